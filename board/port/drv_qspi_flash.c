@@ -6,6 +6,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-01-19     wanghaijing  the first version
+ * 2026-10-18     RT-Thread    add memory mapped FAL flash device
+ * 2026-10-18     RT-Thread    hold the flash from mmap to munmap
+ * 2026-10-18     RT-Thread    return to memory mapped mode after a read of the mapping thread
  */
 
 #include <rtthread.h>
@@ -15,6 +18,23 @@
 
 #ifdef BSP_USING_QSPI_FLASH
 
+#ifdef BSP_QSPI_FLASH_USING_MMAP
+#include <stdlib.h>
+#include <fal.h>
+#include <spi_flash_sfud.h>
+
+static rt_spi_flash_device_t qspi_flash_dev = RT_NULL;
+/**
+ * the mappings held by the owner of the flash lock; while it is not 0 the owner may still read
+ * by commands, with sfud_read() or the flash device, and memory mapped mode is entered again
+ * when SFUD unlocks the flash, but no write or erase is sent
+ */
+static rt_uint32_t qspi_mmap_count = 0;
+static void (*qspi_sfud_unlock)(const sfud_spi *spi) = RT_NULL;
+
+static void qspi_sfud_mmap_unlock(const sfud_spi *spi);
+#endif
+
 char w25qxx_read_status_register2(struct rt_qspi_device *device)
 {
     /* 0x35 read status register2 */
@@ -61,12 +81,231 @@ static int rt_qspi_flash_init(void)
     extern rt_spi_flash_device_t rt_sfud_flash_probe(const char *spi_flash_dev_name, const char *spi_dev_name);
 
     rt_hw_qspi_device_attach("qspi1", "qspi10", RT_NULL, 4, w25qxx_enter_qspi_mode, RT_NULL);
+#ifdef BSP_QSPI_FLASH_USING_MMAP
+    qspi_flash_dev = rt_sfud_flash_probe(QSPI_FLASH_DEV_NAME, "qspi10");
+    if (RT_NULL == qspi_flash_dev)
+#else
     if (RT_NULL == rt_sfud_flash_probe("norflash1", "qspi10"))
+#endif
     {
         return -RT_ERROR;
     }
+#ifdef BSP_QSPI_FLASH_USING_MMAP
+    qspi_sfud_unlock = ((sfud_flash_t)qspi_flash_dev->user_data)->spi.unlock;
+    ((sfud_flash_t)qspi_flash_dev->user_data)->spi.unlock = qspi_sfud_mmap_unlock;
+#endif
     return RT_EOK;
 }
 INIT_ENV_EXPORT(rt_qspi_flash_init);
 
+#ifdef BSP_QSPI_FLASH_USING_MMAP
+static int qspi_fal_init(void);
+static int qspi_fal_read(long offset, uint8_t *buf, size_t size);
+static int qspi_fal_write(long offset, const uint8_t *buf, size_t size);
+static int qspi_fal_erase(long offset, size_t size);
+static const void *qspi_fal_mmap(long offset, size_t size);
+static void qspi_fal_munmap(long offset, size_t size);
+
+struct fal_flash_dev nor_flash1 =
+{
+    .name       = QSPI_FLASH_DEV_NAME,
+    .addr       = 0,
+    .len        = 8 * 1024 * 1024,
+    .blk_size   = 4096,
+    .ops        = {qspi_fal_init, qspi_fal_read, qspi_fal_write, qspi_fal_erase, qspi_fal_mmap, qspi_fal_munmap},
+    .write_gran = 1
+};
+
+/* the SPI flash lock must be taken before call it */
+static rt_err_t qspi_flash_mmap_enter(void)
+{
+    sfud_flash_t sfud_dev = (sfud_flash_t)qspi_flash_dev->user_data;
+    struct rt_qspi_message message;
+
+    rt_memset(&message, 0, sizeof(message));
+    message.instruction.content = sfud_dev->read_cmd_format.instruction;
+    message.instruction.qspi_lines = sfud_dev->read_cmd_format.instruction_lines;
+    message.address.size = sfud_dev->read_cmd_format.address_size;
+    message.address.qspi_lines = sfud_dev->read_cmd_format.address_lines;
+    message.dummy_cycles = sfud_dev->read_cmd_format.dummy_cycles;
+    message.qspi_data_lines = sfud_dev->read_cmd_format.data_lines;
+
+    return rt_hw_qspi_memory_mapped_enter((struct rt_qspi_device *)qspi_flash_dev->rt_spi_device, &message);
+}
+
+/* a command of the thread holding a mapping has left memory mapped mode, enter it again */
+static void qspi_sfud_mmap_unlock(const sfud_spi *spi)
+{
+    if (qspi_mmap_count > 0 && qspi_flash_mmap_enter() != RT_EOK)
+    {
+        rt_kprintf("qspi flash: failed to enter memory mapped mode again\n");
+    }
+    qspi_sfud_unlock(spi);
+}
+
+static int qspi_fal_init(void)
+{
+    sfud_flash_t sfud_dev;
+
+    if (qspi_flash_dev == RT_NULL)
+    {
+        return -1;
+    }
+
+    /* update the flash chip information */
+    sfud_dev = (sfud_flash_t)qspi_flash_dev->user_data;
+    nor_flash1.blk_size = sfud_dev->chip.erase_gran;
+    nor_flash1.len = sfud_dev->chip.capacity;
+
+    return 0;
+}
+
+static int qspi_fal_read(long offset, uint8_t *buf, size_t size)
+{
+    rt_err_t result;
+
+    rt_mutex_take(&qspi_flash_dev->lock, RT_WAITING_FOREVER);
+    result = qspi_flash_mmap_enter();
+    if (result == RT_EOK)
+    {
+        rt_memcpy(buf, (const void *)(QSPI_BASE + nor_flash1.addr + offset), size);
+    }
+    rt_mutex_release(&qspi_flash_dev->lock);
+
+    return result == RT_EOK ? (int)size : -1;
+}
+
+static int qspi_fal_write(long offset, const uint8_t *buf, size_t size)
+{
+    int result = -1;
+
+    /* the other threads wait for the unmap here, the mapping thread must unmap first */
+    rt_mutex_take(&qspi_flash_dev->lock, RT_WAITING_FOREVER);
+    /* the QSPI bus exits memory mapped mode automatically for command transfer */
+    if (qspi_mmap_count == 0 &&
+        sfud_write((sfud_flash_t)qspi_flash_dev->user_data, nor_flash1.addr + offset, size, buf) == SFUD_SUCCESS)
+    {
+        result = size;
+    }
+    rt_mutex_release(&qspi_flash_dev->lock);
+
+    return result;
+}
+
+static int qspi_fal_erase(long offset, size_t size)
+{
+    int result = -1;
+
+    rt_mutex_take(&qspi_flash_dev->lock, RT_WAITING_FOREVER);
+    if (qspi_mmap_count == 0 &&
+        sfud_erase((sfud_flash_t)qspi_flash_dev->user_data, nor_flash1.addr + offset, size) == SFUD_SUCCESS)
+    {
+        result = size;
+    }
+    rt_mutex_release(&qspi_flash_dev->lock);
+
+    return result;
+}
+
+/* the flash lock is held until qspi_fal_munmap(), so no command leaves memory mapped mode */
+static const void *qspi_fal_mmap(long offset, size_t size)
+{
+    rt_mutex_take(&qspi_flash_dev->lock, RT_WAITING_FOREVER);
+    if (qspi_flash_mmap_enter() != RT_EOK)
+    {
+        rt_mutex_release(&qspi_flash_dev->lock);
+        return RT_NULL;
+    }
+    qspi_mmap_count++;
+
+    return (const void *)(QSPI_BASE + nor_flash1.addr + offset);
+}
+
+static void qspi_fal_munmap(long offset, size_t size)
+{
+    RT_ASSERT(qspi_mmap_count > 0);
+
+    qspi_mmap_count--;
+    rt_mutex_release(&qspi_flash_dev->lock);
+}
+
+#ifdef RT_USING_FINSH
+#define QSPI_BENCH_CHUNK_SIZE    4096
+
+static void qspi_mmap_bench(int argc, char **argv)
+{
+    const char *mode[] = {"command", "mmap copy", "mmap ptr"};
+    sfud_flash_t sfud_dev;
+    rt_uint8_t *buf;
+    const rt_uint32_t *ptr;
+    rt_uint32_t total = 1024 * 1024, offset, i, sum = 0;
+    rt_tick_t start, ticks[3];
+
+    if (qspi_flash_dev == RT_NULL)
+    {
+        rt_kprintf("QSPI flash is not probed\n");
+        return;
+    }
+    sfud_dev = (sfud_flash_t)qspi_flash_dev->user_data;
+    if (argc > 1)
+    {
+        total = strtoul(argv[1], RT_NULL, 0);
+    }
+    total = RT_ALIGN_DOWN(total, QSPI_BENCH_CHUNK_SIZE);
+    if (total == 0 || total > sfud_dev->chip.capacity)
+    {
+        rt_kprintf("Usage: qspi_mmap_bench [size(%d-%d)]\n", QSPI_BENCH_CHUNK_SIZE, sfud_dev->chip.capacity);
+        return;
+    }
+    buf = rt_malloc(QSPI_BENCH_CHUNK_SIZE);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return;
+    }
+
+    /* command read by SFUD, the QSPI bus exits memory mapped mode */
+    start = rt_tick_get();
+    for (offset = 0; offset < total; offset += QSPI_BENCH_CHUNK_SIZE)
+    {
+        sfud_read(sfud_dev, offset, QSPI_BENCH_CHUNK_SIZE, buf);
+    }
+    ticks[0] = rt_tick_get() - start;
+
+    /* memory mapped read with copy, the first read switches to memory mapped mode */
+    start = rt_tick_get();
+    for (offset = 0; offset < total; offset += QSPI_BENCH_CHUNK_SIZE)
+    {
+        qspi_fal_read(offset, buf, QSPI_BENCH_CHUNK_SIZE);
+    }
+    ticks[1] = rt_tick_get() - start;
+
+    /* zero-copy read by pointer */
+    start = rt_tick_get();
+    ptr = (const rt_uint32_t *)qspi_fal_mmap(0, total);
+    for (i = 0; ptr && i < total / sizeof(rt_uint32_t); i++)
+    {
+        sum += ptr[i];
+    }
+    if (ptr)
+    {
+        qspi_fal_munmap(0, total);
+    }
+    ticks[2] = rt_tick_get() - start;
+
+    rt_free(buf);
+
+    rt_kprintf("read %d bytes, checksum 0x%08x\n", total, sum);
+    rt_kprintf("%-10s %8s %10s\n", "mode", "ms", "KB/s");
+    for (i = 0; i < 3; i++)
+    {
+        rt_uint32_t ms = ticks[i] * 1000 / RT_TICK_PER_SECOND;
+
+        rt_kprintf("%-10s %8d %10d\n", mode[i], ms, ms ? total / ms * 1000 / 1024 : 0);
+    }
+}
+MSH_CMD_EXPORT(qspi_mmap_bench, QSPI flash command read and memory mapped read throughput benchmark);
+#endif /* RT_USING_FINSH */
+#endif /* BSP_QSPI_FLASH_USING_MMAP */
+
 #endif/* BSP_USING_QSPI_FLASH */
@@ -20,6 +20,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-05-17     armink       the first version
+ * 2026-10-18     RT-Thread    memory mapped QSPI flash partition
  */
 
 #ifndef _FAL_CFG_H_
@@ -29,17 +30,42 @@
 #include <board.h>
 
 #define NOR_FLASH_DEV_NAME             "norflash0"
+#define QSPI_FLASH_DEV_NAME            "norflash1"
 
 /* ===================== Flash device Configuration ========================= */
 extern struct fal_flash_dev nor_flash0;
 
+#ifdef BSP_QSPI_FLASH_USING_MMAP
+/* memory mapped QSPI flash, the partitions on it can be read by fal_partition_mmap/munmap */
+extern struct fal_flash_dev nor_flash1;
+
 /* flash device table */
 #define FAL_FLASH_DEV_TABLE                                          \
 {                                                                    \
     &nor_flash0,                                                     \
+    &nor_flash1,                                                     \
 }
+#else
+/* flash device table */
+#define FAL_FLASH_DEV_TABLE                                          \
+{                                                                    \
+    &nor_flash0,                                                     \
+}
+#endif /* BSP_QSPI_FLASH_USING_MMAP */
 /* ====================== Partition Configuration ========================== */
 #ifdef FAL_PART_HAS_TABLE_CFG
+#ifdef BSP_QSPI_FLASH_USING_MMAP
+/* partition table, the read-only resources are on the memory mapped QSPI flash */
+#define FAL_PART_TABLE                                                                     \
+{                                                                                          \
+    {FAL_PART_MAGIC_WORD, "wifi_image", NOR_FLASH_DEV_NAME,           0,     512*1024, 0}, \
+    {FAL_PART_MAGIC_WORD, "bt_image",   NOR_FLASH_DEV_NAME,    512*1024,     512*1024, 0}, \
+    {FAL_PART_MAGIC_WORD, "download",   NOR_FLASH_DEV_NAME,   1024*1024,  2*1024*1024, 0}, \
+    {FAL_PART_MAGIC_WORD, "easyflash",  NOR_FLASH_DEV_NAME, 3*1024*1024,  1*1024*1024, 0}, \
+    {FAL_PART_MAGIC_WORD, "filesystem", NOR_FLASH_DEV_NAME, 4*1024*1024, 12*1024*1024, 0}, \
+    {FAL_PART_MAGIC_WORD, "resource",  QSPI_FLASH_DEV_NAME,           0,  8*1024*1024, 0}, \
+}
+#else
 /* partition table */
 #define FAL_PART_TABLE                                                                     \
 {                                                                                          \
@@ -49,6 +75,7 @@ extern struct fal_flash_dev nor_flash0;
     {FAL_PART_MAGIC_WORD, "easyflash",  NOR_FLASH_DEV_NAME, 3*1024*1024,  1*1024*1024, 0}, \
     {FAL_PART_MAGIC_WORD, "filesystem", NOR_FLASH_DEV_NAME, 4*1024*1024, 12*1024*1024, 0}, \
 }
+#endif /* BSP_QSPI_FLASH_USING_MMAP */
 #endif /* FAL_PART_HAS_TABLE_CFG */
 
 #endif /* _FAL_CFG_H_ */
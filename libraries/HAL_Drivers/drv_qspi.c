@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-11-27     zylx         first version
+ * 2026-10-18     RT-Thread    add memory mapped mode
  */
 
 #include "board.h"
@@ -27,6 +28,9 @@ struct stm32_qspi_bus
 #ifdef BSP_QSPI_USING_DMA
     DMA_HandleTypeDef hdma_quadspi;
 #endif
+#ifdef BSP_QSPI_USING_MEMORY_MAPPED
+    rt_bool_t mmap_enabled;
+#endif
 };
 
 struct rt_spi_bus _qspi_bus1;
@@ -46,6 +50,10 @@ static int stm32_qspi_init(struct rt_qspi_device *device, struct rt_qspi_configu
 
     QSPI_HandleTypeDef QSPI_Handler_config = QSPI_BUS_CONFIG;
     qspi_bus->QSPI_Handler = QSPI_Handler_config;
+#ifdef BSP_QSPI_USING_MEMORY_MAPPED
+    /* the memory mapped mode is exited by re-initialize */
+    qspi_bus->mmap_enabled = RT_FALSE;
+#endif
 
 #if defined(SOC_SERIES_STM32MP1)
     while (cfg->max_hz < HAL_RCC_GetACLKFreq() / (i + 1))
@@ -119,82 +127,101 @@ static int stm32_qspi_init(struct rt_qspi_device *device, struct rt_qspi_configu
     return result;
 }
 
-static void qspi_send_cmd(struct stm32_qspi_bus *qspi_bus, struct rt_qspi_message *message)
+static void qspi_cmd_config(struct rt_qspi_message *message, QSPI_CommandTypeDef *cmd)
 {
-    RT_ASSERT(qspi_bus != RT_NULL);
     RT_ASSERT(message != RT_NULL);
-
-    QSPI_CommandTypeDef Cmdhandler;
+    RT_ASSERT(cmd != RT_NULL);
 
     /* set QSPI cmd struct */
-    Cmdhandler.Instruction = message->instruction.content;
-    Cmdhandler.Address = message->address.content;
-    Cmdhandler.DummyCycles = message->dummy_cycles;
+    cmd->Instruction = message->instruction.content;
+    cmd->Address = message->address.content;
+    cmd->DummyCycles = message->dummy_cycles;
     if (message->instruction.qspi_lines == 0)
     {
-        Cmdhandler.InstructionMode = QSPI_INSTRUCTION_NONE;
+        cmd->InstructionMode = QSPI_INSTRUCTION_NONE;
     }
     else if (message->instruction.qspi_lines == 1)
     {
-        Cmdhandler.InstructionMode = QSPI_INSTRUCTION_1_LINE;
+        cmd->InstructionMode = QSPI_INSTRUCTION_1_LINE;
     }
     else if (message->instruction.qspi_lines == 2)
     {
-        Cmdhandler.InstructionMode = QSPI_INSTRUCTION_2_LINES;
+        cmd->InstructionMode = QSPI_INSTRUCTION_2_LINES;
     }
     else if (message->instruction.qspi_lines == 4)
     {
-        Cmdhandler.InstructionMode = QSPI_INSTRUCTION_4_LINES;
+        cmd->InstructionMode = QSPI_INSTRUCTION_4_LINES;
     }
     if (message->address.qspi_lines == 0)
     {
-        Cmdhandler.AddressMode = QSPI_ADDRESS_NONE;
+        cmd->AddressMode = QSPI_ADDRESS_NONE;
     }
     else if (message->address.qspi_lines == 1)
     {
-        Cmdhandler.AddressMode = QSPI_ADDRESS_1_LINE;
+        cmd->AddressMode = QSPI_ADDRESS_1_LINE;
     }
     else if (message->address.qspi_lines == 2)
     {
-        Cmdhandler.AddressMode = QSPI_ADDRESS_2_LINES;
+        cmd->AddressMode = QSPI_ADDRESS_2_LINES;
     }
     else if (message->address.qspi_lines == 4)
     {
-        Cmdhandler.AddressMode = QSPI_ADDRESS_4_LINES;
+        cmd->AddressMode = QSPI_ADDRESS_4_LINES;
     }
     if (message->address.size == 24)
     {
-        Cmdhandler.AddressSize = QSPI_ADDRESS_24_BITS;
+        cmd->AddressSize = QSPI_ADDRESS_24_BITS;
     }
     else
     {
-        Cmdhandler.AddressSize = QSPI_ADDRESS_32_BITS;
+        cmd->AddressSize = QSPI_ADDRESS_32_BITS;
     }
     if (message->qspi_data_lines == 0)
     {
-        Cmdhandler.DataMode = QSPI_DATA_NONE;
+        cmd->DataMode = QSPI_DATA_NONE;
     }
     else if (message->qspi_data_lines == 1)
     {
-        Cmdhandler.DataMode = QSPI_DATA_1_LINE;
+        cmd->DataMode = QSPI_DATA_1_LINE;
     }
     else if (message->qspi_data_lines == 2)
     {
-        Cmdhandler.DataMode = QSPI_DATA_2_LINES;
+        cmd->DataMode = QSPI_DATA_2_LINES;
     }
     else if (message->qspi_data_lines == 4)
     {
-        Cmdhandler.DataMode = QSPI_DATA_4_LINES;
+        cmd->DataMode = QSPI_DATA_4_LINES;
     }
 
-    Cmdhandler.SIOOMode = QSPI_SIOO_INST_EVERY_CMD;
-    Cmdhandler.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
-    Cmdhandler.DdrMode = QSPI_DDR_MODE_DISABLE;
-    Cmdhandler.DdrHoldHalfCycle = QSPI_DDR_HHC_ANALOG_DELAY;
-    Cmdhandler.NbData = message->parent.length;
+    cmd->SIOOMode = QSPI_SIOO_INST_EVERY_CMD;
+    cmd->AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+    cmd->DdrMode = QSPI_DDR_MODE_DISABLE;
+    cmd->DdrHoldHalfCycle = QSPI_DDR_HHC_ANALOG_DELAY;
+    cmd->NbData = message->parent.length;
+}
+
+static void qspi_send_cmd(struct stm32_qspi_bus *qspi_bus, struct rt_qspi_message *message)
+{
+    RT_ASSERT(qspi_bus != RT_NULL);
+    RT_ASSERT(message != RT_NULL);
+
+    QSPI_CommandTypeDef Cmdhandler;
+
+    qspi_cmd_config(message, &Cmdhandler);
     HAL_QSPI_Command(&qspi_bus->QSPI_Handler, &Cmdhandler, 5000);
 }
 
+#ifdef BSP_QSPI_USING_MEMORY_MAPPED
+static void qspi_memory_mapped_abort(struct stm32_qspi_bus *qspi_bus)
+{
+    if (qspi_bus->mmap_enabled)
+    {
+        HAL_QSPI_Abort(&qspi_bus->QSPI_Handler);
+        qspi_bus->mmap_enabled = RT_FALSE;
+    }
+}
+#endif /* BSP_QSPI_USING_MEMORY_MAPPED */
+
 static rt_ssize_t qspixfer(struct rt_spi_device *device, struct rt_spi_message *message)
 {
     rt_ssize_t result = 0;
@@ -209,6 +236,11 @@ static rt_ssize_t qspixfer(struct rt_spi_device *device, struct rt_spi_message *
     rt_uint8_t *rcvb = message->recv_buf;
     rt_int32_t length = message->length;
 
+#ifdef BSP_QSPI_USING_MEMORY_MAPPED
+    /* the indirect mode transfer can not work in memory mapped mode */
+    qspi_memory_mapped_abort(qspi_bus);
+#endif
+
 #ifdef BSP_QSPI_USING_SOFTCS
     if (message->cs_take && (device->cs_pin != PIN_NONE))
     {
@@ -345,6 +377,96 @@ __exit:
     return  result;
 }
 
+#ifdef BSP_QSPI_USING_MEMORY_MAPPED
+/**
+  * @brief  This function lets the QSPI bus enter memory mapped mode, then the flash can be read at QSPI_BASE.
+  *         It will exit memory mapped mode automatically when the next indirect transfer on this bus.
+  * @param  device           QSPI device
+  * @param  read_message     the read command which is used in memory mapped mode, the data length is ignored
+  * @retval RT_EOK : success
+  *        -RT_ERROR : failed
+  */
+rt_err_t rt_hw_qspi_memory_mapped_enter(struct rt_qspi_device *device, struct rt_qspi_message *read_message)
+{
+    QSPI_CommandTypeDef Cmdhandler;
+    QSPI_MemoryMappedTypeDef mmap_cfg;
+    struct stm32_qspi_bus *qspi_bus;
+    rt_err_t result = RT_EOK;
+
+    RT_ASSERT(device != RT_NULL);
+    RT_ASSERT(read_message != RT_NULL);
+
+    result = rt_spi_take_bus(&device->parent);
+    if (result != RT_EOK)
+    {
+        return result;
+    }
+
+    qspi_bus = device->parent.bus->parent.user_data;
+    if (!qspi_bus->mmap_enabled)
+    {
+        qspi_cmd_config(read_message, &Cmdhandler);
+        mmap_cfg.TimeOutActivation = QSPI_TIMEOUT_COUNTER_DISABLE;
+        mmap_cfg.TimeOutPeriod = 0;
+
+        if (HAL_QSPI_MemoryMapped(&qspi_bus->QSPI_Handler, &Cmdhandler, &mmap_cfg) == HAL_OK)
+        {
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+            /* the flash may be programmed or erased since last mapped, drop the old cached data */
+            SCB_CleanInvalidateDCache();
+#endif
+            qspi_bus->mmap_enabled = RT_TRUE;
+        }
+        else
+        {
+            LOG_E("QSPI enter memory mapped mode failed(%d)!", qspi_bus->QSPI_Handler.ErrorCode);
+            qspi_bus->QSPI_Handler.State = HAL_QSPI_STATE_READY;
+            result = -RT_ERROR;
+        }
+    }
+
+    rt_spi_release_bus(&device->parent);
+
+    return result;
+}
+
+/**
+  * @brief  This function lets the QSPI bus exit memory mapped mode.
+  * @param  device           QSPI device
+  * @retval RT_EOK : success
+  */
+rt_err_t rt_hw_qspi_memory_mapped_exit(struct rt_qspi_device *device)
+{
+    rt_err_t result;
+
+    RT_ASSERT(device != RT_NULL);
+
+    result = rt_spi_take_bus(&device->parent);
+    if (result == RT_EOK)
+    {
+        qspi_memory_mapped_abort(device->parent.bus->parent.user_data);
+        rt_spi_release_bus(&device->parent);
+    }
+
+    return result;
+}
+
+/**
+  * @brief  This function checks the QSPI bus is in memory mapped mode.
+  * @param  device           QSPI device
+  * @retval RT_TRUE : in memory mapped mode
+  */
+rt_bool_t rt_hw_qspi_is_memory_mapped(struct rt_qspi_device *device)
+{
+    struct stm32_qspi_bus *qspi_bus;
+
+    RT_ASSERT(device != RT_NULL);
+
+    qspi_bus = device->parent.bus->parent.user_data;
+    return qspi_bus->mmap_enabled;
+}
+#endif /* BSP_QSPI_USING_MEMORY_MAPPED */
+
 #ifdef BSP_QSPI_USING_DMA
 void QSPI_IRQHandler(void)
 {
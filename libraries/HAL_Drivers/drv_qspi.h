@@ -12,6 +12,7 @@
 #define __DRV_QSPI_H__
 
 #include <rtthread.h>
+#include <rtdevice.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,6 +20,13 @@ extern "C" {
 
 rt_err_t rt_hw_qspi_device_attach(const char *bus_name, const char *device_name, rt_base_t cs_pin, rt_uint8_t data_line_width, void (*enter_qspi_mode)(), void (*exit_qspi_mode)());
 
+#ifdef BSP_QSPI_USING_MEMORY_MAPPED
+/* the flash is mapped at QSPI_BASE in memory mapped mode */
+rt_err_t rt_hw_qspi_memory_mapped_enter(struct rt_qspi_device *device, struct rt_qspi_message *read_message);
+rt_err_t rt_hw_qspi_memory_mapped_exit(struct rt_qspi_device *device);
+rt_bool_t rt_hw_qspi_is_memory_mapped(struct rt_qspi_device *device);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
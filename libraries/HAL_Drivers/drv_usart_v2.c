@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-06-01     KyleChan     first version
+ * 2026-10-18     RT-Thread    report the idle line as rx timeout for the rx wake condition
  */
 
 #include "board.h"
@@ -417,8 +418,22 @@ static void dma_recv_isr(struct rt_serial_device *serial, rt_uint8_t isr_flag)
         SCB_InvalidateDCache_by_Addr((uint32_t *)rx_fifo->buffer, serial->config.rx_bufsz);
 #endif
         uart->dma_rx.remaining_cnt = counter;
+#ifdef RT_SERIAL_USING_RX_WAKE
+        if (isr_flag == UART_RX_DMA_IT_IDLE_FLAG)
+        {
+            rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_TIMEOUT | (recv_len << 8));
+            return;
+        }
+#endif
         rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_DMADONE | (recv_len << 8));
     }
+#ifdef RT_SERIAL_USING_RX_WAKE
+    else if (isr_flag == UART_RX_DMA_IT_IDLE_FLAG)
+    {
+        /* The line is idle, deliver the data below the wake threshold */
+        rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_TIMEOUT);
+    }
+#endif
 }
 #endif  /* RT_SERIAL_USING_DMA */
 
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2017-05-09     Urey         first version
  * 2019-07-09     Zero-Free    improve device ops interface and data flows
+ * 2026-10-18     RT-Thread    add zero-copy replay and replay statistics
  */
 
 #include <stdio.h>
@@ -29,6 +30,32 @@ enum
     REPLAY_EVT_STOP  = 0x02,
 };
 
+static void _audio_replay_account(struct rt_audio_device *audio, rt_int32_t bytes)
+{
+    struct rt_audio_replay_stat *stat = &audio->replay->stat;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    stat->queued_bytes += bytes;
+    if (stat->queued_bytes > stat->max_queued_bytes)
+        stat->max_queued_bytes = stat->queued_bytes;
+    rt_hw_interrupt_enable(level);
+}
+
+static void _audio_replay_release(struct rt_audio_device *audio, const rt_uint8_t *data)
+{
+    struct rt_mempool *mp = audio->replay->mp;
+
+    /* blocks of write() go back to the memory pool, submitted buffers to the application */
+    if (data >= (rt_uint8_t *)mp->start_address && data < (rt_uint8_t *)mp->start_address + mp->size)
+        rt_mp_free((void *)data);
+    audio->replay->stat.buffers++;
+
+    /* notify transmitted complete. */
+    if (audio->parent.tx_complete != RT_NULL)
+        audio->parent.tx_complete(&audio->parent, (void *)data);
+}
+
 static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
 {
     rt_err_t result = RT_EOK;
@@ -50,6 +77,8 @@ static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
         /* ack stop event */
         if (audio->replay->event & REPLAY_EVT_STOP)
             rt_completion_done(&audio->replay->cmp);
+        else
+            audio->replay->stat.underruns++;
 
         /* send zero frames */
         rt_memset(&buf_info->buffer[audio->replay->pos], 0, dst_size);
@@ -59,19 +88,18 @@ static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
     }
     else
     {
-        rt_memset(&buf_info->buffer[audio->replay->pos], 0, dst_size);
-
         /* copy data from memory pool to hardware device fifo */
         while (index < dst_size)
         {
             result = rt_data_queue_peek(&audio->replay->queue, (const void **)&data, &src_size);
             if (result != RT_EOK)
             {
-                LOG_D("under run %d, remain %d", audio->replay->pos, remain_bytes);
-                audio->replay->pos -= remain_bytes;
-                audio->replay->pos += dst_size;
-                audio->replay->pos %= buf_info->total_size;
+                LOG_D("under run %d, remain %d", audio->replay->pos, dst_size - index);
+                /* fill the rest of the block with zero frames */
+                rt_memset(&buf_info->buffer[audio->replay->pos], 0, dst_size - index);
+                audio->replay->pos = (position + dst_size) % buf_info->total_size;
                 audio->replay->read_index = 0;
+                audio->replay->stat.underruns++;
                 result = -RT_EEMPTY;
                 break;
             }
@@ -84,17 +112,14 @@ static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
             audio->replay->read_index += remain_bytes;
             audio->replay->pos += remain_bytes;
             audio->replay->pos %= buf_info->total_size;
+            audio->replay->stat.queued_bytes -= remain_bytes;
 
             if (audio->replay->read_index == src_size)
             {
                 /* free memory */
                 audio->replay->read_index = 0;
                 rt_data_queue_pop(&audio->replay->queue, (const void **)&data, &src_size, RT_WAITING_NO);
-                rt_mp_free(data);
-
-                /* notify transmitted complete. */
-                if (audio->parent.tx_complete != RT_NULL)
-                    audio->parent.tx_complete(&audio->parent, (void *)data);
+                _audio_replay_release(audio, data);
             }
         }
     }
@@ -108,12 +133,104 @@ static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
     return result;
 }
 
+static rt_uint8_t _audio_replay_depth(struct rt_audio_device *audio)
+{
+    rt_uint16_t depth = audio->replay->buf_info.block_count;
+
+    if (depth == 0)
+        depth = 1;
+
+    return MIN(depth, AUDIO_REPLAY_INFLIGHT_MAX);
+}
+
+/* hand the next block of the queue, or a block of silence, to the DMA */
+static rt_err_t _audio_replay_dispatch(struct rt_audio_device *audio)
+{
+    struct rt_audio_replay *replay = audio->replay;
+    struct rt_audio_replay_chunk *chunk;
+    const rt_uint8_t *data;
+    rt_size_t src_size;
+
+    chunk = &replay->inflight[(replay->inflight_head + replay->inflight_count) % AUDIO_REPLAY_INFLIGHT_MAX];
+    if (rt_data_queue_peek(&replay->queue, (const void **)&data, &src_size) == RT_EOK)
+    {
+        chunk->buffer = data;
+        chunk->size = MIN(replay->buf_info.block_size, src_size - replay->read_index);
+        chunk->last = RT_FALSE;
+        data += replay->read_index;
+        replay->read_index += chunk->size;
+        if (replay->read_index == src_size)
+        {
+            /* the buffer leaves the queue, it's released once its last block is played */
+            replay->read_index = 0;
+            rt_data_queue_pop(&replay->queue, (const void **)&chunk->buffer, &src_size, RT_WAITING_NO);
+            chunk->last = RT_TRUE;
+        }
+    }
+    else
+    {
+        if (!(replay->event & REPLAY_EVT_STOP))
+            replay->stat.underruns++;
+
+        data = replay->buf_info.buffer;
+        chunk->buffer = RT_NULL;
+        chunk->size = replay->buf_info.block_size;
+        chunk->last = RT_FALSE;
+    }
+    replay->inflight_count++;
+
+    if (audio->ops->transmit(audio, data, RT_NULL, chunk->size) != chunk->size)
+        return -RT_ERROR;
+
+    return RT_EOK;
+}
+
+static void _audio_replay_retire(struct rt_audio_device *audio)
+{
+    struct rt_audio_replay *replay = audio->replay;
+    struct rt_audio_replay_chunk *chunk;
+
+    chunk = &replay->inflight[replay->inflight_head];
+    replay->inflight_head = (replay->inflight_head + 1) % AUDIO_REPLAY_INFLIGHT_MAX;
+    replay->inflight_count--;
+
+    if (chunk->buffer != RT_NULL)
+    {
+        replay->stat.queued_bytes -= chunk->size;
+        if (chunk->last)
+            _audio_replay_release(audio, chunk->buffer);
+    }
+}
+
+static rt_err_t _audio_send_replay_dma(struct rt_audio_device *audio)
+{
+    rt_err_t result = RT_EOK;
+    struct rt_audio_replay *replay;
+
+    RT_ASSERT(audio != RT_NULL);
+    replay = audio->replay;
+
+    /* the oldest block in flight is played */
+    if (replay->inflight_count > 0)
+        _audio_replay_retire(audio);
+
+    /* ack stop event */
+    if ((replay->event & REPLAY_EVT_STOP) && replay->stat.queued_bytes == 0)
+        rt_completion_done(&replay->cmp);
+
+    while (replay->inflight_count < _audio_replay_depth(audio) && result == RT_EOK)
+        result = _audio_replay_dispatch(audio);
+
+    return result;
+}
+
 static rt_err_t _audio_flush_replay_frame(struct rt_audio_device *audio)
 {
     rt_err_t result = RT_EOK;
 
     if (audio->replay->write_index)
     {
+        _audio_replay_account(audio, audio->replay->write_index);
         result = rt_data_queue_push(&audio->replay->queue,
                                     (const void **)audio->replay->write_data,
                                     audio->replay->write_index,
@@ -131,6 +248,19 @@ static rt_err_t _aduio_replay_start(struct rt_audio_device *audio)
 
     if (audio->replay->activated != RT_TRUE)
     {
+        if (audio->replay->buf_info.flags & AUDIO_BUF_FLAG_ZEROCOPY)
+        {
+            RT_ASSERT(audio->ops->transmit != RT_NULL);
+            RT_ASSERT(audio->replay->buf_info.block_size != 0);
+
+            /* queue the first blocks before the DMA runs */
+            rt_memset(audio->replay->buf_info.buffer, 0, audio->replay->buf_info.block_size);
+            audio->replay->inflight_head = 0;
+            audio->replay->inflight_count = 0;
+            while (audio->replay->inflight_count < _audio_replay_depth(audio))
+                _audio_replay_dispatch(audio);
+        }
+
         /* start playback hardware device */
         if (audio->ops->start)
             result = audio->ops->start(audio, AUDIO_STREAM_REPLAY);
@@ -163,6 +293,10 @@ static rt_err_t _aduio_replay_stop(struct rt_audio_device *audio)
         if (audio->ops->stop)
             result = audio->ops->stop(audio, AUDIO_STREAM_REPLAY);
 
+        /* only silence is left in flight */
+        while (audio->replay->inflight_count > 0)
+            _audio_replay_retire(audio);
+
         audio->replay->activated = RT_FALSE;
         LOG_D("stop audio replay device");
     }
@@ -314,6 +448,7 @@ static rt_err_t _audio_dev_open(struct rt_device *dev, rt_uint16_t oflag)
             audio->replay->read_index = 0;
             audio->replay->pos = 0;
             audio->replay->event = REPLAY_EVT_NONE;
+            rt_memset(&audio->replay->stat, 0, sizeof(audio->replay->stat));
         }
         dev->open_flag |= RT_DEVICE_OFLAG_WRONLY;
     }
@@ -393,7 +528,6 @@ static rt_ssize_t _audio_dev_write(struct rt_device *dev, rt_off_t pos, const vo
         if (audio->replay->write_index % block_size == 0)
         {
             audio->replay->write_data = rt_mp_alloc(audio->replay->mp, RT_WAITING_FOREVER);
-            rt_memset(audio->replay->write_data, 0, block_size);
         }
 
         /* copy data to replay memory pool */
@@ -406,6 +540,7 @@ static rt_ssize_t _audio_dev_write(struct rt_device *dev, rt_off_t pos, const vo
 
         if (audio->replay->write_index == 0)
         {
+            _audio_replay_account(audio, block_size);
             rt_data_queue_push(&audio->replay->queue,
                                audio->replay->write_data,
                                block_size,
@@ -457,6 +592,57 @@ static rt_err_t _audio_dev_control(struct rt_device *dev, int cmd, void *args)
             result = audio->ops->configure(audio, caps);
         }
 
+        /* keep the replay format for the latency */
+        if (result == RT_EOK && caps->main_type == AUDIO_TYPE_OUTPUT && audio->replay != RT_NULL)
+        {
+            struct rt_audio_configure *config = &audio->replay->config;
+
+            switch (caps->sub_type)
+            {
+            case AUDIO_DSP_PARAM:
+                *config = caps->udata.config;
+                break;
+            case AUDIO_DSP_SAMPLERATE:
+                config->samplerate = caps->udata.config.samplerate;
+                break;
+            case AUDIO_DSP_CHANNELS:
+                config->channels = caps->udata.config.channels;
+                break;
+            case AUDIO_DSP_SAMPLEBITS:
+                config->samplebits = caps->udata.config.samplebits;
+                break;
+            default:
+                break;
+            }
+        }
+
+        break;
+    }
+
+    case AUDIO_CTL_GETREPLAYSTAT:
+    {
+        struct rt_audio_replay_stat *stat = (struct rt_audio_replay_stat *) args;
+        struct rt_audio_configure *config;
+        rt_uint32_t bytes_per_second, hw_bytes = 0;
+
+        if (audio->replay == RT_NULL || stat == RT_NULL)
+        {
+            result = -RT_EINVAL;
+            break;
+        }
+        config = &audio->replay->config;
+        *stat = audio->replay->stat;
+
+        /* the copy mode adds the buffer of the hardware to the queue */
+        if (!(audio->replay->buf_info.flags & AUDIO_BUF_FLAG_ZEROCOPY))
+            hw_bytes = audio->replay->buf_info.total_size;
+        bytes_per_second = config->samplerate * config->channels * (config->samplebits / 8);
+        if (bytes_per_second)
+        {
+            stat->latency_us = (rt_uint64_t)(stat->queued_bytes + hw_bytes) * 1000000 / bytes_per_second;
+            stat->max_latency_us = (rt_uint64_t)(stat->max_queued_bytes + hw_bytes) * 1000000 / bytes_per_second;
+        }
+
         break;
     }
 
@@ -595,10 +781,50 @@ int rt_audio_samplerate_to_speed(rt_uint32_t bitValue)
     return speed;
 }
 
+/**
+ * @brief Queue an application buffer for replay without copying it
+ *
+ * @param audio   the audio device opened for writing
+ * @param buffer  the samples, they must stay untouched until the tx_complete callback
+ *                of the device is called with this buffer
+ * @param size    the size of the buffer in bytes
+ *
+ * @return RT_EOK on success, the buffer is played after the data queued before it
+ */
+rt_err_t rt_audio_replay_submit(struct rt_audio_device *audio, const void *buffer, rt_size_t size)
+{
+    rt_err_t result;
+
+    RT_ASSERT(audio != RT_NULL);
+
+    if (!(audio->parent.open_flag & RT_DEVICE_OFLAG_WRONLY) || (audio->replay == RT_NULL))
+        return -RT_EIO;
+    if (buffer == RT_NULL || size == 0)
+        return -RT_EINVAL;
+
+    rt_mutex_take(&audio->replay->lock, RT_WAITING_FOREVER);
+    /* keep the order with the data of write() */
+    _audio_flush_replay_frame(audio);
+    _audio_replay_account(audio, size);
+    result = rt_data_queue_push(&audio->replay->queue, buffer, size, RT_WAITING_FOREVER);
+    if (result != RT_EOK)
+        _audio_replay_account(audio, -(rt_int32_t)size);
+    rt_mutex_release(&audio->replay->lock);
+
+    /* check replay state */
+    if (result == RT_EOK && audio->replay->activated != RT_TRUE)
+        result = _aduio_replay_start(audio);
+
+    return result;
+}
+
 void rt_audio_tx_complete(struct rt_audio_device *audio)
 {
     /* try to send next frame */
-    _audio_send_replay_frame(audio);
+    if (audio->replay->buf_info.flags & AUDIO_BUF_FLAG_ZEROCOPY)
+        _audio_send_replay_dma(audio);
+    else
+        _audio_send_replay_frame(audio);
 }
 
 void rt_audio_rx_done(struct rt_audio_device *audio, rt_uint8_t *pbuf, rt_size_t len)
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Audio replay CPU cost benchmark.
+ *
+ * Two mock sound devices are registered, one with a circular hardware buffer the
+ * replay data is copied into, one that DMAs from the queued buffers. The bench
+ * plays 48 kHz stereo 16 bit audio as fast as it can: it writes or submits one
+ * memory pool block of samples, then completes the transfers of the mock DMA for
+ * the same amount of bytes by calling rt_audio_tx_complete(). The time spent in the
+ * audio framework is reported per second of audio, with the underruns and latency
+ * from AUDIO_CTL_GETREPLAYSTAT.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(RT_AUDIO_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_SAMPLERATE        48000
+#define BENCH_CHANNELS          2
+#define BENCH_SAMPLEBITS        16
+#define BENCH_BYTES_PER_SECOND  (BENCH_SAMPLERATE * BENCH_CHANNELS * BENCH_SAMPLEBITS / 8)
+
+#define BENCH_PERIOD            RT_AUDIO_REPLAY_MP_BLOCK_SIZE
+#define BENCH_HW_BLOCKS         4
+#define BENCH_HW_BLOCK          (BENCH_PERIOD / BENCH_HW_BLOCKS)
+#define BENCH_APP_BUFFERS       3
+
+struct mock_audio
+{
+    struct rt_audio_device audio;
+    rt_uint8_t buffer[BENCH_HW_BLOCK * 2];
+    rt_uint32_t flags;
+    rt_uint32_t transmitted;
+};
+
+static struct mock_audio mock_copy, mock_dma;
+static rt_uint8_t *app_buffers[BENCH_APP_BUFFERS];
+static volatile rt_bool_t app_busy[BENCH_APP_BUFFERS];
+static struct rt_timer drain_timer;
+
+static rt_err_t mock_getcaps(struct rt_audio_device *audio, struct rt_audio_caps *caps)
+{
+    return RT_EOK;
+}
+
+static rt_err_t mock_configure(struct rt_audio_device *audio, struct rt_audio_caps *caps)
+{
+    return RT_EOK;
+}
+
+static rt_err_t mock_init(struct rt_audio_device *audio)
+{
+    return RT_EOK;
+}
+
+static rt_err_t mock_start(struct rt_audio_device *audio, int stream)
+{
+    return RT_EOK;
+}
+
+static rt_err_t mock_stop(struct rt_audio_device *audio, int stream)
+{
+    return RT_EOK;
+}
+
+static rt_ssize_t mock_transmit(struct rt_audio_device *audio, const void *writeBuf, void *readBuf, rt_size_t size)
+{
+    struct mock_audio *mock = (struct mock_audio *)audio;
+
+    /* the DMA is only programmed, the data is never touched by the CPU */
+    mock->transmitted += size;
+
+    return size;
+}
+
+static void mock_buffer_info(struct rt_audio_device *audio, struct rt_audio_buf_info *info)
+{
+    struct mock_audio *mock = (struct mock_audio *)audio;
+
+    info->buffer = mock->buffer;
+    info->block_size = BENCH_HW_BLOCK;
+    info->block_count = 2;
+    info->total_size = sizeof(mock->buffer);
+    info->flags = mock->flags;
+}
+
+static struct rt_audio_ops mock_ops =
+{
+    .getcaps = mock_getcaps,
+    .configure = mock_configure,
+    .init = mock_init,
+    .start = mock_start,
+    .stop = mock_stop,
+    .transmit = mock_transmit,
+    .buffer_info = mock_buffer_info,
+};
+
+static rt_err_t bench_tx_done(rt_device_t dev, void *buffer)
+{
+    int i;
+
+    for (i = 0; i < BENCH_APP_BUFFERS; i++)
+    {
+        if (buffer == app_buffers[i])
+            app_busy[i] = RT_FALSE;
+    }
+
+    return RT_EOK;
+}
+
+static void bench_drain(void *parameter)
+{
+    rt_audio_tx_complete((struct rt_audio_device *)parameter);
+}
+
+static void bench_fill(rt_uint8_t *buf, rt_uint32_t frame)
+{
+    rt_int16_t *samples = (rt_int16_t *)buf;
+    rt_uint32_t i;
+
+    /* a saw tooth, it's only there to touch the memory */
+    for (i = 0; i < BENCH_PERIOD / 2; i += 2)
+    {
+        samples[i] = samples[i + 1] = (rt_int16_t)((frame + i / 2) * 64);
+    }
+}
+
+/* mode 0: write() and copy, 1: write() and DMA, 2: submit and DMA */
+static rt_err_t bench_run(int mode, rt_uint32_t periods, rt_uint64_t *clocks,
+                          struct rt_audio_replay_stat *stat, rt_uint32_t *reused)
+{
+    struct mock_audio *mock = mode == 0 ? &mock_copy : &mock_dma;
+    rt_device_t dev = RT_DEVICE(&mock->audio);
+    struct rt_audio_caps caps;
+    rt_uint8_t *buf = app_buffers[0];
+    rt_uint32_t n, k, t;
+    rt_err_t result;
+    int slot = 0;
+
+    result = rt_device_open(dev, RT_DEVICE_OFLAG_WRONLY);
+    if (result != RT_EOK)
+        return result;
+    dev->tx_complete = bench_tx_done;
+
+    caps.main_type = AUDIO_TYPE_OUTPUT;
+    caps.sub_type = AUDIO_DSP_PARAM;
+    caps.udata.config.samplerate = BENCH_SAMPLERATE;
+    caps.udata.config.channels = BENCH_CHANNELS;
+    caps.udata.config.samplebits = BENCH_SAMPLEBITS;
+    rt_device_control(dev, AUDIO_CTL_CONFIGURE, &caps);
+
+    *clocks = 0;
+    *reused = 0;
+    for (n = 0; n <= periods; n++)
+    {
+        if (mode == 2)
+        {
+            /* the application rotates its own buffers, the device gives them back */
+            slot = (slot + 1) % BENCH_APP_BUFFERS;
+            buf = app_buffers[slot];
+            if (app_busy[slot])
+                (*reused)++;
+            app_busy[slot] = RT_TRUE;
+        }
+        bench_fill(buf, n * BENCH_PERIOD / 4);
+
+        t = BENCH_CLOCK();
+        if (mode == 2)
+            rt_audio_replay_submit(&mock->audio, buf, BENCH_PERIOD);
+        else
+            rt_device_write(dev, 0, buf, BENCH_PERIOD);
+        *clocks += BENCH_CLOCK() - t;
+
+        /* one period is queued ahead, the DMA plays the one before */
+        if (n == 0)
+            continue;
+        for (k = 0; k < BENCH_HW_BLOCKS; k++)
+        {
+            t = BENCH_CLOCK();
+            rt_audio_tx_complete(&mock->audio);
+            *clocks += BENCH_CLOCK() - t;
+        }
+    }
+    rt_device_control(dev, AUDIO_CTL_GETREPLAYSTAT, stat);
+
+    /* closing waits until the queue is played, the timer is the DMA now */
+    rt_timer_init(&drain_timer, "adrain", bench_drain, &mock->audio, 1, RT_TIMER_FLAG_PERIODIC);
+    rt_timer_start(&drain_timer);
+    rt_device_close(dev);
+    rt_timer_stop(&drain_timer);
+    rt_timer_detach(&drain_timer);
+    dev->tx_complete = RT_NULL;
+
+    return RT_EOK;
+}
+
+static rt_err_t bench_register(void)
+{
+    static rt_bool_t registered = RT_FALSE;
+    rt_err_t result;
+
+    if (registered)
+        return RT_EOK;
+
+    mock_copy.audio.ops = &mock_ops;
+    mock_copy.flags = 0;
+    result = rt_audio_register(&mock_copy.audio, "abench0", RT_DEVICE_FLAG_WRONLY, RT_NULL);
+    if (result != RT_EOK)
+        return result;
+
+    mock_dma.audio.ops = &mock_ops;
+    mock_dma.flags = AUDIO_BUF_FLAG_ZEROCOPY;
+    result = rt_audio_register(&mock_dma.audio, "abench1", RT_DEVICE_FLAG_WRONLY, RT_NULL);
+    if (result != RT_EOK)
+        return result;
+
+    registered = RT_TRUE;
+    return RT_EOK;
+}
+
+static void audio_bench(int argc, char **argv)
+{
+    static const char *const modes[] = {"copy", "write+dma", "submit+dma"};
+    struct rt_audio_replay_stat stat;
+    rt_uint32_t seconds = 10, periods, us, reused;
+    rt_uint64_t clocks;
+    int i;
+
+    if (argc > 1) seconds = strtoul(argv[1], RT_NULL, 0);
+    if (seconds == 0 || BENCH_HW_BLOCK == 0 || BENCH_PERIOD % BENCH_HW_BLOCKS != 0)
+    {
+        rt_kprintf("Usage: audio_bench [seconds]\n");
+        return;
+    }
+    if (bench_register() != RT_EOK)
+    {
+        rt_kprintf("register mock audio devices failed\n");
+        return;
+    }
+    for (i = 0; i < BENCH_APP_BUFFERS; i++)
+    {
+        app_buffers[i] = rt_malloc(BENCH_PERIOD);
+        app_busy[i] = RT_FALSE;
+        if (app_buffers[i] == RT_NULL)
+        {
+            rt_kprintf("no memory for the buffers\n");
+            goto _exit;
+        }
+    }
+    periods = (rt_uint64_t)seconds * BENCH_BYTES_PER_SECOND / BENCH_PERIOD;
+
+    rt_kprintf("%d Hz, %d channels, %d bit, %d s, period %d bytes, dma block %d bytes\n",
+               BENCH_SAMPLERATE, BENCH_CHANNELS, BENCH_SAMPLEBITS, seconds, BENCH_PERIOD, BENCH_HW_BLOCK);
+    rt_kprintf("mode        us/s audio   load  underruns  latency us  max us\n");
+    for (i = 0; i < 3; i++)
+    {
+        if (bench_run(i, periods, &clocks, &stat, &reused) != RT_EOK)
+        {
+            rt_kprintf("%-10s open failed\n", modes[i]);
+            continue;
+        }
+        us = BENCH_CLOCK_US(clocks / seconds);
+        rt_kprintf("%-10s %12d %3d.%02d%% %10d %11d %7d%s\n", modes[i], us, us / 10000, us / 100 % 100,
+                   stat.underruns, stat.latency_us, stat.max_latency_us, reused ? "  buffer reused early" : "");
+    }
+
+_exit:
+    for (i = 0; i < BENCH_APP_BUFFERS; i++)
+    {
+        if (app_buffers[i] != RT_NULL)
+        {
+            rt_free(app_buffers[i]);
+            app_buffers[i] = RT_NULL;
+        }
+    }
+}
+MSH_CMD_EXPORT(audio_bench, audio replay CPU cost per second of 48 kHz stereo);
+
+#endif /* defined(RT_AUDIO_USING_BENCH) && defined(RT_USING_FINSH) */
@@ -0,0 +1,644 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ * 2026-10-18     RT-Thread    coalesce the writes short of a period, check the device class
+ */
+
+#include <rthw.h>
+#include <rtdevice.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef RT_AUDIO_USING_MIXER
+
+#include "audio_mixer.h"
+
+#define DBG_TAG              "audio.mixer"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+#define SRC_ONE                 (1UL << 16)
+#define SRC_PHASES              (1UL << RT_AUDIO_MIXER_SRC_PHASE_BITS)
+#define SRC_TAPS                RT_AUDIO_MIXER_SRC_TAPS
+#define SRC_PI                  3.14159265358979f
+
+#define MIXER_FRAME_BYTES       (2 * sizeof(rt_int16_t))
+#define MIXER_SCRATCH_FRAMES    (RT_AUDIO_MIXER_PERIOD_FRAMES * AUDIO_MIXER_SRC_RATIO_MAX + 1)
+
+#if (SRC_TAPS % 2) != 0
+#error "RT_AUDIO_MIXER_SRC_TAPS must be even"
+#endif
+
+#if defined(__GNUC__) && defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+/* two 16 bit multiplies added to the accumulator in one cycle */
+rt_inline rt_int32_t mixer_smlad(rt_uint32_t x, rt_uint32_t y, rt_int32_t acc)
+{
+    __asm__ ("smlad %0, %1, %2, %0" : "+r"(acc) : "r"(x), "r"(y));
+    return acc;
+}
+
+rt_inline rt_int32_t mixer_ssat16(rt_int32_t x)
+{
+    rt_int32_t result;
+
+    __asm__ ("ssat %0, #16, %1" : "=r"(result) : "r"(x));
+    return result;
+}
+
+static rt_int32_t mixer_fir(const rt_int16_t *coef, const rt_int16_t *x)
+{
+    rt_uint32_t c, s;
+    rt_int32_t acc = 0;
+    int i;
+
+    for (i = 0; i < SRC_TAPS; i += 2)
+    {
+        /* the window starts at any sample, the core reads halfword aligned words */
+        memcpy(&c, &coef[i], sizeof(c));
+        memcpy(&s, &x[i], sizeof(s));
+        acc = mixer_smlad(c, s, acc);
+    }
+
+    return acc;
+}
+#else
+rt_inline rt_int32_t mixer_ssat16(rt_int32_t x)
+{
+    return x > 32767 ? 32767 : (x < -32768 ? -32768 : x);
+}
+
+static rt_int32_t mixer_fir(const rt_int16_t *coef, const rt_int16_t *x)
+{
+    rt_int32_t acc = 0;
+    int i;
+
+    for (i = 0; i < SRC_TAPS; i++)
+    {
+        acc += (rt_int32_t)coef[i] * x[i];
+    }
+
+    return acc;
+}
+#endif /* __ARM_FEATURE_DSP */
+
+/*
+ * Build the polyphase table of a windowed sinc for the given rates. The phase p of the
+ * table interpolates at p / SRC_PHASES after the newest input frame minus half the taps,
+ * coef[p][j] weights the j-th frame of the history, the oldest first.
+ */
+static rt_int16_t *mixer_src_build(rt_uint32_t rate_in, rt_uint32_t rate_out)
+{
+    rt_int16_t *coef;
+    rt_int32_t sum, q;
+    float cutoff, x, w, h[SRC_TAPS], total;
+    int p, j;
+
+    coef = rt_malloc(SRC_PHASES * SRC_TAPS * sizeof(rt_int16_t));
+    if (coef == RT_NULL)
+        return RT_NULL;
+
+    /* the cutoff is below the lower of the two Nyquist rates */
+    cutoff = 0.9f * (rate_out < rate_in ? (float)rate_out / rate_in : 1.0f);
+    for (p = 0; p < SRC_PHASES; p++)
+    {
+        total = 0;
+        for (j = 0; j < SRC_TAPS; j++)
+        {
+            /* the distance from the output point to the frame, the window is Blackman */
+            x = (SRC_TAPS - 1 - j) + (float)p / SRC_PHASES - SRC_TAPS / 2;
+            w = 0.42f + 0.5f * cosf(SRC_PI * x / (SRC_TAPS / 2)) + 0.08f * cosf(2 * SRC_PI * x / (SRC_TAPS / 2));
+            h[j] = (x == 0) ? cutoff : sinf(SRC_PI * cutoff * x) / (SRC_PI * x);
+            h[j] *= w;
+            total += h[j];
+        }
+
+        /* every phase has unity gain, the rounding error goes to the center tap */
+        sum = 0;
+        for (j = 0; j < SRC_TAPS; j++)
+        {
+            q = (rt_int32_t)(h[j] / total * 32768.0f + (h[j] >= 0 ? 0.5f : -0.5f));
+            coef[p * SRC_TAPS + j] = (rt_int16_t)mixer_ssat16(q);
+            sum += coef[p * SRC_TAPS + j];
+        }
+        j = SRC_TAPS / 2 - 1;
+        coef[p * SRC_TAPS + j] = (rt_int16_t)mixer_ssat16(coef[p * SRC_TAPS + j] + 32768 - sum);
+    }
+
+    return coef;
+}
+
+static rt_err_t mixer_stream_setup(struct rt_audio_mixer_stream *stream, struct rt_audio_configure *config)
+{
+    struct rt_audio_mixer *mixer = stream->mixer;
+    rt_int16_t *coef = RT_NULL;
+
+    if (config->samplebits != 16 || config->channels < 1 || config->channels > 2 ||
+            config->samplerate == 0 || config->samplerate > mixer->rate * AUDIO_MIXER_SRC_RATIO_MAX)
+        return -RT_EINVAL;
+
+    if (config->samplerate != mixer->rate)
+    {
+        coef = mixer_src_build(config->samplerate, mixer->rate);
+        if (coef == RT_NULL)
+            return -RT_ENOMEM;
+    }
+
+    rt_mutex_take(&mixer->lock, RT_WAITING_FOREVER);
+    /* the buffered frames were written in the old format */
+    rt_ringbuffer_reset(&stream->ring);
+    if (stream->coef != RT_NULL)
+        rt_free(stream->coef);
+    stream->coef = coef;
+    stream->config = *config;
+    stream->step = (rt_uint32_t)(((rt_uint64_t)config->samplerate << 16) / mixer->rate);
+    stream->frac = SRC_ONE;
+    stream->hist_index = 0;
+    rt_memset(stream->hist, 0, sizeof(stream->hist));
+    rt_mutex_release(&mixer->lock);
+
+    return RT_EOK;
+}
+
+/* resample the buffered frames of a stream and add them to the mix, the lock is held */
+static void mixer_stream_render(struct rt_audio_mixer *mixer, struct rt_audio_mixer_stream *stream, rt_size_t frames)
+{
+    rt_int16_t *in = mixer->scratch;
+    rt_int32_t *mix = mixer->mix;
+    rt_int32_t gain = stream->gain, left, right;
+    rt_size_t channels = stream->config.channels;
+    rt_size_t frame_bytes = channels * sizeof(rt_int16_t);
+    rt_size_t need, got, used = 0, n;
+    const rt_int16_t *coef;
+
+    if (stream->coef == RT_NULL)
+        need = frames;
+    else
+        need = (rt_size_t)(((rt_uint64_t)stream->frac + (rt_uint64_t)(frames - 1) * stream->step) >> 16);
+
+    got = rt_ringbuffer_data_len(&stream->ring) / frame_bytes;
+    if (got == 0)
+        return;
+    if (got < need)
+        stream->underruns++;
+    else
+        got = need;
+    rt_ringbuffer_get(&stream->ring, (rt_uint8_t *)in, got * frame_bytes);
+    if (stream->waiting)
+    {
+        stream->waiting = RT_FALSE;
+        rt_sem_release(&stream->space_sem);
+    }
+
+    if (stream->coef == RT_NULL)
+    {
+        for (n = 0; n < got; n++)
+        {
+            left = in[n * channels];
+            right = in[n * channels + channels - 1];
+            mix[n * 2] += (left * gain) >> 15;
+            mix[n * 2 + 1] += (right * gain) >> 15;
+        }
+        return;
+    }
+
+    for (n = 0; n < frames; n++)
+    {
+        /* move the history up to the output point */
+        while (stream->frac >= SRC_ONE)
+        {
+            if (used == got)
+                return;
+            stream->hist_index = (stream->hist_index + 1) % SRC_TAPS;
+            stream->hist[0][stream->hist_index] = stream->hist[0][stream->hist_index + SRC_TAPS] = in[used * channels];
+            if (channels == 2)
+                stream->hist[1][stream->hist_index] = stream->hist[1][stream->hist_index + SRC_TAPS] = in[used * 2 + 1];
+            used++;
+            stream->frac -= SRC_ONE;
+        }
+
+        coef = &stream->coef[(stream->frac >> (16 - RT_AUDIO_MIXER_SRC_PHASE_BITS)) * SRC_TAPS];
+        left = mixer_ssat16(mixer_fir(coef, &stream->hist[0][stream->hist_index + 1]) >> 15);
+        if (channels == 2)
+            right = mixer_ssat16(mixer_fir(coef, &stream->hist[1][stream->hist_index + 1]) >> 15);
+        else
+            right = left;
+        mix[n * 2] += (left * gain) >> 15;
+        mix[n * 2 + 1] += (right * gain) >> 15;
+
+        stream->frac += stream->step;
+    }
+}
+
+/**
+ * @brief Mix the playback streams into a buffer
+ *
+ * @param mixer   the mixer
+ * @param buffer  the interleaved two channel 16 bit output
+ * @param frames  the number of frames, at most RT_AUDIO_MIXER_PERIOD_FRAMES
+ *
+ * @return the number of frames, streams without enough data add silence
+ */
+rt_size_t rt_audio_mixer_render(struct rt_audio_mixer *mixer, rt_int16_t *buffer, rt_size_t frames)
+{
+    rt_size_t i;
+
+    RT_ASSERT(mixer != RT_NULL);
+    RT_ASSERT(frames <= RT_AUDIO_MIXER_PERIOD_FRAMES);
+
+    if (frames == 0)
+        return 0;
+
+    rt_memset(mixer->mix, 0, frames * 2 * sizeof(rt_int32_t));
+    rt_mutex_take(&mixer->lock, RT_WAITING_FOREVER);
+    for (i = 0; i < RT_AUDIO_MIXER_STREAMS; i++)
+    {
+        if (mixer->streams[i].opened)
+            mixer_stream_render(mixer, &mixer->streams[i], frames);
+    }
+    rt_mutex_release(&mixer->lock);
+
+    /* saturate the sum */
+    for (i = 0; i < frames * 2; i++)
+    {
+        buffer[i] = (rt_int16_t)mixer_ssat16(mixer->mix[i]);
+    }
+
+    return frames;
+}
+
+static rt_slist_t mixer_list = RT_SLIST_OBJECT_INIT(mixer_list);
+
+#define MIXER_PENDING_NONE      0
+#define MIXER_PENDING_PARTIAL   1
+#define MIXER_PENDING_PERIOD    2
+
+/*
+ * A period is rendered once a stream has the input of a whole period buffered, its ring is
+ * full or it is draining. Fewer frames wait for more writes until the deadline.
+ */
+static int mixer_pending(struct rt_audio_mixer *mixer)
+{
+    struct rt_audio_mixer_stream *stream;
+    rt_size_t frame_bytes, need, len;
+    int i, pending = MIXER_PENDING_NONE;
+
+    rt_mutex_take(&mixer->lock, RT_WAITING_FOREVER);
+    for (i = 0; i < RT_AUDIO_MIXER_STREAMS && pending != MIXER_PENDING_PERIOD; i++)
+    {
+        stream = &mixer->streams[i];
+        frame_bytes = stream->config.channels * sizeof(rt_int16_t);
+        len = rt_ringbuffer_data_len(&stream->ring);
+        if (!stream->opened || len < frame_bytes)
+            continue;
+
+        if (stream->coef == RT_NULL)
+            need = RT_AUDIO_MIXER_PERIOD_FRAMES;
+        else
+            need = (rt_size_t)(((rt_uint64_t)stream->frac + (rt_uint64_t)(RT_AUDIO_MIXER_PERIOD_FRAMES - 1) * stream->step) >> 16);
+        if (len >= need * frame_bytes || rt_ringbuffer_space_len(&stream->ring) < frame_bytes || stream->draining)
+            pending = MIXER_PENDING_PERIOD;
+        else
+            pending = MIXER_PENDING_PARTIAL;
+    }
+    rt_mutex_release(&mixer->lock);
+
+    return pending;
+}
+
+static void mixer_thread_entry(void *parameter)
+{
+    struct rt_audio_mixer *mixer = (struct rt_audio_mixer *)parameter;
+    rt_tick_t period_ticks, now;
+    rt_int16_t *buffer;
+    int pending, in_flight;
+
+    /* the time a period plays, the deadline of the frames short of a period is counted in it */
+    period_ticks = (rt_tick_t)((rt_uint64_t)RT_AUDIO_MIXER_PERIOD_FRAMES * RT_TICK_PER_SECOND / mixer->rate);
+    if (period_ticks == 0)
+        period_ticks = 1;
+
+    while (1)
+    {
+        pending = mixer_pending(mixer);
+        if (pending == MIXER_PENDING_NONE)
+        {
+            /* sleep while every stream is idle, the device plays silence meanwhile */
+            mixer->deadline_set = RT_FALSE;
+            rt_sem_take(&mixer->wake_sem, RT_WAITING_FOREVER);
+            continue;
+        }
+        if (pending == MIXER_PENDING_PARTIAL)
+        {
+            now = rt_tick_get();
+            if (!mixer->deadline_set)
+            {
+                /* before the periods the device has are played, or a period when it is idle */
+                in_flight = RT_AUDIO_MIXER_PERIODS - mixer->free_sem.value;
+                mixer->deadline = now + period_ticks * (in_flight > 0 ? in_flight : 1);
+                mixer->deadline_set = RT_TRUE;
+            }
+            /* coalesce the small writes until the deadline */
+            if ((rt_int32_t)(mixer->deadline - now) > 0)
+            {
+                rt_sem_take(&mixer->wake_sem, mixer->deadline - now);
+                continue;
+            }
+        }
+        mixer->deadline_set = RT_FALSE;
+
+        rt_sem_take(&mixer->free_sem, RT_WAITING_FOREVER);
+        buffer = &mixer->periods[mixer->period_index * RT_AUDIO_MIXER_PERIOD_FRAMES * 2];
+        mixer->period_index = (mixer->period_index + 1) % RT_AUDIO_MIXER_PERIODS;
+
+        rt_audio_mixer_render(mixer, buffer, RT_AUDIO_MIXER_PERIOD_FRAMES);
+        if (rt_audio_replay_submit((struct rt_audio_device *)mixer->device, buffer,
+                                   RT_AUDIO_MIXER_PERIOD_FRAMES * MIXER_FRAME_BYTES) != RT_EOK)
+        {
+            rt_sem_release(&mixer->free_sem);
+        }
+    }
+}
+
+static rt_err_t mixer_tx_done(rt_device_t dev, void *buffer)
+{
+    struct rt_audio_mixer *mixer;
+    rt_slist_t *node;
+
+    /* a period buffer of the mixer on this device is free again */
+    rt_slist_for_each(node, &mixer_list)
+    {
+        mixer = rt_slist_entry(node, struct rt_audio_mixer, node);
+        if (mixer->device == dev)
+        {
+            rt_sem_release(&mixer->free_sem);
+            break;
+        }
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t _mixer_stream_open(struct rt_device *dev, rt_uint16_t oflag)
+{
+    struct rt_audio_mixer_stream *stream = (struct rt_audio_mixer_stream *)dev;
+
+    if (oflag & RT_DEVICE_OFLAG_RDONLY)
+        return -RT_EIO;
+
+    rt_mutex_take(&stream->mixer->lock, RT_WAITING_FOREVER);
+    rt_ringbuffer_reset(&stream->ring);
+    stream->underruns = 0;
+    stream->opened = RT_TRUE;
+    rt_mutex_release(&stream->mixer->lock);
+
+    return RT_EOK;
+}
+
+static rt_err_t _mixer_stream_close(struct rt_device *dev)
+{
+    struct rt_audio_mixer_stream *stream = (struct rt_audio_mixer_stream *)dev;
+    struct rt_audio_mixer *mixer = stream->mixer;
+
+    /* let the mixer thread play the buffered frames */
+    rt_mutex_take(&mixer->lock, RT_WAITING_FOREVER);
+    while (mixer->device != RT_NULL && rt_ringbuffer_data_len(&stream->ring) >= stream->config.channels * sizeof(rt_int16_t))
+    {
+        stream->waiting = RT_TRUE;
+        stream->draining = RT_TRUE;
+        rt_mutex_release(&mixer->lock);
+        rt_sem_release(&mixer->wake_sem);
+        rt_sem_take(&stream->space_sem, RT_WAITING_FOREVER);
+        rt_mutex_take(&mixer->lock, RT_WAITING_FOREVER);
+    }
+    stream->draining = RT_FALSE;
+    stream->opened = RT_FALSE;
+    rt_mutex_release(&mixer->lock);
+
+    return RT_EOK;
+}
+
+static rt_ssize_t _mixer_stream_write(struct rt_device *dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct rt_audio_mixer_stream *stream = (struct rt_audio_mixer_stream *)dev;
+    struct rt_audio_mixer *mixer = stream->mixer;
+    const rt_uint8_t *ptr = (const rt_uint8_t *)buffer;
+    rt_size_t index = 0;
+
+    rt_mutex_take(&mixer->lock, RT_WAITING_FOREVER);
+    while (index < size)
+    {
+        index += rt_ringbuffer_put(&stream->ring, &ptr[index], size - index);
+        if (index < size)
+        {
+            /* wait for the mixer to take frames */
+            stream->waiting = RT_TRUE;
+            rt_mutex_release(&mixer->lock);
+            rt_sem_release(&mixer->wake_sem);
+            rt_sem_take(&stream->space_sem, RT_WAITING_FOREVER);
+            rt_mutex_take(&mixer->lock, RT_WAITING_FOREVER);
+        }
+    }
+    rt_mutex_release(&mixer->lock);
+
+    rt_sem_release(&mixer->wake_sem);
+
+    return index;
+}
+
+static rt_err_t _mixer_stream_control(struct rt_device *dev, int cmd, void *args)
+{
+    struct rt_audio_mixer_stream *stream = (struct rt_audio_mixer_stream *)dev;
+    struct rt_audio_caps *caps = (struct rt_audio_caps *)args;
+    struct rt_audio_configure config;
+    rt_err_t result = RT_EOK;
+
+    switch (cmd)
+    {
+    case AUDIO_CTL_GETCAPS:
+        if (caps->main_type == AUDIO_TYPE_OUTPUT)
+            caps->udata.config = stream->config;
+        else if (caps->main_type == AUDIO_TYPE_MIXER && caps->sub_type == AUDIO_MIXER_VOLUME)
+            caps->udata.value = (stream->gain * AUDIO_VOLUME_MAX + 16384) >> 15;
+        else
+            result = -RT_EINVAL;
+        break;
+
+    case AUDIO_CTL_CONFIGURE:
+        if (caps->main_type == AUDIO_TYPE_OUTPUT)
+        {
+            config = stream->config;
+            switch (caps->sub_type)
+            {
+            case AUDIO_DSP_PARAM:
+                config = caps->udata.config;
+                break;
+            case AUDIO_DSP_SAMPLERATE:
+                config.samplerate = caps->udata.config.samplerate;
+                break;
+            case AUDIO_DSP_CHANNELS:
+                config.channels = caps->udata.config.channels;
+                break;
+            case AUDIO_DSP_SAMPLEBITS:
+                config.samplebits = caps->udata.config.samplebits;
+                break;
+            default:
+                break;
+            }
+            result = mixer_stream_setup(stream, &config);
+        }
+        else if (caps->main_type == AUDIO_TYPE_MIXER && caps->sub_type == AUDIO_MIXER_VOLUME)
+        {
+            if (caps->udata.value < AUDIO_VOLUME_MIN || caps->udata.value > AUDIO_VOLUME_MAX)
+                return -RT_EINVAL;
+            stream->gain = (caps->udata.value << 15) / AUDIO_VOLUME_MAX;
+        }
+        else
+        {
+            result = -RT_EINVAL;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return result;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops mixer_stream_ops =
+{
+    RT_NULL,
+    _mixer_stream_open,
+    _mixer_stream_close,
+    RT_NULL,
+    _mixer_stream_write,
+    _mixer_stream_control
+};
+#endif
+
+/**
+ * @brief Create a mixer with RT_AUDIO_MIXER_STREAMS playback streams
+ *
+ * The streams are registered as the sound devices name0, name1 ... A thread mixes
+ * them and submits the periods to the device, which is configured for 16 bit stereo
+ * at the given rate. Without a device the mix is taken with rt_audio_mixer_render().
+ *
+ * @param name    the prefix of the stream device names
+ * @param device  the name of the sound device or RT_NULL
+ * @param rate    the sample rate of the mix
+ *
+ * @return the mixer or RT_NULL
+ */
+struct rt_audio_mixer *rt_audio_mixer_create(const char *name, const char *device, rt_uint32_t rate)
+{
+    struct rt_audio_mixer *mixer;
+    struct rt_audio_mixer_stream *stream;
+    struct rt_audio_caps caps;
+    char stream_name[RT_NAME_MAX];
+    rt_uint8_t *pool;
+    int i;
+
+    RT_ASSERT(name != RT_NULL);
+    RT_ASSERT(rate != 0);
+
+    mixer = rt_calloc(1, sizeof(struct rt_audio_mixer));
+    if (mixer == RT_NULL)
+        return RT_NULL;
+    mixer->rate = rate;
+    mixer->mix = rt_malloc(RT_AUDIO_MIXER_PERIOD_FRAMES * 2 * sizeof(rt_int32_t));
+    mixer->scratch = rt_malloc(MIXER_SCRATCH_FRAMES * MIXER_FRAME_BYTES);
+    pool = rt_malloc(RT_AUDIO_MIXER_STREAMS * RT_AUDIO_MIXER_STREAM_BUFSZ);
+    if (mixer->mix == RT_NULL || mixer->scratch == RT_NULL || pool == RT_NULL)
+        goto _fail;
+
+    if (device != RT_NULL)
+    {
+        mixer->device = rt_device_find(device);
+        if (mixer->device == RT_NULL || mixer->device->type != RT_Device_Class_Sound)
+        {
+            LOG_E("%s is not a sound device", device);
+            mixer->device = RT_NULL;
+            goto _fail;
+        }
+        mixer->periods = rt_malloc(RT_AUDIO_MIXER_PERIODS * RT_AUDIO_MIXER_PERIOD_FRAMES * MIXER_FRAME_BYTES);
+        if (mixer->periods == RT_NULL ||
+                rt_device_open(mixer->device, RT_DEVICE_OFLAG_WRONLY) != RT_EOK)
+        {
+            LOG_E("open sound device %s failed", device);
+            goto _fail;
+        }
+
+        caps.main_type = AUDIO_TYPE_OUTPUT;
+        caps.sub_type = AUDIO_DSP_PARAM;
+        caps.udata.config.samplerate = rate;
+        caps.udata.config.channels = 2;
+        caps.udata.config.samplebits = 16;
+        rt_device_control(mixer->device, AUDIO_CTL_CONFIGURE, &caps);
+        mixer->device->tx_complete = mixer_tx_done;
+    }
+
+    rt_mutex_init(&mixer->lock, "mixer", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&mixer->free_sem, "mixfree", RT_AUDIO_MIXER_PERIODS, RT_IPC_FLAG_PRIO);
+    rt_sem_init(&mixer->wake_sem, "mixwake", 0, RT_IPC_FLAG_PRIO);
+    rt_slist_init(&mixer->node);
+    rt_enter_critical();
+    rt_slist_append(&mixer_list, &mixer->node);
+    rt_exit_critical();
+
+    for (i = 0; i < RT_AUDIO_MIXER_STREAMS; i++)
+    {
+        stream = &mixer->streams[i];
+        stream->mixer = mixer;
+        stream->gain = 1 << 15;
+        stream->config.samplerate = rate;
+        stream->config.channels = 2;
+        stream->config.samplebits = 16;
+        stream->step = SRC_ONE;
+        stream->frac = SRC_ONE;
+        rt_ringbuffer_init(&stream->ring, pool + i * RT_AUDIO_MIXER_STREAM_BUFSZ, RT_AUDIO_MIXER_STREAM_BUFSZ);
+        rt_sem_init(&stream->space_sem, "mixspc", 0, RT_IPC_FLAG_PRIO);
+
+        stream->parent.type = RT_Device_Class_Sound;
+#ifdef RT_USING_DEVICE_OPS
+        stream->parent.ops = &mixer_stream_ops;
+#else
+        stream->parent.open = _mixer_stream_open;
+        stream->parent.close = _mixer_stream_close;
+        stream->parent.write = _mixer_stream_write;
+        stream->parent.control = _mixer_stream_control;
+#endif
+        rt_snprintf(stream_name, sizeof(stream_name), "%s%d", name, i);
+        rt_device_register(&stream->parent, stream_name, RT_DEVICE_FLAG_WRONLY);
+    }
+
+    if (mixer->device != RT_NULL)
+    {
+        mixer->thread = rt_thread_create("mixer", mixer_thread_entry, mixer, 1024,
+                                         RT_THREAD_PRIORITY_MAX / 4, 10);
+        if (mixer->thread != RT_NULL)
+            rt_thread_startup(mixer->thread);
+        else
+            LOG_E("create mixer thread failed");
+    }
+
+    return mixer;
+
+_fail:
+    if (mixer->device != RT_NULL && (mixer->device->open_flag & RT_DEVICE_OFLAG_WRONLY))
+        rt_device_close(mixer->device);
+    rt_free(mixer->periods);
+    rt_free(pool);
+    rt_free(mixer->scratch);
+    rt_free(mixer->mix);
+    rt_free(mixer);
+
+    return RT_NULL;
+}
+
+#endif /* RT_AUDIO_USING_MIXER */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#ifndef __AUDIO_MIXER_H__
+#define __AUDIO_MIXER_H__
+
+#include <rtdevice.h>
+
+#ifndef RT_AUDIO_MIXER_STREAMS
+#define RT_AUDIO_MIXER_STREAMS              4
+#endif
+#ifndef RT_AUDIO_MIXER_PERIOD_FRAMES
+#define RT_AUDIO_MIXER_PERIOD_FRAMES        256
+#endif
+#ifndef RT_AUDIO_MIXER_PERIODS
+#define RT_AUDIO_MIXER_PERIODS              3
+#endif
+#ifndef RT_AUDIO_MIXER_STREAM_BUFSZ
+#define RT_AUDIO_MIXER_STREAM_BUFSZ         4096
+#endif
+#ifndef RT_AUDIO_MIXER_SRC_TAPS
+#define RT_AUDIO_MIXER_SRC_TAPS             16
+#endif
+#ifndef RT_AUDIO_MIXER_SRC_PHASE_BITS
+#define RT_AUDIO_MIXER_SRC_PHASE_BITS       5
+#endif
+
+/* the input rate of a stream is at most this times the mixer rate */
+#define AUDIO_MIXER_SRC_RATIO_MAX           4
+
+/*
+ * A playback stream of the mixer, it's a sound device that takes 16 bit PCM with one
+ * or two channels at its own sample rate, set by AUDIO_CTL_CONFIGURE with the output
+ * type. The volume is set with the mixer type and AUDIO_MIXER_VOLUME.
+ */
+struct rt_audio_mixer_stream
+{
+    struct rt_device parent;
+    struct rt_audio_mixer *mixer;
+
+    struct rt_ringbuffer ring;
+    struct rt_semaphore space_sem;
+    rt_bool_t waiting;
+    rt_bool_t opened;
+    rt_bool_t draining;                     /* closing, the frames short of a period are played */
+
+    struct rt_audio_configure config;
+    rt_int32_t gain;                        /* Q15 */
+    rt_uint32_t underruns;                  /* periods the stream ran dry in */
+
+    /* polyphase resampler, coef is RT_NULL when the rate matches the mixer */
+    rt_int16_t *coef;
+    rt_uint32_t step;                       /* input frames per output frame, Q16 */
+    rt_uint32_t frac;                       /* position after the newest input frame, Q16 */
+    rt_uint16_t hist_index;
+    rt_int16_t hist[2][RT_AUDIO_MIXER_SRC_TAPS * 2];
+};
+
+struct rt_audio_mixer
+{
+    rt_slist_t node;
+    struct rt_device *device;               /* the sound device, RT_NULL for rt_audio_mixer_render() only */
+    rt_uint32_t rate;
+    struct rt_mutex lock;
+
+    struct rt_audio_mixer_stream streams[RT_AUDIO_MIXER_STREAMS];
+    rt_int32_t *mix;                        /* the sum of one period, two channels */
+    rt_int16_t *scratch;                    /* the input frames of a stream for one period */
+
+    rt_int16_t *periods;                    /* the buffers submitted to the device */
+    rt_uint8_t period_index;
+    struct rt_semaphore free_sem;
+    struct rt_semaphore wake_sem;
+    rt_tick_t deadline;                     /* when the frames short of a period are played */
+    rt_bool_t deadline_set;
+    rt_thread_t thread;
+};
+
+struct rt_audio_mixer *rt_audio_mixer_create(const char *name, const char *device, rt_uint32_t rate);
+rt_size_t rt_audio_mixer_render(struct rt_audio_mixer *mixer, rt_int16_t *buffer, rt_size_t frames);
+
+#endif /* __AUDIO_MIXER_H__ */
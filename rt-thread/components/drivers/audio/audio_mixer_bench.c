@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Audio mixer benchmark.
+ *
+ * A mixer without sound device is created at 48 kHz, for every input rate one to
+ * RT_AUDIO_MIXER_STREAMS stereo streams are written and mixed period by period with
+ * rt_audio_mixer_render(). The cost is reported in cputime clocks, the core cycles on
+ * Cortex-M with the DWT counter, per output sample and stream. 48 kHz streams skip the
+ * resampler.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(RT_AUDIO_USING_BENCH) && defined(RT_AUDIO_USING_MIXER) && defined(RT_USING_FINSH)
+
+#include "audio_mixer.h"
+
+#include <msh_bench.h>
+
+#define BENCH_RATE              48000
+#define BENCH_FRAMES            RT_AUDIO_MIXER_PERIOD_FRAMES
+#define BENCH_FRAME_BYTES       (2 * sizeof(rt_int16_t))
+
+static const rt_uint32_t bench_rates[] = {48000, 44100, 32000, 22050, 16000, 8000, 96000};
+
+static struct rt_audio_mixer *bench_mixer;
+
+static rt_uint64_t bench_run(rt_uint32_t rate, int streams, rt_uint32_t periods, rt_int16_t *in, rt_int16_t *out)
+{
+    rt_device_t dev[RT_AUDIO_MIXER_STREAMS];
+    struct rt_audio_caps caps;
+    char name[RT_NAME_MAX];
+    rt_uint32_t n, written = 0, target, t;
+    rt_uint64_t clocks = 0;
+    int i;
+
+    caps.main_type = AUDIO_TYPE_OUTPUT;
+    caps.sub_type = AUDIO_DSP_PARAM;
+    caps.udata.config.samplerate = rate;
+    caps.udata.config.channels = 2;
+    caps.udata.config.samplebits = 16;
+    for (i = 0; i < streams; i++)
+    {
+        rt_snprintf(name, sizeof(name), "mb%d", i);
+        dev[i] = rt_device_find(name);
+        rt_device_open(dev[i], RT_DEVICE_OFLAG_WRONLY);
+        rt_device_control(dev[i], AUDIO_CTL_CONFIGURE, &caps);
+    }
+
+    for (n = 0; n < periods; n++)
+    {
+        /* what the resampler takes for the next period, plus its history */
+        target = (rt_uint64_t)(n + 1) * BENCH_FRAMES * rate / BENCH_RATE + RT_AUDIO_MIXER_SRC_TAPS;
+        for (i = 0; i < streams; i++)
+        {
+            rt_device_write(dev[i], 0, in, (target - written) * BENCH_FRAME_BYTES);
+        }
+        written = target;
+
+        t = BENCH_CLOCK();
+        rt_audio_mixer_render(bench_mixer, out, BENCH_FRAMES);
+        clocks += BENCH_CLOCK() - t;
+    }
+
+    for (i = 0; i < streams; i++)
+    {
+        rt_device_close(dev[i]);
+    }
+
+    return clocks;
+}
+
+static void audio_mixer_bench(int argc, char **argv)
+{
+    rt_uint32_t periods = 200, frames, max_frames, per_sample;
+    rt_int16_t *in, *out;
+    rt_uint64_t clocks;
+    int i, streams;
+
+    if (argc > 1) periods = strtoul(argv[1], RT_NULL, 0);
+    if (periods == 0)
+    {
+        rt_kprintf("Usage: audio_mixer_bench [periods]\n");
+        return;
+    }
+    if (bench_mixer == RT_NULL)
+    {
+        bench_mixer = rt_audio_mixer_create("mb", RT_NULL, BENCH_RATE);
+        if (bench_mixer == RT_NULL)
+        {
+            rt_kprintf("create mixer failed\n");
+            return;
+        }
+    }
+
+    max_frames = BENCH_FRAMES * AUDIO_MIXER_SRC_RATIO_MAX + RT_AUDIO_MIXER_SRC_TAPS;
+    in = rt_malloc(max_frames * BENCH_FRAME_BYTES);
+    out = rt_malloc(BENCH_FRAMES * BENCH_FRAME_BYTES);
+    if (in == RT_NULL || out == RT_NULL)
+    {
+        rt_kprintf("no memory for the buffers\n");
+        goto _exit;
+    }
+    for (i = 0; i < max_frames * 2; i++)
+    {
+        in[i] = (rt_int16_t)(rand() - RAND_MAX / 2);
+    }
+
+    rt_kprintf("mix rate %d, %d frames per period, %d taps, %d phases\n", BENCH_RATE, BENCH_FRAMES,
+               RT_AUDIO_MIXER_SRC_TAPS, 1 << RT_AUDIO_MIXER_SRC_PHASE_BITS);
+    rt_kprintf("rate    streams  clk/sample/stream x100\n");
+    for (i = 0; i < sizeof(bench_rates) / sizeof(bench_rates[0]); i++)
+    {
+        /* one period of input must fit the stream buffer, nothing else drains it */
+        frames = (rt_uint64_t)BENCH_FRAMES * bench_rates[i] / BENCH_RATE + RT_AUDIO_MIXER_SRC_TAPS + 1;
+        if (frames * BENCH_FRAME_BYTES > RT_AUDIO_MIXER_STREAM_BUFSZ || frames > max_frames)
+        {
+            rt_kprintf("%-7d stream buffer too small\n", bench_rates[i]);
+            continue;
+        }
+        for (streams = 1; streams <= RT_AUDIO_MIXER_STREAMS; streams++)
+        {
+            clocks = bench_run(bench_rates[i], streams, periods, in, out);
+            per_sample = (rt_uint32_t)(clocks * 100 / ((rt_uint64_t)periods * BENCH_FRAMES * streams));
+            rt_kprintf("%-7d %7d  %d.%02d\n", bench_rates[i], streams, per_sample / 100, per_sample % 100);
+        }
+    }
+
+_exit:
+    rt_free(in);
+    rt_free(out);
+}
+MSH_CMD_EXPORT(audio_mixer_bench, audio mixer cycles per sample per stream);
+
+#endif /* defined(RT_AUDIO_USING_BENCH) && defined(RT_AUDIO_USING_MIXER) && defined(RT_USING_FINSH) */
@@ -7,15 +7,280 @@
  * Date           Author            Notes
  * 2015-05-14     aubrcool@qq.com   first version
  * 2015-07-06     Bernard           code cleanup and remove RT_CAN_USING_LED;
+ * 2026-10-18     RT-Thread         add lock-free rx ring, batched read and software id filter
  */
 
 #include <rthw.h>
 #include <rtthread.h>
 #include <rtdevice.h>
 
+#ifdef RT_CAN_USING_RX_TIMESTAMP
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define CAN_RX_TIMESTAMP()  ((rt_uint32_t)clock_cpu_gettime())
+#else
+#define CAN_RX_TIMESTAMP()  ((rt_uint32_t)rt_tick_get())
+#endif
+#endif /*RT_CAN_USING_RX_TIMESTAMP*/
+
 #define CAN_LOCK(can)   rt_mutex_take(&(can->lock), RT_WAITING_FOREVER)
 #define CAN_UNLOCK(can) rt_mutex_release(&(can->lock))
 
+#ifdef RT_CAN_USING_LOCKLESS_RX
+#define CAN_SW_FILTER_EMPTY     (-2)
+#define CAN_SW_FILTER_DROP      (-2)
+#define CAN_SW_FILTER_KEY(id, ide)  ((rt_uint32_t)(id) | ((rt_uint32_t)(ide) << 31))
+
+struct can_sw_filter_entry
+{
+    rt_uint32_t key;
+    rt_uint32_t mask;
+    rt_int32_t  bank;
+};
+
+/* exact ids are hashed with open addressing, masked items are matched one by one */
+struct can_sw_filter_index
+{
+    rt_uint32_t hash_mask;
+    rt_uint32_t masked_count;
+    struct can_sw_filter_entry *hash;
+    struct can_sw_filter_entry *masked;
+};
+
+static struct rt_can_rx_ring *_can_ring_create(rt_uint32_t size)
+{
+    struct rt_can_rx_ring *ring;
+    rt_uint32_t capacity = 1;
+
+    while (capacity < size)
+    {
+        capacity <<= 1;
+    }
+
+    ring = (struct rt_can_rx_ring *)rt_malloc(sizeof(struct rt_can_rx_ring) +
+            capacity * sizeof(struct rt_can_msg));
+    if (ring == RT_NULL)
+    {
+        return RT_NULL;
+    }
+    ring->head   = 0;
+    ring->tail   = 0;
+    ring->mask   = capacity - 1;
+    ring->drops  = 0;
+    ring->buffer = (struct rt_can_msg *)(ring + 1);
+
+    return ring;
+}
+
+rt_inline rt_uint32_t _can_ring_count(struct rt_can_rx_ring *ring)
+{
+    return (rt_uint32_t)((rt_ubase_t)rt_atomic_load(&ring->head) - (rt_ubase_t)rt_atomic_load(&ring->tail));
+}
+
+/* producer side, called from rt_hw_can_isr only */
+rt_inline rt_bool_t _can_ring_put(struct rt_can_rx_ring *ring, const struct rt_can_msg *msg)
+{
+    rt_atomic_t head = ring->head;
+
+    if ((rt_ubase_t)head - (rt_ubase_t)rt_atomic_load(&ring->tail) > ring->mask)
+    {
+        ring->drops++;
+        return RT_FALSE;
+    }
+    rt_memcpy(&ring->buffer[head & ring->mask], msg, sizeof(struct rt_can_msg));
+    /* publish the frame after its content is written */
+    rt_atomic_store(&ring->head, head + 1);
+
+    return RT_TRUE;
+}
+
+/* consumer side, copies up to count frames and releases them with a single tail update */
+static rt_uint32_t _can_ring_get(struct rt_can_rx_ring *ring, struct rt_can_msg *data, rt_uint32_t count)
+{
+    rt_atomic_t tail;
+    rt_uint32_t num, index, first;
+
+    do
+    {
+        tail = rt_atomic_load(&ring->tail);
+        num = (rt_uint32_t)((rt_ubase_t)rt_atomic_load(&ring->head) - (rt_ubase_t)tail);
+        if (num > count)
+        {
+            num = count;
+        }
+        if (num == 0)
+        {
+            break;
+        }
+
+        index = tail & ring->mask;
+        first = ring->mask + 1 - index;
+        if (first > num)
+        {
+            first = num;
+        }
+        rt_memcpy(data, &ring->buffer[index], first * sizeof(struct rt_can_msg));
+        if (num > first)
+        {
+            rt_memcpy(data + first, &ring->buffer[0], (num - first) * sizeof(struct rt_can_msg));
+        }
+    } while (!rt_atomic_compare_exchange_strong(&ring->tail, &tail, tail + num));
+
+    return num;
+}
+
+static rt_err_t _can_sw_filter_set(struct rt_can_device *can, struct rt_can_sw_filter_config *cfg)
+{
+    struct can_sw_filter_index *index = RT_NULL, *old;
+    struct can_sw_filter_entry *entry;
+    rt_uint32_t i, exact = 0, hash_size = 1, slot;
+    rt_base_t level;
+
+    if (cfg != RT_NULL && cfg->count)
+    {
+        RT_ASSERT(cfg->items != RT_NULL);
+
+        for (i = 0; i < cfg->count; i++)
+        {
+            if ((cfg->items[i].mask & 0x1FFFFFFF) == 0x1FFFFFFF)
+            {
+                exact++;
+            }
+        }
+        /* keep the load factor of the hash table under one half */
+        while (hash_size < exact * 2)
+        {
+            hash_size <<= 1;
+        }
+
+        index = (struct can_sw_filter_index *)rt_malloc(sizeof(struct can_sw_filter_index) +
+                (hash_size + cfg->count - exact) * sizeof(struct can_sw_filter_entry));
+        if (index == RT_NULL)
+        {
+            return -RT_ENOMEM;
+        }
+        index->hash_mask = hash_size - 1;
+        index->masked_count = 0;
+        index->hash = (struct can_sw_filter_entry *)(index + 1);
+        index->masked = index->hash + hash_size;
+        for (i = 0; i < hash_size; i++)
+        {
+            index->hash[i].bank = CAN_SW_FILTER_EMPTY;
+        }
+
+        for (i = 0; i < cfg->count; i++)
+        {
+            struct rt_can_sw_filter_item *item = &cfg->items[i];
+
+#ifdef RT_CAN_USING_HDR
+            if (item->hdr_bank < -1 || item->hdr_bank >= (rt_int32_t)can->config.maxhdr)
+#else
+            if (item->hdr_bank != -1)
+#endif
+            {
+                rt_free(index);
+                return -RT_EINVAL;
+            }
+
+            if ((item->mask & 0x1FFFFFFF) == 0x1FFFFFFF)
+            {
+                slot = CAN_SW_FILTER_KEY(item->id, item->ide) & index->hash_mask;
+                while (index->hash[slot].bank != CAN_SW_FILTER_EMPTY)
+                {
+                    slot = (slot + 1) & index->hash_mask;
+                }
+                entry = &index->hash[slot];
+            }
+            else
+            {
+                entry = &index->masked[index->masked_count++];
+            }
+            entry->key  = CAN_SW_FILTER_KEY(item->id & item->mask, item->ide);
+            entry->mask = item->mask & 0x1FFFFFFF;
+            entry->bank = item->hdr_bank;
+        }
+    }
+
+    level = rt_hw_interrupt_disable();
+    old = (struct can_sw_filter_index *)can->sw_filter;
+    can->sw_filter = index;
+    rt_hw_interrupt_enable(level);
+
+    if (old != RT_NULL)
+    {
+        rt_free(old);
+    }
+
+    return RT_EOK;
+}
+
+/* returns the hdr bank of the frame, -1 for the default ring or CAN_SW_FILTER_DROP */
+rt_inline rt_int32_t _can_sw_filter_match(struct can_sw_filter_index *index, const struct rt_can_msg *msg)
+{
+    rt_uint32_t key = CAN_SW_FILTER_KEY(msg->id, msg->ide);
+    rt_uint32_t slot, i;
+
+    slot = key & index->hash_mask;
+    while (index->hash[slot].bank != CAN_SW_FILTER_EMPTY)
+    {
+        if (index->hash[slot].key == key)
+        {
+            return index->hash[slot].bank;
+        }
+        slot = (slot + 1) & index->hash_mask;
+    }
+
+    for (i = 0; i < index->masked_count; i++)
+    {
+        if (CAN_SW_FILTER_KEY(msg->id & index->masked[i].mask, msg->ide) == index->masked[i].key)
+        {
+            return index->masked[i].bank;
+        }
+    }
+
+    return CAN_SW_FILTER_DROP;
+}
+
+/* the ring a received frame is delivered to, RT_NULL when it is filtered out */
+rt_inline struct rt_can_rx_ring *_can_rx_ring_select(struct rt_can_device *can, struct rt_can_msg *msg)
+{
+    struct can_sw_filter_index *index = (struct can_sw_filter_index *)can->sw_filter;
+    rt_int32_t bank = -1;
+
+#ifdef RT_CAN_USING_HDR
+    if (can->hdr != RT_NULL && msg->hdr_index >= 0 && msg->hdr_index < can->config.maxhdr &&
+            can->hdr[msg->hdr_index].connected && can->hdr[msg->hdr_index].ring != RT_NULL)
+    {
+        return can->hdr[msg->hdr_index].ring;
+    }
+#endif /*RT_CAN_USING_HDR*/
+
+    if (index != RT_NULL)
+    {
+        bank = _can_sw_filter_match(index, msg);
+        if (bank == CAN_SW_FILTER_DROP)
+        {
+            can->sw_filtered++;
+            return RT_NULL;
+        }
+    }
+    msg->hdr_index = bank;
+
+#ifdef RT_CAN_USING_HDR
+    if (bank >= 0)
+    {
+        if (can->hdr != RT_NULL && can->hdr[bank].ring != RT_NULL)
+        {
+            return can->hdr[bank].ring;
+        }
+        msg->hdr_index = -1;
+    }
+#endif /*RT_CAN_USING_HDR*/
+
+    return (struct rt_can_rx_ring *)can->can_rx;
+}
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
+
 static rt_err_t rt_can_init(struct rt_device *dev)
 {
     rt_err_t result = RT_EOK;
@@ -43,6 +308,41 @@ static rt_err_t rt_can_init(struct rt_device *dev)
 /*
  * can interrupt routines
  */
+#ifdef RT_CAN_USING_LOCKLESS_RX
+rt_inline int _can_int_rx(struct rt_can_device *can, struct rt_can_msg *data, int msgs)
+{
+    struct rt_can_rx_ring *ring;
+    rt_uint32_t num;
+
+    RT_ASSERT(can != RT_NULL);
+
+    ring = (struct rt_can_rx_ring *)can->can_rx;
+    RT_ASSERT(ring != RT_NULL);
+
+#ifdef RT_CAN_USING_HDR
+    if (data->hdr_index >= 0)
+    {
+        if (can->hdr == RT_NULL || data->hdr_index >= can->config.maxhdr)
+        {
+            return 0;
+        }
+        ring = can->hdr[data->hdr_index].ring;
+        if (ring == RT_NULL)
+        {
+            return 0;
+        }
+    }
+    else if (data->hdr_index != -1)
+    {
+        return 0;
+    }
+#endif /*RT_CAN_USING_HDR*/
+
+    num = _can_ring_get(ring, data, msgs / sizeof(struct rt_can_msg));
+
+    return num * sizeof(struct rt_can_msg);
+}
+#else
 rt_inline int _can_int_rx(struct rt_can_device *can, struct rt_can_msg *data, int msgs)
 {
     int size;
@@ -126,6 +426,7 @@ rt_inline int _can_int_rx(struct rt_can_device *can, struct rt_can_msg *data, in
 
     return (size - msgs);
 }
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
 
 rt_inline int _can_int_tx(struct rt_can_device *can, const struct rt_can_msg *data, int msgs)
 {
@@ -275,6 +576,17 @@ static rt_err_t rt_can_open(struct rt_device *dev, rt_uint16_t oflag)
     dev->open_flag = oflag & 0xff;
     if (can->can_rx == RT_NULL)
     {
+#ifdef RT_CAN_USING_LOCKLESS_RX
+        if (oflag & RT_DEVICE_FLAG_INT_RX)
+        {
+            can->can_rx = _can_ring_create(can->config.msgboxsz);
+            RT_ASSERT(can->can_rx != RT_NULL);
+
+            dev->open_flag |= RT_DEVICE_FLAG_INT_RX;
+            /* open can rx interrupt */
+            can->ops->control(can, RT_DEVICE_CTRL_SET_INT, (void *)RT_DEVICE_FLAG_INT_RX);
+        }
+#else
         if (oflag & RT_DEVICE_FLAG_INT_RX)
         {
             int i = 0;
@@ -303,6 +615,7 @@ static rt_err_t rt_can_open(struct rt_device *dev, rt_uint16_t oflag)
             /* open can rx interrupt */
             can->ops->control(can, RT_DEVICE_CTRL_SET_INT, (void *)RT_DEVICE_FLAG_INT_RX);
         }
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
     }
 
     if (can->can_tx == RT_NULL)
@@ -395,9 +708,29 @@ static rt_err_t rt_can_close(struct rt_device *dev)
     can->status_indicate.ind = RT_NULL;
     can->status_indicate.args = RT_NULL;
 
+#ifdef RT_CAN_USING_LOCKLESS_RX
+    if (dev->open_flag & RT_DEVICE_FLAG_INT_RX)
+    {
+        /* stop the producer before the rings are released */
+        can->ops->control(can, RT_DEVICE_CTRL_CLR_INT, (void *)RT_DEVICE_FLAG_INT_RX);
+    }
+    _can_sw_filter_set(can, RT_NULL);
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
+
 #ifdef RT_CAN_USING_HDR
     if (can->hdr != RT_NULL)
     {
+#ifdef RT_CAN_USING_LOCKLESS_RX
+        int i;
+
+        for (i = 0; i < can->config.maxhdr; i++)
+        {
+            if (can->hdr[i].ring != RT_NULL)
+            {
+                rt_free(can->hdr[i].ring);
+            }
+        }
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
         rt_free(can->hdr);
         can->hdr = RT_NULL;
     }
@@ -405,6 +738,13 @@ static rt_err_t rt_can_close(struct rt_device *dev)
 
     if (dev->open_flag & RT_DEVICE_FLAG_INT_RX)
     {
+#ifdef RT_CAN_USING_LOCKLESS_RX
+        RT_ASSERT(can->can_rx != RT_NULL);
+
+        rt_free(can->can_rx);
+        dev->open_flag &= ~RT_DEVICE_FLAG_INT_RX;
+        can->can_rx = RT_NULL;
+#else
         struct rt_can_rx_fifo *rx_fifo;
 
         rx_fifo = (struct rt_can_rx_fifo *)can->can_rx;
@@ -415,6 +755,7 @@ static rt_err_t rt_can_close(struct rt_device *dev)
         can->can_rx = RT_NULL;
         /* clear can rx interrupt */
         can->ops->control(can, RT_DEVICE_CTRL_CLR_INT, (void *)RT_DEVICE_FLAG_INT_RX);
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
     }
 
     if (dev->open_flag & RT_DEVICE_FLAG_INT_TX)
@@ -589,6 +930,17 @@ static rt_err_t rt_can_control(struct rt_device *dev,
                     continue;
                 }
 
+#ifdef RT_CAN_USING_LOCKLESS_RX
+                if (can->hdr[pitem->hdr_bank].ring == RT_NULL)
+                {
+                    /* the ring is kept until the device is closed, the ISR may still hold it */
+                    can->hdr[pitem->hdr_bank].ring = _can_ring_create(can->config.msgboxsz);
+                    if (can->hdr[pitem->hdr_bank].ring == RT_NULL)
+                    {
+                        return -RT_ENOMEM;
+                    }
+                }
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
                 level = rt_hw_interrupt_disable();
                 if (!can->hdr[pitem->hdr_bank].connected)
                 {
@@ -640,6 +992,11 @@ static rt_err_t rt_can_control(struct rt_device *dev,
         }
         break;
 #endif /*RT_CAN_USING_HDR*/
+#ifdef RT_CAN_USING_LOCKLESS_RX
+    case RT_CAN_CMD_SET_SW_FILTER:
+        res = _can_sw_filter_set(can, (struct rt_can_sw_filter_config *)args);
+        break;
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
 #ifdef RT_CAN_USING_BUS_HOOK
     case RT_CAN_CMD_SET_BUS_HOOK:
         can->bus_hook = (rt_can_bus_hook) args;
@@ -721,6 +1078,10 @@ rt_err_t rt_hw_can_register(struct rt_can_device    *can,
 #endif
     can->can_rx         = RT_NULL;
     can->can_tx         = RT_NULL;
+#ifdef RT_CAN_USING_LOCKLESS_RX
+    can->sw_filter      = RT_NULL;
+    can->sw_filtered    = 0;
+#endif
     rt_mutex_init(&(can->lock), "can", RT_IPC_FLAG_PRIO);
 #ifdef RT_CAN_USING_BUS_HOOK
     can->bus_hook       = RT_NULL;
@@ -767,6 +1128,57 @@ void rt_hw_can_isr(struct rt_can_device *can, int event)
         can->status.dropedrcvpkg++;
         rt_hw_interrupt_enable(level);
     }
+#ifdef RT_CAN_USING_LOCKLESS_RX
+    case RT_CAN_EVENT_RX_IND:
+    {
+        struct rt_can_msg tmpmsg;
+        struct rt_can_rx_ring *ring;
+        rt_size_t rx_length;
+        int ch;
+
+        RT_ASSERT(can->can_rx != RT_NULL);
+        /* interrupt mode receive */
+        RT_ASSERT(can->parent.open_flag & RT_DEVICE_FLAG_INT_RX);
+
+        ch = can->ops->recvmsg(can, &tmpmsg, event >> 8);
+        if (ch == -1) break;
+#ifdef RT_CAN_USING_RX_TIMESTAMP
+        tmpmsg.timestamp = CAN_RX_TIMESTAMP();
+#endif
+
+        /* the counters are only written by this ISR, which is not re-entered for one device */
+        can->status.rcvpkg++;
+        can->status.rcvchange = 1;
+
+        ring = _can_rx_ring_select(can, &tmpmsg);
+        if (ring == RT_NULL)
+        {
+            break;
+        }
+        if (!_can_ring_put(ring, &tmpmsg))
+        {
+            can->status.dropedrcvpkg++;
+        }
+        rx_length = _can_ring_count(ring) * sizeof(struct rt_can_msg);
+
+        /* invoke callback */
+#ifdef RT_CAN_USING_HDR
+        if (tmpmsg.hdr_index >= 0 && can->hdr[tmpmsg.hdr_index].filter.ind)
+        {
+            can->hdr[tmpmsg.hdr_index].filter.ind(&can->parent, can->hdr[tmpmsg.hdr_index].filter.args,
+                                                  tmpmsg.hdr_index, rx_length);
+        }
+        else
+#endif
+        {
+            if (can->parent.rx_indicate != RT_NULL && rx_length)
+            {
+                can->parent.rx_indicate(&can->parent, rx_length);
+            }
+        }
+        break;
+    }
+#else
     case RT_CAN_EVENT_RX_IND:
     {
         struct rt_can_msg tmpmsg;
@@ -787,6 +1199,9 @@ void rt_hw_can_isr(struct rt_can_device *can, int event)
         no = event >> 8;
         ch = can->ops->recvmsg(can, &tmpmsg, no);
         if (ch == -1) break;
+#ifdef RT_CAN_USING_RX_TIMESTAMP
+        tmpmsg.timestamp = CAN_RX_TIMESTAMP();
+#endif
 
         /* disable interrupt */
         level = rt_hw_interrupt_disable();
@@ -881,6 +1296,7 @@ void rt_hw_can_isr(struct rt_can_device *can, int event)
         }
         break;
     }
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
 
     case RT_CAN_EVENT_TX_DONE:
     case RT_CAN_EVENT_TX_FAIL:
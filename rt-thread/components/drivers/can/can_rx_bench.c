@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * CAN receive benchmark on a simulated bus.
+ *
+ * A simulated CAN device is fed by a high priority thread which emulates the receive
+ * interrupt: every tick it calls rt_hw_can_isr() with the interrupt disabled for the number
+ * of frames the configured bus load produces. A reader thread drains the device in batches,
+ * optionally stalling after each batch, and checks the frame sequence. The dropped frames,
+ * the time spent in the ISR and the receive latency (with RT_CAN_USING_RX_TIMESTAMP) are
+ * reported, build with and without RT_CAN_USING_LOCKLESS_RX to compare.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(RT_CAN_USING_RX_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_MAX_BATCH         32
+
+struct can_sim
+{
+    struct rt_can_device can;
+    rt_uint32_t seq;
+    rt_bool_t registered;
+};
+
+struct bench_stat
+{
+    rt_uint32_t sent;
+    rt_uint32_t received;
+    rt_uint32_t lost;
+    rt_uint32_t reads;
+    rt_uint32_t isr_max;
+    rt_uint64_t isr_total;
+    rt_uint32_t latency_max;
+    rt_uint64_t latency_total;
+};
+
+static struct can_sim sim;
+static struct bench_stat result;
+static struct rt_semaphore rx_sem;
+static struct rt_semaphore done_sem;
+static volatile rt_bool_t bench_running;
+
+static rt_err_t sim_configure(struct rt_can_device *can, struct can_configure *cfg)
+{
+    return RT_EOK;
+}
+
+static rt_err_t sim_control(struct rt_can_device *can, int cmd, void *arg)
+{
+    return RT_EOK;
+}
+
+static rt_ssize_t sim_sendmsg(struct rt_can_device *can, const void *buf, rt_uint32_t boxno)
+{
+    return -RT_ENOSYS;
+}
+
+static rt_ssize_t sim_recvmsg(struct rt_can_device *can, void *buf, rt_uint32_t boxno)
+{
+    struct rt_can_msg *msg = (struct rt_can_msg *)buf;
+
+    rt_memset(msg, 0, sizeof(struct rt_can_msg));
+    msg->id = sim.seq & 0x7FF;
+    msg->ide = RT_CAN_STDID;
+    msg->rtr = RT_CAN_DTR;
+    msg->len = 8;
+    msg->hdr_index = -1;
+    msg->rxfifo = boxno;
+    rt_memcpy(msg->data, &sim.seq, sizeof(sim.seq));
+    sim.seq++;
+
+    return RT_EOK;
+}
+
+static const struct rt_can_ops sim_ops =
+{
+    sim_configure,
+    sim_control,
+    sim_sendmsg,
+    sim_recvmsg,
+};
+
+static rt_err_t sim_rx_ind(rt_device_t dev, rt_size_t size)
+{
+    rt_sem_release(&rx_sem);
+    return RT_EOK;
+}
+
+static void producer_entry(void *parameter)
+{
+    rt_uint32_t rate = (rt_ubase_t)parameter;
+    rt_uint32_t frames, remainder = 0, start, cost;
+    rt_base_t level;
+
+    while (bench_running)
+    {
+        frames = (rate + remainder) / RT_TICK_PER_SECOND;
+        remainder = (rate + remainder) % RT_TICK_PER_SECOND;
+
+        while (frames--)
+        {
+            level = rt_hw_interrupt_disable();
+            rt_interrupt_enter();
+            start = BENCH_CLOCK();
+            rt_hw_can_isr(&sim.can, RT_CAN_EVENT_RX_IND | CAN_RX_FIFO0 << 8);
+            cost = BENCH_CLOCK() - start;
+            rt_interrupt_leave();
+            rt_hw_interrupt_enable(level);
+
+            result.sent++;
+            result.isr_total += cost;
+            if (cost > result.isr_max)
+            {
+                result.isr_max = cost;
+            }
+        }
+        rt_thread_delay(1);
+    }
+
+    rt_sem_release(&done_sem);
+}
+
+static void consumer_entry(void *parameter)
+{
+    rt_uint32_t stall_ms = (rt_ubase_t)parameter >> 16;
+    rt_uint32_t batch = (rt_ubase_t)parameter & 0xFFFF;
+    struct rt_can_msg msgs[BENCH_MAX_BATCH];
+    rt_uint32_t expect = 0, seq, num, i;
+    rt_ssize_t size;
+
+    while (bench_running || rx_sem.value)
+    {
+        if (rt_sem_take(&rx_sem, rt_tick_from_millisecond(10)) != RT_EOK)
+        {
+            continue;
+        }
+
+        for (;;)
+        {
+            msgs[0].hdr_index = -1;
+            size = rt_device_read(&sim.can.parent, 0, msgs, batch * sizeof(struct rt_can_msg));
+            if (size <= 0)
+            {
+                break;
+            }
+
+            num = size / sizeof(struct rt_can_msg);
+            result.reads++;
+            for (i = 0; i < num; i++)
+            {
+                rt_memcpy(&seq, msgs[i].data, sizeof(seq));
+                result.lost += seq - expect;
+                expect = seq + 1;
+#ifdef RT_CAN_USING_RX_TIMESTAMP
+                {
+                    rt_uint32_t latency = BENCH_CLOCK() - msgs[i].timestamp;
+
+                    result.latency_total += latency;
+                    if (latency > result.latency_max)
+                    {
+                        result.latency_max = latency;
+                    }
+                }
+#endif
+            }
+            result.received += num;
+
+            if (stall_ms)
+            {
+                rt_thread_mdelay(stall_ms);
+            }
+        }
+    }
+
+    rt_sem_release(&done_sem);
+}
+
+static void can_rx_bench(int argc, char **argv)
+{
+    rt_uint32_t rate = 8000, seconds = 2, batch = 8, stall_ms = 0;
+    rt_thread_t producer, consumer;
+
+    if (argc > 1) rate = strtoul(argv[1], RT_NULL, 0);
+    if (argc > 2) seconds = strtoul(argv[2], RT_NULL, 0);
+    if (argc > 3) batch = strtoul(argv[3], RT_NULL, 0);
+    if (argc > 4) stall_ms = strtoul(argv[4], RT_NULL, 0);
+    if (rate == 0 || seconds == 0 || batch == 0 || batch > BENCH_MAX_BATCH)
+    {
+        rt_kprintf("Usage: can_rx_bench [frames/s] [seconds] [batch(1-%d)] [stall_ms]\n", BENCH_MAX_BATCH);
+        return;
+    }
+
+    if (!sim.registered)
+    {
+        struct can_configure config = CANDEFAULTCONFIG;
+
+        config.ticks = RT_TICK_PER_SECOND;
+#ifdef RT_CAN_USING_HDR
+        config.maxhdr = 14;
+#endif
+        sim.can.config = config;
+        if (rt_hw_can_register(&sim.can, "cansim", &sim_ops, RT_NULL) != RT_EOK)
+        {
+            rt_kprintf("register simulated can device failed\n");
+            return;
+        }
+        sim.registered = RT_TRUE;
+    }
+
+    rt_memset(&result, 0, sizeof(result));
+    sim.seq = 0;
+    sim.can.status.dropedrcvpkg = 0;
+    rt_sem_init(&rx_sem, "canrx", 0, RT_IPC_FLAG_PRIO);
+    rt_sem_init(&done_sem, "candone", 0, RT_IPC_FLAG_PRIO);
+    if (rt_device_open(&sim.can.parent, RT_DEVICE_FLAG_INT_RX) != RT_EOK)
+    {
+        rt_sem_detach(&rx_sem);
+        rt_sem_detach(&done_sem);
+        return;
+    }
+    rt_device_set_rx_indicate(&sim.can.parent, sim_rx_ind);
+
+    bench_running = RT_TRUE;
+    consumer = rt_thread_create("canrd", consumer_entry, (void *)(rt_ubase_t)(stall_ms << 16 | batch),
+                                2048, RT_THREAD_PRIORITY_MAX / 2, 10);
+    producer = rt_thread_create("canbus", producer_entry, (void *)(rt_ubase_t)rate,
+                                1024, 1, 10);
+    if (consumer == RT_NULL || producer == RT_NULL)
+    {
+        if (consumer) rt_thread_delete(consumer);
+        if (producer) rt_thread_delete(producer);
+        rt_device_close(&sim.can.parent);
+        rt_sem_detach(&rx_sem);
+        rt_sem_detach(&done_sem);
+        return;
+    }
+    rt_thread_startup(consumer);
+    rt_thread_startup(producer);
+
+    rt_thread_mdelay(seconds * 1000);
+    bench_running = RT_FALSE;
+    /* wait for the producer to stop and the reader to drain the device */
+    rt_sem_take(&done_sem, RT_WAITING_FOREVER);
+    rt_sem_take(&done_sem, RT_WAITING_FOREVER);
+
+    rt_kprintf("%s rx, %d frames/s, batch %d, stall %d ms\n",
+#ifdef RT_CAN_USING_LOCKLESS_RX
+               "lock-free",
+#else
+               "list",
+#endif
+               rate, batch, stall_ms);
+    rt_kprintf("sent %d, received %d, dropped %d, lost %d, reads %d\n", result.sent, result.received,
+               sim.can.status.dropedrcvpkg, result.lost, result.reads);
+    rt_kprintf("isr avg %d us, max %d us\n",
+               result.sent ? BENCH_CLOCK_US(result.isr_total / result.sent) : 0, BENCH_CLOCK_US(result.isr_max));
+#ifdef RT_CAN_USING_RX_TIMESTAMP
+    rt_kprintf("latency avg %d us, max %d us\n",
+               result.received ? BENCH_CLOCK_US(result.latency_total / result.received) : 0,
+               BENCH_CLOCK_US(result.latency_max));
+#endif
+
+    rt_device_set_rx_indicate(&sim.can.parent, RT_NULL);
+    rt_device_close(&sim.can.parent);
+    rt_sem_detach(&rx_sem);
+    rt_sem_detach(&done_sem);
+}
+MSH_CMD_EXPORT(can_rx_bench, CAN receive drops and latency on a simulated bus);
+
+#endif /* defined(RT_CAN_USING_RX_BENCH) && defined(RT_USING_FINSH) */
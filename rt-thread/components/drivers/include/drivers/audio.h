@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2017-05-09     Urey         first version
  * 2019-07-09     Zero-Free    improve device ops interface and data flows
+ * 2026-10-18     RT-Thread    add zero-copy replay and replay statistics
  *
  */
 
@@ -23,6 +24,7 @@
 #define AUDIO_CTL_START                     _AUDIO_CTL(3)
 #define AUDIO_CTL_STOP                      _AUDIO_CTL(4)
 #define AUDIO_CTL_GETBUFFERINFO             _AUDIO_CTL(5)
+#define AUDIO_CTL_GETREPLAYSTAT             _AUDIO_CTL(6)
 
 /* Audio Device Types */
 #define AUDIO_TYPE_QUERY                    0x00
@@ -78,6 +80,10 @@
 #define AUDIO_VOLUME_MIN                    (0)
 
 #define CFG_AUDIO_REPLAY_QUEUE_COUNT        4
+#define AUDIO_REPLAY_INFLIGHT_MAX           4
+
+/* Replay buffer flags */
+#define AUDIO_BUF_FLAG_ZEROCOPY             0x01        /* transmit() DMAs from the given buffer */
 
 enum
 {
@@ -86,13 +92,22 @@ enum
     AUDIO_STREAM_LAST = AUDIO_STREAM_RECORD,
 };
 
-/* the preferred number and size of audio pipeline buffer for the audio device */
+/*
+ * the preferred number and size of audio pipeline buffer for the audio device.
+ *
+ * Without AUDIO_BUF_FLAG_ZEROCOPY the replay data is copied into the buffer block by block
+ * and transmit() is called for every block. With the flag transmit() hands a queued buffer
+ * of up to block_size bytes to the DMA, up to block_count of them are in flight, and the
+ * driver calls rt_audio_tx_complete() for each one in order. The first block_size bytes of
+ * the buffer are played as silence when no data is queued.
+ */
 struct rt_audio_buf_info
 {
     rt_uint8_t *buffer;
     rt_uint16_t block_size;
     rt_uint16_t block_count;
     rt_uint32_t total_size;
+    rt_uint32_t flags;
 };
 
 struct rt_audio_device;
@@ -130,6 +145,24 @@ struct rt_audio_caps
     } udata;
 };
 
+struct rt_audio_replay_stat
+{
+    rt_uint32_t underruns;                  /* blocks played as silence for lack of data */
+    rt_uint32_t buffers;                    /* buffers played and given back */
+    rt_uint32_t queued_bytes;               /* bytes written or submitted and not played yet */
+    rt_uint32_t max_queued_bytes;
+    rt_uint32_t latency_us;                 /* play time of the queued bytes, 0 until configured */
+    rt_uint32_t max_latency_us;
+};
+
+/* a block handed to the DMA in zero-copy replay */
+struct rt_audio_replay_chunk
+{
+    const rt_uint8_t *buffer;               /* the queued buffer, RT_NULL for silence */
+    rt_uint16_t size;
+    rt_bool_t last;                         /* the buffer is released when this block is played */
+};
+
 struct rt_audio_replay
 {
     struct rt_mempool *mp;
@@ -139,10 +172,16 @@ struct rt_audio_replay
     struct rt_audio_buf_info buf_info;
     rt_uint8_t *write_data;
     rt_uint16_t write_index;
-    rt_uint16_t read_index;
+    rt_uint32_t read_index;
     rt_uint32_t pos;
     rt_uint8_t event;
     rt_bool_t activated;
+
+    struct rt_audio_configure config;
+    struct rt_audio_replay_stat stat;
+    struct rt_audio_replay_chunk inflight[AUDIO_REPLAY_INFLIGHT_MAX];
+    rt_uint8_t inflight_head;
+    rt_uint8_t inflight_count;
 };
 
 struct rt_audio_record
@@ -161,6 +200,7 @@ struct rt_audio_device
 
 rt_err_t    rt_audio_register(struct rt_audio_device *audio, const char *name, rt_uint32_t flag, void *data);
 void        rt_audio_tx_complete(struct rt_audio_device *audio);
+rt_err_t    rt_audio_replay_submit(struct rt_audio_device *audio, const void *buffer, rt_size_t size);
 void        rt_audio_rx_done(struct rt_audio_device *audio, rt_uint8_t *pbuf, rt_size_t len);
 
 /* Device Control Commands */
@@ -190,6 +190,7 @@ struct rt_can_ops;
 #define RT_CAN_CMD_SET_CANFD        0x1A
 #define RT_CAN_CMD_SET_BAUD_FD      0x1B
 #define RT_CAN_CMD_SET_BITTIMING    0x1C
+#define RT_CAN_CMD_SET_SW_FILTER    0x1D
 
 #define RT_DEVICE_CAN_INT_ERR       0x1000
 
@@ -230,6 +231,42 @@ struct rt_can_status
     rt_uint32_t lasterrtype;
 };
 
+#ifdef RT_CAN_USING_LOCKLESS_RX
+/*
+ * Lock-free receive ring. The ISR is the only producer and advances head, readers consume
+ * with a compare-and-swap on tail, so neither side needs to disable the interrupt. The
+ * size is a power of two, a frame received while the ring is full is dropped.
+ */
+struct rt_can_rx_ring
+{
+    rt_atomic_t head;
+    rt_atomic_t tail;
+    rt_uint32_t mask;
+    rt_uint32_t drops;
+    struct rt_can_msg *buffer;
+};
+
+/*
+ * Software ID filter, applied to the frames which are not claimed by a connected hardware
+ * filter bank. A frame matching an item goes to the ring of hdr_bank (-1 is the default
+ * ring), frames matching no item are dropped once a software filter is installed.
+ */
+struct rt_can_sw_filter_item
+{
+    rt_uint32_t id  : 29;
+    rt_uint32_t ide : 1;
+    rt_uint32_t reserved : 2;
+    rt_uint32_t mask;
+    rt_int32_t  hdr_bank;
+};
+
+struct rt_can_sw_filter_config
+{
+    rt_uint32_t count;
+    struct rt_can_sw_filter_item *items;
+};
+#endif /*RT_CAN_USING_LOCKLESS_RX*/
+
 #ifdef RT_CAN_USING_HDR
 struct rt_can_hdr
 {
@@ -237,6 +274,9 @@ struct rt_can_hdr
     rt_uint32_t msgs;
     struct rt_can_filter_item filter;
     struct rt_list_node list;
+#ifdef RT_CAN_USING_LOCKLESS_RX
+    struct rt_can_rx_ring *ring;
+#endif
 };
 #endif
 struct rt_can_device;
@@ -268,6 +308,10 @@ struct rt_can_device
     struct rt_mutex lock;
     void *can_rx;
     void *can_tx;
+#ifdef RT_CAN_USING_LOCKLESS_RX
+    void *sw_filter;
+    rt_uint32_t sw_filtered;
+#endif
 };
 typedef struct rt_can_device *rt_can_t;
 
@@ -301,6 +345,9 @@ struct rt_can_msg
 #else
     rt_uint8_t data[8];
 #endif
+#ifdef RT_CAN_USING_RX_TIMESTAMP
+    rt_uint32_t timestamp;/*Receive time, in cputime counts with RT_USING_CPUTIME or in ticks*/
+#endif
 };
 typedef struct rt_can_msg *rt_can_msg_t;
 
@@ -14,6 +14,10 @@
 
 #include <rtthread.h>
 #include "pin.h"
+#ifdef RT_SENSOR_USING_STREAM
+#include "ipc/workqueue.h"
+#include "ipc/completion.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -258,6 +262,8 @@ extern "C" {
 #define RT_SENSOR_CTRL_SET_FETCH_MODE         (RT_DEVICE_CTRL_BASE(Sensor) + 3)  /* set fetch data mode */
 #define RT_SENSOR_CTRL_SET_POWER_MODE         (RT_DEVICE_CTRL_BASE(Sensor) + 4)  /* set power mode */
 #define RT_SENSOR_CTRL_SET_ACCURACY_MODE      (RT_DEVICE_CTRL_BASE(Sensor) + 5)  /* set accuracy mode */
+#define RT_SENSOR_CTRL_STREAM_START           (RT_DEVICE_CTRL_BASE(Sensor) + 6)  /* start streaming, arg: ring size in samples, 0 for default */
+#define RT_SENSOR_CTRL_STREAM_STOP            (RT_DEVICE_CTRL_BASE(Sensor) + 7)  /* stop streaming */
 
 #define  RT_SENSOR_CTRL_USER_CMD_START 0x100  /* User commands should be greater than 0x100 */
 
@@ -307,6 +313,34 @@ struct rt_sensor_config
     struct rt_device_pin_mode    irq_pin;   /* Interrupt pin, The purpose of this pin is to notification read data */
 };
 
+#ifdef RT_SENSOR_USING_STREAM
+struct rt_sensor_stream_reader
+{
+    rt_list_t                    list;
+    rt_uint32_t                  tail;      /* Index of the next sample to read */
+    rt_uint32_t                  overflow;  /* Samples overwritten before this reader got them */
+    void (*notify)(struct rt_sensor_stream_reader *reader, rt_size_t avail); /* Called after new samples are pushed */
+    void                        *user_data;
+};
+
+struct rt_sensor_stream
+{
+    struct rt_sensor_data       *buf;       /* The ring of samples, size is a power of two */
+    rt_uint32_t                  mask;
+    rt_atomic_t                  head;      /* Index of the next sample to write */
+    struct rt_sensor_data       *scratch;   /* One batch fetched from the driver */
+    rt_uint32_t                  batch;
+    rt_tick_t                    period;    /* Fetch period in polling mode */
+    rt_bool_t                    running;   /* Cleared by the stop, the work does not resubmit then */
+    rt_atomic_t                  ref;       /* The sensor holds one, each user of the stream one more */
+    struct rt_completion         released;  /* Done when the last reference is dropped */
+    struct rt_mutex              lock;      /* Protects the reader list and the running flag */
+    rt_list_t                    readers;
+    struct rt_sensor_stream_reader dev_reader; /* Reader behind rt_device_read() */
+    struct rt_work               work;
+};
+#endif /* RT_SENSOR_USING_STREAM */
+
 typedef struct rt_sensor_device *rt_sensor_t;
 typedef struct rt_sensor_data   *rt_sensor_data_t;
 typedef struct rt_sensor_info   *rt_sensor_info_t;
@@ -328,6 +362,9 @@ struct rt_sensor_device
     struct rt_sensor_module     *module;    /* The sensor module */
 
     rt_err_t (*irq_handle)(rt_sensor_t sensor);             /* Called when an interrupt is generated, registered by the driver */
+#ifdef RT_SENSOR_USING_STREAM
+    struct rt_sensor_stream     *stream;    /* The ring the samples are streamed to, RT_NULL if not streaming */
+#endif
 };
 
 struct rt_sensor_module
@@ -399,6 +436,15 @@ int rt_hw_sensor_register(rt_sensor_t     sensor,
                           rt_uint32_t     flag,
                           void           *data);
 
+#ifdef RT_SENSOR_USING_STREAM
+void rt_sensor_stream_notify(rt_sensor_t sensor);
+rt_size_t rt_sensor_stream_push(rt_sensor_t sensor, const struct rt_sensor_data *data, rt_size_t count);
+rt_err_t rt_sensor_stream_subscribe(rt_sensor_t sensor, struct rt_sensor_stream_reader *reader);
+rt_err_t rt_sensor_stream_unsubscribe(rt_sensor_t sensor, struct rt_sensor_stream_reader *reader);
+rt_ssize_t rt_sensor_stream_read(rt_sensor_t sensor, struct rt_sensor_stream_reader *reader,
+                                 rt_sensor_data_t buf, rt_size_t len);
+#endif /* RT_SENSOR_USING_STREAM */
+
 #ifdef __cplusplus
 }
 #endif
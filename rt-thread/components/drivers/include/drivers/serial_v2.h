@@ -72,6 +72,12 @@
 #define RT_SERIAL_EVENT_TX_DMADONE      0x04    /* Tx DMA transfer done */
 #define RT_SERIAL_EVENT_RX_TIMEOUT      0x05    /* Rx timeout    */
 
+#ifdef RT_SERIAL_USING_RX_WAKE
+#define RT_SERIAL_CTRL_SET_RX_WAKE      (RT_DEVICE_CTRL_BASE(Char) + 0x20)  /* set the rx wake condition */
+#define RT_SERIAL_CTRL_GET_RX_STAT      (RT_DEVICE_CTRL_BASE(Char) + 0x21)  /* get the rx counters */
+#define RT_SERIAL_CTRL_CLR_RX_STAT      (RT_DEVICE_CTRL_BASE(Char) + 0x22)  /* clear the rx counters */
+#endif
+
 #define RT_SERIAL_ERR_OVERRUN           0x01
 #define RT_SERIAL_ERR_FRAMING           0x02
 #define RT_SERIAL_ERR_PARITY            0x03
@@ -150,6 +156,27 @@ struct rt_serial_tx_fifo
     rt_uint8_t buffer[];
 };
 
+#ifdef RT_SERIAL_USING_RX_WAKE
+/*
+ * Serial receive wake condition, the reader is woken up once the buffered data
+ * reaches the threshold or the line has been idle, instead of once per chunk.
+ * All zero keeps waking the reader on every received chunk.
+ */
+struct rt_serial_rx_wake
+{
+    rt_uint16_t threshold;      /* bytes buffered before the reader is woken up */
+    rt_uint16_t idle_ms;        /* idle time before the reader is woken up, 0: idle line event of the driver only */
+};
+
+struct rt_serial_rx_stat
+{
+    rt_uint32_t rx_bytes;       /* bytes received */
+    rt_uint32_t overruns;       /* bytes dropped as the rx buffer was full */
+    rt_uint32_t wakeups;        /* times the reader was woken up */
+    rt_uint32_t idle_events;    /* wakeups caused by an idle line */
+};
+#endif /* RT_SERIAL_USING_RX_WAKE */
+
 struct rt_serial_device
 {
     struct rt_device          parent;
@@ -161,6 +188,12 @@ struct rt_serial_device
     void *serial_tx;
 
     struct rt_device_notify rx_notify;
+
+#ifdef RT_SERIAL_USING_RX_WAKE
+    struct rt_serial_rx_wake rx_wake;
+    struct rt_serial_rx_stat rx_stat;
+    struct rt_timer          rx_idle_timer;
+#endif
 };
 
 /**
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Sustained sample rate benchmark of the sensor streaming mode.
+ *
+ * The simulated accelerometer produces samples at the given output data rate into a hardware
+ * FIFO of SIM_FIFO_DEPTH samples, every fetch costs SIM_BUS_COST_US of bus time. In the
+ * legacy mode a reader calls rt_device_read() in polling mode, each read is one bus transaction
+ * returning one sample. In the streaming mode a timer emulates the FIFO watermark interrupt,
+ * a fast and a slow reader subscribe to the stream.
+ */
+
+#include <rthw.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(RT_SENSOR_USING_STREAM_BENCH) && defined(RT_USING_FINSH)
+
+#define SIM_FIFO_DEPTH          32
+#define SIM_WATERMARK           16
+#define SIM_BUS_COST_US         200
+#define BENCH_SLOW_STALL_MS     20
+
+struct sim_sensor
+{
+    struct rt_sensor_device sensor;
+    rt_uint32_t odr;
+    rt_tick_t start;
+    rt_uint32_t produced;               /* samples the sensor has produced into its FIFO */
+    rt_uint32_t fetched;                /* samples taken out of the FIFO */
+    rt_uint32_t hw_overrun;
+    rt_bool_t registered;
+};
+
+struct bench_reader
+{
+    struct rt_sensor_stream_reader reader;
+    struct rt_semaphore sem;
+    rt_uint32_t stall_ms;
+    rt_uint32_t received;
+    rt_uint32_t lost;
+    rt_uint32_t expect;
+};
+
+static struct sim_sensor sim;
+static struct rt_semaphore done_sem;
+static volatile rt_bool_t bench_running;
+
+/* the samples the sensor has produced since the start, the FIFO keeps the newest ones */
+static rt_uint32_t sim_fifo_level(void)
+{
+    rt_uint32_t produced = (rt_uint64_t)(rt_tick_get() - sim.start) * sim.odr / RT_TICK_PER_SECOND;
+
+    sim.produced = produced;
+    if (produced - sim.fetched > SIM_FIFO_DEPTH)
+    {
+        sim.hw_overrun += produced - sim.fetched - SIM_FIFO_DEPTH;
+        sim.fetched = produced - SIM_FIFO_DEPTH;
+    }
+
+    return produced - sim.fetched;
+}
+
+static rt_ssize_t sim_fetch_data(rt_sensor_t sensor, rt_sensor_data_t buf, rt_size_t len)
+{
+    rt_uint32_t level, i;
+
+    /* one bus transaction reads the FIFO level and the samples */
+    rt_hw_us_delay(SIM_BUS_COST_US);
+
+    level = sim_fifo_level();
+    if (len > level)
+    {
+        len = level;
+    }
+    for (i = 0; i < len; i++)
+    {
+        buf[i].type = RT_SENSOR_TYPE_ACCE;
+        buf[i].timestamp = 0;
+        buf[i].data.acce.x = (rt_sensor_float_t)(sim.fetched + i);
+        buf[i].data.acce.y = 0;
+        buf[i].data.acce.z = 1000;
+    }
+    sim.fetched += len;
+
+    return len;
+}
+
+static rt_err_t sim_control(rt_sensor_t sensor, int cmd, void *arg)
+{
+    return RT_EOK;
+}
+
+static const struct rt_sensor_ops sim_ops =
+{
+    sim_fetch_data,
+    sim_control
+};
+
+static void watermark_timeout(void *parameter)
+{
+    rt_uint32_t produced = (rt_uint64_t)(rt_tick_get() - sim.start) * sim.odr / RT_TICK_PER_SECOND;
+
+    /* emulate the FIFO watermark interrupt, the FIFO itself is only touched by the fetch */
+    if (produced - sim.fetched >= SIM_WATERMARK)
+    {
+        rt_sensor_stream_notify(&sim.sensor);
+    }
+}
+
+static void reader_count(struct bench_reader *br, rt_sensor_data_t data, rt_size_t num)
+{
+    rt_uint32_t seq, i;
+
+    for (i = 0; i < num; i++)
+    {
+        seq = (rt_uint32_t)data[i].data.acce.x;
+        if (br->received || br->lost)
+        {
+            br->lost += seq - br->expect;
+        }
+        br->expect = seq + 1;
+    }
+    br->received += num;
+}
+
+static void reader_notify(struct rt_sensor_stream_reader *reader, rt_size_t avail)
+{
+    struct bench_reader *br = (struct bench_reader *)reader->user_data;
+
+    rt_sem_release(&br->sem);
+}
+
+static void reader_entry(void *parameter)
+{
+    struct bench_reader *br = (struct bench_reader *)parameter;
+    struct rt_sensor_data data[SIM_FIFO_DEPTH];
+    rt_ssize_t num;
+
+    while (bench_running)
+    {
+        if (rt_sem_take(&br->sem, rt_tick_from_millisecond(10)) != RT_EOK)
+        {
+            continue;
+        }
+        while ((num = rt_sensor_stream_read(&sim.sensor, &br->reader, data, SIM_FIFO_DEPTH)) > 0)
+        {
+            reader_count(br, data, num);
+        }
+        if (br->stall_ms)
+        {
+            rt_thread_mdelay(br->stall_ms);
+        }
+    }
+
+    rt_sem_release(&done_sem);
+}
+
+static void bench_legacy(rt_uint32_t seconds)
+{
+    struct bench_reader br = {0};
+    struct rt_sensor_data data;
+    rt_tick_t end;
+
+    if (rt_device_open(&sim.sensor.parent, RT_DEVICE_FLAG_RDONLY) != RT_EOK)
+    {
+        return;
+    }
+    sim.start = rt_tick_get();
+    sim.produced = sim.fetched = sim.hw_overrun = 0;
+
+    end = rt_tick_get() + seconds * RT_TICK_PER_SECOND;
+    while ((rt_tick_t)(end - rt_tick_get()) < RT_TICK_MAX / 2)
+    {
+        if (rt_device_read(&sim.sensor.parent, 0, &data, 1) == 1)
+        {
+            reader_count(&br, &data, 1);
+        }
+        else
+        {
+            rt_thread_delay(1);
+        }
+    }
+    rt_device_close(&sim.sensor.parent);
+
+    rt_kprintf("legacy %8d %8d %8d %8d\n", sim.produced, br.received / seconds, br.lost, sim.hw_overrun);
+}
+
+static void bench_stream(rt_uint32_t seconds)
+{
+    static struct bench_reader readers[2];
+    struct rt_timer watermark;
+    rt_thread_t tid;
+    int i;
+
+    if (rt_device_open(&sim.sensor.parent, RT_DEVICE_FLAG_FIFO_RX) != RT_EOK)
+    {
+        return;
+    }
+    if (rt_device_control(&sim.sensor.parent, RT_SENSOR_CTRL_STREAM_START, RT_NULL) != RT_EOK)
+    {
+        rt_device_close(&sim.sensor.parent);
+        return;
+    }
+
+    rt_sem_init(&done_sem, "ssdone", 0, RT_IPC_FLAG_PRIO);
+    bench_running = RT_TRUE;
+    for (i = 0; i < 2; i++)
+    {
+        rt_memset(&readers[i], 0, sizeof(readers[i]));
+        readers[i].stall_ms = i ? BENCH_SLOW_STALL_MS : 0;
+        readers[i].reader.notify = reader_notify;
+        readers[i].reader.user_data = &readers[i];
+        rt_sem_init(&readers[i].sem, "ssrd", 0, RT_IPC_FLAG_PRIO);
+        rt_sensor_stream_subscribe(&sim.sensor, &readers[i].reader);
+        tid = rt_thread_create("ssrd", reader_entry, &readers[i], 1024 + sizeof(struct rt_sensor_data) * SIM_FIFO_DEPTH,
+                               RT_THREAD_PRIORITY_MAX / 2, 10);
+        if (tid != RT_NULL)
+        {
+            rt_thread_startup(tid);
+        }
+        else
+        {
+            rt_sem_release(&done_sem);
+        }
+    }
+
+    sim.start = rt_tick_get();
+    sim.produced = sim.fetched = sim.hw_overrun = 0;
+    rt_timer_init(&watermark, "sswm", watermark_timeout, RT_NULL, 1, RT_TIMER_FLAG_PERIODIC);
+    rt_timer_start(&watermark);
+
+    rt_thread_mdelay(seconds * 1000);
+
+    rt_timer_stop(&watermark);
+    rt_timer_detach(&watermark);
+    bench_running = RT_FALSE;
+    rt_sem_take(&done_sem, RT_WAITING_FOREVER);
+    rt_sem_take(&done_sem, RT_WAITING_FOREVER);
+
+    for (i = 0; i < 2; i++)
+    {
+        rt_sensor_stream_unsubscribe(&sim.sensor, &readers[i].reader);
+        rt_sem_detach(&readers[i].sem);
+        rt_kprintf("%-6s %8d %8d %8d %8d %8d\n", i ? "slow" : "fast", sim.produced,
+                   readers[i].received / seconds, readers[i].lost, sim.hw_overrun, readers[i].reader.overflow);
+    }
+    rt_device_control(&sim.sensor.parent, RT_SENSOR_CTRL_STREAM_STOP, RT_NULL);
+    rt_device_close(&sim.sensor.parent);
+    rt_sem_detach(&done_sem);
+}
+
+static void sensor_stream_bench(int argc, char **argv)
+{
+    rt_uint32_t odr = 1000, seconds = 2;
+
+    if (argc > 1) odr = strtoul(argv[1], RT_NULL, 0);
+    if (argc > 2) seconds = strtoul(argv[2], RT_NULL, 0);
+    if (odr == 0 || seconds == 0)
+    {
+        rt_kprintf("Usage: sensor_stream_bench [odr_hz] [seconds]\n");
+        return;
+    }
+
+    if (!sim.registered)
+    {
+        sim.sensor.info.type = RT_SENSOR_TYPE_ACCE;
+        sim.sensor.info.vendor = RT_SENSOR_VENDOR_UNKNOWN;
+        sim.sensor.info.name = "sim";
+        sim.sensor.info.unit = RT_SENSOR_UNIT_MG;
+        sim.sensor.info.intf_type = RT_SENSOR_INTF_I2C;
+        sim.sensor.info.fifo_max = SIM_FIFO_DEPTH;
+        sim.sensor.config.irq_pin.pin = PIN_IRQ_PIN_NONE;
+        sim.sensor.ops = &sim_ops;
+        if (rt_hw_sensor_register(&sim.sensor, "sim", RT_DEVICE_FLAG_RDONLY | RT_DEVICE_FLAG_FIFO_RX, RT_NULL) != RT_EOK)
+        {
+            return;
+        }
+        sim.registered = RT_TRUE;
+    }
+    sim.odr = odr;
+    sim.sensor.info.acquire_min = 1000.0f / odr;
+
+    rt_kprintf("odr %d Hz, fifo %d, watermark %d, %d us per bus transaction\n",
+               odr, SIM_FIFO_DEPTH, SIM_WATERMARK, SIM_BUS_COST_US);
+    rt_kprintf("mode   produced  rate/s    lost     hw_ovr   ring_ovr\n");
+    bench_legacy(seconds);
+    bench_stream(seconds);
+}
+MSH_CMD_EXPORT(sensor_stream_bench, sensor sustained sample rate with and without streaming);
+
+#endif /* defined(RT_SENSOR_USING_STREAM_BENCH) && defined(RT_USING_FINSH) */
@@ -8,6 +8,8 @@
  * 2019-01-31     flybreak     first version
  * 2020-02-22     luhuadong    support custom commands
  * 2022-12-17     Meco Man     re-implement sensor framework
+ * 2026-10-18     RT-Thread    add streaming mode with timestamped ring buffer
+ * 2026-10-18     RT-Thread    reference the stream, wait for its users on stop
  */
 
 #include <drivers/sensor_v2.h>
@@ -44,9 +46,439 @@ static char *const sensor_name_str[] =
     "bp-"        /* Blood Pressure    */
 };
 
+#ifdef RT_SENSOR_USING_STREAM
+/* Samples of the reader not yet read, the reader is moved forward if it was overrun */
+static rt_uint32_t _stream_reader_avail(struct rt_sensor_stream *stream, struct rt_sensor_stream_reader *reader)
+{
+    rt_uint32_t head = (rt_uint32_t)rt_atomic_load(&stream->head);
+
+    if (head - reader->tail > stream->mask + 1)
+    {
+        reader->overflow += head - reader->tail - (stream->mask + 1);
+        reader->tail = head - (stream->mask + 1);
+    }
+
+    return head - reader->tail;
+}
+
+static rt_ssize_t _stream_read(struct rt_sensor_stream *stream, struct rt_sensor_stream_reader *reader,
+                               rt_sensor_data_t buf, rt_size_t len)
+{
+    rt_uint32_t num, index, first, head, lost;
+
+    num = _stream_reader_avail(stream, reader);
+    if (num > len)
+    {
+        num = len;
+    }
+    if (num == 0)
+    {
+        return 0;
+    }
+
+    index = reader->tail & stream->mask;
+    first = stream->mask + 1 - index;
+    if (first > num)
+    {
+        first = num;
+    }
+    rt_memcpy(buf, &stream->buf[index], first * sizeof(struct rt_sensor_data));
+    if (num > first)
+    {
+        rt_memcpy(buf + first, &stream->buf[0], (num - first) * sizeof(struct rt_sensor_data));
+    }
+
+    /*
+     * The producer never waits for the readers. The sample it is writing now and all the
+     * published ones older than one ring may have changed while they were copied, drop them.
+     */
+    head = (rt_uint32_t)rt_atomic_load(&stream->head);
+    if (head - reader->tail + 1 > stream->mask + 1)
+    {
+        lost = head - reader->tail + 1 - (stream->mask + 1);
+        if (lost > num)
+        {
+            lost = num;
+        }
+        rt_memmove(buf, buf + lost, (num - lost) * sizeof(struct rt_sensor_data));
+        reader->overflow += lost;
+        reader->tail += lost;
+        num -= lost;
+    }
+    reader->tail += num;
+
+    return num;
+}
+
+/* Take a reference of the stream of a sensor, RT_NULL if it is not streaming */
+static struct rt_sensor_stream *_stream_get(rt_sensor_t sensor)
+{
+    struct rt_sensor_stream *stream;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    stream = sensor->stream;
+    if (stream != RT_NULL)
+    {
+        rt_atomic_add(&stream->ref, 1);
+    }
+    rt_hw_interrupt_enable(level);
+
+    return stream;
+}
+
+static void _stream_put(struct rt_sensor_stream *stream)
+{
+    if (rt_atomic_sub(&stream->ref, 1) == 1)
+    {
+        rt_completion_done(&stream->released);
+    }
+}
+
+static void _stream_notify_readers(rt_sensor_t sensor, struct rt_sensor_stream *stream)
+{
+    struct rt_sensor_stream_reader *reader;
+    rt_uint32_t avail;
+
+    rt_mutex_take(&stream->lock, RT_WAITING_FOREVER);
+    rt_list_for_each_entry(reader, &stream->readers, list)
+    {
+        if (reader->notify != RT_NULL)
+        {
+            reader->notify(reader, _stream_reader_avail(stream, reader));
+        }
+    }
+    avail = _stream_reader_avail(stream, &stream->dev_reader);
+    rt_mutex_release(&stream->lock);
+
+    if (sensor->parent.rx_indicate != RT_NULL && avail > 0)
+    {
+        sensor->parent.rx_indicate(&sensor->parent, avail);
+    }
+}
+
+static rt_size_t _stream_push(rt_sensor_t sensor, struct rt_sensor_stream *stream,
+                              const struct rt_sensor_data *data, rt_size_t count)
+{
+    struct rt_sensor_data *slot;
+    rt_uint32_t head, now, i;
+
+    now = rt_sensor_get_ts();
+    head = (rt_uint32_t)rt_atomic_load(&stream->head);
+    for (i = 0; i < count; i++)
+    {
+        slot = &stream->buf[head & stream->mask];
+        rt_memcpy(slot, &data[i], sizeof(struct rt_sensor_data));
+        if (slot->timestamp == 0)
+        {
+#ifdef RT_USING_RTC
+            slot->timestamp = now;
+#else
+            slot->timestamp = now - (count - 1 - i) * stream->period;
+#endif
+        }
+        /* publish one sample at a time, a reader can only lose the one being written */
+        head++;
+        rt_atomic_store(&stream->head, head);
+    }
+
+    _stream_notify_readers(sensor, stream);
+
+    return count;
+}
+
+static void _stream_work(struct rt_work *work, void *work_data)
+{
+    rt_sensor_t sensor = (rt_sensor_t)work_data;
+    struct rt_sensor_stream *stream;
+    rt_ssize_t num = 0;
+
+    stream = _stream_get(sensor);
+    if (stream == RT_NULL)
+    {
+        return;
+    }
+    if (!stream->running)
+    {
+        _stream_put(stream);
+        return;
+    }
+
+    if (sensor->module)
+    {
+        rt_mutex_take(sensor->module->lock, RT_WAITING_FOREVER);
+    }
+    if (sensor->data_len > 0)
+    {
+        /* The module driver has fetched the data for all its sensors */
+        num = sensor->data_len / sizeof(struct rt_sensor_data);
+        if (num > stream->batch)
+        {
+            num = stream->batch;
+        }
+        rt_memcpy(stream->scratch, sensor->data_buf, num * sizeof(struct rt_sensor_data));
+        sensor->data_len = 0;
+    }
+    else if (sensor->ops->fetch_data)
+    {
+        num = sensor->ops->fetch_data(sensor, stream->scratch, stream->batch);
+    }
+    if (sensor->module)
+    {
+        rt_mutex_release(sensor->module->lock);
+    }
+
+    if (num > 0)
+    {
+        _stream_push(sensor, stream, stream->scratch, num);
+    }
+
+    /* The stop clears the flag under the lock, and cancels what is submitted before it */
+    rt_mutex_take(&stream->lock, RT_WAITING_FOREVER);
+    if (stream->running && RT_SENSOR_MODE_GET_FETCH(sensor->info.mode) == RT_SENSOR_MODE_FETCH_POLLING)
+    {
+        rt_work_submit(&stream->work, stream->period);
+    }
+    rt_mutex_release(&stream->lock);
+
+    _stream_put(stream);
+}
+
+static rt_err_t _stream_start(rt_sensor_t sensor, rt_uint32_t size)
+{
+    struct rt_sensor_stream *stream;
+    rt_uint32_t capacity = 1, batch;
+
+    if (sensor->stream != RT_NULL)
+    {
+        return -RT_EBUSY;
+    }
+    if (size == 0)
+    {
+        size = RT_SENSOR_STREAM_BUF_SIZE;
+    }
+    while (capacity < size)
+    {
+        capacity <<= 1;
+    }
+    batch = sensor->info.fifo_max > 0 ? sensor->info.fifo_max : 1;
+
+    stream = (struct rt_sensor_stream *)rt_malloc(sizeof(struct rt_sensor_stream) +
+             (capacity + batch) * sizeof(struct rt_sensor_data));
+    if (stream == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+    rt_memset(stream, 0, sizeof(struct rt_sensor_stream));
+    stream->buf = (struct rt_sensor_data *)(stream + 1);
+    stream->scratch = stream->buf + capacity;
+    stream->mask = capacity - 1;
+    stream->batch = batch;
+    stream->period = rt_tick_from_millisecond((rt_int32_t)sensor->info.acquire_min);
+    if (stream->period == 0)
+    {
+        stream->period = 1;
+    }
+    rt_atomic_store(&stream->ref, 1);
+    rt_completion_init(&stream->released);
+    rt_mutex_init(&stream->lock, "sstream", RT_IPC_FLAG_PRIO);
+    rt_list_init(&stream->readers);
+    rt_work_init(&stream->work, _stream_work, sensor);
+    stream->running = RT_TRUE;
+    sensor->stream = stream;
+
+    if (RT_SENSOR_MODE_GET_FETCH(sensor->info.mode) == RT_SENSOR_MODE_FETCH_POLLING)
+    {
+        rt_work_submit(&stream->work, 0);
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t _stream_stop(rt_sensor_t sensor)
+{
+    struct rt_sensor_stream *stream = sensor->stream;
+    rt_base_t level;
+
+    if (stream == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    /* No new user can get the stream */
+    level = rt_hw_interrupt_disable();
+    sensor->stream = RT_NULL;
+    rt_hw_interrupt_enable(level);
+
+    rt_mutex_take(&stream->lock, RT_WAITING_FOREVER);
+    stream->running = RT_FALSE;
+    if (!rt_list_isempty(&stream->readers))
+    {
+        LOG_W("sensor[%s] stream stopped with readers subscribed", sensor->parent.parent.name);
+    }
+    rt_mutex_release(&stream->lock);
+
+    /*
+     * Must not be called with the module lock held, the fetch work may be waiting for it.
+     * Wait for the running work and the other users to drop their references, then cancel
+     * the work submitted before the flag was cleared, it finds no stream if it starts.
+     */
+    _stream_put(stream);
+    rt_completion_wait(&stream->released, RT_WAITING_FOREVER);
+    rt_work_cancel(&stream->work);
+
+    rt_mutex_detach(&stream->lock);
+    rt_free(stream);
+
+    return RT_EOK;
+}
+
+/**
+ * Schedule the streaming fetch of a sensor, the data ready or FIFO watermark interrupt
+ * of the driver calls it. It can be called in the interrupt context.
+ */
+void rt_sensor_stream_notify(rt_sensor_t sensor)
+{
+    struct rt_sensor_stream *stream;
+
+    RT_ASSERT(sensor != RT_NULL);
+
+    stream = _stream_get(sensor);
+    if (stream != RT_NULL)
+    {
+        if (stream->running)
+        {
+            rt_work_submit(&stream->work, 0);
+        }
+        _stream_put(stream);
+    }
+}
+
+/**
+ * Push samples to the stream ring of a sensor, for the drivers reading their FIFO by
+ * themselves. There is only one producer per sensor, so it must not race with the
+ * fetch work. The samples without a timestamp are stamped with the push time, back-dated
+ * by the acquirement period when the time base is the tick.
+ *
+ * @return the number of samples pushed, 0 if the sensor is not streaming.
+ */
+rt_size_t rt_sensor_stream_push(rt_sensor_t sensor, const struct rt_sensor_data *data, rt_size_t count)
+{
+    struct rt_sensor_stream *stream;
+
+    RT_ASSERT(sensor != RT_NULL);
+
+    if (count == 0)
+    {
+        return 0;
+    }
+    stream = _stream_get(sensor);
+    if (stream == RT_NULL)
+    {
+        return 0;
+    }
+
+    count = _stream_push(sensor, stream, data, count);
+    _stream_put(stream);
+
+    return count;
+}
+
+/**
+ * Subscribe a reader to the stream of a sensor. The reader gets the samples pushed
+ * after the subscription, independently of the other readers. One reader must not be
+ * read by several threads at the same time.
+ */
+rt_err_t rt_sensor_stream_subscribe(rt_sensor_t sensor, struct rt_sensor_stream_reader *reader)
+{
+    struct rt_sensor_stream *stream;
+
+    RT_ASSERT(sensor != RT_NULL);
+    RT_ASSERT(reader != RT_NULL);
+
+    stream = _stream_get(sensor);
+    if (stream == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(&stream->lock, RT_WAITING_FOREVER);
+    reader->tail = (rt_uint32_t)rt_atomic_load(&stream->head);
+    reader->overflow = 0;
+    rt_list_insert_before(&stream->readers, &reader->list);
+    rt_mutex_release(&stream->lock);
+    _stream_put(stream);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_sensor_stream_unsubscribe(rt_sensor_t sensor, struct rt_sensor_stream_reader *reader)
+{
+    struct rt_sensor_stream *stream;
+
+    RT_ASSERT(sensor != RT_NULL);
+    RT_ASSERT(reader != RT_NULL);
+
+    stream = _stream_get(sensor);
+    if (stream == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(&stream->lock, RT_WAITING_FOREVER);
+    rt_list_remove(&reader->list);
+    rt_mutex_release(&stream->lock);
+    _stream_put(stream);
+
+    return RT_EOK;
+}
+
+/**
+ * Read the samples of a subscribed reader without calling the driver.
+ *
+ * @return the number of samples read, a negative error code if the sensor is not streaming.
+ */
+rt_ssize_t rt_sensor_stream_read(rt_sensor_t sensor, struct rt_sensor_stream_reader *reader,
+                                 rt_sensor_data_t buf, rt_size_t len)
+{
+    struct rt_sensor_stream *stream;
+    rt_ssize_t result;
+
+    RT_ASSERT(sensor != RT_NULL);
+    RT_ASSERT(reader != RT_NULL);
+
+    stream = _stream_get(sensor);
+    if (stream == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    /* the producer moves the head and drops the overrun samples under the lock */
+    rt_mutex_take(&stream->lock, RT_WAITING_FOREVER);
+    result = _stream_read(stream, reader, buf, len);
+    rt_mutex_release(&stream->lock);
+    _stream_put(stream);
+
+    return result;
+}
+#endif /* RT_SENSOR_USING_STREAM */
+
 /* sensor interrupt handler function */
 static void _sensor_cb(rt_sensor_t sen)
 {
+#ifdef RT_SENSOR_USING_STREAM
+    if (sen->stream != RT_NULL)
+    {
+        if (sen->irq_handle != RT_NULL)
+        {
+            sen->irq_handle(sen);
+        }
+        /* The data is fetched and pushed to the ring in the work queue */
+        rt_sensor_stream_notify(sen);
+        return;
+    }
+#endif /* RT_SENSOR_USING_STREAM */
+
     if (sen->parent.rx_indicate == RT_NULL)
     {
         return;
@@ -233,6 +665,13 @@ static rt_err_t _sensor_close(rt_device_t dev)
 
     RT_ASSERT(dev != RT_NULL);
 
+#ifdef RT_SENSOR_USING_STREAM
+    if (sensor->stream != RT_NULL)
+    {
+        _stream_stop(sensor);
+    }
+#endif /* RT_SENSOR_USING_STREAM */
+
     if (sensor->module)
     {
         rt_mutex_take(sensor->module->lock, RT_WAITING_FOREVER);
@@ -295,6 +734,23 @@ static rt_ssize_t _sensor_read(rt_device_t dev, rt_off_t pos, void *buf, rt_size
         return 0;
     }
 
+#ifdef RT_SENSOR_USING_STREAM
+    {
+        struct rt_sensor_stream *stream = _stream_get(sensor);
+
+        if (stream != RT_NULL)
+        {
+            /* Streaming, the samples are in the ring already */
+            rt_mutex_take(&stream->lock, RT_WAITING_FOREVER);
+            result = _stream_read(stream, &stream->dev_reader, buf, len);
+            rt_mutex_release(&stream->lock);
+            _stream_put(stream);
+
+            return result;
+        }
+    }
+#endif /* RT_SENSOR_USING_STREAM */
+
     if (sensor->module)
     {
         rt_mutex_take(sensor->module->lock, RT_WAITING_FOREVER);
@@ -339,6 +795,18 @@ static rt_err_t _sensor_control(rt_device_t dev, int cmd, void *args)
     rt_err_t (*local_ctrl)(rt_sensor_t sensor, int cmd, void *arg) = _local_control;
     rt_uint8_t mode;
 
+#ifdef RT_SENSOR_USING_STREAM
+    /* The fetch work takes the module lock, start and stop it without holding the lock */
+    if (cmd == RT_SENSOR_CTRL_STREAM_START)
+    {
+        return _stream_start(sensor, (rt_uint32_t)(rt_ubase_t)args);
+    }
+    else if (cmd == RT_SENSOR_CTRL_STREAM_STOP)
+    {
+        return _stream_stop(sensor);
+    }
+#endif /* RT_SENSOR_USING_STREAM */
+
     if (sensor->module)
     {
         rt_mutex_take(sensor->module->lock, RT_WAITING_FOREVER);
@@ -500,6 +968,9 @@ int rt_hw_sensor_register(rt_sensor_t    sensor,
     device->read        = _sensor_read;
     device->write       = RT_NULL;
     device->control     = _sensor_control;
+#endif
+#ifdef RT_SENSOR_USING_STREAM
+    sensor->stream      = RT_NULL;
 #endif
     device->type        = RT_Device_Class_Sensor;
     device->rx_indicate = RT_NULL;
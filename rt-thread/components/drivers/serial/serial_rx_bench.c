@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Serial receive wakeup benchmark.
+ *
+ * The TX pin of the serial device has to be wired to its RX pin. A sender thread writes
+ * packets of BENCH_PACKET_SIZE bytes with a gap of BENCH_PACKET_GAP_MS between them, a reader
+ * thread waits for the rx indication and drains the device. The run is done once without a
+ * wake condition and once with the given threshold and idle timeout, the throughput, the
+ * reader wakeups per packet and the overruns are reported.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(RT_SERIAL_USING_RX_BENCH) && defined(RT_USING_FINSH)
+
+#define BENCH_PACKET_SIZE       64
+#define BENCH_PACKET_GAP_MS     2
+#define BENCH_READ_SIZE         256
+
+struct bench_result
+{
+    rt_uint32_t received;
+    rt_uint32_t wakeups;
+    rt_uint32_t reads;
+    rt_tick_t ticks;
+};
+
+static struct rt_semaphore rx_sem;
+static struct rt_semaphore done_sem;
+static struct bench_result result;
+static volatile rt_bool_t bench_running;
+
+static rt_err_t bench_rx_ind(rt_device_t dev, rt_size_t size)
+{
+    result.wakeups++;
+    rt_sem_release(&rx_sem);
+    return RT_EOK;
+}
+
+static void reader_entry(void *parameter)
+{
+    rt_device_t dev = (rt_device_t)parameter;
+    rt_uint8_t buf[BENCH_READ_SIZE];
+    rt_ssize_t size;
+
+    while (bench_running)
+    {
+        if (rt_sem_take(&rx_sem, rt_tick_from_millisecond(10)) != RT_EOK)
+        {
+            continue;
+        }
+        while ((size = rt_device_read(dev, 0, buf, sizeof(buf))) > 0)
+        {
+            result.received += size;
+            result.reads++;
+        }
+    }
+
+    rt_sem_release(&done_sem);
+}
+
+static void bench_run(rt_device_t dev, const char *mode, struct rt_serial_rx_wake *wake, rt_uint32_t bytes)
+{
+    rt_uint8_t packet[BENCH_PACKET_SIZE];
+    struct rt_serial_rx_stat stat;
+    rt_uint32_t sent, i;
+    rt_thread_t reader;
+    rt_tick_t start;
+
+    for (i = 0; i < sizeof(packet); i++)
+    {
+        packet[i] = i;
+    }
+
+    rt_memset(&result, 0, sizeof(result));
+    rt_device_control(dev, RT_SERIAL_CTRL_SET_RX_WAKE, wake);
+    rt_device_control(dev, RT_SERIAL_CTRL_CLR_RX_STAT, RT_NULL);
+
+    bench_running = RT_TRUE;
+    reader = rt_thread_create("uartrd", reader_entry, dev, 1024 + BENCH_READ_SIZE, RT_THREAD_PRIORITY_MAX / 2 - 1, 10);
+    if (reader == RT_NULL)
+    {
+        return;
+    }
+    rt_thread_startup(reader);
+
+    start = rt_tick_get();
+    for (sent = 0; sent < bytes; sent += BENCH_PACKET_SIZE)
+    {
+        rt_device_write(dev, 0, packet, sizeof(packet));
+        rt_thread_mdelay(BENCH_PACKET_GAP_MS);
+    }
+    /* wait for the last packet, at most one second */
+    for (i = 0; i < 100 && result.received < sent; i++)
+    {
+        rt_thread_mdelay(10);
+    }
+    result.ticks = rt_tick_get() - start;
+
+    bench_running = RT_FALSE;
+    rt_sem_take(&done_sem, RT_WAITING_FOREVER);
+
+    rt_device_control(dev, RT_SERIAL_CTRL_GET_RX_STAT, &stat);
+    rt_kprintf("%-6s %8d %8d %8d %8d %8d %8d\n", mode, result.received,
+               result.ticks ? (rt_uint32_t)((rt_uint64_t)result.received * RT_TICK_PER_SECOND / result.ticks) : 0,
+               result.wakeups, result.reads, stat.idle_events, stat.overruns);
+}
+
+static void serial_rx_bench(int argc, char **argv)
+{
+    struct rt_serial_rx_wake wake = {0}, none = {0};
+    rt_uint32_t bytes = 16 * 1024;
+    rt_device_t dev;
+
+    if (argc < 2)
+    {
+        rt_kprintf("Usage: serial_rx_bench <uart> [threshold] [idle_ms] [bytes]\n");
+        rt_kprintf("The TX pin of the uart has to be wired to its RX pin.\n");
+        return;
+    }
+    wake.threshold = BENCH_PACKET_SIZE;
+    wake.idle_ms = 1;
+    if (argc > 2) wake.threshold = strtoul(argv[2], RT_NULL, 0);
+    if (argc > 3) wake.idle_ms = strtoul(argv[3], RT_NULL, 0);
+    if (argc > 4) bytes = strtoul(argv[4], RT_NULL, 0);
+
+    dev = rt_device_find(argv[1]);
+    if (dev == RT_NULL)
+    {
+        rt_kprintf("serial device %s not found\n", argv[1]);
+        return;
+    }
+    if (rt_device_open(dev, RT_DEVICE_FLAG_RX_NON_BLOCKING | RT_DEVICE_FLAG_TX_BLOCKING) != RT_EOK)
+    {
+        rt_kprintf("open %s failed\n", argv[1]);
+        return;
+    }
+    rt_sem_init(&rx_sem, "uartrx", 0, RT_IPC_FLAG_PRIO);
+    rt_sem_init(&done_sem, "uartdone", 0, RT_IPC_FLAG_PRIO);
+    rt_device_set_rx_indicate(dev, bench_rx_ind);
+
+    rt_kprintf("%d bytes in packets of %d bytes every %d ms, threshold %d, idle %d ms\n", bytes,
+               BENCH_PACKET_SIZE, BENCH_PACKET_GAP_MS, wake.threshold, wake.idle_ms);
+    rt_kprintf("mode   received  bytes/s  wakeups  reads    idle     overruns\n");
+    bench_run(dev, "none", &none, bytes);
+    bench_run(dev, "wake", &wake, bytes);
+
+    rt_device_control(dev, RT_SERIAL_CTRL_SET_RX_WAKE, &none);
+    rt_device_set_rx_indicate(dev, RT_NULL);
+    rt_device_close(dev);
+    rt_sem_detach(&rx_sem);
+    rt_sem_detach(&done_sem);
+}
+MSH_CMD_EXPORT(serial_rx_bench, serial rx wakeups with and without the wake condition);
+
+#endif /* defined(RT_SERIAL_USING_RX_BENCH) && defined(RT_USING_FINSH) */
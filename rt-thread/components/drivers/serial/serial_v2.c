@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-06-01     KyleChan     first version
+ * 2026-10-18     RT-Thread    add rx wake threshold, idle timeout and rx counters
  */
 
 #include <rthw.h>
@@ -287,6 +288,117 @@ static rt_ssize_t rt_serial_update_write_index(struct rt_ringbuffer  *rb,
 }
 
 
+/**
+  * @brief Wake up the readers of the received data.
+  * @param serial RT-thread serial device.
+  * @param rx_fifo The receive fifo of the serial device.
+  * @param rx_length The length of the data in the receive fifo.
+  */
+static void _serial_rx_wakeup(struct rt_serial_device  *serial,
+                              struct rt_serial_rx_fifo *rx_fifo,
+                                     rt_size_t          rx_length)
+{
+    if (serial->parent.open_flag & RT_SERIAL_RX_BLOCKING)
+    {
+#ifdef RT_SERIAL_USING_RX_WAKE
+        /* With a wake condition, a blocking read returns what has been received */
+        if (rx_fifo->rx_cpt_index && (rx_length >= rx_fifo->rx_cpt_index ||
+                serial->rx_wake.threshold || serial->rx_wake.idle_ms))
+#else
+        if (rx_fifo->rx_cpt_index && rx_length >= rx_fifo->rx_cpt_index )
+#endif
+        {
+            rx_fifo->rx_cpt_index = 0;
+            rt_completion_done(&(rx_fifo->rx_cpt));
+        }
+    }
+    /* Trigger the receiving completion callback */
+    if (serial->parent.rx_indicate != RT_NULL)
+        serial->parent.rx_indicate(&(serial->parent), rx_length);
+
+    if (serial->rx_notify.notify)
+    {
+        serial->rx_notify.notify(serial->rx_notify.dev);
+    }
+#ifdef RT_SERIAL_USING_RX_WAKE
+    serial->rx_stat.wakeups++;
+#endif
+}
+
+#ifdef RT_SERIAL_USING_RX_WAKE
+/**
+  * @brief Check the receive wake condition of the serial device.
+  * @param serial RT-thread serial device.
+  * @param rx_fifo The receive fifo of the serial device.
+  * @param rx_length The length of the data in the receive fifo.
+  * @return Return RT_TRUE if the readers should be woken up.
+  */
+static rt_bool_t _serial_rx_wake_check(struct rt_serial_device  *serial,
+                                       struct rt_serial_rx_fifo *rx_fifo,
+                                              rt_size_t          rx_length)
+{
+    /* No wake condition, wake up on every chunk */
+    if (serial->rx_wake.threshold == 0 && serial->rx_wake.idle_ms == 0)
+        return RT_TRUE;
+
+    if (serial->rx_wake.threshold && rx_length >= serial->rx_wake.threshold)
+        return RT_TRUE;
+
+    /* A blocking read asking for less data than the threshold */
+    if (rx_fifo->rx_cpt_index && rx_length >= rx_fifo->rx_cpt_index)
+        return RT_TRUE;
+
+    /* Don't let the buffer overflow while waiting for the threshold */
+    if (rx_length >= rx_fifo->rb.buffer_size - (rx_fifo->rb.buffer_size >> 2))
+        return RT_TRUE;
+
+    return RT_FALSE;
+}
+
+/**
+  * @brief Check if a blocking read with less data than requested has to wait.
+  * @param serial RT-thread serial device.
+  * @param recv_len The length of the data in the receive fifo.
+  * @return Return RT_TRUE if more data of the current message is expected.
+  */
+static rt_bool_t _serial_rx_wait_needed(struct rt_serial_device *serial,
+                                               rt_size_t         recv_len)
+{
+    if (recv_len == 0)
+        return RT_TRUE;
+
+    /* No wake condition, wait for the requested size */
+    if (serial->rx_wake.threshold == 0 && serial->rx_wake.idle_ms == 0)
+        return RT_TRUE;
+
+    if (serial->rx_wake.threshold && recv_len >= serial->rx_wake.threshold)
+        return RT_FALSE;
+
+    /* The idle timer is running while a message is being received */
+    if (serial->rx_wake.idle_ms)
+        return (serial->rx_idle_timer.parent.flag & RT_TIMER_FLAG_ACTIVATED) ? RT_TRUE : RT_FALSE;
+
+    return RT_TRUE;
+}
+
+static void _serial_rx_idle_timeout(void *parameter)
+{
+    struct rt_serial_device *serial = (struct rt_serial_device *)parameter;
+    struct rt_serial_rx_fifo *rx_fifo;
+    rt_size_t rx_length;
+
+    rx_fifo = (struct rt_serial_rx_fifo *)serial->serial_rx;
+    if (rx_fifo == RT_NULL) return;
+
+    rx_length = rt_ringbuffer_data_len(&rx_fifo->rb);
+    if (rx_length == 0) return;
+
+    serial->rx_stat.idle_events++;
+    _serial_rx_wakeup(serial, rx_fifo, rx_length);
+}
+#endif /* RT_SERIAL_USING_RX_WAKE */
+
+
 /**
   * @brief Serial polling receive data routine, This function will receive data
   *        in a continuous loop by one by one byte.
@@ -418,7 +530,11 @@ static rt_ssize_t _serial_fifo_rx(struct rt_device        *dev,
         /* Get the length of the data from the ringbuffer */
         recv_len = rt_ringbuffer_data_len(&(rx_fifo->rb));
 
+#ifdef RT_SERIAL_USING_RX_WAKE
+        if (recv_len < size && _serial_rx_wait_needed(serial, recv_len))
+#else
         if (recv_len < size)
+#endif
         {
             /* When recv_len is less than size, rx_cpt_index is updated to the size
             * and rt_current_thread is suspend until rx_cpt_index is equal to 0 */
@@ -823,6 +939,10 @@ static rt_err_t rt_serial_rx_disable(struct rt_device        *dev,
 
     if (serial->serial_rx == RT_NULL) return RT_EOK;
 
+#ifdef RT_SERIAL_USING_RX_WAKE
+    rt_timer_stop(&serial->rx_idle_timer);
+#endif
+
     do
     {
         if (rx_oflag == RT_SERIAL_RX_NON_BLOCKING)
@@ -1154,6 +1274,33 @@ static rt_err_t rt_serial_control(struct rt_device *dev,
             }
             break;
 
+#ifdef RT_SERIAL_USING_RX_WAKE
+        case RT_SERIAL_CTRL_SET_RX_WAKE:
+            {
+                struct rt_serial_rx_wake *wake = (struct rt_serial_rx_wake *)args;
+                rt_tick_t idle_tick;
+
+                if (wake == RT_NULL) return -RT_EINVAL;
+
+                rt_timer_stop(&serial->rx_idle_timer);
+                idle_tick = rt_tick_from_millisecond(wake->idle_ms);
+                if (wake->idle_ms && idle_tick == 0)
+                    idle_tick = 1;
+                rt_timer_control(&serial->rx_idle_timer, RT_TIMER_CTRL_SET_TIME, &idle_tick);
+                serial->rx_wake = *wake;
+            }
+            break;
+
+        case RT_SERIAL_CTRL_GET_RX_STAT:
+            if (args == RT_NULL) return -RT_EINVAL;
+            rt_memcpy(args, &serial->rx_stat, sizeof(struct rt_serial_rx_stat));
+            break;
+
+        case RT_SERIAL_CTRL_CLR_RX_STAT:
+            rt_memset(&serial->rx_stat, 0, sizeof(struct rt_serial_rx_stat));
+            break;
+#endif /* RT_SERIAL_USING_RX_WAKE */
+
         case RT_DEVICE_CTRL_CONSOLE_OFLAG:
             if (args)
             {
@@ -1476,6 +1623,13 @@ rt_err_t rt_hw_serial_register(struct rt_serial_device *serial,
 #endif
     device->user_data   = data;
 
+#ifdef RT_SERIAL_USING_RX_WAKE
+    rt_memset(&serial->rx_wake, 0, sizeof(serial->rx_wake));
+    rt_memset(&serial->rx_stat, 0, sizeof(serial->rx_stat));
+    rt_timer_init(&serial->rx_idle_timer, name, _serial_rx_idle_timeout, serial,
+                  1, RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+#endif
+
     /* register a character device */
     ret = rt_device_register(device, name, flag);
 
@@ -1500,6 +1654,9 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
         /* Interrupt receive event */
         case RT_SERIAL_EVENT_RX_IND:
         case RT_SERIAL_EVENT_RX_DMADONE:
+#ifdef RT_SERIAL_USING_RX_WAKE
+        case RT_SERIAL_EVENT_RX_TIMEOUT:
+#endif
         {
             struct rt_serial_rx_fifo *rx_fifo;
             rt_size_t rx_length = 0;
@@ -1513,30 +1670,49 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
             if (rx_length)
             { /* RT_SERIAL_EVENT_RX_DMADONE MODE */
                 level = rt_hw_interrupt_disable();
+#ifdef RT_SERIAL_USING_RX_WAKE
+                serial->rx_stat.overruns += rx_length - rt_serial_update_write_index(&(rx_fifo->rb), rx_length);
+                serial->rx_stat.rx_bytes += rx_length;
+#else
                 rt_serial_update_write_index(&(rx_fifo->rb), rx_length);
+#endif
                 rt_hw_interrupt_enable(level);
             }
+#ifdef RT_SERIAL_USING_RX_WAKE
+            else if ((event & 0xff) == RT_SERIAL_EVENT_RX_IND)
+            {
+                /* The interrupt mode puts one byte at a time */
+                serial->rx_stat.rx_bytes++;
+            }
+#endif
 
             /* Get the length of the data from the ringbuffer */
             rx_length = rt_ringbuffer_data_len(&rx_fifo->rb);
             if (rx_length == 0) break;
 
-            if (serial->parent.open_flag & RT_SERIAL_RX_BLOCKING)
+#ifdef RT_SERIAL_USING_RX_WAKE
+            if ((event & 0xff) == RT_SERIAL_EVENT_RX_TIMEOUT)
             {
-                if (rx_fifo->rx_cpt_index && rx_length >= rx_fifo->rx_cpt_index )
+                /* The driver detected an idle line, the message is complete */
+                serial->rx_stat.idle_events++;
+            }
+            else if (!_serial_rx_wake_check(serial, rx_fifo, rx_length))
+            {
+                if (serial->rx_wake.idle_ms)
                 {
-                    rx_fifo->rx_cpt_index = 0;
-                    rt_completion_done(&(rx_fifo->rx_cpt));
+                    /* Restart the idle timer on every chunk received */
+                    rt_timer_stop(&serial->rx_idle_timer);
+                    rt_timer_start(&serial->rx_idle_timer);
                 }
+                break;
             }
-            /* Trigger the receiving completion callback */
-            if (serial->parent.rx_indicate != RT_NULL)
-                serial->parent.rx_indicate(&(serial->parent), rx_length);
-
-            if (serial->rx_notify.notify)
+            if (serial->rx_wake.idle_ms)
             {
-                serial->rx_notify.notify(serial->rx_notify.dev);
+                rt_timer_stop(&serial->rx_idle_timer);
             }
+#endif /* RT_SERIAL_USING_RX_WAKE */
+
+            _serial_rx_wakeup(serial, rx_fifo, rx_length);
             break;
         }
 
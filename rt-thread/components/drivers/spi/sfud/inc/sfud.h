@@ -129,6 +129,62 @@ sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size);
  */
 sfud_err sfud_write(const sfud_flash *flash, uint32_t addr, size_t size, const uint8_t *data);
 
+#ifdef SFUD_USING_ASYNC_ERASE
+/**
+ * erase flash data without blocking the caller.
+ *
+ * It only sends the erase command of the first sector and returns, the remaining sectors will be erased one by one
+ * when sfud_erase_async_poll() is called.
+ *
+ * @note It will erase align by erase granularity.
+ *
+ * @param flash flash device
+ * @param ctx asynchronous erase context, it must be kept valid until the complete callback is called
+ * @param addr start address
+ * @param size erase size
+ * @param done complete callback, it will be called in sfud_erase_async_poll(). NULL will not callback.
+ * @param user_data complete callback user data
+ *
+ * @return result, SFUD_ERR_BUSY: there is another asynchronous erase is in progress on this flash
+ */
+sfud_err sfud_erase_async(sfud_flash *flash, sfud_erase_async_ctx *ctx, uint32_t addr, size_t size,
+        sfud_erase_async_cb done, void *user_data);
+
+/**
+ * poll the asynchronous erase on this flash. It will start erase the next sector when the current sector is finished.
+ *
+ * @param flash flash device
+ *
+ * @return SFUD_ERR_BUSY: the erase is still in progress.
+ *         others: the erase is finished (or there is no asynchronous erase), it is the erase result.
+ */
+sfud_err sfud_erase_async_poll(sfud_flash *flash);
+#endif /* SFUD_USING_ASYNC_ERASE */
+
+#ifdef SFUD_USING_ERASE_SUSPEND
+/**
+ * suspend the program or erase which is in progress
+ *
+ * @note The SPI bus must be locked by caller.
+ *
+ * @param flash flash device
+ *
+ * @return result, SFUD_SUCCESS: the flash is not busy now, it can be read
+ */
+sfud_err sfud_erase_suspend(const sfud_flash *flash);
+
+/**
+ * resume the suspended program or erase
+ *
+ * @note The SPI bus must be locked by caller.
+ *
+ * @param flash flash device
+ *
+ * @return result
+ */
+sfud_err sfud_erase_resume(const sfud_flash *flash);
+#endif /* SFUD_USING_ERASE_SUSPEND */
+
 /**
  * erase and write flash data
  *
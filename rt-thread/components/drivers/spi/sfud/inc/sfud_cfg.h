@@ -70,6 +70,20 @@
 #define SFUD_USING_FLASH_INFO_TABLE
 #endif
 
+/**
+ * Using the non-blocking sector by sector erase API. @see sfud_erase_async
+ */
+#ifdef RT_SFUD_USING_ASYNC_ERASE
+#define SFUD_USING_ASYNC_ERASE
+#endif
+
+/**
+ * Suspend the asynchronous erase by program/erase suspend command when reading other sectors.
+ */
+#ifdef RT_SFUD_USING_ERASE_SUSPEND
+#define SFUD_USING_ERASE_SUSPEND
+#endif
+
 #define SFUD_FLASH_DEVICE_TABLE {{0}}
 
 #endif /* _SFUD_CFG_H_ */
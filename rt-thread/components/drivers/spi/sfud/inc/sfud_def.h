@@ -166,6 +166,18 @@ if (!(EXPR))                                                                   \
 #define SFUD_CMD_EXIT_4B_ADDRESS_MODE                  0xE9
 #endif
 
+#ifndef SFUD_CMD_READ_STATUS_REGISTER_2
+#define SFUD_CMD_READ_STATUS_REGISTER_2                0x35
+#endif
+
+#ifndef SFUD_CMD_PROGRAM_ERASE_SUSPEND
+#define SFUD_CMD_PROGRAM_ERASE_SUSPEND                 0x75
+#endif
+
+#ifndef SFUD_CMD_PROGRAM_ERASE_RESUME
+#define SFUD_CMD_PROGRAM_ERASE_RESUME                  0x7A
+#endif
+
 #ifndef SFUD_WRITE_MAX_PAGE_SIZE
 #define SFUD_WRITE_MAX_PAGE_SIZE                        256
 #endif
@@ -187,6 +199,13 @@ enum {
     SFUD_STATUS_REGISTER_SRP = (1 << 7),                   /**< status register protect */
 };
 
+/**
+ * status register 2 bits
+ */
+enum {
+    SFUD_STATUS_REGISTER2_SUS = (1 << 7),                  /**< program/erase suspended */
+};
+
 /**
  * error code
  */
@@ -197,6 +216,7 @@ typedef enum {
     SFUD_ERR_READ = 3,                                     /**< read error */
     SFUD_ERR_TIMEOUT = 4,                                  /**< timeout error */
     SFUD_ERR_ADDR_OUT_OF_BOUND = 5,                        /**< address is out of flash bound */
+    SFUD_ERR_BUSY = 6,                                     /**< an asynchronous operation is still in progress */
 } sfud_err;
 
 #ifdef SFUD_USING_QSPI
@@ -263,6 +283,10 @@ typedef struct __sfud_spi {
     void *user_data;
 } sfud_spi, *sfud_spi_t;
 
+#ifdef SFUD_USING_ASYNC_ERASE
+struct __sfud_erase_async_ctx;
+#endif
+
 /**
  * serial flash device
  */
@@ -287,8 +311,30 @@ typedef struct {
     sfud_sfdp sfdp;                              /**< serial flash discoverable parameters by JEDEC standard */
 #endif
 
+#ifdef SFUD_USING_ASYNC_ERASE
+    struct __sfud_erase_async_ctx *erase_async;  /**< pending asynchronous erase, NULL when idle */
+#endif
+
 } sfud_flash, *sfud_flash_t;
 
+#ifdef SFUD_USING_ASYNC_ERASE
+/* asynchronous erase complete callback */
+typedef void (*sfud_erase_async_cb)(const sfud_flash *flash, sfud_err result, void *user_data);
+
+/**
+ * asynchronous erase context, it is owned by the caller until the complete callback is called
+ */
+typedef struct __sfud_erase_async_ctx {
+    uint32_t addr;                               /**< address of the sector which is erasing */
+    size_t size;                                 /**< remaining erase size, include the erasing sector */
+    size_t cur_erase_size;                       /**< size of the sector which is erasing */
+    size_t retry_times;                          /**< remaining busy polling times of the erasing sector */
+    sfud_erase_async_cb done;                    /**< complete callback */
+    void *user_data;                             /**< complete callback user data */
+    size_t suspend_count;                        /**< times of the erase was suspended by read */
+} sfud_erase_async_ctx, *sfud_erase_async_ctx_t;
+#endif /* SFUD_USING_ASYNC_ERASE */
+
 #ifdef __cplusplus
 }
 #endif
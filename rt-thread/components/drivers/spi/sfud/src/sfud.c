@@ -73,6 +73,12 @@ static sfud_err read_jedec_id(sfud_flash *flash);
 static sfud_err set_write_enabled(const sfud_flash *flash, bool enabled);
 static sfud_err set_4_byte_address_mode(sfud_flash *flash, bool enabled);
 static void make_address_byte_array(const sfud_flash *flash, uint32_t addr, uint8_t *array);
+static void get_eraser(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t *cmd, size_t *erase_size);
+static sfud_err erase_sector_start(const sfud_flash *flash, uint32_t addr, uint8_t cmd);
+static bool erase_next(uint32_t *addr, size_t *size, size_t cur_erase_size);
+#ifdef SFUD_USING_ERASE_SUSPEND
+static bool erase_async_suspend(const sfud_flash *flash, uint32_t addr, size_t size);
+#endif
 
 /* ../port/sfup_port.c */
 extern void sfud_log_debug(const char *file, const long line, const char *format, ...);
@@ -405,6 +411,9 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
     sfud_err result = SFUD_SUCCESS;
     const sfud_spi *spi = &flash->spi;
     uint8_t cmd_data[5], cmd_size;
+#ifdef SFUD_USING_ERASE_SUSPEND
+    bool suspended;
+#endif
 
     SFUD_ASSERT(flash);
     SFUD_ASSERT(data);
@@ -420,7 +429,16 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
         spi->lock(spi);
     }
 
-    result = wait_busy(flash);
+#ifdef SFUD_USING_ERASE_SUSPEND
+    /* the read will preempt the asynchronous erase when it isn't reading the erasing sector */
+    suspended = erase_async_suspend(flash, addr, size);
+    if (suspended) {
+        result = SFUD_SUCCESS;
+    } else
+#endif
+    {
+        result = wait_busy(flash);
+    }
 
     if (result == SFUD_SUCCESS) {
 #ifdef SFUD_USING_QSPI
@@ -435,6 +453,14 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
             result = spi->wr(spi, cmd_data, cmd_size, data, size);
         }
     }
+#ifdef SFUD_USING_ERASE_SUSPEND
+    if (suspended) {
+        /* continue the suspended erase */
+        if (sfud_erase_resume(flash) != SFUD_SUCCESS && result == SFUD_SUCCESS) {
+            result = SFUD_ERR_WRITE;
+        }
+    }
+#endif
     /* unlock SPI */
     if (spi->unlock) {
         spi->unlock(spi);
@@ -496,6 +522,93 @@ __exit:
     return result;
 }
 
+/**
+ * get the suitable erase command and erase size for the erase address
+ *
+ * @param flash flash device
+ * @param addr erase address
+ * @param size remaining erase size
+ * @param cmd suitable erase command
+ * @param erase_size erase size of the command
+ */
+static void get_eraser(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t *cmd, size_t *erase_size) {
+    /* if this flash is support SFDP parameter, then used SFDP parameter supplies eraser */
+#ifdef SFUD_USING_SFDP
+    extern size_t sfud_sfdp_get_suitable_eraser(const sfud_flash *flash, uint32_t addr, size_t erase_size);
+
+    size_t eraser_index;
+    if (flash->sfdp.available) {
+        /* get the suitable eraser for erase process from SFDP parameter */
+        eraser_index = sfud_sfdp_get_suitable_eraser(flash, addr, size);
+        *cmd = flash->sfdp.eraser[eraser_index].cmd;
+        *erase_size = flash->sfdp.eraser[eraser_index].size;
+    } else {
+#else
+    {
+#endif
+        *cmd = flash->chip.erase_gran_cmd;
+        *erase_size = flash->chip.erase_gran;
+    }
+}
+
+/**
+ * send the erase command for one sector, it will NOT wait the erase finish
+ *
+ * @param flash flash device
+ * @param addr erase address
+ * @param cmd erase command
+ *
+ * @return result
+ */
+static sfud_err erase_sector_start(const sfud_flash *flash, uint32_t addr, uint8_t cmd) {
+    sfud_err result = SFUD_SUCCESS;
+    const sfud_spi *spi = &flash->spi;
+    uint8_t cmd_data[5], cmd_size;
+
+    /* set the flash write enable */
+    result = set_write_enabled(flash, true);
+    if (result != SFUD_SUCCESS) {
+        return result;
+    }
+
+    cmd_data[0] = cmd;
+    make_address_byte_array(flash, addr, &cmd_data[1]);
+    cmd_size = flash->addr_in_4_byte ? 5 : 4;
+    result = spi->wr(spi, cmd_data, cmd_size, NULL, 0);
+    if (result != SFUD_SUCCESS) {
+        SFUD_INFO("Error: Flash erase SPI communicate error.");
+    }
+
+    return result;
+}
+
+/**
+ * make erase align and calculate next erase address
+ *
+ * @param addr current erase address, it will be changed to next erase address
+ * @param size remaining erase size, it will be changed to next remaining size
+ * @param cur_erase_size current erase size
+ *
+ * @return true: has next erase, false: erase finished
+ */
+static bool erase_next(uint32_t *addr, size_t *size, size_t cur_erase_size) {
+    size_t erased_size;
+
+    if (*addr % cur_erase_size != 0) {
+        erased_size = cur_erase_size - (*addr % cur_erase_size);
+    } else {
+        erased_size = cur_erase_size;
+    }
+
+    if (*size > erased_size) {
+        *size -= erased_size;
+        *addr += erased_size;
+        return true;
+    } else {
+        return false;
+    }
+}
+
 /**
  * erase flash data
  *
@@ -508,11 +621,9 @@ __exit:
  * @return result
  */
 sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size) {
-    extern size_t sfud_sfdp_get_suitable_eraser(const sfud_flash *flash, uint32_t addr, size_t erase_size);
-
     sfud_err result = SFUD_SUCCESS;
     const sfud_spi *spi = &flash->spi;
-    uint8_t cmd_data[5], cmd_size, cur_erase_cmd;
+    uint8_t cur_erase_cmd;
     size_t cur_erase_size;
 
     SFUD_ASSERT(flash);
@@ -535,33 +646,9 @@ sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size) {
 
     /* loop erase operate. erase unit is erase granularity */
     while (size) {
-        /* if this flash is support SFDP parameter, then used SFDP parameter supplies eraser */
-#ifdef SFUD_USING_SFDP
-        size_t eraser_index;
-        if (flash->sfdp.available) {
-            /* get the suitable eraser for erase process from SFDP parameter */
-            eraser_index = sfud_sfdp_get_suitable_eraser(flash, addr, size);
-            cur_erase_cmd = flash->sfdp.eraser[eraser_index].cmd;
-            cur_erase_size = flash->sfdp.eraser[eraser_index].size;
-        } else {
-#else
-        {
-#endif
-            cur_erase_cmd = flash->chip.erase_gran_cmd;
-            cur_erase_size = flash->chip.erase_gran;
-        }
-        /* set the flash write enable */
-        result = set_write_enabled(flash, true);
-        if (result != SFUD_SUCCESS) {
-            goto __exit;
-        }
-
-        cmd_data[0] = cur_erase_cmd;
-        make_address_byte_array(flash, addr, &cmd_data[1]);
-        cmd_size = flash->addr_in_4_byte ? 5 : 4;
-        result = spi->wr(spi, cmd_data, cmd_size, NULL, 0);
+        get_eraser(flash, addr, size, &cur_erase_cmd, &cur_erase_size);
+        result = erase_sector_start(flash, addr, cur_erase_cmd);
         if (result != SFUD_SUCCESS) {
-            SFUD_INFO("Error: Flash erase SPI communicate error.");
             goto __exit;
         }
         result = wait_busy(flash);
@@ -569,34 +656,262 @@ sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size) {
             goto __exit;
         }
         /* make erase align and calculate next erase address */
-        if (addr % cur_erase_size != 0) {
-            if (size > cur_erase_size - (addr % cur_erase_size)) {
-                size -= cur_erase_size - (addr % cur_erase_size);
-                addr += cur_erase_size - (addr % cur_erase_size);
+        if (!erase_next(&addr, &size, cur_erase_size)) {
+            goto __exit;
+        }
+    }
+
+__exit:
+    /* set the flash write disable */
+    set_write_enabled(flash, false);
+    /* unlock SPI */
+    if (spi->unlock) {
+        spi->unlock(spi);
+    }
+
+    return result;
+}
+
+#ifdef SFUD_USING_ASYNC_ERASE
+/**
+ * start erase the sector which is pointed by the asynchronous erase context
+ *
+ * @param flash flash device
+ * @param ctx asynchronous erase context
+ *
+ * @return result
+ */
+static sfud_err erase_async_start_sector(const sfud_flash *flash, sfud_erase_async_ctx *ctx) {
+    uint8_t cur_erase_cmd;
+
+    get_eraser(flash, ctx->addr, ctx->size, &cur_erase_cmd, &ctx->cur_erase_size);
+    ctx->retry_times = flash->retry.times;
+
+    return erase_sector_start(flash, ctx->addr, cur_erase_cmd);
+}
+
+/**
+ * erase flash data without blocking the caller.
+ *
+ * It only sends the erase command of the first sector and returns, the remaining sectors will be erased one by one
+ * when sfud_erase_async_poll() is called. The SPI bus is NOT locked between two polls, so others can access flash
+ * when the erase is in progress.
+ *
+ * @note It will erase align by erase granularity.
+ * @note The chip erase command is never used in asynchronous mode.
+ *
+ * @param flash flash device
+ * @param ctx asynchronous erase context, it must be kept valid until the complete callback is called
+ * @param addr start address
+ * @param size erase size
+ * @param done complete callback, it will be called in sfud_erase_async_poll(). NULL will not callback.
+ * @param user_data complete callback user data
+ *
+ * @return result, SFUD_ERR_BUSY: there is another asynchronous erase is in progress on this flash
+ */
+sfud_err sfud_erase_async(sfud_flash *flash, sfud_erase_async_ctx *ctx, uint32_t addr, size_t size,
+        sfud_erase_async_cb done, void *user_data) {
+    sfud_err result = SFUD_SUCCESS;
+    const sfud_spi *spi = &flash->spi;
+
+    SFUD_ASSERT(flash);
+    SFUD_ASSERT(ctx);
+    /* must be call this function after initialize OK */
+    SFUD_ASSERT(flash->init_ok);
+    /* check the flash address bound */
+    if (addr + size > flash->chip.capacity) {
+        SFUD_INFO("Error: Flash address is out of bound.");
+        return SFUD_ERR_ADDR_OUT_OF_BOUND;
+    }
+
+    if (size == 0) {
+        if (done) {
+            done(flash, SFUD_SUCCESS, user_data);
+        }
+        return SFUD_SUCCESS;
+    }
+
+    /* lock SPI */
+    if (spi->lock) {
+        spi->lock(spi);
+    }
+
+    if (flash->erase_async) {
+        result = SFUD_ERR_BUSY;
+        goto __exit;
+    }
+
+    ctx->addr = addr;
+    ctx->size = size;
+    ctx->done = done;
+    ctx->user_data = user_data;
+    ctx->suspend_count = 0;
+    result = erase_async_start_sector(flash, ctx);
+    if (result == SFUD_SUCCESS) {
+        flash->erase_async = ctx;
+    } else {
+        /* set the flash write disable */
+        set_write_enabled(flash, false);
+    }
+
+__exit:
+    /* unlock SPI */
+    if (spi->unlock) {
+        spi->unlock(spi);
+    }
+
+    return result;
+}
+
+/**
+ * poll the asynchronous erase on this flash. It will start erase the next sector when the current sector is finished.
+ *
+ * @param flash flash device
+ *
+ * @return SFUD_ERR_BUSY: the erase is still in progress.
+ *         others: the erase is finished (or there is no asynchronous erase), it is the erase result.
+ */
+sfud_err sfud_erase_async_poll(sfud_flash *flash) {
+    sfud_err result = SFUD_SUCCESS;
+    const sfud_spi *spi = &flash->spi;
+    sfud_erase_async_ctx *ctx;
+    uint8_t status;
+
+    SFUD_ASSERT(flash);
+
+    /* lock SPI */
+    if (spi->lock) {
+        spi->lock(spi);
+    }
+
+    ctx = flash->erase_async;
+    if (ctx == NULL) {
+        goto __exit;
+    }
+
+    result = sfud_read_status(flash, &status);
+    if (result == SFUD_SUCCESS) {
+        if (status & SFUD_STATUS_REGISTER_BUSY) {
+            /* retry counts */
+            if (ctx->retry_times == 0) {
+                SFUD_INFO("Error: Flash asynchronous erase timeout.");
+                result = SFUD_ERR_TIMEOUT;
             } else {
-                goto __exit;
+                ctx->retry_times--;
+                result = SFUD_ERR_BUSY;
             }
-        } else {
-            if (size > cur_erase_size) {
-                size -= cur_erase_size;
-                addr += cur_erase_size;
-            } else {
-                goto __exit;
+        } else if (erase_next(&ctx->addr, &ctx->size, ctx->cur_erase_size)) {
+            result = erase_async_start_sector(flash, ctx);
+            if (result == SFUD_SUCCESS) {
+                result = SFUD_ERR_BUSY;
             }
         }
     }
 
+    if (result != SFUD_ERR_BUSY) {
+        /* set the flash write disable */
+        set_write_enabled(flash, false);
+        flash->erase_async = NULL;
+    }
+
 __exit:
-    /* set the flash write disable */
-    set_write_enabled(flash, false);
     /* unlock SPI */
     if (spi->unlock) {
         spi->unlock(spi);
     }
 
+    if (ctx && result != SFUD_ERR_BUSY && ctx->done) {
+        ctx->done(flash, result, ctx->user_data);
+    }
+
+    return result;
+}
+#endif /* SFUD_USING_ASYNC_ERASE */
+
+#ifdef SFUD_USING_ERASE_SUSPEND
+/**
+ * suspend the program or erase which is in progress
+ *
+ * @note The SPI bus must be locked by caller.
+ *
+ * @param flash flash device
+ *
+ * @return result, SFUD_SUCCESS: the flash is not busy now, it can be read
+ */
+sfud_err sfud_erase_suspend(const sfud_flash *flash) {
+    uint8_t cmd = SFUD_CMD_PROGRAM_ERASE_SUSPEND;
+    sfud_err result;
+
+    SFUD_ASSERT(flash);
+
+    result = flash->spi.wr(&flash->spi, &cmd, 1, NULL, 0);
+    if (result == SFUD_SUCCESS) {
+        /* the busy bit will be cleared after suspend latency (tSUS) */
+        result = wait_busy(flash);
+    }
+
     return result;
 }
 
+/**
+ * resume the suspended program or erase
+ *
+ * @note The SPI bus must be locked by caller.
+ *
+ * @param flash flash device
+ *
+ * @return result
+ */
+sfud_err sfud_erase_resume(const sfud_flash *flash) {
+    uint8_t cmd = SFUD_CMD_READ_STATUS_REGISTER_2, status;
+    sfud_err result;
+
+    SFUD_ASSERT(flash);
+
+    result = flash->spi.wr(&flash->spi, &cmd, 1, &status, 1);
+    /* the operation was finished before suspend */
+    if (result != SFUD_SUCCESS || (status & SFUD_STATUS_REGISTER2_SUS) == 0) {
+        return result;
+    }
+
+    cmd = SFUD_CMD_PROGRAM_ERASE_RESUME;
+    return flash->spi.wr(&flash->spi, &cmd, 1, NULL, 0);
+}
+
+/**
+ * suspend the asynchronous erase for reading
+ *
+ * @param flash flash device
+ * @param addr read address
+ * @param size read size
+ *
+ * @return true: the erase is suspended, it must be resumed after read
+ */
+static bool erase_async_suspend(const sfud_flash *flash, uint32_t addr, size_t size) {
+    sfud_erase_async_ctx *ctx = flash->erase_async;
+    uint32_t sector_addr;
+    uint8_t status;
+
+    if (ctx == NULL) {
+        return false;
+    }
+    /* the data of erasing sector is undefined when suspended, so the read must wait the erase finish */
+    sector_addr = ctx->addr - ctx->addr % ctx->cur_erase_size;
+    if (addr < sector_addr + ctx->cur_erase_size && addr + size > sector_addr) {
+        return false;
+    }
+    if (sfud_read_status(flash, &status) != SFUD_SUCCESS || (status & SFUD_STATUS_REGISTER_BUSY) == 0) {
+        return false;
+    }
+    if (sfud_erase_suspend(flash) != SFUD_SUCCESS) {
+        return false;
+    }
+    ctx->suspend_count++;
+
+    return true;
+}
+#endif /* SFUD_USING_ERASE_SUSPEND */
+
 /**
  * write flash data (no erase operate) for write 1 to 256 bytes per page mode or byte write mode
  *
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Read latency benchmark for the SFUD asynchronous erase.
+ *
+ * The flash is simulated in RAM: the erase of each sector keeps the busy bit set for a typical
+ * sector erase time, program/erase suspend and resume are simulated too. A reader thread keeps
+ * reading another sector while the erase is in progress and records the read latency.
+ */
+
+#include <rtthread.h>
+#include <string.h>
+#include "./sfud/inc/sfud.h"
+
+#if defined(RT_SFUD_USING_ERASE_BENCH) && defined(RT_USING_FINSH)
+
+#define SIM_FLASH_CAPACITY              (1024 * 1024)
+#define SIM_FLASH_SECTOR_SIZE           4096
+#define SIM_FLASH_SECTOR_ERASE_MS       45
+#define SIM_FLASH_PAGE_PROGRAM_MS       1
+#define BENCH_READ_SIZE                 256
+#define BENCH_READ_INTERVAL_MS          2
+
+struct sim_flash
+{
+    sfud_flash flash;
+    struct rt_mutex lock;
+    rt_tick_t busy_until;
+    rt_tick_t suspend_left;
+    rt_bool_t busy;
+    rt_bool_t wel;
+    rt_bool_t sus;
+    rt_uint32_t read_when_busy;
+};
+
+struct bench_result
+{
+    rt_tick_t erase_ticks;
+    rt_uint32_t reads;
+    rt_tick_t total_latency;
+    rt_tick_t max_latency;
+};
+
+static struct sim_flash sim;
+static volatile rt_bool_t reader_running;
+static struct bench_result reader_result;
+
+static void sim_update(struct sim_flash *sf)
+{
+    if (sf->busy && (rt_tick_t)(rt_tick_get() - sf->busy_until) < RT_TICK_MAX / 2)
+    {
+        sf->busy = RT_FALSE;
+    }
+}
+
+static void sim_set_busy(struct sim_flash *sf, rt_tick_t ticks)
+{
+    sf->busy = RT_TRUE;
+    sf->busy_until = rt_tick_get() + ticks;
+}
+
+static sfud_err sim_wr(const sfud_spi *spi, const uint8_t *write_buf, size_t write_size, uint8_t *read_buf,
+                       size_t read_size)
+{
+    struct sim_flash *sf = (struct sim_flash *)spi->user_data;
+
+    RT_ASSERT(write_size);
+    sim_update(sf);
+
+    switch (write_buf[0])
+    {
+    case SFUD_CMD_READ_STATUS_REGISTER:
+        read_buf[0] = (sf->busy ? SFUD_STATUS_REGISTER_BUSY : 0) | (sf->wel ? SFUD_STATUS_REGISTER_WEL : 0);
+        break;
+    case SFUD_CMD_READ_STATUS_REGISTER_2:
+        read_buf[0] = sf->sus ? SFUD_STATUS_REGISTER2_SUS : 0;
+        break;
+    case SFUD_CMD_WRITE_ENABLE:
+        if (!sf->busy)
+        {
+            sf->wel = RT_TRUE;
+        }
+        break;
+    case SFUD_CMD_WRITE_DISABLE:
+        if (!sf->busy)
+        {
+            sf->wel = RT_FALSE;
+        }
+        break;
+    case 0x20:
+        if (sf->wel && !sf->busy)
+        {
+            sim_set_busy(sf, rt_tick_from_millisecond(SIM_FLASH_SECTOR_ERASE_MS));
+            sf->wel = RT_FALSE;
+        }
+        break;
+    case SFUD_CMD_PAGE_PROGRAM:
+        if (sf->wel && !sf->busy)
+        {
+            sim_set_busy(sf, rt_tick_from_millisecond(SIM_FLASH_PAGE_PROGRAM_MS));
+            sf->wel = RT_FALSE;
+        }
+        break;
+    case SFUD_CMD_PROGRAM_ERASE_SUSPEND:
+        if (sf->busy)
+        {
+            sf->suspend_left = sf->busy_until - rt_tick_get();
+            sf->busy = RT_FALSE;
+            sf->sus = RT_TRUE;
+        }
+        break;
+    case SFUD_CMD_PROGRAM_ERASE_RESUME:
+        if (sf->sus)
+        {
+            sim_set_busy(sf, sf->suspend_left);
+            sf->sus = RT_FALSE;
+        }
+        break;
+    case SFUD_CMD_READ_DATA:
+        if (sf->busy)
+        {
+            sf->read_when_busy++;
+        }
+        rt_memset(read_buf, 0xFF, read_size);
+        break;
+    default:
+        break;
+    }
+
+    return SFUD_SUCCESS;
+}
+
+static void sim_lock(const sfud_spi *spi)
+{
+    rt_mutex_take(&((struct sim_flash *)spi->user_data)->lock, RT_WAITING_FOREVER);
+}
+
+static void sim_unlock(const sfud_spi *spi)
+{
+    rt_mutex_release(&((struct sim_flash *)spi->user_data)->lock);
+}
+
+static void sim_retry_delay(void)
+{
+    rt_thread_delay(1);
+}
+
+static void sim_flash_init(struct sim_flash *sf)
+{
+    rt_memset(sf, 0, sizeof(*sf));
+    rt_mutex_init(&sf->lock, "simflash", RT_IPC_FLAG_PRIO);
+
+    sf->flash.name = "simflash";
+    sf->flash.chip.capacity = SIM_FLASH_CAPACITY;
+    sf->flash.chip.write_mode = SFUD_WM_PAGE_256B;
+    sf->flash.chip.erase_gran = SIM_FLASH_SECTOR_SIZE;
+    sf->flash.chip.erase_gran_cmd = 0x20;
+    sf->flash.spi.name = "simflash";
+    sf->flash.spi.wr = sim_wr;
+    sf->flash.spi.lock = sim_lock;
+    sf->flash.spi.unlock = sim_unlock;
+    sf->flash.spi.user_data = sf;
+    sf->flash.retry.delay = sim_retry_delay;
+    sf->flash.retry.times = 10000;
+    sf->flash.init_ok = true;
+}
+
+static void reader_entry(void *parameter)
+{
+    rt_sem_t done = (rt_sem_t)parameter;
+    uint8_t buf[BENCH_READ_SIZE];
+    rt_tick_t start, latency;
+
+    while (reader_running)
+    {
+        start = rt_tick_get();
+        /* the last sector is never erased by the benchmark */
+        sfud_read(&sim.flash, SIM_FLASH_CAPACITY - SIM_FLASH_SECTOR_SIZE, sizeof(buf), buf);
+        latency = rt_tick_get() - start;
+
+        reader_result.reads++;
+        reader_result.total_latency += latency;
+        if (latency > reader_result.max_latency)
+        {
+            reader_result.max_latency = latency;
+        }
+        rt_thread_mdelay(BENCH_READ_INTERVAL_MS);
+    }
+
+    rt_sem_release(done);
+}
+
+static void bench_run(const char *mode, rt_bool_t async, rt_uint32_t sectors)
+{
+    rt_thread_t reader;
+    rt_sem_t done;
+    rt_tick_t start;
+    size_t suspend_count = 0;
+    sfud_err result;
+
+    done = rt_sem_create("sfbench", 0, RT_IPC_FLAG_PRIO);
+    if (done == RT_NULL)
+    {
+        return;
+    }
+    rt_memset(&reader_result, 0, sizeof(reader_result));
+    reader_running = RT_TRUE;
+    reader = rt_thread_create("sfreader", reader_entry, done, 1024, RT_THREAD_PRIORITY_MAX / 2 - 1, 10);
+    if (reader == RT_NULL)
+    {
+        rt_sem_delete(done);
+        return;
+    }
+    rt_thread_startup(reader);
+
+    start = rt_tick_get();
+    if (async)
+    {
+#ifdef SFUD_USING_ASYNC_ERASE
+        sfud_erase_async_ctx ctx;
+
+        result = sfud_erase_async(&sim.flash, &ctx, 0, sectors * SIM_FLASH_SECTOR_SIZE, RT_NULL, RT_NULL);
+        while (result == SFUD_SUCCESS && (result = sfud_erase_async_poll(&sim.flash)) == SFUD_ERR_BUSY)
+        {
+            rt_thread_delay(1);
+        }
+        suspend_count = ctx.suspend_count;
+#else
+        result = SFUD_ERR_NOT_FOUND;
+#endif
+    }
+    else
+    {
+        result = sfud_erase(&sim.flash, 0, sectors * SIM_FLASH_SECTOR_SIZE);
+    }
+    reader_result.erase_ticks = rt_tick_get() - start;
+
+    reader_running = RT_FALSE;
+    rt_sem_take(done, RT_WAITING_FOREVER);
+    rt_sem_delete(done);
+
+    if (result != SFUD_SUCCESS)
+    {
+        rt_kprintf("%-6s erase failed (%d)\n", mode, result);
+        return;
+    }
+    rt_kprintf("%-6s %8d %6d %8d %8d %8d\n", mode,
+               reader_result.erase_ticks * 1000 / RT_TICK_PER_SECOND,
+               reader_result.reads,
+               reader_result.reads ? reader_result.total_latency * 1000 / RT_TICK_PER_SECOND / reader_result.reads : 0,
+               reader_result.max_latency * 1000 / RT_TICK_PER_SECOND,
+               suspend_count);
+}
+
+static void sfud_erase_bench(int argc, char **argv)
+{
+    rt_uint32_t sectors = 16;
+
+    if (argc > 1)
+    {
+        sectors = strtoul(argv[1], RT_NULL, 0);
+    }
+    if (sectors == 0 || sectors >= SIM_FLASH_CAPACITY / SIM_FLASH_SECTOR_SIZE)
+    {
+        rt_kprintf("Usage: sfud_erase_bench [sectors(1-%d)]\n", SIM_FLASH_CAPACITY / SIM_FLASH_SECTOR_SIZE - 1);
+        return;
+    }
+
+    sim_flash_init(&sim);
+    rt_kprintf("erase %d sectors, %d ms per sector, read %d bytes every %d ms\n", sectors,
+               SIM_FLASH_SECTOR_ERASE_MS, BENCH_READ_SIZE, BENCH_READ_INTERVAL_MS);
+    rt_kprintf("mode   erase_ms  reads  avg_ms   max_ms   suspends\n");
+    bench_run("sync", RT_FALSE, sectors);
+    bench_run("async", RT_TRUE, sectors);
+    if (sim.read_when_busy)
+    {
+        rt_kprintf("ERROR: %d reads were issued while the flash was busy\n", sim.read_when_busy);
+    }
+
+    rt_mutex_detach(&sim.lock);
+}
+MSH_CMD_EXPORT(sfud_erase_bench, SFUD read latency benchmark during erase on a simulated flash);
+
+#endif /* defined(RT_SFUD_USING_ERASE_BENCH) && defined(RT_USING_FINSH) */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-09-28     armink       first version.
+ * 2026-10-18     RT-Thread    add asynchronous erase by system workqueue.
  */
 
 #include <stdint.h>
@@ -509,6 +510,78 @@ __error:
     return RT_NULL;
 }
 
+#ifdef SFUD_USING_ASYNC_ERASE
+struct sfud_erase_async_work {
+    sfud_erase_async_ctx ctx;
+    struct rt_work work;
+    sfud_flash *sfud_dev;
+    sfud_erase_async_cb done;
+    void *user_data;
+};
+
+static void erase_async_done(const sfud_flash *flash, sfud_err result, void *user_data) {
+    struct sfud_erase_async_work *erase_work = (struct sfud_erase_async_work *) user_data;
+
+    if (erase_work->done) {
+        erase_work->done(flash, result, erase_work->user_data);
+    }
+    rt_free(erase_work);
+}
+
+static void erase_async_poll(struct rt_work *work, void *work_data) {
+    struct sfud_erase_async_work *erase_work = (struct sfud_erase_async_work *) work_data;
+
+    /* the erase_work will be freed by erase_async_done when the erase is finished */
+    if (sfud_erase_async_poll(erase_work->sfud_dev) == SFUD_ERR_BUSY) {
+        rt_work_submit(work, 1);
+    }
+}
+
+/**
+ * Erase SPI flash without blocking the caller. The erase is polled by system workqueue every tick.
+ *
+ * @param sfud_dev SFUD flash device
+ * @param addr start address
+ * @param size erase size
+ * @param done complete callback, it will be called in system workqueue thread. RT_NULL will not callback.
+ * @param user_data complete callback user data
+ *
+ * @return the operation status, RT_EOK on successful, -RT_EBUSY when there is another erase is in progress
+ */
+rt_err_t rt_sfud_flash_erase_async(sfud_flash_t sfud_dev, rt_uint32_t addr, rt_size_t size, sfud_erase_async_cb done,
+        void *user_data) {
+    struct sfud_erase_async_work *erase_work;
+    sfud_err result;
+
+    RT_ASSERT(sfud_dev);
+
+    erase_work = (struct sfud_erase_async_work *) rt_calloc(1, sizeof(struct sfud_erase_async_work));
+    if (erase_work == RT_NULL) {
+        LOG_E("ERROR: Low memory.");
+        return -RT_ENOMEM;
+    }
+    erase_work->sfud_dev = sfud_dev;
+    erase_work->done = done;
+    erase_work->user_data = user_data;
+    rt_work_init(&erase_work->work, erase_async_poll, erase_work);
+
+    result = sfud_erase_async(sfud_dev, &erase_work->ctx, addr, size, erase_async_done, erase_work);
+    if (result == SFUD_ERR_BUSY) {
+        rt_free(erase_work);
+        return -RT_EBUSY;
+    } else if (result != SFUD_SUCCESS) {
+        rt_free(erase_work);
+        return -RT_ERROR;
+    }
+    /* the zero size erase is completed in sfud_erase_async */
+    if (size) {
+        rt_work_submit(&erase_work->work, 1);
+    }
+
+    return RT_EOK;
+}
+#endif /* SFUD_USING_ASYNC_ERASE */
+
 #if defined(RT_USING_FINSH)
 
 #include <finsh.h>
@@ -66,4 +66,20 @@ sfud_flash_t rt_sfud_flash_find(const char *spi_dev_name);
  */
 sfud_flash_t rt_sfud_flash_find_by_dev_name(const char *flash_dev_name);
 
+#ifdef SFUD_USING_ASYNC_ERASE
+/**
+ * Erase SPI flash without blocking the caller. The erase is polled by system workqueue every tick.
+ *
+ * @param sfud_dev SFUD flash device
+ * @param addr start address
+ * @param size erase size
+ * @param done complete callback, it will be called in system workqueue thread. RT_NULL will not callback.
+ * @param user_data complete callback user data
+ *
+ * @return the operation status, RT_EOK on successful, -RT_EBUSY when there is another erase is in progress
+ */
+rt_err_t rt_sfud_flash_erase_async(sfud_flash_t sfud_dev, rt_uint32_t addr, rt_size_t size, sfud_erase_async_cb done,
+        void *user_data);
+#endif /* SFUD_USING_ASYNC_ERASE */
+
 #endif /* _SPI_FLASH_SFUD_H_ */
@@ -80,6 +80,29 @@ void fal_set_partition_table_temp(struct fal_partition *table, size_t len);
  */
 int fal_partition_read(const struct fal_partition *part, uint32_t addr, uint8_t *buf, size_t size);
 
+/**
+ * get the memory mapped address of partition data for zero-copy read.
+ * The address is valid until fal_partition_munmap(), which must be called by the same
+ * thread. The flash device is held in between, the other threads accessing it wait.
+ *
+ * @param part partition
+ * @param addr relative address for partition
+ * @param size read size
+ *
+ * @return != NULL: memory mapped address
+ *            NULL: the flash device is not support memory mapped read
+ */
+const void *fal_partition_mmap(const struct fal_partition *part, uint32_t addr, size_t size);
+
+/**
+ * release the memory mapped address got by fal_partition_mmap()
+ *
+ * @param part partition
+ * @param addr relative address for partition, the same as fal_partition_mmap()
+ * @param size read size, the same as fal_partition_mmap()
+ */
+void fal_partition_munmap(const struct fal_partition *part, uint32_t addr, size_t size);
+
 /**
  * write data to partition
  *
@@ -89,6 +89,10 @@ struct fal_flash_dev
         int (*read)(long offset, uint8_t *buf, size_t size);
         int (*write)(long offset, const uint8_t *buf, size_t size);
         int (*erase)(long offset, size_t size);
+        /* optional, get the memory mapped address for zero-copy read. NULL: not supported */
+        const void *(*mmap)(long offset, size_t size);
+        /* release the address got by mmap, required with mmap */
+        void (*munmap)(long offset, size_t size);
     } ops;
 
     /* write minimum granularity, unit: bit.
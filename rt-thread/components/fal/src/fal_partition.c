@@ -428,6 +428,64 @@ int fal_partition_read(const struct fal_partition *part, uint32_t addr, uint8_t
     return ret;
 }
 
+/**
+ * get the memory mapped address of partition data for zero-copy read.
+ * The address is valid until fal_partition_munmap(), which must be called by the same
+ * thread. The flash device is held in between, the other threads accessing it wait.
+ *
+ * @param part partition
+ * @param addr relative address for partition
+ * @param size read size
+ *
+ * @return != NULL: memory mapped address
+ *            NULL: the flash device is not support memory mapped read
+ */
+const void *fal_partition_mmap(const struct fal_partition *part, uint32_t addr, size_t size)
+{
+    const struct fal_flash_dev *flash_dev = NULL;
+
+    assert(part);
+
+    if (addr + size > part->len)
+    {
+        log_e("Partition mmap error! Partition(%s) address(0x%08x) out of bound(0x%08x).", part->name, addr + size, part->len);
+        return NULL;
+    }
+
+    flash_dev = flash_device_find_by_part(part);
+    if (flash_dev == NULL)
+    {
+        log_e("Partition mmap error! Don't found flash device(%s) of the partition(%s).", part->flash_name, part->name);
+        return NULL;
+    }
+
+    if (flash_dev->ops.mmap == NULL || flash_dev->ops.munmap == NULL)
+    {
+        return NULL;
+    }
+
+    return flash_dev->ops.mmap(part->offset + addr, size);
+}
+
+/**
+ * release the memory mapped address got by fal_partition_mmap()
+ *
+ * @param part partition
+ * @param addr relative address for partition, the same as fal_partition_mmap()
+ * @param size read size, the same as fal_partition_mmap()
+ */
+void fal_partition_munmap(const struct fal_partition *part, uint32_t addr, size_t size)
+{
+    const struct fal_flash_dev *flash_dev = NULL;
+
+    assert(part);
+
+    flash_dev = flash_device_find_by_part(part);
+    assert(flash_dev && flash_dev->ops.munmap);
+
+    flash_dev->ops.munmap(part->offset + addr, size);
+}
+
 /**
  * write data to partition
  *
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#ifndef __MSH_BENCH_H__
+#define __MSH_BENCH_H__
+
+#include <rtthread.h>
+
+/*
+ * The clock of the benchmark commands: the CPU time with RT_USING_CPUTIME, the OS tick
+ * otherwise. BENCH_CLOCK() is read around the measured code, and the difference of two
+ * readings is converted with BENCH_CLOCK_NS() or BENCH_CLOCK_US().
+ */
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+
+#define BENCH_CLOCK()           ((rt_uint32_t)clock_cpu_gettime())
+#define BENCH_CLOCK_NS(t)       ((rt_uint64_t)(t) * clock_cpu_getres() / 1000000)
+#define BENCH_CLOCK_US(t)       ((rt_uint32_t)clock_cpu_microsecond(t))
+#else
+#define BENCH_CLOCK()           ((rt_uint32_t)rt_tick_get())
+#define BENCH_CLOCK_NS(t)       ((rt_uint64_t)(t) * 1000000000 / RT_TICK_PER_SECOND)
+#define BENCH_CLOCK_US(t)       ((rt_uint32_t)((rt_uint64_t)(t) * 1000000 / RT_TICK_PER_SECOND))
+#endif /* RT_USING_CPUTIME */
+
+#endif /* __MSH_BENCH_H__ */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2010-10-26     Bernard      the first version
+ * 2026-10-18     RT-Thread    atomic fast path of mutex and rwlock, rwlock kind
  */
 
 #ifndef __PTHREAD_H__
@@ -60,6 +61,14 @@ enum
     PTHREAD_MUTEX_DEFAULT = PTHREAD_MUTEX_NORMAL
 };
 
+enum
+{
+    PTHREAD_RWLOCK_PREFER_READER_NP = 0,
+    PTHREAD_RWLOCK_PREFER_WRITER_NP,
+    PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP,
+    PTHREAD_RWLOCK_DEFAULT_NP = PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP
+};
+
 /* init value for pthread_once_t */
 #define PTHREAD_ONCE_INIT       0
 
@@ -97,7 +106,9 @@ typedef struct pthread_attr pthread_attr_t;
 struct pthread_mutex
 {
     pthread_mutexattr_t attr;
-    struct rt_mutex lock;
+    struct rt_mutex lock;               /* for the threads waiting */
+    rt_atomic_t owner;                  /* owner thread, bit 0 set when threads wait */
+    int count;                          /* recursive takes of the owner */
 };
 typedef struct pthread_mutex pthread_mutex_t;
 
@@ -118,7 +129,7 @@ struct pthread_rwlock
 
     int rw_nwaitreaders;    /* the number of reader threads waiting */
     int rw_nwaitwriters;    /* the number of writer threads waiting */
-    int rw_refcount;    /* 0: unlocked, -1: locked by writer, > 0 locked by n readers */
+    rt_atomic_t rw_state;   /* the number of readers, the writer and the waiters bits */
 };
 typedef struct pthread_rwlock pthread_rwlock_t;
 
@@ -248,6 +259,8 @@ int pthread_rwlockattr_init (pthread_rwlockattr_t *attr);
 int pthread_rwlockattr_destroy (pthread_rwlockattr_t *attr);
 int pthread_rwlockattr_getpshared (const pthread_rwlockattr_t *attr, int *pshared);
 int pthread_rwlockattr_setpshared (pthread_rwlockattr_t *attr, int pshared);
+int pthread_rwlockattr_getkind_np (const pthread_rwlockattr_t *attr, int *pref);
+int pthread_rwlockattr_setkind_np (pthread_rwlockattr_t *attr, int pref);
 
 int pthread_rwlock_init (pthread_rwlock_t *rwlock, const pthread_rwlockattr_t *attr);
 int pthread_rwlock_destroy (pthread_rwlock_t *rwlock);
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * pthread mutex and rwlock benchmark.
+ *
+ * The uncontended lock and unlock pair of a pthread mutex is timed against the one of a kernel
+ * mutex. Then a number of threads at the priority of the shell take a rwlock for a number of
+ * rounds each, one round in the write ratio for writing and the others for reading, for the
+ * writer preferred and the reader preferred kinds. The time per lock and unlock pair over all
+ * the threads is reported and the count of the writes is checked. Without arguments it runs
+ * over 1, 2, 4 and 8 threads with one write in 16 rounds.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#if defined(PTHREAD_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_THREADS_MAX       8
+
+static pthread_rwlock_t bench_rwlock;
+static struct rt_semaphore bench_start, bench_done;
+static rt_uint32_t bench_rounds, bench_ratio, bench_writes;
+static volatile rt_uint32_t bench_value;
+
+static void bench_entry(void *parameter)
+{
+    rt_uint32_t i, value = 0;
+
+    rt_sem_take(&bench_start, RT_WAITING_FOREVER);
+    for (i = 0; i < bench_rounds; i++)
+    {
+        if (i % bench_ratio == 0)
+        {
+            pthread_rwlock_wrlock(&bench_rwlock);
+            bench_writes++;
+            bench_value = i;
+        }
+        else
+        {
+            pthread_rwlock_rdlock(&bench_rwlock);
+            value += bench_value;
+        }
+        pthread_rwlock_unlock(&bench_rwlock);
+    }
+    (void)value;
+    rt_sem_release(&bench_done);
+}
+
+static int bench_rwlock_run(rt_uint32_t threads, int kind, rt_uint32_t ratio, rt_uint32_t rounds)
+{
+    rt_thread_t tid[BENCH_THREADS_MAX];
+    pthread_rwlockattr_t attr;
+    rt_uint32_t i, t, ops, writes;
+
+    bench_rounds = rounds;
+    bench_ratio = ratio;
+    bench_writes = 0;
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setkind_np(&attr, kind);
+    pthread_rwlock_init(&bench_rwlock, &attr);
+    rt_sem_init(&bench_start, "pstart", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&bench_done, "pdone", 0, RT_IPC_FLAG_FIFO);
+
+    for (i = 0; i < threads; i++)
+    {
+        tid[i] = rt_thread_create("pbench", bench_entry, RT_NULL, 1024, rt_thread_self()->current_priority, 10);
+        if (tid[i] == RT_NULL)
+            break;
+        rt_thread_startup(tid[i]);
+    }
+    threads = i;
+
+    t = BENCH_CLOCK();
+    for (i = 0; i < threads; i++)
+        rt_sem_release(&bench_start);
+    for (i = 0; i < threads; i++)
+        rt_sem_take(&bench_done, RT_WAITING_FOREVER);
+    t = BENCH_CLOCK() - t;
+
+    ops = threads * rounds;
+    writes = threads * ((rounds + ratio - 1) / ratio);
+    rt_kprintf("%7d %-7s %10d %10d ns%s\n", threads, kind == PTHREAD_RWLOCK_PREFER_READER_NP ? "reader" : "writer",
+               ops, ops ? (rt_uint32_t)(BENCH_CLOCK_NS(t) / ops) : 0,
+               bench_writes == writes ? "" : "  write count mismatch");
+
+    rt_sem_detach(&bench_done);
+    rt_sem_detach(&bench_start);
+    pthread_rwlock_destroy(&bench_rwlock);
+    pthread_rwlockattr_destroy(&attr);
+
+    return threads;
+}
+
+static void bench_mutex_run(rt_uint32_t rounds)
+{
+    pthread_mutex_t pmutex;
+    struct rt_mutex kmutex;
+    rt_uint32_t i, tp, tk;
+
+    pthread_mutex_init(&pmutex, RT_NULL);
+    rt_mutex_init(&kmutex, "pbench", RT_IPC_FLAG_PRIO);
+
+    tp = BENCH_CLOCK();
+    for (i = 0; i < rounds; i++)
+    {
+        pthread_mutex_lock(&pmutex);
+        pthread_mutex_unlock(&pmutex);
+    }
+    tp = BENCH_CLOCK() - tp;
+
+    tk = BENCH_CLOCK();
+    for (i = 0; i < rounds; i++)
+    {
+        rt_mutex_take(&kmutex, RT_WAITING_FOREVER);
+        rt_mutex_release(&kmutex);
+    }
+    tk = BENCH_CLOCK() - tk;
+
+    rt_kprintf("uncontended lock+unlock: pthread mutex %d ns, kernel mutex %d ns\n",
+               (rt_uint32_t)(BENCH_CLOCK_NS(tp) / rounds), (rt_uint32_t)(BENCH_CLOCK_NS(tk) / rounds));
+
+    rt_mutex_detach(&kmutex);
+    pthread_mutex_destroy(&pmutex);
+}
+
+static void pthread_bench(int argc, char **argv)
+{
+    static const rt_uint8_t threads[] = {1, 2, 4, 8};
+    static const int kinds[] = {PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP, PTHREAD_RWLOCK_PREFER_READER_NP};
+    rt_uint32_t ratio = 16, rounds = 10000, i, j, count = 0;
+
+    if (argc > 1) count = strtoul(argv[1], RT_NULL, 0);
+    if (argc > 2) ratio = strtoul(argv[2], RT_NULL, 0);
+    if (argc > 3) rounds = strtoul(argv[3], RT_NULL, 0);
+    if (rounds == 0 || ratio == 0 || (argc > 1 && (count == 0 || count > BENCH_THREADS_MAX)))
+    {
+        rt_kprintf("Usage: pthread_bench [threads] [1/write ratio] [rounds]\n");
+        return;
+    }
+
+    bench_mutex_run(rounds);
+    rt_kprintf("rwlock, 1 write in %d\n", ratio);
+    rt_kprintf("threads prefer       locks  lock+unlock\n");
+
+    for (j = 0; j < sizeof(kinds) / sizeof(kinds[0]); j++)
+    {
+        if (count)
+        {
+            bench_rwlock_run(count, kinds[j], ratio, rounds);
+            continue;
+        }
+
+        for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+        {
+            if (bench_rwlock_run(threads[i], kinds[j], ratio, rounds) != threads[i])
+            {
+                rt_kprintf("no memory for the threads\n");
+                return;
+            }
+        }
+    }
+}
+MSH_CMD_EXPORT(pthread_bench, pthread mutex and rwlock);
+
+#ifdef RT_USING_UTEST
+#include <utest.h>
+
+static void test_rwlock_writes(void)
+{
+    static const int kinds[] = {PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP, PTHREAD_RWLOCK_PREFER_READER_NP};
+    rt_uint32_t threads, j;
+
+    /* the writers exclude each other with either preference, no write is lost */
+    for (j = 0; j < sizeof(kinds) / sizeof(kinds[0]); j++)
+    {
+        threads = bench_rwlock_run(BENCH_THREADS_MAX / 2, kinds[j], 4, 400);
+        uassert_int_equal(threads, BENCH_THREADS_MAX / 2);
+        uassert_int_equal(bench_writes, threads * 100);
+    }
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_rwlock_writes);
+}
+UTEST_TC_EXPORT(testcase, "components.libc.posix.pthreads.pthread_bench", RT_NULL, RT_NULL, 10);
+#endif /* RT_USING_UTEST */
+
+#endif /* defined(PTHREAD_USING_BENCH) && defined(RT_USING_FINSH) */
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2010-10-26     Bernard      the first version
  * 2022-06-27     xiangxistu   use atomic operation to protect pthread conditional variable
+ * 2026-10-18     RT-Thread    the owner of the mutex is in its atomic word
  */
 
 #include <rthw.h>
@@ -236,7 +237,7 @@ rt_err_t _pthread_cond_timedwait(pthread_cond_t *cond,
     }
 
     /* The mutex was not owned by the current thread at the time of the call. */
-    if (mutex->lock.owner != rt_thread_self())
+    if (_pthread_mutex_owner(mutex) != rt_thread_self())
     {
         return -RT_ERROR;
     }
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2010-10-26     Bernard      the first version
+ * 2026-10-18     RT-Thread    add the owner of the atomic mutex
  */
 
 #ifndef __PTHREAD_INTERNAL_H__
@@ -63,4 +64,12 @@ typedef struct _pthread_data _pthread_data_t;
 
 _pthread_data_t *_pthread_get_data(pthread_t thread);
 
+/* set in the owner word of a mutex when threads wait on its kernel mutex */
+#define PTHREAD_MUTEX_WAITERS   1
+
+rt_inline rt_thread_t _pthread_mutex_owner(pthread_mutex_t *mutex)
+{
+    return (rt_thread_t)(rt_atomic_load(&mutex->owner) & ~PTHREAD_MUTEX_WAITERS);
+}
+
 #endif
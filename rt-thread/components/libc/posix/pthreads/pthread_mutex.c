@@ -6,10 +6,13 @@
  * Change Logs:
  * Date           Author       Notes
  * 2010-10-26     Bernard      the first version
+ * 2026-10-18     RT-Thread    atomic fast path, the kernel mutex for the waiters only
  */
 
+#include <rthw.h>
 #include <rtthread.h>
 #include "pthread.h"
+#include "pthread_internal.h"
 
 #define  MUTEXATTR_SHARED_MASK 0x0010
 #define  MUTEXATTR_TYPE_MASK   0x000f
@@ -129,6 +132,9 @@ int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr)
     rt_object_detach(&(mutex->lock.parent.parent));
     mutex->lock.parent.parent.type = RT_Object_Class_Mutex;
 
+    rt_atomic_store(&(mutex->owner), 0);
+    mutex->count = 0;
+
     return 0;
 }
 RTM_EXPORT(pthread_mutex_init);
@@ -139,7 +145,7 @@ int pthread_mutex_destroy(pthread_mutex_t *mutex)
         return EINVAL;
 
     /* it's busy */
-    if (mutex->lock.owner != RT_NULL)
+    if (rt_atomic_load(&(mutex->owner)) != 0)
         return EBUSY;
 
     rt_memset(mutex, 0, sizeof(pthread_mutex_t));
@@ -149,10 +155,73 @@ int pthread_mutex_destroy(pthread_mutex_t *mutex)
 }
 RTM_EXPORT(pthread_mutex_destroy);
 
+/*
+ * The owner word of a mutex is taken with a compare-and-swap from 0 to the thread and given back
+ * the same way, the kernel is not entered as long as no other thread comes meanwhile. A thread
+ * that finds the mutex taken sets PTHREAD_MUTEX_WAITERS in the word, gives the kernel mutex to
+ * the owner and waits on it, so that the owner inherits its priority. The owner then unlocks
+ * through the kernel mutex, which goes to the next thread together with the word.
+ */
+static int _pthread_mutex_lock_slow(pthread_mutex_t *mutex, rt_int32_t timeout)
+{
+    rt_thread_t thread = rt_thread_self();
+    rt_atomic_t value;
+    rt_base_t level;
+    rt_err_t result;
+
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        value = rt_atomic_load(&(mutex->owner));
+        while (1)
+        {
+            if (value == 0)
+            {
+                if (rt_atomic_compare_exchange_strong(&(mutex->owner), &value, (rt_atomic_t)thread))
+                {
+                    rt_hw_interrupt_enable(level);
+                    return 0;
+                }
+            }
+            else if ((value & PTHREAD_MUTEX_WAITERS) ||
+                     rt_atomic_compare_exchange_strong(&(mutex->owner), &value, value | PTHREAD_MUTEX_WAITERS))
+            {
+                break;
+            }
+        }
+
+        /* the owner took the word alone, the kernel mutex is handed to it now */
+        if (mutex->lock.owner == RT_NULL)
+            rt_mutex_take_for(&(mutex->lock), (rt_thread_t)(value & ~PTHREAD_MUTEX_WAITERS));
+        rt_hw_interrupt_enable(level);
+
+        result = rt_mutex_take(&(mutex->lock), timeout);
+        if (result != RT_EOK)
+            return EBUSY;
+
+        /* the owner may have let the word go before this thread was on the kernel mutex */
+        level = rt_hw_interrupt_disable();
+        value = rt_atomic_load(&(mutex->owner));
+        while (value == 0 || (rt_thread_t)(value & ~PTHREAD_MUTEX_WAITERS) == thread)
+        {
+            if (rt_atomic_compare_exchange_strong(&(mutex->owner), &value, (rt_atomic_t)thread | PTHREAD_MUTEX_WAITERS))
+            {
+                rt_hw_interrupt_enable(level);
+                return 0;
+            }
+        }
+        rt_hw_interrupt_enable(level);
+
+        /* taken by another thread meanwhile, wait for that one */
+        rt_mutex_release(&(mutex->lock));
+    }
+}
+
 int pthread_mutex_lock(pthread_mutex_t *mutex)
 {
     int mtype;
-    rt_err_t result;
+    rt_thread_t thread;
+    rt_atomic_t value = 0;
 
     if (!mutex)
         return EINVAL;
@@ -163,28 +232,29 @@ int pthread_mutex_lock(pthread_mutex_t *mutex)
         pthread_mutex_init(mutex, RT_NULL);
     }
 
-    mtype = mutex->attr & MUTEXATTR_TYPE_MASK;
-    rt_enter_critical();
-    if (mutex->lock.owner == rt_thread_self() &&
-        mtype != PTHREAD_MUTEX_RECURSIVE)
-    {
-        rt_exit_critical();
+    thread = rt_thread_self();
+    if (rt_atomic_compare_exchange_strong(&(mutex->owner), &value, (rt_atomic_t)thread))
+        return 0;
 
-        return EDEADLK;
-    }
-    rt_exit_critical();
+    if ((rt_thread_t)(value & ~PTHREAD_MUTEX_WAITERS) == thread)
+    {
+        mtype = mutex->attr & MUTEXATTR_TYPE_MASK;
+        if (mtype != PTHREAD_MUTEX_RECURSIVE)
+            return EDEADLK;
 
-    result = rt_mutex_take(&(mutex->lock), RT_WAITING_FOREVER);
-    if (result == RT_EOK)
+        mutex->count ++;
         return 0;
+    }
 
-    return EINVAL;
+    return _pthread_mutex_lock_slow(mutex, RT_WAITING_FOREVER) == 0 ? 0 : EINVAL;
 }
 RTM_EXPORT(pthread_mutex_lock);
 
 int pthread_mutex_unlock(pthread_mutex_t *mutex)
 {
-    rt_err_t result;
+    rt_thread_t thread, next = RT_NULL;
+    rt_atomic_t value;
+    rt_base_t level;
 
     if (!mutex)
         return EINVAL;
@@ -194,7 +264,9 @@ int pthread_mutex_unlock(pthread_mutex_t *mutex)
         pthread_mutex_init(mutex, RT_NULL);
     }
 
-    if (mutex->lock.owner != rt_thread_self())
+    thread = rt_thread_self();
+    value = rt_atomic_load(&(mutex->owner));
+    if ((rt_thread_t)(value & ~PTHREAD_MUTEX_WAITERS) != thread)
     {
         int mtype;
         mtype = mutex->attr & MUTEXATTR_TYPE_MASK;
@@ -204,22 +276,41 @@ int pthread_mutex_unlock(pthread_mutex_t *mutex)
             return EPERM;
 
         /* no thread waiting on this mutex */
-        if (mutex->lock.owner == RT_NULL)
+        if (value == 0)
             return 0;
+
+        return EINVAL;
     }
 
-    result = rt_mutex_release(&(mutex->lock));
-    if (result == RT_EOK)
+    if (mutex->count > 0)
+    {
+        mutex->count --;
         return 0;
+    }
 
-    return EINVAL;
+    value = (rt_atomic_t)thread;
+    if (rt_atomic_compare_exchange_strong(&(mutex->owner), &value, 0))
+        return 0;
+
+    /* threads wait, the kernel mutex goes to the first one and the word goes with it */
+    level = rt_hw_interrupt_disable();
+    if (mutex->lock.owner == thread)
+    {
+        rt_mutex_release(&(mutex->lock));
+        next = mutex->lock.owner;
+    }
+    rt_atomic_store(&(mutex->owner), next ? (rt_atomic_t)next | PTHREAD_MUTEX_WAITERS : 0);
+    rt_hw_interrupt_enable(level);
+
+    return 0;
 }
 RTM_EXPORT(pthread_mutex_unlock);
 
 int pthread_mutex_trylock(pthread_mutex_t *mutex)
 {
-    rt_err_t result;
     int mtype;
+    rt_thread_t thread;
+    rt_atomic_t value = 0;
 
     if (!mutex)
         return EINVAL;
@@ -229,19 +320,19 @@ int pthread_mutex_trylock(pthread_mutex_t *mutex)
         pthread_mutex_init(mutex, RT_NULL);
     }
 
-    mtype = mutex->attr & MUTEXATTR_TYPE_MASK;
-    rt_enter_critical();
-    if (mutex->lock.owner == rt_thread_self() &&
-        mtype != PTHREAD_MUTEX_RECURSIVE)
+    thread = rt_thread_self();
+    if (rt_atomic_compare_exchange_strong(&(mutex->owner), &value, (rt_atomic_t)thread))
+        return 0;
+
+    if ((rt_thread_t)(value & ~PTHREAD_MUTEX_WAITERS) == thread)
     {
-        rt_exit_critical();
+        mtype = mutex->attr & MUTEXATTR_TYPE_MASK;
+        if (mtype != PTHREAD_MUTEX_RECURSIVE)
+            return EDEADLK;
 
-        return EDEADLK;
+        mutex->count ++;
+        return 0;
     }
-    rt_exit_critical();
-
-    result = rt_mutex_take(&(mutex->lock), 0);
-    if (result == RT_EOK) return 0;
 
     return EBUSY;
 }
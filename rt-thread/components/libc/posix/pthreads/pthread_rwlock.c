@@ -6,10 +6,17 @@
  * Change Logs:
  * Date           Author       Notes
  * 2010-10-26     Bernard      the first version
+ * 2026-10-18     RT-Thread    atomic state word, reader or writer preference
  */
 
 #include <pthread.h>
 
+#define RWLOCKATTR_PREFER_READER    0x0100
+
+#define RWLOCK_WRITER               ((rt_atomic_t)1 << 30)
+#define RWLOCK_WAITERS              ((rt_atomic_t)1 << 29)
+#define RWLOCK_READERS              (RWLOCK_WAITERS - 1)
+
 int pthread_rwlockattr_init(pthread_rwlockattr_t *attr)
 {
     if (!attr)
@@ -50,20 +57,60 @@ int pthread_rwlockattr_setpshared(pthread_rwlockattr_t *attr, int pshared)
 }
 RTM_EXPORT(pthread_rwlockattr_setpshared);
 
+int pthread_rwlockattr_getkind_np(const pthread_rwlockattr_t *attr, int *pref)
+{
+    if (!attr || !pref)
+        return EINVAL;
+
+    *pref = (*attr & RWLOCKATTR_PREFER_READER) ? PTHREAD_RWLOCK_PREFER_READER_NP
+                                               : PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP;
+
+    return 0;
+}
+RTM_EXPORT(pthread_rwlockattr_getkind_np);
+
+int pthread_rwlockattr_setkind_np(pthread_rwlockattr_t *attr, int pref)
+{
+    if (!attr)
+        return EINVAL;
+
+    switch (pref)
+    {
+    case PTHREAD_RWLOCK_PREFER_READER_NP:
+        *attr |= RWLOCKATTR_PREFER_READER;
+        return 0;
+
+    case PTHREAD_RWLOCK_PREFER_WRITER_NP:
+    case PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP:
+        *attr &= ~RWLOCKATTR_PREFER_READER;
+        return 0;
+    }
+
+    return EINVAL;
+}
+RTM_EXPORT(pthread_rwlockattr_setkind_np);
+
+/*
+ * The state word of a rwlock has the number of readers, RWLOCK_WRITER for a writer and
+ * RWLOCK_WAITERS when threads wait. Without waiters a lock and an unlock are a compare-and-swap
+ * on the word alone. A thread that has to wait takes rw_mutex, sets RWLOCK_WAITERS and waits on
+ * a condition, the unlock that leaves the word free with waiters takes rw_mutex to wake them.
+ * New readers do not pass waiting writers, unless the rwlock prefers readers.
+ */
 int pthread_rwlock_init(pthread_rwlock_t           *rwlock,
                         const pthread_rwlockattr_t *attr)
 {
     if (!rwlock)
         return EINVAL;
 
-    rwlock->attr = PTHREAD_PROCESS_PRIVATE;
+    rwlock->attr = attr ? *attr : PTHREAD_PROCESS_PRIVATE;
     pthread_mutex_init(&(rwlock->rw_mutex), NULL);
     pthread_cond_init(&(rwlock->rw_condreaders), NULL);
     pthread_cond_init(&(rwlock->rw_condwriters), NULL);
 
     rwlock->rw_nwaitwriters = 0;
     rwlock->rw_nwaitreaders = 0;
-    rwlock->rw_refcount = 0;
+    rt_atomic_store(&(rwlock->rw_state), 0);
 
     return 0;
 }
@@ -81,7 +128,7 @@ int pthread_rwlock_destroy (pthread_rwlock_t *rwlock)
     if ( (result = pthread_mutex_lock(&rwlock->rw_mutex)) != 0)
         return(result);
 
-    if (rwlock->rw_refcount != 0 ||
+    if (rt_atomic_load(&(rwlock->rw_state)) != 0 ||
         rwlock->rw_nwaitreaders != 0 ||
         rwlock->rw_nwaitwriters != 0)
     {
@@ -122,184 +169,241 @@ int pthread_rwlock_destroy (pthread_rwlock_t *rwlock)
 }
 RTM_EXPORT(pthread_rwlock_destroy);
 
-int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
+/* with rw_mutex taken, the waiters bit goes with the last waiter */
+static void _pthread_rwlock_waited(pthread_rwlock_t *rwlock)
 {
-    int result;
+    if (rwlock->rw_nwaitreaders == 0 && rwlock->rw_nwaitwriters == 0)
+        rt_atomic_and(&(rwlock->rw_state), ~RWLOCK_WAITERS);
+}
 
-    if (!rwlock)
-        return EINVAL;
-    if (rwlock->attr == -1)
-        pthread_rwlock_init(rwlock, NULL);
+static int _pthread_rwlock_wait(pthread_rwlock_t *rwlock, pthread_cond_t *cond, const struct timespec *abstime)
+{
+    /* rw_mutex will be released when waiting for the condition */
+    if (abstime)
+        return pthread_cond_timedwait(cond, &rwlock->rw_mutex, abstime);
+
+    return pthread_cond_wait(cond, &rwlock->rw_mutex);
+}
+
+static int _pthread_rwlock_rdlock_slow(pthread_rwlock_t *rwlock, const struct timespec *abstime)
+{
+    int result;
+    rt_atomic_t value;
 
     if ((result = pthread_mutex_lock(&rwlock->rw_mutex)) != 0)
         return(result);
 
-    /* give preference to waiting writers */
-    while (rwlock->rw_refcount < 0 || rwlock->rw_nwaitwriters > 0)
+    value = rt_atomic_load(&(rwlock->rw_state));
+    while (1)
     {
+        /* give preference to waiting writers, unless readers are preferred */
+        if (!(value & RWLOCK_WRITER) &&
+            (rwlock->rw_nwaitwriters == 0 || (rwlock->attr & RWLOCKATTR_PREFER_READER)))
+        {
+            if (rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, value + 1))
+                break;
+            continue;
+        }
+        if (!(value & RWLOCK_WAITERS) &&
+            !rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, value | RWLOCK_WAITERS))
+            continue;
+
         rwlock->rw_nwaitreaders++;
-        /* rw_mutex will be released when waiting for rw_condreaders */
-        result = pthread_cond_wait(&rwlock->rw_condreaders, &rwlock->rw_mutex);
+        result = _pthread_rwlock_wait(rwlock, &rwlock->rw_condreaders, abstime);
         /* rw_mutex should have been taken again when returned from waiting */
         rwlock->rw_nwaitreaders--;
         if (result != 0) /* wait error */
             break;
-    }
 
-    /* another reader has a read lock */
-    if (result == 0)
-        rwlock->rw_refcount++;
+        value = rt_atomic_load(&(rwlock->rw_state));
+    }
+    _pthread_rwlock_waited(rwlock);
 
     pthread_mutex_unlock(&rwlock->rw_mutex);
 
     return (result);
 }
-RTM_EXPORT(pthread_rwlock_rdlock);
 
-int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
+static int _pthread_rwlock_wrlock_slow(pthread_rwlock_t *rwlock, const struct timespec *abstime)
 {
     int result;
-
-    if (!rwlock)
-        return EINVAL;
-    if (rwlock->attr == -1)
-        pthread_rwlock_init(rwlock, NULL);
+    rt_atomic_t value;
 
     if ((result = pthread_mutex_lock(&rwlock->rw_mutex)) != 0)
         return(result);
 
-    if (rwlock->rw_refcount < 0 || rwlock->rw_nwaitwriters > 0)
-        result = EBUSY;                 /* held by a writer or waiting writers */
-    else
-        rwlock->rw_refcount++;          /* increment count of reader locks */
+    value = rt_atomic_load(&(rwlock->rw_state));
+    while (1)
+    {
+        if ((value & (RWLOCK_WRITER | RWLOCK_READERS)) == 0)
+        {
+            if (rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, value | RWLOCK_WRITER))
+                break;
+            continue;
+        }
+        if (!(value & RWLOCK_WAITERS) &&
+            !rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, value | RWLOCK_WAITERS))
+            continue;
+
+        rwlock->rw_nwaitwriters++;
+        result = _pthread_rwlock_wait(rwlock, &rwlock->rw_condwriters, abstime);
+        /* rw_mutex should have been taken again when returned from waiting */
+        rwlock->rw_nwaitwriters--;
+        if (result != 0)
+        {
+            /* the readers held back for this writer may go now */
+            if (rwlock->rw_nwaitwriters == 0 && rwlock->rw_nwaitreaders > 0 &&
+                !(rt_atomic_load(&(rwlock->rw_state)) & RWLOCK_WRITER))
+                pthread_cond_broadcast(&rwlock->rw_condreaders);
+            break;
+        }
+
+        value = rt_atomic_load(&(rwlock->rw_state));
+    }
+    _pthread_rwlock_waited(rwlock);
 
     pthread_mutex_unlock(&rwlock->rw_mutex);
 
     return(result);
 }
-RTM_EXPORT(pthread_rwlock_tryrdlock);
 
-int pthread_rwlock_timedrdlock(pthread_rwlock_t      *rwlock,
-                               const struct timespec *abstime)
+int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
 {
-    int result;
+    rt_atomic_t value;
 
     if (!rwlock)
         return EINVAL;
     if (rwlock->attr == -1)
         pthread_rwlock_init(rwlock, NULL);
 
-    if ( (result = pthread_mutex_lock(&rwlock->rw_mutex)) != 0)
-        return(result);
+    value = rt_atomic_load(&(rwlock->rw_state));
+    if (!(value & (RWLOCK_WRITER | RWLOCK_WAITERS)) &&
+        rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, value + 1))
+        return 0;
 
-    /* give preference to waiting writers */
-    while (rwlock->rw_refcount < 0 || rwlock->rw_nwaitwriters > 0)
-    {
-        rwlock->rw_nwaitreaders++;
-        /* rw_mutex will be released when waiting for rw_condreaders */
-        result = pthread_cond_timedwait(&rwlock->rw_condreaders, &rwlock->rw_mutex, abstime);
-        /* rw_mutex should have been taken again when returned from waiting */
-        rwlock->rw_nwaitreaders--;
-        if (result != 0)
-            break;
-    }
+    return _pthread_rwlock_rdlock_slow(rwlock, RT_NULL);
+}
+RTM_EXPORT(pthread_rwlock_rdlock);
 
-    /* another reader has a read lock */
-    if (result == 0)
-        rwlock->rw_refcount++;
+int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
+{
+    rt_atomic_t value;
 
-    pthread_mutex_unlock(&rwlock->rw_mutex);
+    if (!rwlock)
+        return EINVAL;
+    if (rwlock->attr == -1)
+        pthread_rwlock_init(rwlock, NULL);
 
-    return (result);
+    /* held by a writer or waiting writers, unless readers are preferred */
+    value = rt_atomic_load(&(rwlock->rw_state));
+    while (!(value & RWLOCK_WRITER) &&
+           (!(value & RWLOCK_WAITERS) || (rwlock->attr & RWLOCKATTR_PREFER_READER)))
+    {
+        if (rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, value + 1))
+            return 0;
+    }
+
+    return EBUSY;
 }
-RTM_EXPORT(pthread_rwlock_timedrdlock);
+RTM_EXPORT(pthread_rwlock_tryrdlock);
 
-int pthread_rwlock_timedwrlock(pthread_rwlock_t      *rwlock,
+int pthread_rwlock_timedrdlock(pthread_rwlock_t      *rwlock,
                                const struct timespec *abstime)
 {
-    int result;
+    rt_atomic_t value;
 
     if (!rwlock)
         return EINVAL;
     if (rwlock->attr == -1)
         pthread_rwlock_init(rwlock, NULL);
 
-    if ((result = pthread_mutex_lock(&rwlock->rw_mutex)) != 0)
-        return(result);
+    value = rt_atomic_load(&(rwlock->rw_state));
+    if (!(value & (RWLOCK_WRITER | RWLOCK_WAITERS)) &&
+        rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, value + 1))
+        return 0;
 
-    while (rwlock->rw_refcount != 0)
-    {
-        rwlock->rw_nwaitwriters++;
-        /* rw_mutex will be released when waiting for rw_condwriters */
-        result = pthread_cond_timedwait(&rwlock->rw_condwriters, &rwlock->rw_mutex, abstime);
-        /* rw_mutex should have been taken again when returned from waiting */
-        rwlock->rw_nwaitwriters--;
+    return _pthread_rwlock_rdlock_slow(rwlock, abstime);
+}
+RTM_EXPORT(pthread_rwlock_timedrdlock);
 
-        if (result != 0)
-            break;
-    }
+int pthread_rwlock_timedwrlock(pthread_rwlock_t      *rwlock,
+                               const struct timespec *abstime)
+{
+    rt_atomic_t value = 0;
 
-    if (result == 0)
-        rwlock->rw_refcount = -1;
+    if (!rwlock)
+        return EINVAL;
+    if (rwlock->attr == -1)
+        pthread_rwlock_init(rwlock, NULL);
 
-    pthread_mutex_unlock(&rwlock->rw_mutex);
+    if (rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, RWLOCK_WRITER))
+        return 0;
 
-    return(result);
+    return _pthread_rwlock_wrlock_slow(rwlock, abstime);
 }
 RTM_EXPORT(pthread_rwlock_timedwrlock);
 
 int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock)
 {
-    int result;
+    rt_atomic_t value;
 
     if (!rwlock)
         return EINVAL;
     if (rwlock->attr == -1)
         pthread_rwlock_init(rwlock, NULL);
 
-    if ((result = pthread_mutex_lock(&rwlock->rw_mutex)) != 0)
-        return(result);
-
-    if (rwlock->rw_refcount != 0)
-        result = EBUSY;                 /* held by either writer or reader(s) */
-    else
-        rwlock->rw_refcount = -1;       /* available, indicate a writer has it */
-
-    pthread_mutex_unlock(&rwlock->rw_mutex);
+    /* held by either writer or reader(s) */
+    value = rt_atomic_load(&(rwlock->rw_state));
+    while ((value & (RWLOCK_WRITER | RWLOCK_READERS)) == 0)
+    {
+        if (rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, value | RWLOCK_WRITER))
+            return 0;
+    }
 
-    return(result);
+    return EBUSY;
 }
 RTM_EXPORT(pthread_rwlock_trywrlock);
 
 int pthread_rwlock_unlock(pthread_rwlock_t *rwlock)
 {
-    int result;
+    int result = 0;
+    rt_atomic_t value, next;
 
     if (!rwlock)
         return EINVAL;
     if (rwlock->attr == -1)
         pthread_rwlock_init(rwlock, NULL);
 
-    if ( (result = pthread_mutex_lock(&rwlock->rw_mutex)) != 0)
-        return(result);
-
-    if (rwlock->rw_refcount > 0)
-        rwlock->rw_refcount--;              /* releasing a reader */
-    else if (rwlock->rw_refcount == -1)
-        rwlock->rw_refcount = 0;            /* releasing a writer */
+    value = rt_atomic_load(&(rwlock->rw_state));
+    do
+    {
+        if (value & RWLOCK_WRITER)
+            next = value & ~RWLOCK_WRITER;  /* releasing a writer */
+        else if (value & RWLOCK_READERS)
+            next = value - 1;               /* releasing a reader */
+        else
+            return 0;
+    } while (!rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, next));
 
-    /* give preference to waiting writers over waiting readers */
-    if (rwlock->rw_nwaitwriters > 0)
+    /* the last one out wakes the waiting threads */
+    if ((next & RWLOCK_WAITERS) && !(next & RWLOCK_READERS))
     {
-        if (rwlock->rw_refcount == 0)
+        if ((result = pthread_mutex_lock(&rwlock->rw_mutex)) != 0)
+            return(result);
+
+        /* give preference to waiting writers over waiting readers, unless readers are preferred */
+        if (rwlock->rw_nwaitwriters > 0 &&
+            (rwlock->rw_nwaitreaders == 0 || !(rwlock->attr & RWLOCKATTR_PREFER_READER)))
+        {
             result = pthread_cond_signal(&rwlock->rw_condwriters);
-    }
-    else if (rwlock->rw_nwaitreaders > 0)
-    {
-        result = pthread_cond_broadcast(&rwlock->rw_condreaders);
-    }
+        }
+        else if (rwlock->rw_nwaitreaders > 0)
+        {
+            result = pthread_cond_broadcast(&rwlock->rw_condreaders);
+        }
 
-    pthread_mutex_unlock(&rwlock->rw_mutex);
+        pthread_mutex_unlock(&rwlock->rw_mutex);
+    }
 
     return(result);
 }
@@ -307,34 +411,16 @@ RTM_EXPORT(pthread_rwlock_unlock);
 
 int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock)
 {
-    int result;
+    rt_atomic_t value = 0;
 
     if (!rwlock)
         return EINVAL;
     if (rwlock->attr == -1)
         pthread_rwlock_init(rwlock, NULL);
 
-    if ((result = pthread_mutex_lock(&rwlock->rw_mutex)) != 0)
-        return(result);
-
-    while (rwlock->rw_refcount != 0)
-    {
-        rwlock->rw_nwaitwriters++;
-        /* rw_mutex will be released when waiting for rw_condwriters */
-        result = pthread_cond_wait(&rwlock->rw_condwriters, &rwlock->rw_mutex);
-        /* rw_mutex should have been taken again when returned from waiting */
-        rwlock->rw_nwaitwriters--;
+    if (rt_atomic_compare_exchange_strong(&(rwlock->rw_state), &value, RWLOCK_WRITER))
+        return 0;
 
-        if (result != 0)
-            break;
-    }
-
-    if (result == 0)
-        rwlock->rw_refcount = -1;
-
-    pthread_mutex_unlock(&rwlock->rw_mutex);
-
-    return(result);
+    return _pthread_rwlock_wrlock_slow(rwlock, RT_NULL);
 }
 RTM_EXPORT(pthread_rwlock_wrlock);
-
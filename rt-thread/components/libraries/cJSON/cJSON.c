@@ -287,6 +287,8 @@ typedef struct
     size_t offset;
     size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
     internal_hooks hooks;
+    cJSON_Arena *arena; /* items and strings come from the arena instead of the hooks */
+    cJSON_bool insitu; /* strings are unescaped in place, content is writable */
 } parse_buffer;
 
 /* check if the given size is left to read in a given parse buffer (starting with 1) */
@@ -297,6 +299,89 @@ typedef struct
 /* get a pointer to the buffer at the position */
 #define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
 
+#define CJSON_ARENA_ALIGN sizeof(double)
+
+static void *arena_allocate(cJSON_Arena * const arena, size_t size, size_t align)
+{
+    size_t offset = 0;
+    size_t block_size = 0;
+    void **block = NULL;
+
+    if (arena->current != NULL)
+    {
+        /* align the address, the buffer of the caller may start anywhere */
+        offset = (size_t)((((size_t)(arena->current + arena->used) + (align - 1)) & ~(align - 1)) - (size_t)arena->current);
+    }
+    if ((arena->current == NULL) || (offset + size > arena->size))
+    {
+        if (arena->block_size == 0)
+        {
+            return NULL;
+        }
+
+        /* a new block linked in front of the others, the rest of the current one is lost */
+        block_size = sizeof(double) + ((size > arena->block_size) ? size : arena->block_size);
+        block = (void**)global_hooks.allocate(block_size);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        *block = arena->blocks;
+        arena->blocks = block;
+        arena->current = (unsigned char*)block + sizeof(double);
+        arena->size = block_size - sizeof(double);
+        offset = 0;
+    }
+    arena->used = offset + size;
+
+    return arena->current + offset;
+}
+
+static void *parse_allocate(parse_buffer * const buffer, size_t size, size_t align)
+{
+    if (buffer->arena != NULL)
+    {
+        return arena_allocate(buffer->arena, size, align);
+    }
+
+    return buffer->hooks.allocate(size);
+}
+
+static void parse_deallocate(parse_buffer * const buffer, void *pointer)
+{
+    /* the arena is freed as a whole */
+    if (buffer->arena == NULL)
+    {
+        buffer->hooks.deallocate(pointer);
+    }
+}
+
+static cJSON *parse_new_item(parse_buffer * const buffer)
+{
+    cJSON *node = NULL;
+
+    if (buffer->arena == NULL)
+    {
+        return cJSON_New_Item(&buffer->hooks);
+    }
+
+    node = (cJSON*)arena_allocate(buffer->arena, sizeof(cJSON), CJSON_ARENA_ALIGN);
+    if (node)
+    {
+        memset(node, '\0', sizeof(cJSON));
+    }
+
+    return node;
+}
+
+static void parse_delete(parse_buffer * const buffer, cJSON *item)
+{
+    if (buffer->arena == NULL)
+    {
+        cJSON_Delete(item);
+    }
+}
+
 /* Parse the input text to generate a number, and populate the result into item. */
 static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_buffer)
 {
@@ -801,16 +886,33 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
             goto fail; /* string ended unexpectedly */
         }
 
-        /* This is at most how much we need for the output */
-        allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char*)input_buffer->hooks.allocate(allocation_length + sizeof(""));
-        if (output == NULL)
+        if (input_buffer->insitu)
         {
-            goto fail; /* allocation failure */
+            /* the output is never longer than the input, it ends at the closing quote at last */
+            output = (unsigned char*)input_pointer;
+        }
+        else
+        {
+            /* This is at most how much we need for the output */
+            allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
+            output = (unsigned char*)parse_allocate(input_buffer, allocation_length + sizeof(""), 1);
+            if (output == NULL)
+            {
+                goto fail; /* allocation failure */
+            }
         }
     }
 
     output_pointer = output;
+    if (input_buffer->insitu)
+    {
+        /* the characters in front of the first escape stay where they are */
+        while ((input_pointer < input_end) && (*input_pointer != '\\'))
+        {
+            input_pointer++;
+        }
+        output_pointer = (unsigned char*)input_pointer;
+    }
     /* loop through the string literal */
     while (input_pointer < input_end)
     {
@@ -879,9 +981,9 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     return true;
 
 fail:
-    if (output != NULL)
+    if ((output != NULL) && !input_buffer->insitu)
     {
-        input_buffer->hooks.deallocate(output);
+        parse_deallocate(input_buffer, output);
     }
 
     if (input_pointer != NULL)
@@ -1085,10 +1187,10 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return
     return cJSON_ParseWithLengthOpts(value, buffer_length, return_parse_end, require_null_terminated);
 }
 
-/* Parse an object - create a new root, and populate. */
-CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+/* Parse an object - create a new root, and populate. The allocation mode of buffer is set by the caller. */
+static cJSON *parse_document(parse_buffer * const buffer_mode, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = *buffer_mode;
     cJSON *item = NULL;
 
     /* reset error position */
@@ -1103,9 +1205,8 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer
     buffer.content = (const unsigned char*)value;
     buffer.length = buffer_length; 
     buffer.offset = 0;
-    buffer.hooks = global_hooks;
 
-    item = cJSON_New_Item(&global_hooks);
+    item = parse_new_item(&buffer);
     if (item == NULL) /* memory fail */
     {
         goto fail;
@@ -1136,7 +1237,7 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer
 fail:
     if (item != NULL)
     {
-        cJSON_Delete(item);
+        parse_delete(&buffer, item);
     }
 
     if (value != NULL)
@@ -1165,6 +1266,99 @@ fail:
     return NULL;
 }
 
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 }, NULL, false };
+
+    buffer.hooks = global_hooks;
+
+    return parse_document(&buffer, value, buffer_length, return_parse_end, require_null_terminated);
+}
+
+CJSON_PUBLIC(void) cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size, size_t block_size)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    arena->first = (unsigned char*)buffer;
+    arena->first_size = (buffer != NULL) ? size : 0;
+    arena->block_size = block_size;
+    arena->blocks = NULL;
+    arena->current = arena->first;
+    arena->size = arena->first_size;
+    arena->used = 0;
+}
+
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena)
+{
+    void *next = NULL;
+
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    while (arena->blocks != NULL)
+    {
+        next = *(void**)arena->blocks;
+        global_hooks.deallocate(arena->blocks);
+        arena->blocks = next;
+    }
+    arena->current = arena->first;
+    arena->size = arena->first_size;
+    arena->used = 0;
+}
+
+CJSON_PUBLIC(void *) cJSON_ArenaAlloc(cJSON_Arena *arena, size_t size)
+{
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    return arena_allocate(arena, size, CJSON_ARENA_ALIGN);
+}
+
+static cJSON *parse_arena(cJSON_Arena *arena, const char *value, size_t buffer_length, cJSON_bool insitu)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 }, NULL, false };
+    unsigned char *current = NULL;
+    size_t used = 0;
+    cJSON *item = NULL;
+
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    buffer.hooks = global_hooks;
+    buffer.arena = arena;
+    buffer.insitu = insitu;
+
+    /* a failed parse gives back what it took, unless it needed a new block */
+    current = arena->current;
+    used = arena->used;
+    item = parse_document(&buffer, value, buffer_length, NULL, false);
+    if ((item == NULL) && (arena->current == current))
+    {
+        arena->used = used;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseArena(cJSON_Arena *arena, const char *value, size_t buffer_length)
+{
+    return parse_arena(arena, value, buffer_length, false);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(cJSON_Arena *arena, char *value, size_t buffer_length)
+{
+    return parse_arena(arena, value, buffer_length, true);
+}
+
 /* Default options for cJSON_Parse */
 CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
 {
@@ -1470,7 +1664,7 @@ static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buf
     do
     {
         /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
+        cJSON *new_item = parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1523,7 +1717,7 @@ success:
 fail:
     if (head != NULL)
     {
-        cJSON_Delete(head);
+        parse_delete(input_buffer, head);
     }
 
     return false;
@@ -1628,7 +1822,7 @@ static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_bu
     do
     {
         /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
+        cJSON *new_item = parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1698,7 +1892,7 @@ success:
 fail:
     if (head != NULL)
     {
-        cJSON_Delete(head);
+        parse_delete(input_buffer, head);
     }
 
     return false;
@@ -152,6 +152,29 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLength(const char *value, size_t buffer_len
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
 
+/* Arena for parsing without a heap allocation per item: the items and strings of the trees parsed into it
+ * are taken from the buffer of the caller, then from blocks of block_size bytes allocated with the hooks when
+ * block_size is not 0. The trees are freed together with cJSON_ResetArena, never with cJSON_Delete. */
+typedef struct cJSON_Arena
+{
+    unsigned char *first;
+    size_t first_size;
+    unsigned char *current;
+    size_t size;
+    size_t used;
+    size_t block_size;
+    void *blocks;
+} cJSON_Arena;
+
+CJSON_PUBLIC(void) cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size, size_t block_size);
+/* Free the blocks of the arena and everything parsed into it, the arena can be used again. */
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena);
+CJSON_PUBLIC(void *) cJSON_ArenaAlloc(cJSON_Arena *arena, size_t size);
+/* Parse into an arena, the strings are copied into it. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseArena(cJSON_Arena *arena, const char *value, size_t buffer_length);
+/* Parse into an arena, the strings are unescaped in place and point into value, which must outlive the tree. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(cJSON_Arena *arena, char *value, size_t buffer_length);
+
 /* Render a cJSON entity to text for transfer/storage. */
 CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item);
 /* Render a cJSON entity to text for transfer/storage without any formatting. */
@@ -0,0 +1,896 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "cJSON_Stream.h"
+
+#define true ((cJSON_bool)1)
+#define false ((cJSON_bool)0)
+
+/* what the next structural character may be */
+enum
+{
+    STATE_VALUE,
+    STATE_VALUE_OR_END,
+    STATE_KEY_OR_END,
+    STATE_KEY,
+    STATE_COLON,
+    STATE_NEXT,
+    STATE_DONE
+};
+
+/* the token being read across chunks */
+enum
+{
+    LEX_NONE,
+    LEX_STRING,
+    LEX_KEY,
+    LEX_NUMBER,
+    LEX_LITERAL
+};
+
+enum
+{
+    ESCAPE_NONE,
+    ESCAPE_START,
+    ESCAPE_HEX
+};
+
+/* inside a skipped or captured container nothing is reported and the path is not kept */
+#define stream_skipping(stream) ((stream)->skip_depth >= 0)
+#define stream_capturing(stream) ((stream)->capture_depth >= 0)
+#define stream_quiet(stream) (stream_skipping(stream) || stream_capturing(stream))
+
+CJSON_PUBLIC(void) cJSON_StreamInit(cJSON_Stream *stream, cJSON_StreamCallback callback, void *user_data)
+{
+    if (stream == NULL)
+    {
+        return;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->callback = callback;
+    stream->user_data = user_data;
+    stream->state = STATE_VALUE;
+    stream->lex = LEX_NONE;
+    stream->skip_depth = -1;
+    stream->capture_depth = -1;
+}
+
+static int stream_emit(cJSON_Stream *stream, cJSON_StreamEvent event, const char *value, size_t length)
+{
+    int result = CJSON_STREAM_CONTINUE;
+
+    if (stream->callback != NULL)
+    {
+        result = stream->callback(stream, event, value, length);
+    }
+
+    return result < 0 ? CJSON_STREAM_ABORTED : result;
+}
+
+static int stream_set_path(cJSON_Stream *stream, const char *segment, size_t length, cJSON_bool escape)
+{
+    size_t end = stream->path_end[stream->depth];
+    char *path = stream->path + end;
+    char *limit = stream->path + CJSON_STREAM_PATH_MAX - 1;
+    size_t i = 0;
+
+    if (path >= limit)
+    {
+        return CJSON_STREAM_ERROR_PATH;
+    }
+    *path++ = '/';
+    for (i = 0; i < length; i++)
+    {
+        if (path >= limit)
+        {
+            return CJSON_STREAM_ERROR_PATH;
+        }
+        /* RFC6901 escapes */
+        if (escape && (segment[i] == '~' || segment[i] == '/'))
+        {
+            *path++ = '~';
+            if (path >= limit)
+            {
+                return CJSON_STREAM_ERROR_PATH;
+            }
+            *path++ = segment[i] == '~' ? '0' : '1';
+        }
+        else
+        {
+            *path++ = segment[i];
+        }
+    }
+    *path = '\0';
+    stream->path_length = (size_t)(path - stream->path);
+
+    return CJSON_STREAM_OK;
+}
+
+static int stream_set_index(cJSON_Stream *stream)
+{
+    char digits[12];
+    unsigned int index = stream->index[stream->depth - 1];
+    size_t length = sizeof(digits);
+
+    do
+    {
+        digits[--length] = (char)('0' + index % 10);
+        index /= 10;
+    } while (index != 0);
+
+    return stream_set_path(stream, digits + length, sizeof(digits) - length, false);
+}
+
+/* link a new item into the captured container it is read in */
+static void stream_capture_add(cJSON_Stream *stream, cJSON *item)
+{
+    cJSON *parent = stream->capture[stream->depth - stream->capture_depth];
+
+    if (cJSON_IsObject(parent))
+    {
+        item->string = stream->capture_key;
+        stream->capture_key = NULL;
+    }
+    cJSON_AddItemToArray(parent, item);
+}
+
+static int stream_value_done(cJSON_Stream *stream)
+{
+    stream->state = stream->depth > 0 ? STATE_NEXT : STATE_DONE;
+
+    return CJSON_STREAM_OK;
+}
+
+static int stream_open(cJSON_Stream *stream, cJSON_bool object)
+{
+    cJSON *item = NULL;
+    int result = CJSON_STREAM_CONTINUE;
+
+    if (stream->depth >= CJSON_STREAM_DEPTH)
+    {
+        return CJSON_STREAM_ERROR_DEPTH;
+    }
+
+    if (!stream_quiet(stream))
+    {
+        result = stream_emit(stream, object ? cJSON_StreamObjectStart : cJSON_StreamArrayStart, NULL, 0);
+        if (result == CJSON_STREAM_ABORTED)
+        {
+            return result;
+        }
+        if (result == CJSON_STREAM_SKIP)
+        {
+            stream->skip_depth = stream->depth + 1;
+        }
+    }
+    if (result == CJSON_STREAM_CAPTURE || (stream_capturing(stream) && !stream_skipping(stream)))
+    {
+        item = object ? cJSON_CreateObject() : cJSON_CreateArray();
+        if (item == NULL)
+        {
+            return CJSON_STREAM_ERROR_MEMORY;
+        }
+        if (stream_capturing(stream))
+        {
+            stream_capture_add(stream, item);
+        }
+        else
+        {
+            stream->capture_depth = stream->depth + 1;
+        }
+    }
+
+    stream->object[stream->depth] = (unsigned char)object;
+    stream->index[stream->depth] = 0;
+    stream->depth++;
+    stream->path_end[stream->depth] = (unsigned short)stream->path_length;
+    if (item != NULL)
+    {
+        stream->capture[stream->depth - stream->capture_depth] = item;
+    }
+    stream->state = object ? STATE_KEY_OR_END : STATE_VALUE_OR_END;
+
+    return CJSON_STREAM_OK;
+}
+
+static int stream_close(cJSON_Stream *stream)
+{
+    cJSON_bool object = stream->object[stream->depth - 1];
+    int result = CJSON_STREAM_OK;
+
+    stream->depth--;
+    stream->path_length = stream->path_end[stream->depth + 1];
+    stream->path[stream->path_length] = '\0';
+
+    if (stream_skipping(stream))
+    {
+        if (stream->depth < stream->skip_depth)
+        {
+            stream->skip_depth = -1;
+        }
+    }
+    else if (stream_capturing(stream))
+    {
+        if (stream->depth < stream->capture_depth)
+        {
+            stream->item = stream->capture[0];
+            stream->capture[0] = NULL;
+            stream->capture_depth = -1;
+            result = stream_emit(stream, cJSON_StreamItem, NULL, 0);
+            stream->item = NULL;
+        }
+    }
+    else
+    {
+        result = stream_emit(stream, object ? cJSON_StreamObjectEnd : cJSON_StreamArrayEnd, NULL, 0);
+    }
+    if (result == CJSON_STREAM_ABORTED)
+    {
+        return result;
+    }
+
+    return stream_value_done(stream);
+}
+
+static int stream_scalar(cJSON_Stream *stream, cJSON_StreamEvent event, const char *value, size_t length)
+{
+    cJSON *item = NULL;
+
+    if (stream_skipping(stream))
+    {
+        return stream_value_done(stream);
+    }
+
+    if (!stream_capturing(stream))
+    {
+        if (stream_emit(stream, event, value, length) == CJSON_STREAM_ABORTED)
+        {
+            return CJSON_STREAM_ABORTED;
+        }
+        return stream_value_done(stream);
+    }
+
+    switch (event)
+    {
+        case cJSON_StreamString:
+            item = cJSON_CreateString(value);
+            break;
+        case cJSON_StreamNumber:
+            item = cJSON_CreateNumber(stream->number);
+            break;
+        case cJSON_StreamTrue:
+            item = cJSON_CreateTrue();
+            break;
+        case cJSON_StreamFalse:
+            item = cJSON_CreateFalse();
+            break;
+        default:
+            item = cJSON_CreateNull();
+            break;
+    }
+    if (item == NULL)
+    {
+        return CJSON_STREAM_ERROR_MEMORY;
+    }
+    stream_capture_add(stream, item);
+
+    return stream_value_done(stream);
+}
+
+/* a captured string longer than the token is collected on the heap */
+static int stream_capture_append(cJSON_Stream *stream)
+{
+    cJSON *item = stream->capture_string;
+    size_t length = 0;
+    char *value = NULL;
+
+    if (item == NULL)
+    {
+        item = cJSON_CreateString(stream->token);
+        if (item == NULL)
+        {
+            return CJSON_STREAM_ERROR_MEMORY;
+        }
+        stream->capture_string = item;
+        return CJSON_STREAM_OK;
+    }
+
+    length = strlen(item->valuestring);
+    value = (char*)cJSON_malloc(length + stream->token_length + 1);
+    if (value == NULL)
+    {
+        return CJSON_STREAM_ERROR_MEMORY;
+    }
+    memcpy(value, item->valuestring, length);
+    memcpy(value + length, stream->token, stream->token_length + 1);
+    cJSON_free(item->valuestring);
+    item->valuestring = value;
+
+    return CJSON_STREAM_OK;
+}
+
+/* the token is full: report the piece of a string, keys must fit */
+static int stream_string_flush(cJSON_Stream *stream)
+{
+    int result = CJSON_STREAM_OK;
+
+    if (stream->lex == LEX_KEY)
+    {
+        return CJSON_STREAM_ERROR_TOKEN;
+    }
+
+    stream->token[stream->token_length] = '\0';
+    if (stream_capturing(stream))
+    {
+        result = stream_capture_append(stream);
+    }
+    else
+    {
+        stream->more = true;
+        result = stream_emit(stream, cJSON_StreamString, stream->token, stream->token_length);
+        stream->more = false;
+    }
+    stream->token_length = 0;
+
+    return result < 0 ? result : CJSON_STREAM_OK;
+}
+
+static int stream_string_end(cJSON_Stream *stream)
+{
+    cJSON_bool key = stream->lex == LEX_KEY;
+    int result = CJSON_STREAM_OK;
+    cJSON *item = NULL;
+
+    stream->lex = LEX_NONE;
+    stream->token[stream->token_length] = '\0';
+
+    if (stream_skipping(stream))
+    {
+        return key ? CJSON_STREAM_OK : stream_value_done(stream);
+    }
+
+    /* the state of a key is already STATE_COLON */
+    if (key)
+    {
+        if (stream_capturing(stream))
+        {
+            stream->capture_key = (char*)cJSON_malloc(stream->token_length + 1);
+            if (stream->capture_key == NULL)
+            {
+                return CJSON_STREAM_ERROR_MEMORY;
+            }
+            memcpy(stream->capture_key, stream->token, stream->token_length + 1);
+            return CJSON_STREAM_OK;
+        }
+        return stream_set_path(stream, stream->token, stream->token_length, true);
+    }
+
+    if (stream->capture_string != NULL)
+    {
+        result = stream_capture_append(stream);
+        if (result != CJSON_STREAM_OK)
+        {
+            return result;
+        }
+        item = stream->capture_string;
+        stream->capture_string = NULL;
+        stream_capture_add(stream, item);
+        return stream_value_done(stream);
+    }
+
+    return stream_scalar(stream, cJSON_StreamString, stream->token, stream->token_length);
+}
+
+static int stream_codepoint(cJSON_Stream *stream)
+{
+    unsigned int codepoint = stream->unicode;
+    unsigned char *out = (unsigned char*)stream->token + stream->token_length;
+
+    if (stream->surrogate != 0)
+    {
+        if (codepoint < 0xDC00 || codepoint > 0xDFFF)
+        {
+            return CJSON_STREAM_ERROR_SYNTAX;
+        }
+        codepoint = 0x10000 + (((stream->surrogate & 0x3FF) << 10) | (codepoint & 0x3FF));
+        stream->surrogate = 0;
+    }
+    else if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+    {
+        /* wait for the low surrogate */
+        stream->surrogate = codepoint;
+        return CJSON_STREAM_OK;
+    }
+    else if ((codepoint >= 0xDC00 && codepoint <= 0xDFFF) || codepoint == 0)
+    {
+        return CJSON_STREAM_ERROR_SYNTAX;
+    }
+
+    if (codepoint < 0x80)
+    {
+        out[0] = (unsigned char)codepoint;
+        stream->token_length += 1;
+    }
+    else if (codepoint < 0x800)
+    {
+        out[0] = (unsigned char)(0xC0 | (codepoint >> 6));
+        out[1] = (unsigned char)(0x80 | (codepoint & 0x3F));
+        stream->token_length += 2;
+    }
+    else if (codepoint < 0x10000)
+    {
+        out[0] = (unsigned char)(0xE0 | (codepoint >> 12));
+        out[1] = (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = (unsigned char)(0x80 | (codepoint & 0x3F));
+        stream->token_length += 3;
+    }
+    else
+    {
+        out[0] = (unsigned char)(0xF0 | (codepoint >> 18));
+        out[1] = (unsigned char)(0x80 | ((codepoint >> 12) & 0x3F));
+        out[2] = (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out[3] = (unsigned char)(0x80 | (codepoint & 0x3F));
+        stream->token_length += 4;
+    }
+
+    return CJSON_STREAM_OK;
+}
+
+static int stream_escape(cJSON_Stream *stream, unsigned char c)
+{
+    char out = 0;
+
+    if (stream->escape == ESCAPE_HEX)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            stream->unicode = (stream->unicode << 4) | (unsigned int)(c - '0');
+        }
+        else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+        {
+            stream->unicode = (stream->unicode << 4) | (unsigned int)((c | 0x20) - 'a' + 10);
+        }
+        else
+        {
+            return CJSON_STREAM_ERROR_SYNTAX;
+        }
+        if (++stream->hex_digits < 4)
+        {
+            return CJSON_STREAM_OK;
+        }
+        stream->escape = ESCAPE_NONE;
+        return stream_codepoint(stream);
+    }
+
+    if (stream->surrogate != 0 && c != 'u')
+    {
+        return CJSON_STREAM_ERROR_SYNTAX;
+    }
+    switch (c)
+    {
+        case '"':
+        case '\\':
+        case '/':
+            out = (char)c;
+            break;
+        case 'b':
+            out = '\b';
+            break;
+        case 'f':
+            out = '\f';
+            break;
+        case 'n':
+            out = '\n';
+            break;
+        case 'r':
+            out = '\r';
+            break;
+        case 't':
+            out = '\t';
+            break;
+        case 'u':
+            stream->escape = ESCAPE_HEX;
+            stream->unicode = 0;
+            stream->hex_digits = 0;
+            return CJSON_STREAM_OK;
+        default:
+            return CJSON_STREAM_ERROR_SYNTAX;
+    }
+    stream->token[stream->token_length++] = out;
+    stream->escape = ESCAPE_NONE;
+
+    return CJSON_STREAM_OK;
+}
+
+/* read string characters up to the end of the chunk or the closing quote */
+static int stream_string(cJSON_Stream *stream, const unsigned char **input, const unsigned char *end)
+{
+    const unsigned char *p = *input;
+    const unsigned char *start = NULL;
+    const unsigned char *limit = NULL;
+    cJSON_bool skipping = stream_skipping(stream);
+    int result = CJSON_STREAM_OK;
+
+    while (p < end)
+    {
+        if (stream->escape != ESCAPE_NONE)
+        {
+            if (skipping)
+            {
+                /* the escaped characters never contain a quote */
+                stream->escape = ESCAPE_NONE;
+                p++;
+                continue;
+            }
+            result = stream_escape(stream, *p);
+            if (result != CJSON_STREAM_OK)
+            {
+                break;
+            }
+            p++;
+            if (stream->token_length >= CJSON_STREAM_TOKEN_MAX &&
+                (stream->lex != LEX_KEY || stream->token_length > CJSON_STREAM_TOKEN_MAX))
+            {
+                result = stream_string_flush(stream);
+                if (result != CJSON_STREAM_OK)
+                {
+                    break;
+                }
+            }
+            continue;
+        }
+
+        if (stream->surrogate != 0 && *p != '\\')
+        {
+            result = CJSON_STREAM_ERROR_SYNTAX;
+            break;
+        }
+        if (skipping)
+        {
+            while (p < end && *p != '"' && *p != '\\')
+            {
+                p++;
+            }
+        }
+        else
+        {
+            start = p;
+            limit = end;
+            if ((size_t)(end - p) > CJSON_STREAM_TOKEN_MAX - stream->token_length)
+            {
+                limit = p + (CJSON_STREAM_TOKEN_MAX - stream->token_length);
+            }
+            while (p < limit && *p != '"' && *p != '\\')
+            {
+                p++;
+            }
+            memcpy(stream->token + stream->token_length, start, (size_t)(p - start));
+            stream->token_length += (size_t)(p - start);
+            if (p < end && *p != '"' && *p != '\\')
+            {
+                result = stream_string_flush(stream);
+                if (result != CJSON_STREAM_OK)
+                {
+                    break;
+                }
+                continue;
+            }
+        }
+        if (p == end)
+        {
+            break;
+        }
+        if (*p++ == '"')
+        {
+            result = stream_string_end(stream);
+            break;
+        }
+        stream->escape = ESCAPE_START;
+    }
+
+    *input = p;
+    return result;
+}
+
+static int stream_number(cJSON_Stream *stream)
+{
+    char *end = NULL;
+
+    stream->lex = LEX_NONE;
+    if (stream_skipping(stream))
+    {
+        return stream_value_done(stream);
+    }
+
+    stream->token[stream->token_length] = '\0';
+    if (stream->token[0] != '-' && (stream->token[0] < '0' || stream->token[0] > '9'))
+    {
+        return CJSON_STREAM_ERROR_SYNTAX;
+    }
+    stream->number = strtod(stream->token, &end);
+    if (end != stream->token + stream->token_length)
+    {
+        return CJSON_STREAM_ERROR_SYNTAX;
+    }
+
+    return stream_scalar(stream, cJSON_StreamNumber, stream->token, stream->token_length);
+}
+
+static int stream_value(cJSON_Stream *stream, unsigned char c)
+{
+    int result = CJSON_STREAM_OK;
+
+    if (stream->depth > 0 && !stream->object[stream->depth - 1] && !stream_quiet(stream))
+    {
+        result = stream_set_index(stream);
+        if (result != CJSON_STREAM_OK)
+        {
+            return result;
+        }
+    }
+
+    switch (c)
+    {
+        case '{':
+            return stream_open(stream, true);
+        case '[':
+            return stream_open(stream, false);
+        case '"':
+            stream->lex = LEX_STRING;
+            stream->token_length = 0;
+            return CJSON_STREAM_OK;
+        case 't':
+            stream->literal = "rue";
+            stream->literal_event = cJSON_StreamTrue;
+            break;
+        case 'f':
+            stream->literal = "alse";
+            stream->literal_event = cJSON_StreamFalse;
+            break;
+        case 'n':
+            stream->literal = "ull";
+            stream->literal_event = cJSON_StreamNull;
+            break;
+        default:
+            if (c != '-' && (c < '0' || c > '9'))
+            {
+                return CJSON_STREAM_ERROR_SYNTAX;
+            }
+            stream->lex = LEX_NUMBER;
+            stream->token[0] = (char)c;
+            stream->token_length = 1;
+            return CJSON_STREAM_OK;
+    }
+    stream->lex = LEX_LITERAL;
+
+    return CJSON_STREAM_OK;
+}
+
+static int stream_structure(cJSON_Stream *stream, unsigned char c)
+{
+    cJSON_bool object = false;
+
+    switch (stream->state)
+    {
+        case STATE_VALUE_OR_END:
+            if (c == ']')
+            {
+                return stream_close(stream);
+            }
+            return stream_value(stream, c);
+
+        case STATE_VALUE:
+            return stream_value(stream, c);
+
+        case STATE_KEY_OR_END:
+            if (c == '}')
+            {
+                return stream_close(stream);
+            }
+            /* fall through */
+        case STATE_KEY:
+            if (c != '"')
+            {
+                return CJSON_STREAM_ERROR_SYNTAX;
+            }
+            stream->lex = LEX_KEY;
+            stream->token_length = 0;
+            stream->state = STATE_COLON;
+            return CJSON_STREAM_OK;
+
+        case STATE_COLON:
+            if (c != ':')
+            {
+                return CJSON_STREAM_ERROR_SYNTAX;
+            }
+            stream->state = STATE_VALUE;
+            return CJSON_STREAM_OK;
+
+        case STATE_NEXT:
+            object = stream->object[stream->depth - 1];
+            if (c == ',')
+            {
+                if (object)
+                {
+                    stream->state = STATE_KEY;
+                }
+                else
+                {
+                    stream->index[stream->depth - 1]++;
+                    stream->state = STATE_VALUE;
+                }
+                return CJSON_STREAM_OK;
+            }
+            if (c == (object ? '}' : ']'))
+            {
+                return stream_close(stream);
+            }
+            return CJSON_STREAM_ERROR_SYNTAX;
+
+        default:
+            return CJSON_STREAM_ERROR_SYNTAX;
+    }
+}
+
+CJSON_PUBLIC(int) cJSON_StreamFeed(cJSON_Stream *stream, const char *data, size_t length)
+{
+    const unsigned char *p = (const unsigned char*)data;
+    const unsigned char *end = p + length;
+    int result = CJSON_STREAM_OK;
+    unsigned char c = 0;
+
+    if (stream == NULL || (data == NULL && length != 0))
+    {
+        return CJSON_STREAM_ERROR_SYNTAX;
+    }
+    if (stream->error != CJSON_STREAM_OK)
+    {
+        return stream->error;
+    }
+
+    while (p < end && result == CJSON_STREAM_OK)
+    {
+        switch (stream->lex)
+        {
+            case LEX_STRING:
+            case LEX_KEY:
+                result = stream_string(stream, &p, end);
+                break;
+
+            case LEX_NUMBER:
+                c = *p;
+                if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')
+                {
+                    if (!stream_skipping(stream))
+                    {
+                        if (stream->token_length >= CJSON_STREAM_TOKEN_MAX)
+                        {
+                            result = CJSON_STREAM_ERROR_TOKEN;
+                            break;
+                        }
+                        stream->token[stream->token_length++] = (char)c;
+                    }
+                    p++;
+                    break;
+                }
+                /* the character after the number is read again */
+                result = stream_number(stream);
+                break;
+
+            case LEX_LITERAL:
+                if (*p != (unsigned char)*stream->literal)
+                {
+                    result = CJSON_STREAM_ERROR_SYNTAX;
+                    break;
+                }
+                p++;
+                if (*++stream->literal == '\0')
+                {
+                    stream->lex = LEX_NONE;
+                    result = stream_scalar(stream, (cJSON_StreamEvent)stream->literal_event, NULL, 0);
+                }
+                break;
+
+            default:
+                c = *p;
+                if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+                {
+                    p++;
+                    break;
+                }
+                result = stream_structure(stream, c);
+                if (result == CJSON_STREAM_OK || result == CJSON_STREAM_ABORTED)
+                {
+                    p++;
+                }
+                break;
+        }
+    }
+
+    stream->position += (size_t)(p - (const unsigned char*)data);
+    stream->error = result;
+
+    return result;
+}
+
+CJSON_PUBLIC(int) cJSON_StreamFinish(cJSON_Stream *stream)
+{
+    if (stream == NULL)
+    {
+        return CJSON_STREAM_ERROR_SYNTAX;
+    }
+
+    /* a number at the top level ends with the document */
+    if (stream->error == CJSON_STREAM_OK && stream->lex == LEX_NUMBER)
+    {
+        stream->error = stream_number(stream);
+    }
+    if (stream->error == CJSON_STREAM_OK && (stream->state != STATE_DONE || stream->lex != LEX_NONE))
+    {
+        stream->error = CJSON_STREAM_ERROR_SYNTAX;
+    }
+
+    if (stream_capturing(stream))
+    {
+        cJSON_Delete(stream->capture[0]);
+        stream->capture[0] = NULL;
+        stream->capture_depth = -1;
+    }
+    if (stream->capture_string != NULL)
+    {
+        cJSON_Delete(stream->capture_string);
+        stream->capture_string = NULL;
+    }
+    if (stream->capture_key != NULL)
+    {
+        cJSON_free(stream->capture_key);
+        stream->capture_key = NULL;
+    }
+
+    return stream->error;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamPathMatch(const char *path, const char *pattern)
+{
+    if (path == NULL || pattern == NULL)
+    {
+        return false;
+    }
+
+    while (*pattern == '/' && *path == '/')
+    {
+        pattern++;
+        path++;
+        if (pattern[0] == '*' && (pattern[1] == '/' || pattern[1] == '\0'))
+        {
+            pattern++;
+            while (*path != '\0' && *path != '/')
+            {
+                path++;
+            }
+            continue;
+        }
+        while (*pattern != '\0' && *pattern != '/' && *pattern == *path)
+        {
+            pattern++;
+            path++;
+        }
+        if ((*pattern != '\0' && *pattern != '/') || (*path != '\0' && *path != '/'))
+        {
+            return false;
+        }
+    }
+
+    return *pattern == '\0' && *path == '\0';
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#ifndef cJSON_Stream__h
+#define cJSON_Stream__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "cJSON.h"
+
+/*
+ * Streaming JSON reader: the document is fed in chunks of any size and reported token by
+ * token to a callback, with the RFC6901 JSON Pointer of the value, e.g. "/records/3/temp".
+ * The memory used is the cJSON_Stream itself, nothing is allocated unless a subtree is
+ * captured as a cJSON item.
+ *
+ * Strings longer than CJSON_STREAM_TOKEN_MAX bytes are reported in pieces, stream->more is
+ * set for all but the last one. Keys and numbers must fit the token, the pointer of a value
+ * must fit CJSON_STREAM_PATH_MAX bytes, containers can nest CJSON_STREAM_DEPTH deep.
+ */
+
+#ifndef CJSON_STREAM_DEPTH
+#define CJSON_STREAM_DEPTH 16
+#endif
+#ifndef CJSON_STREAM_PATH_MAX
+#define CJSON_STREAM_PATH_MAX 128
+#endif
+#ifndef CJSON_STREAM_TOKEN_MAX
+#define CJSON_STREAM_TOKEN_MAX 64
+#endif
+
+/* results of cJSON_StreamFeed and cJSON_StreamFinish */
+#define CJSON_STREAM_OK 0
+#define CJSON_STREAM_ERROR_SYNTAX (-1)
+#define CJSON_STREAM_ERROR_DEPTH (-2)
+#define CJSON_STREAM_ERROR_TOKEN (-3)
+#define CJSON_STREAM_ERROR_PATH (-4)
+#define CJSON_STREAM_ERROR_MEMORY (-5)
+#define CJSON_STREAM_ABORTED (-6)
+
+/* what the callback returns: to go on, or for the start of an object or array, to skip it
+ * without further callbacks or to build it as a cJSON item reported by cJSON_StreamItem.
+ * A negative value stops the stream with CJSON_STREAM_ABORTED. */
+#define CJSON_STREAM_CONTINUE 0
+#define CJSON_STREAM_SKIP 1
+#define CJSON_STREAM_CAPTURE 2
+
+typedef enum cJSON_StreamEvent
+{
+    cJSON_StreamObjectStart,
+    cJSON_StreamObjectEnd,
+    cJSON_StreamArrayStart,
+    cJSON_StreamArrayEnd,
+    cJSON_StreamString,
+    cJSON_StreamNumber,
+    cJSON_StreamTrue,
+    cJSON_StreamFalse,
+    cJSON_StreamNull,
+    /* a captured object or array, stream->item belongs to the callback */
+    cJSON_StreamItem
+} cJSON_StreamEvent;
+
+struct cJSON_Stream;
+/* value and length are the text of strings and numbers, zero terminated */
+typedef int (*cJSON_StreamCallback)(struct cJSON_Stream *stream, cJSON_StreamEvent event, const char *value, size_t length);
+
+typedef struct cJSON_Stream
+{
+    cJSON_StreamCallback callback;
+    void *user_data;
+
+    /* the pointer of the current value and the depth of its container */
+    char path[CJSON_STREAM_PATH_MAX];
+    int depth;
+    /* the value of cJSON_StreamNumber, a string piece is followed by more */
+    double number;
+    cJSON_bool more;
+    cJSON *item;
+    /* bytes consumed, the offset of the error when feeding failed */
+    size_t position;
+
+    /* internal state */
+    int state;
+    int lex;
+    int escape;
+    int error;
+    size_t path_length;
+    unsigned int index[CJSON_STREAM_DEPTH];
+    unsigned short path_end[CJSON_STREAM_DEPTH + 1];
+    unsigned char object[CJSON_STREAM_DEPTH];
+    int skip_depth;
+    int capture_depth;
+    cJSON *capture[CJSON_STREAM_DEPTH];
+    char *capture_key;
+    cJSON *capture_string;
+    const char *literal;
+    int literal_event;
+    unsigned int unicode;
+    unsigned int surrogate;
+    int hex_digits;
+    size_t token_length;
+    char token[CJSON_STREAM_TOKEN_MAX + 4];
+} cJSON_Stream;
+
+CJSON_PUBLIC(void) cJSON_StreamInit(cJSON_Stream *stream, cJSON_StreamCallback callback, void *user_data);
+/* Feed the next chunk of the document, returns CJSON_STREAM_OK or the error the stream stopped with. */
+CJSON_PUBLIC(int) cJSON_StreamFeed(cJSON_Stream *stream, const char *data, size_t length);
+/* End of the document, fails if it is not complete. Frees what a stopped capture left behind. */
+CJSON_PUBLIC(int) cJSON_StreamFinish(cJSON_Stream *stream);
+/* Match a JSON Pointer against a pattern where the segment "*" matches any key or index. */
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamPathMatch(const char *path, const char *pattern);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Streaming JSON reader benchmark.
+ *
+ * Telemetry documents from 1 KB up to the given size are generated chunk by chunk. The
+ * stream reader is fed the chunks as they come, sums the temperature of the records and
+ * captures the manifest object; cJSON_Parse gets the whole document in one buffer and the
+ * same values are taken from the tree. The throughput and the peak memory are reported:
+ * for the stream the cJSON_Stream, the chunk and the heap of the capture, for cJSON_Parse
+ * the document and the heap of the tree. Documents that do not fit the heap are only
+ * streamed.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cJSON_Stream.h"
+
+#if defined(CJSON_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_HEADER            sizeof(double)
+#define BENCH_RECORD_MAX        160
+
+struct bench_gen
+{
+    rt_size_t size;
+    rt_size_t produced;
+    int record;
+    rt_bool_t last;
+    char text[BENCH_RECORD_MAX];
+    rt_size_t length;
+    rt_size_t offset;
+};
+
+struct bench_result
+{
+    double temp;
+    int records;
+    int version;
+};
+
+static rt_size_t heap_used, heap_peak;
+
+static void *bench_malloc(size_t size)
+{
+    rt_uint8_t *ptr = rt_malloc(size + BENCH_HEADER);
+
+    if (ptr == RT_NULL)
+        return RT_NULL;
+    *(rt_size_t *)ptr = size;
+    heap_used += size;
+    if (heap_used > heap_peak)
+        heap_peak = heap_used;
+
+    return ptr + BENCH_HEADER;
+}
+
+static void bench_free(void *ptr)
+{
+    rt_uint8_t *block = (rt_uint8_t *)ptr - BENCH_HEADER;
+
+    if (ptr == RT_NULL)
+        return;
+    heap_used -= *(rt_size_t *)block;
+    rt_free(block);
+}
+
+/* the next piece of the document: a manifest, then records until the size is reached */
+static void bench_gen_next(struct bench_gen *gen)
+{
+    gen->offset = 0;
+    if (gen->record < 0)
+    {
+        gen->length = rt_snprintf(gen->text, sizeof(gen->text),
+                                  "{\"manifest\":{\"version\":7,\"image\":\"app.rbl\",\"size\":%d},\"records\":[", gen->size);
+    }
+    else if (gen->produced + BENCH_RECORD_MAX < gen->size)
+    {
+        gen->length = rt_snprintf(gen->text, sizeof(gen->text),
+                                  "%s{\"id\":%d,\"time\":%d,\"temp\":%d.%d,\"node\":\"room \\\"%d\\\"\",\"ok\":%s,\"tags\":[\"a\",\"b\"]}",
+                                  gen->record ? "," : "", gen->record, 1700000000 + gen->record * 10, 18 + gen->record % 8,
+                                  gen->record % 10, gen->record % 64, gen->record % 5 ? "true" : "false");
+    }
+    else
+    {
+        gen->length = rt_snprintf(gen->text, sizeof(gen->text), "]}");
+        gen->last = RT_TRUE;
+    }
+    gen->record++;
+}
+
+static rt_size_t bench_gen_read(struct bench_gen *gen, char *buf, rt_size_t size)
+{
+    rt_size_t total = 0, n;
+
+    while (total < size)
+    {
+        if (gen->offset == gen->length)
+        {
+            if (gen->last)
+                break;
+            bench_gen_next(gen);
+        }
+        n = gen->length - gen->offset;
+        if (n > size - total)
+            n = size - total;
+        rt_memcpy(buf + total, gen->text + gen->offset, n);
+        gen->offset += n;
+        gen->produced += n;
+        total += n;
+    }
+
+    return total;
+}
+
+static void bench_gen_init(struct bench_gen *gen, rt_size_t size)
+{
+    rt_memset(gen, 0, sizeof(*gen));
+    gen->size = size;
+    gen->record = -1;
+}
+
+static int bench_callback(cJSON_Stream *stream, cJSON_StreamEvent event, const char *value, size_t length)
+{
+    struct bench_result *result = (struct bench_result *)stream->user_data;
+    cJSON *version;
+
+    switch (event)
+    {
+    case cJSON_StreamObjectStart:
+        if (stream->depth == 1 && cJSON_StreamPathMatch(stream->path, "/manifest"))
+            return CJSON_STREAM_CAPTURE;
+        if (stream->depth == 2)
+            result->records++;
+        break;
+    case cJSON_StreamItem:
+        version = cJSON_GetObjectItem(stream->item, "version");
+        result->version = cJSON_IsNumber(version) ? version->valueint : -1;
+        cJSON_Delete(stream->item);
+        break;
+    case cJSON_StreamNumber:
+        if (stream->depth == 3 && cJSON_StreamPathMatch(stream->path, "/records/*/temp"))
+            result->temp += stream->number;
+        break;
+    default:
+        break;
+    }
+
+    return CJSON_STREAM_CONTINUE;
+}
+
+static int bench_stream(rt_size_t size, char *chunk, rt_size_t chunk_size, rt_uint32_t *clocks, struct bench_result *result)
+{
+    cJSON_Stream stream;
+    struct bench_gen gen;
+    rt_size_t n;
+    rt_uint32_t t;
+    int err = CJSON_STREAM_OK, end;
+
+    bench_gen_init(&gen, size);
+    rt_memset(result, 0, sizeof(*result));
+    cJSON_StreamInit(&stream, bench_callback, result);
+    *clocks = 0;
+    while (err == CJSON_STREAM_OK && (n = bench_gen_read(&gen, chunk, chunk_size)) > 0)
+    {
+        t = BENCH_CLOCK();
+        err = cJSON_StreamFeed(&stream, chunk, n);
+        *clocks += BENCH_CLOCK() - t;
+    }
+    t = BENCH_CLOCK();
+    end = cJSON_StreamFinish(&stream);
+    *clocks += BENCH_CLOCK() - t;
+
+    return err != CJSON_STREAM_OK ? err : end;
+}
+
+static int bench_tree(rt_size_t size, rt_uint32_t *clocks, rt_size_t *length, struct bench_result *result)
+{
+    struct bench_gen gen;
+    cJSON *root, *records, *record, *version;
+    char *doc;
+    rt_uint32_t t;
+    int err;
+
+    doc = rt_malloc(size + BENCH_RECORD_MAX);
+    if (doc == RT_NULL)
+        return -RT_ENOMEM;
+    bench_gen_init(&gen, size);
+    *length = bench_gen_read(&gen, doc, size + BENCH_RECORD_MAX - 1);
+    doc[*length] = '\0';
+
+    rt_memset(result, 0, sizeof(*result));
+    t = BENCH_CLOCK();
+    root = cJSON_Parse(doc);
+    err = root ? RT_EOK : -RT_ERROR;
+    records = cJSON_GetObjectItem(root, "records");
+    cJSON_ArrayForEach(record, records)
+    {
+        result->temp += cJSON_GetNumberValue(cJSON_GetObjectItem(record, "temp"));
+        result->records++;
+    }
+    version = cJSON_GetObjectItem(cJSON_GetObjectItem(root, "manifest"), "version");
+    result->version = cJSON_IsNumber(version) ? version->valueint : -1;
+    cJSON_Delete(root);
+    *clocks = BENCH_CLOCK() - t;
+    rt_free(doc);
+
+    return err;
+}
+
+static void bench_report(const char *name, rt_size_t size, rt_uint32_t clocks, rt_size_t peak)
+{
+    rt_uint32_t us = BENCH_CLOCK_US(clocks);
+
+    rt_kprintf("%-7d %-7s %9d %9d %9d\n", size / 1024, name, us,
+               us ? (rt_uint32_t)((rt_uint64_t)size * 1000000 / 1024 / us) : 0, peak);
+}
+
+extern int cJSON_hook_init(void);
+
+static void cjson_stream_bench(int argc, char **argv)
+{
+    cJSON_Hooks hooks = {bench_malloc, bench_free};
+    rt_uint32_t max_kb = 1024, chunk_size = 256, clocks;
+    struct bench_result streamed, parsed;
+    rt_size_t size, length;
+    char *chunk;
+    int err;
+
+    if (argc > 1) max_kb = strtoul(argv[1], RT_NULL, 0);
+    if (argc > 2) chunk_size = strtoul(argv[2], RT_NULL, 0);
+    if (max_kb == 0 || chunk_size == 0)
+    {
+        rt_kprintf("Usage: cjson_stream_bench [max_kb] [chunk_bytes]\n");
+        return;
+    }
+    chunk = rt_malloc(chunk_size);
+    if (chunk == RT_NULL)
+    {
+        rt_kprintf("no memory for the chunk\n");
+        return;
+    }
+
+    cJSON_InitHooks(&hooks);
+    rt_kprintf("chunk %d bytes, cJSON_Stream %d bytes\n", chunk_size, sizeof(cJSON_Stream));
+    rt_kprintf("kb      reader         us      kb/s peak byte\n");
+    for (size = 1024; size <= max_kb * 1024; size *= 4)
+    {
+        heap_used = heap_peak = 0;
+        err = bench_stream(size, chunk, chunk_size, &clocks, &streamed);
+        if (err != CJSON_STREAM_OK)
+        {
+            rt_kprintf("%-7d stream  error %d\n", size / 1024, err);
+            continue;
+        }
+        bench_report("stream", size, clocks, sizeof(cJSON_Stream) + chunk_size + heap_peak);
+
+        heap_used = heap_peak = 0;
+        err = bench_tree(size, &clocks, &length, &parsed);
+        if (err == -RT_ENOMEM)
+        {
+            rt_kprintf("%-7d parse   no memory for the document\n", size / 1024);
+            continue;
+        }
+        if (err != RT_EOK)
+        {
+            rt_kprintf("%-7d parse   no memory for the tree\n", size / 1024);
+            continue;
+        }
+        bench_report("parse", size, clocks, length + 1 + heap_peak);
+
+        if (streamed.records != parsed.records || streamed.version != parsed.version ||
+                (rt_int32_t)(streamed.temp * 10) != (rt_int32_t)(parsed.temp * 10))
+        {
+            rt_kprintf("the readers disagree: %d/%d records\n", streamed.records, parsed.records);
+        }
+    }
+
+    cJSON_hook_init();
+    rt_free(chunk);
+}
+MSH_CMD_EXPORT(cjson_stream_bench, streaming JSON reader against cJSON_Parse);
+
+#endif /* defined(CJSON_USING_BENCH) && defined(RT_USING_FINSH) */
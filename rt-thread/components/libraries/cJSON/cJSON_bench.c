@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * cJSON parse and print benchmark.
+ *
+ * A device configuration document of the given size is parsed with the heap hooks,
+ * into an arena growing in 4 KB blocks and in situ into an arena, then printed into
+ * heap and into a preallocated buffer. The time and the heap allocations per run are
+ * reported, the trees of the three parsers are checked to print the same text.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cJSON.h"
+
+#if defined(CJSON_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_ARENA_BLOCK       4096
+
+static rt_uint32_t bench_allocs;
+
+static void *bench_malloc(size_t size)
+{
+    bench_allocs++;
+    return rt_malloc(size);
+}
+
+/* a cloud configuration with devices, strings to escape and numbers */
+static char *bench_document(rt_size_t size)
+{
+    char *doc;
+    rt_size_t len;
+    int i;
+
+    doc = rt_malloc(size + 512);
+    if (doc == RT_NULL)
+        return RT_NULL;
+
+    len = rt_snprintf(doc, 512, "{\"version\":3,\"tenant\":\"rt-thread\",\"upload\":{\"url\":\"https:\\/\\/example.com\\/v1\","
+                      "\"interval\":60,\"retry\":[1,5,30]},\"devices\":[");
+    for (i = 0; len < size; i++)
+    {
+        len += rt_snprintf(doc + len, 512, "%s{\"id\":\"dev-%04d\",\"name\":\"sensor \\\"%d\\\"\",\"enabled\":%s,"
+                           "\"interval\":%d,\"threshold\":%d.%d,\"tags\":[\"temp\",\"room %d\"],"
+                           "\"location\":{\"lat\":31.%04d,\"lon\":-121.%04d}}",
+                           i ? "," : "", i, i, (i & 1) ? "true" : "false", 1000 + i, i % 100, i % 10, i % 16,
+                           i * 7 % 10000, i * 13 % 10000);
+    }
+    rt_snprintf(doc + len, 512, "]}");
+
+    return doc;
+}
+
+static void bench_report(const char *name, rt_uint32_t clocks, rt_uint32_t rounds, rt_uint32_t allocs)
+{
+    rt_kprintf("%-14s %9d %9d\n", name, BENCH_CLOCK_US(clocks) / rounds, allocs / rounds);
+}
+
+extern int cJSON_hook_init(void);
+
+static void cjson_bench(int argc, char **argv)
+{
+    cJSON_Hooks hooks = {bench_malloc, rt_free};
+    rt_uint32_t size = 20, rounds = 20, n, t, clocks, length;
+    char *doc = RT_NULL, *insitu = RT_NULL, *text[3] = {RT_NULL}, *out = RT_NULL;
+    cJSON_Arena arena;
+    cJSON *tree;
+    int i;
+
+    if (argc > 1) size = strtoul(argv[1], RT_NULL, 0);
+    if (argc > 2) rounds = strtoul(argv[2], RT_NULL, 0);
+    if (size == 0 || rounds == 0)
+    {
+        rt_kprintf("Usage: cjson_bench [doc_kb] [rounds]\n");
+        return;
+    }
+    doc = bench_document(size * 1024);
+    if (doc == RT_NULL)
+    {
+        rt_kprintf("no memory for the document\n");
+        return;
+    }
+    length = rt_strlen(doc) + 1;
+    insitu = rt_malloc(length);
+    out = rt_malloc(length + 64);
+    if (insitu == RT_NULL || out == RT_NULL)
+    {
+        rt_kprintf("no memory for the buffers\n");
+        goto _exit;
+    }
+
+    cJSON_InitHooks(&hooks);
+    cJSON_InitArena(&arena, RT_NULL, 0, BENCH_ARENA_BLOCK);
+    rt_kprintf("%d bytes document, %d rounds\n", length - 1, rounds);
+    rt_kprintf("mode           us/run    allocs\n");
+
+    bench_allocs = 0;
+    clocks = 0;
+    for (n = 0; n < rounds; n++)
+    {
+        t = BENCH_CLOCK();
+        cJSON_Delete(cJSON_Parse(doc));
+        clocks += BENCH_CLOCK() - t;
+    }
+    bench_report("parse heap", clocks, rounds, bench_allocs);
+
+    bench_allocs = 0;
+    clocks = 0;
+    for (n = 0; n < rounds; n++)
+    {
+        t = BENCH_CLOCK();
+        cJSON_ParseArena(&arena, doc, length);
+        cJSON_ResetArena(&arena);
+        clocks += BENCH_CLOCK() - t;
+    }
+    bench_report("parse arena", clocks, rounds, bench_allocs);
+
+    /* the copy of the document the parser writes into is not counted */
+    bench_allocs = 0;
+    clocks = 0;
+    for (n = 0; n < rounds; n++)
+    {
+        rt_memcpy(insitu, doc, length);
+        t = BENCH_CLOCK();
+        cJSON_ParseInSitu(&arena, insitu, length);
+        cJSON_ResetArena(&arena);
+        clocks += BENCH_CLOCK() - t;
+    }
+    bench_report("parse in situ", clocks, rounds, bench_allocs);
+
+    tree = cJSON_ParseArena(&arena, doc, length);
+    bench_allocs = 0;
+    clocks = 0;
+    for (n = 0; n < rounds; n++)
+    {
+        t = BENCH_CLOCK();
+        rt_free(cJSON_PrintUnformatted(tree));
+        clocks += BENCH_CLOCK() - t;
+    }
+    bench_report("print heap", clocks, rounds, bench_allocs);
+
+    bench_allocs = 0;
+    clocks = 0;
+    for (n = 0; n < rounds; n++)
+    {
+        t = BENCH_CLOCK();
+        cJSON_PrintPreallocated(tree, out, length + 64, 0);
+        clocks += BENCH_CLOCK() - t;
+    }
+    bench_report("print prealloc", clocks, rounds, bench_allocs);
+
+    /* the three parsers must build the same tree */
+    text[0] = cJSON_PrintUnformatted(tree);
+    cJSON_ResetArena(&arena);
+    tree = cJSON_Parse(doc);
+    text[1] = cJSON_PrintUnformatted(tree);
+    cJSON_Delete(tree);
+    rt_memcpy(insitu, doc, length);
+    text[2] = cJSON_PrintUnformatted(cJSON_ParseInSitu(&arena, insitu, length));
+    cJSON_ResetArena(&arena);
+    if (text[0] == RT_NULL || text[1] == RT_NULL || text[2] == RT_NULL ||
+            rt_strcmp(text[0], text[1]) != 0 || rt_strcmp(text[0], text[2]) != 0)
+    {
+        rt_kprintf("the parsers disagree\n");
+    }
+
+_exit:
+    cJSON_hook_init();
+    for (i = 0; i < 3; i++)
+    {
+        rt_free(text[i]);
+    }
+    rt_free(out);
+    rt_free(insitu);
+    rt_free(doc);
+}
+MSH_CMD_EXPORT(cjson_bench, cJSON parse and print time and allocations);
+
+#ifdef RT_USING_UTEST
+#include <utest.h>
+
+static void test_cjson_parsers(void)
+{
+    char *doc, *insitu, *out, *text[3];
+    rt_uint32_t length;
+    cJSON_Arena arena;
+    cJSON *tree;
+    int i;
+
+    doc = bench_document(4096);
+    uassert_not_null(doc);
+    if (doc == RT_NULL)
+        return;
+    length = rt_strlen(doc) + 1;
+    insitu = rt_malloc(length);
+    out = rt_malloc(length + 64);
+    cJSON_InitArena(&arena, RT_NULL, 0, BENCH_ARENA_BLOCK);
+
+    /* the heap, arena and in situ parsers build the same tree */
+    tree = cJSON_Parse(doc);
+    text[0] = cJSON_PrintUnformatted(tree);
+    cJSON_Delete(tree);
+    text[1] = cJSON_PrintUnformatted(cJSON_ParseArena(&arena, doc, length));
+    cJSON_ResetArena(&arena);
+    text[2] = RT_NULL;
+    if (insitu)
+    {
+        rt_memcpy(insitu, doc, length);
+        text[2] = cJSON_PrintUnformatted(cJSON_ParseInSitu(&arena, insitu, length));
+        cJSON_ResetArena(&arena);
+    }
+    for (i = 0; i < 3; i++)
+    {
+        uassert_not_null(text[i]);
+        if (text[0] && text[i])
+            uassert_str_equal(text[i], text[0]);
+    }
+
+    /* printing into a buffer gives the text printed into the heap */
+    if (out && text[0])
+    {
+        tree = cJSON_ParseArena(&arena, doc, length);
+        uassert_true(cJSON_PrintPreallocated(tree, out, length + 64, 0));
+        uassert_str_equal(out, text[0]);
+        cJSON_ResetArena(&arena);
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        rt_free(text[i]);
+    }
+    rt_free(out);
+    rt_free(insitu);
+    rt_free(doc);
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_cjson_parsers);
+}
+UTEST_TC_EXPORT(testcase, "components.libraries.cJSON.cJSON_bench", RT_NULL, RT_NULL, 10);
+#endif /* RT_USING_UTEST */
+
+#endif /* defined(CJSON_USING_BENCH) && defined(RT_USING_FINSH) */
@@ -1,15 +0,0 @@
-/*
- * Copyright (c) 2006-2022, RT-Thread Development Team
- *
- * SPDX-License-Identifier: Apache-2.0
- *
- * Change Logs:
- * Date           Author       Notes
- */
-
-#ifndef __COREDUMP_H__
-#define __COREDUMP_H__
-
-void coredump(struct rt_hw_exp_stack *regs);
-
-#endif //__COREDUMP_H__
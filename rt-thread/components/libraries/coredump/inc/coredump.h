@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    streaming compressed core to file, FAL partition or socket
+ * 2026-10-18     RT-Thread    keep the core of a fault in RAM until the next boot
+ */
+
+#ifndef __COREDUMP_H__
+#define __COREDUMP_H__
+
+#include <rtthread.h>
+
+/* history of the compressor, also the size of a compressed frame */
+#ifndef COREDUMP_LZ_WINDOW
+#define COREDUMP_LZ_WINDOW      4096
+#endif
+
+/* threads with a register note, the others are left out of the core */
+#ifndef COREDUMP_THREAD_MAX
+#define COREDUMP_THREAD_MAX     32
+#endif
+
+#ifndef COREDUMP_REGION_MAX
+#define COREDUMP_REGION_MAX     8
+#endif
+
+/* what goes into the core, the register notes of the threads are always there */
+#define COREDUMP_INCLUDE_STACKS 0x01    /* the used part of the thread stacks */
+#define COREDUMP_INCLUDE_DATA   0x02    /* regions added as data, .data and .bss by the port */
+#define COREDUMP_INCLUDE_HEAP   0x04    /* regions added as heap, the system heap by the port */
+#define COREDUMP_INCLUDE_USER   0x08    /* other regions added by the application */
+#define COREDUMP_RAW            0x80    /* a plain ELF core instead of the compressed stream */
+
+#ifndef COREDUMP_INCLUDE_DEFAULT
+#ifdef COREDUMP_USING_HEAP
+#define COREDUMP_INCLUDE_DEFAULT (COREDUMP_INCLUDE_STACKS | COREDUMP_INCLUDE_DATA | COREDUMP_INCLUDE_HEAP | COREDUMP_INCLUDE_USER)
+#else
+#define COREDUMP_INCLUDE_DEFAULT (COREDUMP_INCLUDE_STACKS | COREDUMP_INCLUDE_DATA | COREDUMP_INCLUDE_USER)
+#endif
+#endif
+
+struct coredump_sink
+{
+    int (*open)(struct coredump_sink *sink);
+    int (*write)(struct coredump_sink *sink, const void *buf, rt_size_t size);
+    void (*close)(struct coredump_sink *sink);
+
+    const void *user_data;              /* path, partition, host:port or buffer */
+    int fd;
+    rt_uint32_t offset;                 /* bytes written */
+    rt_uint32_t erased;                 /* end of the erased part of a partition */
+    rt_uint32_t limit;                  /* size of a buffer */
+};
+
+struct coredump_stat
+{
+    rt_uint32_t raw_size;               /* size of the ELF core */
+    rt_uint32_t size;                   /* bytes written to the sink */
+    rt_uint32_t threads;
+    rt_uint32_t segments;
+};
+
+int coredump_region_add(void *addr, rt_size_t size, rt_uint32_t type);
+
+/* context is the exception context of the port, RT_NULL for a snapshot of the running system */
+int coredump_write(struct coredump_sink *sink, void *context, rt_uint32_t include, struct coredump_stat *stat);
+int coredump(void *context);
+int coredump_install(void);
+#ifdef COREDUMP_RETAINED_SIZE
+int coredump_retained_save(void);
+#endif
+
+void coredump_sink_ram_init(struct coredump_sink *sink, void *buffer, rt_size_t size);
+void coredump_sink_file_init(struct coredump_sink *sink, const char *path);
+int coredump_sink_fal_init(struct coredump_sink *sink, const char *partition);
+int coredump_sink_socket_init(struct coredump_sink *sink, const char *target);
+
+#endif //__COREDUMP_H__
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+#include <board.h>
+#include "coredump_internal.h"
+
+#if defined(ARCH_ARM_CORTEX_M3) || defined(ARCH_ARM_CORTEX_M4) || defined(ARCH_ARM_CORTEX_M7)
+
+#if               /* ARMCC */ (  (defined ( __CC_ARM ) && defined ( __TARGET_FPU_VFP ))    \
+                  /* Clang */ || (defined ( __clang__ ) && defined ( __VFP_FP__ ) && !defined(__SOFTFP__)) \
+                  /* IAR */   || (defined ( __ICCARM__ ) && defined ( __ARMVFP__ ))        \
+                  /* GNU */   || (defined ( __GNUC__ ) && defined ( __VFP_FP__ ) && !defined(__SOFTFP__)) )
+#define USE_FPU   1
+#else
+#define USE_FPU   0
+#endif
+
+/*
+ * Cortex-M: the exception stacks r0 - r3, r12, lr, pc and xpsr, with s0 - s15 and fpscr when
+ * bit 4 of EXC_RETURN is clear, and one more word when bit 9 of the stacked xpsr is set. The
+ * HardFault_Handler pushes r4 - r11 below it, then EXC_RETURN, the exception hook gets the
+ * stacked frame. PendSV saves a switched out thread the same way, with a flag word for the
+ * FPU registers s16 - s31 in front of r4 - r11.
+ *
+ * The debugger reads the registers in the A-profile layout, the Thumb bit of xpsr (bit 24) is
+ * also given as the T bit (bit 5) of cpsr.
+ */
+#define SCB_VTOR                (*(volatile rt_uint32_t *)0xE000ED08)
+
+#define CORE_FRAME_WORDS        8
+#define CORE_FRAME_FPU_WORDS    18
+#define CORE_XPSR_ALIGN         (1UL << 9)
+#define CORE_XPSR_THUMB         (1UL << 24)
+#define CORE_CPSR_THUMB         (1UL << 5)
+
+#define CORE_HWCAP_HALF         (1 << 1)
+#define CORE_HWCAP_THUMB        (1 << 2)
+#define CORE_HWCAP_FAST_MULT    (1 << 4)
+#define CORE_HWCAP_VFP          (1 << 6)
+#define CORE_HWCAP_EDSP         (1 << 7)
+#define CORE_HWCAP_VFPv3D16     (1 << 14)
+#define CORE_HWCAP_VFPv4        (1 << 16)
+#define CORE_HWCAP_IDIVT        (1 << 18)
+
+static void core_port_frame(struct coredump_regs *regs, const rt_uint32_t *frame, rt_bool_t fpu)
+{
+    rt_uint32_t sp;
+
+    regs->r[0] = frame[0];
+    regs->r[1] = frame[1];
+    regs->r[2] = frame[2];
+    regs->r[3] = frame[3];
+    regs->r[12] = frame[4];
+    regs->r[14] = frame[5];
+    regs->r[15] = frame[6];
+    regs->psr = frame[7];
+    if (regs->psr & CORE_XPSR_THUMB)
+        regs->psr |= CORE_CPSR_THUMB;
+
+    sp = (rt_uint32_t)(frame + CORE_FRAME_WORDS + (fpu ? CORE_FRAME_FPU_WORDS : 0));
+    if (frame[7] & CORE_XPSR_ALIGN)
+        sp += 4;
+    regs->r[13] = sp;
+}
+
+rt_bool_t coredump_port_fault_regs(void *context, struct coredump_regs *regs, rt_ubase_t *stack_top)
+{
+    const rt_uint32_t *frame = (const rt_uint32_t *)context;
+    rt_uint32_t exc_return = frame[-9];
+    int index;
+
+    rt_memset(regs, 0, sizeof(*regs));
+    for (index = 0; index < 8; index++)
+        regs->r[4 + index] = frame[index - 8];
+    core_port_frame(regs, frame, (exc_return & 0x10) == 0);
+
+    /* a fault in a handler is on the main stack, its top is the first word of the vectors */
+    *stack_top = *(rt_uint32_t *)SCB_VTOR;
+
+    return (exc_return & 0x04) ? RT_TRUE : RT_FALSE;
+}
+
+void coredump_port_self_regs(struct coredump_regs *regs)
+{
+    volatile rt_uint32_t sp = 0;
+
+    /* what the caller can give without assembly, r4 - r11 are not saved */
+    rt_memset(regs, 0, sizeof(*regs));
+    regs->r[13] = (rt_uint32_t)&sp;
+#if defined(__GNUC__) || defined(__CC_ARM) || defined(__clang__)
+    regs->r[14] = (rt_uint32_t)__builtin_return_address(0);
+#endif
+    regs->r[15] = (rt_uint32_t)coredump_port_self_regs;
+    regs->psr = CORE_XPSR_THUMB | CORE_CPSR_THUMB;
+}
+
+void coredump_port_thread_regs(rt_thread_t thread, struct coredump_regs *regs)
+{
+    const rt_uint32_t *sp = (const rt_uint32_t *)thread->sp;
+    rt_ubase_t bottom = (rt_ubase_t)thread->stack_addr;
+    rt_ubase_t top = bottom + thread->stack_size;
+    rt_bool_t fpu = RT_FALSE;
+    int index;
+
+    rt_memset(regs, 0, sizeof(*regs));
+    if (thread == rt_thread_self())
+    {
+        /* interrupted by a fault in a handler, r4 - r11 are lost in the handler */
+        sp = (const rt_uint32_t *)__get_PSP();
+        if ((rt_ubase_t)sp >= bottom && (rt_ubase_t)(sp + CORE_FRAME_WORDS) <= top)
+            core_port_frame(regs, sp, RT_FALSE);
+        else
+            regs->r[13] = (rt_uint32_t)sp;
+        return;
+    }
+
+    /* a stack pointer out of the stack is left alone, reading there could fault again */
+    if ((rt_ubase_t)sp < bottom || (rt_ubase_t)(sp + 1 + 8 + 16 + CORE_FRAME_WORDS) > top)
+    {
+        regs->r[13] = (rt_uint32_t)sp;
+        return;
+    }
+
+#if USE_FPU
+    fpu = *sp++ ? RT_TRUE : RT_FALSE;
+#endif
+    for (index = 4; index <= 11; index++)
+        regs->r[index] = *sp++;
+    if (fpu)
+        sp += 16;
+    core_port_frame(regs, sp, fpu);
+}
+
+rt_uint32_t coredump_port_hwcap(void)
+{
+    rt_uint32_t hwcap = CORE_HWCAP_HALF | CORE_HWCAP_THUMB | CORE_HWCAP_FAST_MULT | CORE_HWCAP_IDIVT;
+
+#if defined(ARCH_ARM_CORTEX_M4) || defined(ARCH_ARM_CORTEX_M7)
+    hwcap |= CORE_HWCAP_EDSP;
+#endif
+#if USE_FPU
+    hwcap |= CORE_HWCAP_VFP | CORE_HWCAP_VFPv3D16 | CORE_HWCAP_VFPv4;
+#endif
+
+    return hwcap;
+}
+
+#if defined(__CC_ARM) || defined(__CLANG_ARM)
+extern int Image$$RW_IRAM1$$Base, Image$$RW_IRAM1$$ZI$$Limit;
+#elif defined(__GNUC__)
+extern int _sdata, _edata, __bss_start, __bss_end;
+#endif
+
+void coredump_port_regions(void)
+{
+#if defined(__CC_ARM) || defined(__CLANG_ARM)
+    coredump_region_add(&Image$$RW_IRAM1$$Base, (rt_ubase_t)&Image$$RW_IRAM1$$ZI$$Limit - (rt_ubase_t)&Image$$RW_IRAM1$$Base,
+                        COREDUMP_INCLUDE_DATA);
+#elif defined(__GNUC__)
+    coredump_region_add(&_sdata, (rt_ubase_t)&_edata - (rt_ubase_t)&_sdata, COREDUMP_INCLUDE_DATA);
+    coredump_region_add(&__bss_start, (rt_ubase_t)&__bss_end - (rt_ubase_t)&__bss_start, COREDUMP_INCLUDE_DATA);
+#endif
+
+#if defined(RT_USING_HEAP) && defined(HEAP_BEGIN) && defined(HEAP_END)
+    coredump_region_add((void *)HEAP_BEGIN, (rt_ubase_t)HEAP_END - (rt_ubase_t)HEAP_BEGIN, COREDUMP_INCLUDE_HEAP);
+#endif
+}
+
+#endif /* defined(ARCH_ARM_CORTEX_M3) || defined(ARCH_ARM_CORTEX_M4) || defined(ARCH_ARM_CORTEX_M7) */
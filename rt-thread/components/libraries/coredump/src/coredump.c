@@ -0,0 +1,579 @@
+/*
+ * Copyright (c) 2006-2020, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2020-02-17     Jesven       first version
+ * 2026-10-18     RT-Thread    stream the core of all threads and selected segments
+ * 2026-10-18     RT-Thread    only the FAL sink from the exception handler
+ * 2026-10-18     RT-Thread    keep the core of a fault in RAM, save it on the next boot
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef RT_USING_MODULE
+#include <dlmodule.h>
+#endif
+#include "coredump_internal.h"
+
+#define DBG_TAG    "COREDUMP"
+#define DBG_LVL    DBG_INFO
+#include <rtdbg.h>
+
+/*
+ * The core is written in one pass: the segments are chosen and the threads with their
+ * registers are taken first, so that the program headers know every offset, then the memory
+ * goes from its place straight into the stream. In a fault the system stays as it is while
+ * the core is written; a snapshot of the running system lets the other threads run, their
+ * memory may change while it is written.
+ */
+
+#ifndef COREDUMP_FILE_PATH
+#define COREDUMP_FILE_PATH      "/core.rcd"
+#endif
+
+#define CORE_SIGSEGV            11
+#define CORE_AT_HWCAP           16
+#define CORE_AT_NULL            0
+
+struct core_thread
+{
+    rt_thread_t thread;                 /* RT_NULL for a fault in a handler */
+    struct coredump_regs regs;
+    rt_ubase_t stack_bottom;
+    rt_ubase_t stack_top;
+};
+
+struct core_region
+{
+    rt_ubase_t addr;
+    rt_size_t size;
+    rt_uint32_t type;
+};
+
+static struct core_thread core_threads[COREDUMP_THREAD_MAX];
+static struct core_region core_regions[COREDUMP_REGION_MAX];
+static struct core_region core_segments[COREDUMP_THREAD_MAX + COREDUMP_REGION_MAX + 1];
+static int core_region_nr;
+static struct core_stream core_stream;
+static volatile int core_dumping;
+
+static const char core_note_name[8] = "CORE";
+
+#ifdef COREDUMP_RETAINED_SIZE
+#define CORE_RETAINED_MAGIC     0x44435452  /* "RTCD" */
+
+/* the stream of the core of a fault, not cleared on reset */
+struct core_retained
+{
+    rt_uint32_t magic;
+    rt_uint32_t size;
+    rt_uint32_t check;                  /* ~size */
+    rt_uint8_t data[COREDUMP_RETAINED_SIZE];
+};
+static struct core_retained core_retained rt_section(".noinit");
+#endif
+
+rt_weak rt_bool_t coredump_port_fault_regs(void *context, struct coredump_regs *regs, rt_ubase_t *stack_top)
+{
+    rt_memset(regs, 0, sizeof(*regs));
+    *stack_top = 0;
+
+    return RT_TRUE;
+}
+
+rt_weak void coredump_port_self_regs(struct coredump_regs *regs)
+{
+    rt_memset(regs, 0, sizeof(*regs));
+}
+
+rt_weak void coredump_port_thread_regs(rt_thread_t thread, struct coredump_regs *regs)
+{
+    rt_memset(regs, 0, sizeof(*regs));
+    regs->r[13] = (rt_uint32_t)(rt_ubase_t)thread->sp;
+}
+
+rt_weak rt_uint32_t coredump_port_hwcap(void)
+{
+    return 0;
+}
+
+rt_weak void coredump_port_regions(void)
+{
+}
+
+int coredump_region_add(void *addr, rt_size_t size, rt_uint32_t type)
+{
+    rt_ubase_t start = RT_ALIGN_DOWN((rt_ubase_t)addr, 4);
+    rt_ubase_t end = RT_ALIGN((rt_ubase_t)addr + size, 4);
+    rt_base_t level;
+    int ret = -RT_EFULL;
+
+    if (size == 0)
+        return -RT_EINVAL;
+
+    level = rt_hw_interrupt_disable();
+    if (core_region_nr < COREDUMP_REGION_MAX)
+    {
+        core_regions[core_region_nr].addr = start;
+        core_regions[core_region_nr].size = end - start;
+        core_regions[core_region_nr].type = type;
+        core_region_nr++;
+        ret = RT_EOK;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return ret;
+}
+
+static void core_thread_stack(struct core_thread *ct)
+{
+    rt_ubase_t bottom = (rt_ubase_t)ct->thread->stack_addr;
+    rt_ubase_t top = bottom + ct->thread->stack_size;
+    rt_ubase_t sp = ct->regs.r[13];
+
+    /* only the used part, all of it when the stack pointer left the stack */
+#ifdef ARCH_CPU_STACK_GROWS_UPWARD
+    ct->stack_bottom = bottom;
+    ct->stack_top = (sp > bottom && sp <= top) ? sp : top;
+#else
+    ct->stack_bottom = (sp >= bottom && sp < top) ? sp : bottom;
+    ct->stack_top = top;
+#endif
+}
+
+static int core_collect_threads(void *context)
+{
+    struct rt_object_information *info = rt_object_get_information(RT_Object_Class_Thread);
+    struct core_thread *ct = &core_threads[0];
+    struct rt_list_node *node;
+    rt_thread_t thread;
+    rt_base_t level;
+    int count = 1;
+
+    /* the context of the fault or of the caller is the first, the thread of the debugger */
+    rt_memset(ct, 0, sizeof(*ct));
+    if (context == RT_NULL)
+    {
+        coredump_port_self_regs(&ct->regs);
+        ct->thread = rt_thread_self();
+    }
+    else if (coredump_port_fault_regs(context, &ct->regs, &ct->stack_top))
+    {
+        ct->thread = rt_thread_self();
+    }
+    else
+    {
+        ct->stack_bottom = RT_ALIGN_DOWN(ct->regs.r[13], 4);
+        if (ct->stack_top < ct->stack_bottom)
+            ct->stack_top = ct->stack_bottom;
+    }
+    if (ct->thread)
+        core_thread_stack(ct);
+
+    level = rt_hw_interrupt_disable();
+    rt_list_for_each(node, &info->object_list)
+    {
+        thread = (rt_thread_t)rt_list_entry(node, struct rt_object, list);
+        if (thread == core_threads[0].thread)
+            continue;
+        if (count == COREDUMP_THREAD_MAX)
+            break;
+
+        ct = &core_threads[count++];
+        ct->thread = thread;
+        coredump_port_thread_regs(thread, &ct->regs);
+        core_thread_stack(ct);
+    }
+    rt_hw_interrupt_enable(level);
+
+    return count;
+}
+
+static rt_bool_t core_in_segments(int segments, rt_ubase_t start, rt_ubase_t end)
+{
+    int index;
+
+    for (index = 0; index < segments; index++)
+    {
+        if (start >= core_segments[index].addr && end <= core_segments[index].addr + core_segments[index].size)
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+static int core_select_segments(int threads, rt_uint32_t include)
+{
+    rt_ubase_t start, end;
+    int count = 0, index;
+
+    for (index = 0; index < core_region_nr; index++)
+    {
+        if (core_regions[index].type & include)
+            core_segments[count++] = core_regions[index];
+    }
+
+#ifdef RT_USING_MODULE
+    /* the memory of the module of the thread, the core of the previous versions */
+    if (core_threads[0].thread && core_threads[0].thread->module && (include & COREDUMP_INCLUDE_USER))
+    {
+        core_segments[count].addr = (rt_ubase_t)core_threads[0].thread->module->mem_space;
+        core_segments[count].size = core_threads[0].thread->module->mem_size;
+        core_segments[count++].type = COREDUMP_INCLUDE_USER;
+    }
+#endif
+
+    /* stacks in a segment already, as in the heap, are not written twice */
+    for (index = 0; (include & COREDUMP_INCLUDE_STACKS) && index < threads; index++)
+    {
+        start = RT_ALIGN_DOWN(core_threads[index].stack_bottom, 4);
+        end = RT_ALIGN(core_threads[index].stack_top, 4);
+        if (end > start && !core_in_segments(count, start, end))
+        {
+            core_segments[count].addr = start;
+            core_segments[count].size = end - start;
+            core_segments[count++].type = COREDUMP_INCLUDE_STACKS;
+        }
+    }
+
+    return count;
+}
+
+static void core_write_headers(int segments, rt_uint32_t note_size)
+{
+    struct core_ehdr ehdr;
+    struct core_phdr phdr;
+    rt_uint32_t offset;
+    int index;
+
+    rt_memset(&ehdr, 0, sizeof(ehdr));
+    rt_memcpy(ehdr.e_ident, "\177ELF", 4);
+    ehdr.e_ident[4] = 1;                /* ELFCLASS32 */
+    ehdr.e_ident[5] = 1;                /* ELFDATA2LSB */
+    ehdr.e_ident[6] = 1;                /* EV_CURRENT */
+    ehdr.e_type = CORE_ET_CORE;
+    ehdr.e_machine = CORE_EM_ARM;
+    ehdr.e_version = 1;
+    ehdr.e_phoff = sizeof(ehdr);
+    ehdr.e_ehsize = sizeof(ehdr);
+    ehdr.e_phentsize = sizeof(phdr);
+    ehdr.e_phnum = segments + 1;
+    core_stream_write(&core_stream, &ehdr, sizeof(ehdr));
+
+    offset = sizeof(ehdr) + (segments + 1) * sizeof(phdr);
+    rt_memset(&phdr, 0, sizeof(phdr));
+    phdr.p_type = CORE_PT_NOTE;
+    phdr.p_offset = offset;
+    phdr.p_filesz = note_size;
+    core_stream_write(&core_stream, &phdr, sizeof(phdr));
+    offset += note_size;
+
+    for (index = 0; index < segments; index++)
+    {
+        phdr.p_type = CORE_PT_LOAD;
+        phdr.p_offset = offset;
+        phdr.p_vaddr = core_segments[index].addr;
+        phdr.p_filesz = core_segments[index].size;
+        phdr.p_memsz = core_segments[index].size;
+        phdr.p_flags = CORE_PF_RWX;
+        phdr.p_align = 4;
+        core_stream_write(&core_stream, &phdr, sizeof(phdr));
+        offset += core_segments[index].size;
+    }
+}
+
+static void core_write_note(rt_uint32_t type, const void *desc, rt_uint32_t size)
+{
+    struct core_nhdr nhdr;
+
+    nhdr.n_namesz = 5;
+    nhdr.n_descsz = size;
+    nhdr.n_type = type;
+    core_stream_write(&core_stream, &nhdr, sizeof(nhdr));
+    core_stream_write(&core_stream, core_note_name, sizeof(core_note_name));
+    core_stream_write(&core_stream, desc, size);
+}
+
+static void core_write_notes(int threads, rt_bool_t fault)
+{
+    struct core_prstatus prstatus;
+    rt_uint32_t auxv[4];
+    int index;
+
+    for (index = 0; index < threads; index++)
+    {
+        rt_memset(&prstatus, 0, sizeof(prstatus));
+        if (index == 0 && fault)
+        {
+            prstatus.si_signo = CORE_SIGSEGV;
+            prstatus.pr_cursig = CORE_SIGSEGV;
+        }
+        prstatus.pr_pid = index + 1;
+        rt_memcpy(prstatus.pr_reg, core_threads[index].regs.r, sizeof(core_threads[index].regs.r));
+        prstatus.pr_reg[16] = core_threads[index].regs.psr;
+        prstatus.pr_reg[17] = core_threads[index].regs.r[0];
+        core_write_note(CORE_NT_PRSTATUS, &prstatus, sizeof(prstatus));
+    }
+
+    auxv[0] = CORE_AT_HWCAP;
+    auxv[1] = coredump_port_hwcap();
+    auxv[2] = CORE_AT_NULL;
+    auxv[3] = 0;
+    core_write_note(CORE_NT_AUXV, auxv, sizeof(auxv));
+}
+
+/**
+ * This function writes the core of the system to a sink.
+ *
+ * @param sink the sink of the core.
+ * @param context the exception context of the port, RT_NULL for a snapshot of the running system.
+ * @param include the COREDUMP_INCLUDE_* segments, with COREDUMP_RAW for a plain ELF core.
+ * @param stat the sizes of the core when it is not RT_NULL.
+ *
+ * @return RT_EOK on success, -RT_EBUSY when a core is being written, -RT_EIO when the sink failed.
+ */
+int coredump_write(struct coredump_sink *sink, void *context, rt_uint32_t include, struct coredump_stat *stat)
+{
+    rt_uint32_t note_size;
+    int threads, segments, index, ret;
+
+    if (core_dumping)
+        return -RT_EBUSY;
+    core_dumping = 1;
+
+    threads = core_collect_threads(context);
+    segments = core_select_segments(threads, include);
+    note_size = threads * (sizeof(struct core_nhdr) + sizeof(core_note_name) + sizeof(struct core_prstatus))
+                + sizeof(struct core_nhdr) + sizeof(core_note_name) + 4 * sizeof(rt_uint32_t);
+
+    ret = core_stream_open(&core_stream, sink, !(include & COREDUMP_RAW));
+    if (ret == RT_EOK)
+    {
+        core_write_headers(segments, note_size);
+        core_write_notes(threads, context != RT_NULL);
+        for (index = 0; index < segments && core_stream.error == 0; index++)
+            core_stream_write(&core_stream, (void *)core_segments[index].addr, core_segments[index].size);
+
+        ret = core_stream_close(&core_stream);
+    }
+
+    if (stat)
+    {
+        stat->raw_size = core_stream.raw_size;
+        stat->size = sink->offset;
+        stat->threads = threads;
+        stat->segments = segments;
+    }
+    core_dumping = 0;
+
+    return ret;
+}
+
+/**
+ * This function writes the core to the sink of the configuration: the FAL partition
+ * COREDUMP_FAL_PARTITION, or else the file COREDUMP_FILE_PATH. The flash driver and a file
+ * need the scheduler, so from an exception the core is kept in RAM with COREDUMP_RETAINED_SIZE
+ * and saved to the partition on the next boot, and nothing is written without it.
+ *
+ * @param context the exception context of the port, RT_NULL for a snapshot of the running system.
+ *
+ * @return RT_EOK on success, -RT_ENOSYS if there is no sink usable in the context,
+ *         otherwise an error code.
+ */
+int coredump(void *context)
+{
+    struct coredump_sink sink;
+    struct coredump_stat stat;
+    int ret;
+
+#if defined(RT_USING_FAL) && defined(COREDUMP_FAL_PARTITION)
+    if (context != RT_NULL)
+    {
+#ifdef COREDUMP_RETAINED_SIZE
+        core_retained.magic = 0;
+        coredump_sink_ram_init(&sink, core_retained.data, sizeof(core_retained.data));
+        ret = RT_EOK;
+#else
+        /* the flash driver takes mutexes, not in the exception handler */
+        return -RT_ENOSYS;
+#endif
+    }
+    else
+    {
+        ret = coredump_sink_fal_init(&sink, COREDUMP_FAL_PARTITION);
+    }
+#elif defined(RT_USING_DFS)
+    if (context != RT_NULL)
+    {
+        /* open() and write() take mutexes, not in the exception handler */
+        return -RT_ENOSYS;
+    }
+    coredump_sink_file_init(&sink, COREDUMP_FILE_PATH);
+    ret = RT_EOK;
+#else
+    ret = -RT_ENOSYS;
+#endif
+    if (ret != RT_EOK)
+    {
+        LOG_E("No sink for the core!");
+        return ret;
+    }
+
+    ret = coredump_write(&sink, context, COREDUMP_INCLUDE_DEFAULT, &stat);
+#ifdef COREDUMP_RETAINED_SIZE
+    if (ret == RT_EOK && context != RT_NULL)
+    {
+        core_retained.size = stat.size;
+        core_retained.check = ~stat.size;
+        core_retained.magic = CORE_RETAINED_MAGIC;
+        LOG_I("Core kept in RAM until the next boot");
+    }
+#endif
+    if (ret == RT_EOK)
+        LOG_I("Core dumped: %d threads, %d segments, %d bytes in %d", stat.threads, stat.segments, stat.raw_size, stat.size);
+    else
+        LOG_E("Core dump failed: %d", ret);
+
+    return ret;
+}
+
+#ifdef COREDUMP_RETAINED_SIZE
+/**
+ * This function saves the core kept in RAM by a fault before the reset to the FAL partition
+ * COREDUMP_FAL_PARTITION, it runs on boot once the partitions are found.
+ *
+ * @return RT_EOK on success or when no core is kept, otherwise an error code.
+ */
+int coredump_retained_save(void)
+{
+    struct coredump_sink sink;
+    int ret;
+
+    if (core_retained.magic != CORE_RETAINED_MAGIC || core_retained.size > COREDUMP_RETAINED_SIZE ||
+        core_retained.check != ~core_retained.size)
+    {
+        return RT_EOK;
+    }
+
+    ret = coredump_sink_fal_init(&sink, COREDUMP_FAL_PARTITION);
+    if (ret == RT_EOK)
+    {
+        if (sink.open(&sink) != 0 ||
+            sink.write(&sink, core_retained.data, core_retained.size) != (int)core_retained.size)
+        {
+            ret = -RT_EIO;
+        }
+        sink.close(&sink);
+    }
+    if (ret == RT_EOK)
+    {
+        core_retained.magic = 0;
+        LOG_I("Core of the last fault saved to %s, %d bytes", COREDUMP_FAL_PARTITION, core_retained.size);
+    }
+    else
+    {
+        LOG_E("Core of the last fault not saved: %d", ret);
+    }
+
+    return ret;
+}
+INIT_APP_EXPORT(coredump_retained_save);
+#endif /* COREDUMP_RETAINED_SIZE */
+
+#ifdef COREDUMP_USING_FAULT_HOOK
+static rt_err_t coredump_exception_hook(void *context)
+{
+    coredump(context);
+
+    /* on to the report of the fault */
+    return -RT_ERROR;
+}
+#endif
+
+/**
+ * This function adds the regions of the port and, with COREDUMP_USING_FAULT_HOOK, writes a core
+ * from the exception handler of the CPU.
+ */
+int coredump_install(void)
+{
+    static rt_bool_t installed = RT_FALSE;
+
+    if (!installed)
+    {
+        installed = RT_TRUE;
+        coredump_port_regions();
+#ifdef COREDUMP_USING_FAULT_HOOK
+        rt_hw_exception_install(coredump_exception_hook);
+#endif
+    }
+
+    return RT_EOK;
+}
+INIT_COMPONENT_EXPORT(coredump_install);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void cmd_coredump(int argc, char **argv)
+{
+    struct coredump_sink sink;
+    struct coredump_stat stat;
+    rt_uint32_t include = COREDUMP_INCLUDE_DEFAULT;
+    rt_tick_t tick;
+    int ret = -RT_ENOSYS;
+
+    if (argc < 2)
+    {
+        rt_kprintf("Usage: coredump <file | partition | host:port> [include]\n");
+        rt_kprintf("       a snapshot of the running system, include is a mask of\n");
+        rt_kprintf("       stacks 0x1, data 0x2, heap 0x4, user 0x8, raw ELF 0x80\n");
+        return;
+    }
+    if (argc > 2)
+        include = strtoul(argv[2], RT_NULL, 0);
+
+    if (argv[1][0] == '/')
+    {
+#ifdef RT_USING_DFS
+        coredump_sink_file_init(&sink, argv[1]);
+        ret = RT_EOK;
+#endif
+    }
+    else if (strchr(argv[1], ':'))
+    {
+#ifdef RT_USING_SAL
+        ret = coredump_sink_socket_init(&sink, argv[1]);
+#endif
+    }
+    else
+    {
+#ifdef RT_USING_FAL
+        ret = coredump_sink_fal_init(&sink, argv[1]);
+#endif
+    }
+    if (ret != RT_EOK)
+    {
+        rt_kprintf("no sink %s\n", argv[1]);
+        return;
+    }
+
+    coredump_install();
+    tick = rt_tick_get();
+    ret = coredump_write(&sink, RT_NULL, include, &stat);
+    tick = rt_tick_get() - tick;
+    if (ret != RT_EOK)
+    {
+        rt_kprintf("core dump failed: %d\n", ret);
+        return;
+    }
+
+    rt_kprintf("%d threads, %d segments, %d bytes of core in %d bytes, %d ms\n", stat.threads, stat.segments,
+               stat.raw_size, stat.size, tick * 1000 / RT_TICK_PER_SECOND);
+}
+MSH_CMD_EXPORT_ALIAS(cmd_coredump, coredump, write a core of the running system);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Core dump size and time benchmark.
+ *
+ * A snapshot of the running system with the selected segments goes to a sink that only counts
+ * the bytes, as a plain ELF core and as the compressed stream, which gives the size of the core
+ * for the RAM layout of the board and the time of the compressor without the flash or network.
+ * The coredump command times the same with a real sink.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#include "coredump_internal.h"
+
+#if defined(COREDUMP_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+static int bench_open(struct coredump_sink *sink)
+{
+    return 0;
+}
+
+static int bench_write(struct coredump_sink *sink, const void *buf, rt_size_t size)
+{
+    sink->offset += size;
+
+    return (int)size;
+}
+
+static void bench_close(struct coredump_sink *sink)
+{
+}
+
+static int bench_dump(rt_uint32_t include, struct coredump_stat *stat, rt_uint32_t *us)
+{
+    struct coredump_sink sink;
+    rt_uint32_t t;
+    int ret;
+
+    rt_memset(&sink, 0, sizeof(sink));
+    sink.open = bench_open;
+    sink.write = bench_write;
+    sink.close = bench_close;
+
+    t = BENCH_CLOCK();
+    ret = coredump_write(&sink, RT_NULL, include, stat);
+    *us = (rt_uint32_t)(BENCH_CLOCK_NS(BENCH_CLOCK() - t) / 1000);
+
+    return ret;
+}
+
+static void coredump_bench(int argc, char **argv)
+{
+    struct coredump_stat raw, lz;
+    rt_uint32_t include = COREDUMP_INCLUDE_DEFAULT, raw_us, lz_us;
+
+    if (argc > 1) include = strtoul(argv[1], RT_NULL, 0) & ~COREDUMP_RAW;
+    if (include == 0)
+    {
+        rt_kprintf("Usage: coredump_bench [include]\n");
+        return;
+    }
+
+    coredump_install();
+    if (bench_dump(include | COREDUMP_RAW, &raw, &raw_us) != RT_EOK || bench_dump(include, &lz, &lz_us) != RT_EOK)
+    {
+        rt_kprintf("core dump failed\n");
+        return;
+    }
+
+    rt_kprintf("%d threads, %d segments, window %d\n", lz.threads, lz.segments, COREDUMP_LZ_WINDOW);
+    rt_kprintf("elf core      %8d bytes %8d us\n", raw.size, raw_us);
+    rt_kprintf("compressed    %8d bytes %8d us, %d.%d%%\n", lz.size, lz_us,
+               lz.size * 100 / lz.raw_size, lz.size * 1000 / lz.raw_size % 10);
+    rt_kprintf("throughput    %8d KB/s\n", lz_us ? (rt_uint32_t)((rt_uint64_t)lz.raw_size * 1000000 / 1024 / lz_us) : 0);
+}
+MSH_CMD_EXPORT(coredump_bench, core dump size and time);
+
+#endif /* defined(COREDUMP_USING_BENCH) && defined(RT_USING_FINSH) */
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#ifndef __COREDUMP_INTERNAL_H__
+#define __COREDUMP_INTERNAL_H__
+
+#include <rtthread.h>
+#include "coredump.h"
+
+/*
+ * The ELF core of a 32-bit ARM target: one PT_NOTE with a NT_PRSTATUS for each thread and the
+ * NT_AUXV, then one PT_LOAD for each memory segment. Only what the core needs is defined here,
+ * the core does not depend on the dynamic module loader.
+ */
+#define CORE_EI_NIDENT          16
+#define CORE_ET_CORE            4
+#define CORE_EM_ARM             40
+#define CORE_PT_LOAD            1
+#define CORE_PT_NOTE            4
+#define CORE_PF_RWX             7
+#define CORE_NT_PRSTATUS        1
+#define CORE_NT_AUXV            6
+
+struct core_ehdr
+{
+    rt_uint8_t  e_ident[CORE_EI_NIDENT];
+    rt_uint16_t e_type;
+    rt_uint16_t e_machine;
+    rt_uint32_t e_version;
+    rt_uint32_t e_entry;
+    rt_uint32_t e_phoff;
+    rt_uint32_t e_shoff;
+    rt_uint32_t e_flags;
+    rt_uint16_t e_ehsize;
+    rt_uint16_t e_phentsize;
+    rt_uint16_t e_phnum;
+    rt_uint16_t e_shentsize;
+    rt_uint16_t e_shnum;
+    rt_uint16_t e_shstrndx;
+};
+
+struct core_phdr
+{
+    rt_uint32_t p_type;
+    rt_uint32_t p_offset;
+    rt_uint32_t p_vaddr;
+    rt_uint32_t p_paddr;
+    rt_uint32_t p_filesz;
+    rt_uint32_t p_memsz;
+    rt_uint32_t p_flags;
+    rt_uint32_t p_align;
+};
+
+struct core_nhdr
+{
+    rt_uint32_t n_namesz;
+    rt_uint32_t n_descsz;
+    rt_uint32_t n_type;
+};
+
+/* r0 - r15 and the status register, as in the pr_reg of ARM */
+struct coredump_regs
+{
+    rt_uint32_t r[16];
+    rt_uint32_t psr;
+};
+
+/* struct elf_prstatus of 32-bit ARM, 148 bytes */
+struct core_prstatus
+{
+    rt_int32_t  si_signo;
+    rt_int32_t  si_code;
+    rt_int32_t  si_errno;
+    rt_int16_t  pr_cursig;
+    rt_uint16_t pad;
+    rt_uint32_t pr_sigpend;
+    rt_uint32_t pr_sighold;
+    rt_int32_t  pr_pid;
+    rt_int32_t  pr_ppid;
+    rt_int32_t  pr_pgrp;
+    rt_int32_t  pr_sid;
+    rt_uint32_t pr_times[8];            /* utime, stime, cutime, cstime */
+    rt_uint32_t pr_reg[18];             /* r0 - r15, cpsr, orig_r0 */
+    rt_int32_t  pr_fpvalid;
+};
+
+/*
+ * Compressed stream: an 8-byte header "RTCD", version, log2 of the window and two reserved
+ * bytes, then frames of a 16-bit raw length and a 16-bit compressed length, little endian,
+ * followed by the data. A compressed length of 0 is a stored frame of raw length bytes, a frame
+ * of two zero lengths ends the stream with the 32-bit raw size and CRC-32 of the ELF core.
+ *
+ * The data of a frame is a LZ4 style sequence of tokens: the high nibble is the literal count,
+ * the low nibble the match length minus 4, 15 in either continues with bytes added until one
+ * is below 255. The literals follow, then a 16-bit offset back into the output, at most the
+ * window, and the rest of the match length. The last token of a frame has only literals.
+ */
+#define CORE_STREAM_MAGIC       "RTCD"
+#define CORE_STREAM_VERSION     1
+#define CORE_LZ_MIN_MATCH       4
+
+#ifndef COREDUMP_LZ_HASH_BITS
+#define COREDUMP_LZ_HASH_BITS   11
+#endif
+
+#if (COREDUMP_LZ_WINDOW & (COREDUMP_LZ_WINDOW - 1)) != 0
+#error "COREDUMP_LZ_WINDOW must be a power of 2, the stream header stores its log2"
+#endif
+
+#define CORE_LZ_BOUND(n)        ((n) + (n) / 255 + 16)
+
+struct core_stream
+{
+    struct coredump_sink *sink;
+    rt_bool_t compress;
+    int error;
+
+    rt_uint32_t raw_size;
+    rt_uint32_t crc;
+    rt_uint16_t history;                /* bytes before the frame in window */
+    rt_uint16_t fill;                   /* bytes of the frame */
+
+    rt_uint16_t hash[1 << COREDUMP_LZ_HASH_BITS];
+    rt_uint8_t window[2 * COREDUMP_LZ_WINDOW];
+    rt_uint8_t out[4 + CORE_LZ_BOUND(COREDUMP_LZ_WINDOW)];
+};
+
+int core_stream_open(struct core_stream *stream, struct coredump_sink *sink, rt_bool_t compress);
+int core_stream_write(struct core_stream *stream, const void *buf, rt_size_t size);
+int core_stream_close(struct core_stream *stream);
+
+/* the port, weak defaults in coredump.c save no registers */
+rt_bool_t coredump_port_fault_regs(void *context, struct coredump_regs *regs, rt_ubase_t *stack_top);
+void coredump_port_self_regs(struct coredump_regs *regs);
+void coredump_port_thread_regs(rt_thread_t thread, struct coredump_regs *regs);
+rt_uint32_t coredump_port_hwcap(void);
+void coredump_port_regions(void);
+
+#endif /* __COREDUMP_INTERNAL_H__ */
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ * 2026-10-18     RT-Thread    RAM sink for the core of a fault
+ */
+
+#include <rtthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef RT_USING_DFS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef RT_USING_FAL
+#include <fal.h>
+#endif
+#ifdef RT_USING_SAL
+#include <sys/socket.h>
+#include <netdb.h>
+#endif
+
+#include "coredump_internal.h"
+
+/*
+ * The sinks of the core. A buffer in RAM is the only one for the exception handler. A FAL
+ * partition is erased a block ahead of the writes, its flash driver takes mutexes as a file or
+ * a socket does, they are for the snapshots of the coredump command or a core saved later from
+ * a thread.
+ */
+
+static int core_ram_open(struct coredump_sink *sink)
+{
+    return 0;
+}
+
+static int core_ram_write(struct coredump_sink *sink, const void *buf, rt_size_t size)
+{
+    if (sink->offset + size > sink->limit)
+        size = sink->limit - sink->offset;
+    rt_memcpy((rt_uint8_t *)sink->user_data + sink->offset, buf, size);
+    sink->offset += size;
+
+    return (int)size;
+}
+
+static void core_ram_close(struct coredump_sink *sink)
+{
+}
+
+void coredump_sink_ram_init(struct coredump_sink *sink, void *buffer, rt_size_t size)
+{
+    rt_memset(sink, 0, sizeof(*sink));
+    sink->open = core_ram_open;
+    sink->write = core_ram_write;
+    sink->close = core_ram_close;
+    sink->user_data = buffer;
+    sink->limit = size;
+}
+
+#ifdef RT_USING_DFS
+static int core_file_open(struct coredump_sink *sink)
+{
+    sink->fd = open((const char *)sink->user_data, O_WRONLY | O_CREAT | O_TRUNC);
+
+    return sink->fd >= 0 ? 0 : -1;
+}
+
+static int core_file_write(struct coredump_sink *sink, const void *buf, rt_size_t size)
+{
+    rt_size_t off = 0;
+    int len;
+
+    while (off < size)
+    {
+        len = write(sink->fd, (const rt_uint8_t *)buf + off, size - off);
+        if (len <= 0)
+            break;
+        off += len;
+    }
+    sink->offset += off;
+
+    return (int)off;
+}
+
+static void core_file_close(struct coredump_sink *sink)
+{
+    if (sink->fd >= 0)
+    {
+        close(sink->fd);
+        sink->fd = -1;
+    }
+}
+
+void coredump_sink_file_init(struct coredump_sink *sink, const char *path)
+{
+    rt_memset(sink, 0, sizeof(*sink));
+    sink->open = core_file_open;
+    sink->write = core_file_write;
+    sink->close = core_file_close;
+    sink->user_data = path;
+    sink->fd = -1;
+}
+#endif /* RT_USING_DFS */
+
+#ifdef RT_USING_FAL
+static int core_fal_open(struct coredump_sink *sink)
+{
+    sink->erased = 0;
+
+    return 0;
+}
+
+static int core_fal_write(struct coredump_sink *sink, const void *buf, rt_size_t size)
+{
+    const struct fal_partition *part = (const struct fal_partition *)sink->user_data;
+    const struct fal_flash_dev *flash = fal_flash_device_find(part->flash_name);
+
+    if (flash == RT_NULL || sink->offset + size > part->len)
+        return 0;
+
+    while (sink->erased < sink->offset + size)
+    {
+        if (fal_partition_erase(part, sink->erased, flash->blk_size) < 0)
+            return 0;
+        sink->erased += flash->blk_size;
+    }
+    if (fal_partition_write(part, sink->offset, (const uint8_t *)buf, size) < 0)
+        return 0;
+    sink->offset += size;
+
+    return (int)size;
+}
+
+static void core_fal_close(struct coredump_sink *sink)
+{
+}
+
+int coredump_sink_fal_init(struct coredump_sink *sink, const char *partition)
+{
+    const struct fal_partition *part = fal_partition_find(partition);
+
+    if (part == RT_NULL)
+        return -RT_ERROR;
+
+    rt_memset(sink, 0, sizeof(*sink));
+    sink->open = core_fal_open;
+    sink->write = core_fal_write;
+    sink->close = core_fal_close;
+    sink->user_data = part;
+
+    return RT_EOK;
+}
+#endif /* RT_USING_FAL */
+
+#ifdef RT_USING_SAL
+static int core_socket_open(struct coredump_sink *sink)
+{
+    const char *target = (const char *)sink->user_data;
+    const char *colon = strrchr(target, ':');
+    char host[64];
+    struct sockaddr_in addr;
+    struct hostent *entry;
+
+    if (colon == RT_NULL || colon == target || (rt_size_t)(colon - target) >= sizeof(host))
+        return -1;
+    rt_memcpy(host, target, colon - target);
+    host[colon - target] = '\0';
+
+    entry = gethostbyname(host);
+    if (entry == RT_NULL)
+        return -1;
+
+    sink->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (sink->fd < 0)
+        return -1;
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)atoi(colon + 1));
+    addr.sin_addr = *((struct in_addr *)entry->h_addr);
+    if (connect(sink->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        closesocket(sink->fd);
+        sink->fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+static int core_socket_write(struct coredump_sink *sink, const void *buf, rt_size_t size)
+{
+    rt_size_t off = 0;
+    int len;
+
+    while (off < size)
+    {
+        len = send(sink->fd, (const rt_uint8_t *)buf + off, size - off, 0);
+        if (len <= 0)
+            break;
+        off += len;
+    }
+    sink->offset += off;
+
+    return (int)off;
+}
+
+static void core_socket_close(struct coredump_sink *sink)
+{
+    if (sink->fd >= 0)
+    {
+        closesocket(sink->fd);
+        sink->fd = -1;
+    }
+}
+
+int coredump_sink_socket_init(struct coredump_sink *sink, const char *target)
+{
+    if (strchr(target, ':') == RT_NULL)
+        return -RT_EINVAL;
+
+    rt_memset(sink, 0, sizeof(*sink));
+    sink->open = core_socket_open;
+    sink->write = core_socket_write;
+    sink->close = core_socket_close;
+    sink->user_data = target;
+    sink->fd = -1;
+
+    return RT_EOK;
+}
+#endif /* RT_USING_SAL */
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+#include "coredump_internal.h"
+
+/*
+ * The compressor keeps the last window of the core in front of the frame it fills, matches of
+ * a frame reach back into the previous one. It runs in the exception handler: everything is
+ * in the stream, which is static, and one frame is compressed at a time, so the sink sees the
+ * core in pieces of at most one window.
+ */
+
+static const rt_uint32_t crc32_nibble[16] =
+{
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+};
+
+static rt_uint32_t core_crc32(rt_uint32_t crc, const rt_uint8_t *buf, rt_size_t size)
+{
+    while (size--)
+    {
+        crc ^= *buf++;
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0xf];
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0xf];
+    }
+
+    return crc;
+}
+
+rt_inline void core_put16(rt_uint8_t *p, rt_uint32_t value)
+{
+    p[0] = (rt_uint8_t)value;
+    p[1] = (rt_uint8_t)(value >> 8);
+}
+
+rt_inline rt_uint32_t core_read32(const rt_uint8_t *p)
+{
+    return p[0] | (rt_uint32_t)p[1] << 8 | (rt_uint32_t)p[2] << 16 | (rt_uint32_t)p[3] << 24;
+}
+
+rt_inline rt_uint32_t core_lz_hash(const rt_uint8_t *p)
+{
+    return (core_read32(p) * 2654435761u) >> (32 - COREDUMP_LZ_HASH_BITS);
+}
+
+static rt_uint8_t *core_lz_length(rt_uint8_t *op, rt_size_t length)
+{
+    while (length >= 255)
+    {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (rt_uint8_t)length;
+
+    return op;
+}
+
+/* one token, a match length of 0 for the literals that end the frame */
+static rt_uint8_t *core_lz_sequence(rt_uint8_t *op, const rt_uint8_t *literal, rt_size_t literals,
+                                    rt_size_t offset, rt_size_t length)
+{
+    rt_uint8_t *token = op++;
+
+    *token = (rt_uint8_t)((literals < 15 ? literals : 15) << 4);
+    if (literals >= 15)
+        op = core_lz_length(op, literals - 15);
+    rt_memcpy(op, literal, literals);
+    op += literals;
+
+    if (length)
+    {
+        length -= CORE_LZ_MIN_MATCH;
+        *token |= (rt_uint8_t)(length < 15 ? length : 15);
+        core_put16(op, offset);
+        op += 2;
+        if (length >= 15)
+            op = core_lz_length(op, length - 15);
+    }
+
+    return op;
+}
+
+static rt_size_t core_lz_compress(struct core_stream *stream, rt_uint8_t *out)
+{
+    const rt_uint8_t *base = stream->window;
+    rt_size_t end = stream->history + stream->fill;
+    rt_size_t p = stream->history, anchor = p, candidate, length;
+    rt_uint32_t h, misses = 0;
+    rt_uint8_t *op = out;
+
+    while (p + CORE_LZ_MIN_MATCH <= end)
+    {
+        h = core_lz_hash(base + p);
+        candidate = stream->hash[h];
+        stream->hash[h] = (rt_uint16_t)(p + 1);
+
+        if (candidate && p - (candidate - 1) <= COREDUMP_LZ_WINDOW
+            && core_read32(base + candidate - 1) == core_read32(base + p))
+        {
+            candidate -= 1;
+            length = CORE_LZ_MIN_MATCH;
+            while (p + length < end && base[candidate + length] == base[p + length])
+                length++;
+
+            op = core_lz_sequence(op, base + anchor, p - anchor, p - candidate, length);
+            p += length;
+            anchor = p;
+            misses = 0;
+        }
+        else
+        {
+            /* step faster through data that does not compress */
+            p += 1 + (misses++ >> 6);
+        }
+    }
+
+    return core_lz_sequence(op, base + anchor, end - anchor, 0, 0) - out;
+}
+
+static int core_sink_write(struct core_stream *stream, const void *buf, rt_size_t size)
+{
+    if (stream->error == 0 && stream->sink->write(stream->sink, buf, size) != (int)size)
+        stream->error = -RT_EIO;
+
+    return stream->error;
+}
+
+/* compress the frame, then slide the window over it */
+static int core_stream_flush(struct core_stream *stream)
+{
+    rt_size_t size, shift, index;
+
+    if (stream->fill == 0)
+        return stream->error;
+
+    size = core_lz_compress(stream, stream->out + 4);
+    core_put16(stream->out, stream->fill);
+    if (size < stream->fill)
+    {
+        core_put16(stream->out + 2, size);
+        core_sink_write(stream, stream->out, 4 + size);
+    }
+    else
+    {
+        core_put16(stream->out + 2, 0);
+        core_sink_write(stream, stream->out, 4);
+        core_sink_write(stream, stream->window + stream->history, stream->fill);
+    }
+
+    stream->history += stream->fill;
+    stream->fill = 0;
+    if (stream->history > COREDUMP_LZ_WINDOW)
+    {
+        shift = stream->history - COREDUMP_LZ_WINDOW;
+        rt_memmove(stream->window, stream->window + shift, COREDUMP_LZ_WINDOW);
+        for (index = 0; index < (1 << COREDUMP_LZ_HASH_BITS); index++)
+            stream->hash[index] = stream->hash[index] > shift ? (rt_uint16_t)(stream->hash[index] - shift) : 0;
+        stream->history = COREDUMP_LZ_WINDOW;
+    }
+
+    return stream->error;
+}
+
+int core_stream_open(struct core_stream *stream, struct coredump_sink *sink, rt_bool_t compress)
+{
+    rt_uint8_t header[8] = CORE_STREAM_MAGIC;
+
+    stream->sink = sink;
+    stream->compress = compress;
+    stream->error = 0;
+    stream->raw_size = 0;
+    stream->crc = 0xffffffff;
+    stream->history = 0;
+    stream->fill = 0;
+
+    sink->offset = 0;
+    if (sink->open(sink) != 0)
+        return -RT_EIO;
+
+    if (compress)
+    {
+        rt_memset(stream->hash, 0, sizeof(stream->hash));
+        header[4] = CORE_STREAM_VERSION;
+        header[5] = (rt_uint8_t)(__rt_ffs(COREDUMP_LZ_WINDOW) - 1);
+        core_sink_write(stream, header, sizeof(header));
+    }
+
+    return stream->error;
+}
+
+int core_stream_write(struct core_stream *stream, const void *buf, rt_size_t size)
+{
+    const rt_uint8_t *data = (const rt_uint8_t *)buf;
+    rt_size_t length;
+
+    stream->raw_size += size;
+    stream->crc = core_crc32(stream->crc, data, size);
+    if (!stream->compress)
+        return core_sink_write(stream, buf, size);
+
+    while (size && stream->error == 0)
+    {
+        length = COREDUMP_LZ_WINDOW - stream->fill;
+        if (length > size)
+            length = size;
+        rt_memcpy(stream->window + stream->history + stream->fill, data, length);
+        stream->fill += length;
+        data += length;
+        size -= length;
+
+        if (stream->fill == COREDUMP_LZ_WINDOW)
+            core_stream_flush(stream);
+    }
+
+    return stream->error;
+}
+
+int core_stream_close(struct core_stream *stream)
+{
+    rt_uint8_t trailer[12];
+
+    if (stream->compress)
+    {
+        core_stream_flush(stream);
+        rt_memset(trailer, 0, sizeof(trailer));
+        core_put16(trailer + 4, stream->raw_size);
+        core_put16(trailer + 6, stream->raw_size >> 16);
+        core_put16(trailer + 8, ~stream->crc);
+        core_put16(trailer + 10, ~stream->crc >> 16);
+        core_sink_write(stream, trailer, sizeof(trailer));
+    }
+    stream->sink->close(stream->sink);
+
+    return stream->error;
+}
@@ -0,0 +1,150 @@
+import os
+import sys
+import socket
+import struct
+import getopt
+import zlib
+
+# the compressed core stream of coredump_stream.c
+MAGIC = b'RTCD'
+VERSION = 1
+
+def inflate_frame(data, out, window):
+    pos = 0
+    end = len(data)
+
+    while True:
+        token = data[pos]
+        pos += 1
+
+        literals = token >> 4
+        if literals == 15:
+            while True:
+                byte = data[pos]
+                pos += 1
+                literals += byte
+                if byte != 255:
+                    break
+        out += data[pos:pos + literals]
+        pos += literals
+        if pos >= end:
+            break
+
+        (offset,) = struct.unpack_from('<H', data, pos)
+        pos += 2
+        length = (token & 0xf) + 4
+        if (token & 0xf) == 15:
+            while True:
+                byte = data[pos]
+                pos += 1
+                length += byte
+                if byte != 255:
+                    break
+        if offset == 0 or offset > window or offset > len(out):
+            raise ValueError('bad match offset %d' % offset)
+
+        start = len(out) - offset
+        if offset >= length:
+            out += out[start:start + length]
+        else:
+            # the match overlaps what it writes
+            for index in range(length):
+                out.append(out[start + index])
+
+def inflate(data):
+    if data[:4] != MAGIC:
+        # a plain ELF core
+        return data, True
+    if data[4] != VERSION:
+        raise ValueError('unknown version %d' % data[4])
+
+    window = 1 << data[5]
+    out = bytearray()
+    pos = 8
+
+    while pos + 4 <= len(data):
+        (raw, size) = struct.unpack_from('<HH', data, pos)
+        pos += 4
+        if raw == 0 and size == 0:
+            (total, crc) = struct.unpack_from('<II', data, pos)
+            if total != len(out) or crc != (zlib.crc32(bytes(out)) & 0xffffffff):
+                print('core of %d bytes does not match the stream' % len(out))
+                return out, False
+            return out, True
+
+        if size == 0:
+            out += data[pos:pos + raw]
+            pos += raw
+        else:
+            before = len(out)
+            inflate_frame(data[pos:pos + size], out, window)
+            pos += size
+            if len(out) - before != raw:
+                raise ValueError('frame of %d bytes instead of %d' % (len(out) - before, raw))
+
+    print('stream truncated after %d bytes of core' % len(out))
+    return out, False
+
+def receive(port):
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(('', port))
+    server.listen(1)
+    print('waiting for the core on port %d' % port)
+
+    conn, addr = server.accept()
+    print('core from %s:%d' % addr)
+    data = b''
+    while True:
+        chunk = conn.recv(65536)
+        if not chunk:
+            break
+        data += chunk
+    conn.close()
+    server.close()
+
+    return data
+
+def Usage():
+    print('Usage: coredump_inflate [-i core_stream | -p port] [-o core_elf]')
+    print('    the input is a file written by the file sink, a read back FAL partition or,')
+    print('    with -p, what the socket sink sends to the port')
+    exit(0)
+
+if __name__ == '__main__':
+    print('Core Dump Inflate')
+
+    input_file = None
+    output_file = 'core.elf'
+    port = 0
+
+    try:
+        opts,args = getopt.getopt(sys.argv[1:], "hi:o:p:", ["help", "input", "output", "port"])
+    except Exception as e:
+        print(e)
+        Usage()
+
+    for opt,arg in opts:
+        if opt in ('-h'):
+            Usage()
+        elif opt in ('-i'):
+            input_file = arg
+        elif opt in ('-o'):
+            output_file = arg
+        elif opt in ('-p'):
+            port = int(arg)
+
+    if port:
+        data = receive(port)
+    elif input_file:
+        with open(input_file, 'rb') as f:
+            data = f.read()
+    else:
+        Usage()
+
+    core, complete = inflate(data)
+    with open(output_file, 'wb') as f:
+        f.write(core)
+    print('%d bytes of stream, %d bytes of core in %s' % (len(data), len(core), output_file))
+    if not complete:
+        exit(1)
@@ -7,6 +7,7 @@
  * Date           Author      Notes
  * 2018/08/29     Bernard     first version
  * 2021/04/23     chunyexixiaoyu    distinguish 32-bit and 64-bit
+ * 2026-10-18     RT-Thread   split the shared object loader for the streaming loader
  */
 
 #include "dlmodule.h"
@@ -16,68 +17,60 @@
 #define DBG_LVL    DBG_INFO
 #include <rtdbg.h>          // must after of DEBUG_ENABLE or some other options
 
-rt_err_t dlmodule_load_shared_object(struct rt_dlmodule* module, void *module_ptr)
+/* allocate the zeroed image for the PT_LOAD segments of a shared object */
+rt_err_t dlmodule_shared_layout(struct rt_dlmodule* module, Elf_Phdr *phdrs, rt_ubase_t phnum)
 {
-    rt_bool_t linked   = RT_FALSE;
     rt_ubase_t  index, module_size = 0;
     Elf_Addr vstart_addr, vend_addr;
     rt_bool_t has_vstart;
 
-    RT_ASSERT(module_ptr != RT_NULL);
-
-    if (rt_memcmp(elf_module->e_ident, RTMMAG, SELFMAG) == 0)
-    {
-        /* rtmlinker finished */
-        linked = RT_TRUE;
-    }
-
     /* get the ELF image size */
     has_vstart = RT_FALSE;
     vstart_addr = vend_addr = RT_NULL;
-    for (index = 0; index < elf_module->e_phnum; index++)
+    for (index = 0; index < phnum; index++)
     {
-        if (phdr[index].p_type != PT_LOAD)
+        if (phdrs[index].p_type != PT_LOAD)
             continue;
 
-        LOG_D("LOAD segment: %d, 0x%p, 0x%08x", index, phdr[index].p_vaddr, phdr[index].p_memsz);
+        LOG_D("LOAD segment: %d, 0x%p, 0x%08x", index, phdrs[index].p_vaddr, phdrs[index].p_memsz);
 
-        if (phdr[index].p_memsz < phdr[index].p_filesz)
+        if (phdrs[index].p_memsz < phdrs[index].p_filesz)
         {
             rt_kprintf("invalid elf: segment %d: p_memsz: %d, p_filesz: %d\n",
-                       index, phdr[index].p_memsz, phdr[index].p_filesz);
-            return RT_NULL;
+                       index, phdrs[index].p_memsz, phdrs[index].p_filesz);
+            return -RT_ERROR;
         }
         if (!has_vstart)
         {
-            vstart_addr = phdr[index].p_vaddr;
-            vend_addr = phdr[index].p_vaddr + phdr[index].p_memsz;
+            vstart_addr = phdrs[index].p_vaddr;
+            vend_addr = phdrs[index].p_vaddr + phdrs[index].p_memsz;
             has_vstart = RT_TRUE;
             if (vend_addr < vstart_addr)
             {
                 LOG_E("invalid elf: segment %d: p_vaddr: %d, p_memsz: %d\n",
-                           index, phdr[index].p_vaddr, phdr[index].p_memsz);
-                return RT_NULL;
+                           index, phdrs[index].p_vaddr, phdrs[index].p_memsz);
+                return -RT_ERROR;
             }
         }
         else
         {
-            if (phdr[index].p_vaddr < vend_addr)
+            if (phdrs[index].p_vaddr < vend_addr)
             {
                 LOG_E("invalid elf: segment should be sorted and not overlapped\n");
-                return RT_NULL;
+                return -RT_ERROR;
             }
-            if (phdr[index].p_vaddr > vend_addr + 16)
+            if (phdrs[index].p_vaddr > vend_addr + 16)
             {
                 /* There should not be too much padding in the object files. */
                 LOG_W("warning: too much padding before segment %d", index);
             }
 
-            vend_addr = phdr[index].p_vaddr + phdr[index].p_memsz;
-            if (vend_addr < phdr[index].p_vaddr)
+            vend_addr = phdrs[index].p_vaddr + phdrs[index].p_memsz;
+            if (vend_addr < phdrs[index].p_vaddr)
             {
                 LOG_E("invalid elf: "
                            "segment %d address overflow\n", index);
-                return RT_NULL;
+                return -RT_ERROR;
             }
         }
     }
@@ -104,27 +97,176 @@ rt_err_t dlmodule_load_shared_object(struct rt_dlmodule* module, void *module_pt
 
     /* zero all space */
     rt_memset(module->mem_space, 0, module_size);
+
+    return RT_EOK;
+}
+
+/*
+ * Relocate a table of relocations of a shared object, against the symbols of the module or the
+ * kernel. The values are also appended to fixups when it is given, a later load of the same
+ * file applies them without the symbol tables.
+ */
+rt_err_t dlmodule_shared_relocate(struct rt_dlmodule* module, Elf_Rel *rel, rt_ubase_t nr_reloc,
+                                  Elf_Sym *symtab, rt_uint8_t *strtab, rt_bool_t linked,
+                                  struct dlmodule_fixups *fixups)
+{
+    rt_ubase_t i;
+    rt_bool_t unsolved = RT_FALSE;
+
+    /* relocate every items */
+    for (i = 0; i < nr_reloc; i ++)
+    {
+        #if (defined(__arm__) || defined(__i386__) || (__riscv_xlen == 32))
+        Elf_Sym *sym = &symtab[ELF32_R_SYM(rel->r_info)];
+        #elif (defined(__aarch64__) || defined(__x86_64__) || (__riscv_xlen == 64))
+        Elf_Sym *sym = &symtab[ELF64_R_SYM(rel->r_info)];
+        #endif
+        LOG_D("relocate symbol %s shndx %d", strtab + sym->st_name, sym->st_shndx);
+
+        if ((sym->st_shndx != SHT_NULL) ||(ELF_ST_BIND(sym->st_info) == STB_LOCAL))
+        {
+            Elf_Addr addr;
+
+            addr = (Elf_Addr)(module->mem_space + sym->st_value - module->vstart_addr);
+            dlmodule_relocate(module, rel, addr);
+            dlmodule_fixup_add(fixups, rel, sym->st_value - module->vstart_addr, RT_TRUE);
+        }
+        else if (!linked)
+        {
+            Elf_Addr addr;
+
+            LOG_D("relocate symbol: %s", strtab + sym->st_name);
+            /* need to resolve symbol in kernel symbol table */
+            addr = dlmodule_symbol_find((const char *)(strtab + sym->st_name));
+            if (addr == 0)
+            {
+                LOG_E("Module: can't find %s in kernel symbol table", strtab + sym->st_name);
+                unsolved = RT_TRUE;
+            }
+            else
+            {
+                dlmodule_relocate(module, rel, addr);
+                dlmodule_fixup_add(fixups, rel, addr, RT_FALSE);
+            }
+        }
+        rel ++;
+    }
+
+    return unsolved ? -RT_ERROR : RT_EOK;
+}
+
+/* build the table of the exported functions and read the thread parameters of a module */
+rt_err_t dlmodule_shared_symtab(struct rt_dlmodule* module, Elf_Sym *symtab, rt_ubase_t nr_sym, rt_uint8_t *strtab)
+{
+    int i, count = 0;
+
+    for (i = 0; i < nr_sym; i++)
+    {
+        if ((ELF_ST_BIND(symtab[i].st_info) == STB_GLOBAL) &&
+            (ELF_ST_TYPE(symtab[i].st_info) == STT_FUNC))
+            count ++;
+    }
+
+    module->symtab = (struct rt_module_symtab *)rt_malloc
+                     (count * sizeof(struct rt_module_symtab));
+    if (count && module->symtab == RT_NULL)
+        return -RT_ENOMEM;
+    module->nsym = count;
+    for (i = 0, count = 0; i < nr_sym; i++)
+    {
+        rt_size_t length;
+
+        if ((ELF_ST_BIND(symtab[i].st_info) != STB_GLOBAL) ||
+            (ELF_ST_TYPE(symtab[i].st_info) != STT_FUNC))
+            continue;
+
+        length = rt_strlen((const char *)(strtab + symtab[i].st_name)) + 1;
+
+        module->symtab[count].addr =
+            (void *)(module->mem_space + symtab[i].st_value - module->vstart_addr);
+        module->symtab[count].name = rt_malloc(length);
+        rt_memset((void *)module->symtab[count].name, 0, length);
+        rt_memcpy((void *)module->symtab[count].name,
+                  strtab + symtab[i].st_name,
+                  length);
+        count ++;
+    }
+    dlmodule_symhash_build(&module->symhash, module->symtab, module->nsym);
+
+    /* get priority & stack size params*/
+    rt_uint32_t flag = 0;
+    rt_uint16_t priority;
+    rt_uint32_t stacksize;
+    for (i = 0; i < nr_sym; i++)
+    {
+        if (((flag & 0x01) == 0) &&
+            (rt_strcmp((const char *)(strtab + symtab[i].st_name), "dlmodule_thread_priority") == 0))
+        {
+            flag |= 0x01;
+            priority = *(rt_uint16_t*)(module->mem_space + symtab[i].st_value - module->vstart_addr);
+            if (priority < RT_THREAD_PRIORITY_MAX)
+            {
+                module->priority = priority;
+            }
+        }
+
+        if (((flag & 0x02) == 0) &&
+            (rt_strcmp((const char *)(strtab + symtab[i].st_name), "dlmodule_thread_stacksize") == 0))
+        {
+            flag |= 0x02;
+            stacksize = *(rt_uint32_t*)(module->mem_space + symtab[i].st_value - module->vstart_addr);
+            if ((stacksize < 2048) || (stacksize > 1024 * 32))
+            {
+                module->stack_size = stacksize;
+            }
+        }
+
+        if ((flag & 0x03) == 0x03)
+        {
+            break;
+        }
+    }
+
+    return RT_EOK;
+}
+
+rt_err_t dlmodule_load_shared_object(struct rt_dlmodule* module, void *module_ptr)
+{
+    rt_bool_t linked   = RT_FALSE;
+    rt_ubase_t  index;
+    rt_err_t ret;
+
+    RT_ASSERT(module_ptr != RT_NULL);
+
+    if (rt_memcmp(elf_module->e_ident, RTMMAG, SELFMAG) == 0)
+    {
+        /* rtmlinker finished */
+        linked = RT_TRUE;
+    }
+
+    ret = dlmodule_shared_layout(module, phdr, elf_module->e_phnum);
+    if (ret != RT_EOK)
+        return ret;
+
     for (index = 0; index < elf_module->e_phnum; index++)
     {
         if (phdr[index].p_type == PT_LOAD)
         {
-            rt_memcpy(module->mem_space + phdr[index].p_vaddr - vstart_addr,
+            rt_memcpy(module->mem_space + phdr[index].p_vaddr - module->vstart_addr,
                       (rt_uint8_t *)elf_module + phdr[index].p_offset,
                       phdr[index].p_filesz);
         }
     }
 
     /* set module entry */
-    module->entry = module->mem_space + elf_module->e_entry - vstart_addr;
+    module->entry = module->mem_space + elf_module->e_entry - module->vstart_addr;
 
     /* handle relocation section */
     for (index = 0; index < elf_module->e_shnum; index ++)
     {
-        rt_ubase_t i, nr_reloc;
         Elf_Sym *symtab;
         Elf_Rel *rel;
         rt_uint8_t *strtab;
-        static rt_bool_t unsolved = RT_FALSE;
         #if (defined(__arm__) || defined(__i386__) || (__riscv_xlen == 32))
         if (!IS_REL(shdr[index]))
             continue;
@@ -141,47 +283,11 @@ rt_err_t dlmodule_load_shared_object(struct rt_dlmodule* module, void *module_pt
                                shdr[shdr[index].sh_link].sh_offset);
         strtab = (rt_uint8_t *)module_ptr +
                  shdr[shdr[shdr[index].sh_link].sh_link].sh_offset;
-        nr_reloc = (rt_ubase_t)(shdr[index].sh_size / sizeof(Elf_Rel));
-
-        /* relocate every items */
-        for (i = 0; i < nr_reloc; i ++)
-        {
-            #if (defined(__arm__) || defined(__i386__) || (__riscv_xlen == 32))
-            Elf_Sym *sym = &symtab[ELF32_R_SYM(rel->r_info)];
-            #elif (defined(__aarch64__) || defined(__x86_64__) || (__riscv_xlen == 64))
-            Elf_Sym *sym = &symtab[ELF64_R_SYM(rel->r_info)];
-            #endif
-            LOG_D("relocate symbol %s shndx %d", strtab + sym->st_name, sym->st_shndx);
-
-            if ((sym->st_shndx != SHT_NULL) ||(ELF_ST_BIND(sym->st_info) == STB_LOCAL))
-            {
-                Elf_Addr addr;
 
-                addr = (Elf_Addr)(module->mem_space + sym->st_value - vstart_addr);
-                dlmodule_relocate(module, rel, addr);
-            }
-            else if (!linked)
-            {
-                Elf_Addr addr;
-
-                LOG_D("relocate symbol: %s", strtab + sym->st_name);
-                /* need to resolve symbol in kernel symbol table */
-                addr = dlmodule_symbol_find((const char *)(strtab + sym->st_name));
-                if (addr == 0)
-                {
-                    LOG_E("Module: can't find %s in kernel symbol table", strtab + sym->st_name);
-                    unsolved = RT_TRUE;
-                }
-                else
-                {
-                    dlmodule_relocate(module, rel, addr);
-                }
-            }
-            rel ++;
-        }
-
-        if (unsolved)
-            return -RT_ERROR;
+        ret = dlmodule_shared_relocate(module, rel, (rt_ubase_t)(shdr[index].sh_size / sizeof(Elf_Rel)),
+                                       symtab, strtab, linked, RT_NULL);
+        if (ret != RT_EOK)
+            return ret;
     }
 
     /* construct module symbol table */
@@ -198,76 +304,10 @@ rt_err_t dlmodule_load_shared_object(struct rt_dlmodule* module, void *module_pt
     /* found .dynsym section */
     if (index != elf_module->e_shnum)
     {
-        int i, count = 0;
-        Elf_Sym  *symtab = RT_NULL;
-        rt_uint8_t *strtab = RT_NULL;
-
-        symtab = (Elf_Sym *)((rt_uint8_t *)module_ptr + shdr[index].sh_offset);
-        strtab = (rt_uint8_t *)module_ptr + shdr[shdr[index].sh_link].sh_offset;
-
-        for (i = 0; i < shdr[index].sh_size / sizeof(Elf_Sym); i++)
-        {
-            if ((ELF_ST_BIND(symtab[i].st_info) == STB_GLOBAL) &&
-                (ELF_ST_TYPE(symtab[i].st_info) == STT_FUNC))
-                count ++;
-        }
-
-        module->symtab = (struct rt_module_symtab *)rt_malloc
-                         (count * sizeof(struct rt_module_symtab));
-        module->nsym = count;
-        for (i = 0, count = 0; i < shdr[index].sh_size / sizeof(Elf_Sym); i++)
-        {
-            rt_size_t length;
-
-            if ((ELF_ST_BIND(symtab[i].st_info) != STB_GLOBAL) ||
-                (ELF_ST_TYPE(symtab[i].st_info) != STT_FUNC))
-                continue;
-
-            length = rt_strlen((const char *)(strtab + symtab[i].st_name)) + 1;
-
-            module->symtab[count].addr =
-                (void *)(module->mem_space + symtab[i].st_value - module->vstart_addr);
-            module->symtab[count].name = rt_malloc(length);
-            rt_memset((void *)module->symtab[count].name, 0, length);
-            rt_memcpy((void *)module->symtab[count].name,
-                      strtab + symtab[i].st_name,
-                      length);
-            count ++;
-        }
-
-        /* get priority & stack size params*/
-        rt_uint32_t flag = 0;
-        rt_uint16_t priority;
-        rt_uint32_t stacksize;
-        for (i = 0; i < shdr[index].sh_size / sizeof(Elf_Sym); i++)
-        {
-            if (((flag & 0x01) == 0) &&
-                (rt_strcmp((const char *)(strtab + symtab[i].st_name), "dlmodule_thread_priority") == 0))
-            {
-                flag |= 0x01;
-                priority = *(rt_uint16_t*)(module->mem_space + symtab[i].st_value - module->vstart_addr);
-                if (priority < RT_THREAD_PRIORITY_MAX)
-                {
-                    module->priority = priority;
-                }
-            }
-
-            if (((flag & 0x02) == 0) &&
-                (rt_strcmp((const char *)(strtab + symtab[i].st_name), "dlmodule_thread_stacksize") == 0))
-            {
-                flag |= 0x02;
-                stacksize = *(rt_uint32_t*)(module->mem_space + symtab[i].st_value - module->vstart_addr);
-                if ((stacksize < 2048) || (stacksize > 1024 * 32))
-                {
-                    module->stack_size = stacksize;
-                }
-            }
-
-            if ((flag & 0x03) == 0x03)
-            {
-                break;
-            }
-        }
+        return dlmodule_shared_symtab(module,
+                                      (Elf_Sym *)((rt_uint8_t *)module_ptr + shdr[index].sh_offset),
+                                      shdr[index].sh_size / sizeof(Elf_Sym),
+                                      (rt_uint8_t *)module_ptr + shdr[shdr[index].sh_link].sh_offset);
     }
 
     return RT_EOK;
@@ -7,6 +7,7 @@
  * Date           Author          Notes
  * 2018/08/29     Bernard         first version
  * 2021/04/23     chunyexixiaoyu  distinguish 32-bit and 64-bit
+ * 2026-10-18     RT-Thread       add the streaming loader and the module cache
  */
 
 #ifndef DL_ELF_H__
@@ -597,8 +598,35 @@ typedef Elf64_Rela      Elf_Rel;
 typedef Elf64_Addr      Elf_Addr;
 #endif
 
+/* a relocation with its resolved value, as the module cache keeps it */
+struct dlmodule_fixup
+{
+    Elf_Rel rel;
+    Elf_Addr value;         /* offset in the image for a symbol of the module, else the address */
+    rt_uint8_t local;       /* value is an offset in the image */
+};
+
+struct dlmodule_fixups
+{
+    struct dlmodule_fixup *fixup;
+    rt_uint32_t count;
+    rt_uint32_t max;
+    rt_bool_t failed;       /* out of memory, the list is incomplete */
+};
+
 int dlmodule_relocate(struct rt_dlmodule *module, Elf_Rel *rel, Elf_Addr sym_val);
 rt_err_t dlmodule_load_shared_object(struct rt_dlmodule *module, void *module_ptr);
 rt_err_t dlmodule_load_relocated_object(struct rt_dlmodule *module, void *module_ptr);
 
+rt_err_t dlmodule_shared_layout(struct rt_dlmodule *module, Elf_Phdr *phdrs, rt_ubase_t phnum);
+rt_err_t dlmodule_shared_relocate(struct rt_dlmodule *module, Elf_Rel *rel, rt_ubase_t nr_reloc,
+                                  Elf_Sym *symtab, rt_uint8_t *strtab, rt_bool_t linked,
+                                  struct dlmodule_fixups *fixups);
+rt_err_t dlmodule_shared_symtab(struct rt_dlmodule *module, Elf_Sym *symtab, rt_ubase_t nr_sym, rt_uint8_t *strtab);
+
+void dlmodule_fixup_add(struct dlmodule_fixups *fixups, Elf_Rel *rel, Elf_Addr value, rt_bool_t local);
+rt_err_t dlmodule_load_shared_stream(struct rt_dlmodule *module, int fd, const char *path, int flags,
+                                     struct dlmodule_load_stat *stat);
+void dlmodule_cache_init(void);
+
 #endif
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Module load time and memory benchmark.
+ *
+ * The module is loaded and freed a number of times in each way of dlmodule_load_flags(): read
+ * as a whole, streamed, streamed with the cache of the relocations (the first load fills the
+ * cache, the rest use it) and in place from a memory mapped file system. The way the loader
+ * took, the time per load, the image and the peak of the memory the loader held are reported.
+ * The module_init and module_cleanup of the module run on each load.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#include "dlmodule.h"
+
+#if defined(DLMODULE_USING_BENCH) && defined(RT_USING_FINSH) && defined(RT_USING_POSIX_FS)
+
+#include <msh_bench.h>
+
+static const char *bench_mode(rt_uint32_t mode)
+{
+    switch (mode)
+    {
+    case DLMODULE_LOAD_BUFFER: return "buffer";
+    case DLMODULE_LOAD_STREAM: return "stream";
+    case DLMODULE_LOAD_MAPPED: return "mapped";
+    case DLMODULE_LOAD_CACHED: return "cached";
+    default: return "-";
+    }
+}
+
+static void bench_run(const char *path, int flags, rt_uint32_t rounds)
+{
+    struct rt_dlmodule *module;
+    struct dlmodule_load_stat stat;
+    rt_uint32_t i, t, us = 0;
+
+    for (i = 0; i < rounds; i++)
+    {
+        t = BENCH_CLOCK();
+        module = dlmodule_load_flags(path, flags);
+        t = BENCH_CLOCK() - t;
+        if (module == RT_NULL)
+        {
+            rt_kprintf("%-6s load failed\n", bench_mode(flags & ~DLMODULE_LOAD_STREAM));
+            return;
+        }
+        dlmodule_load_stat(&stat);
+        dlmodule_free(module);
+
+        us += (rt_uint32_t)(BENCH_CLOCK_NS(t) / 1000);
+    }
+
+    rt_kprintf("%-6s %10d us %10d %10d\n", bench_mode(stat.mode), us / rounds, stat.image, stat.peak);
+}
+
+static void dlmodule_bench(int argc, char **argv)
+{
+    rt_uint32_t rounds = 10;
+
+    if (argc > 2) rounds = strtoul(argv[2], RT_NULL, 0);
+    if (argc < 2 || rounds == 0)
+    {
+        rt_kprintf("Usage: dlmodule_bench <module> [rounds]\n");
+        return;
+    }
+
+    rt_kprintf("mode         load      image       peak\n");
+    bench_run(argv[1], DLMODULE_LOAD_BUFFER, rounds);
+    bench_run(argv[1], DLMODULE_LOAD_STREAM, rounds);
+#ifdef DLMODULE_USING_CACHE
+    /* the first load fills the cache */
+    bench_run(argv[1], DLMODULE_LOAD_STREAM | DLMODULE_LOAD_CACHED, 1);
+    bench_run(argv[1], DLMODULE_LOAD_STREAM | DLMODULE_LOAD_CACHED, rounds);
+#endif
+    bench_run(argv[1], DLMODULE_LOAD_MAPPED, rounds);
+}
+MSH_CMD_EXPORT(dlmodule_bench, module load time and memory);
+
+#endif /* defined(DLMODULE_USING_BENCH) && defined(RT_USING_FINSH) && defined(RT_USING_POSIX_FS) */
@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author      Notes
  * 2018/08/29     Bernard     first version
+ * 2026-10-18     RT-Thread   hash index of the kernel symbols
+ * 2026-10-18     RT-Thread   streamed, mapped and cached loads of the modules
  */
 
 #include <rthw.h>
@@ -18,8 +20,10 @@
 #include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <dfs_file.h>
 #endif
 
 #ifdef RT_USING_GDBSERVER
@@ -44,7 +48,9 @@ struct dlmodule_ids
 static struct dlmodule_ids mids;
 static struct rt_module_symtab *_rt_module_symtab_begin = RT_NULL;
 static struct rt_module_symtab *_rt_module_symtab_end   = RT_NULL;
+static struct dlmodule_symhash _rt_module_symhash;
 static void* load_address = RT_NULL;
+static struct dlmodule_load_stat _load_stat;
 
 #if defined(__IAR_SYSTEMS_ICC__) /* for IAR compiler */
     #pragma section="RTMSymTab"
@@ -179,6 +185,7 @@ static struct rt_dlmodule *dlmodule_new(void)
 rt_err_t dlmodule_free(struct rt_dlmodule* module)
 {
     int i;
+    rt_base_t level;
 
     RT_ASSERT(module != RT_NULL)
 
@@ -323,6 +330,13 @@ rt_err_t dlmodule_free(struct rt_dlmodule* module)
     {
         rt_free(module->symtab);
     }
+    dlmodule_symhash_free(&module->symhash);
+
+    /* a freed module is no longer found by its mid */
+    level = rt_hw_interrupt_disable();
+    if (mids.map[module->mid] == module)
+        mids.map[module->mid] = RT_NULL;
+    rt_hw_interrupt_enable(level);
 
     /* destory module */
     rt_free(module->mem_space);
@@ -552,16 +566,38 @@ static int _module_name2mid(const char* name)
 }
 
 struct rt_dlmodule* dlmodule_load(const char* path)
+{
+    return dlmodule_load_flags(path, DLMODULE_LOAD_ANY);
+}
+
+/**
+ * This function will load a module as one of the ways in flags allows. A file of a memory
+ * mapped file system is parsed in place, a shared object is read section by section, or from
+ * the relocations kept from an earlier load of it, and the rest is read to the heap as a whole.
+ *
+ * @param path the path of the module file
+ * @param flags the DLMODULE_LOAD_xxx ways the module may be loaded
+ *
+ * @return the module
+ */
+struct rt_dlmodule* dlmodule_load_flags(const char* path, int flags)
 {
 #ifdef RT_USING_POSIX_FS
     int fd = -1, length = 0;
+    rt_ubase_t addr = 0;
 #endif
     rt_uint8_t i = 0;
     rt_base_t level;
     rt_err_t ret = RT_EOK;
     rt_uint8_t *module_ptr = RT_NULL;
+    rt_bool_t mapped = RT_FALSE;
+    Elf_Ehdr ehdr;
+    struct dlmodule_load_stat stat;
     struct rt_dlmodule *module = RT_NULL;
 
+    rt_memset(&stat, 0, sizeof(stat));
+    rt_memset(&ehdr, 0, sizeof(ehdr));
+
     if(_is_dlmodule_load(path))
     {
         rt_kprintf("module [%s] has already been loaded!\n", path);
@@ -576,17 +612,45 @@ struct rt_dlmodule* dlmodule_load(const char* path)
         length = lseek(fd, 0, SEEK_END);
         lseek(fd, 0, SEEK_SET);
 
-        if (length == 0) goto __exit;
+        if (length < (int)sizeof(ehdr)) goto __exit;
+
+#ifdef RT_FIOGETADDR
+        /* a file of romfs in XIP flash is in memory already, its headers and tables are used there */
+        if ((flags & DLMODULE_LOAD_MAPPED) && ioctl(fd, RT_FIOGETADDR, &addr) == 0 &&
+            addr != 0 && (addr % sizeof(rt_ubase_t)) == 0)
+        {
+            module_ptr = (rt_uint8_t *)addr;
+            mapped = RT_TRUE;
+            stat.mode = DLMODULE_LOAD_MAPPED;
+        }
+        else
+#endif
+        if ((flags & (DLMODULE_LOAD_STREAM | DLMODULE_LOAD_CACHED)) &&
+            read(fd, &ehdr, sizeof(ehdr)) == sizeof(ehdr) && ehdr.e_type == ET_DYN)
+        {
+            /* a shared object is streamed from the file, see dlstream.c */
+        }
+        else if (flags & DLMODULE_LOAD_BUFFER)
+        {
+            lseek(fd, 0, SEEK_SET);
 
-        module_ptr = (uint8_t*) rt_malloc (length);
-        if (!module_ptr) goto __exit;
+            module_ptr = (uint8_t*) rt_malloc (length);
+            if (!module_ptr) goto __exit;
 
-        if (read(fd, module_ptr, length) != length)
-            goto __exit;
+            if (read(fd, module_ptr, length) != length)
+                goto __exit;
 
-        /* close file and release fd */
-        close(fd);
-        fd = -1;
+            stat.mode = DLMODULE_LOAD_BUFFER;
+            stat.peak = length;
+
+            /* close file and release fd */
+            close(fd);
+            fd = -1;
+        }
+        else
+        {
+            goto __exit;
+        }
     }
     else
     {
@@ -594,18 +658,19 @@ struct rt_dlmodule* dlmodule_load(const char* path)
     }
 #endif
 
-    if (!module_ptr) goto __exit;
+    if (module_ptr) rt_memcpy(&ehdr, module_ptr, sizeof(ehdr));
+    else if (ehdr.e_type != ET_DYN) goto __exit;
 
     /* check ELF header */
-    if (rt_memcmp(elf_module->e_ident, RTMMAG, SELFMAG) != 0 &&
-        rt_memcmp(elf_module->e_ident, ELFMAG, SELFMAG) != 0)
+    if (rt_memcmp(ehdr.e_ident, RTMMAG, SELFMAG) != 0 &&
+        rt_memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0)
     {
         rt_kprintf("Module: magic error\n");
         goto __exit;
     }
 
     /* check ELF class */
-    if ((elf_module->e_ident[EI_CLASS] != ELFCLASS32)&&(elf_module->e_ident[EI_CLASS] != ELFCLASS64))
+    if ((ehdr.e_ident[EI_CLASS] != ELFCLASS32)&&(ehdr.e_ident[EI_CLASS] != ELFCLASS64))
     {
         rt_kprintf("Module: ELF class error\n");
         goto __exit;
@@ -619,13 +684,18 @@ struct rt_dlmodule* dlmodule_load(const char* path)
 
     LOG_D("rt_module_load: %.*s", RT_NAME_MAX, module->parent.name);
 
-    if (elf_module->e_type == ET_REL)
+    if (ehdr.e_type == ET_REL)
     {
         ret = dlmodule_load_relocated_object(module, module_ptr);
     }
-    else if (elf_module->e_type == ET_DYN)
+    else if (ehdr.e_type == ET_DYN)
     {
-        ret = dlmodule_load_shared_object(module, module_ptr);
+#ifdef RT_USING_POSIX_FS
+        if (module_ptr == RT_NULL)
+            ret = dlmodule_load_shared_stream(module, fd, path, flags, &stat);
+        else
+#endif
+            ret = dlmodule_load_shared_object(module, module_ptr);
     }
     else
     {
@@ -637,7 +707,22 @@ struct rt_dlmodule* dlmodule_load(const char* path)
     if (ret != RT_EOK) goto __exit;
 
     /* release module data */
-    rt_free(module_ptr);
+    if (!mapped) rt_free(module_ptr);
+    module_ptr = RT_NULL;
+#ifdef RT_USING_POSIX_FS
+    if (fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+#endif
+
+    if (stat.mode != DLMODULE_LOAD_STREAM && stat.mode != DLMODULE_LOAD_CACHED)
+    {
+        stat.image = module->mem_size;
+        stat.peak += module->mem_size;
+    }
+    _load_stat = stat;
 
     /* set module initialization and cleanup function */
     module->init_func = dlsym(module, "module_init");
@@ -679,7 +764,7 @@ __exit:
 #ifdef RT_USING_POSIX_FS
     if (fd >= 0) close(fd);
 #endif
-    if (module_ptr) rt_free(module_ptr);
+    if (module_ptr && !mapped) rt_free(module_ptr);
     if (module) dlmodule_free(module);
 
     return RT_NULL;
@@ -885,11 +970,10 @@ rt_uint32_t dlmodule_symbol_find(const char *sym_str)
     /* find in kernel symbol table */
     struct rt_module_symtab *index;
 
-    for (index = _rt_module_symtab_begin; index != _rt_module_symtab_end; index ++)
-    {
-        if (rt_strcmp(index->name, sym_str) == 0)
-            return (rt_uint32_t)index->addr;
-    }
+    index = dlmodule_symhash_find(&_rt_module_symhash, _rt_module_symtab_begin,
+                                  _rt_module_symtab_end - _rt_module_symtab_begin, sym_str);
+    if (index != RT_NULL)
+        return (rt_uint32_t)index->addr;
 
     return 0;
 }
@@ -913,6 +997,14 @@ int rt_system_dlmodule_init(void)
     _rt_module_symtab_end   = __section_end("RTMSymTab");
 #endif
 
+    /* the kernel exports are fixed at link time, index them once */
+    dlmodule_symhash_build(&_rt_module_symhash, _rt_module_symtab_begin,
+                           _rt_module_symtab_end - _rt_module_symtab_begin);
+
+#ifdef RT_USING_POSIX_FS
+    dlmodule_cache_init();
+#endif
+
     rt_memset(mids.map, RT_NULL, RT_MID_NUM_MAX * sizeof(struct rt_dlmodule*));
     mids.last = 0;
 
@@ -942,6 +1034,16 @@ struct rt_dlmodule *dlmodule_find(const char *name)
 }
 RTM_EXPORT(dlmodule_find);
 
+/**
+ * This function will get how the last module was loaded.
+ *
+ * @param stat the load mode, image size and peak memory of the loader
+ */
+void dlmodule_load_stat(struct dlmodule_load_stat *stat)
+{
+    *stat = _load_stat;
+}
+
 #ifdef RT_USING_FINSH
 
 int list_symbols(void)
@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018/08/11     Bernard      the first version
+ * 2026-10-18     RT-Thread    add the hash index of the symbols
+ * 2026-10-18     RT-Thread    add the load modes and their statistics
  */
 
 #ifndef RT_DL_MODULE_H__
@@ -19,6 +21,14 @@ typedef void (*rt_dlmodule_init_func_t)(struct rt_dlmodule *module);
 typedef void (*rt_dlmodule_cleanup_func_t)(struct rt_dlmodule *module);
 typedef int  (*rt_dlmodule_entry_func_t)(int argc, char** argv);
 
+/* hash index of a symbol table */
+struct dlmodule_symhash
+{
+    rt_uint32_t mask;       /* number of buckets - 1 */
+    rt_uint16_t *bucket;    /* first symbol + 1 of a bucket, 0 for none */
+    rt_uint16_t *chain;     /* next symbol + 1 of the same bucket */
+};
+
 struct rt_dlmodule
 {
     struct rt_object parent;
@@ -54,6 +64,21 @@ struct rt_dlmodule
 
     rt_uint16_t nsym;       /* number of symbols in the module */
     struct rt_module_symtab *symtab;    /* module symbol table */
+    struct dlmodule_symhash symhash;    /* hash index of the symbol table */
+};
+
+/* how dlmodule_load_flags() may load a module, and how the last module was loaded */
+#define DLMODULE_LOAD_BUFFER    0x01    /* read the whole file to the heap */
+#define DLMODULE_LOAD_STREAM    0x02    /* read a shared object section by section */
+#define DLMODULE_LOAD_MAPPED    0x04    /* parse a file of a memory mapped file system in place */
+#define DLMODULE_LOAD_CACHED    0x08    /* apply the relocations kept from an earlier load */
+#define DLMODULE_LOAD_ANY       0x0f
+
+struct dlmodule_load_stat
+{
+    rt_uint32_t mode;       /* DLMODULE_LOAD_xxx */
+    rt_uint32_t image;      /* bytes of the module image */
+    rt_uint32_t peak;       /* bytes the loader held at most, with the image */
 };
 
 struct rt_dlmodule_ops
@@ -65,6 +90,9 @@ struct rt_dlmodule_ops
 struct rt_dlmodule *dlmodule_self(void);
 
 struct rt_dlmodule* dlmodule_load(const char* filename);
+struct rt_dlmodule* dlmodule_load_flags(const char* filename, int flags);
+void dlmodule_load_stat(struct dlmodule_load_stat *stat);
+rt_err_t dlmodule_free(struct rt_dlmodule *module);
 struct rt_dlmodule* dlmodule_exec(const char* pgname, int debug, const char* cmd, int length);
 void dlmodule_add_subthread(struct rt_dlmodule* module, rt_thread_t thread);
 
@@ -83,4 +111,10 @@ void dlmodule_delete(struct rt_dlmodule *module);
 struct rt_dlmodule *dlmodule_find(const char *name);
 rt_uint32_t dlmodule_symbol_find(const char *sym_str);
 
+rt_uint32_t dlmodule_symhash(const char *name);
+int dlmodule_symhash_build(struct dlmodule_symhash *index, struct rt_module_symtab *symtab, rt_size_t nsym);
+void dlmodule_symhash_free(struct dlmodule_symhash *index);
+struct rt_module_symtab *dlmodule_symhash_find(struct dlmodule_symhash *index, struct rt_module_symtab *symtab,
+                                               rt_size_t nsym, const char *name);
+
 #endif
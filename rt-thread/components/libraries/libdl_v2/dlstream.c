@@ -0,0 +1,536 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+
+#include "dlmodule.h"
+#include "dlelf.h"
+
+#ifdef RT_USING_POSIX_FS
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define DBG_TAG    "DLMD"
+#define DBG_LVL    DBG_INFO
+#include <rtdbg.h>          // must after of DEBUG_ENABLE or some other options
+
+/*
+ * Streaming loader of the shared objects.
+ *
+ * The file is not read as a whole: the program and section headers are read first, then each
+ * PT_LOAD segment straight into the module image, then the relocations in blocks of
+ * DLMODULE_STREAM_RELS against the dynamic symbol and string tables, which are the only parts of
+ * the file held while the module is relocated. The peak is the image and these tables instead of
+ * the image and the file.
+ *
+ * With DLMODULE_USING_CACHE the resolved relocations, the segments and the exported functions of
+ * a loaded file are kept, keyed by the path, size and time of the file. Loading the file again
+ * only reads its segments and applies the kept values, without the symbol tables and lookups.
+ * The image is not kept, its data is written by the module once it runs.
+ */
+
+#ifndef DLMODULE_STREAM_RELS
+#define DLMODULE_STREAM_RELS    64
+#endif
+
+struct dl_stream
+{
+    int fd;
+    rt_uint32_t held;                   /* bytes allocated by the loader now */
+    struct dlmodule_load_stat *stat;
+};
+
+static rt_err_t _stream_read(struct dl_stream *s, rt_off_t offset, void *buf, rt_size_t size)
+{
+    rt_size_t off = 0;
+    int len;
+
+    if (lseek(s->fd, offset, SEEK_SET) != offset)
+        return -RT_EIO;
+
+    while (off < size)
+    {
+        len = read(s->fd, (rt_uint8_t *)buf + off, size - off);
+        if (len <= 0)
+            return -RT_EIO;
+        off += len;
+    }
+
+    return RT_EOK;
+}
+
+static void _stream_hold(struct dl_stream *s, rt_size_t size)
+{
+    s->held += size;
+    if (s->held > s->stat->peak)
+        s->stat->peak = s->held;
+}
+
+static void *_stream_alloc(struct dl_stream *s, rt_size_t size)
+{
+    void *ptr = rt_malloc(size);
+
+    if (ptr != RT_NULL)
+        _stream_hold(s, size);
+
+    return ptr;
+}
+
+static void _stream_free(struct dl_stream *s, void *ptr, rt_size_t size)
+{
+    if (ptr != RT_NULL)
+    {
+        rt_free(ptr);
+        s->held -= size;
+    }
+}
+
+static void *_stream_read_alloc(struct dl_stream *s, rt_off_t offset, rt_size_t size)
+{
+    void *ptr = _stream_alloc(s, size);
+
+    if (ptr != RT_NULL && _stream_read(s, offset, ptr, size) != RT_EOK)
+    {
+        _stream_free(s, ptr, size);
+        ptr = RT_NULL;
+    }
+
+    return ptr;
+}
+
+/* allocate the image and read the PT_LOAD segments into it */
+static rt_err_t _stream_segments(struct dl_stream *s, struct rt_dlmodule *module, Elf_Phdr *ph, rt_ubase_t phnum)
+{
+    rt_ubase_t index;
+    rt_err_t ret;
+
+    ret = dlmodule_shared_layout(module, ph, phnum);
+    if (ret != RT_EOK)
+        return ret;
+    _stream_hold(s, module->mem_size);
+    s->stat->image = module->mem_size;
+
+    for (index = 0; index < phnum; index++)
+    {
+        if (ph[index].p_type != PT_LOAD || ph[index].p_filesz == 0)
+            continue;
+
+        ret = _stream_read(s, ph[index].p_offset,
+                           (rt_uint8_t *)module->mem_space + ph[index].p_vaddr - module->vstart_addr,
+                           ph[index].p_filesz);
+        if (ret != RT_EOK)
+            return ret;
+    }
+
+    return RT_EOK;
+}
+
+/* read the symbol table of section index and its string table, unless they are read already */
+static rt_err_t _stream_symbols(struct dl_stream *s, Elf_Shdr *sh, rt_ubase_t shnum, rt_ubase_t index,
+                                rt_ubase_t *loaded, Elf_Sym **sym, rt_uint8_t **str)
+{
+    if (*sym != RT_NULL && *loaded == index)
+        return RT_EOK;
+
+    if (*sym != RT_NULL)
+    {
+        _stream_free(s, *str, sh[sh[*loaded].sh_link].sh_size);
+        _stream_free(s, *sym, sh[*loaded].sh_size);
+        *sym = RT_NULL;
+        *str = RT_NULL;
+    }
+
+    if (index >= shnum || sh[index].sh_link >= shnum)
+        return -RT_ERROR;
+
+    *sym = (Elf_Sym *)_stream_read_alloc(s, sh[index].sh_offset, sh[index].sh_size);
+    *str = (rt_uint8_t *)_stream_read_alloc(s, sh[sh[index].sh_link].sh_offset, sh[sh[index].sh_link].sh_size);
+    if (*sym == RT_NULL || *str == RT_NULL)
+    {
+        if (*sym != RT_NULL)
+            _stream_free(s, *sym, sh[index].sh_size);
+        if (*str != RT_NULL)
+            _stream_free(s, *str, sh[sh[index].sh_link].sh_size);
+        *sym = RT_NULL;
+        *str = RT_NULL;
+        return -RT_ENOMEM;
+    }
+    *loaded = index;
+
+    return RT_EOK;
+}
+
+static rt_err_t _stream_load(struct dl_stream *s, struct rt_dlmodule *module, Elf_Ehdr *eh,
+                             struct dlmodule_fixups *fixups)
+{
+    Elf_Phdr *ph;
+    Elf_Shdr *sh;
+    Elf_Rel *rel;
+    Elf_Sym *sym = RT_NULL;
+    rt_uint8_t *str = RT_NULL;
+    rt_ubase_t index, loaded = 0, done, count, nr_reloc;
+    rt_bool_t linked;
+    rt_err_t ret = -RT_ENOMEM;
+
+    /* rtmlinker finished */
+    linked = rt_memcmp(eh->e_ident, RTMMAG, SELFMAG) == 0 ? RT_TRUE : RT_FALSE;
+
+    ph = (Elf_Phdr *)_stream_read_alloc(s, eh->e_phoff, eh->e_phnum * sizeof(Elf_Phdr));
+    sh = (Elf_Shdr *)_stream_read_alloc(s, eh->e_shoff, eh->e_shnum * sizeof(Elf_Shdr));
+    rel = (Elf_Rel *)_stream_alloc(s, DLMODULE_STREAM_RELS * sizeof(Elf_Rel));
+    if (ph == RT_NULL || sh == RT_NULL || rel == RT_NULL)
+        goto __exit;
+
+    ret = _stream_segments(s, module, ph, eh->e_phnum);
+    if (ret != RT_EOK)
+        goto __exit;
+
+    /* set module entry */
+    module->entry = (rt_dlmodule_entry_func_t)((rt_uint8_t *)module->mem_space + eh->e_entry - module->vstart_addr);
+
+    /* handle relocation section */
+    for (index = 0; index < eh->e_shnum; index ++)
+    {
+        #if (defined(__arm__) || defined(__i386__) || (__riscv_xlen == 32))
+        if (!IS_REL(sh[index]))
+            continue;
+        #elif (defined(__aarch64__) || defined(__x86_64__) || (__riscv_xlen == 64))
+        if (!IS_RELA(sh[index]))
+            continue;
+        #endif
+
+        /* .rel.dyn and .rel.plt share .dynsym, it is read once */
+        ret = _stream_symbols(s, sh, eh->e_shnum, sh[index].sh_link, &loaded, &sym, &str);
+        if (ret != RT_EOK)
+            goto __exit;
+
+        nr_reloc = (rt_ubase_t)(sh[index].sh_size / sizeof(Elf_Rel));
+        for (done = 0; done < nr_reloc; done += count)
+        {
+            count = nr_reloc - done;
+            if (count > DLMODULE_STREAM_RELS)
+                count = DLMODULE_STREAM_RELS;
+
+            ret = _stream_read(s, sh[index].sh_offset + done * sizeof(Elf_Rel), rel, count * sizeof(Elf_Rel));
+            if (ret != RT_EOK)
+                goto __exit;
+            ret = dlmodule_shared_relocate(module, rel, count, sym, str, linked, fixups);
+            if (ret != RT_EOK)
+                goto __exit;
+        }
+    }
+
+    /* construct module symbol table from .dynsym */
+    for (index = 0; index < eh->e_shnum; index ++)
+    {
+        if (sh[index].sh_type == SHT_DYNSYM)
+            break;
+    }
+    if (index != eh->e_shnum)
+    {
+        ret = _stream_symbols(s, sh, eh->e_shnum, index, &loaded, &sym, &str);
+        if (ret == RT_EOK)
+            ret = dlmodule_shared_symtab(module, sym, sh[index].sh_size / sizeof(Elf_Sym), str);
+    }
+
+__exit:
+    if (sym != RT_NULL)
+    {
+        _stream_free(s, str, sh[sh[loaded].sh_link].sh_size);
+        _stream_free(s, sym, sh[loaded].sh_size);
+    }
+    _stream_free(s, rel, DLMODULE_STREAM_RELS * sizeof(Elf_Rel));
+    _stream_free(s, sh, eh->e_shnum * sizeof(Elf_Shdr));
+    _stream_free(s, ph, eh->e_phnum * sizeof(Elf_Phdr));
+
+    return ret;
+}
+
+void dlmodule_fixup_add(struct dlmodule_fixups *fixups, Elf_Rel *rel, Elf_Addr value, rt_bool_t local)
+{
+    struct dlmodule_fixup *fixup;
+
+    if (fixups == RT_NULL || fixups->failed)
+        return;
+
+    if (fixups->count == fixups->max)
+    {
+        fixup = (struct dlmodule_fixup *)rt_realloc(fixups->fixup,
+                                                    (fixups->max ? fixups->max * 2 : 32) * sizeof(*fixup));
+        if (fixup == RT_NULL)
+        {
+            rt_free(fixups->fixup);
+            rt_memset(fixups, 0, sizeof(*fixups));
+            fixups->failed = RT_TRUE;
+            return;
+        }
+        fixups->fixup = fixup;
+        fixups->max = fixups->max ? fixups->max * 2 : 32;
+    }
+
+    fixup = &fixups->fixup[fixups->count++];
+    fixup->rel = *rel;
+    fixup->value = value;
+    fixup->local = local;
+}
+
+#ifdef DLMODULE_USING_CACHE
+#ifndef DLMODULE_CACHE_SIZE
+#define DLMODULE_CACHE_SIZE     16384
+#endif
+
+#define CACHE_ALIGN(size)       RT_ALIGN((size), 8)
+
+/* what a load of a file leaves for the next load of it, in one allocation */
+struct dlmodule_cache
+{
+    rt_list_t list;
+    rt_uint32_t bytes;                  /* size of the entry with its tables */
+    const char *path;
+    off_t size;
+    time_t mtime;
+
+    rt_ubase_t entry;                   /* offset of the entry in the image */
+    rt_uint16_t priority;
+    rt_uint32_t stack_size;
+
+    rt_uint16_t nload;
+    Elf_Phdr *load;                     /* the PT_LOAD segments */
+    rt_uint32_t nfixup;
+    struct dlmodule_fixup *fixup;
+    rt_uint16_t nsym;
+    struct rt_module_symtab *symtab;    /* addr is the offset in the image */
+};
+
+static rt_list_t _cache_list = RT_LIST_OBJECT_INIT(_cache_list);
+static struct rt_mutex _cache_lock;
+static rt_uint32_t _cache_bytes;
+
+static struct dlmodule_cache *_cache_find(const char *path, struct stat *st)
+{
+    struct dlmodule_cache *entry;
+
+    rt_list_for_each_entry(entry, &_cache_list, list)
+    {
+        if (entry->size == st->st_size && entry->mtime == st->st_mtime && rt_strcmp(entry->path, path) == 0)
+        {
+            /* the list is kept from the most to the least recently used */
+            rt_list_remove(&entry->list);
+            rt_list_insert_after(&_cache_list, &entry->list);
+            return entry;
+        }
+    }
+
+    return RT_NULL;
+}
+
+static void _cache_remove(struct dlmodule_cache *entry)
+{
+    rt_list_remove(&entry->list);
+    _cache_bytes -= entry->bytes;
+    rt_free(entry);
+}
+
+static void _cache_add(const char *path, struct stat *st, struct rt_dlmodule *module,
+                       Elf_Phdr *ph, rt_ubase_t phnum, struct dlmodule_fixups *fixups)
+{
+    struct dlmodule_cache *entry;
+    rt_uint32_t bytes, load_off, fixup_off, sym_off, str_off;
+    rt_ubase_t index, nload = 0;
+    rt_uint8_t *base;
+    char *str;
+
+    for (index = 0; index < phnum; index++)
+    {
+        if (ph[index].p_type == PT_LOAD)
+            nload++;
+    }
+
+    load_off = CACHE_ALIGN(sizeof(*entry));
+    fixup_off = CACHE_ALIGN(load_off + nload * sizeof(Elf_Phdr));
+    sym_off = CACHE_ALIGN(fixup_off + fixups->count * sizeof(struct dlmodule_fixup));
+    str_off = sym_off + module->nsym * sizeof(struct rt_module_symtab);
+    bytes = str_off + rt_strlen(path) + 1;
+    for (index = 0; index < module->nsym; index++)
+        bytes += rt_strlen(module->symtab[index].name) + 1;
+
+    if (bytes > DLMODULE_CACHE_SIZE)
+        return;
+    while (_cache_bytes + bytes > DLMODULE_CACHE_SIZE)
+        _cache_remove(rt_list_entry(_cache_list.prev, struct dlmodule_cache, list));
+
+    base = (rt_uint8_t *)rt_malloc(bytes);
+    if (base == RT_NULL)
+        return;
+
+    entry = (struct dlmodule_cache *)base;
+    entry->bytes = bytes;
+    entry->size = st->st_size;
+    entry->mtime = st->st_mtime;
+    entry->entry = (rt_uint8_t *)module->entry - (rt_uint8_t *)module->mem_space;
+    entry->priority = module->priority;
+    entry->stack_size = module->stack_size;
+
+    entry->nload = nload;
+    entry->load = (Elf_Phdr *)(base + load_off);
+    for (index = 0, nload = 0; index < phnum; index++)
+    {
+        if (ph[index].p_type == PT_LOAD)
+            entry->load[nload++] = ph[index];
+    }
+
+    entry->nfixup = fixups->count;
+    entry->fixup = (struct dlmodule_fixup *)(base + fixup_off);
+    rt_memcpy(entry->fixup, fixups->fixup, fixups->count * sizeof(struct dlmodule_fixup));
+
+    entry->nsym = module->nsym;
+    entry->symtab = (struct rt_module_symtab *)(base + sym_off);
+    str = (char *)(base + str_off);
+    entry->path = str;
+    rt_strcpy(str, path);
+    str += rt_strlen(path) + 1;
+    for (index = 0; index < module->nsym; index++)
+    {
+        entry->symtab[index].addr = (void *)((rt_uint8_t *)module->symtab[index].addr - (rt_uint8_t *)module->mem_space);
+        entry->symtab[index].name = str;
+        rt_strcpy(str, module->symtab[index].name);
+        str += rt_strlen(str) + 1;
+    }
+
+    rt_list_insert_after(&_cache_list, &entry->list);
+    _cache_bytes += bytes;
+}
+
+static rt_err_t _cache_apply(struct dl_stream *s, struct rt_dlmodule *module, struct dlmodule_cache *entry)
+{
+    struct dlmodule_fixup *fixup;
+    rt_uint32_t index;
+    rt_err_t ret;
+
+    ret = _stream_segments(s, module, entry->load, entry->nload);
+    if (ret != RT_EOK)
+        return ret;
+    module->entry = (rt_dlmodule_entry_func_t)((rt_uint8_t *)module->mem_space + entry->entry);
+
+    for (index = 0; index < entry->nfixup; index++)
+    {
+        fixup = &entry->fixup[index];
+        dlmodule_relocate(module, &fixup->rel,
+                          fixup->local ? (Elf_Addr)((rt_uint8_t *)module->mem_space + fixup->value) : fixup->value);
+    }
+
+    if (entry->nsym)
+    {
+        module->symtab = (struct rt_module_symtab *)rt_malloc(entry->nsym * sizeof(struct rt_module_symtab));
+        if (module->symtab == RT_NULL)
+            return -RT_ENOMEM;
+        for (index = 0; index < entry->nsym; index++)
+        {
+            module->symtab[index].addr = (rt_uint8_t *)module->mem_space + (rt_ubase_t)entry->symtab[index].addr;
+            module->symtab[index].name = rt_strdup(entry->symtab[index].name);
+            if (module->symtab[index].name == RT_NULL)
+                break;
+        }
+        module->nsym = index;
+        if (index != entry->nsym)
+            return -RT_ENOMEM;
+        dlmodule_symhash_build(&module->symhash, module->symtab, module->nsym);
+    }
+
+    module->priority = entry->priority;
+    module->stack_size = entry->stack_size;
+
+    return RT_EOK;
+}
+#endif /* DLMODULE_USING_CACHE */
+
+void dlmodule_cache_init(void)
+{
+#ifdef DLMODULE_USING_CACHE
+    rt_mutex_init(&_cache_lock, "dlcache", RT_IPC_FLAG_PRIO);
+#endif
+}
+
+rt_err_t dlmodule_load_shared_stream(struct rt_dlmodule *module, int fd, const char *path, int flags,
+                                     struct dlmodule_load_stat *stat)
+{
+    struct dl_stream s;
+    struct dlmodule_fixups *record = RT_NULL;
+    Elf_Ehdr eh;
+    rt_err_t ret;
+#ifdef DLMODULE_USING_CACHE
+    struct dlmodule_fixups fixups;
+    struct dlmodule_cache *entry;
+    struct stat st;
+    rt_bool_t cache;
+#endif
+
+    s.fd = fd;
+    s.held = 0;
+    s.stat = stat;
+
+    ret = _stream_read(&s, 0, &eh, sizeof(eh));
+    if (ret != RT_EOK)
+        return ret;
+    if (eh.e_phentsize != sizeof(Elf_Phdr) || eh.e_shentsize != sizeof(Elf_Shdr))
+    {
+        LOG_E("Module: unsupported elf header size");
+        return -RT_ERROR;
+    }
+
+#ifdef DLMODULE_USING_CACHE
+    cache = ((flags & DLMODULE_LOAD_CACHED) && fstat(fd, &st) == 0) ? RT_TRUE : RT_FALSE;
+    if (cache)
+    {
+        rt_mutex_take(&_cache_lock, RT_WAITING_FOREVER);
+        entry = _cache_find(path, &st);
+        if (entry != RT_NULL)
+        {
+            stat->mode = DLMODULE_LOAD_CACHED;
+            ret = _cache_apply(&s, module, entry);
+        }
+        rt_mutex_release(&_cache_lock);
+        if (entry != RT_NULL)
+            return ret;
+
+        rt_memset(&fixups, 0, sizeof(fixups));
+        record = &fixups;
+    }
+#endif
+
+    stat->mode = DLMODULE_LOAD_STREAM;
+    ret = _stream_load(&s, module, &eh, record);
+
+#ifdef DLMODULE_USING_CACHE
+    if (cache)
+    {
+        /* the list of the relocations grows while the tables are held */
+        stat->peak += fixups.max * sizeof(struct dlmodule_fixup);
+        if (ret == RT_EOK && !fixups.failed)
+        {
+            Elf_Phdr *ph = (Elf_Phdr *)_stream_read_alloc(&s, eh.e_phoff, eh.e_phnum * sizeof(Elf_Phdr));
+
+            if (ph != RT_NULL)
+            {
+                rt_mutex_take(&_cache_lock, RT_WAITING_FOREVER);
+                _cache_add(path, &st, module, ph, eh.e_phnum, &fixups);
+                rt_mutex_release(&_cache_lock);
+                _stream_free(&s, ph, eh.e_phnum * sizeof(Elf_Phdr));
+            }
+        }
+        rt_free(fixups.fixup);
+    }
+#endif
+
+    return ret;
+}
+
+#endif /* RT_USING_POSIX_FS */
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Symbol lookup benchmark of the module loader.
+ *
+ * A synthetic table of exports with names like the kernel ones is looked up as the relocations
+ * of a module do, by a scan of the table and by its hash index, for a number of lookups spread
+ * over the table and a tenth of them missing. The time to build the index, the time per lookup
+ * and the total for the relocations are reported. Without arguments it runs over tables of
+ * 100, 1000 and 4000 symbols with 300 lookups.
+ */
+
+#include <rtthread.h>
+#include <rtm.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#include "dlmodule.h"
+
+#if defined(DLMODULE_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_NAME_SIZE         24
+
+static void bench_run(rt_uint32_t nsym, rt_uint32_t lookups)
+{
+    struct rt_module_symtab *symtab;
+    struct dlmodule_symhash index, scan;
+    char *names, name[BENCH_NAME_SIZE];
+    rt_uint32_t i, n, t, build, found[2], ns[2];
+    int pass;
+
+    symtab = (struct rt_module_symtab *)rt_malloc(nsym * sizeof(*symtab));
+    names = (char *)rt_malloc(nsym * BENCH_NAME_SIZE);
+    if (symtab == RT_NULL || names == RT_NULL)
+    {
+        rt_free(symtab);
+        rt_free(names);
+        rt_kprintf("no memory for %d symbols\n", nsym);
+        return;
+    }
+    for (i = 0; i < nsym; i++)
+    {
+        rt_snprintf(names + i * BENCH_NAME_SIZE, BENCH_NAME_SIZE, "rt_bench_export_%u", i);
+        symtab[i].name = names + i * BENCH_NAME_SIZE;
+        symtab[i].addr = (void *)(rt_ubase_t)(i + 1);
+    }
+
+    t = BENCH_CLOCK();
+    dlmodule_symhash_build(&index, symtab, nsym);
+    build = (rt_uint32_t)(BENCH_CLOCK_NS(BENCH_CLOCK() - t) / 1000);
+    rt_memset(&scan, 0, sizeof(scan));
+
+    /* pass 0 scans the table, pass 1 uses the index */
+    for (pass = 0; pass < 2; pass++)
+    {
+        found[pass] = 0;
+        t = BENCH_CLOCK();
+        for (i = 0; i < lookups; i++)
+        {
+            /* every tenth name is not in the table */
+            n = (rt_uint32_t)((rt_uint64_t)i * 2654435761u % nsym);
+            rt_snprintf(name, sizeof(name), (i % 10 == 9) ? "rt_bench_missing_%u" : "rt_bench_export_%u", n);
+            if (dlmodule_symhash_find(pass ? &index : &scan, symtab, nsym, name) != RT_NULL)
+                found[pass]++;
+        }
+        ns[pass] = (rt_uint32_t)(BENCH_CLOCK_NS(BENCH_CLOCK() - t) / lookups);
+    }
+
+    rt_kprintf("%7d %7d %8d us %8d ns %8d ns %8d us %8d us%s\n", nsym, lookups, build, ns[0], ns[1],
+               ns[0] * lookups / 1000, ns[1] * lookups / 1000,
+               (found[0] != found[1] || index.bucket == RT_NULL) ? "  index failed" : "");
+
+    dlmodule_symhash_free(&index);
+    rt_free(names);
+    rt_free(symtab);
+}
+
+static void dlsym_bench(int argc, char **argv)
+{
+    static const rt_uint16_t symbols[] = {100, 1000, 4000};
+    rt_uint32_t lookups = 300, i;
+
+    if (argc > 2) lookups = strtoul(argv[2], RT_NULL, 0);
+    if (lookups == 0 || (argc > 1 && (strtoul(argv[1], RT_NULL, 0) == 0 || strtoul(argv[1], RT_NULL, 0) >= 0xffff)))
+    {
+        rt_kprintf("Usage: dlsym_bench [symbols] [lookups]\n");
+        return;
+    }
+
+    /* the lookups include the formatting of the name, the same for both */
+    rt_kprintf("symbols lookups      build         scan         hash   scan total   hash total\n");
+    if (argc > 1)
+    {
+        bench_run(strtoul(argv[1], RT_NULL, 0), lookups);
+        return;
+    }
+    for (i = 0; i < sizeof(symbols) / sizeof(symbols[0]); i++)
+        bench_run(symbols[i], lookups);
+}
+MSH_CMD_EXPORT(dlsym_bench, module symbol lookup);
+
+#ifdef RT_USING_UTEST
+#include <utest.h>
+
+#define TEST_SYMBOLS            500
+
+static void test_symhash_find(void)
+{
+    struct rt_module_symtab *symtab, *sym;
+    struct dlmodule_symhash index;
+    char *names, name[BENCH_NAME_SIZE];
+    rt_uint32_t i;
+
+    symtab = (struct rt_module_symtab *)rt_malloc(TEST_SYMBOLS * sizeof(*symtab));
+    names = (char *)rt_malloc(TEST_SYMBOLS * BENCH_NAME_SIZE);
+    uassert_not_null(symtab);
+    uassert_not_null(names);
+    if (symtab == RT_NULL || names == RT_NULL)
+    {
+        rt_free(symtab);
+        rt_free(names);
+        return;
+    }
+    for (i = 0; i < TEST_SYMBOLS; i++)
+    {
+        rt_snprintf(names + i * BENCH_NAME_SIZE, BENCH_NAME_SIZE, "rt_bench_export_%u", i);
+        symtab[i].name = names + i * BENCH_NAME_SIZE;
+        symtab[i].addr = (void *)(rt_ubase_t)(i + 1);
+    }
+
+    /* the index finds every export at its entry and none of the missing names */
+    uassert_int_equal(dlmodule_symhash_build(&index, symtab, TEST_SYMBOLS), RT_EOK);
+    for (i = 0; i < TEST_SYMBOLS; i++)
+    {
+        rt_snprintf(name, sizeof(name), "rt_bench_export_%u", i);
+        sym = dlmodule_symhash_find(&index, symtab, TEST_SYMBOLS, name);
+        uassert_true(sym == &symtab[i]);
+        rt_snprintf(name, sizeof(name), "rt_bench_missing_%u", i);
+        uassert_null(dlmodule_symhash_find(&index, symtab, TEST_SYMBOLS, name));
+    }
+
+    dlmodule_symhash_free(&index);
+    rt_free(names);
+    rt_free(symtab);
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_symhash_find);
+}
+UTEST_TC_EXPORT(testcase, "components.libraries.libdl_v2.dlsym_bench", RT_NULL, RT_NULL, 10);
+#endif /* RT_USING_UTEST */
+
+#endif /* defined(DLMODULE_USING_BENCH) && defined(RT_USING_FINSH) */
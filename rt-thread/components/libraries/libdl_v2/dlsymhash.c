@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+#include <rtm.h>
+
+#include "dlmodule.h"
+
+/*
+ * Hash index of a symbol table, for the kernel exports and the symbols of a module.
+ *
+ * The table itself is left as it is, the index is a power of 2 of buckets with the first symbol
+ * of each and a chain with the next symbol of the same bucket, both as the index + 1 and 0 at
+ * the end, in one allocation of 2 bytes per bucket and per symbol. The load factor is between
+ * 1/2 and 1, so a lookup compares about one name. Without an index, when it could not be
+ * allocated or the table has more than 65534 symbols, the lookup scans the table.
+ */
+
+/* the hash of the GNU ELF hash sections */
+rt_uint32_t dlmodule_symhash(const char *name)
+{
+    rt_uint32_t hash = 5381;
+
+    while (*name)
+        hash = hash * 33 + (rt_uint8_t)*name++;
+
+    return hash;
+}
+
+int dlmodule_symhash_build(struct dlmodule_symhash *index, struct rt_module_symtab *symtab, rt_size_t nsym)
+{
+    rt_uint32_t nbucket, bucket;
+    rt_size_t i;
+
+    rt_memset(index, 0, sizeof(*index));
+    if (nsym == 0 || nsym >= 0xffff)
+        return -RT_EINVAL;
+
+    for (nbucket = 1; nbucket < nsym; nbucket <<= 1);
+
+    index->bucket = (rt_uint16_t *)rt_malloc((nbucket + nsym) * sizeof(rt_uint16_t));
+    if (index->bucket == RT_NULL)
+        return -RT_ENOMEM;
+    index->chain = index->bucket + nbucket;
+    index->mask = nbucket - 1;
+    rt_memset(index->bucket, 0, nbucket * sizeof(rt_uint16_t));
+
+    /* insert backwards, the first of the equal names is found as the scan finds it */
+    for (i = nsym; i > 0; i--)
+    {
+        bucket = dlmodule_symhash(symtab[i - 1].name) & index->mask;
+        index->chain[i - 1] = index->bucket[bucket];
+        index->bucket[bucket] = (rt_uint16_t)i;
+    }
+
+    return RT_EOK;
+}
+
+void dlmodule_symhash_free(struct dlmodule_symhash *index)
+{
+    if (index->bucket)
+        rt_free(index->bucket);
+    rt_memset(index, 0, sizeof(*index));
+}
+
+struct rt_module_symtab *dlmodule_symhash_find(struct dlmodule_symhash *index, struct rt_module_symtab *symtab,
+                                               rt_size_t nsym, const char *name)
+{
+    rt_uint16_t i;
+    rt_size_t n;
+
+    if (index->bucket == RT_NULL)
+    {
+        for (n = 0; n < nsym; n++)
+        {
+            if (rt_strcmp(symtab[n].name, name) == 0)
+                return &symtab[n];
+        }
+        return RT_NULL;
+    }
+
+    for (i = index->bucket[dlmodule_symhash(name) & index->mask]; i != 0; i = index->chain[i - 1])
+    {
+        if (rt_strcmp(symtab[i - 1].name, name) == 0)
+            return &symtab[i - 1];
+    }
+
+    return RT_NULL;
+}
@@ -6,10 +6,14 @@
  * Change Logs:
  * Date           Author       Notes
  * 2020-05-25     chenyong     first version
+ * 2026-10-18     RT-Thread    use the CRC service for crc16
  */
 
 #include <mcf.h>
 #include <mcf_trans.h>
+#ifdef RT_USING_CRC
+#include <crc.h>
+#endif
 
 #define DBG_TAG               "mcf.log"
 #ifdef MCF_USING_DEBUG
@@ -99,6 +103,10 @@ void mcf_print_raw_data(const uint8_t *raw_data, size_t size)
 /* crc16 calculation */
 uint16_t mcf_crc16_calc(const uint8_t *data, size_t size)
 {
+#ifdef RT_USING_CRC
+    /* CRC-16/MODBUS, the same value as the tables below */
+    return (uint16_t) rt_crc_calc(RT_CRC16_MODBUS, data, size);
+#else
     static const uint8_t auc_crc_hi[] = {
         0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0, 0x80, 0x41,
         0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1, 0x81, 0x40,
@@ -160,5 +168,6 @@ uint16_t mcf_crc16_calc(const uint8_t *data, size_t size)
     }
 
     return (uint16_t) (crc_hi << 8 | crc_lo);
+#endif /* RT_USING_CRC */
 }
 
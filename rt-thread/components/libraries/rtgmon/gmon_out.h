@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef __RT_GMON_OUT_H__
+#define __RT_GMON_OUT_H__
+
+#include <rtthread.h>
+
+/* records of gmon.out, shared by rtgmon and the sampling profiler */
+
+/* labels */
+#define GMON_MAGIC      "gmon"  /* magic cookie */
+#define GMON_VERSION    1       /* version number */
+
+enum gmon_record_tag
+{
+    GMON_TAG_TIME_HIST = 0,
+    GMON_TAG_CG_ARC = 1,
+    GMON_TAG_BB_COUNT = 2
+};
+typedef rt_uint8_t gmon_record_tag_t;
+
+/* gmon\sys\gmon_out.h */
+/* gmon\gmon.c */
+struct gmon_hdr
+{
+    char cookie[4];         /* gmon */
+    rt_uint32_t version;    /* 1 */
+    char spare[3*4];
+};
+
+/* gmon\sys\gmon_out.h */
+/* gmon\gmon.c */
+struct gmon_hist_hdr
+{
+    rt_ubase_t low_pc;     /* base pc address of sample buffer */
+    rt_ubase_t high_pc;    /* max pc address of sampled buffer */
+    rt_uint32_t hist_size;  /* size of sample buffer */
+    rt_uint32_t prof_rate;  /* profiling clock rate */
+    char dimen[15];         /* phys. dim., usually "seconds" */
+    char dimen_abbrev;      /* usually 's' for "seconds" */
+};
+
+#endif /* __RT_GMON_OUT_H__ */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Sampling profiler overhead benchmark.
+ *
+ * A CRC32 workload runs with the profiler stopped, then sampled; the difference is the time
+ * the sampling interrupts took from it, given for each sample and as a share of the run.
+ * A running profile is stopped and cleared.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#include "rtprof.h"
+
+#if defined(RT_PROF_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_DATA_SIZE         1024
+
+static rt_uint32_t bench_crc32(const rt_uint8_t *data, rt_size_t size, rt_uint32_t crc)
+{
+    int bit;
+
+    while (size--)
+    {
+        crc ^= *data++;
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+
+    return crc;
+}
+
+static rt_uint32_t bench_run(const rt_uint8_t *data, rt_uint32_t rounds, rt_uint32_t *crc)
+{
+    rt_uint32_t i, t;
+
+    t = BENCH_CLOCK();
+    for (i = 0; i < rounds; i++)
+        *crc = bench_crc32(data, BENCH_DATA_SIZE, *crc);
+
+    return BENCH_CLOCK() - t;
+}
+
+static void prof_bench(int argc, char **argv)
+{
+    struct rt_prof_stat stat;
+    rt_uint32_t rounds = 2000, i, off, on, crc = 0;
+    rt_uint64_t extra;
+    rt_uint8_t *data;
+
+    if (argc > 1) rounds = strtoul(argv[1], RT_NULL, 0);
+    if (rounds == 0)
+    {
+        rt_kprintf("Usage: prof_bench [rounds]\n");
+        return;
+    }
+
+    data = rt_malloc(BENCH_DATA_SIZE);
+    if (data == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return;
+    }
+    for (i = 0; i < BENCH_DATA_SIZE; i++)
+        data[i] = (rt_uint8_t)(i * 31 + 7);
+
+    rt_prof_stop();
+    rt_prof_clear();
+    off = bench_run(data, rounds, &crc);
+    if (rt_prof_start() != RT_EOK)
+    {
+        rt_kprintf("prof: start failed\n");
+        rt_free(data);
+        return;
+    }
+    on = bench_run(data, rounds, &crc);
+    rt_prof_stop();
+    rt_prof_get_stat(&stat);
+    rt_prof_clear();
+    rt_free(data);
+
+    extra = on > off ? BENCH_CLOCK_NS(on - off) : 0;
+    rt_kprintf("%d rounds of crc32 over %d bytes, crc 0x%08x\n", rounds, BENCH_DATA_SIZE, crc);
+    rt_kprintf("profiler stopped   %8d us\n", (rt_uint32_t)(BENCH_CLOCK_NS(off) / 1000));
+    rt_kprintf("sampled at %5d Hz %8d us, %d samples\n", stat.rate,
+               (rt_uint32_t)(BENCH_CLOCK_NS(on) / 1000), stat.samples);
+    if (stat.samples)
+        rt_kprintf("cost of a sample   %8d ns\n", (rt_uint32_t)(extra / stat.samples));
+    if (off && on > off)
+        rt_kprintf("overhead           %8d.%02d%%\n", (rt_uint32_t)((on - off) * 100 / off),
+                   (rt_uint32_t)((on - off) * 10000 / off % 100));
+}
+MSH_CMD_EXPORT(prof_bench, sampling profiler overhead);
+
+#endif /* defined(RT_PROF_USING_BENCH) && defined(RT_USING_FINSH) */
@@ -12,6 +12,7 @@
 #include <dlmodule.h>
 #include "rtgmon.h" 
 #include "gmoncfg.h"
+#include "gmon_out.h"
 
 #define RTGMON_VERSION  "v1.1.0" 
 
@@ -19,44 +20,11 @@
 #define ROUNDDOWN(x,y)  (((x)/(y))*(y))
 #define ROUNDUP(x,y)    ((((x)+(y)-1)/(y))*(y))
 
-/* labels */
-#define GMON_MAGIC      "gmon"  /* magic cookie */
-#define GMON_VERSION    1       /* version number */
-
 #define GMON_PROF_ON    0 
 #define GMON_PROF_BUSY  1 
 #define GMON_PROF_ERROR 2 
 #define GMON_PROF_OFF   3
 
-enum gmon_record_tag
-{
-    GMON_TAG_TIME_HIST = 0,
-    GMON_TAG_CG_ARC = 1,
-    GMON_TAG_BB_COUNT = 2
-}; 
-typedef rt_uint8_t gmon_record_tag_t; 
-
-/* gmon\sys\gmon_out.h */ 
-/* gmon\gmon.c */ 
-struct gmon_hdr
-{
-    char cookie[4];         /* gmon */ 
-    rt_uint32_t version;    /* 1 */ 
-    char spare[3*4];
-};
-
-/* gmon\sys\gmon_out.h */ 
-/* gmon\gmon.c */
-struct gmon_hist_hdr
-{
-    rt_ubase_t low_pc;     /* base pc address of sample buffer */
-    rt_ubase_t high_pc;    /* max pc address of sampled buffer */
-    rt_uint32_t hist_size;  /* size of sample buffer */
-    rt_uint32_t prof_rate;  /* profiling clock rate */
-    char dimen[15];         /* phys. dim., usually "seconds" */
-    char dimen_abbrev;      /* usually 's' for "seconds" */
-};
-
 struct gmon_cg_arc_record
 {
     char from_pc[sizeof (char *)];	/* address within caller's body */
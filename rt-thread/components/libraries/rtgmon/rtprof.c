@@ -0,0 +1,547 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Statistical profiler: a periodic interrupt, the OS tick or a hwtimer, samples the PC of
+ * the code it stopped. The PC goes to a histogram of the text, saved as gmon.out for gprof,
+ * and with its thread and a few return addresses to a ring of the last samples, saved as
+ * folded stacks for flamegraph.pl. Nothing is instrumented, the profiler is started and
+ * stopped at run time and costs nothing while it is stopped.
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef RT_USING_DFS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef RT_USING_HWTIMER
+#include <rtdevice.h>
+#endif
+#ifdef ARCH_ARM_CORTEX_M
+#include <board.h>
+#endif
+
+#include "rtprof.h"
+#include "gmon_out.h"
+
+#ifndef RT_PROF_TIMER_DEVICE
+#define RT_PROF_TIMER_DEVICE    ""      /* sample in the OS tick */
+#endif
+#define PROF_OUTFILE            "/gmon.out"
+
+/* the default profiled text, other toolchains give it to rt_prof_init() */
+#if defined(__ARMCC_VERSION)
+extern const char Image$$ER_IROM1$$Base[], Image$$ER_IROM1$$Limit[];
+#define PROF_TEXT_START         ((rt_ubase_t)Image$$ER_IROM1$$Base)
+#define PROF_TEXT_END           ((rt_ubase_t)Image$$ER_IROM1$$Limit)
+#elif defined(__GNUC__)
+extern const char _stext[], _etext[];
+#define PROF_TEXT_START         ((rt_ubase_t)_stext)
+#define PROF_TEXT_END           ((rt_ubase_t)_etext)
+#else
+#define PROF_TEXT_START         0
+#define PROF_TEXT_END           0
+#endif
+
+struct prof
+{
+    rt_bool_t running;
+
+    rt_ubase_t lowpc;
+    rt_ubase_t highpc;
+    rt_uint16_t *hist;
+    rt_ubase_t hist_size;               /* counters */
+
+    struct rt_prof_sample *ring;
+    rt_uint32_t head;                   /* samples written to the ring */
+
+    struct rt_prof_stat stat;
+#ifdef RT_USING_HWTIMER
+    rt_device_t timer;
+#endif
+};
+static struct prof _prof;
+
+#ifdef ARCH_ARM_CORTEX_M
+/* a Thumb address in the text after a BL or a BLX register */
+static rt_bool_t prof_is_return(rt_ubase_t addr)
+{
+    const rt_uint16_t *ins;
+
+    if (!(addr & 1))
+        return RT_FALSE;
+    addr &= ~(rt_ubase_t)1;
+    if (addr < _prof.lowpc + 4 || addr >= _prof.highpc)
+        return RT_FALSE;
+
+    ins = (const rt_uint16_t *)addr;
+    if ((ins[-1] & 0xff87) == 0x4780)
+        return RT_TRUE;
+
+    return (ins[-2] & 0xf800) == 0xf000 && (ins[-1] & 0xd000) == 0xd000;
+}
+
+/*
+ * The threads run on the PSP, where the interrupt stacked their r0-r3, r12, lr, pc and xpsr.
+ * Thumb code keeps no frame chain, the callers are the words of the stack that are return
+ * addresses; a stale one left by a returned call may show up as an extra frame.
+ */
+rt_weak int rt_prof_port_backtrace(rt_ubase_t *pc, int depth)
+{
+    rt_thread_t thread = rt_thread_self();
+    rt_ubase_t *sp, *end;
+    int count = 0, words;
+
+    if (thread == RT_NULL)
+        return 0;
+    sp = (rt_ubase_t *)__get_PSP();
+    end = (rt_ubase_t *)((rt_uint8_t *)thread->stack_addr + thread->stack_size);
+    if (sp < (rt_ubase_t *)thread->stack_addr || sp + 8 > end)
+        return 0;
+
+    pc[count++] = sp[6];
+    if (count < depth && prof_is_return(sp[5]))
+        pc[count++] = sp[5] & ~(rt_ubase_t)1;
+    for (sp += 8, words = 0; count < depth && sp < end && words < RT_PROF_SCAN_WORDS; sp++, words++)
+    {
+        if (prof_is_return(*sp) && (*sp & ~(rt_ubase_t)1) != pc[count - 1])
+            pc[count++] = *sp & ~(rt_ubase_t)1;
+    }
+
+    return count;
+}
+#else
+/* the port of the architecture reads the interrupted context */
+rt_weak int rt_prof_port_backtrace(rt_ubase_t *pc, int depth)
+{
+    return 0;
+}
+#endif /* ARCH_ARM_CORTEX_M */
+
+/* called by the sampling interrupt, one CPU takes the samples */
+void rt_prof_sample(void)
+{
+    struct rt_prof_sample *sample;
+    rt_ubase_t index;
+
+    if (!_prof.running)
+        return;
+
+    _prof.stat.samples++;
+    sample = &_prof.ring[_prof.head++ % RT_PROF_RING_SIZE];
+    rt_memset(sample, 0, sizeof(*sample));
+    if (rt_interrupt_get_nest() > 1 || rt_prof_port_backtrace(sample->pc, RT_PROF_DEPTH + 1) == 0)
+    {
+        /* another interrupt was stopped, its context is not at hand */
+        _prof.stat.unknown++;
+        return;
+    }
+    sample->thread = rt_thread_self();
+
+    if (sample->pc[0] >= _prof.lowpc && sample->pc[0] < _prof.highpc)
+    {
+        index = (sample->pc[0] - _prof.lowpc) >> RT_PROF_HIST_SHIFT;
+        if (_prof.hist[index] != 0xffff)
+            _prof.hist[index]++;
+    }
+    else
+    {
+        _prof.stat.outside++;
+    }
+}
+
+int rt_prof_init(rt_ubase_t lowpc, rt_ubase_t highpc)
+{
+    rt_ubase_t size;
+
+    if (_prof.running || lowpc >= highpc)
+        return -RT_ERROR;
+
+    rt_free(_prof.hist);
+    rt_free(_prof.ring);
+    _prof.lowpc = RT_ALIGN_DOWN(lowpc, 1 << RT_PROF_HIST_SHIFT);
+    _prof.highpc = RT_ALIGN(highpc, 1 << RT_PROF_HIST_SHIFT);
+    size = (_prof.highpc - _prof.lowpc) >> RT_PROF_HIST_SHIFT;
+    _prof.hist = rt_calloc(size, sizeof(rt_uint16_t));
+    _prof.ring = rt_calloc(RT_PROF_RING_SIZE, sizeof(struct rt_prof_sample));
+    if (_prof.hist == RT_NULL || _prof.ring == RT_NULL)
+    {
+        rt_free(_prof.hist);
+        rt_free(_prof.ring);
+        _prof.hist = RT_NULL;
+        _prof.ring = RT_NULL;
+        return -RT_ENOMEM;
+    }
+    _prof.hist_size = size;
+    rt_prof_clear();
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_HWTIMER
+static rt_err_t prof_timeout(rt_device_t dev, rt_size_t size)
+{
+    rt_prof_sample();
+    return RT_EOK;
+}
+
+static rt_err_t prof_timer_start(void)
+{
+    rt_hwtimerval_t timeout = {0, 1000000 / RT_PROF_RATE};
+    rt_hwtimer_mode_t mode = HWTIMER_MODE_PERIOD;
+
+    _prof.timer = rt_device_find(RT_PROF_TIMER_DEVICE);
+    if (_prof.timer == RT_NULL || rt_device_open(_prof.timer, RT_DEVICE_OFLAG_RDWR) != RT_EOK)
+    {
+        rt_kprintf("prof: no timer %s\n", RT_PROF_TIMER_DEVICE);
+        _prof.timer = RT_NULL;
+        return -RT_ERROR;
+    }
+    rt_device_set_rx_indicate(_prof.timer, prof_timeout);
+    rt_device_control(_prof.timer, HWTIMER_CTRL_MODE_SET, &mode);
+    if (rt_device_write(_prof.timer, 0, &timeout, sizeof(timeout)) != sizeof(timeout))
+    {
+        rt_device_close(_prof.timer);
+        _prof.timer = RT_NULL;
+        return -RT_ERROR;
+    }
+    _prof.stat.rate = RT_PROF_RATE;
+
+    return RT_EOK;
+}
+#endif /* RT_USING_HWTIMER */
+
+int rt_prof_start(void)
+{
+    if (_prof.running)
+        return RT_EOK;
+    if (_prof.hist == RT_NULL && rt_prof_init(PROF_TEXT_START, PROF_TEXT_END) != RT_EOK)
+        return -RT_ERROR;
+
+    _prof.running = RT_TRUE;
+#ifdef RT_USING_HWTIMER
+    if (RT_PROF_TIMER_DEVICE[0] != '\0')
+    {
+        if (prof_timer_start() != RT_EOK)
+        {
+            _prof.running = RT_FALSE;
+            return -RT_ERROR;
+        }
+        return RT_EOK;
+    }
+#endif
+    /* the tick hook has one user, the tick shares its period with the timers it drives */
+    _prof.stat.rate = RT_TICK_PER_SECOND;
+    rt_tick_sethook(rt_prof_sample);
+
+    return RT_EOK;
+}
+
+int rt_prof_stop(void)
+{
+    if (!_prof.running)
+        return RT_EOK;
+
+#ifdef RT_USING_HWTIMER
+    if (_prof.timer)
+    {
+        rt_device_control(_prof.timer, HWTIMER_CTRL_STOP, RT_NULL);
+        rt_device_close(_prof.timer);
+        _prof.timer = RT_NULL;
+    }
+    else
+#endif
+    {
+        rt_tick_sethook(RT_NULL);
+    }
+    _prof.running = RT_FALSE;
+
+    return RT_EOK;
+}
+
+void rt_prof_clear(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (_prof.hist)
+        rt_memset(_prof.hist, 0, _prof.hist_size * sizeof(rt_uint16_t));
+    _prof.head = 0;
+    _prof.stat.samples = 0;
+    _prof.stat.outside = 0;
+    _prof.stat.unknown = 0;
+    rt_hw_interrupt_enable(level);
+}
+
+void rt_prof_get_stat(struct rt_prof_stat *stat)
+{
+    *stat = _prof.stat;
+}
+
+static int prof_sample_cmp(const void *a, const void *b)
+{
+    return memcmp(a, b, sizeof(struct rt_prof_sample));
+}
+
+/* a sorted copy of the ring, the same stacks are next to each other */
+static int prof_snapshot(struct rt_prof_sample **samples)
+{
+    rt_base_t level;
+    int count;
+
+    *samples = RT_NULL;
+    if (_prof.ring == RT_NULL)
+        return 0;
+    *samples = rt_malloc(RT_PROF_RING_SIZE * sizeof(struct rt_prof_sample));
+    if (*samples == RT_NULL)
+        return -RT_ENOMEM;
+
+    level = rt_hw_interrupt_disable();
+    count = _prof.head < RT_PROF_RING_SIZE ? _prof.head : RT_PROF_RING_SIZE;
+    rt_memcpy(*samples, _prof.ring, count * sizeof(struct rt_prof_sample));
+    rt_hw_interrupt_enable(level);
+    qsort(*samples, count, sizeof(struct rt_prof_sample), prof_sample_cmp);
+
+    return count;
+}
+
+/* the thread may be gone since the sample, only a thread still in the object list is read */
+static void prof_thread_name(rt_thread_t thread, char *name, int size)
+{
+    struct rt_object_information *info;
+    rt_list_t *node;
+
+    if (thread == RT_NULL)
+    {
+        rt_snprintf(name, size, "[irq]");
+        return;
+    }
+
+    rt_snprintf(name, size, "%p", thread);
+    info = rt_object_get_information(RT_Object_Class_Thread);
+    rt_enter_critical();
+    rt_list_for_each(node, &info->object_list)
+    {
+        if (rt_list_entry(node, struct rt_object, list) == &thread->parent)
+        {
+            rt_snprintf(name, size, "%.*s", RT_NAME_MAX, thread->parent.name);
+            break;
+        }
+    }
+    rt_exit_critical();
+}
+
+static void prof_output(int fd, const char *line, int length)
+{
+#ifdef RT_USING_DFS
+    if (fd >= 0)
+    {
+        write(fd, line, length);
+        return;
+    }
+#endif
+    rt_kprintf("%s", line);
+}
+
+/* "thread;caller;...;pc count" for each stack, to the console for a negative fd */
+static int prof_folded(int fd)
+{
+    struct rt_prof_sample *samples;
+    char line[RT_NAME_MAX + 16 + (RT_PROF_DEPTH + 1) * 11];
+    int count, index, next, length, depth;
+
+    count = prof_snapshot(&samples);
+    if (count < 0)
+        return count;
+
+    for (index = 0; index < count; index = next)
+    {
+        for (next = index + 1; next < count; next++)
+        {
+            if (prof_sample_cmp(&samples[index], &samples[next]) != 0)
+                break;
+        }
+
+        prof_thread_name(samples[index].thread, line, RT_NAME_MAX + 16);
+        length = rt_strlen(line);
+        for (depth = RT_PROF_DEPTH; depth >= 0; depth--)
+        {
+            if (samples[index].pc[depth])
+                length += rt_snprintf(line + length, sizeof(line) - length, ";0x%08x", samples[index].pc[depth]);
+        }
+        length += rt_snprintf(line + length, sizeof(line) - length, " %d\n", next - index);
+        prof_output(fd, line, length);
+    }
+    rt_free(samples);
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_DFS
+int rt_prof_save_gmon(const char *path)
+{
+    gmon_record_tag_t tag = GMON_TAG_TIME_HIST;
+    struct gmon_hist_hdr hhdr;
+    struct gmon_hdr ghdr;
+    int fd;
+
+    if (_prof.hist == RT_NULL)
+        return -RT_ERROR;
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0)
+        return -RT_EIO;
+
+    rt_memcpy(&ghdr.cookie[0], GMON_MAGIC, sizeof(ghdr.cookie));
+    ghdr.version = GMON_VERSION;
+    rt_memset(ghdr.spare, 0, sizeof(ghdr.spare));
+    write(fd, &ghdr, sizeof(ghdr));
+
+    hhdr.low_pc = _prof.lowpc;
+    hhdr.high_pc = _prof.highpc;
+    hhdr.hist_size = _prof.hist_size;
+    hhdr.prof_rate = _prof.stat.rate;
+    strncpy(hhdr.dimen, "seconds", sizeof(hhdr.dimen));
+    hhdr.dimen_abbrev = 's';
+    write(fd, &tag, sizeof(tag));
+    write(fd, &hhdr, sizeof(hhdr));
+    write(fd, _prof.hist, _prof.hist_size * sizeof(rt_uint16_t));
+    close(fd);
+
+    return RT_EOK;
+}
+
+int rt_prof_save_folded(const char *path)
+{
+    int fd, ret;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0)
+        return -RT_EIO;
+    ret = prof_folded(fd);
+    close(fd);
+
+    return ret;
+}
+#endif /* RT_USING_DFS */
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+/* the busiest histogram counters and the threads of the last samples */
+static void prof_top(int number)
+{
+    struct rt_prof_sample *samples;
+    rt_ubase_t index, best, last = 0;
+    int rank, count, sample, next;
+    char name[RT_NAME_MAX + 16];
+
+    rt_kprintf("%d samples at %d Hz, %d outside the text, %d in interrupts\n", _prof.stat.samples,
+               _prof.stat.rate, _prof.stat.outside, _prof.stat.unknown);
+    if (_prof.stat.samples == 0)
+        return;
+
+    rt_kprintf("address     samples\n");
+    for (rank = 0; rank < number; rank++)
+    {
+        /* the next counter after last in the order of count, then of address */
+        best = _prof.hist_size;
+        for (index = 0; index < _prof.hist_size; index++)
+        {
+            if (_prof.hist[index] == 0)
+                continue;
+            if (rank > 0 && (_prof.hist[index] > _prof.hist[last] ||
+                             (_prof.hist[index] == _prof.hist[last] && index <= last)))
+                continue;
+            if (best == _prof.hist_size || _prof.hist[index] > _prof.hist[best])
+                best = index;
+        }
+        if (best == _prof.hist_size)
+            break;
+        rt_kprintf("0x%08x  %7d %3d%%\n", _prof.lowpc + (best << RT_PROF_HIST_SHIFT), _prof.hist[best],
+                   _prof.hist[best] * 100 / _prof.stat.samples);
+        last = best;
+    }
+
+    count = prof_snapshot(&samples);
+    if (count <= 0)
+        return;
+    rt_kprintf("thread      samples of the last %d\n", count);
+    for (sample = 0; sample < count; sample = next)
+    {
+        for (next = sample + 1; next < count && samples[next].thread == samples[sample].thread; next++);
+        prof_thread_name(samples[sample].thread, name, sizeof(name));
+        rt_kprintf("%-*.*s %7d %3d%%\n", RT_NAME_MAX + 2, RT_NAME_MAX + 2, name, next - sample,
+                   (next - sample) * 100 / count);
+    }
+    rt_free(samples);
+}
+
+static void prof(int argc, char **argv)
+{
+    if (argc >= 2 && !strcmp(argv[1], "start"))
+    {
+        if (argc == 4 && rt_prof_init(strtoul(argv[2], RT_NULL, 0), strtoul(argv[3], RT_NULL, 0)) != RT_EOK)
+        {
+            rt_kprintf("prof: bad text range\n");
+            return;
+        }
+        if (rt_prof_start() != RT_EOK)
+            rt_kprintf("prof: start failed\n");
+    }
+    else if (argc >= 2 && !strcmp(argv[1], "stop"))
+    {
+        rt_prof_stop();
+    }
+    else if (argc >= 2 && !strcmp(argv[1], "clear"))
+    {
+        rt_prof_clear();
+    }
+    else if (argc >= 2 && !strcmp(argv[1], "top"))
+    {
+        prof_top(argc > 2 ? atoi(argv[2]) : 10);
+    }
+    else if (argc >= 2 && !strcmp(argv[1], "folded"))
+    {
+#ifdef RT_USING_DFS
+        if (argc > 2)
+        {
+            if (rt_prof_save_folded(argv[2]) != RT_EOK)
+                rt_kprintf("prof: save %s failed\n", argv[2]);
+            return;
+        }
+#endif
+        prof_folded(-1);
+    }
+#ifdef RT_USING_DFS
+    else if (argc >= 2 && !strcmp(argv[1], "save"))
+    {
+        const char *path = argc > 2 ? argv[2] : PROF_OUTFILE;
+
+        if (rt_prof_save_gmon(path) != RT_EOK)
+            rt_kprintf("prof: save %s failed\n", path);
+    }
+#endif
+    else
+    {
+        rt_kprintf("Usage: prof start [lowpc highpc]  sample the PC\n");
+        rt_kprintf("       prof stop | clear\n");
+        rt_kprintf("       prof top [number]          busiest addresses and threads\n");
+        rt_kprintf("       prof folded [file]         folded stacks of the last samples\n");
+#ifdef RT_USING_DFS
+        rt_kprintf("       prof save [file]           histogram as gmon.out, %s\n", PROF_OUTFILE);
+#endif
+    }
+}
+MSH_CMD_EXPORT(prof, statistical profiler);
+#endif /* RT_USING_FINSH */
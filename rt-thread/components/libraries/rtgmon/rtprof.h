@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+#ifndef __RT_PROF_H__
+#define __RT_PROF_H__
+
+#include <rtthread.h>
+
+#ifndef RT_PROF_RATE
+#define RT_PROF_RATE            997     /* Hz, of the hwtimer clock */
+#endif
+#ifndef RT_PROF_RING_SIZE
+#define RT_PROF_RING_SIZE       512     /* the last samples kept with their thread and frames */
+#endif
+#ifndef RT_PROF_DEPTH
+#define RT_PROF_DEPTH           0       /* return addresses kept after the PC */
+#endif
+#ifndef RT_PROF_HIST_SHIFT
+#define RT_PROF_HIST_SHIFT      4       /* log2 of the bytes of text for each histogram counter */
+#endif
+#ifndef RT_PROF_SCAN_WORDS
+#define RT_PROF_SCAN_WORDS      64      /* stack words searched for the return addresses */
+#endif
+
+struct rt_prof_sample
+{
+    rt_thread_t thread;                 /* RT_NULL in a nested interrupt */
+    rt_ubase_t pc[RT_PROF_DEPTH + 1];   /* the PC, then the callers, 0 when unknown */
+};
+
+struct rt_prof_stat
+{
+    rt_uint32_t samples;
+    rt_uint32_t outside;                /* PC out of the profiled text */
+    rt_uint32_t unknown;                /* no PC, taken in a nested interrupt */
+    rt_uint32_t rate;
+};
+
+int rt_prof_init(rt_ubase_t lowpc, rt_ubase_t highpc);
+int rt_prof_start(void);
+int rt_prof_stop(void);
+void rt_prof_clear(void);
+void rt_prof_sample(void);
+void rt_prof_get_stat(struct rt_prof_stat *stat);
+
+int rt_prof_save_gmon(const char *path);
+int rt_prof_save_folded(const char *path);
+
+/* frames of the code the sampling interrupt stopped, returns their number */
+int rt_prof_port_backtrace(rt_ubase_t *pc, int depth);
+
+#endif /* __RT_PROF_H__ */
@@ -0,0 +1,74 @@
+import sys
+import getopt
+import subprocess
+
+# 'prof folded' lines are "thread;0xcaller;...;0xpc count", the callers are return addresses
+
+def symbolize(addr2line, elf, addresses):
+    names = {}
+    if not addresses:
+        return names
+
+    # the line of a return address is the one after the call
+    query = ['0x%x' % (a - 1 if i else a) for (a, i) in addresses]
+    out = subprocess.check_output([addr2line, '-f', '-e', elf] + query).decode().splitlines()
+    for n, key in enumerate(addresses):
+        names[key] = out[n * 2]
+
+    return names
+
+def Usage():
+    print('Usage: prof_fold -e rtthread.elf [-a addr2line] -i prof.folded -o stacks.folded')
+    exit(0)
+
+if __name__ == '__main__':
+    elf = 'rtthread.elf'
+    addr2line = 'arm-none-eabi-addr2line'
+    input_fn = 'prof.folded'
+    output_fn = 'stacks.folded'
+
+    try:
+        opts,args = getopt.getopt(sys.argv[1:], "he:a:i:o:", ["help", "elf", "addr2line", "input", "output"])
+    except Exception as e:
+        print(e)
+        Usage()
+
+    for opt,arg in opts:
+        if opt in ('-h'):
+            Usage()
+        elif opt in ('-e'):
+            elf = arg
+        elif opt in ('-a'):
+            addr2line = arg
+        elif opt in ('-i'):
+            input_fn = arg
+        elif opt in ('-o'):
+            output_fn = arg
+
+    stacks = []
+    addresses = set()
+    for line in open(input_fn, 'r'):
+        line = line.strip()
+        if not line or ' ' not in line:
+            continue
+        (stack, count) = line.rsplit(' ', 1)
+        frames = stack.split(';')
+        keys = []
+        for n, frame in enumerate(frames[1:]):
+            # the last frame is the PC, the others return addresses
+            key = (int(frame, 16), n != len(frames) - 2)
+            keys.append(key)
+            addresses.add(key)
+        stacks.append((frames[0], keys, int(count)))
+
+    names = symbolize(addr2line, elf, sorted(addresses))
+    merged = {}
+    for (thread, keys, count) in stacks:
+        folded = ';'.join([thread] + [names[key] for key in keys])
+        merged[folded] = merged.get(folded, 0) + count
+
+    f = open(output_fn, 'w')
+    for folded in sorted(merged):
+        f.write('%s %d\n' % (folded, merged[folded]))
+    f.close()
+    print('%d stacks, flamegraph.pl %s > prof.svg' % (len(merged), output_fn))
@@ -4,6 +4,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-06-01     realthread   the first version
+ * 2026-10-18     RT-Thread    trace_port_get_ts() returns the 32-bit stamp of the ports
  */
 #ifndef TRACE_AGENT_H__
 #define TRACE_AGENT_H__
@@ -29,7 +30,7 @@ int trace_agent_init(void);
 int trace_agent_start(void);
 int trace_agent_stop(void);
 
-uint64_t trace_port_get_ts(void);
+rt_uint32_t trace_port_get_ts(void);
 
 int trace_put_pdu(uint8_t *pdu);
 struct trace_pdu *trace_get_pdu(int hashkey, size_t size);
@@ -4,12 +4,31 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-06-01     realthread   the first version
+ * 2026-10-18     RT-Thread    cputime timestamps and the clock frequency
  */
 #include <rtthread.h>
+#ifdef RT_USING_CPUTIME
+#include <rtdevice.h>
+#endif
 
 rt_weak rt_uint32_t trace_port_get_ts(void)
 {
+#ifdef RT_USING_CPUTIME
+    return (rt_uint32_t)clock_cpu_gettime();
+#else
     return rt_tick_get();
+#endif
+}
+
+/* the frequency of trace_port_get_ts(), for the clock of the CTF metadata */
+rt_weak rt_uint32_t trace_port_get_freq(void)
+{
+#ifdef RT_USING_CPUTIME
+    /* the resolution is in nanoseconds per count, scaled by 1000000 */
+    return (rt_uint32_t)(1000000000ULL * 1000000 / clock_cpu_getres());
+#else
+    return RT_TICK_PER_SECOND;
+#endif
 }
 
 rt_weak int trace_port_init(void)
@@ -4,6 +4,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-06-01     realthread   the first version
+ * 2026-10-18     RT-Thread    CTF packets, trace targets and lost event report
  */
 
 #include <stdio.h>
@@ -17,13 +18,48 @@
 #include <trace_agent.h>
 #include "trace_buffer.h"
 #include "trace_internal.h"
+#include "trace_ctf.h"
 
 #define BUFSZ               (1024 * 8)
+#define TRACE_METADATA_SIZE (1024 * 4)
 #define TRACE_EVENT_STOP    0x01
 #define TRACE_EVENT_START   0x02
 #define TRACE_EVENT_SAVE    0x04
 
 static struct trace_agent ta = {0};
+static char *trace_target = NULL;
+
+static void trace_write_metadata(void)
+{
+    char *metadata;
+    int length;
+
+    metadata = (char *)malloc(TRACE_METADATA_SIZE);
+    if (metadata)
+    {
+        length = ctf_metadata(metadata, TRACE_METADATA_SIZE, trace_port_get_freq());
+        trace_file_write(TRACE_STREAM_METADATA, metadata, length);
+        free(metadata);
+    }
+}
+
+/* a block goes out as a CTF packet of the stream of its CPU */
+static void trace_write_block(struct trace_block *block)
+{
+    struct ctf_packet_header header;
+    int length = block->length - sizeof(struct trace_block);
+
+    header.magic = CTF_PACKET_MAGIC;
+    header.stream_id = 0;
+    header.stream_instance_id = block->cpu;
+    header.packet_seq_num = block->sequence;
+    header.content_size = (sizeof(header) + length) * 8;
+    header.packet_size = header.content_size;
+    header.events_discarded = block->lost;
+
+    trace_file_write(block->cpu, &header, sizeof(header));
+    trace_file_write(block->cpu, (uint8_t *)(block + 1), length);
+}
 
 static void tb_ready_handler(struct trace_buffer *tb, struct trace_block *block)
 {
@@ -66,9 +102,12 @@ static void trace_agent(void *parameter)
             {
                 /* reset trace buffer */
                 trace_buffer_reset(ta.tb);
+                ctf_object_reset();
 
                 /* start record */
-                trace_file_open();
+                if (trace_file_open(trace_target) != 0)
+                    continue;
+                trace_write_metadata();
 
                 level = trace_lock();
                 ta.status = TA_STATUS_RUNNING;
@@ -87,21 +126,21 @@ static void trace_agent(void *parameter)
                     rt_list_remove(&(block->list));
                     trace_unlock(level);
 
-                    /* skip block header */
-                    trace_file_write((uint8_t*)(block + 1), block->length - sizeof(struct trace_block));
+                    trace_write_block(block);
                     trace_release_block((uint8_t*)block);
 
                     level = trace_lock();
                 }
 
                 if ((ta.status == TA_STATUS_STOPPING) &&
-                    rt_list_isempty(&(block->list)) &&
+                    rt_list_isempty(&(ta.tb_list)) &&
                     trace_buffer_get_wcount(ta.tb) == 0)
                 {
                     ta.status = TA_STATUS_STOPPED;
                     trace_unlock(level);
 
                     trace_file_close();
+                    printf("trace: %u events lost\n", (unsigned int)trace_buffer_get_lost(ta.tb));
                 }
                 else
                 {
@@ -130,7 +169,7 @@ int trace_agent_init(void)
     rt_list_init(&(ta.tb_list));
     rt_event_init(&ta.event, "trace", RT_IPC_FLAG_FIFO);
 
-    ta.tb = trace_buffer_create(1024 * 8, 4);
+    ta.tb = trace_buffer_create(TRACE_AGENT_BLOCK_SIZE, TRACE_AGENT_BLOCK_NUM);
     trace_buffer_set_ready_handler(ta.tb, tb_ready_handler);
 
     trace_pdu_init(&ta);
@@ -148,6 +187,7 @@ INIT_APP_EXPORT(trace_agent_init);
 /*
  * trace --desc fn  generate description json file
  * trace start      to start trace
+ * trace start dir  to start trace into a directory, or host:port for a socket
  * trace stop       to stop trace
  */
 int trace(int argc, char **argv)
@@ -157,20 +197,25 @@ int trace(int argc, char **argv)
         printf("RT-Thread Trace Event Agent\n");
         printf("Usage:\n");
         printf("trace start       to start trace\n");
+        printf("trace start dir   to start trace into dir, or host:port\n");
         printf("trace stop        to stop trace\n");
         return 0;
     }
 
-    if (argc == 2)
+    if (strcmp(argv[1], "start") == 0)
     {
-        if (strcmp(argv[1], "start") == 0)
-        {
-            rt_event_send(&ta.event, TRACE_EVENT_START);
-        }
-        else if (strcmp(argv[1], "stop") == 0)
+        if (ta.status == TA_STATUS_RUNNING || ta.status == TA_STATUS_STOPPING)
         {
-            rt_event_send(&ta.event, TRACE_EVENT_STOP);
+            printf("trace is running\n");
+            return 0;
         }
+        free(trace_target);
+        trace_target = (argc == 3) ? strdup(argv[2]) : NULL;
+        rt_event_send(&ta.event, TRACE_EVENT_START);
+    }
+    else if (strcmp(argv[1], "stop") == 0)
+    {
+        rt_event_send(&ta.event, TRACE_EVENT_STOP);
     }
 
     return 0;
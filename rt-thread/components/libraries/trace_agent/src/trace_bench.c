@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Trace event overhead benchmark.
+ *
+ * The events go to a trace buffer of the benchmark whose blocks are released as soon as they
+ * are ready, nothing is written and nothing is dropped while the agent is idle. The cost of
+ * recording one event is measured, then the cost of a semaphore release and take with the
+ * trace hooks off and on, which is the overhead tracing adds to the two kernel events.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#include <trace_agent.h>
+#include "trace_buffer.h"
+#include "trace_internal.h"
+#include "trace_ctf.h"
+
+#if defined(TRACE_AGENT_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+static struct trace_agent bench_agent;
+static rt_uint32_t bench_packets;
+
+static void bench_ready_handler(struct trace_buffer *tb, struct trace_block *block)
+{
+    bench_packets++;
+    trace_buffer_release_block(tb, (uint8_t *)block);
+}
+
+static rt_uint32_t bench_sem(struct rt_semaphore *sem, rt_uint32_t count)
+{
+    rt_uint32_t i, t;
+
+    t = BENCH_CLOCK();
+    for (i = 0; i < count; i++)
+    {
+        rt_sem_release(sem);
+        rt_sem_take(sem, RT_WAITING_FOREVER);
+    }
+
+    return BENCH_CLOCK() - t;
+}
+
+static void trace_bench(int argc, char **argv)
+{
+    struct trace_agent *agent = trace_pdu_get();
+    struct rt_semaphore sem;
+    rt_uint32_t count = 10000, i, t, event, off, on;
+    rt_uint16_t id;
+
+    if (argc > 1) count = strtoul(argv[1], RT_NULL, 0);
+    if (count == 0)
+    {
+        rt_kprintf("Usage: trace_bench [events]\n");
+        return;
+    }
+    if (agent == RT_NULL || agent->status == TA_STATUS_RUNNING || agent->status == TA_STATUS_STOPPING)
+    {
+        rt_kprintf("the trace agent is not idle\n");
+        return;
+    }
+
+    rt_memset(&bench_agent, 0, sizeof(bench_agent));
+    bench_agent.tb = trace_buffer_create(TRACE_AGENT_BLOCK_SIZE, TRACE_AGENT_BLOCK_NUM);
+    if (bench_agent.tb == RT_NULL)
+    {
+        rt_kprintf("no memory for the trace buffer\n");
+        return;
+    }
+    trace_buffer_set_ready_handler(bench_agent.tb, bench_ready_handler);
+    bench_packets = 0;
+    rt_sem_init(&sem, "tbench", 0, RT_IPC_FLAG_FIFO);
+    trace_pdu_init(&bench_agent);
+    ctf_object_reset();
+
+    /* the event alone, the object ID is interned once */
+    id = ctf_object_id(&sem, "tbench", RT_Object_Class_Semaphore);
+    t = BENCH_CLOCK();
+    for (i = 0; i < count; i++)
+        ctf_event_sem_take(id);
+    event = BENCH_CLOCK() - t;
+
+    /* two kernel events for each round */
+    off = bench_sem(&sem, count);
+    trace_hook_set_enable(RT_TRUE);
+    on = bench_sem(&sem, count);
+    trace_hook_set_enable(RT_FALSE);
+
+    trace_buffer_flush(bench_agent.tb);
+    trace_pdu_init(agent);
+    ctf_object_reset();
+
+    rt_kprintf("%d rounds, %d packets of %d bytes, %d events lost\n", count, bench_packets,
+               TRACE_AGENT_BLOCK_SIZE, trace_buffer_get_lost(bench_agent.tb));
+    rt_kprintf("record an event      %6d ns\n", (rt_uint32_t)(BENCH_CLOCK_NS(event) / count));
+    rt_kprintf("sem pair, trace off  %6d ns\n", (rt_uint32_t)(BENCH_CLOCK_NS(off) / count));
+    rt_kprintf("sem pair, trace on   %6d ns\n", (rt_uint32_t)(BENCH_CLOCK_NS(on) / count));
+    rt_kprintf("overhead per event   %6d ns\n",
+               on > off ? (rt_uint32_t)(BENCH_CLOCK_NS(on - off) / count / 2) : 0);
+
+    rt_sem_detach(&sem);
+    trace_buffer_destroy(bench_agent.tb);
+}
+MSH_CMD_EXPORT(trace_bench, trace event overhead);
+
+#endif /* defined(TRACE_AGENT_USING_BENCH) && defined(RT_USING_FINSH) */
@@ -4,6 +4,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-06-01     realthread   the first version
+ * 2026-10-18     RT-Thread    lock-free per-CPU reserve and commit
+ * 2026-10-18     RT-Thread    unsigned free mask arithmetic
  */
 #include <stdio.h>
 #include <stdint.h>
@@ -11,6 +13,33 @@
 
 #include "trace_buffer.h"
 
+/*
+ * block state: offset | pending writers << 16 | sealed | generation << 24
+ * current block of a CPU: index + 1 | generation << 24, the index is 0 for none
+ *
+ * Each block taken from the free mask gets the next generation of its CPU, a writer that
+ * read the current block before it was sealed and recycled sees another generation in its
+ * state and retries instead of reserving in the new use of the block. Only a writer held
+ * between those two reads while its CPU goes through 256 blocks could be mistaken.
+ */
+#define TB_STATE_OFFSET(s)      ((rt_ubase_t)(s) & 0xffff)
+#define TB_STATE_PENDING(s)     (((rt_ubase_t)(s) >> 16) & 0x7f)
+#define TB_STATE_WRITER         0x10000
+#define TB_STATE_SEALED         0x800000
+#define TB_GENERATION(s)        (((rt_ubase_t)(s) >> 24) & 0xff)
+#define TB_CURRENT_INDEX(c)     ((rt_ubase_t)(c) & 0xffff)
+#define TB_STATE(offset, gen)   ((rt_atomic_t)((offset) | ((rt_ubase_t)(gen) & 0xff) << 24))
+#define TB_CURRENT(index, gen)  ((rt_atomic_t)((index) | ((rt_ubase_t)(gen) & 0xff) << 24))
+
+struct trace_cpu_buffer
+{
+    rt_atomic_t current;
+    rt_atomic_t free;                   /* mask of the free blocks of the CPU */
+    rt_atomic_t lost;
+    rt_atomic_t generation;
+    uint32_t sequence;                  /* packet number after a flush */
+};
+
 struct trace_buffer
 {
     uint16_t block_size;
@@ -19,29 +48,107 @@ struct trace_buffer
     uint8_t *block_buffer;
     uint8_t *block_end;
 
-    struct trace_block *current_block;
-    rt_list_t block_list;
+    struct trace_cpu_buffer cpus[TB_CPUS_NR];
 
     tb_ready_handler_t block_ready;
-    uint32_t wandering_count;
+    rt_atomic_t wandering_count;
 };
 
-rt_inline rt_ubase_t trace_buffer_lock(void)
+rt_inline struct trace_block *tb_block(struct trace_buffer *buffer, rt_ubase_t index)
 {
-    return rt_hw_interrupt_disable();
+    return (struct trace_block *)(buffer->block_buffer + index * buffer->block_size);
 }
 
-rt_inline void trace_buffer_unlock(rt_ubase_t status)
+rt_inline struct trace_cpu_buffer *tb_cpu(struct trace_buffer *buffer)
 {
-    rt_hw_interrupt_enable(status);
-    return;
+#ifdef RT_USING_SMP
+    return &buffer->cpus[rt_hw_cpu_id()];
+#else
+    return &buffer->cpus[0];
+#endif
+}
+
+static void tb_free_block(struct trace_buffer *buffer, struct trace_block *block)
+{
+    rt_ubase_t index = ((uint8_t *)block - buffer->block_buffer) / buffer->block_size;
+
+    rt_atomic_or(&buffer->cpus[index / buffer->block_num].free, (rt_atomic_t)((rt_ubase_t)1 << (index % buffer->block_num)));
+}
+
+/* a sealed block without writers, hand it to the agent */
+static void tb_ready(struct trace_buffer *buffer, struct trace_block *block, rt_atomic_t state)
+{
+    block->length = TB_STATE_OFFSET(state);
+    if ((block->length > sizeof(struct trace_block)) && buffer->block_ready)
+    {
+        buffer->block_ready(buffer, block);
+    }
+    else
+    {
+        tb_free_block(buffer, block);
+    }
+}
+
+static void tb_seal(struct trace_buffer *buffer, struct trace_block *block)
+{
+    rt_atomic_t state;
+
+    /* counted before sealing, it must not read zero while the block has writers */
+    rt_atomic_add(&buffer->wandering_count, 1);
+    state = rt_atomic_or(&block->state, TB_STATE_SEALED);
+    if (TB_STATE_PENDING(state) == 0)
+    {
+        tb_ready(buffer, block, state);
+        rt_atomic_sub(&buffer->wandering_count, 1);
+    }
+}
+
+/* replace the current block of the CPU, read as current, by a free one */
+static int tb_switch(struct trace_buffer *buffer, struct trace_cpu_buffer *cpu, rt_atomic_t current)
+{
+    struct trace_block *block, *old = RT_NULL;
+    rt_atomic_t free, bit, next;
+    rt_ubase_t index;
+
+    free = rt_atomic_load(&cpu->free);
+    do
+    {
+        if (free == 0)
+            return -1;
+        /* the lowest free block, unsigned as the mask can have the sign bit */
+        bit = (rt_atomic_t)((rt_ubase_t)free & (0 - (rt_ubase_t)free));
+    } while (!rt_atomic_compare_exchange_strong(&cpu->free, &free, free & ~bit));
+
+    if (TB_CURRENT_INDEX(current))
+        old = tb_block(buffer, TB_CURRENT_INDEX(current) - 1);
+
+    index = (cpu - buffer->cpus) * buffer->block_num + __rt_ffs((int)bit) - 1;
+    next = TB_CURRENT(index + 1, rt_atomic_add(&cpu->generation, 1) + 1);
+    block = tb_block(buffer, index);
+    block->cpu = cpu - buffer->cpus;
+    block->sequence = old ? old->sequence + 1 : cpu->sequence;
+    block->lost = rt_atomic_load(&cpu->lost);
+    rt_atomic_store(&block->state, TB_STATE(sizeof(struct trace_block), TB_GENERATION(next)));
+
+    if (!rt_atomic_compare_exchange_strong(&cpu->current, &current, next))
+    {
+        /* an interrupt switched first */
+        rt_atomic_or(&cpu->free, bit);
+    }
+    else if (old)
+    {
+        tb_seal(buffer, old);
+    }
+
+    return 0;
 }
 
 struct trace_buffer *trace_buffer_create(uint16_t size, uint16_t number)
 {
     struct trace_buffer *buffer = NULL;
 
-    if (size < sizeof(struct trace_block))
+    size = RT_ALIGN_DOWN(size, TB_ALIGN_SIZE);
+    if (size <= sizeof(struct trace_block) || number == 0 || number > TB_BLOCK_NUM_MAX)
         goto __exit;
 
     buffer = (struct trace_buffer *)calloc(1, sizeof(struct trace_buffer));
@@ -49,11 +156,9 @@ struct trace_buffer *trace_buffer_create(uint16_t size, uint16_t number)
     {
         buffer->block_num = number;
         buffer->block_size = size;
-        rt_list_init(&(buffer->block_list));
         buffer->block_ready = NULL;
-        buffer->wandering_count = 0;
 
-        buffer->block_buffer = (uint8_t *)malloc(size * number);
+        buffer->block_buffer = (uint8_t *)malloc((size_t)size * number * TB_CPUS_NR);
         if (buffer->block_buffer == NULL)
         {
             /* allocate block buffer failed */
@@ -62,31 +167,7 @@ struct trace_buffer *trace_buffer_create(uint16_t size, uint16_t number)
         }
         else
         {
-            int index;
-
-            /* set buffer end */
-            buffer->block_end = buffer->block_buffer + buffer->block_size * buffer->block_num;
-
-            /* add to block list */
-            for (index = 0; index < number; index++)
-            {
-                struct trace_block *block;
-
-                block = (struct trace_block *)(buffer->block_buffer + index * buffer->block_size);
-                block->length = 0;
-                block->ref_count = 0;
-                rt_list_init(&(block->list));
-
-                /* add to block list */
-                rt_list_insert_before(&(buffer->block_list), &(block->list));
-            }
-
-            /* set to the first block */
-            buffer->current_block = rt_list_entry(buffer->block_list.next, struct trace_block, list);
-            buffer->current_block->ref_count = 0;
-            buffer->current_block->length = sizeof(struct trace_block);
-
-            rt_list_remove(&(buffer->current_block->list));
+            trace_buffer_reset(buffer);
         }
     }
 
@@ -115,141 +196,90 @@ int trace_buffer_set_ready_handler(struct trace_buffer *buffer, tb_ready_handler
     return 0;
 }
 
+/*
+ * reserve size bytes in the current block of this CPU, the event is dropped and counted
+ * when all the blocks of the CPU wait for the agent
+ */
 uint8_t *trace_buffer_get(struct trace_buffer *buffer, size_t size)
 {
-    rt_ubase_t level;
-    uint8_t *ptr = NULL;
-    struct trace_block *block = NULL, *ready_block = NULL;
+    struct trace_cpu_buffer *cpu;
+    struct trace_block *block;
+    rt_atomic_t current, state;
 
-    /* set to align size */
-    if (size == 0)
+    if ((buffer == NULL) || (size == 0) || (size > buffer->block_size - sizeof(struct trace_block)))
         return NULL;
 
-    if (buffer)
+    cpu = tb_cpu(buffer);
+    while (1)
     {
-        level = trace_buffer_lock();
-        if (size < buffer->block_size)
+        current = rt_atomic_load(&cpu->current);
+        if (TB_CURRENT_INDEX(current))
         {
-            /* the current block */
-            block = buffer->current_block;
-
-            /* get a memory block */
-            if ((block == NULL) || (block->length + size > buffer->block_size))
+            block = tb_block(buffer, TB_CURRENT_INDEX(current) - 1);
+            state = rt_atomic_load(&block->state);
+            if (TB_GENERATION(state) != TB_GENERATION(current))
+                continue;
+            if (!(state & TB_STATE_SEALED) && (TB_STATE_OFFSET(state) + size <= buffer->block_size))
             {
-                /* move to next block */
-                if (!rt_list_isempty(&(buffer->block_list)))
-                {
-                    /* current block is ready */
-                    if ((block->ref_count == 0) && (buffer->block_ready))
-                    {
-                        ready_block = block;
-                        buffer->current_block = NULL;
-                    }
-                    else
-                    {
-                        buffer->wandering_count += 1;
-                    }
-
-                    /* allocate new block */
-                    block = rt_list_entry(buffer->block_list.next, struct trace_block, list);
-                    rt_list_remove(&(block->list));
-
-                    block->length = sizeof(struct trace_block);
-                    block->ref_count = 0;
-                    buffer->current_block = block;
-                }
-                else
-                {
-                    block = NULL;
-                }
+                if (rt_atomic_compare_exchange_strong(&block->state, &state, state + size + TB_STATE_WRITER))
+                    return (uint8_t *)block + TB_STATE_OFFSET(state);
+                continue;
             }
-
-            if (block == NULL)
-            {
-                trace_buffer_unlock(level);
-                goto __exit;
-            }
-
-            block->ref_count += 1;
-            ptr = (uint8_t *)block + block->length;
-            block->length += size;
         }
-        trace_buffer_unlock(level);
-    }
 
-__exit:
-    if (ready_block)
-    {
-        buffer->block_ready(buffer, ready_block);
+        if (tb_switch(buffer, cpu, current) != 0)
+            break;
     }
+    rt_atomic_add(&cpu->lost, 1);
 
-    return ptr;
+    return NULL;
 }
 
 int trace_buffer_put(struct trace_buffer *buffer, uint8_t *mem)
 {
     int ret = -1;
-    rt_ubase_t level;
+    rt_atomic_t state;
     struct trace_block *block;
 
     if (mem > buffer->block_buffer && mem < buffer->block_end)
     {
         block = (struct trace_block *)(buffer->block_buffer + ((mem - buffer->block_buffer) / buffer->block_size) * buffer->block_size);
 
-        level = trace_buffer_lock();
-        block->ref_count -= 1;
-        if ((block != buffer->current_block) &&
-            (block->ref_count == 0) && buffer->block_ready)
-        {
-            buffer->wandering_count -= 1;
-            trace_buffer_unlock(level);
-
-            /* invoke block ready callback */
-            buffer->block_ready(buffer, block);
-            ret = 0;
-        }
-        else
+        state = rt_atomic_sub(&block->state, TB_STATE_WRITER);
+        if ((state & TB_STATE_SEALED) && (TB_STATE_PENDING(state) == 1))
         {
-            trace_buffer_unlock(level);
+            /* the last writer of a full block */
+            tb_ready(buffer, block, state - TB_STATE_WRITER);
+            rt_atomic_sub(&buffer->wandering_count, 1);
         }
+        ret = 0;
     }
 
     return ret;
 }
 
+/* seal the current blocks with data, the next event of a CPU takes a new block */
 int trace_buffer_flush(struct trace_buffer *buffer)
 {
-    rt_ubase_t level;
-    struct trace_block *block, *ready_block = NULL;
+    struct trace_cpu_buffer *cpu;
+    struct trace_block *block;
+    rt_atomic_t current;
 
-    level = trace_buffer_lock();
-    /* the current block */
-    block = buffer->current_block;
-    if (block && (block->length > sizeof(struct trace_block))) /* has valid data */
+    for (cpu = buffer->cpus; cpu < buffer->cpus + TB_CPUS_NR; cpu++)
     {
-        ready_block = block;
-        buffer->current_block = NULL;
-
-        /* move to next block */
-        if (!rt_list_isempty(&(buffer->block_list)))
+        current = rt_atomic_load(&cpu->current);
+        while (TB_CURRENT_INDEX(current))
         {
-            /* allocate new block */
-            block = rt_list_entry(buffer->block_list.next, struct trace_block, list);
-            rt_list_remove(&(block->list));
+            block = tb_block(buffer, TB_CURRENT_INDEX(current) - 1);
+            if (TB_STATE_OFFSET(rt_atomic_load(&block->state)) <= sizeof(struct trace_block))
+                break;
 
-            block->length = sizeof(struct trace_block);
-            block->ref_count = 0;
-            buffer->current_block = block;
-        }
-    }
-    trace_buffer_unlock(level);
-
-    if (ready_block)
-    {
-        if ((ready_block->ref_count == 0) && (buffer->block_ready))
-        {
-            /* invoke block ready callback */
-            buffer->block_ready(buffer, ready_block);
+            cpu->sequence = block->sequence + 1;
+            if (rt_atomic_compare_exchange_strong(&cpu->current, &current, TB_CURRENT(0, TB_GENERATION(current))))
+            {
+                tb_seal(buffer, block);
+                break;
+            }
         }
     }
 
@@ -262,49 +292,41 @@ int trace_buffer_get_wcount(struct trace_buffer *buffer)
 
     if (buffer)
     {
-        wcount = buffer->wandering_count;
+        wcount = (int)rt_atomic_load(&buffer->wandering_count);
     }
 
     return wcount;
 }
 
-int trace_buffer_reset(struct trace_buffer *buffer)
+uint32_t trace_buffer_get_lost(struct trace_buffer *buffer)
 {
-    rt_ubase_t level;
+    uint32_t lost = 0;
+    int index;
 
-    level = trace_buffer_lock();
-    rt_list_init(&(buffer->block_list));
-
-    if (buffer->block_buffer)
+    if (buffer)
     {
-        int index;
-
-        /* set buffer end */
-        buffer->block_end = buffer->block_buffer + buffer->block_size * buffer->block_num;
-        buffer->wandering_count = 0;
-
-        /* add to block list */
-        for (index = 0; index < buffer->block_num; index++)
-        {
-            struct trace_block *block;
-
-            block = (struct trace_block *)(buffer->block_buffer + index * buffer->block_size);
-            block->length = 0;
-            block->ref_count = 0;
-            rt_list_init(&(block->list));
+        for (index = 0; index < TB_CPUS_NR; index++)
+            lost += (uint32_t)rt_atomic_load(&buffer->cpus[index].lost);
+    }
 
-            /* add to block list */
-            rt_list_insert_before(&(buffer->block_list), &(block->list));
-        }
+    return lost;
+}
 
-        /* set to the first block */
-        buffer->current_block = rt_list_entry(buffer->block_list.next, struct trace_block, list);
-        buffer->current_block->ref_count = 0;
-        buffer->current_block->length = sizeof(struct trace_block);
+/* back to all blocks free, with no writer left */
+int trace_buffer_reset(struct trace_buffer *buffer)
+{
+    struct trace_cpu_buffer *cpu;
 
-        rt_list_remove(&(buffer->current_block->list));
+    buffer->block_end = buffer->block_buffer + (size_t)buffer->block_size * buffer->block_num * TB_CPUS_NR;
+    for (cpu = buffer->cpus; cpu < buffer->cpus + TB_CPUS_NR; cpu++)
+    {
+        rt_atomic_store(&cpu->current, 0);
+        rt_atomic_store(&cpu->lost, 0);
+        rt_atomic_store(&cpu->generation, 0);
+        cpu->sequence = 0;
+        rt_atomic_store(&cpu->free, (rt_atomic_t)(((rt_uint64_t)1 << buffer->block_num) - 1));
     }
-    trace_buffer_unlock(level);
+    rt_atomic_store(&buffer->wandering_count, 0);
 
     return 0;
 }
@@ -312,18 +334,14 @@ int trace_buffer_reset(struct trace_buffer *buffer)
 int trace_buffer_release_block(struct trace_buffer *buffer, uint8_t *block)
 {
     int ret = -1;
-    rt_ubase_t level;
-    struct trace_block *tb = (struct trace_block *)block;
 
-    if (tb && buffer)
+    if (block && buffer)
     {
-        level = trace_buffer_lock();
         if (block >= buffer->block_buffer && block < buffer->block_end)
         {
-            rt_list_insert_before(&(buffer->block_list), &(tb->list));
+            tb_free_block(buffer, (struct trace_block *)block);
             ret = 0;
         }
-        trace_buffer_unlock(level);
     }
 
     return ret;
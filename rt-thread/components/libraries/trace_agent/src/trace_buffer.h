@@ -4,6 +4,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-06-01     realthread   the first version
+ * 2026-10-18     RT-Thread    lock-free per-CPU reserve and commit
  */
 #ifndef TRACE_BUFFER_H__
 #define TRACE_BUFFER_H__
@@ -11,27 +12,47 @@
 #include <rthw.h>
 #include <rtthread.h>
 #include <rtservice.h>
+#include <rtatomic.h>
 
 #define TB_ALIGN_SIZE 4
+/* blocks of each CPU, one bit of the free mask each */
+#define TB_BLOCK_NUM_MAX 32
+
+#ifdef RT_USING_SMP
+#define TB_CPUS_NR RT_CPUS_NR
+#else
+#define TB_CPUS_NR 1
+#endif
 
 struct trace_buffer;
 
+/*
+ * Events are reserved in the current block of the CPU with one compare-and-swap on the
+ * state word: the reserved offset in the low 16 bits, the writers still copying above it
+ * and the sealed bit on top. A full block is sealed and replaced, the writer that brings a
+ * sealed block to no pending writers hands it to the ready handler.
+ */
 struct trace_block
 {
     rt_list_t list;
 
-    uint16_t length;
-    uint16_t ref_count;
+    uint16_t length;                    /* bytes used with this header, set when ready */
+    uint16_t cpu;
+    uint32_t sequence;                  /* packet number of the CPU */
+    uint32_t lost;                      /* events dropped on the CPU before this block */
+    rt_atomic_t state;
 };
 
 typedef void (*tb_ready_handler_t)(struct trace_buffer *buffer, struct trace_block *block);
 
+/* size is the size of a block, number the blocks of each CPU */
 struct trace_buffer *trace_buffer_create(uint16_t size, uint16_t number);
 int trace_buffer_destroy(struct trace_buffer *buffer);
 int trace_buffer_flush(struct trace_buffer *buffer);
 int trace_buffer_reset(struct trace_buffer *buffer);
 
 int trace_buffer_get_wcount(struct trace_buffer *buffer);
+uint32_t trace_buffer_get_lost(struct trace_buffer *buffer);
 int trace_buffer_set_ready_handler(struct trace_buffer *buffer, tb_ready_handler_t handler);
 
 uint8_t *trace_buffer_get(struct trace_buffer *buffer, size_t size);
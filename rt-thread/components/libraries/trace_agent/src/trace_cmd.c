@@ -4,6 +4,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-06-01     realthread   the first version
+ * 2026-10-18     RT-Thread    trace_event as a CTF event with an interned name
  */
 #include <stdlib.h>
 #include <rtthread.h>
@@ -12,26 +13,17 @@
 
 #include "trace_buffer.h"
 #include "trace_internal.h"
+#include "trace_ctf.h"
 #include <trace_fmt.h>
 
 static struct trace_agent *_agent = NULL;
 
 int trace_event(const char *name)
 {
-    struct trace_pdu_event *pdu = NULL;
-
     if (_agent == NULL) return -1;
 
-    pdu = (struct trace_pdu_event *)trace_buffer_get(_agent->tb, sizeof(struct trace_pdu_event));
-    if (pdu)
-    {
-        pdu->hashkey = TH_TRACE_EVENT;
-        pdu->length = sizeof(pdu->name);
-
-        rt_strncpy(pdu->name, name, sizeof(pdu->name));
-
-        trace_buffer_put(_agent->tb, (uint8_t *)pdu);
-    }
+    /* the name is interned by its address, it must be a constant */
+    ctf_event_user(ctf_object_id(name, name, 0));
 
     return 0;
 }
@@ -62,6 +54,8 @@ struct trace_pdu *trace_get_pdu(int hashkey, size_t size)
 
 uint8_t* trace_get_raw(size_t size)
 {
+    if (_agent == NULL) return NULL;
+
     return trace_buffer_get(_agent->tb, size);
 }
 
@@ -87,3 +81,8 @@ int trace_pdu_init(struct trace_agent *ta)
 
     return 0;
 }
+
+struct trace_agent *trace_pdu_get(void)
+{
+    return _agent;
+}
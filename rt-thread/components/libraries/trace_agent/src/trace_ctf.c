@@ -6,10 +6,14 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-03-16     liboran       the first version
+ * 2026-10-18     RT-Thread     interned object IDs and CTF metadata
  */
 
+#include <rtthread.h>
+#include <rtatomic.h>
 #include "trace_ctf.h"
 #include "trace_agent.h"
+#include "trace_internal.h"
 
 typedef enum {
     CTF_EVENT_THREAD_SWITCHED_OUT   = 0x10,
@@ -25,76 +29,237 @@ typedef enum {
     CTF_EVENT_MB_RECV               = 0x1A,
     CTF_EVENT_MB_SEND               = 0x1B,
     CTF_EVENT_MQ_RECV               = 0x1C,
-    CTF_EVENT_MQ_SEND               = 0x1D
+    CTF_EVENT_MQ_SEND               = 0x1D,
+    CTF_EVENT_OBJECT_NAME           = 0x20,
+    CTF_EVENT_USER                  = 0x21
 } ctf_event_t;
 
-void ctf_event_thread_switch_out(rt_uint8_t pri, ctf_bounded_string_t name)
+/**
+ * the addresses of the interned objects, the ID is the slot plus one; the slot of a released
+ * object holds CTF_OBJECT_FREED, so that the probe goes on past it, and is taken again
+ */
+static rt_atomic_t ctf_objects[TRACE_AGENT_OBJECT_MAX];
+
+/* objects are aligned, no object is at this address */
+#define CTF_OBJECT_FREED    ((rt_atomic_t)1)
+
+static const char ctf_tsdl[] =
+    "/* CTF 1.8 */\n"
+    "typealias integer { size = 8; align = 8; signed = false; } := uint8_t;\n"
+    "typealias integer { size = 16; align = 8; signed = false; } := uint16_t;\n"
+    "typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n"
+    "typealias integer { size = 8; align = 8; signed = false; encoding = UTF8; } := ctf_char_t;\n"
+    "trace {\n"
+    "    major = 1; minor = 8;\n"
+    "    byte_order = %s;\n"
+    "    packet.header := struct { uint32_t magic; uint32_t stream_id; uint32_t stream_instance_id; };\n"
+    "};\n"
+    "env { domain = \"rt-thread\"; };\n"
+    "clock { name = trace_clock; freq = %u; };\n"
+    "typealias integer { size = 32; align = 8; signed = false; map = clock.trace_clock.value; } := ctf_clock_t;\n"
+    "stream {\n"
+    "    id = 0;\n"
+    "    packet.context := struct { uint32_t packet_seq_num; uint32_t content_size;\n"
+    "                               uint32_t packet_size; uint32_t events_discarded; };\n"
+    "    event.header := struct { uint8_t id; ctf_clock_t timestamp; };\n"
+    "};\n"
+    "event { name = thread_switched_out; id = 0x10; fields := struct { uint16_t thread; uint8_t priority; }; };\n"
+    "event { name = thread_switched_in; id = 0x11; fields := struct { uint16_t thread; uint8_t priority; }; };\n"
+    "event { name = timer_enter; id = 0x12; fields := struct { uint16_t timer; }; };\n"
+    "event { name = timer_exit; id = 0x13; fields := struct { uint16_t timer; }; };\n"
+    "event { name = sem_take; id = 0x14; fields := struct { uint16_t sem; }; };\n"
+    "event { name = sem_release; id = 0x15; fields := struct { uint16_t sem; }; };\n"
+    "event { name = mutex_take; id = 0x16; fields := struct { uint16_t mutex; }; };\n"
+    "event { name = mutex_release; id = 0x17; fields := struct { uint16_t mutex; }; };\n"
+    "event { name = event_recv; id = 0x18; fields := struct { uint16_t event; uint32_t set; }; };\n"
+    "event { name = event_send; id = 0x19; fields := struct { uint16_t event; uint32_t set; }; };\n"
+    "event { name = mb_recv; id = 0x1A; fields := struct { uint16_t mb; }; };\n"
+    "event { name = mb_send; id = 0x1B; fields := struct { uint16_t mb; }; };\n"
+    "event { name = mq_recv; id = 0x1C; fields := struct { uint16_t mq; }; };\n"
+    "event { name = mq_send; id = 0x1D; fields := struct { uint16_t mq; }; };\n"
+    "event { name = object_name; id = 0x20; fields := struct { uint16_t object; uint8_t type; ctf_char_t name[%d]; }; };\n"
+    "event { name = user; id = 0x21; fields := struct { uint16_t name; }; };\n";
+
+int ctf_metadata(char *buffer, size_t size, rt_uint32_t freq)
+{
+    const rt_uint16_t order = 1;
+
+    return rt_snprintf(buffer, size, ctf_tsdl, *(const rt_uint8_t *)&order ? "le" : "be", freq, RT_NAME_MAX);
+}
+
+static void ctf_event_object_name(rt_uint16_t id, rt_uint8_t type, const char *name)
+{
+    ctf_bounded_string_t string;
+
+    rt_strncpy(string.buf, name, RT_NAME_MAX);
+    CTF_EVENT(CTF_EVENT_OBJECT_NAME, id, type, string);
+}
+
+rt_inline rt_ubase_t ctf_object_slot(const void *object)
 {
-    CTF_EVENT(CTF_EVENT_THREAD_SWITCHED_OUT, pri, name);
+    /* the low bits of aligned addresses are alike, take the middle of the product */
+    return (((rt_uint32_t)(rt_ubase_t)object * 2654435761u) >> 16) % TRACE_AGENT_OBJECT_MAX;
 }
 
-void ctf_event_thread_switch_in(rt_uint8_t pri, ctf_bounded_string_t name)
+rt_uint16_t ctf_object_id(const void *object, const char *name, rt_uint8_t type)
 {
-    CTF_EVENT(CTF_EVENT_THREAD_SWITCHED_IN, pri, name);
+    rt_atomic_t entry;
+    rt_ubase_t slot, probe, freed = TRACE_AGENT_OBJECT_MAX;
+
+    slot = ctf_object_slot(object);
+    for (probe = 0; probe < TRACE_AGENT_OBJECT_MAX; probe++)
+    {
+        entry = rt_atomic_load(&ctf_objects[slot]);
+        if (entry == (rt_atomic_t)object)
+            return slot + 1;
+        if (entry == CTF_OBJECT_FREED && freed == TRACE_AGENT_OBJECT_MAX)
+            freed = slot;
+        if (entry == 0)
+            break;
+        slot = (slot + 1) % TRACE_AGENT_OBJECT_MAX;
+    }
+
+    /* not interned, the first released slot on the way is taken before the empty one */
+    if (freed != TRACE_AGENT_OBJECT_MAX)
+    {
+        slot = freed;
+        entry = CTF_OBJECT_FREED;
+    }
+    else if (probe == TRACE_AGENT_OBJECT_MAX)
+    {
+        return 0;
+    }
+    if (rt_atomic_compare_exchange_strong(&ctf_objects[slot], &entry, (rt_atomic_t)object))
+    {
+        ctf_event_object_name(slot + 1, type, name);
+        return slot + 1;
+    }
+
+    /* another CPU took the slot meanwhile, it may have been for this object */
+    return ctf_object_id(object, name, type);
 }
 
-void ctf_event_timer_enter(ctf_bounded_string_t name)
+/* the object is detached or deleted, its ID is given to the next object interned */
+void ctf_object_release(const void *object)
 {
-    CTF_EVENT(CTF_EVENT_TIMER_ENTER, name);
+    rt_atomic_t entry;
+    rt_ubase_t slot, probe;
+
+    slot = ctf_object_slot(object);
+    for (probe = 0; probe < TRACE_AGENT_OBJECT_MAX; probe++)
+    {
+        entry = rt_atomic_load(&ctf_objects[slot]);
+        if (entry == 0)
+            break;
+        if (entry == (rt_atomic_t)object)
+        {
+            rt_atomic_store(&ctf_objects[slot], CTF_OBJECT_FREED);
+            break;
+        }
+        slot = (slot + 1) % TRACE_AGENT_OBJECT_MAX;
+    }
 }
 
-void ctf_event_timer_exit(ctf_bounded_string_t name)
+/* an object was created where an interned one was, send its name again */
+void ctf_object_renamed(const void *object, const char *name, rt_uint8_t type)
 {
-    CTF_EVENT(CTF_EVENT_TIMER_EXIT, name);
+    rt_atomic_t entry;
+    rt_ubase_t slot, probe;
+
+    slot = ctf_object_slot(object);
+    for (probe = 0; probe < TRACE_AGENT_OBJECT_MAX; probe++)
+    {
+        entry = rt_atomic_load(&ctf_objects[slot]);
+        if (entry == 0)
+            break;
+        if (entry == (rt_atomic_t)object)
+        {
+            ctf_event_object_name(slot + 1, type, name);
+            break;
+        }
+        slot = (slot + 1) % TRACE_AGENT_OBJECT_MAX;
+    }
 }
 
-void ctf_event_sem_take(ctf_bounded_string_t name)
+void ctf_object_reset(void)
 {
-    CTF_EVENT(CTF_EVENT_SEM_TAKE, name);
+    int slot;
+
+    for (slot = 0; slot < TRACE_AGENT_OBJECT_MAX; slot++)
+        rt_atomic_store(&ctf_objects[slot], 0);
 }
 
-void ctf_event_sem_release(ctf_bounded_string_t name)
+void ctf_event_thread_switch_out(rt_uint8_t pri, rt_uint16_t thread)
 {
-    CTF_EVENT(CTF_EVENT_SEM_RELEASE, name);
+    CTF_EVENT(CTF_EVENT_THREAD_SWITCHED_OUT, thread, pri);
 }
 
-void ctf_event_mutex_take(ctf_bounded_string_t name)
+void ctf_event_thread_switch_in(rt_uint8_t pri, rt_uint16_t thread)
 {
-    CTF_EVENT(CTF_EVENT_MUTEX_TAKE, name);
+    CTF_EVENT(CTF_EVENT_THREAD_SWITCHED_IN, thread, pri);
 }
 
-void ctf_event_mutex_release(ctf_bounded_string_t name)
+void ctf_event_timer_enter(rt_uint16_t timer)
 {
-    CTF_EVENT(CTF_EVENT_MUTEX_RELEASE, name);
+    CTF_EVENT(CTF_EVENT_TIMER_ENTER, timer);
 }
 
-void ctf_event_event_recv(ctf_bounded_string_t name, rt_uint32_t set)
+void ctf_event_timer_exit(rt_uint16_t timer)
 {
-    CTF_EVENT(CTF_EVENT_EVENT_RECV, name, set);
+    CTF_EVENT(CTF_EVENT_TIMER_EXIT, timer);
 }
 
-void ctf_event_event_send(ctf_bounded_string_t name, rt_uint32_t set)
+void ctf_event_sem_take(rt_uint16_t sem)
 {
-    CTF_EVENT(CTF_EVENT_EVENT_SEND, name, set);
+    CTF_EVENT(CTF_EVENT_SEM_TAKE, sem);
 }
 
-void ctf_event_mb_recv(ctf_bounded_string_t name)
+void ctf_event_sem_release(rt_uint16_t sem)
 {
-    CTF_EVENT(CTF_EVENT_MB_RECV, name);
+    CTF_EVENT(CTF_EVENT_SEM_RELEASE, sem);
 }
 
-void ctf_event_mb_send(ctf_bounded_string_t name)
+void ctf_event_mutex_take(rt_uint16_t mutex)
 {
-    CTF_EVENT(CTF_EVENT_MB_SEND, name);
+    CTF_EVENT(CTF_EVENT_MUTEX_TAKE, mutex);
 }
 
-void ctf_event_mq_recv(ctf_bounded_string_t name)
+void ctf_event_mutex_release(rt_uint16_t mutex)
 {
-    CTF_EVENT(CTF_EVENT_MQ_RECV, name);
+    CTF_EVENT(CTF_EVENT_MUTEX_RELEASE, mutex);
 }
 
-void ctf_event_mq_send(ctf_bounded_string_t name)
+void ctf_event_event_recv(rt_uint16_t event, rt_uint32_t set)
 {
-    CTF_EVENT(CTF_EVENT_MQ_SEND, name);
+    CTF_EVENT(CTF_EVENT_EVENT_RECV, event, set);
 }
 
+void ctf_event_event_send(rt_uint16_t event, rt_uint32_t set)
+{
+    CTF_EVENT(CTF_EVENT_EVENT_SEND, event, set);
+}
+
+void ctf_event_mb_recv(rt_uint16_t mb)
+{
+    CTF_EVENT(CTF_EVENT_MB_RECV, mb);
+}
+
+void ctf_event_mb_send(rt_uint16_t mb)
+{
+    CTF_EVENT(CTF_EVENT_MB_SEND, mb);
+}
+
+void ctf_event_mq_recv(rt_uint16_t mq)
+{
+    CTF_EVENT(CTF_EVENT_MQ_RECV, mq);
+}
+
+void ctf_event_mq_send(rt_uint16_t mq)
+{
+    CTF_EVENT(CTF_EVENT_MQ_SEND, mq);
+}
+
+void ctf_event_user(rt_uint16_t name)
+{
+    CTF_EVENT(CTF_EVENT_USER, name);
+}
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-03-16     liboran       the first version
+ * 2026-10-18     RT-Thread     interned object IDs and CTF packet headers
  */
 
 #ifndef __RT_TRACE_H__
@@ -56,26 +57,54 @@
         timestamp = trace_port_get_ts();            \
         CTF_EVENT_SEND(id, timestamp, __VA_ARGS__)
 
+#define CTF_PACKET_MAGIC    0xC1FC1FC1
+
 typedef struct
 {
     char buf[RT_NAME_MAX];
 } ctf_bounded_string_t;
 
-void ctf_event_thread_switch_out(rt_uint8_t pri, ctf_bounded_string_t name);
-void ctf_event_thread_switch_in(rt_uint8_t pri, ctf_bounded_string_t name);
-void ctf_event_memory_malloc(rt_uint32_t ptr, rt_uint32_t size, ctf_bounded_string_t name);
-void ctf_event_memory_free(rt_uint32_t ptr, ctf_bounded_string_t name);
-void ctf_event_timer_enter(ctf_bounded_string_t name);
-void ctf_event_timer_exit(ctf_bounded_string_t name);
-void ctf_event_sem_take(ctf_bounded_string_t name);
-void ctf_event_sem_release(ctf_bounded_string_t name);
-void ctf_event_mutex_take(ctf_bounded_string_t name);
-void ctf_event_mutex_release(ctf_bounded_string_t name);
-void ctf_event_event_recv(ctf_bounded_string_t name, rt_uint32_t set);
-void ctf_event_event_send(ctf_bounded_string_t name, rt_uint32_t set);
-void ctf_event_mb_recv(ctf_bounded_string_t name);
-void ctf_event_mb_send(ctf_bounded_string_t name);
-void ctf_event_mq_recv(ctf_bounded_string_t name);
-void ctf_event_mq_send(ctf_bounded_string_t name);
+/* the packet header and context written before each trace block, see ctf_metadata() */
+struct ctf_packet_header
+{
+    rt_uint32_t magic;
+    rt_uint32_t stream_id;
+    rt_uint32_t stream_instance_id;     /* the CPU */
+    rt_uint32_t packet_seq_num;
+    rt_uint32_t content_size;           /* in bits */
+    rt_uint32_t packet_size;            /* in bits */
+    rt_uint32_t events_discarded;
+};
+
+/*
+ * Objects are identified in the events by a 16-bit ID, the name of an object goes to the
+ * trace once, in an object_name event the first time the object is seen. ID 0 is used for
+ * the objects that do not fit the table. The ID of a released object is used again, with a
+ * new object_name event.
+ */
+rt_uint16_t ctf_object_id(const void *object, const char *name, rt_uint8_t type);
+void ctf_object_release(const void *object);
+void ctf_object_renamed(const void *object, const char *name, rt_uint8_t type);
+void ctf_object_reset(void);
+/* write the TSDL metadata of the trace, returns its length */
+int ctf_metadata(char *buffer, size_t size, rt_uint32_t freq);
+
+void ctf_event_thread_switch_out(rt_uint8_t pri, rt_uint16_t thread);
+void ctf_event_thread_switch_in(rt_uint8_t pri, rt_uint16_t thread);
+void ctf_event_memory_malloc(rt_uint32_t ptr, rt_uint32_t size, rt_uint16_t heap);
+void ctf_event_memory_free(rt_uint32_t ptr, rt_uint16_t heap);
+void ctf_event_timer_enter(rt_uint16_t timer);
+void ctf_event_timer_exit(rt_uint16_t timer);
+void ctf_event_sem_take(rt_uint16_t sem);
+void ctf_event_sem_release(rt_uint16_t sem);
+void ctf_event_mutex_take(rt_uint16_t mutex);
+void ctf_event_mutex_release(rt_uint16_t mutex);
+void ctf_event_event_recv(rt_uint16_t event, rt_uint32_t set);
+void ctf_event_event_send(rt_uint16_t event, rt_uint32_t set);
+void ctf_event_mb_recv(rt_uint16_t mb);
+void ctf_event_mb_send(rt_uint16_t mb);
+void ctf_event_mq_recv(rt_uint16_t mq);
+void ctf_event_mq_send(rt_uint16_t mq);
+void ctf_event_user(rt_uint16_t name);
 
 #endif /* __RT_TRACE_H__ */
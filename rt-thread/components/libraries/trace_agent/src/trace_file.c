@@ -4,49 +4,189 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-06-01     realthread   the first version
+ * 2026-10-18     RT-Thread    CTF stream files and socket output
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/stat.h>
 
-#define TRACE_FILE_FN "/trace.bin"
+#include <rtthread.h>
 
-static int _trace_fd = -1;
-int trace_file_open(void)
+#ifdef TRACE_AGENT_USING_SOCKET
+#include <sys/socket.h>
+#include <netdb.h>
+#endif
+
+#include "trace_buffer.h"
+#include "trace_internal.h"
+
+/*
+ * A trace directory holds the CTF trace: the TSDL metadata file and one stream file for each
+ * CPU. A target "host:port" streams the same files to a TCP socket instead, in frames of a
+ * 16-bit stream (0xffff for the metadata, the CPU for the packets) and a 16-bit length, both
+ * little endian, followed by the data. tools/trace_recv.py writes them back into files.
+ */
+#define TRACE_FILE_DIR          "/trace"
+#define TRACE_FILE_PATH_MAX     64
+
+static int _trace_fd[TB_CPUS_NR + 1];
+static rt_bool_t _trace_file_opened = RT_FALSE;
+static char _trace_dir[TRACE_FILE_PATH_MAX] = TRACE_FILE_DIR;
+
+#ifdef TRACE_AGENT_USING_SOCKET
+static int _trace_socket = -1;
+
+static int trace_socket_open(const char *target)
+{
+    char host[TRACE_FILE_PATH_MAX];
+    const char *colon = strrchr(target, ':');
+    struct sockaddr_in addr;
+    struct hostent *entry;
+    int fd;
+
+    if (colon == NULL || colon == target || (size_t)(colon - target) >= sizeof(host))
+        return -1;
+    memcpy(host, target, colon - target);
+    host[colon - target] = '\0';
+
+    entry = gethostbyname(host);
+    if (entry == NULL)
+    {
+        printf("trace: unknown host %s\n", host);
+        return -1;
+    }
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)atoi(colon + 1));
+    addr.sin_addr = *((struct in_addr *)entry->h_addr);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        printf("trace: connect %s failed!\n", target);
+        closesocket(fd);
+        return -1;
+    }
+
+    return fd;
+}
+#endif /* TRACE_AGENT_USING_SOCKET */
+
+/* target is a directory or, with TRACE_AGENT_USING_SOCKET, host:port; NULL for the last one */
+int trace_file_open(const char *target)
 {
-    int ret = 0;
+    char path[TRACE_FILE_PATH_MAX];
+    int index;
 
-    _trace_fd = open(TRACE_FILE_FN, O_RDWR | O_TRUNC);
-    if (_trace_fd < 0)
+    for (index = 0; index < TB_CPUS_NR + 1; index++)
+        _trace_fd[index] = -1;
+    _trace_file_opened = RT_TRUE;
+
+    if (target && target[0] != '/')
     {
-        ret = -1;
-        printf("open file failed!\n");
+#ifdef TRACE_AGENT_USING_SOCKET
+        _trace_socket = trace_socket_open(target);
+        if (_trace_socket >= 0)
+        {
+            printf("trace: streaming to %s\n", target);
+            return 0;
+        }
+#else
+        printf("trace: socket output is not enabled\n");
+#endif
+        return -1;
     }
-    else
+
+    if (target)
+    {
+        strncpy(_trace_dir, target, sizeof(_trace_dir) - 1);
+    }
+    mkdir(_trace_dir, 0);
+
+    snprintf(path, sizeof(path), "%s/metadata", _trace_dir);
+    _trace_fd[0] = open(path, O_WRONLY | O_CREAT | O_TRUNC);
+    for (index = 0; index < TB_CPUS_NR; index++)
     {
-        printf("open trace file OK!");
+        snprintf(path, sizeof(path), "%s/stream_%d", _trace_dir, index);
+        _trace_fd[index + 1] = open(path, O_WRONLY | O_CREAT | O_TRUNC);
     }
 
-    return ret;
+    for (index = 0; index < TB_CPUS_NR + 1; index++)
+    {
+        if (_trace_fd[index] < 0)
+        {
+            printf("open file failed!\n");
+            trace_file_close();
+            return -1;
+        }
+    }
+    printf("open trace file OK!\n");
+
+    return 0;
 }
 
-int trace_file_write(void *buffer, int length)
+/* stream is the CPU of the packets or TRACE_STREAM_METADATA */
+int trace_file_write(int stream, void *buffer, int length)
 {
-    write(_trace_fd, buffer, length);
+#ifdef TRACE_AGENT_USING_SOCKET
+    if (_trace_socket >= 0)
+    {
+        uint8_t frame[4];
+
+        frame[0] = (uint8_t)stream;
+        frame[1] = (uint8_t)((unsigned int)stream >> 8);
+        frame[2] = (uint8_t)length;
+        frame[3] = (uint8_t)(length >> 8);
+        if (send(_trace_socket, frame, sizeof(frame), 0) != sizeof(frame) ||
+            send(_trace_socket, buffer, length, 0) != length)
+        {
+            return -1;
+        }
+        return 0;
+    }
+#endif
+
+    if (_trace_file_opened == RT_FALSE || stream + 1 < 0 || stream + 1 > TB_CPUS_NR || _trace_fd[stream + 1] < 0)
+        return -1;
+    write(_trace_fd[stream + 1], buffer, length);
 
     return 0;
 }
 
 int trace_file_close(void)
 {
-    if (_trace_fd >= 0)
+    int index;
+
+#ifdef TRACE_AGENT_USING_SOCKET
+    if (_trace_socket >= 0)
     {
-        close(_trace_fd);
-        _trace_fd = -1;
+        closesocket(_trace_socket);
+        _trace_socket = -1;
+        printf("close trace socket OK!\n");
+        return 0;
+    }
+#endif
 
-        printf("close trace file OK!");
+    if (_trace_file_opened == RT_FALSE)
+        return 0;
+    if (_trace_fd[0] >= 0)
+    {
+        printf("close trace file OK!\n");
+    }
+    for (index = 0; index < TB_CPUS_NR + 1; index++)
+    {
+        if (_trace_fd[index] >= 0)
+        {
+            close(_trace_fd[index]);
+            _trace_fd[index] = -1;
+        }
     }
+    _trace_file_opened = RT_FALSE;
 
     return 0;
 }
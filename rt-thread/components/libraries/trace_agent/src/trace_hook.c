@@ -4,6 +4,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-06-01     realthread   the first version
+ * 2026-10-18     RT-Thread    interned object IDs instead of names
  */
 #include <stdlib.h>
 #include <rtthread.h>
@@ -46,61 +47,52 @@ void int_leave_hook(void)
     return;
 }
 
-static void rt_scheduler_hook(struct rt_thread *from, struct rt_thread *to)
+rt_inline rt_uint16_t trace_object_id(struct rt_object *object)
 {
-    ctf_bounded_string_t name_to = {"unknown"};
-    ctf_bounded_string_t name_from = {"unknown"};
+    return ctf_object_id(object, object->name, object->type & (~RT_Object_Class_Static));
+}
 
+static void rt_scheduler_hook(struct rt_thread *from, struct rt_thread *to)
+{
     if (_hook.enable == RT_FALSE) return;
-    memcpy(&name_from, from->parent.name, RT_NAME_MAX);
-    memcpy(&name_to, to->parent.name, RT_NAME_MAX);
 
-    ctf_event_thread_switch_in(from->current_priority, name_from);
-    ctf_event_thread_switch_out(to->current_priority, name_to);
+    ctf_event_thread_switch_out(from->current_priority, trace_object_id(&from->parent));
+    ctf_event_thread_switch_in(to->current_priority, trace_object_id(&to->parent));
 }
 
 static void rt_timer_enter_hook(struct rt_timer *timer)
 {
-    ctf_bounded_string_t name = {"unknown"};
-
     if (_hook.enable == RT_FALSE) return;
 
-    memcpy(&name, timer->parent.name, RT_NAME_MAX);
-    ctf_event_timer_enter(name);
+    ctf_event_timer_enter(trace_object_id(&timer->parent));
 }
 
 static void rt_timer_exit_hook(struct rt_timer *timer)
 {
-    ctf_bounded_string_t name = {"unknown"};
-
     if (_hook.enable == RT_FALSE) return;
 
-    memcpy(&name, timer->parent.name, RT_NAME_MAX);
-    ctf_event_timer_exit(name);
+    ctf_event_timer_exit(trace_object_id(&timer->parent));
 }
 
 static void rt_object_take_hook(struct rt_object *object)
 {
-    ctf_bounded_string_t name = {"unknown"};
-
     if (_hook.enable == RT_FALSE) return;
-    memcpy(&name, object->name, RT_NAME_MAX);
     switch (object->type & (~RT_Object_Class_Static))
     {
         case RT_Object_Class_Semaphore:
-            ctf_event_sem_take(name);
+            ctf_event_sem_take(trace_object_id(object));
             break;
         case RT_Object_Class_Mutex:
-            ctf_event_mutex_take(name);
+            ctf_event_mutex_take(trace_object_id(object));
             break;
         case RT_Object_Class_Event:
-            ctf_event_event_recv(name, ((rt_event_t)object)->set);
+            ctf_event_event_recv(trace_object_id(object), ((rt_event_t)object)->set);
             break;
         case RT_Object_Class_MailBox:
-            ctf_event_mb_recv(name);
+            ctf_event_mb_recv(trace_object_id(object));
             break;
         case RT_Object_Class_MessageQueue:
-            ctf_event_mq_recv(name);
+            ctf_event_mq_recv(trace_object_id(object));
             break;
         default:
             break;
@@ -109,32 +101,45 @@ static void rt_object_take_hook(struct rt_object *object)
 
 static void rt_object_put_hook(struct rt_object *object)
 {
-    ctf_bounded_string_t name = {"unknown"};
-
     if (_hook.enable == RT_FALSE) return;
-    memcpy(&name, object->name, RT_NAME_MAX);
     switch (object->type & (~RT_Object_Class_Static))
     {
         case RT_Object_Class_Semaphore:
-            ctf_event_sem_release(name);
+            ctf_event_sem_release(trace_object_id(object));
             break;
         case RT_Object_Class_Mutex:
-            ctf_event_mutex_release(name);
+            ctf_event_mutex_release(trace_object_id(object));
             break;
         case RT_Object_Class_Event:
-            ctf_event_event_send(name, ((rt_event_t)object)->set);
+            ctf_event_event_send(trace_object_id(object), ((rt_event_t)object)->set);
             break;
         case RT_Object_Class_MailBox:
-            ctf_event_mb_send(name);
+            ctf_event_mb_send(trace_object_id(object));
             break;
         case RT_Object_Class_MessageQueue:
-            ctf_event_mq_send(name);
+            ctf_event_mq_send(trace_object_id(object));
             break;
         default:
             break;
     }
 }
 
+/* a new object may reuse the address of an interned one */
+static void rt_object_attach_hook(struct rt_object *object)
+{
+    if (_hook.enable == RT_FALSE) return;
+
+    ctf_object_renamed(object, object->name, object->type & (~RT_Object_Class_Static));
+}
+
+/* the ID of the object is free for the next one */
+static void rt_object_detach_hook(struct rt_object *object)
+{
+    if (_hook.enable == RT_FALSE) return;
+
+    ctf_object_release(object);
+}
+
 int trace_hook_set_enable(rt_bool_t enable)
 {
     if (enable == RT_TRUE)
@@ -146,6 +151,8 @@ int trace_hook_set_enable(rt_bool_t enable)
         rt_timer_exit_sethook(rt_timer_exit_hook);
         rt_object_take_sethook(rt_object_take_hook);
         rt_object_put_sethook(rt_object_put_hook);
+        rt_object_attach_sethook(rt_object_attach_hook);
+        rt_object_detach_sethook(rt_object_detach_hook);
 
 #ifdef CTF_USE_TIMESTAMP
     _   rt_trace_timestamp_set(rt_trace_get_time);
@@ -160,7 +167,9 @@ int trace_hook_set_enable(rt_bool_t enable)
         rt_timer_enter_sethook(RT_NULL);
         rt_timer_exit_sethook(RT_NULL);
         rt_object_take_sethook(RT_NULL);
-        rt_object_put_sethook(RT_NULL);        
+        rt_object_put_sethook(RT_NULL);
+        rt_object_attach_sethook(RT_NULL);
+        rt_object_detach_sethook(RT_NULL);
     }
 
     return 0;
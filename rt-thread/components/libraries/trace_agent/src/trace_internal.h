@@ -4,6 +4,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-06-01     realthread   the first version
+ * 2026-10-18     RT-Thread    per-CPU CTF streams
  */
 #ifndef TRACE_INTERNAL_H__
 #define TRACE_INTERNAL_H__
@@ -12,6 +13,19 @@
 #define TA_STATUS_STOPPING      0x02
 #define TA_STATUS_STOPPED       0x03
 
+#ifndef TRACE_AGENT_BLOCK_SIZE
+#define TRACE_AGENT_BLOCK_SIZE  (1024 * 8)
+#endif
+#ifndef TRACE_AGENT_BLOCK_NUM
+#define TRACE_AGENT_BLOCK_NUM   4
+#endif
+#ifndef TRACE_AGENT_OBJECT_MAX
+#define TRACE_AGENT_OBJECT_MAX  128
+#endif
+
+/* the stream of trace_file_write() for the metadata, the others are the CPUs */
+#define TRACE_STREAM_METADATA   (-1)
+
 struct trace_agent
 {
     rt_thread_t tid;
@@ -28,13 +42,16 @@ struct trace_agent
 int trace_port_init(void);
 int trace_hook_set_enable(rt_bool_t enable);
 
-int trace_file_open(void);
-int trace_file_write(void *buffer, int length);
+int trace_file_open(const char *target);
+int trace_file_write(int stream, void *buffer, int length);
 int trace_file_close(void);
 
 rt_ubase_t trace_lock(void);
 void trace_unlock(rt_ubase_t status);
 
 int trace_pdu_init(struct trace_agent *ta);
+struct trace_agent *trace_pdu_get(void);
+
+rt_uint32_t trace_port_get_freq(void);
 
 #endif
@@ -0,0 +1,85 @@
+import os
+import sys
+import socket
+import struct
+import getopt
+
+# frames of 'trace start host:port': u16 stream, u16 length, little endian, then the data
+STREAM_METADATA = 0xffff
+
+def recv_all(conn, size):
+    data = b''
+    while len(data) < size:
+        chunk = conn.recv(size - len(data))
+        if not chunk:
+            return None
+        data += chunk
+
+    return data
+
+def receive(conn, output_dir):
+    files = {}
+    total = 0
+
+    while True:
+        header = recv_all(conn, 4)
+        if header == None:
+            break
+
+        (stream, length) = struct.unpack('<HH', header)
+        data = recv_all(conn, length)
+        if data == None:
+            print('connection closed in a frame')
+            break
+
+        if stream not in files:
+            if stream == STREAM_METADATA:
+                fn = 'metadata'
+            else:
+                fn = 'stream_%d' % stream
+            files[stream] = open(os.path.join(output_dir, fn), 'wb')
+        files[stream].write(data)
+        total += length
+
+    for f in files.values():
+        f.close()
+    print('%d bytes in %d files' % (total, len(files)))
+
+def Usage():
+    print('Usage: trace_recv [-p port] [-o trace_dir]')
+    exit(0)
+
+if __name__ == '__main__':
+    print('Trace Receiver')
+
+    port = 5555
+    output_dir = 'trace'
+
+    try:
+        opts,args = getopt.getopt(sys.argv[1:], "hp:o:", ["help", "port", "output"])
+    except Exception as e:
+        print(e)
+        Usage()
+
+    for opt,arg in opts:
+        if opt in ('-h'):
+            Usage()
+        elif opt in ('-p'):
+            port = int(arg)
+        elif opt in ('-o'):
+            output_dir = arg
+
+    if not os.path.isdir(output_dir):
+        os.makedirs(output_dir)
+
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(('', port))
+    server.listen(1)
+    print('waiting for the trace on port %d' % port)
+
+    conn, addr = server.accept()
+    print('trace from %s:%d' % addr)
+    receive(conn, output_dir)
+    conn.close()
+    server.close()
@@ -4,6 +4,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-01-18     tyx          first implementation
+ * 2026-10-18     RT-Thread    add zero-copy reader and writer
  */
 
 #ifndef __UBJ_H__
@@ -447,6 +448,87 @@ ubjsonr_t *ubj_read_file(const char *path);
 ubj_err_t ubj_to_json(ubjsonr_t *ubj, char **buff, size_t *len); /* UBJSON to JSON */
 ubj_err_t json_to_ubj(ubjsonw_t *ubj, const char *json, size_t len);   /* JSON to UBJSON */
 
+/*
+ * Zero-copy API: the reader walks a contiguous buffer and returns strings, keys and
+ * typed arrays as spans pointing into it, the writer builds into a preallocated buffer.
+ * Nothing is allocated, the buffer must outlive the values read from it.
+ */
+struct ubjz_container
+{
+    uint8_t flags;          // Container related marking
+    int8_t type;            // Type of the elements of a typed container
+    int32_t remaining;      // Elements left in a sized container
+};
+
+typedef struct
+{
+    ubj_type_t type;                        /* type of the value, or of the container left */
+    ubj_err_t error;                        /* error code */
+    uint8_t flags;                          /* flags of the container entered or left */
+    uint8_t act;                            /* UBJ_CONTAINER_ENTER_FLAG or UBJ_CONTAINER_EXIT_FLAG */
+    int16_t level;                          /* depth of the container of the value */
+    ubj_str_t key;                          /* key in an object, not terminated */
+    union
+    {
+        char vchar;
+        uint8_t vbool;
+        uint8_t vuint8;
+        int8_t vint8;
+        int16_t vint16;
+        int32_t vint32;
+        float vfloat;
+        double vdouble;
+        int64_t vint64;
+        ubj_str_t vstring;                  /* string and high precision, not terminated */
+        struct
+        {
+            ubj_type_t type;                /* type of the elements */
+            size_t count;
+            const uint8_t *data;            /* big endian elements */
+        } varray;                           /* sized array of fixed size numbers, read as a whole */
+    } value;
+} ubjz_value_t;
+
+typedef struct ubjsonz_reader
+{
+    const uint8_t *begin;
+    const uint8_t *current;
+    const uint8_t *end;
+    struct ubjz_container stack[UBJ_CONTAINER_STACK_DEPTH];
+    int16_t stack_point;
+    uint8_t done;
+    ubjz_value_t value;
+} ubjzr_t;
+
+typedef struct ubjsonz_writer
+{
+    uint8_t *begin;
+    uint8_t *current;
+    uint8_t *end;
+    ubj_err_t error;                        /* the first error, later writes are dropped */
+} ubjzw_t;
+
+ubjzr_t *ubjz_read_init(ubjzr_t *ubj, const void *buff, size_t len);
+const ubjz_value_t *ubjz_read_next(ubjzr_t *ubj);
+ubj_err_t ubjz_skip_container(ubjzr_t *ubj);
+size_t ubjz_read_array(const ubjz_value_t *value, void *out, size_t count);
+
+ubjzw_t *ubjz_write_init(ubjzw_t *ubj, void *buff, size_t size);
+size_t ubjz_write_end(ubjzw_t *ubj);
+ubj_err_t ubjz_begin_array(ubjzw_t *ubj);
+ubj_err_t ubjz_end_array(ubjzw_t *ubj);
+ubj_err_t ubjz_begin_object(ubjzw_t *ubj);
+ubj_err_t ubjz_end_object(ubjzw_t *ubj);
+ubj_err_t ubjz_write_key(ubjzw_t *ubj, const char *key, size_t len);
+ubj_err_t ubjz_write_string(ubjzw_t *ubj, const char *v, size_t len);
+ubj_err_t ubjz_write_char(ubjzw_t *ubj, char v);
+ubj_err_t ubjz_write_integer(ubjzw_t *ubj, int64_t v);
+ubj_err_t ubjz_write_float32(ubjzw_t *ubj, float v);
+ubj_err_t ubjz_write_float64(ubjzw_t *ubj, double v);
+ubj_err_t ubjz_write_null(ubjzw_t *ubj);
+ubj_err_t ubjz_write_bool(ubjzw_t *ubj, int v);
+ubj_err_t ubjz_write_array(ubjzw_t *ubj, ubj_type_t type, const void *data, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
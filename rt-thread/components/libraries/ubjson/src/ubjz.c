@@ -0,0 +1,632 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    first implementation
+ */
+
+#include "ubj.h"
+#include "ubj_internal.h"
+#include <string.h>
+
+#define UBJ_ERROR_PRINT ubj_printf
+
+static const char *ubj_ctab = UBJ_TYPE_TAB;
+
+/* bytes of the payload of fixed size types, 0 for the rest */
+static const uint8_t ubjz_size_tab[UBJ_NUM_TYPES] =
+{
+    0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 2, 4, 8, 4, 8, 0, 0
+};
+
+static ubj_type_t ubjz_get_type(uint8_t t)
+{
+    switch (t)
+    {
+    case 'Z': return UBJ_TYPE_NULL;
+    case 'N': return UBJ_TYPE_NOOP;
+    case 'T': return UBJ_TYPE_TRUE;
+    case 'F': return UBJ_TYPE_FALSE;
+    case 'C': return UBJ_TYPE_CHAR;
+    case 'S': return UBJ_TYPE_STRING;
+    case 'H': return UBJ_TYPE_HIGH_PRECISION;
+    case 'i': return UBJ_TYPE_INT8;
+    case 'U': return UBJ_TYPE_UINT8;
+    case 'I': return UBJ_TYPE_INT16;
+    case 'l': return UBJ_TYPE_INT32;
+    case 'L': return UBJ_TYPE_INT64;
+    case 'd': return UBJ_TYPE_FLOAT32;
+    case 'D': return UBJ_TYPE_FLOAT64;
+    case '[': return UBJ_TYPE_ARRAY;
+    case '{': return UBJ_TYPE_OBJECT;
+    default: return UBJ_NUM_TYPES;
+    }
+}
+
+static uint16_t ubjz_be16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t ubjz_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint64_t ubjz_be64(const uint8_t *p)
+{
+    return ((uint64_t)ubjz_be32(p) << 32) | ubjz_be32(p + 4);
+}
+
+ubjzr_t *ubjz_read_init(ubjzr_t *ubj, const void *buff, size_t len)
+{
+    if (ubj == NULL || (buff == NULL && len != 0))
+        return NULL;
+
+    memset(ubj, 0, sizeof(*ubj));
+    ubj->begin = (const uint8_t *)buff;
+    ubj->current = ubj->begin;
+    ubj->end = ubj->begin + len;
+    ubj->stack[0].remaining = -1;
+    return ubj;
+}
+
+static ubj_err_t ubjz_read_integer(ubjzr_t *ubj, int64_t *v)
+{
+    const uint8_t *p = ubj->current;
+    size_t left = (size_t)(ubj->end - p);
+    size_t size;
+
+    if (left < 1)
+        return -UBJ_PARSE_ERROR;
+    switch (p[0])
+    {
+    case 'i':
+        size = 1;
+        break;
+    case 'U':
+        size = 1;
+        break;
+    case 'I':
+        size = 2;
+        break;
+    case 'l':
+        size = 4;
+        break;
+    case 'L':
+        size = 8;
+        break;
+    default:
+        UBJ_ERROR_PRINT("Integer type exception. %c:%02x\n", p[0], p[0]);
+        return -UBJ_PARSE_ERROR;
+    }
+    if (left < size + 1)
+        return -UBJ_PARSE_ERROR;
+    switch (p[0])
+    {
+    case 'i':
+        *v = (int8_t)p[1];
+        break;
+    case 'U':
+        *v = p[1];
+        break;
+    case 'I':
+        *v = (int16_t)ubjz_be16(p + 1);
+        break;
+    case 'l':
+        *v = (int32_t)ubjz_be32(p + 1);
+        break;
+    default:
+        *v = (int64_t)ubjz_be64(p + 1);
+        break;
+    }
+    ubj->current = p + 1 + size;
+    return UBJ_OK;
+}
+
+/* a length and that many bytes, as in keys and strings */
+static ubj_err_t ubjz_read_span(ubjzr_t *ubj, ubj_str_t *str)
+{
+    int64_t length;
+    ubj_err_t err;
+
+    if ((err = ubjz_read_integer(ubj, &length)) != UBJ_OK)
+        return err;
+    if (length < 0 || (uint64_t)length > (uint64_t)(ubj->end - ubj->current))
+        return -UBJ_PARSE_ERROR;
+    str->ptr = (char *)ubj->current;
+    str->size = (size_t)length;
+    ubj->current += (size_t)length;
+    return UBJ_OK;
+}
+
+static ubj_err_t ubjz_read_scalar(ubjzr_t *ubj, ubjz_value_t *value)
+{
+    const uint8_t *p = ubj->current;
+    size_t size = ubjz_size_tab[value->type];
+    uint32_t u32;
+    uint64_t u64;
+
+    if ((size_t)(ubj->end - p) < size)
+        return -UBJ_PARSE_ERROR;
+    switch (value->type)
+    {
+    case UBJ_TYPE_NULL:
+    case UBJ_TYPE_NOOP:
+        break;
+    case UBJ_TYPE_TRUE:
+        value->value.vbool = 1;
+        break;
+    case UBJ_TYPE_FALSE:
+        value->value.vbool = 0;
+        break;
+    case UBJ_TYPE_CHAR:
+        value->value.vchar = (char)p[0];
+        break;
+    case UBJ_TYPE_INT8:
+        value->value.vint8 = (int8_t)p[0];
+        break;
+    case UBJ_TYPE_UINT8:
+        value->value.vuint8 = p[0];
+        break;
+    case UBJ_TYPE_INT16:
+        value->value.vint16 = (int16_t)ubjz_be16(p);
+        break;
+    case UBJ_TYPE_INT32:
+        value->value.vint32 = (int32_t)ubjz_be32(p);
+        break;
+    case UBJ_TYPE_INT64:
+        value->value.vint64 = (int64_t)ubjz_be64(p);
+        break;
+    case UBJ_TYPE_FLOAT32:
+        u32 = ubjz_be32(p);
+        memcpy(&value->value.vfloat, &u32, sizeof(u32));
+        break;
+    case UBJ_TYPE_FLOAT64:
+        u64 = ubjz_be64(p);
+        memcpy(&value->value.vdouble, &u64, sizeof(u64));
+        break;
+    case UBJ_TYPE_STRING:
+    case UBJ_TYPE_HIGH_PRECISION:
+        return ubjz_read_span(ubj, &value->value.vstring);
+    default:
+        return -UBJ_PARSE_ERROR;
+    }
+    ubj->current = p + size;
+    return UBJ_OK;
+}
+
+static ubj_err_t ubjz_begin_container(ubjzr_t *ubj, ubjz_value_t *value)
+{
+    struct ubjz_container *container;
+    ubj_type_t type = UBJ_TYPE_MIXED;
+    uint8_t flags = value->type == UBJ_TYPE_ARRAY ? UBJ_CONTAINER_IS_ARRAY : UBJ_CONTAINER_IS_OBJECT;
+    int64_t count = -1;
+    size_t size;
+    ubj_err_t err;
+
+    if (ubj->current < ubj->end && *ubj->current == '$')
+    {
+        if (ubj->end - ubj->current < 2)
+            return -UBJ_PARSE_ERROR;
+        type = ubjz_get_type(ubj->current[1]);
+        if (type == UBJ_NUM_TYPES || type == UBJ_TYPE_NOOP)
+            return -UBJ_PARSE_ERROR;
+        ubj->current += 2;
+        flags |= UBJ_CONTAINER_IS_TYPED;
+        /* a type is always followed by a count */
+        if (ubj->current == ubj->end || *ubj->current != '#')
+            return -UBJ_PARSE_ERROR;
+    }
+    if (ubj->current < ubj->end && *ubj->current == '#')
+    {
+        ubj->current++;
+        if ((err = ubjz_read_integer(ubj, &count)) != UBJ_OK)
+            return err;
+        if (count < 0 || count > UBJ_INT32_MAX)
+            return -UBJ_PARSE_ERROR;
+        flags |= UBJ_CONTAINER_IS_SIZED;
+    }
+
+    size = ubjz_size_tab[type];
+    if ((flags & UBJ_CONTAINER_IS_TYPED) && (flags & UBJ_CONTAINER_IS_ARRAY) && size != 0)
+    {
+        /* numbers in a row: the whole array is a span of the buffer */
+        if ((uint64_t)count * size > (uint64_t)(ubj->end - ubj->current))
+            return -UBJ_PARSE_ERROR;
+        value->flags = flags | UBJ_CONTAINER_BUFFER_FLAG;
+        value->value.varray.type = type;
+        value->value.varray.count = (size_t)count;
+        value->value.varray.data = ubj->current;
+        ubj->current += (size_t)count * size;
+        return UBJ_OK;
+    }
+
+    if (ubj->stack_point + 1 >= UBJ_CONTAINER_STACK_DEPTH)
+    {
+        UBJ_ERROR_PRINT("Maximum stack depth reached.%d\n", UBJ_CONTAINER_STACK_DEPTH);
+        return -UBJ_NOMEM_ERROR;
+    }
+    container = &ubj->stack[++ubj->stack_point];
+    container->flags = flags;
+    container->type = (int8_t)type;
+    container->remaining = (int32_t)count;
+    value->flags = flags;
+    value->act = UBJ_CONTAINER_ENTER_FLAG;
+    return UBJ_OK;
+}
+
+static const ubjz_value_t *ubjz_read_error(ubjzr_t *ubj, ubj_err_t err)
+{
+    ubj->value.error = err;
+    ubj->done = 1;
+    return &ubj->value;
+}
+
+const ubjz_value_t *ubjz_read_next(ubjzr_t *ubj)
+{
+    struct ubjz_container *container = &ubj->stack[ubj->stack_point];
+    ubjz_value_t *value = &ubj->value;
+    ubj_err_t err;
+    uint8_t tag;
+
+    if (ubj->done)
+        return value->error != UBJ_OK ? value : NULL;
+
+    value->error = UBJ_OK;
+    value->flags = 0;
+    value->act = 0;
+    value->level = ubj->stack_point;
+    value->key.ptr = NULL;
+    value->key.size = 0;
+
+    if (ubj->stack_point > 0)
+    {
+        /* skip the no-ops between the values of unsized containers */
+        if (!(container->flags & UBJ_CONTAINER_IS_SIZED))
+        {
+            while (ubj->current < ubj->end && *ubj->current == 'N')
+                ubj->current++;
+        }
+        if ((container->flags & UBJ_CONTAINER_IS_SIZED) ? container->remaining == 0 :
+            (ubj->current < ubj->end &&
+             *ubj->current == ((container->flags & UBJ_CONTAINER_IS_ARRAY) ? ']' : '}')))
+        {
+            if (!(container->flags & UBJ_CONTAINER_IS_SIZED))
+                ubj->current++;
+            value->type = (container->flags & UBJ_CONTAINER_IS_ARRAY) ? UBJ_TYPE_ARRAY : UBJ_TYPE_OBJECT;
+            value->flags = container->flags;
+            value->act = UBJ_CONTAINER_EXIT_FLAG;
+            if (--ubj->stack_point == 0)
+                ubj->done = 1;
+            return value;
+        }
+        if (container->flags & UBJ_CONTAINER_IS_OBJECT)
+        {
+            if ((err = ubjz_read_span(ubj, &value->key)) != UBJ_OK)
+                return ubjz_read_error(ubj, err);
+        }
+        if (container->flags & UBJ_CONTAINER_IS_SIZED)
+            container->remaining--;
+    }
+
+    if (container->flags & UBJ_CONTAINER_IS_TYPED)
+    {
+        value->type = (ubj_type_t)container->type;
+    }
+    else
+    {
+        if (ubj->current == ubj->end)
+            return ubjz_read_error(ubj, -UBJ_PARSE_ERROR);
+        tag = *ubj->current++;
+        value->type = ubjz_get_type(tag);
+        if (value->type == UBJ_NUM_TYPES)
+        {
+            UBJ_ERROR_PRINT("unknown type. %c:%02x\n", tag, tag);
+            return ubjz_read_error(ubj, -UBJ_PARSE_ERROR);
+        }
+    }
+
+    if (value->type == UBJ_TYPE_ARRAY || value->type == UBJ_TYPE_OBJECT)
+        err = ubjz_begin_container(ubj, value);
+    else
+        err = ubjz_read_scalar(ubj, value);
+    if (err != UBJ_OK)
+        return ubjz_read_error(ubj, err);
+
+    if (ubj->stack_point == 0)
+        ubj->done = 1;
+    return value;
+}
+
+/* skip the rest of the container entered last, its exit is not returned */
+ubj_err_t ubjz_skip_container(ubjzr_t *ubj)
+{
+    int16_t level = ubj->stack_point;
+    const ubjz_value_t *value;
+
+    if (level == 0)
+        return -UBJ_PARAM_ERROR;
+    do
+    {
+        value = ubjz_read_next(ubj);
+        if (value == NULL)
+            return -UBJ_PARSE_ERROR;
+        if (value->error != UBJ_OK)
+            return value->error;
+    } while (ubj->stack_point >= level);
+    return UBJ_OK;
+}
+
+/* copy the elements of a typed array into host order */
+size_t ubjz_read_array(const ubjz_value_t *value, void *out, size_t count)
+{
+    const uint8_t *p = value->value.varray.data;
+    size_t size, i;
+
+    if (!(value->flags & UBJ_CONTAINER_BUFFER_FLAG) || out == NULL)
+        return 0;
+    if (count > value->value.varray.count)
+        count = value->value.varray.count;
+    size = ubjz_size_tab[value->value.varray.type];
+    switch (size)
+    {
+    case 1:
+        memcpy(out, p, count);
+        break;
+    case 2:
+        for (i = 0; i < count; i++, p += 2)
+            ((uint16_t *)out)[i] = ubjz_be16(p);
+        break;
+    case 4:
+        for (i = 0; i < count; i++, p += 4)
+            ((uint32_t *)out)[i] = ubjz_be32(p);
+        break;
+    case 8:
+        for (i = 0; i < count; i++, p += 8)
+            ((uint64_t *)out)[i] = ubjz_be64(p);
+        break;
+    default:
+        return 0;
+    }
+    return count;
+}
+
+ubjzw_t *ubjz_write_init(ubjzw_t *ubj, void *buff, size_t size)
+{
+    if (ubj == NULL || (buff == NULL && size != 0))
+        return NULL;
+
+    ubj->begin = (uint8_t *)buff;
+    ubj->current = ubj->begin;
+    ubj->end = ubj->begin + size;
+    ubj->error = UBJ_OK;
+    return ubj;
+}
+
+/* the bytes written, 0 if the buffer was too small */
+size_t ubjz_write_end(ubjzw_t *ubj)
+{
+    return ubj->error == UBJ_OK ? (size_t)(ubj->current - ubj->begin) : 0;
+}
+
+/* room for size more bytes, the first failure sticks */
+static uint8_t *ubjz_reserve(ubjzw_t *ubj, size_t size)
+{
+    uint8_t *p = ubj->current;
+
+    if (ubj->error != UBJ_OK)
+        return NULL;
+    if ((size_t)(ubj->end - p) < size)
+    {
+        ubj->error = -UBJ_NOMEM_ERROR;
+        return NULL;
+    }
+    ubj->current = p + size;
+    return p;
+}
+
+static ubj_err_t ubjz_write_tag(ubjzw_t *ubj, char tag)
+{
+    uint8_t *p = ubjz_reserve(ubj, 1);
+
+    if (p == NULL)
+        return ubj->error;
+    *p = (uint8_t)tag;
+    return UBJ_OK;
+}
+
+static void ubjz_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static void ubjz_put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void ubjz_put64(uint8_t *p, uint64_t v)
+{
+    ubjz_put32(p, (uint32_t)(v >> 32));
+    ubjz_put32(p + 4, (uint32_t)v);
+}
+
+ubj_err_t ubjz_begin_array(ubjzw_t *ubj)
+{
+    return ubjz_write_tag(ubj, '[');
+}
+
+ubj_err_t ubjz_end_array(ubjzw_t *ubj)
+{
+    return ubjz_write_tag(ubj, ']');
+}
+
+ubj_err_t ubjz_begin_object(ubjzw_t *ubj)
+{
+    return ubjz_write_tag(ubj, '{');
+}
+
+ubj_err_t ubjz_end_object(ubjzw_t *ubj)
+{
+    return ubjz_write_tag(ubj, '}');
+}
+
+/* the smallest integer type that holds the value */
+ubj_err_t ubjz_write_integer(ubjzw_t *ubj, int64_t v)
+{
+    uint8_t *p;
+
+    if (v >= 0 && v <= 0xFF)
+    {
+        if ((p = ubjz_reserve(ubj, 2)) == NULL)
+            return ubj->error;
+        p[0] = 'U';
+        p[1] = (uint8_t)v;
+    }
+    else if (v >= -128 && v < 0)
+    {
+        if ((p = ubjz_reserve(ubj, 2)) == NULL)
+            return ubj->error;
+        p[0] = 'i';
+        p[1] = (uint8_t)(int8_t)v;
+    }
+    else if (v >= -32768 && v <= UBJ_INT16_MAX)
+    {
+        if ((p = ubjz_reserve(ubj, 3)) == NULL)
+            return ubj->error;
+        p[0] = 'I';
+        ubjz_put16(p + 1, (uint16_t)v);
+    }
+    else if (v >= (int64_t)UBJ_INT32_MIN && v <= UBJ_INT32_MAX)
+    {
+        if ((p = ubjz_reserve(ubj, 5)) == NULL)
+            return ubj->error;
+        p[0] = 'l';
+        ubjz_put32(p + 1, (uint32_t)v);
+    }
+    else
+    {
+        if ((p = ubjz_reserve(ubj, 9)) == NULL)
+            return ubj->error;
+        p[0] = 'L';
+        ubjz_put64(p + 1, (uint64_t)v);
+    }
+    return UBJ_OK;
+}
+
+static ubj_err_t ubjz_write_span(ubjzw_t *ubj, const char *v, size_t len)
+{
+    uint8_t *p;
+
+    if (ubjz_write_integer(ubj, (int64_t)len) != UBJ_OK)
+        return ubj->error;
+    if ((p = ubjz_reserve(ubj, len)) == NULL)
+        return ubj->error;
+    memcpy(p, v, len);
+    return UBJ_OK;
+}
+
+ubj_err_t ubjz_write_key(ubjzw_t *ubj, const char *key, size_t len)
+{
+    return ubjz_write_span(ubj, key, len);
+}
+
+ubj_err_t ubjz_write_string(ubjzw_t *ubj, const char *v, size_t len)
+{
+    if (ubjz_write_tag(ubj, 'S') != UBJ_OK)
+        return ubj->error;
+    return ubjz_write_span(ubj, v, len);
+}
+
+ubj_err_t ubjz_write_char(ubjzw_t *ubj, char v)
+{
+    uint8_t *p = ubjz_reserve(ubj, 2);
+
+    if (p == NULL)
+        return ubj->error;
+    p[0] = 'C';
+    p[1] = (uint8_t)v;
+    return UBJ_OK;
+}
+
+ubj_err_t ubjz_write_float32(ubjzw_t *ubj, float v)
+{
+    uint8_t *p = ubjz_reserve(ubj, 5);
+    uint32_t u32;
+
+    if (p == NULL)
+        return ubj->error;
+    memcpy(&u32, &v, sizeof(u32));
+    p[0] = 'd';
+    ubjz_put32(p + 1, u32);
+    return UBJ_OK;
+}
+
+ubj_err_t ubjz_write_float64(ubjzw_t *ubj, double v)
+{
+    uint8_t *p = ubjz_reserve(ubj, 9);
+    uint64_t u64;
+
+    if (p == NULL)
+        return ubj->error;
+    memcpy(&u64, &v, sizeof(u64));
+    p[0] = 'D';
+    ubjz_put64(p + 1, u64);
+    return UBJ_OK;
+}
+
+ubj_err_t ubjz_write_null(ubjzw_t *ubj)
+{
+    return ubjz_write_tag(ubj, 'Z');
+}
+
+ubj_err_t ubjz_write_bool(ubjzw_t *ubj, int v)
+{
+    return ubjz_write_tag(ubj, v ? 'T' : 'F');
+}
+
+/* a typed and sized array of numbers from a host order array */
+ubj_err_t ubjz_write_array(ubjzw_t *ubj, ubj_type_t type, const void *data, size_t count)
+{
+    size_t size = (int)type >= 0 && type < UBJ_NUM_TYPES ? ubjz_size_tab[type] : 0;
+    const uint8_t *in = (const uint8_t *)data;
+    uint8_t *p;
+    size_t i;
+
+    if (size == 0 || count > UBJ_INT32_MAX || count > (size_t)-1 / size || (data == NULL && count != 0))
+        return -UBJ_PARAM_ERROR;
+    if ((p = ubjz_reserve(ubj, 3)) == NULL)
+        return ubj->error;
+    p[0] = '[';
+    p[1] = '$';
+    p[2] = (uint8_t)ubj_ctab[type];
+    if (ubjz_write_tag(ubj, '#') != UBJ_OK || ubjz_write_integer(ubj, (int64_t)count) != UBJ_OK)
+        return ubj->error;
+    if ((p = ubjz_reserve(ubj, count * size)) == NULL)
+        return ubj->error;
+    switch (size)
+    {
+    case 1:
+        memcpy(p, in, count);
+        break;
+    case 2:
+        for (i = 0; i < count; i++, p += 2)
+            ubjz_put16(p, ((const uint16_t *)in)[i]);
+        break;
+    case 4:
+        for (i = 0; i < count; i++, p += 4)
+            ubjz_put32(p, ((const uint32_t *)in)[i]);
+        break;
+    default:
+        for (i = 0; i < count; i++, p += 8)
+            ubjz_put64(p, ((const uint64_t *)in)[i]);
+        break;
+    }
+    return UBJ_OK;
+}
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * UBJSON round-trip benchmark.
+ *
+ * A batch of telemetry records, each with a block of int16 samples, is encoded and decoded
+ * three ways: the zero-copy writer into a preallocated buffer and the zero-copy reader with
+ * the samples copied out as one typed array, the ubjw memory writer and the ubjr reader, and
+ * cJSON with cJSON_PrintPreallocated and cJSON_Parse. The encoded size and the encode and
+ * decode times are reported, the decoded sums are compared with what was encoded.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ubj.h"
+
+#if defined(UBJSON_USING_BENCH) && defined(URPC_USING_CJSON) && defined(RT_USING_FINSH)
+
+#include "cJSON.h"
+
+#include <msh_bench.h>
+
+#define BENCH_SAMPLES           32
+/* the largest record in any of the encodings, JSON being the widest */
+#define BENCH_RECORD_MAX        (96 + BENCH_SAMPLES * 7)
+
+struct bench_record
+{
+    rt_int32_t id;
+    rt_int32_t time;
+    float temp;
+    char node[16];
+    rt_int16_t samples[BENCH_SAMPLES];
+};
+
+struct bench_sum
+{
+    rt_int64_t ids;
+    rt_int64_t samples;
+    rt_int32_t temps;
+    int records;
+};
+
+struct bench_result
+{
+    rt_size_t bytes;
+    rt_uint32_t encode;
+    rt_uint32_t decode;
+    struct bench_sum sum;
+};
+
+static void bench_fill(struct bench_record *records, int count, struct bench_sum *sum)
+{
+    int i, j;
+
+    rt_memset(sum, 0, sizeof(*sum));
+    for (i = 0; i < count; i++)
+    {
+        records[i].id = i;
+        records[i].time = 1700000000 + i * 10;
+        records[i].temp = 18.0f + (i % 80) / 8.0f;
+        rt_snprintf(records[i].node, sizeof(records[i].node), "room %d", i % 64);
+        for (j = 0; j < BENCH_SAMPLES; j++)
+            records[i].samples[j] = (rt_int16_t)((i * 131 + j * 977) % 65536 - 32768);
+
+        sum->ids += records[i].id;
+        sum->temps += (rt_int32_t)(records[i].temp * 8);
+        for (j = 0; j < BENCH_SAMPLES; j++)
+            sum->samples += records[i].samples[j];
+        sum->records++;
+    }
+}
+
+static rt_bool_t bench_key(const char *key, rt_size_t len, const char *name)
+{
+    return key != RT_NULL && len == rt_strlen(name) && rt_memcmp(key, name, len) == 0;
+}
+
+static int bench_ubjz(const struct bench_record *records, int count, rt_uint8_t *buf, rt_size_t size,
+                      struct bench_result *result)
+{
+    const struct bench_record *r;
+    const ubjz_value_t *v;
+    rt_int16_t samples[BENCH_SAMPLES];
+    ubjzw_t w;
+    ubjzr_t rd;
+    rt_uint32_t t;
+    rt_size_t n, i;
+    int err = 0;
+
+    t = BENCH_CLOCK();
+    ubjz_write_init(&w, buf, size);
+    ubjz_begin_object(&w);
+    ubjz_write_key(&w, "records", 7);
+    ubjz_begin_array(&w);
+    for (r = records; r < records + count; r++)
+    {
+        ubjz_begin_object(&w);
+        ubjz_write_key(&w, "id", 2);
+        ubjz_write_integer(&w, r->id);
+        ubjz_write_key(&w, "time", 4);
+        ubjz_write_integer(&w, r->time);
+        ubjz_write_key(&w, "temp", 4);
+        ubjz_write_float32(&w, r->temp);
+        ubjz_write_key(&w, "node", 4);
+        ubjz_write_string(&w, r->node, rt_strlen(r->node));
+        ubjz_write_key(&w, "samples", 7);
+        ubjz_write_array(&w, UBJ_TYPE_INT16, r->samples, BENCH_SAMPLES);
+        ubjz_end_object(&w);
+    }
+    ubjz_end_array(&w);
+    ubjz_end_object(&w);
+    result->bytes = ubjz_write_end(&w);
+    result->encode = BENCH_CLOCK() - t;
+    if (result->bytes == 0)
+        return -RT_ENOMEM;
+
+    t = BENCH_CLOCK();
+    ubjz_read_init(&rd, buf, result->bytes);
+    while ((v = ubjz_read_next(&rd)) != RT_NULL)
+    {
+        if (v->error != UBJ_OK)
+        {
+            err = -RT_ERROR;
+            break;
+        }
+        if (v->act == UBJ_CONTAINER_ENTER_FLAG && v->level == 2)
+            result->sum.records++;
+        else if (v->level == 3 && bench_key(v->key.ptr, v->key.size, "id"))
+            result->sum.ids += v->type == UBJ_TYPE_UINT8 ? v->value.vuint8 :
+                               v->type == UBJ_TYPE_INT16 ? v->value.vint16 : v->value.vint32;
+        else if (v->level == 3 && bench_key(v->key.ptr, v->key.size, "temp"))
+            result->sum.temps += (rt_int32_t)(v->value.vfloat * 8);
+        else if (v->level == 3 && bench_key(v->key.ptr, v->key.size, "samples"))
+        {
+            n = ubjz_read_array(v, samples, BENCH_SAMPLES);
+            for (i = 0; i < n; i++)
+                result->sum.samples += samples[i];
+        }
+    }
+    result->decode = BENCH_CLOCK() - t;
+
+    return err;
+}
+
+static int bench_ubjw(const struct bench_record *records, int count, struct bench_result *result)
+{
+    const struct bench_record *r;
+    const ubj_value_t *v;
+    ubjsonw_t *w;
+    ubjsonr_t *rd;
+    rt_uint8_t *buf;
+    rt_uint32_t t;
+    int err = 0;
+
+    t = BENCH_CLOCK();
+    w = ubj_write_memory();
+    if (w == RT_NULL)
+        return -RT_ENOMEM;
+    ubj_begin_object(w);
+    ubj_object_write_array(w, "records");
+    for (r = records; r < records + count; r++)
+    {
+        ubj_begin_object(w);
+        ubj_object_write_integer(w, "id", r->id);
+        ubj_object_write_integer(w, "time", r->time);
+        ubj_object_write_float32(w, "temp", r->temp);
+        ubj_object_write_string(w, "node", r->node);
+        ubj_object_write_buffer(w, "samples", (const uint8_t *)r->samples, UBJ_TYPE_INT16, BENCH_SAMPLES);
+        ubj_end_object(w);
+    }
+    ubj_end_array(w);
+    ubj_end_object(w);
+    err = w->error;
+    result->bytes = w->total;
+    buf = ubj_get_memory_and_close(w);
+    result->encode = BENCH_CLOCK() - t;
+    if (buf == RT_NULL || err != UBJ_OK)
+    {
+        ubj_free(buf);
+        return -RT_ENOMEM;
+    }
+
+    t = BENCH_CLOCK();
+    rd = ubj_read_static_memory(buf, result->bytes);
+    if (rd == RT_NULL)
+    {
+        ubj_free(buf);
+        return -RT_ENOMEM;
+    }
+    while ((v = ubj_read_next(rd)) != RT_NULL)
+    {
+        if (v->error != UBJ_OK)
+        {
+            err = -RT_ERROR;
+            break;
+        }
+        if (v->container.level == 3 && bench_key(v->container.key, v->container.keylen, "id"))
+        {
+            result->sum.records++;
+            result->sum.ids += v->type == UBJ_TYPE_UINT8 ? v->value.vuint8 :
+                               v->type == UBJ_TYPE_INT16 ? v->value.vint16 : v->value.vint32;
+        }
+        else if (v->container.level == 3 && bench_key(v->container.key, v->container.keylen, "temp"))
+            result->sum.temps += (rt_int32_t)(v->value.vfloat * 8);
+        else if (v->container.level == 4 && v->type == UBJ_TYPE_INT16)
+            result->sum.samples += v->value.vint16;
+    }
+    ubj_read_end(rd);
+    result->decode = BENCH_CLOCK() - t;
+    ubj_free(buf);
+
+    return err;
+}
+
+static int bench_cjson(const struct bench_record *records, int count, char *buf, rt_size_t size,
+                       struct bench_result *result)
+{
+    const struct bench_record *r;
+    cJSON *root, *array, *item, *field;
+    int samples[BENCH_SAMPLES], j, ok;
+    rt_uint32_t t;
+
+    t = BENCH_CLOCK();
+    root = cJSON_CreateObject();
+    array = cJSON_AddArrayToObject(root, "records");
+    for (r = records; r < records + count && array; r++)
+    {
+        item = cJSON_CreateObject();
+        cJSON_AddItemToArray(array, item);
+        cJSON_AddNumberToObject(item, "id", r->id);
+        cJSON_AddNumberToObject(item, "time", r->time);
+        cJSON_AddNumberToObject(item, "temp", r->temp);
+        cJSON_AddStringToObject(item, "node", r->node);
+        for (j = 0; j < BENCH_SAMPLES; j++)
+            samples[j] = r->samples[j];
+        cJSON_AddItemToObject(item, "samples", cJSON_CreateIntArray(samples, BENCH_SAMPLES));
+    }
+    ok = cJSON_PrintPreallocated(root, buf, size, 0);
+    cJSON_Delete(root);
+    result->encode = BENCH_CLOCK() - t;
+    if (!ok)
+        return -RT_ENOMEM;
+    result->bytes = rt_strlen(buf);
+
+    t = BENCH_CLOCK();
+    root = cJSON_Parse(buf);
+    if (root == RT_NULL)
+        return -RT_ERROR;
+    cJSON_ArrayForEach(item, cJSON_GetObjectItem(root, "records"))
+    {
+        result->sum.records++;
+        result->sum.ids += cJSON_GetObjectItem(item, "id")->valueint;
+        result->sum.temps += (rt_int32_t)(cJSON_GetNumberValue(cJSON_GetObjectItem(item, "temp")) * 8);
+        cJSON_ArrayForEach(field, cJSON_GetObjectItem(item, "samples"))
+            result->sum.samples += field->valueint;
+    }
+    cJSON_Delete(root);
+    result->decode = BENCH_CLOCK() - t;
+
+    return RT_EOK;
+}
+
+static void bench_report(const char *name, int err, const struct bench_result *result, const struct bench_sum *sum)
+{
+    if (err != RT_EOK)
+    {
+        rt_kprintf("%-6s error %d\n", name, err);
+        return;
+    }
+    rt_kprintf("%-6s %8d %9d %9d %s\n", name, result->bytes, BENCH_CLOCK_US(result->encode),
+               BENCH_CLOCK_US(result->decode), rt_memcmp(&result->sum, sum, sizeof(*sum)) ? "mismatch" : "ok");
+}
+
+static void ubj_bench(int argc, char **argv)
+{
+    struct bench_record *records;
+    struct bench_result result;
+    struct bench_sum sum;
+    rt_uint32_t count = 64;
+    rt_size_t size;
+    char *buf;
+    int err;
+
+    if (argc > 1) count = strtoul(argv[1], RT_NULL, 0);
+    if (count == 0)
+    {
+        rt_kprintf("Usage: ubj_bench [records]\n");
+        return;
+    }
+    size = 32 + count * BENCH_RECORD_MAX;
+    records = rt_malloc(count * sizeof(*records));
+    buf = rt_malloc(size);
+    if (records == RT_NULL || buf == RT_NULL)
+    {
+        rt_kprintf("no memory for %d records\n", count);
+        rt_free(records);
+        rt_free(buf);
+        return;
+    }
+    bench_fill(records, count, &sum);
+
+    rt_kprintf("%d records of %d samples\n", count, BENCH_SAMPLES);
+    rt_kprintf("codec     bytes encode_us decode_us\n");
+    rt_memset(&result, 0, sizeof(result));
+    err = bench_ubjz(records, count, (rt_uint8_t *)buf, size, &result);
+    bench_report("ubjz", err, &result, &sum);
+    rt_memset(&result, 0, sizeof(result));
+    err = bench_ubjw(records, count, &result);
+    bench_report("ubjw", err, &result, &sum);
+    rt_memset(&result, 0, sizeof(result));
+    err = bench_cjson(records, count, buf, size, &result);
+    bench_report("cjson", err, &result, &sum);
+
+    rt_free(records);
+    rt_free(buf);
+}
+MSH_CMD_EXPORT(ubj_bench, UBJSON zero-copy codec against ubjw/ubjr and cJSON);
+
+#ifdef RT_USING_UTEST
+#include <utest.h>
+
+#define TEST_RECORDS            16
+
+static void test_ubj_round_trip(void)
+{
+    struct bench_record *records;
+    struct bench_result result;
+    struct bench_sum sum;
+    rt_size_t size = 32 + TEST_RECORDS * BENCH_RECORD_MAX;
+    char *buf;
+
+    records = rt_malloc(TEST_RECORDS * sizeof(*records));
+    buf = rt_malloc(size);
+    uassert_not_null(records);
+    uassert_not_null(buf);
+    if (records == RT_NULL || buf == RT_NULL)
+    {
+        rt_free(records);
+        rt_free(buf);
+        return;
+    }
+    bench_fill(records, TEST_RECORDS, &sum);
+
+    /* each codec decodes what it encoded */
+    rt_memset(&result, 0, sizeof(result));
+    uassert_int_equal(bench_ubjz(records, TEST_RECORDS, (rt_uint8_t *)buf, size, &result), RT_EOK);
+    uassert_buf_equal(&result.sum, &sum, sizeof(sum));
+    rt_memset(&result, 0, sizeof(result));
+    uassert_int_equal(bench_ubjw(records, TEST_RECORDS, &result), RT_EOK);
+    uassert_buf_equal(&result.sum, &sum, sizeof(sum));
+    rt_memset(&result, 0, sizeof(result));
+    uassert_int_equal(bench_cjson(records, TEST_RECORDS, buf, size, &result), RT_EOK);
+    uassert_buf_equal(&result.sum, &sum, sizeof(sum));
+
+    rt_free(records);
+    rt_free(buf);
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_ubj_round_trip);
+}
+UTEST_TC_EXPORT(testcase, "components.libraries.ubjson.ubj_bench", RT_NULL, RT_NULL, 10);
+#endif /* RT_USING_UTEST */
+
+#endif /* defined(UBJSON_USING_BENCH) && defined(URPC_USING_CJSON) && defined(RT_USING_FINSH) */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-07-11     RT-Thread    first version
+ * 2026-10-18     RT-Thread    add the futex word and FUTEX_WAKE_OP encoding
  */
 
 #ifndef __LIBC_MUSL_H__
@@ -28,6 +29,26 @@
 
 #define FUTEX_CLOCK_REALTIME 256
 
+/* from linux/futex.h */
+
+#define FUTEX_WAITERS        0x80000000
+#define FUTEX_OWNER_DIED     0x40000000
+#define FUTEX_TID_MASK       0x3fffffff
+
+#define FUTEX_OP_SET         0
+#define FUTEX_OP_ADD         1
+#define FUTEX_OP_OR          2
+#define FUTEX_OP_ANDN        3
+#define FUTEX_OP_XOR         4
+#define FUTEX_OP_OPARG_SHIFT 8
+
+#define FUTEX_OP_CMP_EQ      0
+#define FUTEX_OP_CMP_NE      1
+#define FUTEX_OP_CMP_LT      2
+#define FUTEX_OP_CMP_LE      3
+#define FUTEX_OP_CMP_GT      4
+#define FUTEX_OP_CMP_GE      5
+
 /* for pmutex op */
 #define PMUTEX_INIT    0
 #define PMUTEX_LOCK    1
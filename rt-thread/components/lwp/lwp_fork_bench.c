@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Fork and exec cost benchmark.
+ *
+ * The address space of a running process is duplicated into an empty process the way fork()
+ * does, and the child is released again the way its exec() or exit() does. The time of both
+ * and the memory taken by the child are reported. With the private frames shared copy-on-write
+ * the child only takes its page tables until a page is written. Run it against a shell or a
+ * daemon of the QEMU vexpress-a9 smart image, the process is not stopped.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(LWP_USING_FORK_BENCH) && defined(RT_USING_FINSH) && defined(ARCH_MM_MMU)
+
+#include "lwp.h"
+#include "lwp_pid.h"
+#include "lwp_user_mm.h"
+
+#include <msh_bench.h>
+
+static void fork_bench(int argc, char **argv)
+{
+    struct rt_lwp *lwp, *child;
+    rt_size_t total, free_start, free_fork, free_end;
+    rt_uint32_t rounds = 10, i, t, fork_t = 0, release_t = 0;
+    int err = RT_EOK;
+
+    if (argc > 2) rounds = strtoul(argv[2], RT_NULL, 0);
+    if (argc < 2 || rounds == 0)
+    {
+        rt_kprintf("Usage: fork_bench <pid> [rounds]\n");
+        return;
+    }
+
+    lwp = lwp_from_pid(strtoul(argv[1], RT_NULL, 0));
+    if (lwp == RT_NULL)
+    {
+        rt_kprintf("no such process\n");
+        return;
+    }
+    lwp_ref_inc(lwp);
+
+    rt_page_get_info(&total, &free_start);
+    free_fork = free_start;
+    for (i = 0; i < rounds; i++)
+    {
+        child = lwp_new();
+        if (child == RT_NULL)
+        {
+            err = -RT_ENOMEM;
+            break;
+        }
+        if (lwp_user_space_init(child, 1) != 0)
+        {
+            lwp_ref_dec(child);
+            err = -RT_ENOMEM;
+            break;
+        }
+
+        t = BENCH_CLOCK();
+        child->lwp_obj->source = lwp->aspace;
+        err = rt_aspace_traversal(lwp->aspace, lwp_dup_user, child);
+        child->lwp_obj->source = RT_NULL;
+        fork_t += BENCH_CLOCK() - t;
+
+        if (i == 0)
+            rt_page_get_info(&total, &free_fork);
+
+        t = BENCH_CLOCK();
+        lwp_ref_dec(child);
+        release_t += BENCH_CLOCK() - t;
+
+        if (err != RT_EOK)
+            break;
+    }
+    rt_page_get_info(&total, &free_end);
+    lwp_ref_dec(lwp);
+
+    if (err != RT_EOK)
+    {
+        rt_kprintf("duplication failed at round %d\n", i);
+        return;
+    }
+
+    rt_kprintf("process %s, %d rounds\n", argv[1], rounds);
+    rt_kprintf("fork          %8d us\n", (rt_uint32_t)(BENCH_CLOCK_NS(fork_t) / rounds / 1000));
+    rt_kprintf("release       %8d us\n", (rt_uint32_t)(BENCH_CLOCK_NS(release_t) / rounds / 1000));
+    rt_kprintf("child         %8d KB\n", (int)(free_start - free_fork) * (ARCH_PAGE_SIZE / 1024));
+    rt_kprintf("not released  %8d KB\n", (int)(free_start - free_end) * (ARCH_PAGE_SIZE / 1024));
+}
+MSH_CMD_EXPORT(fork_bench, fork and exec cost of a process);
+
+#endif /* defined(LWP_USING_FORK_BENCH) && defined(RT_USING_FINSH) && defined(ARCH_MM_MMU) */
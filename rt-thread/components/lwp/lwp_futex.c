@@ -6,8 +6,10 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021/01/02     bernard      the first version
+ * 2026-10-18     RT-Thread    hashed buckets, requeue, wake-op and PI futexes
  */
 
+#include <rthw.h>
 #include <rtthread.h>
 #include <lwp.h>
 #ifdef ARCH_MM_MMU
@@ -15,23 +17,103 @@
 #endif
 #include "sys/time.h"
 
+#ifndef LWP_FUTEX_HASH_SIZE
+#define LWP_FUTEX_HASH_SIZE     64
+#endif
+
+/*
+ * The futexes of all the processes are hashed by process and user address into buckets with a
+ * lock each, so that the futexes of different addresses do not wait on one another. The lock of
+ * a bucket makes the test of the user word and the suspend of a waiter atomic against a wake of
+ * the same futex. The lists themselves are changed with the interrupts disabled, the thread
+ * timer and the signals take a waiter off its list there and a futex is destroyed there at the
+ * exit of its process.
+ *
+ * A PI futex has the TID of its owner in the user word. The first waiter gives a kernel mutex to
+ * the owner and waits on it, the owner inherits the priority of the waiters, and the unlock hands
+ * the mutex and the word over to the next one. FUTEX_WAITERS stays set as long as the mutex has
+ * an owner, so that its owner always unlocks through the kernel.
+ */
+
 struct rt_futex
 {
     int *uaddr;
+    struct rt_lwp *lwp;
     rt_list_t waiting_thread;
-    struct lwp_avl_struct node;
+    rt_list_t node;
+    rt_mutex_t pi_mutex;
     struct rt_object *custom_obj;
 };
 
-static struct rt_mutex _futex_lock;
+struct futex_bucket
+{
+    struct rt_mutex lock;
+    rt_list_t futex_list;
+};
+
+static struct futex_bucket _futex_bucket[LWP_FUTEX_HASH_SIZE];
 
 static int futex_system_init(void)
 {
-    rt_mutex_init(&_futex_lock, "futexList", RT_IPC_FLAG_FIFO);
+    int index;
+
+    for (index = 0; index < LWP_FUTEX_HASH_SIZE; index++)
+    {
+        rt_mutex_init(&_futex_bucket[index].lock, "futex", RT_IPC_FLAG_FIFO);
+        rt_list_init(&_futex_bucket[index].futex_list);
+    }
     return 0;
 }
 INIT_PREV_EXPORT(futex_system_init);
 
+static struct futex_bucket *futex_bucket(struct rt_lwp *lwp, int *uaddr)
+{
+    rt_uint32_t hash = (rt_uint32_t)((rt_ubase_t)uaddr >> 2) ^ (rt_uint32_t)((rt_ubase_t)lwp >> 4);
+
+    /* the multiplication mixes the address into the upper bits */
+    hash *= 0x9E3779B1;
+    return &_futex_bucket[(hash >> 16) & (LWP_FUTEX_HASH_SIZE - 1)];
+}
+
+static rt_err_t futex_lock(struct futex_bucket *bucket, struct futex_bucket *bucket2)
+{
+    struct futex_bucket *first = bucket;
+    rt_err_t ret;
+
+    /* two buckets are taken in the order of their address, the same one twice is recursive */
+    if (bucket2 && bucket2 < bucket)
+    {
+        first = bucket2;
+        bucket2 = bucket;
+    }
+
+    ret = rt_mutex_take_interruptible(&first->lock, RT_WAITING_FOREVER);
+    if (ret == RT_EOK && bucket2)
+    {
+        ret = rt_mutex_take_interruptible(&bucket2->lock, RT_WAITING_FOREVER);
+        if (ret != RT_EOK)
+        {
+            rt_mutex_release(&first->lock);
+        }
+    }
+    return ret;
+}
+
+static void futex_unlock(struct futex_bucket *bucket, struct futex_bucket *bucket2)
+{
+    if (bucket2)
+    {
+        rt_mutex_release(&bucket2->lock);
+    }
+    rt_mutex_release(&bucket->lock);
+}
+
+/* the user space changes the word with atomics of its own */
+static rt_bool_t futex_cmpxchg(int *uaddr, int *expected, int value)
+{
+    return __atomic_compare_exchange_n(uaddr, expected, value, RT_FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
 rt_err_t futex_destory(void *data)
 {
     rt_err_t ret = -1;
@@ -41,10 +123,15 @@ rt_err_t futex_destory(void *data)
     if (futex)
     {
         level = rt_hw_interrupt_disable();
-        /* remove futex from futext avl */
-        lwp_avl_remove(&futex->node, (struct lwp_avl_struct **)futex->node.data);
+        /* remove futex from its bucket */
+        rt_list_remove(&futex->node);
         rt_hw_interrupt_enable(level);
 
+        if (futex->pi_mutex)
+        {
+            rt_mutex_delete(futex->pi_mutex);
+        }
+
         /* release object */
         rt_free(futex);
         ret = 0;
@@ -52,10 +139,11 @@ rt_err_t futex_destory(void *data)
     return ret;
 }
 
-struct rt_futex *futex_create(int *uaddr, struct rt_lwp *lwp)
+static struct rt_futex *futex_create(struct futex_bucket *bucket, int *uaddr, struct rt_lwp *lwp)
 {
     struct rt_futex *futex = RT_NULL;
     struct rt_object *obj = RT_NULL;
+    rt_base_t level;
 
     if (!lwp)
     {
@@ -74,48 +162,62 @@ struct rt_futex *futex_create(int *uaddr, struct rt_lwp *lwp)
     }
 
     futex->uaddr = uaddr;
-    futex->node.avl_key = (avl_key_t)uaddr;
-    futex->node.data = &lwp->address_search_head;
+    futex->lwp = lwp;
+    futex->pi_mutex = RT_NULL;
     futex->custom_obj = obj;
     rt_list_init(&(futex->waiting_thread));
 
-    /* insert into futex head */
-    lwp_avl_insert(&futex->node, &lwp->address_search_head);
+    /* insert into the bucket */
+    level = rt_hw_interrupt_disable();
+    rt_list_insert_before(&bucket->futex_list, &futex->node);
+    rt_hw_interrupt_enable(level);
+
+    if (lwp_user_object_add(lwp, futex->custom_obj) != 0)
+    {
+        rt_custom_object_destroy(futex->custom_obj);
+        return RT_NULL;
+    }
     return futex;
 }
 
-static struct rt_futex *futex_get(void *uaddr, struct rt_lwp *lwp)
+static struct rt_futex *futex_get(struct futex_bucket *bucket, int *uaddr, struct rt_lwp *lwp)
 {
     struct rt_futex *futex = RT_NULL;
-    struct lwp_avl_struct *node = RT_NULL;
+    rt_list_t *node;
+    rt_base_t level;
 
-    node = lwp_avl_find((avl_key_t)uaddr, lwp->address_search_head);
-    if (!node)
+    level = rt_hw_interrupt_disable();
+    rt_list_for_each(node, &bucket->futex_list)
     {
-        return RT_NULL;
+        struct rt_futex *entry = rt_list_entry(node, struct rt_futex, node);
+
+        if (entry->uaddr == uaddr && entry->lwp == lwp)
+        {
+            futex = entry;
+            break;
+        }
     }
-    futex = rt_container_of(node, struct rt_futex, node);
+    rt_hw_interrupt_enable(level);
+
     return futex;
 }
 
-int futex_wait(struct rt_futex *futex, int value, const struct timespec *timeout)
+static int futex_wait(struct futex_bucket *bucket, struct rt_futex *futex, int value,
+                      const struct timespec *timeout)
 {
     rt_base_t level = 0;
-    rt_err_t ret = -RT_EINTR;
+    int ret = -EAGAIN;
 
     if (*(futex->uaddr) == value)
     {
         rt_thread_t thread = rt_thread_self();
 
         level = rt_hw_interrupt_disable();
-        ret = rt_thread_suspend_with_flag(thread, RT_INTERRUPTIBLE);
-
-        if (ret < 0)
+        if (rt_thread_suspend_with_flag(thread, RT_INTERRUPTIBLE) != RT_EOK)
         {
-            rt_mutex_release(&_futex_lock);
+            rt_mutex_release(&bucket->lock);
             rt_hw_interrupt_enable(level);
-            rt_set_errno(EINTR);
-            return ret;
+            return -EINTR;
         }
 
         /* add into waiting thread list */
@@ -137,28 +239,31 @@ int futex_wait(struct rt_futex *futex, int value, const struct timespec *timeout
                              &time);
             rt_timer_start(&(thread->thread_timer));
         }
-        rt_mutex_release(&_futex_lock);
+        rt_mutex_release(&bucket->lock);
         rt_hw_interrupt_enable(level);
 
         /* do schedule */
         rt_schedule();
 
-        ret = thread->error;
-        /* check errno */
+        if (thread->error == RT_EOK)
+            ret = 0;
+        else
+            ret = thread->error == -RT_ETIMEOUT ? -ETIMEDOUT : -EINTR;
     }
     else
     {
-        rt_mutex_release(&_futex_lock);
-        rt_set_errno(EAGAIN);
+        rt_mutex_release(&bucket->lock);
     }
 
     return ret;
 }
 
-void futex_wake(struct rt_futex *futex, int number)
+static int futex_wake(struct rt_futex *futex, int number)
 {
+    int woken = 0;
     rt_base_t level = rt_hw_interrupt_disable();
-    while (!rt_list_isempty(&(futex->waiting_thread)) && number)
+
+    while (!rt_list_isempty(&(futex->waiting_thread)) && number > 0)
     {
         rt_thread_t thread;
 
@@ -171,12 +276,225 @@ void futex_wake(struct rt_futex *futex, int number)
         rt_thread_resume(thread);
 
         number--;
+        woken++;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return woken;
+}
+
+/* wake some of the waiters and move some of the others to the second futex without waking them */
+static int futex_requeue(struct rt_futex *futex, struct rt_futex *futex2, int number, int requeue)
+{
+    int moved = 0;
+    int woken = futex_wake(futex, number);
+    rt_base_t level = rt_hw_interrupt_disable();
+
+    while (!rt_list_isempty(&(futex->waiting_thread)) && requeue > 0)
+    {
+        rt_thread_t thread;
+
+        thread = rt_list_entry(futex->waiting_thread.next, struct rt_thread, tlist);
+        rt_list_remove(&(thread->tlist));
+        rt_list_insert_before(&(futex2->waiting_thread), &(thread->tlist));
+
+        requeue--;
+        moved++;
     }
-    rt_mutex_release(&_futex_lock);
     rt_hw_interrupt_enable(level);
 
-    /* do schedule */
-    rt_schedule();
+    return woken + moved;
+}
+
+/* the operation of FUTEX_WAKE_OP on the second word, the result tells whether to wake there */
+static int futex_wake_op_value(int *uaddr2, int encoded)
+{
+    int op = (encoded >> 28) & 0xf;
+    int cmp = (encoded >> 24) & 0xf;
+    int oparg = (int)((rt_uint32_t)encoded << 8) >> 20;
+    int cmparg = (int)((rt_uint32_t)encoded << 20) >> 20;
+    int value, result = 0;
+
+    if (op & FUTEX_OP_OPARG_SHIFT)
+    {
+        if (oparg < 0 || oparg > 31)
+        {
+            return -EINVAL;
+        }
+        oparg = 1 << oparg;
+        op &= ~FUTEX_OP_OPARG_SHIFT;
+    }
+    if (op > FUTEX_OP_XOR || cmp > FUTEX_OP_CMP_GE)
+    {
+        return -ENOSYS;
+    }
+
+    value = *uaddr2;
+    do
+    {
+        switch (op)
+        {
+        case FUTEX_OP_SET:
+            result = oparg;
+            break;
+        case FUTEX_OP_ADD:
+            result = value + oparg;
+            break;
+        case FUTEX_OP_OR:
+            result = value | oparg;
+            break;
+        case FUTEX_OP_ANDN:
+            result = value & ~oparg;
+            break;
+        case FUTEX_OP_XOR:
+            result = value ^ oparg;
+            break;
+        }
+    } while (!futex_cmpxchg(uaddr2, &value, result));
+
+    switch (cmp)
+    {
+    case FUTEX_OP_CMP_EQ:
+        return value == cmparg;
+    case FUTEX_OP_CMP_NE:
+        return value != cmparg;
+    case FUTEX_OP_CMP_LT:
+        return value < cmparg;
+    case FUTEX_OP_CMP_LE:
+        return value <= cmparg;
+    case FUTEX_OP_CMP_GT:
+        return value > cmparg;
+    default:
+        return value >= cmparg;
+    }
+}
+
+/* the timeout of FUTEX_LOCK_PI is an absolute time of CLOCK_REALTIME */
+static rt_int32_t futex_pi_timeout(const struct timespec *timeout)
+{
+    struct timespec now;
+    rt_int32_t time;
+
+    if (!timeout)
+    {
+        return RT_WAITING_FOREVER;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    time = (timeout->tv_sec - now.tv_sec) * RT_TICK_PER_SECOND +
+           (timeout->tv_nsec - now.tv_nsec) * RT_TICK_PER_SECOND / NANOSECOND_PER_SECOND;
+
+    return time < 0 ? 0 : time;
+}
+
+static int futex_lock_pi(struct futex_bucket *bucket, struct rt_futex *futex,
+                         const struct timespec *timeout, rt_bool_t trylock)
+{
+    rt_thread_t thread = rt_thread_self();
+    rt_thread_t owner;
+    rt_err_t ret;
+    int value;
+
+    if (!futex->pi_mutex)
+    {
+        futex->pi_mutex = rt_mutex_create("pifutex", RT_IPC_FLAG_PRIO);
+        if (!futex->pi_mutex)
+        {
+            rt_mutex_release(&bucket->lock);
+            return -ENOMEM;
+        }
+    }
+
+    while (1)
+    {
+        value = *(futex->uaddr);
+        if ((value & FUTEX_TID_MASK) == 0)
+        {
+            /* free, taken in the word alone as the user space does */
+            if (futex_cmpxchg(futex->uaddr, &value, thread->tid | (value & FUTEX_WAITERS)))
+            {
+                rt_mutex_release(&bucket->lock);
+                return 0;
+            }
+            continue;
+        }
+        if ((value & FUTEX_TID_MASK) == thread->tid)
+        {
+            rt_mutex_release(&bucket->lock);
+            return -EDEADLK;
+        }
+        if (trylock)
+        {
+            rt_mutex_release(&bucket->lock);
+            return -EAGAIN;
+        }
+        if ((value & FUTEX_WAITERS) || futex_cmpxchg(futex->uaddr, &value, value | FUTEX_WAITERS))
+        {
+            break;
+        }
+    }
+
+    /* the owner took the word in user space, the kernel mutex is handed to it now */
+    if (futex->pi_mutex->owner == RT_NULL)
+    {
+        /* the word is private to the process, an owner out of it is not taken for one */
+        owner = lwp_tid_get_thread(value & FUTEX_TID_MASK);
+        if (!owner || owner->lwp != futex->lwp)
+        {
+            rt_mutex_release(&bucket->lock);
+            return -ESRCH;
+        }
+        rt_mutex_take_for(futex->pi_mutex, owner);
+    }
+    rt_mutex_release(&bucket->lock);
+
+    ret = rt_mutex_take_interruptible(futex->pi_mutex, futex_pi_timeout(timeout));
+    if (ret != RT_EOK)
+    {
+        return ret == -RT_ETIMEOUT ? -ETIMEDOUT : -EINTR;
+    }
+
+    /**
+     * the owner may have let the lock go before this thread was on the mutex, then the word can
+     * have been taken by another thread in user space meanwhile and the mutex goes to that one
+     */
+    rt_mutex_take(&bucket->lock, RT_WAITING_FOREVER);
+    value = *(futex->uaddr);
+    while ((value & FUTEX_TID_MASK) == 0 || (value & FUTEX_TID_MASK) == thread->tid)
+    {
+        if (futex_cmpxchg(futex->uaddr, &value, thread->tid | FUTEX_WAITERS))
+        {
+            rt_mutex_release(&bucket->lock);
+            return 0;
+        }
+    }
+    rt_mutex_release(futex->pi_mutex);
+
+    return futex_lock_pi(bucket, futex, timeout, RT_FALSE);
+}
+
+static int futex_unlock_pi(struct futex_bucket *bucket, struct rt_futex *futex)
+{
+    rt_thread_t thread = rt_thread_self();
+    rt_thread_t next = RT_NULL;
+    int value = *(futex->uaddr);
+
+    if ((value & FUTEX_TID_MASK) != thread->tid)
+    {
+        rt_mutex_release(&bucket->lock);
+        return -EPERM;
+    }
+
+    if (futex->pi_mutex && futex->pi_mutex->owner == thread)
+    {
+        /* the mutex goes to the waiter of the highest priority, then the word does */
+        rt_mutex_release(futex->pi_mutex);
+        next = futex->pi_mutex->owner;
+    }
+    __atomic_store_n(futex->uaddr, next ? (next->tid | FUTEX_WAITERS) : 0, __ATOMIC_SEQ_CST);
+    rt_mutex_release(&bucket->lock);
+
+    return 0;
 }
 
 #include <syscall_generic.h>
@@ -185,75 +503,155 @@ sysret_t sys_futex(int *uaddr, int op, int val, const struct timespec *timeout,
               int *uaddr2, int val3)
 {
     struct rt_lwp *lwp = RT_NULL;
-    struct rt_futex *futex = RT_NULL;
+    struct rt_futex *futex = RT_NULL, *futex2 = RT_NULL;
+    struct futex_bucket *bucket, *bucket2 = RT_NULL;
+    int cmd = op & ~(FUTEX_PRIVATE | FUTEX_CLOCK_REALTIME);
     int ret = 0;
     rt_err_t lock_ret = 0;
 
     if (!lwp_user_accessable(uaddr, sizeof(int)))
     {
         rt_set_errno(EINVAL);
-        return -RT_EINVAL;
+        return -EINVAL;
     }
 
     /**
-     * if (op & (FUTEX_WAKE|FUTEX_FD|FUTEX_WAKE_BITSET|FUTEX_TRYLOCK_PI|FUTEX_UNLOCK_PI)) was TRUE
-     * `timeout` should be ignored by implementation, according to POSIX futex(2) manual.
-     * since only FUTEX_WAKE is implemented in rt-smart, only FUTEX_WAKE was omitted currently
+     * the ops on two words take the second one, and `timeout` carries the number of waiters to
+     * requeue or to wake there, it is a time for the waits only, according to futex(2) manual.
      */
-    if (timeout && !(op & (FUTEX_WAKE)))
+    lwp = lwp_self();
+    if (cmd == FUTEX_REQUEUE || cmd == FUTEX_CMP_REQUEUE || cmd == FUTEX_WAKE_OP)
+    {
+        if (!lwp_user_accessable(uaddr2, sizeof(int)))
+        {
+            rt_set_errno(EINVAL);
+            return -EINVAL;
+        }
+        bucket2 = futex_bucket(lwp, uaddr2);
+    }
+    else if (timeout && (cmd == FUTEX_WAIT || cmd == FUTEX_LOCK_PI))
     {
         if (!lwp_user_accessable((void *)timeout, sizeof(struct timespec)))
         {
             rt_set_errno(EINVAL);
-            return -RT_EINVAL;
+            return -EINVAL;
         }
     }
-    lock_ret = rt_mutex_take_interruptible(&_futex_lock, RT_WAITING_FOREVER);
+
+    bucket = futex_bucket(lwp, uaddr);
+    lock_ret = futex_lock(bucket, bucket2);
     if (lock_ret != RT_EOK)
     {
-        rt_set_errno(EAGAIN);
-        return -RT_EINTR;
+        rt_set_errno(EINTR);
+        return -EINTR;
     }
 
-    lwp = lwp_self();
-    futex = futex_get(uaddr, lwp);
-    if (futex == RT_NULL)
+    futex = futex_get(bucket, uaddr, lwp);
+    if (futex == RT_NULL && (cmd == FUTEX_WAIT || cmd == FUTEX_LOCK_PI || cmd == FUTEX_TRYLOCK_PI))
     {
         /* create a futex according to this uaddr */
-        futex = futex_create(uaddr, lwp);
+        futex = futex_create(bucket, uaddr, lwp);
         if (futex == RT_NULL)
         {
-            rt_mutex_release(&_futex_lock);
-            rt_set_errno(ENOMEM);
-            return -RT_ENOMEM;
-        }
-        if (lwp_user_object_add(lwp, futex->custom_obj) != 0)
-        {
-            rt_custom_object_destroy(futex->custom_obj);
-            rt_mutex_release(&_futex_lock);
+            futex_unlock(bucket, bucket2);
             rt_set_errno(ENOMEM);
-            return -RT_ENOMEM;
+            return -ENOMEM;
         }
     }
+    if (bucket2)
+    {
+        futex2 = futex_get(bucket2, uaddr2, lwp);
+    }
 
-    switch (op)
+    switch (cmd)
     {
     case FUTEX_WAIT:
-        ret = futex_wait(futex, val, timeout);
-        /* _futex_lock is released by futex_wait */
+        ret = futex_wait(bucket, futex, val, timeout);
+        /* the bucket is unlocked by futex_wait */
         break;
 
     case FUTEX_WAKE:
-        futex_wake(futex, val);
-        /* _futex_lock is released by futex_wake */
+        ret = futex ? futex_wake(futex, val) : 0;
+        futex_unlock(bucket, bucket2);
+        break;
+
+    case FUTEX_CMP_REQUEUE:
+        if (*uaddr != val3)
+        {
+            futex_unlock(bucket, bucket2);
+            rt_set_errno(EAGAIN);
+            return -EAGAIN;
+        }
+        /* fall through */
+    case FUTEX_REQUEUE:
+        if (futex && !rt_list_isempty(&futex->waiting_thread) && futex2 == RT_NULL)
+        {
+            futex2 = futex_create(bucket2, uaddr2, lwp);
+        }
+        if (futex && futex2)
+        {
+            ret = futex_requeue(futex, futex2, val, (int)(rt_ubase_t)timeout);
+        }
+        else if (futex)
+        {
+            ret = futex_wake(futex, val);
+        }
+        futex_unlock(bucket, bucket2);
+        break;
+
+    case FUTEX_WAKE_OP:
+        ret = futex_wake_op_value(uaddr2, val3);
+        if (ret >= 0)
+        {
+            int woken = futex ? futex_wake(futex, val) : 0;
+
+            if (ret && futex2)
+            {
+                woken += futex_wake(futex2, (int)(rt_ubase_t)timeout);
+            }
+            ret = woken;
+        }
+        futex_unlock(bucket, bucket2);
+        break;
+
+    case FUTEX_LOCK_PI:
+    case FUTEX_TRYLOCK_PI:
+        ret = futex_lock_pi(bucket, futex, timeout, cmd == FUTEX_TRYLOCK_PI);
+        /* the bucket is unlocked by futex_lock_pi */
+        break;
+
+    case FUTEX_UNLOCK_PI:
+        if (futex)
+        {
+            ret = futex_unlock_pi(bucket, futex);
+            /* the bucket is unlocked by futex_unlock_pi */
+        }
+        else
+        {
+            int value = rt_thread_self()->tid;
+
+            /* never contended, so the word alone has the lock */
+            ret = futex_cmpxchg(uaddr, &value, 0) ? 0 : -EPERM;
+            futex_unlock(bucket, bucket2);
+        }
         break;
 
     default:
-        rt_mutex_release(&_futex_lock);
+        futex_unlock(bucket, bucket2);
         rt_set_errno(ENOSYS);
         ret = -ENOSYS;
         break;
     }
 
+    if (ret < 0)
+    {
+        rt_set_errno(-ret);
+    }
+    else if (ret > 0)
+    {
+        /* do schedule */
+        rt_schedule();
+    }
+
     return ret;
 }
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2019-10-12     Jesven       first version
  * 2023-02-20     wangxiaoyao  adapt to mm
+ * 2026-10-18     RT-Thread    attach the large segments on section boundaries
  */
 #include <rthw.h>
 #include <rtthread.h>
@@ -268,6 +269,7 @@ int lwp_shmrm(int id)
 static void *_lwp_shmat(int id, void *shm_vaddr)
 {
     int err;
+    mm_flag_t flags;
     struct rt_lwp *lwp  = RT_NULL;
     struct lwp_avl_struct *node_key = RT_NULL;
     struct lwp_shm_struct *p = RT_NULL;
@@ -292,7 +294,16 @@ static void *_lwp_shmat(int id, void *shm_vaddr)
         return RT_NULL;
     }
 
-    err = rt_aspace_map(lwp->aspace, &va, p->size, MMU_MAP_U_RWCB, MMF_PREFETCH,
+    flags = MMF_PREFETCH;
+#ifdef ARCH_SECTION_SIZE
+    /* a segment of whole sections is mapped by sections where it is free to pick */
+    if (!va && p->size >= ARCH_SECTION_SIZE &&
+        !(((rt_size_t)p->addr + PV_OFFSET) & ARCH_SECTION_MASK))
+    {
+        flags = MMF_CREATE(MMF_PREFETCH, ARCH_SECTION_SIZE);
+    }
+#endif
+    err = rt_aspace_map(lwp->aspace, &va, p->size, MMU_MAP_U_RWCB, flags,
                         &p->mem_obj, 0);
     if (err != RT_EOK)
     {
@@ -12,6 +12,8 @@
  * 2021-06-07     lizhirui     modify user space bound check
  * 2022-12-25     wangxiaoyao  adapt to new mm
  * 2023-09-13     Shell        Add lwp_memcpy and support run-time choice of memcpy base on memory attr
+ * 2026-10-18     RT-Thread    copy-on-write duplication of the user space
+ * 2026-10-18     RT-Thread    share the resident runs of the source in a time
  */
 
 #include <rtthread.h>
@@ -31,6 +33,7 @@
 #include <mm_page.h>
 #include <mmu.h>
 #include <page.h>
+#include <tlb.h>
 
 #ifdef RT_USING_MUSLLIBC
 #include "libc_musl.h"
@@ -120,10 +123,45 @@ static const char *user_get_name(rt_varea_t varea)
 #define NO_AUTO_FETCH               0x1
 #define VAREA_CAN_AUTO_FETCH(varea) (!((rt_ubase_t)((varea)->data) & NO_AUTO_FETCH))
 
+static rt_bool_t _cow_protect(rt_aspace_t aspace, void *vaddr, rt_size_t size)
+{
+    if (rt_hw_mmu_control(aspace, vaddr, size, MMU_CNTL_READONLY) != RT_EOK)
+    {
+        return RT_FALSE;
+    }
+    rt_hw_tlb_invalidate_range(aspace, vaddr, size, ARCH_PAGE_SIZE);
+    return RT_TRUE;
+}
+
+/* the frames of the source around the fault page contiguous with it, inside the fault-around window */
+static char *_source_run(rt_aspace_t source, struct rt_aspace_fault_msg *msg, char *paddr, rt_size_t *size)
+{
+    char *fault = msg->fault_vaddr;
+    char *start = fault;
+    char *end = fault + ARCH_PAGE_SIZE;
+    char *around_end = (char *)msg->around_vaddr + msg->around_size;
+
+    while (start > (char *)msg->around_vaddr &&
+           rt_hw_mmu_v2p(source, start - ARCH_PAGE_SIZE) == paddr - (fault - start) - ARCH_PAGE_SIZE)
+    {
+        start -= ARCH_PAGE_SIZE;
+    }
+    while (end < around_end && rt_hw_mmu_v2p(source, end) == paddr + (end - fault))
+    {
+        end += ARCH_PAGE_SIZE;
+    }
+
+    *size = end - start;
+    return start;
+}
+
 static void _user_do_page_fault(struct rt_varea *varea,
                                 struct rt_aspace_fault_msg *msg)
 {
     struct rt_lwp_objs *lwp_objs;
+    void *page = RT_NULL;
+    char *base = msg->fault_vaddr;
+    rt_size_t size = ARCH_PAGE_SIZE, off;
     lwp_objs = rt_container_of(varea->mem_obj, struct rt_lwp_objs, mem_obj);
 
     if (lwp_objs->source)
@@ -134,43 +172,98 @@ static void _user_do_page_fault(struct rt_varea *varea,
             void *vaddr;
             vaddr = paddr - PV_OFFSET;
 
-            if (!(varea->flag & MMF_TEXT))
+            if (!(varea->flag & (MMF_TEXT | MMF_COW)))
             {
-                void *cp = rt_pages_alloc_ext(0, PAGE_ANY_AVAILABLE);
-                if (cp)
-                {
-                    memcpy(cp, vaddr, ARCH_PAGE_SIZE);
-                    rt_varea_pgmgr_insert(varea, cp);
-                    msg->response.status = MM_FAULT_STATUS_OK;
-                    msg->response.vaddr = cp;
-                    msg->response.size = ARCH_PAGE_SIZE;
-                }
-                else
+                page = rt_pages_alloc_ext(0, PAGE_ANY_AVAILABLE);
+                if (page)
                 {
-                    LOG_W("%s: page alloc failed at %p", __func__,
-                          varea->start);
+                    memcpy(page, vaddr, ARCH_PAGE_SIZE);
                 }
             }
             else
             {
-                rt_page_t page = rt_page_addr2page(vaddr);
-                page->ref_cnt += 1;
-                rt_varea_pgmgr_insert(varea, vaddr);
-                msg->response.status = MM_FAULT_STATUS_OK;
-                msg->response.vaddr = vaddr;
-                msg->response.size = ARCH_PAGE_SIZE;
+                /**
+                 * text and copy-on-write frames are shared with the source, the resident
+                 * neighbours contiguous with the fault page in a time. The references are
+                 * taken before the source is made read-only, so a write fault of the source
+                 * copies the frame from then on. The duplicate is not running yet and
+                 * lwp_dup_user() protects its side once the varea is loaded.
+                 */
+                base = _source_run(lwp_objs->source, msg, paddr, &size);
+                page = (char *)vaddr - ((char *)msg->fault_vaddr - base);
+                for (off = 0; off < size; off += ARCH_PAGE_SIZE)
+                {
+                    rt_page_ref_inc((char *)page + off, 0);
+                }
+                if ((varea->flag & MMF_COW) && !_cow_protect(lwp_objs->source, base, size))
+                {
+                    for (off = 0; off < size; off += ARCH_PAGE_SIZE)
+                    {
+                        rt_pages_free((char *)page + off, 0);
+                    }
+                    base = msg->fault_vaddr;
+                    size = ARCH_PAGE_SIZE;
+                    page = rt_pages_alloc_ext(0, PAGE_ANY_AVAILABLE);
+                    if (page)
+                    {
+                        memcpy(page, vaddr, ARCH_PAGE_SIZE);
+                    }
+                }
             }
         }
         else if (!(varea->flag & MMF_TEXT))
         {
             /* if data segment not exist in source do a fallback */
-            rt_mm_dummy_mapper.on_page_fault(varea, msg);
+            page = rt_pages_alloc_ext(0, PAGE_ANY_AVAILABLE);
+        }
+        else
+        {
+            return;
         }
     }
     else if (VAREA_CAN_AUTO_FETCH(varea))
     {
         /* if (!lwp_objs->source), no aspace as source data */
-        rt_mm_dummy_mapper.on_page_fault(varea, msg);
+        page = rt_pages_alloc_ext(0, PAGE_ANY_AVAILABLE);
+    }
+    else
+    {
+        return;
+    }
+
+    if (page)
+    {
+        msg->response.status = MM_FAULT_STATUS_OK;
+        msg->response.vaddr = page;
+        msg->response.size = size;
+        msg->response.map_vaddr = base;
+    }
+    else
+    {
+        LOG_W("%s: page alloc failed at %p", __func__, msg->fault_vaddr);
+    }
+}
+
+static void _user_varea_close(struct rt_varea *varea)
+{
+    char *vaddr = varea->start;
+    char *vend = vaddr + varea->size;
+    char *paddr;
+
+    /**
+     * frames of the user vareas are not kept on the varea->frames list since they may be
+     * shared by the processes forked, each mapping holds a reference of the frame instead.
+     * The reference is dropped only after the page is unmapped and out of the TLB, a frame
+     * freed while still mapped could be reused under a running thread of the process.
+     */
+    for (; vaddr != vend; vaddr += ARCH_PAGE_SIZE)
+    {
+        paddr = rt_hw_mmu_v2p(varea->aspace, vaddr);
+        if (paddr != ARCH_MAP_FAILED)
+        {
+            rt_varea_unmap_page(varea, vaddr);
+            rt_pages_free(paddr - PV_OFFSET, 0);
+        }
     }
 }
 
@@ -187,9 +280,9 @@ static void _init_lwp_objs(struct rt_lwp_objs *lwp_objs, rt_aspace_t aspace)
         lwp_objs->mem_obj.get_name = user_get_name;
         lwp_objs->mem_obj.hint_free = NULL;
         lwp_objs->mem_obj.on_page_fault = _user_do_page_fault;
-        lwp_objs->mem_obj.on_page_offload = rt_mm_dummy_mapper.on_page_offload;
+        lwp_objs->mem_obj.on_page_offload = RT_NULL;
         lwp_objs->mem_obj.on_varea_open = rt_mm_dummy_mapper.on_varea_open;
-        lwp_objs->mem_obj.on_varea_close = rt_mm_dummy_mapper.on_varea_close;
+        lwp_objs->mem_obj.on_varea_close = _user_varea_close;
     }
 }
 
@@ -223,57 +316,69 @@ int lwp_unmap_user(struct rt_lwp *lwp, void *va)
     return err;
 }
 
-static void _dup_varea(rt_varea_t varea, struct rt_lwp *src_lwp,
-                       rt_aspace_t dst)
+static void _dup_varea(rt_varea_t varea, rt_aspace_t src, rt_aspace_t dst)
 {
     char *vaddr = varea->start;
     char *vend = vaddr + varea->size;
+    char *run;
     if (vaddr < (char *)USER_STACK_VSTART || vaddr >= (char *)USER_STACK_VEND)
     {
+        /* each run of pages resident in the source is loaded in a time */
         while (vaddr != vend)
         {
-            void *paddr;
-            paddr = lwp_v2p(src_lwp, vaddr);
-            if (paddr != ARCH_MAP_FAILED)
+            run = vaddr;
+            while (vaddr != vend && rt_hw_mmu_v2p(src, vaddr) != ARCH_MAP_FAILED)
             {
-                rt_aspace_load_page(dst, vaddr, 1);
+                vaddr += ARCH_PAGE_SIZE;
             }
-            vaddr += ARCH_PAGE_SIZE;
-        }
-    }
-    else
-    {
-        while (vaddr != vend)
-        {
-            vend -= ARCH_PAGE_SIZE;
-            void *paddr;
-            paddr = lwp_v2p(src_lwp, vend);
-            if (paddr != ARCH_MAP_FAILED)
+            if (vaddr != run)
             {
-                rt_aspace_load_page(dst, vend, 1);
+                rt_aspace_load_page(dst, run, (vaddr - run) >> ARCH_PAGE_SHIFT);
             }
             else
             {
-                break;
+                vaddr += ARCH_PAGE_SIZE;
             }
         }
     }
+    else
+    {
+        /* the stack is resident from its top down to the first hole */
+        run = vend;
+        while (run != vaddr && rt_hw_mmu_v2p(src, run - ARCH_PAGE_SIZE) != ARCH_MAP_FAILED)
+        {
+            run -= ARCH_PAGE_SIZE;
+        }
+        if (run != vend)
+        {
+            rt_aspace_load_page(dst, run, (vend - run) >> ARCH_PAGE_SHIFT);
+        }
+    }
+}
+
+rt_inline rt_bool_t _varea_can_cow(rt_varea_t varea)
+{
+    /* the private and writable memory of a process */
+    return varea->mem_obj->on_page_fault == _user_do_page_fault &&
+           !(varea->flag & (MMF_TEXT | MMF_MAP_SHARED)) &&
+           varea->attr == (MMU_MAP_U_RWCB);
 }
 
 int lwp_dup_user(rt_varea_t varea, void *arg)
 {
     int err;
-    struct rt_lwp *self_lwp = lwp_self();
     struct rt_lwp *new_lwp = (struct rt_lwp *)arg;
+    rt_aspace_t src = new_lwp->lwp_obj->source;
 
     void *pa = RT_NULL;
     void *va = RT_NULL;
     rt_mem_obj_t mem_obj = varea->mem_obj;
+    mm_flag_t flags;
 
     if (!mem_obj)
     {
         /* duplicate a physical mapping */
-        pa = lwp_v2p(self_lwp, (void *)varea->start);
+        pa = rt_hw_mmu_v2p(src, (void *)varea->start);
         RT_ASSERT(pa != ARCH_MAP_FAILED);
         struct rt_mm_va_hint hint = {.flags = MMF_MAP_FIXED,
                                      .limit_range_size = new_lwp->aspace->size,
@@ -290,10 +395,23 @@ int lwp_dup_user(rt_varea_t varea, void *arg)
     }
     else
     {
+        /**
+         * the frames of a private mapping are shared read-only by both of the processes
+         * and copied on the first write. Each frame is referenced by the duplicate before
+         * its source page is protected (see _user_do_page_fault()), and the traversal
+         * holds the lock of the source, so no fault of the source is fixed meanwhile.
+         */
+        flags = varea->flag;
+        if (_varea_can_cow(varea))
+        {
+            varea->flag |= MMF_COW;
+            flags |= MMF_COW;
+        }
+
         /* duplicate a mem_obj backing mapping */
         va = varea->start;
         err = rt_aspace_map(new_lwp->aspace, &va, varea->size, varea->attr,
-                            varea->flag, &new_lwp->lwp_obj->mem_obj,
+                            flags, &new_lwp->lwp_obj->mem_obj,
                             varea->offset);
         if (err != RT_EOK)
         {
@@ -305,7 +423,13 @@ int lwp_dup_user(rt_varea_t varea, void *arg)
             /* loading page frames for !MMF_PREFETCH varea */
             if (!(varea->flag & MMF_PREFETCH))
             {
-                _dup_varea(varea, self_lwp, new_lwp->aspace);
+                _dup_varea(varea, src, new_lwp->aspace);
+            }
+
+            if (flags & MMF_COW)
+            {
+                rt_hw_mmu_control(new_lwp->aspace, va, varea->size, MMU_CNTL_READONLY);
+                rt_hw_tlb_invalidate_range(new_lwp->aspace, va, varea->size, ARCH_PAGE_SIZE);
             }
         }
     }
@@ -792,6 +916,18 @@ size_t lwp_data_get(struct rt_lwp *lwp, void *dst, void *src, size_t size)
     return copy_len;
 }
 
+/* the frame written through the kernel mapping must not be shared copy-on-write */
+static void _user_cow_break(struct rt_lwp *lwp, void *addr)
+{
+    struct rt_aspace_fault_msg msg = {
+        .fault_op = MM_FAULT_OP_WRITE,
+        .fault_type = MM_FAULT_TYPE_ACCESS_FAULT,
+        .fault_vaddr = addr,
+    };
+
+    rt_aspace_fault_try_fix(lwp->aspace, &msg);
+}
+
 /* dst is in kernel space, src is in current thread space */
 size_t lwp_data_put(struct rt_lwp *lwp, void *dst, void *src, size_t size)
 {
@@ -816,6 +952,7 @@ size_t lwp_data_put(struct rt_lwp *lwp, void *dst, void *src, size_t size)
         {
             len = size;
         }
+        _user_cow_break(lwp, addr_start);
         tmp_dst = lwp_v2p(lwp, addr_start);
         if (tmp_dst == ARCH_MAP_FAILED)
         {
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2019-10-28     Jesven       first version
  * 2021-02-12     lizhirui     add 64-bit support for lwp_brk
+ * 2026-10-18     RT-Thread    export lwp_dup_user
  */
 #ifndef  __LWP_USER_MM_H__
 #define  __LWP_USER_MM_H__
@@ -140,6 +141,7 @@ size_t lwp_put_to_user(void *dst, void *src, size_t size);
 size_t lwp_data_set(struct rt_lwp *lwp, void *dst, int c, size_t size);
 
 int lwp_user_space_init(struct rt_lwp *lwp, rt_bool_t is_fork);
+int lwp_dup_user(rt_varea_t varea, void *arg);
 void lwp_unmap_user_space(struct rt_lwp *lwp);
 
 int lwp_unmap_user(struct rt_lwp *lwp, void *va);
@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-11-14     WangXiaoyao  the first version
+ * 2026-10-18     RT-Thread    prefetch by the largest response, map physical on sections
+ * 2026-10-18     RT-Thread    map a response on the base given by the handler
  */
 
 /**
@@ -149,7 +151,7 @@ static int _do_named_map(rt_aspace_t aspace, void *vaddr, rt_size_t length,
 }
 
 rt_inline void _do_page_fault(struct rt_aspace_fault_msg *msg, rt_size_t off,
-                              void *vaddr, rt_mem_obj_t mem_obj,
+                              void *vaddr, rt_size_t size, rt_mem_obj_t mem_obj,
                               rt_varea_t varea)
 {
     msg->off = off;
@@ -159,6 +161,10 @@ rt_inline void _do_page_fault(struct rt_aspace_fault_msg *msg, rt_size_t off,
     msg->response.status = MM_FAULT_STATUS_UNRECOVERABLE;
     msg->response.vaddr = 0;
     msg->response.size = 0;
+    msg->response.map_vaddr = RT_NULL;
+    /* the handler can serve up to the rest of the range in a time */
+    msg->around_vaddr = vaddr;
+    msg->around_size = size;
 
     mem_obj->on_page_fault(varea, msg);
 }
@@ -174,15 +180,17 @@ int _varea_map_with_msg(rt_varea_t varea, struct rt_aspace_fault_msg *msg)
          */
         char *store = msg->response.vaddr;
         rt_size_t store_sz = msg->response.size;
-        if ((char *)msg->fault_vaddr + store_sz > (char *)varea->start + varea->size)
+        char *v_addr = msg->response.map_vaddr ? msg->response.map_vaddr : msg->fault_vaddr;
+        if (v_addr > (char *)msg->fault_vaddr || v_addr < (char *)varea->start ||
+            v_addr + store_sz > (char *)varea->start + varea->size ||
+            v_addr + store_sz <= (char *)msg->fault_vaddr)
         {
-            LOG_W("%s: too much (0x%lx) of buffer on vaddr %p is provided",
-                    __func__, store_sz, msg->fault_vaddr);
+            LOG_W("%s: buffer (0x%lx) on vaddr %p is provided for fault on %p",
+                    __func__, store_sz, v_addr, msg->fault_vaddr);
         }
         else
         {
             void *map;
-            void *v_addr = msg->fault_vaddr;
             void *p_addr = store + PV_OFFSET;
             map = rt_hw_mmu_map(varea->aspace, v_addr, p_addr, store_sz, varea->attr);
 
@@ -226,13 +234,13 @@ static int _do_prefetch(rt_aspace_t aspace, rt_varea_t varea, void *start,
     /* it's ensured by caller that start & size ara page-aligned */
     char *end = (char *)start + size;
     char *vaddr = start;
+    char *next;
     rt_size_t off = varea->offset + ((vaddr - (char *)varea->start) >> ARCH_PAGE_SHIFT);
 
     while (vaddr != end)
     {
-        /* TODO try to map with huge TLB, when flag & HUGEPAGE */
         struct rt_aspace_fault_msg msg;
-        _do_page_fault(&msg, off, vaddr, varea->mem_obj, varea);
+        _do_page_fault(&msg, off, vaddr, end - vaddr, varea->mem_obj, varea);
 
         if (_varea_map_with_msg(varea, &msg))
         {
@@ -246,8 +254,10 @@ static int _do_prefetch(rt_aspace_t aspace, rt_varea_t varea, void *start,
         if (msg.response.status == MM_FAULT_STATUS_OK_MAPPED)
             break;
 
-        vaddr += msg.response.size;
-        off += msg.response.size >> ARCH_PAGE_SHIFT;
+        /* the range is served from its start, so the run ends past vaddr */
+        next = (msg.response.map_vaddr ? (char *)msg.response.map_vaddr : vaddr) + msg.response.size;
+        off += (next - vaddr) >> ARCH_PAGE_SHIFT;
+        vaddr = next;
     }
 
     return err;
@@ -526,6 +536,15 @@ int _mm_aspace_map_phy(rt_aspace_t aspace, rt_varea_t varea,
     }
     else
     {
+#ifdef ARCH_SECTION_SIZE
+        /* where the place is free to pick, keep the sections of the physical region whole */
+        if (!hint->prefer && !(hint->flags & (MMF_MAP_FIXED | MMF_REQUEST_ALIGN)) &&
+            hint->map_size >= ARCH_SECTION_SIZE &&
+            !((pa_off << MM_PAGE_SHIFT) & ARCH_SECTION_MASK))
+        {
+            hint->flags = MMF_SET_ALIGN(MMF_SET_CNTL(hint->flags, MMF_REQUEST_ALIGN), ARCH_SECTION_SIZE);
+        }
+#endif
         WR_LOCK(aspace);
         err = _varea_install(aspace, varea, hint);
         WR_UNLOCK(aspace);
@@ -6,6 +6,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-12-06     WangXiaoyao  the first version
+ * 2026-10-18     RT-Thread    copy-on-write fault
+ * 2026-10-18     RT-Thread    fault-around
+ * 2026-10-18     RT-Thread    fault-around from the start of the window
  */
 #include <rtthread.h>
 
@@ -19,6 +22,7 @@
 #include "mm_aspace.h"
 #include "mm_fault.h"
 #include "mm_flag.h"
+#include "mm_page.h"
 #include "mm_private.h"
 #include <mmu.h>
 #include <tlb.h>
@@ -26,12 +30,57 @@
 #define UNRECOVERABLE 0
 #define RECOVERABLE   1
 
+/**
+ * the pages not mapped around the fault page in the aligned fault-around
+ * window (a section for a huge page varea), inside the varea
+ */
+static void _fault_around(rt_varea_t varea, struct rt_aspace_fault_msg *msg)
+{
+    rt_size_t window = RT_MM_FAULT_AROUND_PAGES << ARCH_PAGE_SHIFT;
+    char *fault = msg->fault_vaddr;
+    char *start, *end, *vaddr;
+
+#ifdef ARCH_SECTION_SIZE
+    if ((varea->flag & MMF_HUGEPAGE) && window < ARCH_SECTION_SIZE)
+        window = ARCH_SECTION_SIZE;
+#endif
+    start = (char *)RT_ALIGN_DOWN((rt_ubase_t)fault, window);
+    end = start + window;
+    if (start < (char *)varea->start)
+        start = varea->start;
+    if (end > (char *)varea->start + varea->size || end < start)
+        end = (char *)varea->start + varea->size;
+
+    /* stop at the pages mapped already on both sides of the fault page */
+    for (vaddr = fault + ARCH_PAGE_SIZE; vaddr < end; vaddr += ARCH_PAGE_SIZE)
+    {
+        if (rt_hw_mmu_v2p(varea->aspace, vaddr) != ARCH_MAP_FAILED)
+        {
+            end = vaddr;
+            break;
+        }
+    }
+    for (vaddr = fault; vaddr > start; vaddr -= ARCH_PAGE_SIZE)
+    {
+        if (rt_hw_mmu_v2p(varea->aspace, vaddr - ARCH_PAGE_SIZE) != ARCH_MAP_FAILED)
+        {
+            start = vaddr;
+            break;
+        }
+    }
+
+    msg->around_vaddr = start;
+    msg->around_size = end - start;
+}
+
 static int _fetch_page(rt_varea_t varea, struct rt_aspace_fault_msg *msg)
 {
     int err = UNRECOVERABLE;
     msg->response.status = MM_FAULT_STATUS_UNRECOVERABLE;
     msg->response.vaddr = 0;
     msg->response.size = 0;
+    msg->response.map_vaddr = RT_NULL;
+    _fault_around(varea, msg);
     if (varea->mem_obj && varea->mem_obj->on_page_fault)
     {
         varea->mem_obj->on_page_fault(varea, msg);
@@ -41,14 +90,58 @@ static int _fetch_page(rt_varea_t varea, struct rt_aspace_fault_msg *msg)
     return err;
 }
 
+static int _cow_fault(rt_varea_t varea, void *pa, struct rt_aspace_fault_msg *msg)
+{
+    int err = UNRECOVERABLE;
+    void *page = (char *)pa - PV_OFFSET;
+    void *copy;
+
+    if (rt_page_ref_get(page, 0) == 1)
+    {
+        /* the last owner of the frame takes it over without a copy */
+        if (rt_hw_mmu_control(varea->aspace, msg->fault_vaddr, ARCH_PAGE_SIZE,
+                              MMU_CNTL_READWRITE) == RT_EOK)
+        {
+            rt_hw_tlb_invalidate_range(varea->aspace, msg->fault_vaddr,
+                                       ARCH_PAGE_SIZE, ARCH_PAGE_SIZE);
+            err = RECOVERABLE;
+        }
+    }
+    else
+    {
+        copy = rt_pages_alloc_ext(0, PAGE_ANY_AVAILABLE);
+        if (copy)
+        {
+            rt_memcpy(copy, page, ARCH_PAGE_SIZE);
+            rt_varea_unmap_page(varea, msg->fault_vaddr);
+            rt_pages_free(page, 0);
+
+            msg->response.status = MM_FAULT_STATUS_OK;
+            msg->response.vaddr = copy;
+            msg->response.size = ARCH_PAGE_SIZE;
+            msg->response.map_vaddr = RT_NULL;
+            if (_varea_map_with_msg(varea, msg) == RT_EOK)
+                err = RECOVERABLE;
+            else
+                rt_pages_free(copy, 0);
+        }
+        else
+        {
+            LOG_W("%s: page alloc failed at %p", __func__, msg->fault_vaddr);
+        }
+    }
+
+    return err;
+}
+
 static int _read_fault(rt_varea_t varea, void *pa, struct rt_aspace_fault_msg *msg)
 {
     int err = UNRECOVERABLE;
     if (msg->fault_type == MM_FAULT_TYPE_PAGE_FAULT)
     {
         RT_ASSERT(pa == ARCH_MAP_FAILED);
-        RT_ASSERT(!(varea->flag & MMF_PREFETCH));
-        err = _fetch_page(varea, msg);
+        if (!(varea->flag & MMF_PREFETCH))
+            err = _fetch_page(varea, msg);
     }
     else
     {
@@ -63,12 +156,13 @@ static int _write_fault(rt_varea_t varea, void *pa, struct rt_aspace_fault_msg *
     if (msg->fault_type == MM_FAULT_TYPE_PAGE_FAULT)
     {
         RT_ASSERT(pa == ARCH_MAP_FAILED);
-        RT_ASSERT(!(varea->flag & MMF_PREFETCH));
-        err = _fetch_page(varea, msg);
+        if (!(varea->flag & MMF_PREFETCH))
+            err = _fetch_page(varea, msg);
     }
     else if (msg->fault_type == MM_FAULT_TYPE_ACCESS_FAULT &&
-             varea->flag & MMF_COW)
+             varea->flag & MMF_COW && pa != ARCH_MAP_FAILED)
     {
+        err = _cow_fault(varea, pa, msg);
     }
     else
     {
@@ -83,8 +177,8 @@ static int _exec_fault(rt_varea_t varea, void *pa, struct rt_aspace_fault_msg *m
     if (msg->fault_type == MM_FAULT_TYPE_PAGE_FAULT)
     {
         RT_ASSERT(pa == ARCH_MAP_FAILED);
-        RT_ASSERT(!(varea->flag & MMF_PREFETCH));
-        err = _fetch_page(varea, msg);
+        if (!(varea->flag & MMF_PREFETCH))
+            err = _fetch_page(varea, msg);
     }
     return err;
 }
@@ -107,18 +201,26 @@ int rt_aspace_fault_try_fix(rt_aspace_t aspace, struct rt_aspace_fault_msg *msg)
             void *pa = rt_hw_mmu_v2p(aspace, msg->fault_vaddr);
             msg->off = ((char *)msg->fault_vaddr - (char *)varea->start) >> ARCH_PAGE_SHIFT;
 
-            /* permission checked by fault op */
-            switch (msg->fault_op)
+            if (msg->fault_type == MM_FAULT_TYPE_PAGE_FAULT && pa != ARCH_MAP_FAILED)
+            {
+                /* fixed by another thread while this one waits for the lock */
+                err = RECOVERABLE;
+            }
+            else
             {
-            case MM_FAULT_OP_READ:
-                err = _read_fault(varea, pa, msg);
-                break;
-            case MM_FAULT_OP_WRITE:
-                err = _write_fault(varea, pa, msg);
-                break;
-            case MM_FAULT_OP_EXECUTE:
-                err = _exec_fault(varea, pa, msg);
-                break;
+                /* permission checked by fault op */
+                switch (msg->fault_op)
+                {
+                case MM_FAULT_OP_READ:
+                    err = _read_fault(varea, pa, msg);
+                    break;
+                case MM_FAULT_OP_WRITE:
+                    err = _write_fault(varea, pa, msg);
+                    break;
+                case MM_FAULT_OP_EXECUTE:
+                    err = _exec_fault(varea, pa, msg);
+                    break;
+                }
             }
         }
         RD_UNLOCK(aspace);
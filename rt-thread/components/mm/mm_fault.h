@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-12-06     WangXiaoyao  the first version
+ * 2026-10-18     RT-Thread    size hint of the response
+ * 2026-10-18     RT-Thread    fault-around window and base of the response
  */
 #ifndef __MM_FAULT_H__
 #define __MM_FAULT_H__
@@ -14,6 +16,15 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/* pages of the aligned window mapped around a page fault */
+#ifndef RT_MM_FAULT_AROUND_PAGES
+#define RT_MM_FAULT_AROUND_PAGES        16
+#endif
+
+#if RT_MM_FAULT_AROUND_PAGES == 0 || (RT_MM_FAULT_AROUND_PAGES & (RT_MM_FAULT_AROUND_PAGES - 1)) != 0
+#error "RT_MM_FAULT_AROUND_PAGES must be a power of 2, the window is aligned to its size"
+#endif
+
 /* fast path fault handler, a page frame on kernel space is returned */
 #define MM_FAULT_STATUS_OK              0
 /* customized fault handler, done by using rt_varea_map_* */
@@ -25,6 +36,8 @@ struct rt_mm_fault_res
     void *vaddr;
     rt_size_t size;
     int status;
+    /* where the frames are mapped, RT_NULL for the fault page */
+    void *map_vaddr;
 };
 
 enum rt_mm_fault_op
@@ -49,6 +62,15 @@ struct rt_aspace_fault_msg
     rt_size_t off;
     void *fault_vaddr;
 
+    /**
+     * the pages not mapped around the fault page in the aligned fault-around
+     * window (a section for a huge page varea). A handler with neighbouring
+     * frames resident may return any contiguous run of them covering the
+     * fault page and set the base of it in response.map_vaddr
+     */
+    void *around_vaddr;
+    rt_size_t around_size;
+
     struct rt_mm_fault_res response;
 };
 
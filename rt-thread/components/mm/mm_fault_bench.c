@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Page fault and large mapping benchmark.
+ *
+ * A resident block of contiguous frames is mapped into the kernel space the ways a large mmap()
+ * is, and every page of it is touched once. The page faults taken and the throughput of mapping
+ * and touching are reported: demand faulting with fault-around, demand faulting of a huge page
+ * region, prefetch, and the physical mapping on section boundaries and off them by a page.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(RT_MM_USING_BENCH) && defined(RT_USING_FINSH) && defined(RT_USING_SMART)
+
+#include <mmu.h>
+#include "mm_aspace.h"
+#include "mm_fault.h"
+#include "mm_flag.h"
+#include "mm_page.h"
+
+#include <msh_bench.h>
+
+static char *bench_block;
+static rt_size_t bench_size;
+static rt_uint32_t bench_faults;
+
+static const char *bench_get_name(rt_varea_t varea)
+{
+    return "fault-bench";
+}
+
+/* the block is resident, so all of the window asked for is served */
+static void bench_on_page_fault(struct rt_varea *varea, struct rt_aspace_fault_msg *msg)
+{
+    char *start = msg->around_vaddr;
+    char *end = start + msg->around_size;
+
+    if (end > (char *)varea->start + bench_size)
+        end = (char *)varea->start + bench_size;
+
+    bench_faults++;
+    msg->response.status = MM_FAULT_STATUS_OK;
+    msg->response.vaddr = bench_block + (start - (char *)varea->start);
+    msg->response.size = end - start;
+    msg->response.map_vaddr = start;
+}
+
+static struct rt_mem_obj bench_obj = {
+    .get_name = bench_get_name,
+    .on_page_fault = bench_on_page_fault,
+};
+
+/* read a word of each page, taking the faults the MMU would raise */
+static int bench_touch(char *va, rt_size_t size)
+{
+    struct rt_aspace_fault_msg msg;
+    volatile rt_uint32_t sum = 0;
+    rt_size_t off;
+
+    for (off = 0; off < size; off += ARCH_PAGE_SIZE)
+    {
+        if (rt_hw_mmu_v2p(&rt_kernel_space, va + off) == ARCH_MAP_FAILED)
+        {
+            msg.fault_op = MM_FAULT_OP_READ;
+            msg.fault_type = MM_FAULT_TYPE_PAGE_FAULT;
+            msg.fault_vaddr = va + off;
+            if (!rt_aspace_fault_try_fix(&rt_kernel_space, &msg))
+                return -RT_ERROR;
+        }
+        sum += *(volatile rt_uint32_t *)(va + off);
+    }
+
+    return RT_EOK;
+}
+
+static void bench_report(const char *mode, rt_size_t size, rt_uint32_t t)
+{
+    rt_uint64_t ns = BENCH_CLOCK_NS(t);
+
+    rt_kprintf("%-14s %8d %10d us %8d MB/s\n", mode, bench_faults, (rt_uint32_t)(ns / 1000),
+               ns ? (rt_uint32_t)((rt_uint64_t)size * 1000 / ns) : 0);
+}
+
+static int bench_map(const char *mode, mm_flag_t flags)
+{
+    void *va = RT_NULL;
+    rt_uint32_t t;
+    int err;
+
+    bench_faults = 0;
+    t = BENCH_CLOCK();
+    err = rt_aspace_map(&rt_kernel_space, &va, bench_size, MMU_MAP_K_RWCB, flags, &bench_obj, 0);
+    if (err == RT_EOK)
+        err = bench_touch(va, bench_size);
+    t = BENCH_CLOCK() - t;
+
+    if (va)
+        rt_aspace_unmap(&rt_kernel_space, va);
+    if (err == RT_EOK)
+        bench_report(mode, bench_size, t);
+
+    return err;
+}
+
+static int bench_map_phy(const char *mode, rt_size_t skip)
+{
+    struct rt_mm_va_hint hint = {
+        .limit_start = rt_kernel_space.start,
+        .limit_range_size = rt_kernel_space.size,
+        .prefer = RT_NULL,
+        .map_size = bench_size - skip,
+        .flags = 0,
+    };
+    void *va = RT_NULL;
+    rt_uint32_t t;
+    int err;
+
+    bench_faults = 0;
+    t = BENCH_CLOCK();
+    err = rt_aspace_map_phy(&rt_kernel_space, &hint, MMU_MAP_K_RWCB,
+                            MM_PA_TO_OFF(bench_block + skip + PV_OFFSET), &va);
+    if (err == RT_EOK)
+        err = bench_touch(va, bench_size - skip);
+    t = BENCH_CLOCK() - t;
+
+    if (va)
+        rt_aspace_unmap(&rt_kernel_space, va);
+    if (err == RT_EOK)
+        bench_report(mode, bench_size - skip, t);
+
+    return err;
+}
+
+static void mm_fault_bench(int argc, char **argv)
+{
+    rt_uint32_t order = 0;
+    rt_size_t size = 4096;
+
+    if (argc > 1) size = strtoul(argv[1], RT_NULL, 0);
+    if (size == 0)
+    {
+        rt_kprintf("Usage: mm_fault_bench [size KB]\n");
+        return;
+    }
+
+    size = RT_ALIGN(size * 1024, ARCH_PAGE_SIZE);
+    while (((rt_size_t)ARCH_PAGE_SIZE << order) < size)
+        order++;
+    if (order >= RT_PAGE_MAX_ORDER)
+    {
+        rt_kprintf("no more than %d KB\n", (ARCH_PAGE_SIZE << (RT_PAGE_MAX_ORDER - 1)) / 1024);
+        return;
+    }
+
+    bench_block = rt_pages_alloc_ext(order, PAGE_ANY_AVAILABLE);
+    if (!bench_block)
+    {
+        rt_kprintf("no memory for %d KB\n", (ARCH_PAGE_SIZE << order) / 1024);
+        return;
+    }
+    bench_size = size;
+
+    rt_kprintf("%d KB, fault-around %d pages\n", size / 1024, RT_MM_FAULT_AROUND_PAGES);
+    rt_kprintf("mode             faults   map+touch      throughput\n");
+    if (bench_map("demand", 0) != RT_EOK ||
+        bench_map("demand huge", MMF_CREATE(MMF_HUGEPAGE, ARCH_SECTION_SIZE)) != RT_EOK ||
+        bench_map("prefetch", MMF_CREATE(MMF_PREFETCH, ARCH_SECTION_SIZE)) != RT_EOK ||
+        bench_map_phy("phy", 0) != RT_EOK ||
+        bench_map_phy("phy unaligned", ARCH_PAGE_SIZE) != RT_EOK)
+    {
+        rt_kprintf("mapping failed\n");
+    }
+
+    rt_pages_free(bench_block, order);
+    bench_block = RT_NULL;
+}
+MSH_CMD_EXPORT(mm_fault_bench, page faults and throughput of large mappings);
+
+#endif /* defined(RT_MM_USING_BENCH) && defined(RT_USING_FINSH) && defined(RT_USING_SMART) */
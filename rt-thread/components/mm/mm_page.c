@@ -9,6 +9,7 @@
  * 2022-12-13     WangXiaoyao  Hot-pluggable, extensible
  *                             page management algorithm
  * 2023-02-20     WangXiaoyao  Multi-list page-management
+ * 2026-10-18     RT-Thread    fault-around of the init region
  */
 #include <rtthread.h>
 
@@ -68,10 +69,19 @@ static void on_page_fault(struct rt_varea *varea, struct rt_aspace_fault_msg *ms
     char *init_end = (void *)init_mpr_align_end;
     if ((char *)msg->fault_vaddr < init_end && (char *)msg->fault_vaddr >= init_start)
     {
-        rt_size_t offset = (char *)msg->fault_vaddr - init_start;
+        char *start = msg->around_vaddr;
+        char *end = start + msg->around_size;
+
+        /* the region is contiguous, serve all of the window inside it in a time */
+        if (start < init_start)
+            start = init_start;
+        if (end > init_end)
+            end = init_end;
+
         msg->response.status = MM_FAULT_STATUS_OK;
-        msg->response.vaddr = (char *)init_mpr_cont_start + offset;
-        msg->response.size = ARCH_PAGE_SIZE;
+        msg->response.vaddr = (char *)init_mpr_cont_start + (start - init_start);
+        msg->response.size = end - start;
+        msg->response.map_vaddr = start;
     }
     else
     {
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2018-03-30     chenyong     first version
  * 2018-08-17     chenyong     multiple client support
+ * 2026-10-18     RT-Thread    add the compiled URC matcher
  */
 
 #ifndef __AT_H__
@@ -159,6 +160,46 @@ struct at_urc_table
 };
 typedef struct at_urc *at_urc_table_t;
 
+/* the URC prefix trie node, children are linked by sibling */
+struct at_urc_node
+{
+    char ch;
+    rt_uint16_t child;
+    rt_uint16_t sibling;
+    /* the nearest ancestor node which URC prefixes end at */
+    rt_uint16_t out;
+    /* the URCs whose prefix ends at this node, in table order */
+    rt_uint16_t urc_first;
+    rt_uint16_t urc_count;
+};
+
+struct at_urc_entry
+{
+    const struct at_urc *urc;
+    /* the position of the URC in all tables, the first one matched wins */
+    rt_uint16_t order;
+    rt_uint16_t prefix_len;
+    rt_uint16_t suffix_len;
+    char suffix_last;
+};
+
+/* URC tables compiled into a prefix trie by at_obj_set_urc_table() */
+struct at_urc_matcher
+{
+    struct at_urc_node *nodes;
+    rt_uint16_t node_num;
+    struct at_urc_entry *entries;
+    rt_uint16_t entry_num;
+};
+
+/* the matcher state of the line being received */
+struct at_urc_cursor
+{
+    const struct at_urc_matcher *matcher;
+    rt_uint16_t node;
+    rt_uint16_t depth;
+};
+
 struct at_client
 {
     rt_device_t device;
@@ -181,6 +222,10 @@ struct at_client
 
     struct at_urc_table *urc_table;
     rt_size_t urc_table_size;
+    struct at_urc_matcher *urc_matcher;
+    struct at_urc_cursor urc_cursor;
+    /* the URC matched by the current received line */
+    const struct at_urc *urc;
 
     rt_thread_t parser;
 };
@@ -226,6 +271,12 @@ void at_obj_set_end_sign(at_client_t client, char ch);
 /* Set URC(Unsolicited Result Code) table */
 int at_obj_set_urc_table(at_client_t client, const struct at_urc * table, rt_size_t size);
 
+/* URC tables compiled into a matcher, fed a line byte by byte */
+struct at_urc_matcher *at_urc_matcher_create(const struct at_urc_table *table, rt_size_t table_size);
+void at_urc_matcher_delete(struct at_urc_matcher *matcher);
+const struct at_urc *at_urc_matcher_feed(const struct at_urc_matcher *matcher, struct at_urc_cursor *cursor,
+                                         const char *buf, rt_size_t len);
+
 /* AT client send commands to AT server and waiter response */
 int at_obj_exec_cmd(at_client_t client, at_response_t resp, const char *cmd_expr, ...);
 
@@ -10,9 +10,11 @@
  * 2018-08-17     chenyong     multiple client support
  * 2021-03-17     Meco Man     fix a buf of leaking memory
  * 2021-07-14     Sszl         fix a buf of leaking memory
+ * 2026-10-18     RT-Thread    match URCs incrementally with a compiled prefix trie
  */
 
 #include <at.h>
+#include <rthw.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -27,7 +29,11 @@
 #define AT_RESP_END_FAIL               "FAIL"
 #define AT_END_CR_LF                   "\r\n"
 
+#define AT_URC_NODE_NONE               0xFFFF
+
 static struct at_client at_client_table[AT_CLIENT_NUM_MAX] = { 0 };
+/* protect the URC matcher of the clients from being replaced while it is used */
+static struct rt_spinlock at_urc_lock;
 
 extern rt_size_t at_utils_send(rt_device_t dev,
                                rt_off_t    pos,
@@ -540,6 +546,221 @@ void at_obj_set_end_sign(at_client_t client, char ch)
     client->end_sign = ch;
 }
 
+/**
+ * Delete the compiled URC matcher.
+ *
+ * @param matcher URC matcher
+ */
+void at_urc_matcher_delete(struct at_urc_matcher *matcher)
+{
+    if (matcher)
+    {
+        rt_free(matcher->nodes);
+        rt_free(matcher->entries);
+        rt_free(matcher);
+    }
+}
+
+/**
+ * Compile the URC tables into a prefix trie. Every URC is attached to the node its
+ * prefix ends at, the lengths are computed once here instead of on every received byte.
+ *
+ * @param table URC tables
+ * @param table_size the number of URC tables
+ *
+ * @return != RT_NULL: URC matcher
+ *          = RT_NULL: no memory or too many URCs
+ */
+struct at_urc_matcher *at_urc_matcher_create(const struct at_urc_table *table, rt_size_t table_size)
+{
+    struct at_urc_matcher *matcher = RT_NULL;
+    rt_uint16_t *node_of = RT_NULL, *parent = RT_NULL;
+    rt_size_t i, j, urc_num = 0, node_max = 1;
+    rt_uint16_t n, c, order, first;
+    const struct at_urc *urc;
+    struct at_urc_entry *entry;
+    const char *p;
+
+    for (i = 0; i < table_size; i++)
+    {
+        for (j = 0; j < table[i].urc_size; j++)
+        {
+            urc_num++;
+            node_max += rt_strlen(table[i].urc[j].cmd_prefix);
+        }
+    }
+    if (node_max >= AT_URC_NODE_NONE || urc_num >= AT_URC_NODE_NONE)
+    {
+        LOG_E("AT client URC table is too large(%d URCs, %d prefix bytes)!", urc_num, node_max);
+        return RT_NULL;
+    }
+
+    matcher = (struct at_urc_matcher *) rt_calloc(1, sizeof(struct at_urc_matcher));
+    node_of = (rt_uint16_t *) rt_malloc((urc_num + 1) * sizeof(rt_uint16_t));
+    parent = (rt_uint16_t *) rt_malloc(node_max * sizeof(rt_uint16_t));
+    if (matcher == RT_NULL || node_of == RT_NULL || parent == RT_NULL)
+    {
+        goto __nomem;
+    }
+    matcher->nodes = (struct at_urc_node *) rt_calloc(node_max, sizeof(struct at_urc_node));
+    matcher->entries = (struct at_urc_entry *) rt_calloc(urc_num + 1, sizeof(struct at_urc_entry));
+    if (matcher->nodes == RT_NULL || matcher->entries == RT_NULL)
+    {
+        goto __nomem;
+    }
+
+    matcher->nodes[0].child = AT_URC_NODE_NONE;
+    matcher->nodes[0].sibling = AT_URC_NODE_NONE;
+    matcher->nodes[0].out = AT_URC_NODE_NONE;
+    matcher->node_num = 1;
+    matcher->entry_num = urc_num;
+
+    /* insert the prefixes, the children of a node are always created after it */
+    for (i = 0, order = 0; i < table_size; i++)
+    {
+        for (j = 0; j < table[i].urc_size; j++, order++)
+        {
+            n = 0;
+            for (p = table[i].urc[j].cmd_prefix; *p; p++)
+            {
+                for (c = matcher->nodes[n].child; c != AT_URC_NODE_NONE && matcher->nodes[c].ch != *p;
+                        c = matcher->nodes[c].sibling);
+                if (c == AT_URC_NODE_NONE)
+                {
+                    c = matcher->node_num++;
+                    matcher->nodes[c].ch = *p;
+                    matcher->nodes[c].child = AT_URC_NODE_NONE;
+                    matcher->nodes[c].sibling = matcher->nodes[n].child;
+                    matcher->nodes[n].child = c;
+                    parent[c] = n;
+                }
+                n = c;
+            }
+            node_of[order] = n;
+            matcher->nodes[n].urc_count++;
+        }
+    }
+
+    /* place the URCs of one node together, keeping the table order */
+    for (n = 0, first = 0; n < matcher->node_num; n++)
+    {
+        matcher->nodes[n].urc_first = first;
+        first += matcher->nodes[n].urc_count;
+        matcher->nodes[n].urc_count = 0;
+    }
+    for (i = 0, order = 0; i < table_size; i++)
+    {
+        for (j = 0; j < table[i].urc_size; j++, order++)
+        {
+            urc = table[i].urc + j;
+            n = node_of[order];
+            entry = &matcher->entries[matcher->nodes[n].urc_first + matcher->nodes[n].urc_count++];
+            entry->urc = urc;
+            entry->order = order;
+            entry->prefix_len = rt_strlen(urc->cmd_prefix);
+            entry->suffix_len = rt_strlen(urc->cmd_suffix);
+            entry->suffix_last = entry->suffix_len ? urc->cmd_suffix[entry->suffix_len - 1] : 0;
+        }
+    }
+
+    /* a line matching a prefix also matches all the shorter prefixes on its path */
+    for (n = 1; n < matcher->node_num; n++)
+    {
+        c = parent[n];
+        matcher->nodes[n].out = matcher->nodes[c].urc_count ? c : matcher->nodes[c].out;
+    }
+
+    rt_free(node_of);
+    rt_free(parent);
+
+    return matcher;
+
+__nomem:
+    LOG_E("AT client compile URC table failed! No memory for URC matcher.");
+    rt_free(node_of);
+    rt_free(parent);
+    at_urc_matcher_delete(matcher);
+
+    return RT_NULL;
+}
+
+rt_inline void at_urc_cursor_step(const struct at_urc_matcher *matcher, struct at_urc_cursor *cursor, char ch)
+{
+    rt_uint16_t c;
+
+    for (c = matcher->nodes[cursor->node].child; c != AT_URC_NODE_NONE && matcher->nodes[c].ch != ch;
+            c = matcher->nodes[c].sibling);
+    if (c != AT_URC_NODE_NONE)
+    {
+        cursor->node = c;
+        cursor->depth++;
+    }
+}
+
+/**
+ * Match the line being received against the compiled URC tables after a byte is appended.
+ * The cursor follows the trie while the whole line is a prefix of some URC, so only the
+ * URCs whose prefix matches have their suffix checked.
+ *
+ * @param matcher URC matcher
+ * @param cursor matcher state of the line, it restarts when the line length is 1
+ * @param buf the line buffer
+ * @param len the line length, the last byte is the one just received
+ *
+ * @return != RT_NULL: the first URC in table order matching the line
+ *          = RT_NULL: no URC matches the line
+ */
+const struct at_urc *at_urc_matcher_feed(const struct at_urc_matcher *matcher, struct at_urc_cursor *cursor,
+                                         const char *buf, rt_size_t len)
+{
+    const struct at_urc_entry *entry;
+    const struct at_urc *urc = RT_NULL;
+    rt_uint16_t n, k, best = AT_URC_NODE_NONE;
+    char ch = buf[len - 1];
+    rt_size_t i;
+
+    if (len == 1 || cursor->matcher != matcher)
+    {
+        /* new line or the tables are changed, walk the received part again */
+        cursor->matcher = matcher;
+        cursor->node = 0;
+        cursor->depth = 0;
+        for (i = 0; i + 1 < len && cursor->depth == i; i++)
+        {
+            at_urc_cursor_step(matcher, cursor, buf[i]);
+        }
+    }
+    if (cursor->depth == len - 1)
+    {
+        at_urc_cursor_step(matcher, cursor, ch);
+    }
+
+    for (n = cursor->node; n != AT_URC_NODE_NONE; n = matcher->nodes[n].out)
+    {
+        for (k = 0; k < matcher->nodes[n].urc_count; k++)
+        {
+            entry = &matcher->entries[matcher->nodes[n].urc_first + k];
+            if (entry->order >= best)
+            {
+                break;
+            }
+            if (len < entry->prefix_len + entry->suffix_len)
+            {
+                continue;
+            }
+            if (entry->suffix_len == 0 || (ch == entry->suffix_last &&
+                    !rt_memcmp(buf + len - entry->suffix_len, entry->urc->cmd_suffix, entry->suffix_len)))
+            {
+                best = entry->order;
+                urc = entry->urc;
+                break;
+            }
+        }
+    }
+
+    return urc;
+}
+
 /**
  * set URC(Unsolicited Result Code) table
  *
@@ -550,6 +771,7 @@ void at_obj_set_end_sign(at_client_t client, char ch)
 int at_obj_set_urc_table(at_client_t client, const struct at_urc *urc_table, rt_size_t table_sz)
 {
     rt_size_t idx;
+    struct at_urc_matcher *matcher = RT_NULL, *old_matcher = RT_NULL;
 
     if (client == RT_NULL)
     {
@@ -592,6 +814,21 @@ int at_obj_set_urc_table(at_client_t client, const struct at_urc *urc_table, rt_
 
     }
 
+    /* compile all the tables again, the parser keeps using the old matcher until it is replaced */
+    matcher = at_urc_matcher_create(client->urc_table, client->urc_table_size);
+    if (matcher == RT_NULL)
+    {
+        client->urc_table_size--;
+        return -RT_ENOMEM;
+    }
+
+    rt_spin_lock(&at_urc_lock);
+    old_matcher = client->urc_matcher;
+    client->urc_matcher = matcher;
+    rt_spin_unlock(&at_urc_lock);
+
+    at_urc_matcher_delete(old_matcher);
+
     return RT_EOK;
 }
 
@@ -635,46 +872,6 @@ at_client_t at_client_get_first(void)
     return &at_client_table[0];
 }
 
-static const struct at_urc *get_urc_obj(at_client_t client)
-{
-    rt_size_t i, j, prefix_len, suffix_len;
-    rt_size_t bufsz;
-    char *buffer = RT_NULL;
-    const struct at_urc *urc = RT_NULL;
-    struct at_urc_table *urc_table = RT_NULL;
-
-    if (client->urc_table == RT_NULL)
-    {
-        return RT_NULL;
-    }
-
-    buffer = client->recv_line_buf;
-    bufsz = client->recv_line_len;
-
-    for (i = 0; i < client->urc_table_size; i++)
-    {
-        for (j = 0; j < client->urc_table[i].urc_size; j++)
-        {
-            urc_table = client->urc_table + i;
-            urc = urc_table->urc + j;
-
-            prefix_len = rt_strlen(urc->cmd_prefix);
-            suffix_len = rt_strlen(urc->cmd_suffix);
-            if (bufsz < prefix_len + suffix_len)
-            {
-                continue;
-            }
-            if ((prefix_len ? !rt_strncmp(buffer, urc->cmd_prefix, prefix_len) : 1)
-                    && (suffix_len ? !rt_strncmp(buffer + bufsz - suffix_len, urc->cmd_suffix, suffix_len) : 1))
-            {
-                return urc;
-            }
-        }
-    }
-
-    return RT_NULL;
-}
-
 static int at_recv_readline(at_client_t client)
 {
     rt_size_t read_len = 0;
@@ -683,6 +880,7 @@ static int at_recv_readline(at_client_t client)
 
     rt_memset(client->recv_line_buf, 0x00, client->recv_bufsz);
     client->recv_line_len = 0;
+    client->urc = RT_NULL;
 
     while (1)
     {
@@ -692,6 +890,15 @@ static int at_recv_readline(at_client_t client)
         {
             client->recv_line_buf[read_len++] = ch;
             client->recv_line_len = read_len;
+
+            /* the line only changes when a byte is appended, so does the URC it matches */
+            if (client->urc_matcher)
+            {
+                rt_spin_lock(&at_urc_lock);
+                client->urc = at_urc_matcher_feed(client->urc_matcher, &client->urc_cursor,
+                                                  client->recv_line_buf, read_len);
+                rt_spin_unlock(&at_urc_lock);
+            }
         }
         else
         {
@@ -700,7 +907,7 @@ static int at_recv_readline(at_client_t client)
 
         /* is newline or URC data */
         if ((ch == '\n' && last_ch == '\r') || (client->end_sign != 0 && ch == client->end_sign)
-                || get_urc_obj(client))
+                || client->urc)
         {
             if (is_full)
             {
@@ -729,7 +936,7 @@ static void client_parser(at_client_t client)
     {
         if (at_recv_readline(client) > 0)
         {
-            if ((urc = get_urc_obj(client)) != RT_NULL)
+            if ((urc = client->urc) != RT_NULL)
             {
                 /* current receive is request, try to execute related operations */
                 if (urc->func != RT_NULL)
@@ -824,6 +1031,11 @@ static int at_client_para_init(at_client_t client)
     static int at_client_num = 0;
     char name[RT_NAME_MAX];
 
+    if (at_client_num == 0)
+    {
+        rt_spin_lock_init(&at_urc_lock);
+    }
+
     client->status = AT_STATUS_UNINITIALIZED;
 
     client->recv_line_len = 0;
@@ -864,6 +1076,8 @@ static int at_client_para_init(at_client_t client)
 
     client->urc_table = RT_NULL;
     client->urc_table_size = 0;
+    client->urc_matcher = RT_NULL;
+    client->urc = RT_NULL;
 
     rt_snprintf(name, RT_NAME_MAX, "%s%d", AT_CLIENT_THREAD_NAME, at_client_num);
     client->parser = rt_thread_create(name,
@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * AT client URC matching benchmark.
+ *
+ * A traffic capture of a cellular module is replayed: socket data frames ("+IPD,<id>,<len>:"
+ * followed by the payload) mixed with network status URCs and command responses, against a
+ * table of BENCH_URC_NUM URCs. The capture is first split into lines the way the parser does
+ * and matched with the linear table scan and with the compiled matcher, both must pick the
+ * same URCs. Then it is fed through the parser of an AT client on a simulated device, the
+ * URC handlers read the socket payload with at_client_recv() as the module drivers do.
+ */
+
+#include <at.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(AT_USING_URC_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_DEVICE_NAME       "atsim"
+#define BENCH_LINE_SIZE         256
+#define BENCH_PAYLOAD_MAX       128
+
+struct at_sim
+{
+    struct rt_device parent;
+    const char *data;
+    rt_size_t size;
+    rt_size_t pos;
+    rt_bool_t registered;
+};
+
+static struct at_sim sim;
+static volatile rt_uint32_t urc_handled;
+
+/* the payload length of "+IPD,<id>,<len>:" */
+static int ipd_payload_len(const char *data)
+{
+    const char *p = strchr(data, ',');
+
+    if (p == RT_NULL || (p = strchr(p + 1, ',')) == RT_NULL)
+    {
+        return 0;
+    }
+
+    return atoi(p + 1);
+}
+
+static void urc_ipd_func(struct at_client *client, const char *data, rt_size_t size)
+{
+    char payload[BENCH_PAYLOAD_MAX];
+    int len = ipd_payload_len(data);
+
+    if (len > 0 && len <= BENCH_PAYLOAD_MAX)
+    {
+        at_client_obj_recv(client, payload, len, 100);
+    }
+    urc_handled++;
+}
+
+static void urc_count_func(struct at_client *client, const char *data, rt_size_t size)
+{
+    urc_handled++;
+}
+
+/* the URCs a typical LTE module driver registers, the data frame URC comes last */
+static const struct at_urc bench_urc_table[] =
+{
+    {"RDY",             "\r\n", urc_count_func},
+    {"+CPIN:",          "\r\n", urc_count_func},
+    {"+CFUN:",          "\r\n", urc_count_func},
+    {"+QUSIM:",         "\r\n", urc_count_func},
+    {"+QIND: SMS DONE", "\r\n", urc_count_func},
+    {"+QIND: PB DONE",  "\r\n", urc_count_func},
+    {"+QIND:",          "\r\n", urc_count_func},
+    {"+CREG:",          "\r\n", urc_count_func},
+    {"+CGREG:",         "\r\n", urc_count_func},
+    {"+CEREG:",         "\r\n", urc_count_func},
+    {"+C5GREG:",        "\r\n", urc_count_func},
+    {"+CGEV:",          "\r\n", urc_count_func},
+    {"+CTZV:",          "\r\n", urc_count_func},
+    {"+CTZE:",          "\r\n", urc_count_func},
+    {"+QNITZ:",         "\r\n", urc_count_func},
+    {"+CMTI:",          "\r\n", urc_count_func},
+    {"+CMT:",           "\r\n", urc_count_func},
+    {"+CDS:",           "\r\n", urc_count_func},
+    {"+CBM:",           "\r\n", urc_count_func},
+    {"RING",            "\r\n", urc_count_func},
+    {"+CRING:",         "\r\n", urc_count_func},
+    {"+CLIP:",          "\r\n", urc_count_func},
+    {"NO CARRIER",      "\r\n", urc_count_func},
+    {"+QIOPEN:",        "\r\n", urc_count_func},
+    {"+QIURC: \"closed\"", "\r\n", urc_count_func},
+    {"+QIURC: \"pdpdeact\"", "\r\n", urc_count_func},
+    {"+QIURC: \"dnsgip\"", "\r\n", urc_count_func},
+    {"+QIURC: \"incoming\"", "\r\n", urc_count_func},
+    {"+QSSLOPEN:",      "\r\n", urc_count_func},
+    {"+QSSLURC:",       "\r\n", urc_count_func},
+    {"+QMTOPEN:",       "\r\n", urc_count_func},
+    {"+QMTCONN:",       "\r\n", urc_count_func},
+    {"+QMTSTAT:",       "\r\n", urc_count_func},
+    {"+QMTRECV:",       "\r\n", urc_count_func},
+    {"+QMTPUBEX:",      "\r\n", urc_count_func},
+    {"+QHTTPGET:",      "\r\n", urc_count_func},
+    {"+QFTPGET:",       "\r\n", urc_count_func},
+    {"+QPING:",         "\r\n", urc_count_func},
+    {"+QGPSURC:",       "\r\n", urc_count_func},
+    {"+QSIMSTAT:",      "\r\n", urc_count_func},
+    {"POWERED DOWN",    "\r\n", urc_count_func},
+    {"+IPD",            ":",    urc_ipd_func},
+};
+#define BENCH_URC_NUM           (sizeof(bench_urc_table) / sizeof(bench_urc_table[0]))
+
+/* the status lines of the capture, a few of them are responses and do not match any URC */
+static const char *const bench_status_lines[] =
+{
+    "+CEREG: 1,\"1A2B\",\"0C3D4E5F\",7\r\n",
+    "+QIURC: \"closed\",1\r\n",
+    "+QMTRECV: 0,1,\"topic/sensor\",\"{\\\"t\\\":25}\"\r\n",
+    "+CSQ: 23,99\r\n",
+    "+QIND: \"csq\",23,99\r\n",
+    "OK\r\n",
+    "SEND OK\r\n",
+    "+CGEV: ME PDN ACT 1\r\n",
+};
+
+static char *capture_build(rt_size_t size, rt_size_t *capture_size, rt_uint32_t *urc_num)
+{
+    rt_size_t pos = 0, len, i;
+    rt_uint32_t seed = 1, frames = 0;
+    const char *line;
+    char *buf;
+
+    buf = (char *) rt_malloc(size);
+    if (buf == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    *urc_num = 0;
+    while (1)
+    {
+        seed = seed * 1103515245 + 12345;
+        if (frames++ % 4 == 3)
+        {
+            line = bench_status_lines[(seed >> 16) % (sizeof(bench_status_lines) / sizeof(bench_status_lines[0]))];
+            len = rt_strlen(line);
+            if (pos + len > size)
+            {
+                break;
+            }
+            rt_memcpy(buf + pos, line, len);
+            /* the responses are not URCs */
+            if (line[0] == '+' && rt_strncmp(line, "+CSQ:", 5))
+            {
+                (*urc_num)++;
+            }
+        }
+        else
+        {
+            char head[24];
+            rt_size_t payload = 16 + (seed >> 16) % (BENCH_PAYLOAD_MAX - 16);
+
+            len = rt_snprintf(head, sizeof(head), "+IPD,%d,%d:", (int)(frames % 5), (int)payload);
+            if (pos + len + payload > size)
+            {
+                break;
+            }
+            rt_memcpy(buf + pos, head, len);
+            for (i = 0; i < payload; i++)
+            {
+                seed = seed * 1103515245 + 12345;
+                buf[pos + len + i] = (char)(seed >> 24);
+            }
+            len += payload;
+            (*urc_num)++;
+        }
+        pos += len;
+    }
+    *capture_size = pos;
+
+    return buf;
+}
+
+/* the table scan the parser used to do after every received byte */
+static const struct at_urc *linear_match(const struct at_urc_table *table, rt_size_t table_size,
+                                         const char *buffer, rt_size_t bufsz)
+{
+    rt_size_t i, j, prefix_len, suffix_len;
+    const struct at_urc *urc;
+
+    for (i = 0; i < table_size; i++)
+    {
+        for (j = 0; j < table[i].urc_size; j++)
+        {
+            urc = table[i].urc + j;
+            prefix_len = rt_strlen(urc->cmd_prefix);
+            suffix_len = rt_strlen(urc->cmd_suffix);
+            if (bufsz < prefix_len + suffix_len)
+            {
+                continue;
+            }
+            if ((prefix_len ? !rt_strncmp(buffer, urc->cmd_prefix, prefix_len) : 1)
+                    && (suffix_len ? !rt_strncmp(buffer + bufsz - suffix_len, urc->cmd_suffix, suffix_len) : 1))
+            {
+                return urc;
+            }
+        }
+    }
+
+    return RT_NULL;
+}
+
+/* split the capture into lines as at_recv_readline() does, return the URCs matched */
+static rt_uint32_t offline_run(const char *data, rt_size_t size, const struct at_urc_table *table,
+                               const struct at_urc_matcher *matcher, rt_uint32_t *cost)
+{
+    char line[BENCH_LINE_SIZE];
+    struct at_urc_cursor cursor = {0};
+    const struct at_urc *urc;
+    rt_uint32_t start, urc_num = 0;
+    rt_size_t pos, len = 0;
+
+    start = BENCH_CLOCK();
+    for (pos = 0; pos < size; pos++)
+    {
+        if (len == sizeof(line) - 1)
+        {
+            len = 0;
+        }
+        line[len++] = data[pos];
+        if (matcher)
+        {
+            urc = at_urc_matcher_feed(matcher, &cursor, line, len);
+        }
+        else
+        {
+            urc = linear_match(table, 1, line, len);
+        }
+
+        if (urc)
+        {
+            urc_num++;
+            if (urc->func == urc_ipd_func)
+            {
+                line[len] = '\0';
+                pos += ipd_payload_len(line);
+            }
+            len = 0;
+        }
+        else if (len > 1 && line[len - 2] == '\r' && line[len - 1] == '\n')
+        {
+            len = 0;
+        }
+    }
+    *cost = BENCH_CLOCK() - start;
+
+    return urc_num;
+}
+
+static rt_ssize_t sim_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    rt_size_t len = sim.size - sim.pos;
+
+    if (len > size)
+    {
+        len = size;
+    }
+    rt_memcpy(buffer, sim.data + sim.pos, len);
+    sim.pos += len;
+
+    return len;
+}
+
+static rt_ssize_t sim_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    return size;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+static const struct rt_device_ops sim_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    sim_read,
+    sim_write,
+    RT_NULL
+};
+#endif
+
+static at_client_t sim_client_get(void)
+{
+    at_client_t client;
+
+    if (!sim.registered)
+    {
+        sim.parent.type = RT_Device_Class_Char;
+#ifdef RT_USING_DEVICE_OPS
+        sim.parent.ops = &sim_ops;
+#else
+        sim.parent.read = sim_read;
+        sim.parent.write = sim_write;
+#endif
+        if (rt_device_register(&sim.parent, BENCH_DEVICE_NAME, RT_DEVICE_FLAG_RDWR) != RT_EOK)
+        {
+            return RT_NULL;
+        }
+        sim.registered = RT_TRUE;
+    }
+
+    client = at_client_get(BENCH_DEVICE_NAME);
+    if (client == RT_NULL)
+    {
+        if (at_client_init(BENCH_DEVICE_NAME, BENCH_LINE_SIZE) != RT_EOK)
+        {
+            rt_kprintf("no free AT client for the simulated device, check AT_CLIENT_NUM_MAX\n");
+            return RT_NULL;
+        }
+        client = at_client_get(BENCH_DEVICE_NAME);
+        at_obj_set_urc_table(client, bench_urc_table, BENCH_URC_NUM);
+    }
+
+    return client;
+}
+
+static void at_urc_bench(int argc, char **argv)
+{
+    struct at_urc_table table = {BENCH_URC_NUM, bench_urc_table};
+    struct at_urc_matcher *matcher;
+    rt_uint32_t urc_num, linear_num, trie_num, linear_cost, trie_cost;
+    rt_size_t size = 16 * 1024;
+    rt_tick_t start, ticks;
+    at_client_t client;
+    char *data;
+
+    if (argc > 1) size = strtoul(argv[1], RT_NULL, 0);
+    if (size < 256)
+    {
+        rt_kprintf("Usage: at_urc_bench [capture_bytes]\n");
+        return;
+    }
+
+    data = capture_build(size, &size, &urc_num);
+    matcher = at_urc_matcher_create(&table, 1);
+    if (data == RT_NULL || matcher == RT_NULL)
+    {
+        rt_kprintf("no memory for the capture\n");
+        rt_free(data);
+        at_urc_matcher_delete(matcher);
+        return;
+    }
+    sim.data = data;
+    sim.size = size;
+
+    rt_kprintf("%d URCs registered, capture %d bytes with %d URCs\n", BENCH_URC_NUM, sim.size, urc_num);
+    linear_num = offline_run(data, sim.size, &table, RT_NULL, &linear_cost);
+    trie_num = offline_run(data, sim.size, &table, matcher, &trie_cost);
+    rt_kprintf("linear  %6d URCs %8d us\n", linear_num, BENCH_CLOCK_US(linear_cost));
+    rt_kprintf("trie    %6d URCs %8d us\n", trie_num, BENCH_CLOCK_US(trie_cost));
+    if (linear_num != urc_num || trie_num != urc_num)
+    {
+        rt_kprintf("ERROR: the URCs matched differ from the capture\n");
+    }
+    at_urc_matcher_delete(matcher);
+
+    client = sim_client_get();
+    if (client != RT_NULL)
+    {
+        urc_handled = 0;
+        sim.pos = 0;
+        start = rt_tick_get();
+        sim.parent.rx_indicate(&sim.parent, sim.size);
+        while (urc_handled < urc_num && rt_tick_get() - start < RT_TICK_PER_SECOND * 10)
+        {
+            rt_thread_delay(1);
+        }
+        ticks = rt_tick_get() - start;
+        rt_kprintf("parser  %6d URCs %8d ms, %d bytes/s\n", urc_handled, ticks * 1000 / RT_TICK_PER_SECOND,
+                   ticks ? (rt_uint32_t)((rt_uint64_t)sim.size * RT_TICK_PER_SECOND / ticks) : 0);
+        /* the parser may still be waiting on the last bytes */
+        sim.size = sim.pos;
+    }
+
+    sim.data = RT_NULL;
+    sim.size = sim.pos = 0;
+    rt_free(data);
+}
+MSH_CMD_EXPORT(at_urc_bench, AT client URC matching on a replayed modem capture);
+
+#ifdef RT_USING_UTEST
+#include <utest.h>
+
+static void test_urc_matcher(void)
+{
+    struct at_urc_table table = {BENCH_URC_NUM, bench_urc_table};
+    struct at_urc_matcher *matcher;
+    rt_uint32_t urc_num, cost;
+    rt_size_t size;
+    char *data;
+
+    data = capture_build(4096, &size, &urc_num);
+    matcher = at_urc_matcher_create(&table, 1);
+    uassert_not_null(data);
+    uassert_not_null(matcher);
+    if (data && matcher)
+    {
+        /* the table scan and the compiled matcher find every URC of the capture */
+        uassert_int_equal(offline_run(data, size, &table, RT_NULL, &cost), urc_num);
+        uassert_int_equal(offline_run(data, size, &table, matcher, &cost), urc_num);
+    }
+    at_urc_matcher_delete(matcher);
+    rt_free(data);
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_urc_matcher);
+}
+UTEST_TC_EXPORT(testcase, "components.net.at.at_urc_bench", RT_NULL, RT_NULL, 10);
+#endif /* RT_USING_UTEST */
+
+#endif /* defined(AT_USING_URC_BENCH) && defined(RT_USING_FINSH) */
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ * 2026-10-18     RT-Thread    build the tables with the scheduler running
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <crc.h>
+
+#ifdef RT_CRC_USING_SLICING_BY_8
+#define CRC_SLICES              8
+#else
+#define CRC_SLICES              1
+#endif
+
+#ifndef RT_CRC_HW_THRESHOLD
+#define RT_CRC_HW_THRESHOLD     64
+#endif
+
+struct crc_algo
+{
+    rt_uint32_t poly;           /* reflected polynomial */
+    rt_uint32_t init;
+    rt_uint32_t xorout;
+    rt_uint8_t width;
+};
+
+static const struct crc_algo crc_algos[RT_CRC_TYPE_MAX] =
+{
+    [RT_CRC16_MODBUS] = {0xA001, 0xFFFF, 0x0000, 16},
+    [RT_CRC32] = {0xEDB88320, 0xFFFFFFFF, 0xFFFFFFFF, 32},
+};
+
+#define CRC_TABLE_EMPTY         0
+#define CRC_TABLE_BUILDING      1
+#define CRC_TABLE_READY         2
+
+/* table[k][n] is the CRC of the byte n followed by k zero bytes */
+static rt_uint32_t crc_tables[RT_CRC_TYPE_MAX][CRC_SLICES][256];
+static rt_atomic_t crc_table_state[RT_CRC_TYPE_MAX];
+
+static void crc_table_build(rt_crc_type_t type)
+{
+    rt_uint32_t (*table)[256] = crc_tables[type];
+    rt_uint32_t poly = crc_algos[type].poly;
+    rt_uint32_t c;
+    int i, j;
+
+    for (i = 0; i < 256; i++)
+    {
+        c = i;
+        for (j = 0; j < 8; j++)
+        {
+            c = (c & 0x01) ? (c >> 1) ^ poly : c >> 1;
+        }
+        table[0][i] = c;
+    }
+    for (j = 1; j < CRC_SLICES; j++)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            c = table[j - 1][i];
+            table[j][i] = (c >> 8) ^ table[0][c & 0xFF];
+        }
+    }
+}
+
+/* the tables of a type, RT_NULL while another user is building them */
+static const rt_uint32_t (*crc_table_get(rt_crc_type_t type))[256]
+{
+    rt_atomic_t state = CRC_TABLE_EMPTY;
+
+    if (rt_atomic_load(&crc_table_state[type]) != CRC_TABLE_READY)
+    {
+        /* built once on the first use without locking out the scheduler, the users
+         * coming meanwhile go bit by bit */
+        if (!rt_atomic_compare_exchange_strong(&crc_table_state[type], &state, CRC_TABLE_BUILDING))
+        {
+            return RT_NULL;
+        }
+        crc_table_build(type);
+        rt_atomic_store(&crc_table_state[type], CRC_TABLE_READY);
+    }
+    return (const rt_uint32_t (*)[256])crc_tables[type];
+}
+
+static rt_uint32_t crc_update_bitwise(rt_crc_type_t type, rt_uint32_t crc, const rt_uint8_t *data, rt_size_t len)
+{
+    rt_uint32_t poly = crc_algos[type].poly;
+    int j;
+
+    while (len--)
+    {
+        crc ^= *data++;
+        for (j = 0; j < 8; j++)
+        {
+            crc = (crc & 0x01) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+/* the reflected CRC of any width up to 32 bits, the register is kept in the low bits */
+static rt_uint32_t crc_update_sw(rt_crc_type_t type, rt_uint32_t crc, const rt_uint8_t *data, rt_size_t len)
+{
+    const rt_uint32_t (*table)[256] = crc_table_get(type);
+
+    if (table == RT_NULL)
+    {
+        return crc_update_bitwise(type, crc, data, len);
+    }
+
+#ifdef RT_CRC_USING_SLICING_BY_8
+    rt_uint32_t high;
+
+    /* byte by byte up to the word alignment, then eight bytes per round */
+    while (len && ((rt_ubase_t)data & 0x03))
+    {
+        crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xFF];
+        len--;
+    }
+    while (len >= 8)
+    {
+        crc ^= (rt_uint32_t)data[0] | ((rt_uint32_t)data[1] << 8) |
+               ((rt_uint32_t)data[2] << 16) | ((rt_uint32_t)data[3] << 24);
+        high = (rt_uint32_t)data[4] | ((rt_uint32_t)data[5] << 8) |
+               ((rt_uint32_t)data[6] << 16) | ((rt_uint32_t)data[7] << 24);
+        crc = table[7][crc & 0xFF] ^ table[6][(crc >> 8) & 0xFF] ^
+              table[5][(crc >> 16) & 0xFF] ^ table[4][crc >> 24] ^
+              table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^
+              table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+        data += 8;
+        len -= 8;
+    }
+#endif /* RT_CRC_USING_SLICING_BY_8 */
+    while (len--)
+    {
+        crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xFF];
+    }
+
+    return crc;
+}
+
+#ifdef RT_CRC_USING_HWCRYPTO
+struct crc_hw
+{
+    struct rt_hwcrypto_ctx *ctx;
+    struct hwcrypto_crc_cfg cfg;
+};
+
+static struct crc_hw crc_hw[RT_CRC_TYPE_MAX];
+static struct rt_mutex crc_hw_lock;
+static rt_bool_t crc_hw_ready = RT_FALSE;
+
+static rt_uint32_t crc_reflect(rt_uint32_t value, rt_uint8_t width)
+{
+    rt_uint32_t result = 0;
+    rt_uint8_t i;
+
+    for (i = 0; i < width; i++)
+    {
+        result = (result << 1) | (value & 0x01);
+        value >>= 1;
+    }
+    return result;
+}
+
+static void crc_hw_create(struct rt_hwcrypto_device *dev, rt_crc_type_t type, rt_uint32_t poly)
+{
+    struct crc_hw *hw = &crc_hw[type];
+
+    hw->ctx = rt_hwcrypto_crc_create(dev, HWCRYPTO_CRC_CUSTOM);
+    if (hw->ctx == RT_NULL)
+    {
+        return;
+    }
+    /* the xorout is applied by rt_crc_final(), the device gets the reflected register */
+    hw->cfg.poly = poly;
+    hw->cfg.width = crc_algos[type].width;
+    hw->cfg.xorout = 0;
+    hw->cfg.flags = CRC_FLAG_REFIN | CRC_FLAG_REFOUT;
+    hw->cfg.last_val = crc_reflect(crc_algos[type].init, hw->cfg.width);
+    rt_hwcrypto_crc_cfg(hw->ctx, &hw->cfg);
+}
+
+static int rt_crc_hw_init(void)
+{
+    struct rt_hwcrypto_device *dev = rt_hwcrypto_dev_default();
+
+    if (dev == RT_NULL)
+    {
+        return 0;
+    }
+    rt_mutex_init(&crc_hw_lock, "crc", RT_IPC_FLAG_PRIO);
+#ifdef RT_HWCRYPTO_USING_CRC_8005
+    crc_hw_create(dev, RT_CRC16_MODBUS, 0x8005);
+#endif
+#ifdef RT_HWCRYPTO_USING_CRC_04C11DB7
+    crc_hw_create(dev, RT_CRC32, 0x04C11DB7);
+#endif
+    crc_hw_ready = RT_TRUE;
+
+    return 0;
+}
+INIT_COMPONENT_EXPORT(rt_crc_hw_init);
+
+static rt_bool_t crc_update_hw(struct rt_crc_ctx *ctx, const rt_uint8_t *data, rt_size_t len)
+{
+    struct crc_hw *hw = &crc_hw[ctx->type];
+    rt_uint32_t mask = crc_algos[ctx->type].width == 32 ? 0xFFFFFFFF : (1UL << crc_algos[ctx->type].width) - 1;
+
+    /* the device is shared behind a mutex, short blocks are faster in software */
+    if (!crc_hw_ready || (hw->ctx == RT_NULL) || (ctx->flags & RT_CRC_FLAG_SOFTWARE) ||
+            (len < RT_CRC_HW_THRESHOLD) || (rt_interrupt_get_nest() != 0))
+    {
+        return RT_FALSE;
+    }
+
+    rt_mutex_take(&crc_hw_lock, RT_WAITING_FOREVER);
+    /* continue from the register of this stream, the device is only reconfigured
+     * when another stream used it in between */
+    hw->cfg.last_val = crc_reflect(ctx->crc, hw->cfg.width);
+    rt_hwcrypto_crc_cfg(hw->ctx, &hw->cfg);
+    ctx->crc = rt_hwcrypto_crc_update(hw->ctx, data, len) & mask;
+    rt_mutex_release(&crc_hw_lock);
+
+    return RT_TRUE;
+}
+#endif /* RT_CRC_USING_HWCRYPTO */
+
+/**
+ * @brief Initialize a CRC context
+ *
+ * @param ctx   the CRC context
+ * @param type  the CRC algorithm
+ */
+void rt_crc_init(struct rt_crc_ctx *ctx, rt_crc_type_t type)
+{
+    RT_ASSERT(ctx != RT_NULL);
+    RT_ASSERT(type < RT_CRC_TYPE_MAX);
+
+    ctx->crc = crc_algos[type].init;
+    ctx->type = type;
+    ctx->flags = 0;
+}
+
+/**
+ * @brief Feed data to a CRC context, the data may be split at any byte
+ *
+ * @param ctx   the CRC context
+ * @param data  the data
+ * @param len   the length of the data
+ */
+void rt_crc_update(struct rt_crc_ctx *ctx, const void *data, rt_size_t len)
+{
+    RT_ASSERT(ctx != RT_NULL);
+
+    if (len == 0)
+    {
+        return;
+    }
+#ifdef RT_CRC_USING_HWCRYPTO
+    if (crc_update_hw(ctx, (const rt_uint8_t *)data, len))
+    {
+        return;
+    }
+#endif
+    ctx->crc = crc_update_sw((rt_crc_type_t)ctx->type, ctx->crc, (const rt_uint8_t *)data, len);
+}
+
+/**
+ * @brief Get the CRC of the data fed so far, the context can still be updated
+ *
+ * @param ctx   the CRC context
+ *
+ * @return the CRC value
+ */
+rt_uint32_t rt_crc_final(struct rt_crc_ctx *ctx)
+{
+    RT_ASSERT(ctx != RT_NULL);
+
+    return ctx->crc ^ crc_algos[ctx->type].xorout;
+}
+
+/**
+ * @brief Calculate the CRC of one buffer
+ *
+ * @param type  the CRC algorithm
+ * @param data  the data
+ * @param len   the length of the data
+ *
+ * @return the CRC value
+ */
+rt_uint32_t rt_crc_calc(rt_crc_type_t type, const void *data, rt_size_t len)
+{
+    struct rt_crc_ctx ctx;
+
+    rt_crc_init(&ctx, type);
+    rt_crc_update(&ctx, data, len);
+    return rt_crc_final(&ctx);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#ifndef __CRC_H__
+#define __CRC_H__
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    RT_CRC16_MODBUS = 0,        /* poly 0x8005 reflected, init 0xFFFF, xorout 0x0000 */
+    RT_CRC32,                   /* poly 0x04C11DB7 reflected, init 0xFFFFFFFF, xorout 0xFFFFFFFF */
+
+    RT_CRC_TYPE_MAX
+} rt_crc_type_t;
+
+#define RT_CRC_FLAG_SOFTWARE    0x01U   /* never use the hardware CRC device */
+
+/* incremental CRC context, every stream has its own */
+struct rt_crc_ctx
+{
+    rt_uint32_t crc;            /* the register of the reflected CRC */
+    rt_uint8_t type;            /* rt_crc_type_t */
+    rt_uint8_t flags;
+};
+
+void rt_crc_init(struct rt_crc_ctx *ctx, rt_crc_type_t type);
+void rt_crc_update(struct rt_crc_ctx *ctx, const void *data, rt_size_t len);
+rt_uint32_t rt_crc_final(struct rt_crc_ctx *ctx);
+
+/* CRC of one buffer */
+rt_uint32_t rt_crc_calc(rt_crc_type_t type, const void *data, rt_size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRC_H__ */
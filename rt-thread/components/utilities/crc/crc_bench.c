@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * CRC throughput benchmark.
+ *
+ * For every polynomial and block size the same buffer is processed by the byte at a time
+ * table CRC the protocols used before, by the software kernel of the CRC service and by
+ * the service with the hardware CRC device when it is present. The results are checked
+ * against each other, the throughput is reported in KB/s.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <crc.h>
+
+#if defined(RT_CRC_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_BUFFER_SIZE       4096
+
+static const struct
+{
+    const char *name;
+    rt_crc_type_t type;
+    rt_uint32_t poly;
+    rt_uint32_t init;
+    rt_uint32_t xorout;
+} bench_algos[] =
+{
+    {"crc16", RT_CRC16_MODBUS, 0xA001, 0xFFFF, 0x0000},
+    {"crc32", RT_CRC32, 0xEDB88320, 0xFFFFFFFF, 0xFFFFFFFF},
+};
+
+static const rt_uint32_t bench_blocks[] = {16, 64, 256, 1024, 4096};
+
+static rt_uint32_t bytewise_table[256];
+
+static void bytewise_build(rt_uint32_t poly)
+{
+    rt_uint32_t c;
+    int i, j;
+
+    for (i = 0; i < 256; i++)
+    {
+        c = i;
+        for (j = 0; j < 8; j++)
+        {
+            c = (c & 0x01) ? (c >> 1) ^ poly : c >> 1;
+        }
+        bytewise_table[i] = c;
+    }
+}
+
+static rt_uint32_t bytewise_crc(rt_uint32_t crc, const rt_uint8_t *data, rt_size_t len)
+{
+    while (len--)
+    {
+        crc = (crc >> 8) ^ bytewise_table[(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+static rt_uint32_t bench_rate(rt_uint32_t bytes, rt_uint32_t clocks)
+{
+    rt_uint32_t us = BENCH_CLOCK_US(clocks);
+
+    return us ? (rt_uint32_t)((rt_uint64_t)bytes * 1000000 / 1024 / us) : 0;
+}
+
+static void crc_bench(int argc, char **argv)
+{
+    rt_uint32_t total = 256 * 1024, block, rounds, i, j, k, n, clocks[3];
+    rt_uint32_t result[3];
+    struct rt_crc_ctx ctx;
+    rt_uint8_t *buf;
+
+    if (argc > 1) total = strtoul(argv[1], RT_NULL, 0) * 1024;
+    if (total == 0)
+    {
+        rt_kprintf("Usage: crc_bench [total_kb]\n");
+        return;
+    }
+    buf = rt_malloc(BENCH_BUFFER_SIZE);
+    if (buf == RT_NULL)
+    {
+        return;
+    }
+    for (i = 0; i < BENCH_BUFFER_SIZE; i++)
+    {
+        buf[i] = rand();
+    }
+
+    rt_kprintf("%d KB per run, KB/s\n", total / 1024);
+    rt_kprintf("poly   block  bytewise   service    hw/auto\n");
+    for (i = 0; i < sizeof(bench_algos) / sizeof(bench_algos[0]); i++)
+    {
+        bytewise_build(bench_algos[i].poly);
+        for (j = 0; j < sizeof(bench_blocks) / sizeof(bench_blocks[0]); j++)
+        {
+            block = bench_blocks[j];
+            rounds = total / block;
+
+            clocks[0] = BENCH_CLOCK();
+            for (n = 0; n < rounds; n++)
+            {
+                result[0] = bytewise_crc(bench_algos[i].init, buf, block) ^ bench_algos[i].xorout;
+            }
+            clocks[0] = BENCH_CLOCK() - clocks[0];
+
+            /* the software kernel and the automatic choice of the service */
+            for (k = 1; k < 3; k++)
+            {
+                clocks[k] = BENCH_CLOCK();
+                for (n = 0; n < rounds; n++)
+                {
+                    rt_crc_init(&ctx, bench_algos[i].type);
+                    if (k == 1)
+                    {
+                        ctx.flags |= RT_CRC_FLAG_SOFTWARE;
+                    }
+                    rt_crc_update(&ctx, buf, block);
+                    result[k] = rt_crc_final(&ctx);
+                }
+                clocks[k] = BENCH_CLOCK() - clocks[k];
+            }
+
+            rt_kprintf("%-6s %5d %9d %9d %9d%s\n", bench_algos[i].name, block,
+                       bench_rate(rounds * block, clocks[0]), bench_rate(rounds * block, clocks[1]),
+                       bench_rate(rounds * block, clocks[2]),
+                       (result[0] != result[1] || result[0] != result[2]) ? "  mismatch" : "");
+        }
+    }
+
+    rt_free(buf);
+}
+MSH_CMD_EXPORT(crc_bench, CRC throughput per polynomial and block size);
+
+#ifdef RT_USING_UTEST
+#include <utest.h>
+
+static void test_crc_check(void)
+{
+    /* the check values of the CRC catalogue, the CRC of "123456789" */
+    uassert_int_equal(rt_crc_calc(RT_CRC16_MODBUS, "123456789", 9), 0x4B37);
+    uassert_int_equal(rt_crc_calc(RT_CRC32, "123456789", 9), 0xCBF43926);
+}
+
+static void test_crc_split(void)
+{
+    rt_uint8_t buf[BENCH_BUFFER_SIZE / 8 + 1];
+    rt_uint32_t expect, i, split, soft;
+    struct rt_crc_ctx ctx;
+
+    for (i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = rand();
+    }
+    /* an unaligned stream split at any byte, by the software kernel and the automatic choice */
+    for (i = 0; i < sizeof(bench_algos) / sizeof(bench_algos[0]); i++)
+    {
+        bytewise_build(bench_algos[i].poly);
+        expect = bytewise_crc(bench_algos[i].init, buf + 1, sizeof(buf) - 1) ^ bench_algos[i].xorout;
+        for (soft = 0; soft < 2; soft++)
+        {
+            for (split = 0; split < sizeof(buf) - 1; split += 13)
+            {
+                rt_crc_init(&ctx, bench_algos[i].type);
+                if (soft)
+                {
+                    ctx.flags |= RT_CRC_FLAG_SOFTWARE;
+                }
+                rt_crc_update(&ctx, buf + 1, split);
+                rt_crc_update(&ctx, buf + 1 + split, sizeof(buf) - 1 - split);
+                uassert_int_equal(rt_crc_final(&ctx), expect);
+            }
+        }
+    }
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_crc_check);
+    UTEST_UNIT_RUN(test_crc_split);
+}
+UTEST_TC_EXPORT(testcase, "components.utilities.crc.crc_bench", RT_NULL, RT_NULL, 10);
+#endif /* RT_USING_UTEST */
+
+#endif /* defined(RT_CRC_USING_BENCH) && defined(RT_USING_FINSH) */
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2021-02-02     xiangxistu   the first version
  * 2021-03-19     Sherman      Streamline the struct rt_link_session
+ * 2026-10-18     RT-Thread    add sliding window transport
  */
 
 #ifndef __RT_LINK_H__
@@ -23,11 +24,23 @@
 
 #define RT_LINK_FRAME_HEAD          0x15U
 #define RT_LINK_FRAME_HEAD_MASK     0x1FU
+#ifdef RT_LINK_USING_WINDOW
+/* The maximum number of split frames for a long package, at most 32 frames
+and 65535 bytes (the long package length is sent in the extend parameter) */
+#define RT_LINK_FRAMES_MAX          RT_LINK_WINDOW_FRAMES_MAX
+/* The length in the rt_link_frame_head structure occupies 11 bits,
+so the value range after 4-byte alignment is 0-2044.*/
+#define RT_LINK_MAX_FRAME_LENGTH    RT_LINK_WINDOW_FRAME_LENGTH
+/* The frames on the link are limited by the window, and so is the receive buffer */
+#define RT_LINK_RECEIVE_FRAMES      RT_LINK_WINDOW_SIZE
+#else
 /* The maximum number of split frames for a long package */
 #define RT_LINK_FRAMES_MAX          0x03U
 /* The length in the rt_link_frame_head structure occupies 11 bits,
 so the value range after 4-byte alignment is 0-2044.*/
 #define RT_LINK_MAX_FRAME_LENGTH    1024U
+#define RT_LINK_RECEIVE_FRAMES      RT_LINK_FRAMES_MAX
+#endif /* RT_LINK_USING_WINDOW */
 
 #define RT_LINK_ACK_MAX             0x07U
 #define RT_LINK_CRC_LENGTH          4U
@@ -39,7 +52,7 @@ so the value range after 4-byte alignment is 0-2044.*/
                                         RT_LINK_EXTEND_LENGTH - \
                                         RT_LINK_CRC_LENGTH)
 #define RT_LINK_RECEIVE_BUFFER_LENGTH   (RT_LINK_MAX_FRAME_LENGTH * \
-                                        RT_LINK_FRAMES_MAX + \
+                                        RT_LINK_RECEIVE_FRAMES + \
                                         RT_LINK_HEAD_LENGTH + \
                                         RT_LINK_EXTEND_LENGTH)
 
@@ -132,7 +145,7 @@ struct rt_link_record
 {
     rt_uint8_t rx_seq;      /* record the opposite sequence */
     rt_uint8_t total;       /* the number of long frame number */
-    rt_uint8_t long_count;  /* long packet recv counter */
+    rt_uint32_t long_count; /* long packet recv counter */
     rt_uint8_t *dataspace;  /* the space of long frame */
 };
 
@@ -7,12 +7,16 @@
  * Date           Author       Notes
  * 2021-02-02     xiangxistu   the first version
  * 2021-07-13     Sherman      add reconnect API
+ * 2026-10-18     RT-Thread    add scatter-gather send
+ * 2026-10-18     RT-Thread    keep the running crc in the caller
  *
  */
 #ifndef __RT_LINK_HW_H__
 #define __RT_LINK_HW_H__
 
 #include <rtdef.h>
+#include <rtlink_port.h>
+#include <rtlink_utils.h>
 
 rt_size_t rt_link_hw_recv_len(struct rt_link_receive_buffer *buffer);
 void rt_link_hw_copy(rt_uint8_t *dst, rt_uint8_t *src, rt_size_t count);
@@ -22,5 +26,9 @@ rt_err_t rt_link_hw_init(void);
 rt_err_t rt_link_hw_deinit(void);
 rt_err_t rt_link_hw_reconnect(void);
 rt_size_t rt_link_hw_send(void *data, rt_size_t length);
+rt_size_t rt_link_hw_sendv(const struct rt_link_iovec *iov, rt_size_t iovcnt);
+
+rt_err_t rt_link_reset_crc32(rt_link_crc_ctx_t *ctx);
+rt_uint32_t rt_link_crc32(rt_link_crc_ctx_t *ctx, rt_uint8_t *data, rt_size_t u32_size);
 
 #endif /* _RT_LINK_PORT_INTERNAL_H_ */
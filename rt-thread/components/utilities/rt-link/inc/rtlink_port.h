@@ -8,23 +8,33 @@
  * 2021-02-02     xiangxistu   the first version
  * 2021-05-15     Sherman      function rename
  * 2021-07-13     Sherman      add reconnect API
+ * 2026-10-18     RT-Thread    add scatter-gather send
  */
 #ifndef __RT_LINK_PORT_H__
 #define __RT_LINK_PORT_H__
 
 #include <rtdef.h>
 
+struct rt_link_iovec
+{
+    void *base;
+    rt_size_t len;
+};
+
 /* Functions that need to be implemented at the hardware */
 rt_err_t rt_link_port_init(void);
 rt_err_t rt_link_port_deinit(void);
 rt_err_t rt_link_port_reconnect(void);
 rt_size_t rt_link_port_send(void *data, rt_size_t length);
+/* Optional, send one frame from several buffers. The default sends each buffer with
+ * rt_link_port_send(), the ports which need a frame in one transfer have to implement it */
+rt_size_t rt_link_port_sendv(const struct rt_link_iovec *iov, rt_size_t iovcnt);
 
 #ifdef RT_LINK_USING_HW_CRC
     rt_err_t rt_link_hw_crc32_init(void);
     rt_err_t rt_link_hw_crc32_deinit(void);
     rt_err_t rt_link_hw_crc32_reset(void);
-    rt_uint32_t rt_link_hw_crc32(rt_uint8_t *data, rt_size_t u32_size)
+    rt_uint32_t rt_link_hw_crc32(rt_uint8_t *data, rt_size_t u32_size);
 #endif
 
 /* Called when the hardware receives data and the data is transferred to RTLink */
@@ -6,16 +6,30 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-05-15     Sherman      the first version
+ * 2026-10-18     RT-Thread    use the CRC service for the software crc
+ * 2026-10-18     RT-Thread    keep the running crc in the caller
  */
 #ifndef __RT_LINK_UTILITIES_H__
 #define __RT_LINK_UTILITIES_H__
 
 #include <rtthread.h>
+#ifdef RT_LINK_USING_SF_CRC
+#include <crc.h>
+#endif
+
+/* the running CRC of a frame, kept by the caller so that frames can be checked at once */
+#ifdef RT_LINK_USING_SF_CRC
+typedef struct rt_crc_ctx rt_link_crc_ctx_t;
+#else
+typedef rt_uint32_t rt_link_crc_ctx_t; /* the hardware CRC device keeps its own register */
+#endif
 
 /* Calculate the number of '1' */
 int rt_link_utils_num1(rt_uint32_t n);
 
-rt_err_t rt_link_sf_crc32_reset(void);
-rt_uint32_t rt_link_sf_crc32(rt_uint8_t *data, rt_size_t len);
+#ifdef RT_LINK_USING_SF_CRC
+rt_err_t rt_link_sf_crc32_reset(rt_link_crc_ctx_t *ctx);
+rt_uint32_t rt_link_sf_crc32(rt_link_crc_ctx_t *ctx, rt_uint8_t *data, rt_size_t len);
+#endif
 
 #endif /* __RT_LINK_UTILITIES_H__ */
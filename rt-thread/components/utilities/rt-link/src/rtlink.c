@@ -13,6 +13,8 @@
  *                             Fix known bugs
  * 2021-08-06     Sherman      Add NACK, NCRC, non-blocking transmit mode;
  *                             Add service connection status;
+ * 2026-10-18     RT-Thread    Add sliding window transport with selective ack;
+ *                             Send frames without the staging copy
  */
 
 #include <rtthread.h>
@@ -52,6 +54,13 @@
 
 #define RT_LINK_FRAME_SENT      1
 #define RT_LINK_FRAME_NOSEND    0
+#ifdef RT_LINK_USING_WINDOW
+#define RT_LINK_FRAME_ACKED     2
+#define RT_LINK_FRAME_RESENT    3
+
+/* the receiver confirms after every half window of frames received in order */
+#define RT_LINK_WINDOW_ACK_INTERVAL     ((RT_LINK_WINDOW_SIZE + 1) / 2)
+#endif /* RT_LINK_USING_WINDOW */
 
 typedef enum
 {
@@ -210,45 +219,46 @@ static void rt_link_service_send_finish(rt_link_err_e err)
 
 static rt_ssize_t frame_send(struct rt_link_frame *frame)
 {
+    struct rt_link_iovec iov[4];
+    rt_size_t iovcnt = 0;
     rt_size_t length = 0;
-    rt_uint8_t *data = RT_NULL;
 
-    rt_memset(rt_link_scb->sendbuffer, 0, sizeof(rt_link_scb->sendbuffer));
-    data = rt_link_scb->sendbuffer;
-    length = RT_LINK_HEAD_LENGTH;
-    if (frame->head.crc)
-    {
-        length += RT_LINK_CRC_LENGTH;
-    }
-    if (frame->head.extend)
-    {
-        length += RT_LINK_EXTEND_LENGTH;
-    }
-
-    length += frame->data_len;
+    /* The frame is sent from the head, extend, data and crc where they are,
+     * they stay valid until the frame is removed from the sending list */
     frame->head.length = frame->data_len;
-    rt_memcpy(data, &frame->head, RT_LINK_HEAD_LENGTH);
-    data = data + RT_LINK_HEAD_LENGTH;
+    iov[iovcnt].base = &frame->head;
+    iov[iovcnt++].len = RT_LINK_HEAD_LENGTH;
     if (frame->head.extend)
     {
-        rt_memcpy(data, &frame->extend, RT_LINK_EXTEND_LENGTH);
-        data = data + RT_LINK_EXTEND_LENGTH;
+        iov[iovcnt].base = &frame->extend;
+        iov[iovcnt++].len = RT_LINK_EXTEND_LENGTH;
     }
-    if (frame->attribute == RT_LINK_SHORT_DATA_FRAME || frame->attribute == RT_LINK_LONG_DATA_FRAME)
+    if ((frame->attribute == RT_LINK_SHORT_DATA_FRAME || frame->attribute == RT_LINK_LONG_DATA_FRAME)
+            && frame->data_len)
     {
-        rt_memcpy(data, frame->real_data, frame->data_len);
-        data = data + frame->data_len;
+        iov[iovcnt].base = frame->real_data;
+        iov[iovcnt++].len = frame->data_len;
     }
     if (frame->head.crc)
     {
-        frame->crc = rt_link_scb->calculate_crc(RT_FALSE, rt_link_scb->sendbuffer, length - RT_LINK_CRC_LENGTH);
-        rt_memcpy(data, &frame->crc, RT_LINK_CRC_LENGTH);
+        rt_link_crc_ctx_t ctx;
+        rt_size_t i;
+
+        rt_link_reset_crc32(&ctx);
+        for (i = 0; i < iovcnt; i++)
+        {
+            frame->crc = rt_link_crc32(&ctx, iov[i].base, iov[i].len);
+        }
+        iov[iovcnt].base = &frame->crc;
+        iov[iovcnt++].len = RT_LINK_CRC_LENGTH;
     }
 
-    LOG_D("frame send seq(%d) len(%d) attr:(%d), crc:(0x%08x).", frame->head.sequence, length, frame->attribute, frame->crc);
-    return rt_link_hw_send(rt_link_scb->sendbuffer, length);
+    LOG_D("frame send seq(%d) len(%d) attr:(%d), crc:(0x%08x).", frame->head.sequence, frame->data_len, frame->attribute, frame->crc);
+    length = rt_link_hw_sendv(iov, iovcnt);
+    return length;
 }
 
+#ifndef RT_LINK_USING_WINDOW
 /* performs data transmission */
 static rt_err_t rt_link_frame_send(rt_slist_t *slist)
 {
@@ -310,6 +320,173 @@ static rt_err_t rt_link_frame_send(rt_slist_t *slist)
 __err:
     return -RT_ERROR;
 }
+#else
+/* Send the frames of the first package on the sending list which are inside the window,
+ * the window starts at the first frame which is not acknowledged yet */
+static rt_err_t rt_link_window_send(rt_bool_t resend)
+{
+    struct rt_link_frame *frame = RT_NULL;
+    rt_slist_t *slist = rt_slist_first(&rt_link_scb->tx_data_slist);
+    rt_uint8_t index = 0, limit = 0, total = 0, ack = 0;
+
+    if (slist == RT_NULL)
+    {
+        LOG_W("send data list NULL");
+        return -RT_ERROR;
+    }
+    frame = rt_container_of(slist, struct rt_link_frame, slist);
+    total = frame->total;
+    ack = frame->head.ack;
+
+    while ((slist != RT_NULL) && (index < total))
+    {
+        frame = rt_container_of(slist, struct rt_link_frame, slist);
+        if (frame->issent != RT_LINK_FRAME_ACKED)
+        {
+            break;
+        }
+        slist = rt_slist_next(slist);
+        index++;
+    }
+
+    /* NACK frames are never acknowledged, they are sent without the window */
+    limit = ack ? index + RT_LINK_WINDOW_SIZE : total;
+    for (; (slist != RT_NULL) && (index < total) && (index < limit); index++)
+    {
+        frame = rt_container_of(slist, struct rt_link_frame, slist);
+        slist = rt_slist_next(slist);
+        if ((frame->issent == RT_LINK_FRAME_NOSEND) ||
+                (resend && (frame->issent != RT_LINK_FRAME_ACKED)))
+        {
+            if (frame_send(frame) == 0)
+            {
+                rt_link_scb->service[frame->head.service]->err = RT_LINK_EIO;
+                return -RT_ERROR;
+            }
+            frame->issent = (frame->issent == RT_LINK_FRAME_NOSEND) ? RT_LINK_FRAME_SENT : RT_LINK_FRAME_RESENT;
+        }
+    }
+
+    if (ack == 0)
+    {
+        /* NACK frame send finish, remove after sending */
+        rt_link_service_send_finish(RT_LINK_EOK);
+        if (rt_slist_first(&rt_link_scb->tx_data_slist) != RT_NULL)
+        {
+            LOG_D("Continue sending");
+            rt_event_send(&rt_link_scb->event, RT_LINK_SEND_READY_EVENT);
+        }
+    }
+    else
+    {
+        rt_int32_t timeout = RT_LINK_SENT_FRAME_TIMEOUT;
+        rt_timer_control(&rt_link_scb->sendtimer, RT_TIMER_CTRL_SET_TIME, &timeout);
+        rt_timer_start(&rt_link_scb->sendtimer);
+    }
+    return RT_EOK;
+}
+
+/* The confirm sequence acknowledges the frames up to it, the bit n of the parameter
+ * acknowledges the frame n + 1 after it */
+static void rt_link_window_confirm(struct rt_link_frame *receive_frame)
+{
+    struct rt_link_frame *frame = RT_NULL;
+    rt_slist_t *slist = rt_slist_first(&rt_link_scb->tx_data_slist);
+    rt_uint16_t sack = receive_frame->extend.parameter;
+    rt_uint8_t acked = 0, highest = 0, index = 0, total = 0;
+    rt_bool_t progress = RT_FALSE;
+
+    if (slist == RT_NULL)
+    {
+        return;
+    }
+    frame = rt_container_of(slist, struct rt_link_frame, slist);
+    total = frame->total;
+    acked = rt_link_check_seq(receive_frame->head.sequence + 1, frame->head.sequence);
+    if (acked > total)
+    {
+        LOG_D("confirm seq(%d) out of window", receive_frame->head.sequence);
+        return;
+    }
+    if (acked == total)
+    {
+        rt_link_service_send_finish(RT_LINK_EOK);
+        if (rt_slist_first(&rt_link_scb->tx_data_slist) != RT_NULL)
+        {
+            LOG_D("Continue sending");
+            rt_event_send(&rt_link_scb->event, RT_LINK_SEND_READY_EVENT);
+        }
+        return;
+    }
+
+    for (index = 0; (slist != RT_NULL) && (index < total); index++)
+    {
+        frame = rt_container_of(slist, struct rt_link_frame, slist);
+        slist = rt_slist_next(slist);
+        if ((index < acked) ||
+                ((index > acked) && (index - acked - 1 < 16) && ((sack >> (index - acked - 1)) & 0x01)))
+        {
+            if (frame->issent != RT_LINK_FRAME_ACKED)
+            {
+                frame->issent = RT_LINK_FRAME_ACKED;
+                progress = RT_TRUE;
+            }
+            highest = index;
+        }
+    }
+    if (progress)
+    {
+        rt_link_scb->sendtimer.parameter = 0;
+    }
+
+    /* The link keeps the frame order, a frame missing below an acknowledged one
+     * is lost, resend it once without waiting for the timeout */
+    slist = rt_slist_first(&rt_link_scb->tx_data_slist);
+    for (index = 0; (slist != RT_NULL) && (index < highest); index++)
+    {
+        frame = rt_container_of(slist, struct rt_link_frame, slist);
+        slist = rt_slist_next(slist);
+        if (frame->issent == RT_LINK_FRAME_SENT)
+        {
+            LOG_D("fast resend frame(%d)", frame->head.sequence);
+            frame_send(frame);
+            frame->issent = RT_LINK_FRAME_RESENT;
+        }
+    }
+
+    if (rt_link_window_send(RT_FALSE) != RT_EOK)
+    {
+        rt_link_scb->state = RT_LINK_DISCONN;
+        rt_link_service_send_finish(RT_LINK_EIO);
+    }
+}
+
+/* Confirm the frames received in order and report the ones received after a gap */
+static void rt_link_window_ack(struct rt_link_frame *receive_frame, rt_bool_t duplicate)
+{
+    rt_uint32_t count = rt_link_scb->rx_record.long_count;
+    rt_uint8_t total = rt_link_scb->rx_record.total;
+    rt_uint8_t contiguous = 0;
+    rt_uint16_t sack = 0;
+
+    while ((contiguous < total) && ((count >> contiguous) & 0x01))
+    {
+        contiguous++;
+    }
+    if (contiguous + 1 < 32)
+    {
+        sack = (rt_uint16_t)(count >> (contiguous + 1));
+    }
+
+    if ((contiguous == total) || duplicate || (rt_link_utils_num1(count) != contiguous) ||
+            (contiguous % RT_LINK_WINDOW_ACK_INTERVAL == 0))
+    {
+        rt_link_command_frame_send(receive_frame->head.service,
+                                   (rt_link_scb->rx_record.rx_seq + contiguous),
+                                   RT_LINK_CONFIRM_FRAME, sack);
+    }
+}
+#endif /* RT_LINK_USING_WINDOW */
 
 static void _stop_recv_long(void)
 {
@@ -350,6 +527,14 @@ static rt_err_t rt_link_resend_handle(struct rt_link_frame *receive_frame)
         find_frame = rt_container_of(tem_list, struct rt_link_frame, slist);
         if (find_frame->head.sequence == receive_frame->head.sequence)
         {
+#ifdef RT_LINK_USING_WINDOW
+            /* the frames outside the window are sent when the window moves */
+            if (find_frame->issent == RT_LINK_FRAME_NOSEND)
+            {
+                break;
+            }
+            find_frame->issent = RT_LINK_FRAME_RESENT;
+#endif
             LOG_D("resend frame(%d)", find_frame->head.sequence);
             frame_send(find_frame);
             break;
@@ -392,6 +577,11 @@ static rt_err_t rt_link_confirm_handle(struct rt_link_frame *receive_frame)
         return RT_EOK;
     }
 
+#ifdef RT_LINK_USING_WINDOW
+    rt_link_window_confirm(receive_frame);
+    return RT_EOK;
+#endif
+
     /* Check to see if the frame is send for confirm */
     tem_list = rt_slist_first(&rt_link_scb->tx_data_slist);
     if (tem_list == RT_NULL)
@@ -481,7 +671,9 @@ static void _long_handle_first(struct rt_link_frame *receive_frame)
 
 static void _long_handle_second(struct rt_link_frame *receive_frame)
 {
+#ifndef RT_LINK_USING_WINDOW
     static rt_uint8_t ack_mask = RT_LINK_ACK_MAX;
+#endif
     rt_size_t offset = 0; /* offset, count from 0 */
 
     receive_frame->index = rt_link_check_seq(receive_frame->head.sequence, rt_link_scb->rx_record.rx_seq) - 1;
@@ -492,18 +684,28 @@ static void _long_handle_second(struct rt_link_frame *receive_frame)
           , receive_frame->total
           , rt_link_scb->rx_record.long_count);
 
-    if ((receive_frame->index > RT_LINK_FRAMES_MAX) || (rt_link_scb->rx_record.long_count & (0x01 << receive_frame->index)))
+    if ((receive_frame->index >= RT_LINK_FRAMES_MAX) || (rt_link_scb->rx_record.long_count & (1UL << receive_frame->index)))
     {
         LOG_D("ERR:index %d, rx_seq %d", receive_frame->index, rt_link_scb->rx_record.rx_seq);
+#ifdef RT_LINK_USING_WINDOW
+        /* the confirm of a repeated frame is lost, send it again */
+        if ((receive_frame->index < rt_link_scb->rx_record.total) && receive_frame->head.ack)
+        {
+            rt_link_window_ack(receive_frame, RT_TRUE);
+        }
+#endif
     }
     else if (rt_link_scb->rx_record.dataspace != RT_NULL)
     {
-        rt_link_scb->rx_record.long_count |= (0x01 << receive_frame->index);
+        rt_link_scb->rx_record.long_count |= (1UL << receive_frame->index);
         offset = RT_LINK_MAX_DATA_LENGTH * receive_frame->index;
         rt_link_hw_copy(rt_link_scb->rx_record.dataspace + offset, receive_frame->real_data, receive_frame->data_len);
 
         if (receive_frame->head.ack)
         {
+#ifdef RT_LINK_USING_WINDOW
+            rt_link_window_ack(receive_frame, RT_FALSE);
+#else
             if (rt_link_utils_num1(rt_link_scb->rx_record.long_count) == rt_link_scb->rx_record.total)
             {
                 rt_link_command_frame_send(receive_frame->head.service,
@@ -517,6 +719,7 @@ static void _long_handle_second(struct rt_link_frame *receive_frame)
                                            RT_LINK_CONFIRM_FRAME, RT_NULL);
                 ack_mask |= ack_mask << rt_link_utils_num1(RT_LINK_ACK_MAX);
             }
+#endif /* RT_LINK_USING_WINDOW */
         }
 
         /* receive a complete package */
@@ -531,7 +734,9 @@ static void _long_handle_second(struct rt_link_frame *receive_frame)
             rt_link_scb->rx_record.dataspace = RT_NULL;
             rt_link_scb->rx_record.long_count = 0;
             rt_link_scb->rx_record.total = 0;
+#ifndef RT_LINK_USING_WINDOW
             ack_mask = RT_LINK_ACK_MAX;
+#endif
             rt_exit_critical();
         }
         else if (rt_link_hw_recv_len(rt_link_scb->rx_buffer) < (receive_frame->data_len % RT_LINK_MAX_DATA_LENGTH))
@@ -751,6 +956,13 @@ static void rt_link_frame_check(void)
                 if (rt_slist_first(&rt_link_scb->tx_data_slist) != RT_NULL)
                 {
                     send_frame = rt_container_of(rt_link_scb->tx_data_slist.next, struct rt_link_frame, slist);
+#ifdef RT_LINK_USING_WINDOW
+                    /* the window confirms and resends any frame of the package */
+                    if (rt_link_check_seq(receive_frame.head.sequence + 1, send_frame->head.sequence) <= send_frame->total)
+                    {
+                        offset = 0;
+                    }
+#endif
                     if (offset > send_frame->total)
                     {
                         /* exceptional frame, ignore it */
@@ -765,6 +977,18 @@ static void rt_link_frame_check(void)
             case RT_LINK_SHORT_DATA_FRAME:
             case RT_LINK_SESSION_END:
             {
+#ifdef RT_LINK_USING_WINDOW
+                /* The package is received and its last confirm is lost, confirm it again */
+                if ((receive_frame.attribute != RT_LINK_SESSION_END) && receive_frame.head.ack &&
+                        (rt_link_check_seq(rt_link_scb->rx_record.rx_seq, receive_frame.head.sequence) < RT_LINK_FRAMES_MAX))
+                {
+                    LOG_D("seq (%d) received, rx_seq (%d)", receive_frame.head.sequence, rt_link_scb->rx_record.rx_seq);
+                    rt_link_command_frame_send(receive_frame.head.service, rt_link_scb->rx_record.rx_seq,
+                                               RT_LINK_CONFIRM_FRAME, RT_NULL);
+                    rt_link_hw_buffer_point_shift(&rt_link_scb->rx_buffer->read_point, 1);
+                    goto __find_head;
+                }
+#endif
                 /* Check the receive sequence */
                 offset = rt_link_check_seq(receive_frame.head.sequence, rt_link_scb->rx_record.rx_seq) - 1;
                 if (offset > RT_LINK_FRAMES_MAX)
@@ -888,7 +1112,11 @@ static void rt_link_send_ready(void)
         /* Avoid sending the first data frame multiple times */
         if ((frame != RT_NULL) && (frame->issent == RT_LINK_FRAME_NOSEND))
         {
+#ifdef RT_LINK_USING_WINDOW
+            if (RT_EOK != rt_link_window_send(RT_FALSE))
+#else
             if (RT_EOK != rt_link_frame_send(&rt_link_scb->tx_data_slist))
+#endif
             {
                 rt_link_scb->state = RT_LINK_DISCONN;
                 rt_link_service_send_finish(RT_LINK_EIO);
@@ -913,6 +1141,17 @@ static void rt_link_send_timeout(void)
         rt_link_scb->sendtimer.parameter = 0x00;
         rt_link_service_send_finish(RT_LINK_ETIMEOUT);
     }
+#ifdef RT_LINK_USING_WINDOW
+    else if ((rt_link_scb->state == RT_LINK_CONNECT) && rt_slist_next(&rt_link_scb->tx_data_slist))
+    {
+        /* resend the unacknowledged frames of the window */
+        if (rt_link_window_send(RT_TRUE) != RT_EOK)
+        {
+            rt_link_scb->state = RT_LINK_DISCONN;
+            rt_link_service_send_finish(RT_LINK_EIO);
+        }
+    }
+#endif
     else
     {
         if (rt_slist_next(&rt_link_scb->tx_data_slist))
@@ -1039,6 +1278,13 @@ rt_size_t rt_link_send(struct rt_link_service *service, const void *data, rt_siz
         goto __exit;
     }
 
+    /* the length of a long package is sent in the 16 bits extend parameter */
+    if ((size > 0xFFFF) || (size > RT_LINK_FRAMES_MAX * RT_LINK_MAX_DATA_LENGTH))
+    {
+        service->err = RT_LINK_ENOMEM;
+        goto __exit;
+    }
+
     service->err = RT_LINK_EOK;
     if (size % RT_LINK_MAX_DATA_LENGTH == 0)
     {
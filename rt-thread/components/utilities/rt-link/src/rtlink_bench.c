@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * RT-Link throughput benchmark on a simulated serial link.
+ *
+ * The rt_link_port functions put the frames into a link FIFO, a delivery thread moves
+ * baud / 10 bytes per second from the FIFO into rt_link_hw_write_cb(), so the session
+ * receives what it sends. The given percentage of frames is corrupted on the link. A
+ * sender transmits the packages with ACK and CRC, the throughput, the latency from
+ * rt_link_send() to the receive callback and the frames on the link are reported,
+ * build with and without RT_LINK_USING_WINDOW to compare.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#include <rtlink.h>
+#include <rtlink_hw.h>
+#include <rtlink_port.h>
+
+#if defined(RT_LINK_USING_BENCH) && defined(RT_USING_FINSH)
+
+#define LINK_FIFO_SIZE          (RT_LINK_RECEIVE_BUFFER_LENGTH * 2)
+#define LINK_CHUNK_SIZE         256
+#define LINK_SEND_WAIT          100     /* ticks to wait for the FIFO space before the bytes are lost */
+
+struct link_sim
+{
+    struct rt_ringbuffer fifo;
+    rt_uint8_t pool[LINK_FIFO_SIZE];
+    rt_uint32_t bytes_per_tick;
+    rt_uint32_t loss_pct;
+    volatile rt_bool_t running;
+    rt_thread_t thread;
+
+    rt_uint32_t frames;
+    rt_uint32_t corrupted;
+    rt_uint32_t dropped;                /* bytes lost by a full FIFO or receive buffer */
+};
+
+struct bench_stat
+{
+    rt_uint32_t received;
+    rt_uint32_t errors;
+    rt_uint32_t expect;
+    rt_tick_t send_tick;
+    rt_tick_t latency_max;
+    rt_uint64_t latency_total;
+};
+
+static struct link_sim sim;
+static struct bench_stat result;
+static struct rt_semaphore recv_sem;
+
+static void link_deliver_entry(void *parameter)
+{
+    rt_uint8_t chunk[LINK_CHUNK_SIZE];
+    rt_uint32_t budget, size, accepted;
+
+    while (sim.running)
+    {
+        budget = sim.bytes_per_tick;
+        while (budget > 0)
+        {
+            size = budget > sizeof(chunk) ? sizeof(chunk) : budget;
+            rt_enter_critical();
+            size = rt_ringbuffer_get(&sim.fifo, chunk, size);
+            rt_exit_critical();
+            if (size == 0)
+            {
+                break;
+            }
+            /* no flow control, the bytes the receive buffer can't take are lost */
+            accepted = rt_link_hw_write_cb(chunk, size);
+            sim.dropped += size - accepted;
+            budget -= size;
+        }
+        rt_thread_delay(1);
+    }
+}
+
+static rt_size_t link_put(const rt_uint8_t *data, rt_size_t length, rt_size_t corrupt)
+{
+    rt_uint32_t wait = 0;
+    rt_size_t i;
+
+    while (rt_ringbuffer_space_len(&sim.fifo) < length)
+    {
+        if (++wait > LINK_SEND_WAIT)
+        {
+            sim.dropped += length;
+            return length;
+        }
+        rt_thread_delay(1);
+    }
+
+    rt_enter_critical();
+    if (corrupt < length)
+    {
+        for (i = 0; i < length; i++)
+        {
+            rt_ringbuffer_putchar(&sim.fifo, i == corrupt ? data[i] ^ 0x5A : data[i]);
+        }
+    }
+    else
+    {
+        rt_ringbuffer_put(&sim.fifo, data, length);
+    }
+    rt_exit_critical();
+
+    return length;
+}
+
+/* the byte to corrupt in a frame of the given length, or the length to keep it */
+static rt_size_t link_corrupt_pos(rt_size_t length)
+{
+    sim.frames++;
+    if ((rt_uint32_t)(rand() % 100) < sim.loss_pct)
+    {
+        sim.corrupted++;
+        return rand() % length;
+    }
+    return length;
+}
+
+rt_err_t rt_link_port_init(void)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_link_port_deinit(void)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_link_port_reconnect(void)
+{
+    return RT_EOK;
+}
+
+rt_size_t rt_link_port_send(void *data, rt_size_t length)
+{
+    return link_put(data, length, link_corrupt_pos(length));
+}
+
+rt_size_t rt_link_port_sendv(const struct rt_link_iovec *iov, rt_size_t iovcnt)
+{
+    rt_size_t length = 0, corrupt, i;
+
+    for (i = 0; i < iovcnt; i++)
+    {
+        length += iov[i].len;
+    }
+    corrupt = link_corrupt_pos(length);
+    for (i = 0; i < iovcnt; i++)
+    {
+        link_put(iov[i].base, iov[i].len, corrupt);
+        /* the position is counted from the next segment, or out of the frame once it is done */
+        corrupt = corrupt >= iov[i].len ? corrupt - iov[i].len : length;
+    }
+
+    return length;
+}
+
+static void bench_recv_cb(struct rt_link_service *service, void *data, rt_size_t size)
+{
+    rt_uint8_t *buf = (rt_uint8_t *)data;
+    rt_tick_t latency = rt_tick_get() - result.send_tick;
+    rt_size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        if (buf[i] != (rt_uint8_t)(i + result.expect))
+        {
+            result.errors++;
+            break;
+        }
+    }
+    result.expect++;
+    result.received++;
+    result.latency_total += latency;
+    if (latency > result.latency_max)
+    {
+        result.latency_max = latency;
+    }
+    rt_free(data);
+    rt_sem_release(&recv_sem);
+}
+
+static struct rt_link_service bench_service =
+{
+    .timeout_tx = RT_WAITING_FOREVER,
+    .recv_cb = bench_recv_cb,
+    .flag = RT_LINK_FLAG_ACK | RT_LINK_FLAG_CRC,
+    .service = RT_LINK_SERVICE_MNGT,
+};
+
+static void rtlink_bench(int argc, char **argv)
+{
+    rt_uint32_t size = RT_LINK_FRAMES_MAX * RT_LINK_MAX_DATA_LENGTH;
+    rt_uint32_t count = 20, baud = 921600, sent = 0, i, j;
+    rt_uint8_t *buf;
+    rt_tick_t start, ticks;
+
+    if (size > 0xFFFF)
+    {
+        size = 0xFFFF;
+    }
+    sim.loss_pct = 0;
+    if (argc > 1) size = strtoul(argv[1], RT_NULL, 0);
+    if (argc > 2) count = strtoul(argv[2], RT_NULL, 0);
+    if (argc > 3) sim.loss_pct = strtoul(argv[3], RT_NULL, 0);
+    if (argc > 4) baud = strtoul(argv[4], RT_NULL, 0);
+    if (size == 0 || count == 0 || sim.loss_pct >= 100 || baud / 10 < RT_TICK_PER_SECOND)
+    {
+        rt_kprintf("Usage: rtlink_bench [msg_bytes] [count] [loss_pct] [baud]\n");
+        return;
+    }
+    if (rt_link_get_scb() == RT_NULL && rt_link_init() != RT_EOK)
+    {
+        rt_kprintf("rt link init failed\n");
+        return;
+    }
+    buf = rt_malloc(size);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("no memory for %d bytes\n", size);
+        return;
+    }
+
+    rt_ringbuffer_init(&sim.fifo, sim.pool, sizeof(sim.pool));
+    sim.bytes_per_tick = baud / 10 / RT_TICK_PER_SECOND;
+    sim.frames = sim.corrupted = sim.dropped = 0;
+    sim.running = RT_TRUE;
+    sim.thread = rt_thread_create("linksim", link_deliver_entry, RT_NULL, 1024 + LINK_CHUNK_SIZE,
+                                  RT_THREAD_PRIORITY_MAX / 2 - 2, 10);
+    if (sim.thread == RT_NULL)
+    {
+        rt_free(buf);
+        return;
+    }
+    rt_thread_startup(sim.thread);
+    rt_memset(&result, 0, sizeof(result));
+    rt_sem_init(&recv_sem, "linkrx", 0, RT_IPC_FLAG_PRIO);
+
+    /* the session talks to itself, the handshake syncs its rx sequence to its tx sequence */
+    rt_link_service_attach(&bench_service);
+    for (i = 0; i < 100 && bench_service.state != RT_LINK_CONNECT; i++)
+    {
+        rt_thread_mdelay(10);
+    }
+
+    start = rt_tick_get();
+    for (i = 0; i < count; i++)
+    {
+        for (j = 0; j < size; j++)
+        {
+            buf[j] = (rt_uint8_t)(j + i);
+        }
+        result.send_tick = rt_tick_get();
+        if (rt_link_send(&bench_service, buf, size) != size)
+        {
+            rt_kprintf("package %d send failed, err %d\n", i, bench_service.err);
+            break;
+        }
+        sent++;
+        /* the confirm may arrive before the receive callback is done */
+        rt_sem_take(&recv_sem, RT_TICK_PER_SECOND);
+    }
+    ticks = rt_tick_get() - start;
+
+    rt_link_service_detach(&bench_service);
+    sim.running = RT_FALSE;
+    rt_thread_mdelay(10);
+    rt_sem_detach(&recv_sem);
+    rt_free(buf);
+
+    rt_kprintf("%s, %d x %d bytes, %d%% frames corrupted, %d baud\n",
+#ifdef RT_LINK_USING_WINDOW
+               "window",
+#else
+               "stop-and-wait",
+#endif
+               count, size, sim.loss_pct, baud);
+    rt_kprintf("sent %d, received %d, errors %d, %d bytes/s\n", sent, result.received, result.errors,
+               ticks ? (rt_uint32_t)((rt_uint64_t)result.received * size * RT_TICK_PER_SECOND / ticks) : 0);
+    rt_kprintf("latency avg %d ms, max %d ms\n",
+               result.received ? (rt_uint32_t)(result.latency_total * 1000 / RT_TICK_PER_SECOND / result.received) : 0,
+               (rt_uint32_t)((rt_uint64_t)result.latency_max * 1000 / RT_TICK_PER_SECOND));
+    rt_kprintf("link frames %d, corrupted %d, bytes dropped %d\n", sim.frames, sim.corrupted, sim.dropped);
+}
+MSH_CMD_EXPORT(rtlink_bench, rt link throughput and latency on a simulated serial link);
+
+#endif /* defined(RT_LINK_USING_BENCH) && defined(RT_USING_FINSH) */
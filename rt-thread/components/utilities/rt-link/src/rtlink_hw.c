@@ -7,6 +7,8 @@
  * Date           Author       Notes
  * 2021-02-02     xiangxistu   the first version
  * 2021-05-08     Sherman      Optimize the operation function on the rt_link_receive_buffer
+ * 2026-10-18     RT-Thread    add scatter-gather send
+ * 2026-10-18     RT-Thread    keep the running crc in the caller
  */
 
 #include <rtthread.h>
@@ -157,26 +159,27 @@ rt_size_t rt_link_hw_recv_len(struct rt_link_receive_buffer *buffer)
     }
 }
 
-rt_err_t rt_link_reset_crc32(void)
+rt_err_t rt_link_reset_crc32(rt_link_crc_ctx_t *ctx)
 {
 #ifdef RT_LINK_USING_HW_CRC
     return rt_link_hw_crc32_reset();
 #else
-    return rt_link_sf_crc32_reset();
+    return rt_link_sf_crc32_reset(ctx);
 #endif
 }
 
-rt_uint32_t rt_link_crc32(rt_uint8_t *data, rt_size_t u32_size)
+rt_uint32_t rt_link_crc32(rt_link_crc_ctx_t *ctx, rt_uint8_t *data, rt_size_t u32_size)
 {
 #ifdef RT_LINK_USING_HW_CRC
     return rt_link_hw_crc32(data, u32_size);
 #else
-    return rt_link_sf_crc32(data, u32_size);
+    return rt_link_sf_crc32(ctx, data, u32_size);
 #endif
 }
 
 rt_uint32_t rt_link_get_crc(rt_uint8_t using_buffer_ring, rt_uint8_t *data, rt_size_t size)
 {
+    rt_link_crc_ctx_t ctx;
     rt_uint32_t crc32 = 0x0;
     rt_size_t surplus = 0;
 
@@ -186,24 +189,24 @@ rt_uint32_t rt_link_get_crc(rt_uint8_t using_buffer_ring, rt_uint8_t *data, rt_s
         return 0;
     }
 
-    rt_link_reset_crc32();
+    rt_link_reset_crc32(&ctx);
     if (using_buffer_ring == 1)
     {
         /* modify the missing character */
         surplus = rx_buffer->end_point - data;
         if (surplus >= size)
         {
-            crc32 = rt_link_crc32(data, size);
+            crc32 = rt_link_crc32(&ctx, data, size);
         }
         else
         {
-            rt_link_crc32(data, surplus);
-            crc32 = rt_link_crc32(rx_buffer->data, size - surplus);
+            rt_link_crc32(&ctx, data, surplus);
+            crc32 = rt_link_crc32(&ctx, rx_buffer->data, size - surplus);
         }
     }
     else
     {
-        crc32 = rt_link_crc32(data, size);
+        crc32 = rt_link_crc32(&ctx, data, size);
     }
     return crc32;
 }
@@ -220,6 +223,46 @@ rt_size_t rt_link_hw_send(void *data, rt_size_t length)
     return send_len;
 }
 
+rt_weak rt_size_t rt_link_port_sendv(const struct rt_link_iovec *iov, rt_size_t iovcnt)
+{
+    rt_size_t i, send_len = 0;
+#ifdef RT_LINK_USING_SPI
+    /* one transfer per frame, gather the frame into the send buffer */
+    struct rt_link_session *scb = rt_link_get_scb();
+
+    for (i = 0; i < iovcnt; i++)
+    {
+        RT_ASSERT(send_len + iov[i].len <= sizeof(scb->sendbuffer));
+        rt_memcpy(scb->sendbuffer + send_len, iov[i].base, iov[i].len);
+        send_len += iov[i].len;
+    }
+    return rt_link_port_send(scb->sendbuffer, send_len);
+#else
+    /* the stream ports send the buffers one after another */
+    for (i = 0; i < iovcnt; i++)
+    {
+        if (rt_link_port_send(iov[i].base, iov[i].len) != iov[i].len)
+        {
+            return 0;
+        }
+        send_len += iov[i].len;
+    }
+    return send_len;
+#endif /* RT_LINK_USING_SPI */
+}
+
+rt_size_t rt_link_hw_sendv(const struct rt_link_iovec *iov, rt_size_t iovcnt)
+{
+    rt_size_t send_len = 0;
+    send_len = rt_link_port_sendv(iov, iovcnt);
+    if (send_len <= 0)
+    {
+        rt_link_port_reconnect();
+        send_len = rt_link_port_sendv(iov, iovcnt);
+    }
+    return send_len;
+}
+
 rt_size_t rt_link_hw_write_cb(void *data, rt_size_t length)
 {
     /* write real data into rtlink receive buffer */
@@ -50,6 +50,8 @@
  * 2023-04-01     Chushicheng  change version number to v5.0.1
  * 2023-05-20     Bernard      add stdc atomic detection.
  * 2023-09-17     Meco Man     add RT_USING_LIBC_ISO_ONLY macro
+ * 2026-10-18     RT-Thread    add cpu usage accounting
+ * 2026-10-18     RT-Thread    add the mutex priority of a thread
  */
 
 #ifndef __RT_DEF_H__
@@ -889,6 +891,7 @@ struct rt_thread
     /* object for IPC */
     rt_list_t                   taken_object_list;
     rt_object_t                 pending_object;
+    rt_uint8_t                  mutex_priority;         /**< highest priority of the taken mutexes */
 #endif
 
 #ifdef RT_USING_EVENT
@@ -913,6 +916,10 @@ struct rt_thread
 
 #ifdef RT_USING_CPU_USAGE
     rt_uint64_t                 duration_tick;          /**< cpu usage tick */
+    rt_uint32_t                 wakeup_tick;            /**< cpu tick of the wakeup, 0 when not waiting to run */
+    rt_uint32_t                 max_latency;            /**< the longest wakeup to run, in cpu ticks */
+    rt_uint32_t                 switch_count;           /**< times switched in */
+    rt_uint32_t                 preempt_count;          /**< times switched out while ready */
 #endif /* RT_USING_CPU_USAGE */
 
 #ifdef RT_USING_PTHREADS
@@ -958,6 +965,31 @@ struct rt_thread
 };
 typedef struct rt_thread *rt_thread_t;
 
+#ifdef RT_USING_CPU_USAGE
+#define RT_CPU_USAGE_LATENCY_NR         24
+
+/**
+ * CPU usage of a thread, in cpu ticks of the cputime clock
+ */
+struct rt_thread_usage
+{
+    rt_uint64_t                 run_tick;               /**< time running */
+    rt_uint32_t                 switch_count;           /**< times switched in */
+    rt_uint32_t                 preempt_count;          /**< times switched out while ready, yields included */
+    rt_uint32_t                 max_latency;            /**< the longest wakeup to run */
+};
+
+/**
+ * CPU usage of the interrupts and the scheduler, summed over the CPUs
+ */
+struct rt_cpu_usage
+{
+    rt_uint64_t                 irq_tick;               /**< time in interrupts */
+    rt_uint32_t                 irq_count;
+    rt_uint32_t                 latency[RT_CPU_USAGE_LATENCY_NR]; /**< wakeups run after [2^n, 2^(n+1)) cpu ticks */
+};
+#endif /* RT_USING_CPU_USAGE */
+
 /**@}*/
 
 /**
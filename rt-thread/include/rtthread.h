@@ -19,6 +19,9 @@
  * 2022-06-04     Meco Man     remove strnlen
  * 2023-05-20     Bernard      add rtatomic.h header file to included files.
  * 2023-06-30     ChuShicheng  move debug check from the rtdebug.h
+ * 2026-10-18     RT-Thread    add cpu usage accounting
+ * 2026-10-18     RT-Thread    add loaned buffers of the message queue
+ * 2026-10-18     RT-Thread    add rt_mutex_take_for
  */
 
 #ifndef __RT_THREAD_H__
@@ -214,6 +217,21 @@ void rt_secondary_cpu_entry(void);
 void rt_scheduler_ipi_handler(int vector, void *param);
 #endif /* RT_USING_SMP */
 
+#ifdef RT_USING_CPU_USAGE
+/*
+ * cpu usage interface
+ */
+rt_err_t rt_thread_get_usage(rt_thread_t thread, struct rt_thread_usage *usage);
+void rt_cpu_usage_get(struct rt_cpu_usage *usage);
+void rt_cpu_usage_reset(void);
+
+/* called by the scheduler and the interrupt entry, with interrupts disabled */
+void rt_cpu_usage_switch(struct rt_thread *from, struct rt_thread *to);
+void rt_cpu_usage_ready(struct rt_thread *thread);
+void rt_cpu_usage_irq_enter(void);
+void rt_cpu_usage_irq_leave(void);
+#endif /* RT_USING_CPU_USAGE */
+
 /**@}*/
 
 /**
@@ -382,6 +400,7 @@ rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout);
 rt_err_t rt_mutex_trytake(rt_mutex_t mutex);
 rt_err_t rt_mutex_take_interruptible(rt_mutex_t mutex, rt_int32_t time);
 rt_err_t rt_mutex_take_killable(rt_mutex_t mutex, rt_int32_t time);
+rt_err_t rt_mutex_take_for(rt_mutex_t mutex, rt_thread_t thread);
 rt_err_t rt_mutex_release(rt_mutex_t mutex);
 rt_err_t rt_mutex_control(rt_mutex_t mutex, int cmd, void *arg);
 #endif /* RT_USING_MUTEX */
@@ -524,6 +543,14 @@ rt_ssize_t rt_mq_recv_prio(rt_mq_t mq,
                            rt_int32_t timeout,
                            int suspend_flag);
 #endif /* RT_USING_MESSAGEQUEUE_PRIORITY */
+
+#ifdef RT_USING_MESSAGEQUEUE_LOAN
+rt_err_t rt_mq_loan(rt_mq_t mq, void **buffer, rt_int32_t timeout, int suspend_flag);
+rt_err_t rt_mq_commit(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t prio);
+rt_err_t rt_mq_cancel(rt_mq_t mq, void *buffer);
+rt_ssize_t rt_mq_recv_loan(rt_mq_t mq, void **buffer, rt_int32_t *prio, rt_int32_t timeout, int suspend_flag);
+rt_err_t rt_mq_recv_release(rt_mq_t mq, void *buffer);
+#endif /* RT_USING_MESSAGEQUEUE_LOAN */
 #endif /* RT_USING_MESSAGEQUEUE */
 
 /* defunct */
@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2012-01-10     bernard      porting to AM1808
+ * 2026-10-18     RT-Thread    read-only and read-write control of the user pages
+ * 2026-10-18     RT-Thread    map the aligned 1MB by sections
  */
 
 #include <rthw.h>
@@ -211,6 +213,65 @@ int rt_hw_mmu_ioremap_init(rt_aspace_t aspace, void* v_address, size_t size)
 
 
 
+#define ARCH_SECTION_PAGES  (ARCH_SECTION_SIZE >> ARCH_PAGE_SHIFT)
+#define ARCH_TYPE_SECTION   0x2
+
+/* the small page attributes to a section descriptor, and back */
+static size_t _attr_to_section(size_t attr)
+{
+    return ARCH_TYPE_SECTION | (attr & (MMU_MAP_MTBL_B | MMU_MAP_MTBL_C)) |
+           ((attr & MMU_MAP_MTBL_XN) << 4) | ((attr & (0xff << 4)) << 6);
+}
+
+static size_t _section_to_attr(size_t sect)
+{
+    return MMU_MAP_MTBL_A | (sect & (MMU_MAP_MTBL_B | MMU_MAP_MTBL_C)) |
+           ((sect >> 4) & MMU_MAP_MTBL_XN) | ((sect >> 6) & (0xff << 4));
+}
+
+static int _kenrel_map_section(unsigned long *lv0_tbl, void *v_addr, void *p_addr,
+                               size_t attr)
+{
+    size_t *mmu_l1 = (size_t *)lv0_tbl + ((size_t)v_addr >> ARCH_SECTION_SHIFT);
+
+    if (*mmu_l1 & ARCH_MMU_USED_MASK)
+    {
+        /* a page table is there already */
+        return -1;
+    }
+
+    *mmu_l1 = ((size_t)p_addr & ~ARCH_SECTION_MASK) | _attr_to_section(attr);
+    /* cache maintain */
+    rt_hw_cpu_dcache_ops(RT_HW_CACHE_FLUSH, mmu_l1, 4);
+
+    return 0;
+}
+
+/* replace a section with the page table mmu_l2 of the same mapping */
+static void _kenrel_split_section(size_t *mmu_l1, size_t *mmu_l2)
+{
+    size_t sect = *mmu_l1;
+    size_t pa = sect & ~ARCH_SECTION_MASK;
+    size_t attr = _section_to_attr(sect);
+    int i;
+
+    for (i = 0; i < ARCH_SECTION_PAGES; i++)
+    {
+        mmu_l2[i] = (pa + (i << ARCH_PAGE_SHIFT)) | attr;
+    }
+    /* one reference for each entry used */
+    for (i = 1; i < ARCH_SECTION_PAGES; i++)
+    {
+        rt_page_ref_inc(mmu_l2, 0);
+    }
+    /* cache maintain */
+    rt_hw_cpu_dcache_ops(RT_HW_CACHE_FLUSH, mmu_l2, ARCH_PAGE_TBL_SIZE);
+
+    *mmu_l1 = (((size_t)mmu_l2 + PV_OFFSET) | 0x1);
+    /* cache maintain */
+    rt_hw_cpu_dcache_ops(RT_HW_CACHE_FLUSH, mmu_l1, 4);
+}
+
 static void _kenrel_unmap_4K(unsigned long *lv0_tbl, void *v_addr)
 {
     size_t loop_va = (size_t)v_addr & ~ARCH_PAGE_MASK;
@@ -258,7 +319,12 @@ static int _kenrel_map_4K(unsigned long *lv0_tbl, void *v_addr, void *p_addr,
     l2_off = ((loop_va & ARCH_SECTION_MASK) >> ARCH_PAGE_SHIFT);
     mmu_l1 = (size_t *)lv0_tbl + l1_off;
 
-    if (*mmu_l1 & ARCH_MMU_USED_MASK)
+    if (*mmu_l1 & ARCH_TYPE_SECTION)
+    {
+        /* mapped by a section already */
+        return -1;
+    }
+    else if (*mmu_l1 & ARCH_MMU_USED_MASK)
     {
         mmu_l2 = (size_t *)((*mmu_l1 & ~ARCH_PAGE_TBL_MASK) - PV_OFFSET);
         rt_page_ref_inc(mmu_l2, 0);
@@ -299,26 +365,33 @@ void *rt_hw_mmu_map(rt_aspace_t aspace, void *v_addr, void *p_addr, size_t size,
     int ret = -1;
     void *unmap_va = v_addr;
     size_t npages = size >> ARCH_PAGE_SHIFT;
+    size_t step;
 
-    // TODO trying with HUGEPAGE here
-    while (npages--)
+    while (npages)
     {
-        ret = _kenrel_map_4K(aspace->page_table, v_addr, p_addr, attr);
+        /* a section for each aligned 1MB, where no page table is used */
+        if (!(((size_t)v_addr | (size_t)p_addr) & ARCH_SECTION_MASK) &&
+            npages >= ARCH_SECTION_PAGES &&
+            _kenrel_map_section(aspace->page_table, v_addr, p_addr, attr) == 0)
+        {
+            ret = 0;
+            step = ARCH_SECTION_SIZE;
+        }
+        else
+        {
+            ret = _kenrel_map_4K(aspace->page_table, v_addr, p_addr, attr);
+            step = ARCH_PAGE_SIZE;
+        }
+
         if (ret != 0)
         {
             /* error, undo map */
-            while (unmap_va != v_addr)
-            {
-                rt_enter_critical();
-                _kenrel_unmap_4K(aspace->page_table, (void *)unmap_va);
-                rt_exit_critical();
-
-                unmap_va += ARCH_PAGE_SIZE;
-            }
+            rt_hw_mmu_unmap(aspace, unmap_va, (size_t)v_addr - (size_t)unmap_va);
             break;
         }
-        v_addr += ARCH_PAGE_SIZE;
-        p_addr += ARCH_PAGE_SIZE;
+        v_addr += step;
+        p_addr += step;
+        npages -= step >> ARCH_PAGE_SHIFT;
     }
 
     if (ret == 0)
@@ -333,19 +406,63 @@ void rt_hw_mmu_unmap(rt_aspace_t aspace, void *v_addr, size_t size)
 {
     // caller guarantee that v_addr & size are page aligned
     size_t npages = size >> ARCH_PAGE_SHIFT;
+    size_t *mmu_l1, *mmu_l2;
+    size_t step;
+    rt_bool_t whole;
 
     if (!aspace->page_table)
     {
         return;
     }
 
-    while (npages--)
+    while (npages)
     {
+        mmu_l1 = (size_t *)aspace->page_table + ((size_t)v_addr >> ARCH_SECTION_SHIFT);
+        whole = !((size_t)v_addr & ARCH_SECTION_MASK) && npages >= ARCH_SECTION_PAGES;
+        step = ARCH_PAGE_SIZE;
+        mmu_l2 = RT_NULL;
+
+        if ((*mmu_l1 & ARCH_TYPE_SECTION) && !whole)
+        {
+            /**
+             * the page table of the split is taken out of the critical section, a section
+             * left mapped would point to the frames the caller frees after the unmap
+             */
+            mmu_l2 = (size_t *)rt_pages_alloc(0);
+            if (!mmu_l2)
+            {
+                LOG_E("%s: no page to split the section at %p", __func__, v_addr);
+                RT_ASSERT(0);
+            }
+        }
+
         rt_enter_critical();
-        _kenrel_unmap_4K(aspace->page_table, v_addr);
+        if ((*mmu_l1 & ARCH_TYPE_SECTION) && whole)
+        {
+            *mmu_l1 = 0;
+            /* cache maintain */
+            rt_hw_cpu_dcache_ops(RT_HW_CACHE_FLUSH, mmu_l1, 4);
+            step = ARCH_SECTION_SIZE;
+        }
+        else
+        {
+            if ((*mmu_l1 & ARCH_TYPE_SECTION) && mmu_l2)
+            {
+                _kenrel_split_section(mmu_l1, mmu_l2);
+                mmu_l2 = RT_NULL;
+            }
+            _kenrel_unmap_4K(aspace->page_table, v_addr);
+        }
         rt_exit_critical();
 
-        v_addr += ARCH_PAGE_SIZE;
+        if (mmu_l2)
+        {
+            /* the section is gone meanwhile */
+            rt_pages_free(mmu_l2, 0);
+        }
+
+        v_addr += step;
+        npages -= step >> ARCH_PAGE_SHIFT;
     }
 }
 
@@ -438,5 +555,118 @@ void *rt_hw_mmu_v2p(rt_aspace_t aspace, void* v_addr)
 int rt_hw_mmu_control(struct rt_aspace *aspace, void *vaddr, size_t size,
                       enum rt_mmu_cntl cmd)
 {
-    return -RT_ENOSYS;
+    size_t loop_va = (size_t)vaddr & ~ARCH_PAGE_MASK;
+    size_t loop_end = (size_t)vaddr + size;
+    size_t *mmu_l1, *mmu_l2;
+    size_t part[2], *split[2];
+    int i, npart = 0;
+
+    if (cmd != MMU_CNTL_READONLY && cmd != MMU_CNTL_READWRITE)
+    {
+        return -RT_ENOSYS;
+    }
+
+    /**
+     * the sections covered in part, at most the first and the last one, are split
+     * before any entry is changed; the page tables are taken out of the critical
+     * section, so a failure leaves the mapping as it was
+     */
+    if ((loop_va & ARCH_SECTION_MASK) || loop_end - loop_va < ARCH_SECTION_SIZE)
+        part[npart++] = loop_va & ~ARCH_SECTION_MASK;
+    if ((loop_end & ARCH_SECTION_MASK) &&
+        (npart == 0 || ((loop_end - 1) & ~ARCH_SECTION_MASK) != part[0]))
+        part[npart++] = (loop_end - 1) & ~ARCH_SECTION_MASK;
+
+_retry:
+    for (i = 0; i < npart; i++)
+    {
+        mmu_l1 = (size_t *)aspace->page_table + (part[i] >> ARCH_SECTION_SHIFT);
+        split[i] = RT_NULL;
+        if (*mmu_l1 & ARCH_TYPE_SECTION)
+        {
+            split[i] = (size_t *)rt_pages_alloc(0);
+            if (!split[i])
+            {
+                while (i--)
+                {
+                    if (split[i])
+                        rt_pages_free(split[i], 0);
+                }
+                return -RT_ENOMEM;
+            }
+        }
+    }
+
+    rt_enter_critical();
+    for (i = 0; i < npart; i++)
+    {
+        mmu_l1 = (size_t *)aspace->page_table + (part[i] >> ARCH_SECTION_SHIFT);
+        if ((*mmu_l1 & ARCH_TYPE_SECTION) && !split[i])
+        {
+            /* a section is mapped here meanwhile */
+            rt_exit_critical();
+            for (i = 0; i < npart; i++)
+            {
+                if (split[i])
+                    rt_pages_free(split[i], 0);
+            }
+            goto _retry;
+        }
+    }
+    for (i = 0; i < npart; i++)
+    {
+        mmu_l1 = (size_t *)aspace->page_table + (part[i] >> ARCH_SECTION_SHIFT);
+        if ((*mmu_l1 & ARCH_TYPE_SECTION) && split[i])
+        {
+            _kenrel_split_section(mmu_l1, split[i]);
+            split[i] = RT_NULL;
+        }
+    }
+
+    /* only the AP2 bit is changed, the caller invalidates the TLB */
+    while (loop_va < loop_end)
+    {
+        mmu_l1 = (size_t *)aspace->page_table + (loop_va >> ARCH_SECTION_SHIFT);
+        if (*mmu_l1 & ARCH_TYPE_SECTION)
+        {
+            /* the sections left are covered as a whole */
+            if (cmd == MMU_CNTL_READONLY)
+                *mmu_l1 |= MMU_MAP_MTBL_AP2(1) << 6;
+            else
+                *mmu_l1 &= ~(MMU_MAP_MTBL_AP2(1) << 6);
+            /* cache maintain */
+            rt_hw_cpu_dcache_ops(RT_HW_CACHE_FLUSH, mmu_l1, 4);
+            loop_va += ARCH_SECTION_SIZE;
+            continue;
+        }
+        else if (!(*mmu_l1 & ARCH_MMU_USED_MASK))
+        {
+            /* no page table here, skip the section */
+            loop_va = (loop_va & ~ARCH_SECTION_MASK) + ARCH_SECTION_SIZE;
+            continue;
+        }
+
+        mmu_l2 = (size_t *)((*mmu_l1 & ~ARCH_PAGE_TBL_MASK) - PV_OFFSET);
+        mmu_l2 += (loop_va & ARCH_SECTION_MASK) >> ARCH_PAGE_SHIFT;
+        if (*mmu_l2 & 0x2)
+        {
+            if (cmd == MMU_CNTL_READONLY)
+                *mmu_l2 |= MMU_MAP_MTBL_AP2(1);
+            else
+                *mmu_l2 &= ~MMU_MAP_MTBL_AP2(1);
+            /* cache maintain */
+            rt_hw_cpu_dcache_ops(RT_HW_CACHE_FLUSH, mmu_l2, 4);
+        }
+        loop_va += ARCH_PAGE_SIZE;
+    }
+    rt_exit_critical();
+
+    for (i = 0; i < npart; i++)
+    {
+        /* the section is gone meanwhile */
+        if (split[i])
+            rt_pages_free(split[i], 0);
+    }
+
+    return RT_EOK;
 }
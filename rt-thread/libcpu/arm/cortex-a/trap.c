@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-07-20     Bernard      first version
+ * 2026-10-18     RT-Thread    handle the translation and copy-on-write faults of the user space
  */
 
 #include <backtrace.h>
@@ -42,25 +43,49 @@ void check_user_fault(struct rt_hw_exp_stack *regs, uint32_t pc_adj, char *info)
     }
 }
 
-int check_user_stack(struct rt_hw_exp_stack *regs)
+#define DFSR_FS(dfsr)           ((((dfsr) >> 6) & 0x10) | ((dfsr) & 0xf))
+#define DFSR_WNR                (1 << 11)
+#define DFSR_FS_TRANS_SECTION   0x05
+#define DFSR_FS_TRANS_PAGE      0x07
+#define DFSR_FS_PERM_SECTION    0x0d
+#define DFSR_FS_PERM_PAGE       0x0f
+
+int check_user_access(struct rt_hw_exp_stack *regs)
 {
+    uint32_t dfsr;
     void *dfar = RT_NULL;
     struct rt_lwp *lwp;
+    struct rt_aspace_fault_msg msg;
+    asm volatile("MRC p15, 0, %0, c5, c0, 0" : "=r"(dfsr));
     asm volatile("MRC p15, 0, %0, c6, c0, 0" : "=r"(dfar));
 
-    if ((dfar >= (void *)USER_STACK_VSTART) && (dfar < (void *)USER_STACK_VEND))
+    if ((dfar < (void *)USER_VADDR_START) || (dfar >= (void *)USER_VADDR_TOP))
     {
-        struct rt_aspace_fault_msg msg = {
-            .fault_op = MM_FAULT_OP_WRITE,
-            .fault_type = MM_FAULT_TYPE_PAGE_FAULT,
-            .fault_vaddr = dfar,
-        };
-        lwp = lwp_self();
-        if (lwp && rt_aspace_fault_try_fix(lwp->aspace, &msg))
-        {
-            regs->pc -= 8;
-            return 1;
-        }
+        return 0;
+    }
+
+    /* a missing page or a write to a copy-on-write page, from the user or the kernel */
+    switch (DFSR_FS(dfsr))
+    {
+    case DFSR_FS_TRANS_SECTION:
+    case DFSR_FS_TRANS_PAGE:
+        msg.fault_type = MM_FAULT_TYPE_PAGE_FAULT;
+        break;
+    case DFSR_FS_PERM_SECTION:
+    case DFSR_FS_PERM_PAGE:
+        msg.fault_type = MM_FAULT_TYPE_ACCESS_FAULT;
+        break;
+    default:
+        return 0;
+    }
+    msg.fault_op = (dfsr & DFSR_WNR) ? MM_FAULT_OP_WRITE : MM_FAULT_OP_READ;
+    msg.fault_vaddr = dfar;
+
+    lwp = lwp_self();
+    if (lwp && rt_aspace_fault_try_fix(lwp->aspace, &msg))
+    {
+        regs->pc -= 8;
+        return 1;
     }
 
     return 0;
@@ -211,7 +236,7 @@ void rt_hw_trap_dabt(struct rt_hw_exp_stack *regs)
     {
         return;
     }
-    if (check_user_stack(regs))
+    if (check_user_access(regs))
     {
         return;
     }
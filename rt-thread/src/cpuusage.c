@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_CPU_USAGE
+#include <drivers/cputime.h>
+
+/*
+ * Each CPU charges the time since its last mark to the thread it runs, when it switches
+ * threads in thread context or enters an interrupt, and to the interrupts when it leaves
+ * them. A switch inside an interrupt only hands the CPU over, the interrupt keeps the time.
+ *
+ * The cputime counter may be 32 bits wide, the intervals are taken modulo 2^32 cpu ticks;
+ * the tick interrupt keeps them short.
+ */
+struct cpu_usage
+{
+    rt_uint32_t last;                               /* cpu tick of the last mark */
+    rt_uint64_t irq_tick;
+    rt_uint32_t irq_count;
+    rt_uint32_t latency[RT_CPU_USAGE_LATENCY_NR];
+};
+
+#ifdef RT_USING_SMP
+static struct cpu_usage _cpu_usage[RT_CPUS_NR];
+#define _CPU_USAGE_NR                   RT_CPUS_NR
+#define _cpu_usage_self()               (&_cpu_usage[rt_hw_cpu_id()])
+#else
+static struct cpu_usage _cpu_usage[1];
+#define _CPU_USAGE_NR                   1
+#define _cpu_usage_self()               (&_cpu_usage[0])
+#endif /* RT_USING_SMP */
+
+rt_inline rt_uint32_t _cpu_usage_now(void)
+{
+    return (rt_uint32_t)clock_cpu_gettime();
+}
+
+rt_inline int _cpu_usage_log2(rt_uint32_t value)
+{
+    int n = 0;
+
+    if (value >= 1UL << 16) { value >>= 16; n += 16; }
+    if (value >= 1UL << 8)  { value >>= 8;  n += 8;  }
+    if (value >= 1UL << 4)  { value >>= 4;  n += 4;  }
+    if (value >= 1UL << 2)  { value >>= 2;  n += 2;  }
+    if (value >= 1UL << 1)  { n += 1; }
+
+    return n;
+}
+
+/**
+ * @brief This function charges the running time of the from thread and records the
+ *        wakeup latency of the to thread.
+ *
+ * @param from is the thread switched out, RT_NULL when the scheduler starts.
+ *
+ * @param to is the thread switched in.
+ *
+ * @note  Please do not invoke this function in user application.
+ */
+void rt_cpu_usage_switch(struct rt_thread *from, struct rt_thread *to)
+{
+    struct cpu_usage *usage = _cpu_usage_self();
+    rt_uint32_t now = _cpu_usage_now();
+    rt_uint32_t latency;
+    rt_uint8_t stat;
+    int index;
+
+    if (from != RT_NULL)
+    {
+        if (rt_interrupt_get_nest() == 0)
+        {
+            from->duration_tick += now - usage->last;
+            usage->last = now;
+        }
+
+        stat = from->stat & RT_THREAD_STAT_MASK;
+        if (stat == RT_THREAD_RUNNING || stat == RT_THREAD_READY)
+        {
+            from->preempt_count++;
+        }
+    }
+    else
+    {
+        usage->last = now;
+    }
+
+    to->switch_count++;
+    if (to->wakeup_tick)
+    {
+        latency = now - to->wakeup_tick;
+        to->wakeup_tick = 0;
+        if (latency > to->max_latency)
+        {
+            to->max_latency = latency;
+        }
+
+        index = _cpu_usage_log2(latency);
+        if (index >= RT_CPU_USAGE_LATENCY_NR)
+        {
+            index = RT_CPU_USAGE_LATENCY_NR - 1;
+        }
+        usage->latency[index]++;
+    }
+}
+
+/**
+ * @brief This function marks the wakeup of a suspended thread made ready.
+ *
+ * @param thread is the thread inserted to the ready queue.
+ *
+ * @note  Please do not invoke this function in user application.
+ */
+void rt_cpu_usage_ready(struct rt_thread *thread)
+{
+    rt_uint32_t now;
+
+    /* a preempted thread or a new priority is not a wakeup */
+    if ((thread->stat & RT_THREAD_SUSPEND_MASK) == RT_THREAD_SUSPEND_MASK)
+    {
+        now = _cpu_usage_now();
+        thread->wakeup_tick = now ? now : 1;
+    }
+}
+
+/**
+ * @brief This function charges the interrupted thread when the first interrupt enters.
+ *
+ * @note  Please do not invoke this function in user application.
+ */
+void rt_cpu_usage_irq_enter(void)
+{
+    struct cpu_usage *usage = _cpu_usage_self();
+    struct rt_thread *thread = rt_thread_self();
+    rt_uint32_t now = _cpu_usage_now();
+
+    if (thread != RT_NULL)
+    {
+        thread->duration_tick += now - usage->last;
+    }
+    usage->last = now;
+}
+
+/**
+ * @brief This function charges the interrupts when the last one leaves.
+ *
+ * @note  Please do not invoke this function in user application.
+ */
+void rt_cpu_usage_irq_leave(void)
+{
+    struct cpu_usage *usage = _cpu_usage_self();
+    rt_uint32_t now = _cpu_usage_now();
+
+    usage->irq_tick += now - usage->last;
+    usage->irq_count++;
+    usage->last = now;
+}
+
+/**
+ * @brief This function will get the cpu usage of a thread.
+ *
+ * @param thread is the thread.
+ *
+ * @param usage is the usage of the thread, in cpu ticks. The running time includes the
+ *        current slice when the thread asks for itself.
+ *
+ * @return Return the operation status. If the return value is RT_EOK, the function is successfully executed.
+ */
+rt_err_t rt_thread_get_usage(rt_thread_t thread, struct rt_thread_usage *usage)
+{
+    rt_base_t level;
+
+    RT_ASSERT(thread != RT_NULL);
+    RT_ASSERT(usage != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    usage->run_tick = thread->duration_tick;
+    usage->switch_count = thread->switch_count;
+    usage->preempt_count = thread->preempt_count;
+    usage->max_latency = thread->max_latency;
+    if (thread == rt_thread_self() && rt_interrupt_get_nest() == 0)
+    {
+        usage->run_tick += _cpu_usage_now() - _cpu_usage_self()->last;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_thread_get_usage);
+
+/**
+ * @brief This function will get the interrupt time and the wakeup latency histogram.
+ *
+ * @param usage is the usage summed over the CPUs, in cpu ticks.
+ */
+void rt_cpu_usage_get(struct rt_cpu_usage *usage)
+{
+    rt_base_t level;
+    int cpu, index;
+
+    RT_ASSERT(usage != RT_NULL);
+
+    rt_memset(usage, 0, sizeof(*usage));
+    level = rt_hw_interrupt_disable();
+    for (cpu = 0; cpu < _CPU_USAGE_NR; cpu++)
+    {
+        usage->irq_tick += _cpu_usage[cpu].irq_tick;
+        usage->irq_count += _cpu_usage[cpu].irq_count;
+        for (index = 0; index < RT_CPU_USAGE_LATENCY_NR; index++)
+        {
+            usage->latency[index] += _cpu_usage[cpu].latency[index];
+        }
+    }
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_cpu_usage_get);
+
+/**
+ * @brief This function will clear the latency histogram and the longest latency of the
+ *        threads. The running times keep counting.
+ */
+void rt_cpu_usage_reset(void)
+{
+    struct rt_object_information *info;
+    struct rt_list_node *node;
+    rt_base_t level;
+    int cpu;
+
+    info = rt_object_get_information(RT_Object_Class_Thread);
+    level = rt_hw_interrupt_disable();
+    for (cpu = 0; cpu < _CPU_USAGE_NR; cpu++)
+    {
+        rt_memset(_cpu_usage[cpu].latency, 0, sizeof(_cpu_usage[cpu].latency));
+    }
+    rt_list_for_each(node, &info->object_list)
+    {
+        ((struct rt_thread *)rt_list_entry(node, struct rt_object, list))->max_latency = 0;
+    }
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_cpu_usage_reset);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+#include <stdlib.h>
+
+struct top_entry
+{
+    rt_thread_t thread;
+    struct rt_thread_usage usage;
+    rt_uint32_t delta;
+    rt_uint8_t priority;
+    char name[RT_NAME_MAX];
+};
+
+/* copy what is shown, a thread may be deleted after the snapshot */
+static int top_snapshot(struct top_entry *entry, rt_object_t *objects, int max)
+{
+    rt_base_t level;
+    int count, index, number = 0;
+
+    count = rt_object_get_pointers(RT_Object_Class_Thread, objects, max);
+    for (index = 0; index < count; index++)
+    {
+        level = rt_hw_interrupt_disable();
+        if ((objects[index]->type & ~RT_Object_Class_Static) != RT_Object_Class_Thread)
+        {
+            rt_hw_interrupt_enable(level);
+            continue;
+        }
+        entry[number].thread = (rt_thread_t)objects[index];
+        rt_thread_get_usage(entry[number].thread, &entry[number].usage);
+        entry[number].priority = entry[number].thread->current_priority;
+        rt_strncpy(entry[number].name, entry[number].thread->parent.name, RT_NAME_MAX);
+        rt_hw_interrupt_enable(level);
+        entry[number].delta = 0;
+        number++;
+    }
+
+    return number;
+}
+
+static rt_uint32_t top_ns(rt_uint64_t tick)
+{
+    return (rt_uint32_t)(tick * clock_cpu_getres() / 1000000);
+}
+
+static void top_latency(void)
+{
+    struct rt_cpu_usage usage;
+    rt_uint32_t total = 0;
+    int index;
+
+    rt_cpu_usage_get(&usage);
+    for (index = 0; index < RT_CPU_USAGE_LATENCY_NR; index++)
+    {
+        total += usage.latency[index];
+    }
+    rt_kprintf("wakeup to run     count\n");
+    for (index = 0; index < RT_CPU_USAGE_LATENCY_NR; index++)
+    {
+        if (usage.latency[index] == 0)
+            continue;
+        rt_kprintf(">= %8d ns %9d %3d%%\n", top_ns((rt_uint64_t)1 << index), usage.latency[index],
+                   (int)((rt_uint64_t)usage.latency[index] * 100 / total));
+    }
+}
+
+static int cmd_top(int argc, char **argv)
+{
+    struct rt_cpu_usage begin, end;
+    struct top_entry *before, *after, swap;
+    rt_object_t *objects;
+    rt_uint64_t total, irq;
+    int interval = 1000, max, count_before, count_after, i, j, count = 0;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "-l"))
+    {
+        top_latency();
+        return 0;
+    }
+    if (argc > 1 && !rt_strcmp(argv[1], "-r"))
+    {
+        rt_cpu_usage_reset();
+        return 0;
+    }
+    if (argc > 1)
+        interval = atoi(argv[1]);
+    if (interval <= 0)
+    {
+        rt_kprintf("Usage: top [ms]  threads by cpu usage over an interval\n");
+        rt_kprintf("       top -l    wakeup to run latency histogram\n");
+        rt_kprintf("       top -r    reset the latencies\n");
+        return -1;
+    }
+
+    max = rt_object_get_length(RT_Object_Class_Thread) + 8;
+    before = rt_malloc(max * (2 * sizeof(struct top_entry) + sizeof(rt_object_t)));
+    if (before == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return -RT_ENOMEM;
+    }
+    after = before + max;
+    objects = (rt_object_t *)(after + max);
+
+    rt_cpu_usage_get(&begin);
+    count_before = top_snapshot(before, objects, max);
+    rt_thread_mdelay(interval);
+    count_after = top_snapshot(after, objects, max);
+    rt_cpu_usage_get(&end);
+
+    /* the threads alive at both ends, the elapsed time is all that was charged */
+    irq = end.irq_tick - begin.irq_tick;
+    total = irq;
+    for (i = 0; i < count_after; i++)
+    {
+        for (j = 0; j < count_before; j++)
+        {
+            if (before[j].thread == after[i].thread)
+            {
+                after[count] = after[i];
+                after[count].delta = (rt_uint32_t)(after[i].usage.run_tick - before[j].usage.run_tick);
+                total += after[count].delta;
+                count++;
+                break;
+            }
+        }
+    }
+    if (total == 0)
+        total = 1;
+
+    for (i = 1; i < count; i++)
+    {
+        for (j = i; j > 0 && after[j].delta > after[j - 1].delta; j--)
+        {
+            swap = after[j];
+            after[j] = after[j - 1];
+            after[j - 1] = swap;
+        }
+    }
+
+    rt_kprintf("%d ms, irq %d.%d%% (%d)\n", interval, (int)(irq * 1000 / total / 10), (int)(irq * 1000 / total % 10),
+               end.irq_count - begin.irq_count);
+    rt_kprintf("%-*.*s pri   cpu%%  switch preempt max latency\n", RT_NAME_MAX, RT_NAME_MAX, "thread");
+    for (i = 0; i < count; i++)
+    {
+        rt_kprintf("%-*.*s %3d %3d.%d %7d %7d %8d ns\n", RT_NAME_MAX, RT_NAME_MAX, after[i].name, after[i].priority,
+                   (int)((rt_uint64_t)after[i].delta * 1000 / total / 10),
+                   (int)((rt_uint64_t)after[i].delta * 1000 / total % 10),
+                   after[i].usage.switch_count, after[i].usage.preempt_count, top_ns(after[i].usage.max_latency));
+    }
+    rt_free(before);
+
+    return 0;
+}
+MSH_CMD_EXPORT_ALIAS(cmd_top, top, show the cpu usage of the threads);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_USING_CPU_USAGE */
@@ -45,6 +45,9 @@
  * 2022-10-15     Bernard      add nested mutex feature
  * 2022-10-16     Bernard      add prioceiling feature in mutex
  * 2023-04-16     Xin-zheqi    redesigen queue recv and send function return real message size
+ * 2026-10-18     RT-Thread    O(1) mutex priority of a thread, adaptive mutex on SMP
+ * 2026-10-18     RT-Thread    loaned buffers of the message queue
+ * 2026-10-18     RT-Thread    add rt_mutex_take_for for PI futexes
  */
 
 #include <rtthread.h>
@@ -747,6 +750,54 @@ RTM_EXPORT(rt_sem_control);
 #endif /* RT_USING_SEMAPHORE */
 
 #ifdef RT_USING_MUTEX
+/* the priority a mutex gives to its owner, at least its priority ceiling */
+rt_inline rt_uint8_t _mutex_owner_priority(struct rt_mutex *mutex)
+{
+    return mutex->priority < mutex->ceiling_priority ? mutex->priority : mutex->ceiling_priority;
+}
+
+/*
+ * The highest priority of the mutexes taken by a thread is kept in thread->mutex_priority. When
+ * the priority a taken mutex gives changes from old to new, the taken list is only walked when
+ * the highest one goes down or leaves.
+ */
+rt_inline void _thread_mutex_priority_changed(struct rt_thread *thread, rt_uint8_t old, rt_uint8_t new)
+{
+    rt_list_t *node = RT_NULL;
+    struct rt_mutex *mutex = RT_NULL;
+    rt_uint8_t priority;
+
+    if (new <= thread->mutex_priority)
+    {
+        thread->mutex_priority = new;
+    }
+    else if (old == thread->mutex_priority)
+    {
+        thread->mutex_priority = 0xff;
+        rt_list_for_each(node, &(thread->taken_object_list))
+        {
+            mutex = rt_list_entry(node, struct rt_mutex, taken_list);
+            priority = _mutex_owner_priority(mutex);
+            if (thread->mutex_priority > priority)
+            {
+                thread->mutex_priority = priority;
+            }
+        }
+    }
+}
+
+/* set the priority of the pending threads of a mutex, the owner follows */
+rt_inline void _mutex_set_priority(struct rt_mutex *mutex, rt_uint8_t priority)
+{
+    rt_uint8_t old = _mutex_owner_priority(mutex);
+
+    mutex->priority = priority;
+    if (mutex->owner)
+    {
+        _thread_mutex_priority_changed(mutex->owner, old, _mutex_owner_priority(mutex));
+    }
+}
+
 /* iterate over each suspended thread to update highest priority in pending threads */
 rt_inline rt_uint8_t _mutex_update_priority(struct rt_mutex *mutex)
 {
@@ -755,11 +806,11 @@ rt_inline rt_uint8_t _mutex_update_priority(struct rt_mutex *mutex)
     if (!rt_list_isempty(&mutex->parent.suspend_thread))
     {
         thread = rt_list_entry(mutex->parent.suspend_thread.next, struct rt_thread, tlist);
-        mutex->priority = thread->current_priority;
+        _mutex_set_priority(mutex, thread->current_priority);
     }
     else
     {
-        mutex->priority = 0xff;
+        _mutex_set_priority(mutex, 0xff);
     }
 
     return mutex->priority;
@@ -768,24 +819,7 @@ rt_inline rt_uint8_t _mutex_update_priority(struct rt_mutex *mutex)
 /* get highest priority inside its taken object and its init priority */
 rt_inline rt_uint8_t _thread_get_mutex_priority(struct rt_thread* thread)
 {
-    rt_list_t *node = RT_NULL;
-    struct rt_mutex *mutex = RT_NULL;
-    rt_uint8_t priority = thread->init_priority;
-
-    rt_list_for_each(node, &(thread->taken_object_list))
-    {
-        mutex = rt_list_entry(node, struct rt_mutex, taken_list);
-        rt_uint8_t mutex_prio = mutex->priority;
-        /* prio at least be priority ceiling */
-        mutex_prio = mutex_prio < mutex->ceiling_priority ? mutex_prio : mutex->ceiling_priority;
-
-        if (priority > mutex_prio)
-        {
-            priority = mutex_prio;
-        }
-    }
-
-    return priority;
+    return thread->init_priority < thread->mutex_priority ? thread->init_priority : thread->mutex_priority;
 }
 
 /* update priority of target thread and the thread suspended it if any */
@@ -932,6 +966,8 @@ rt_err_t rt_mutex_detach(rt_mutex_t mutex)
     _ipc_list_resume_all(&(mutex->parent.suspend_thread));
     /* remove mutex from thread's taken list */
     rt_list_remove(&mutex->taken_list);
+    if (mutex->owner)
+        _thread_mutex_priority_changed(mutex->owner, _mutex_owner_priority(mutex), 0xff);
     rt_hw_interrupt_enable(level);
 
     /* detach mutex object */
@@ -967,22 +1003,7 @@ void rt_mutex_drop_thread(rt_mutex_t mutex, rt_thread_t thread)
         need_update = RT_TRUE;
 
     /* update the priority of mutex */
-    if (!rt_list_isempty(&mutex->parent.suspend_thread))
-    {
-        /* more thread suspended in the list */
-        struct rt_thread *th;
-
-        th = rt_list_entry(mutex->parent.suspend_thread.next,
-                                struct rt_thread,
-                                tlist);
-        /* update the priority of mutex */
-        mutex->priority = th->current_priority;
-    }
-    else
-    {
-        /* set mutex priority to maximal priority */
-        mutex->priority = 0xff;
-    }
+    _mutex_update_priority(mutex);
 
     /* try to change the priority of mutex owner thread */
     if (need_update)
@@ -1013,10 +1034,13 @@ rt_uint8_t rt_mutex_setprioceiling(rt_mutex_t mutex, rt_uint8_t priority)
     {
         /* critical section here if multiple updates to one mutex happen */
         rt_ubase_t level = rt_hw_interrupt_disable();
+        rt_uint8_t old = _mutex_owner_priority(mutex);
+
         ret_priority = mutex->ceiling_priority;
         mutex->ceiling_priority = priority;
         if (mutex->owner)
         {
+            _thread_mutex_priority_changed(mutex->owner, old, _mutex_owner_priority(mutex));
             rt_uint8_t priority = _thread_get_mutex_priority(mutex->owner);
             if (priority != mutex->owner->current_priority)
                 _thread_update_priority(mutex->owner, priority, RT_UNINTERRUPTIBLE);
@@ -1138,6 +1162,8 @@ rt_err_t rt_mutex_delete(rt_mutex_t mutex)
     _ipc_list_resume_all(&(mutex->parent.suspend_thread));
     /* remove mutex from thread's taken list */
     rt_list_remove(&mutex->taken_list);
+    if (mutex->owner)
+        _thread_mutex_priority_changed(mutex->owner, _mutex_owner_priority(mutex), 0xff);
     rt_hw_interrupt_enable(level);
 
     /* delete mutex object */
@@ -1149,6 +1175,41 @@ RTM_EXPORT(rt_mutex_delete);
 #endif /* RT_USING_HEAP */
 
 
+#ifdef RT_USING_MUTEX_ADAPTIVE
+#ifndef RT_MUTEX_SPIN_MAX
+#define RT_MUTEX_SPIN_MAX       1000
+#endif
+
+/*
+ * Adaptive mutex on SMP: the mutex being taken by a thread running on another CPU, the taker
+ * spins out of the kernel lock while the owner runs and holds it, at most RT_MUTEX_SPIN_MAX
+ * rounds, then takes the lock again and retries before it suspends. A short critical section
+ * costs no switch out and back in of the taker.
+ *
+ * It returns RT_TRUE after spinning, with the lock released.
+ */
+static rt_bool_t _mutex_spin(struct rt_mutex *mutex, rt_base_t level)
+{
+    struct rt_thread *owner = mutex->owner;
+    rt_uint32_t count;
+
+    if (owner->oncpu == RT_CPU_DETACHED)
+        return RT_FALSE;
+
+    rt_hw_interrupt_enable(level);
+    for (count = 0; count < RT_MUTEX_SPIN_MAX; count++)
+    {
+        if (*(struct rt_thread * volatile *)&mutex->owner != owner ||
+            *(volatile rt_uint8_t *)&owner->oncpu == RT_CPU_DETACHED)
+        {
+            break;
+        }
+    }
+
+    return RT_TRUE;
+}
+#endif /* RT_USING_MUTEX_ADAPTIVE */
+
 /**
  * @brief    This function will take a mutex, if the mutex is unavailable, the thread shall wait for
  *           the mutex up to a specified time.
@@ -1177,6 +1238,9 @@ static rt_err_t _rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout, int suspend
     rt_base_t level;
     struct rt_thread *thread;
     rt_err_t ret;
+#ifdef RT_USING_MUTEX_ADAPTIVE
+    rt_bool_t spun = RT_FALSE;
+#endif
 
     /* this function must not be used in interrupt even if time = 0 */
     /* current context checking */
@@ -1194,6 +1258,9 @@ static rt_err_t _rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout, int suspend
 
     RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mutex->parent.parent)));
 
+#ifdef RT_USING_MUTEX_ADAPTIVE
+__again:
+#endif
     LOG_D("mutex_take: current thread %s, hold: %d",
           thread->parent.name, mutex->hold);
 
@@ -1232,6 +1299,7 @@ static rt_err_t _rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout, int suspend
 
             /* insert mutex to thread's taken object list */
             rt_list_insert_after(&thread->taken_object_list, &mutex->taken_list);
+            _thread_mutex_priority_changed(thread, 0xff, _mutex_owner_priority(mutex));
         }
         else
         {
@@ -1250,6 +1318,15 @@ static rt_err_t _rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout, int suspend
             {
                 rt_uint8_t priority = thread->current_priority;
 
+#ifdef RT_USING_MUTEX_ADAPTIVE
+                if (!spun && _mutex_spin(mutex, level))
+                {
+                    spun = RT_TRUE;
+                    level = rt_hw_interrupt_disable();
+                    goto __again;
+                }
+#endif
+
                 /* mutex is unavailable, push to suspend list */
                 LOG_D("mutex_take: suspend thread: %s",
                       thread->parent.name);
@@ -1271,7 +1348,7 @@ static rt_err_t _rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout, int suspend
                 /* update the priority level of mutex */
                 if (priority < mutex->priority)
                 {
-                    mutex->priority = priority;
+                    _mutex_set_priority(mutex, priority);
                     if (mutex->priority < mutex->owner->current_priority)
                     {
                         _thread_update_priority(mutex->owner, priority, RT_UNINTERRUPTIBLE); /* TODO */
@@ -1321,22 +1398,7 @@ static rt_err_t _rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout, int suspend
                         need_update = RT_TRUE;
 
                     /* update the priority of mutex */
-                    if (!rt_list_isempty(&mutex->parent.suspend_thread))
-                    {
-                        /* more thread suspended in the list */
-                        struct rt_thread *th;
-
-                        th = rt_list_entry(mutex->parent.suspend_thread.next,
-                                                struct rt_thread,
-                                                tlist);
-                        /* update the priority of mutex */
-                        mutex->priority = th->current_priority;
-                    }
-                    else
-                    {
-                        /* set mutex priority to maximal priority */
-                        mutex->priority = 0xff;
-                    }
+                    _mutex_update_priority(mutex);
 
                     /* try to change the priority of mutex owner thread */
                     if (need_update)
@@ -1411,6 +1473,48 @@ rt_err_t rt_mutex_trytake(rt_mutex_t mutex)
 RTM_EXPORT(rt_mutex_trytake);
 
 
+/**
+ * @brief    This function will make a thread the owner of a free mutex.
+ *
+ * @note     It is for a lock that is taken outside of the kernel, as a PI futex taken in user space.
+ *           The first thread to wait on the lock gives the mutex to the owner of the lock, then it
+ *           waits on the mutex and the owner inherits its priority until it releases the mutex.
+ *
+ * @param    mutex is a pointer to a mutex object.
+ *
+ * @param    thread is the thread to own the mutex.
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the thread owns the mutex.
+ *           If the mutex has an owner already, -RT_EBUSY is returned.
+ */
+rt_err_t rt_mutex_take_for(rt_mutex_t mutex, rt_thread_t thread)
+{
+    rt_base_t level;
+
+    /* parameter check */
+    RT_ASSERT(mutex != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mutex->parent.parent) == RT_Object_Class_Mutex);
+    RT_ASSERT(thread != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    if (mutex->owner != RT_NULL)
+    {
+        rt_hw_interrupt_enable(level);
+
+        return -RT_EBUSY;
+    }
+
+    mutex->owner    = thread;
+    mutex->priority = 0xff;
+    mutex->hold     = 1;
+    rt_list_insert_after(&thread->taken_object_list, &mutex->taken_list);
+    _thread_mutex_priority_changed(thread, 0xff, _mutex_owner_priority(mutex));
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+
 /**
  * @brief    This function will release a mutex. If there is thread suspended on the mutex, the thread will be resumed.
  *
@@ -1467,6 +1571,7 @@ rt_err_t rt_mutex_release(rt_mutex_t mutex)
     {
         /* remove mutex from thread's taken list */
         rt_list_remove(&mutex->taken_list);
+        _thread_mutex_priority_changed(thread, _mutex_owner_priority(mutex), 0xff);
 
         /* whether change the thread priority */
         if ((mutex->ceiling_priority != 0xFF) || (thread->current_priority == mutex->priority))
@@ -1497,30 +1602,19 @@ rt_err_t rt_mutex_release(rt_mutex_t mutex)
             /* remove the thread from the suspended list of mutex */
             rt_list_remove(&(next_thread->tlist));
 
-            /* set new owner and put mutex into taken list of thread */
-            mutex->owner = next_thread;
-            mutex->hold  = 1;
-            rt_list_insert_after(&next_thread->taken_object_list, &mutex->taken_list);
             /* cleanup pending object */
             next_thread->pending_object = RT_NULL;
 
             /* resume thread */
             rt_thread_resume(next_thread);
 
-            /* update mutex priority */
-            if (!rt_list_isempty(&(mutex->parent.suspend_thread)))
-            {
-                struct rt_thread *th;
-
-                th = rt_list_entry(mutex->parent.suspend_thread.next,
-                        struct rt_thread,
-                        tlist);
-                mutex->priority = th->current_priority;
-            }
-            else
-            {
-                mutex->priority = 0xff;
-            }
+            /* update mutex priority, then set new owner and put mutex into taken list of thread */
+            mutex->owner = RT_NULL;
+            _mutex_update_priority(mutex);
+            mutex->owner = next_thread;
+            mutex->hold  = 1;
+            rt_list_insert_after(&next_thread->taken_object_list, &mutex->taken_list);
+            _thread_mutex_priority_changed(next_thread, 0xff, _mutex_owner_priority(mutex));
 
             need_schedule = RT_TRUE;
         }
@@ -3170,45 +3264,17 @@ rt_err_t rt_mq_delete(rt_mq_t mq)
 RTM_EXPORT(rt_mq_delete);
 #endif /* RT_USING_HEAP */
 
-/**
- * @brief    This function will send a message to the messagequeue object. If
- *           there is a thread suspended on the messagequeue, the thread will be
- *           resumed.
- *
- * @note     When using this function to send a message, if the messagequeue is
- *           fully used, the current thread will wait for a timeout. If reaching
- *           the timeout and there is still no space available, the sending
- *           thread will be resumed and an error code will be returned. By
- *           contrast, the _rt_mq_send_wait() function will return an error code
- *           immediately without waiting when the messagequeue if fully used.
- *
- * @see      _rt_mq_send_wait()
- *
- * @param    mq is a pointer to the messagequeue object to be sent.
- *
- * @param    buffer is the content of the message.
- *
- * @param    size is the length of the message(Unit: Byte).
- *
- * @param    prio is message priority, A larger value indicates a higher priority
- *
- * @param    timeout is a timeout period (unit: an OS tick).
- *
- * @param    suspend_flag status flag of the thread to be suspended.
- *
- * @return   Return the operation status. When the return value is RT_EOK, the
- *           operation is successful. If the return value is any other values,
- *           it means that the messagequeue detach failed.
- *
- * @warning  This function can be called in interrupt context and thread
- * context.
+/*
+ * The messages of a queue move between the free list and the message list, a message taken
+ * off one of them belongs to the thread that took it until it is put on the other. The copying
+ * send and receive and the loaned buffers share these four steps, a loan only skips the copy.
  */
-static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
-                                 const void *buffer,
-                                 rt_size_t size,
-                                 rt_int32_t prio,
-                                 rt_int32_t timeout,
-                                 int suspend_flag)
+
+/* take a free message, waiting for the timeout when the queue is full */
+static rt_err_t _mq_msg_alloc(rt_mq_t mq,
+                              struct rt_mq_message **msg_out,
+                              rt_int32_t timeout,
+                              int suspend_flag)
 {
     rt_base_t level;
     struct rt_mq_message *msg;
@@ -3216,26 +3282,14 @@ static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
     struct rt_thread *thread;
     rt_err_t ret;
 
-    /* parameter check */
-    RT_ASSERT(mq != RT_NULL);
-    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
-    RT_ASSERT(buffer != RT_NULL);
-    RT_ASSERT(size != 0);
-
     /* current context checking */
     RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
 
-    /* greater than one message size */
-    if (size > mq->msg_size)
-        return -RT_ERROR;
-
     /* initialize delta tick */
     tick_delta = 0;
     /* get current thread */
     thread = rt_thread_self();
 
-    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
-
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
@@ -3326,11 +3380,21 @@ static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
 
     /* the msg is the new tailer of list, the next shall be NULL */
     msg->next = RT_NULL;
+    *msg_out = msg;
+
+    return RT_EOK;
+}
+
+/* link a filled message into the queue by its priority and wake up a receiver */
+static rt_err_t _mq_msg_put(rt_mq_t mq,
+                            struct rt_mq_message *msg,
+                            rt_size_t size,
+                            rt_int32_t prio)
+{
+    rt_base_t level;
 
     /* add the length */
-    ((struct rt_mq_message *)msg)->length = size;
-    /* copy buffer */
-    rt_memcpy(GET_MESSAGEBYTE_ADDR(msg), buffer, size);
+    msg->length = size;
 
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
@@ -3405,83 +3469,300 @@ static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
     return RT_EOK;
 }
 
-rt_err_t rt_mq_send_wait(rt_mq_t     mq,
-                         const void *buffer,
-                         rt_size_t   size,
-                         rt_int32_t  timeout)
+/* take the first message off the queue, waiting for the timeout when the queue is empty */
+static rt_err_t _mq_msg_get(rt_mq_t mq,
+                            struct rt_mq_message **msg_out,
+                            rt_int32_t timeout,
+                            int suspend_flag)
 {
-    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_UNINTERRUPTIBLE);
-}
-RTM_EXPORT(rt_mq_send_wait);
+    struct rt_thread *thread;
+    rt_base_t level;
+    struct rt_mq_message *msg;
+    rt_uint32_t tick_delta;
+    rt_err_t ret;
 
-rt_err_t rt_mq_send_wait_interruptible(rt_mq_t     mq,
-                         const void *buffer,
-                         rt_size_t   size,
-                         rt_int32_t  timeout)
-{
-    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_INTERRUPTIBLE);
-}
-RTM_EXPORT(rt_mq_send_wait_interruptible);
+    /* current context checking */
+    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
 
-rt_err_t rt_mq_send_wait_killable(rt_mq_t     mq,
-                         const void *buffer,
-                         rt_size_t   size,
-                         rt_int32_t  timeout)
-{
-    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_KILLABLE);
-}
-RTM_EXPORT(rt_mq_send_wait_killable);
-/**
- * @brief    This function will send a message to the messagequeue object.
- *           If there is a thread suspended on the messagequeue, the thread will be resumed.
- *
- * @note     When using this function to send a message, if the messagequeue is fully used,
- *           the current thread will wait for a timeout.
- *           By contrast, when the messagequeue is fully used, the rt_mq_send_wait() function will
- *           return an error code immediately without waiting.
- *
- * @see      rt_mq_send_wait()
- *
- * @param    mq is a pointer to the messagequeue object to be sent.
- *
- * @param    buffer is the content of the message.
- *
- * @param    size is the length of the message(Unit: Byte).
- *
- * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
- *           If the return value is any other values, it means that the messagequeue detach failed.
- *
- * @warning  This function can be called in interrupt context and thread context.
- */
-rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size)
-{
-    return rt_mq_send_wait(mq, buffer, size, 0);
-}
-RTM_EXPORT(rt_mq_send);
+    /* initialize delta tick */
+    tick_delta = 0;
+    /* get current thread */
+    thread = rt_thread_self();
 
-rt_err_t rt_mq_send_interruptible(rt_mq_t mq, const void *buffer, rt_size_t size)
-{
-    return rt_mq_send_wait_interruptible(mq, buffer, size, 0);
-}
-RTM_EXPORT(rt_mq_send_interruptible);
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
 
-rt_err_t rt_mq_send_killable(rt_mq_t mq, const void *buffer, rt_size_t size)
-{
-    return rt_mq_send_wait_killable(mq, buffer, size, 0);
-}
-RTM_EXPORT(rt_mq_send_killable);
-/**
- * @brief    This function will send an urgent message to the messagequeue object.
- *
- * @note     This function is almost the same as the rt_mq_send() function. The only difference is that
- *           when sending an urgent message, the message is placed at the head of the messagequeue so that
- *           the recipient can receive the urgent message first.
- *
- * @see      rt_mq_send()
- *
- * @param    mq is a pointer to the messagequeue object to be sent.
- *
- * @param    buffer is the content of the message.
+    /* for non-blocking call */
+    if (mq->entry == 0 && timeout == 0)
+    {
+        rt_hw_interrupt_enable(level);
+
+        return -RT_ETIMEOUT;
+    }
+
+    /* message queue is empty */
+    while (mq->entry == 0)
+    {
+        /* reset error number in thread */
+        thread->error = -RT_EINTR;
+
+        /* no waiting, return timeout */
+        if (timeout == 0)
+        {
+            /* enable interrupt */
+            rt_hw_interrupt_enable(level);
+
+            thread->error = -RT_ETIMEOUT;
+
+            return -RT_ETIMEOUT;
+        }
+
+        /* suspend current thread */
+        ret = _ipc_list_suspend(&(mq->parent.suspend_thread),
+                            thread,
+                            mq->parent.parent.flag,
+                            suspend_flag);
+        if (ret != RT_EOK)
+        {
+            rt_hw_interrupt_enable(level);
+            return ret;
+        }
+
+        /* has waiting time, start thread timer */
+        if (timeout > 0)
+        {
+            /* get the start tick of timer */
+            tick_delta = rt_tick_get();
+
+            LOG_D("set thread:%s to timer list",
+                  thread->parent.name);
+
+            /* reset the timeout of thread timer and start it */
+            rt_timer_control(&(thread->thread_timer),
+                             RT_TIMER_CTRL_SET_TIME,
+                             &timeout);
+            rt_timer_start(&(thread->thread_timer));
+        }
+
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
+
+        /* re-schedule */
+        rt_schedule();
+
+        /* recv message */
+        if (thread->error != RT_EOK)
+        {
+            /* return error */
+            return thread->error;
+        }
+
+        /* disable interrupt */
+        level = rt_hw_interrupt_disable();
+
+        /* if it's not waiting forever and then re-calculate timeout tick */
+        if (timeout > 0)
+        {
+            tick_delta = rt_tick_get() - tick_delta;
+            timeout -= tick_delta;
+            if (timeout < 0)
+                timeout = 0;
+        }
+    }
+
+    /* get message from queue */
+    msg = (struct rt_mq_message *)mq->msg_queue_head;
+
+    /* move message queue head */
+    mq->msg_queue_head = msg->next;
+    /* reach queue tail, set to NULL */
+    if (mq->msg_queue_tail == msg)
+        mq->msg_queue_tail = RT_NULL;
+
+    /* decrease message entry */
+    if(mq->entry > 0)
+    {
+        mq->entry --;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    *msg_out = msg;
+
+    return RT_EOK;
+}
+
+/* give a message back to the free list and wake up a sender */
+static void _mq_msg_free(rt_mq_t mq, struct rt_mq_message *msg)
+{
+    rt_base_t level;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+    /* put message to free list */
+    msg->next = (struct rt_mq_message *)mq->msg_queue_free;
+    mq->msg_queue_free = msg;
+
+    /* resume suspended thread */
+    if (!rt_list_isempty(&(mq->suspend_sender_thread)))
+    {
+        _ipc_list_resume(&(mq->suspend_sender_thread));
+
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
+
+        rt_schedule();
+
+        return;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief    This function will send a message to the messagequeue object. If
+ *           there is a thread suspended on the messagequeue, the thread will be
+ *           resumed.
+ *
+ * @note     When using this function to send a message, if the messagequeue is
+ *           fully used, the current thread will wait for a timeout. If reaching
+ *           the timeout and there is still no space available, the sending
+ *           thread will be resumed and an error code will be returned. By
+ *           contrast, the _rt_mq_send_wait() function will return an error code
+ *           immediately without waiting when the messagequeue if fully used.
+ *
+ * @see      _rt_mq_send_wait()
+ *
+ * @param    mq is a pointer to the messagequeue object to be sent.
+ *
+ * @param    buffer is the content of the message.
+ *
+ * @param    size is the length of the message(Unit: Byte).
+ *
+ * @param    prio is message priority, A larger value indicates a higher priority
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @param    suspend_flag status flag of the thread to be suspended.
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the
+ *           operation is successful. If the return value is any other values,
+ *           it means that the messagequeue detach failed.
+ *
+ * @warning  This function can be called in interrupt context and thread
+ * context.
+ */
+static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
+                                 const void *buffer,
+                                 rt_size_t size,
+                                 rt_int32_t prio,
+                                 rt_int32_t timeout,
+                                 int suspend_flag)
+{
+    struct rt_mq_message *msg;
+    rt_err_t ret;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return -RT_ERROR;
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    ret = _mq_msg_alloc(mq, &msg, timeout, suspend_flag);
+    if (ret != RT_EOK)
+        return ret;
+
+    /* copy buffer */
+    rt_memcpy(GET_MESSAGEBYTE_ADDR(msg), buffer, size);
+
+    return _mq_msg_put(mq, msg, size, prio);
+}
+
+rt_err_t rt_mq_send_wait(rt_mq_t     mq,
+                         const void *buffer,
+                         rt_size_t   size,
+                         rt_int32_t  timeout)
+{
+    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_UNINTERRUPTIBLE);
+}
+RTM_EXPORT(rt_mq_send_wait);
+
+rt_err_t rt_mq_send_wait_interruptible(rt_mq_t     mq,
+                         const void *buffer,
+                         rt_size_t   size,
+                         rt_int32_t  timeout)
+{
+    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_INTERRUPTIBLE);
+}
+RTM_EXPORT(rt_mq_send_wait_interruptible);
+
+rt_err_t rt_mq_send_wait_killable(rt_mq_t     mq,
+                         const void *buffer,
+                         rt_size_t   size,
+                         rt_int32_t  timeout)
+{
+    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_KILLABLE);
+}
+RTM_EXPORT(rt_mq_send_wait_killable);
+/**
+ * @brief    This function will send a message to the messagequeue object.
+ *           If there is a thread suspended on the messagequeue, the thread will be resumed.
+ *
+ * @note     When using this function to send a message, if the messagequeue is fully used,
+ *           the current thread will wait for a timeout.
+ *           By contrast, when the messagequeue is fully used, the rt_mq_send_wait() function will
+ *           return an error code immediately without waiting.
+ *
+ * @see      rt_mq_send_wait()
+ *
+ * @param    mq is a pointer to the messagequeue object to be sent.
+ *
+ * @param    buffer is the content of the message.
+ *
+ * @param    size is the length of the message(Unit: Byte).
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *           If the return value is any other values, it means that the messagequeue detach failed.
+ *
+ * @warning  This function can be called in interrupt context and thread context.
+ */
+rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    return rt_mq_send_wait(mq, buffer, size, 0);
+}
+RTM_EXPORT(rt_mq_send);
+
+rt_err_t rt_mq_send_interruptible(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    return rt_mq_send_wait_interruptible(mq, buffer, size, 0);
+}
+RTM_EXPORT(rt_mq_send_interruptible);
+
+rt_err_t rt_mq_send_killable(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    return rt_mq_send_wait_killable(mq, buffer, size, 0);
+}
+RTM_EXPORT(rt_mq_send_killable);
+/**
+ * @brief    This function will send an urgent message to the messagequeue object.
+ *
+ * @note     This function is almost the same as the rt_mq_send() function. The only difference is that
+ *           when sending an urgent message, the message is placed at the head of the messagequeue so that
+ *           the recipient can receive the urgent message first.
+ *
+ * @see      rt_mq_send()
+ *
+ * @param    mq is a pointer to the messagequeue object to be sent.
+ *
+ * @param    buffer is the content of the message.
  *
  * @param    size is the length of the message(Unit: Byte).
  *
@@ -3608,10 +3889,7 @@ static rt_ssize_t _rt_mq_recv(rt_mq_t mq,
                               rt_int32_t timeout,
                               int suspend_flag)
 {
-    struct rt_thread *thread;
-    rt_base_t level;
     struct rt_mq_message *msg;
-    rt_uint32_t tick_delta;
     rt_err_t ret;
     rt_size_t len;
 
@@ -3621,116 +3899,14 @@ static rt_ssize_t _rt_mq_recv(rt_mq_t mq,
     RT_ASSERT(buffer != RT_NULL);
     RT_ASSERT(size != 0);
 
-    /* current context checking */
-    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
-
-    /* initialize delta tick */
-    tick_delta = 0;
-    /* get current thread */
-    thread = rt_thread_self();
     RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
 
-    /* disable interrupt */
-    level = rt_hw_interrupt_disable();
-
-    /* for non-blocking call */
-    if (mq->entry == 0 && timeout == 0)
-    {
-        rt_hw_interrupt_enable(level);
-
-        return -RT_ETIMEOUT;
-    }
-
-    /* message queue is empty */
-    while (mq->entry == 0)
-    {
-        /* reset error number in thread */
-        thread->error = -RT_EINTR;
-
-        /* no waiting, return timeout */
-        if (timeout == 0)
-        {
-            /* enable interrupt */
-            rt_hw_interrupt_enable(level);
-
-            thread->error = -RT_ETIMEOUT;
-
-            return -RT_ETIMEOUT;
-        }
-
-        /* suspend current thread */
-        ret = _ipc_list_suspend(&(mq->parent.suspend_thread),
-                            thread,
-                            mq->parent.parent.flag,
-                            suspend_flag);
-        if (ret != RT_EOK)
-        {
-            rt_hw_interrupt_enable(level);
-            return ret;
-        }
-
-        /* has waiting time, start thread timer */
-        if (timeout > 0)
-        {
-            /* get the start tick of timer */
-            tick_delta = rt_tick_get();
-
-            LOG_D("set thread:%s to timer list",
-                  thread->parent.name);
-
-            /* reset the timeout of thread timer and start it */
-            rt_timer_control(&(thread->thread_timer),
-                             RT_TIMER_CTRL_SET_TIME,
-                             &timeout);
-            rt_timer_start(&(thread->thread_timer));
-        }
-
-        /* enable interrupt */
-        rt_hw_interrupt_enable(level);
-
-        /* re-schedule */
-        rt_schedule();
-
-        /* recv message */
-        if (thread->error != RT_EOK)
-        {
-            /* return error */
-            return thread->error;
-        }
-
-        /* disable interrupt */
-        level = rt_hw_interrupt_disable();
-
-        /* if it's not waiting forever and then re-calculate timeout tick */
-        if (timeout > 0)
-        {
-            tick_delta = rt_tick_get() - tick_delta;
-            timeout -= tick_delta;
-            if (timeout < 0)
-                timeout = 0;
-        }
-    }
-
-    /* get message from queue */
-    msg = (struct rt_mq_message *)mq->msg_queue_head;
-
-    /* move message queue head */
-    mq->msg_queue_head = msg->next;
-    /* reach queue tail, set to NULL */
-    if (mq->msg_queue_tail == msg)
-        mq->msg_queue_tail = RT_NULL;
-
-    /* decrease message entry */
-    if(mq->entry > 0)
-    {
-        mq->entry --;
-    }
-
-    /* enable interrupt */
-    rt_hw_interrupt_enable(level);
+    ret = _mq_msg_get(mq, &msg, timeout, suspend_flag);
+    if (ret != RT_EOK)
+        return ret;
 
     /* get real message length */
-    len = ((struct rt_mq_message *)msg)->length;
+    len = msg->length;
 
     if (len > size)
         len = size;
@@ -3741,32 +3917,11 @@ static rt_ssize_t _rt_mq_recv(rt_mq_t mq,
     if (prio != RT_NULL)
         *prio = msg->prio;
 #endif
-    /* disable interrupt */
-    level = rt_hw_interrupt_disable();
-    /* put message to free list */
-    msg->next = (struct rt_mq_message *)mq->msg_queue_free;
-    mq->msg_queue_free = msg;
-
-    /* resume suspended thread */
-    if (!rt_list_isempty(&(mq->suspend_sender_thread)))
-    {
-        _ipc_list_resume(&(mq->suspend_sender_thread));
-
-        /* enable interrupt */
-        rt_hw_interrupt_enable(level);
-
-        RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
-
-        rt_schedule();
-
-        return len;
-    }
-
-    /* enable interrupt */
-    rt_hw_interrupt_enable(level);
 
     RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
 
+    _mq_msg_free(mq, msg);
+
     return len;
 }
 
@@ -3816,6 +3971,198 @@ rt_ssize_t rt_mq_recv_prio(rt_mq_t mq,
 }
 #endif
 RTM_EXPORT(rt_mq_recv_killable);
+
+#ifdef RT_USING_MESSAGEQUEUE_LOAN
+static struct rt_mq_message *_mq_msg_of(rt_mq_t mq, void *buffer)
+{
+    struct rt_mq_message *msg = (struct rt_mq_message *)buffer - 1;
+    rt_size_t msg_size = RT_ALIGN(mq->msg_size, RT_ALIGN_SIZE) + sizeof(struct rt_mq_message);
+    rt_size_t offset = (rt_uint8_t *)msg - (rt_uint8_t *)mq->msg_pool;
+
+    /* a buffer of the loans is always the payload of one message of the pool */
+    RT_ASSERT((rt_uint8_t *)msg >= (rt_uint8_t *)mq->msg_pool);
+    RT_ASSERT(offset < msg_size * mq->max_msgs && offset % msg_size == 0);
+    (void)offset;
+
+    return msg;
+}
+
+/**
+ * @brief    This function will loan the buffer of a free message of the messagequeue to the
+ *           sender, which fills it in place and sends it with rt_mq_commit().
+ *
+ * @note     The buffer is msg_size bytes of the pool of the messagequeue and belongs to the
+ *           caller until it is committed, or returned with rt_mq_cancel(). When the messagequeue
+ *           is full the thread will wait for a timeout, as rt_mq_send_wait() does.
+ *
+ * @see      rt_mq_commit(), rt_mq_cancel()
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is a pointer to get the address of the loaned buffer.
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @param    suspend_flag status flag of the thread to be suspended.
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *           If the return value is -RT_EFULL or any other values, no buffer is loaned.
+ *
+ * @warning  This function can be called in interrupt context with a timeout of zero.
+ */
+rt_err_t rt_mq_loan(rt_mq_t mq, void **buffer, rt_int32_t timeout, int suspend_flag)
+{
+    struct rt_mq_message *msg;
+    rt_err_t ret;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    ret = _mq_msg_alloc(mq, &msg, timeout, suspend_flag);
+    if (ret != RT_EOK)
+        return ret;
+
+    *buffer = GET_MESSAGEBYTE_ADDR(msg);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_loan);
+
+/**
+ * @brief    This function will send a loaned buffer as a message of the messagequeue. If there
+ *           is a thread suspended on the messagequeue, the thread will be resumed.
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is the buffer from rt_mq_loan().
+ *
+ * @param    size is the length of the message(Unit: Byte).
+ *
+ * @param    prio is message priority, A larger value indicates a higher priority. It is
+ *           ignored without RT_USING_MESSAGEQUEUE_PRIORITY.
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *           On an error the buffer is still owned by the caller.
+ */
+rt_err_t rt_mq_commit(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t prio)
+{
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return -RT_ERROR;
+
+    return _mq_msg_put(mq, _mq_msg_of(mq, buffer), size, prio);
+}
+RTM_EXPORT(rt_mq_commit);
+
+/**
+ * @brief    This function will return a loaned buffer of the messagequeue without sending it.
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is the buffer from rt_mq_loan().
+ *
+ * @return   Return the operation status. It is always RT_EOK.
+ */
+rt_err_t rt_mq_cancel(rt_mq_t mq, void *buffer)
+{
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    _mq_msg_free(mq, _mq_msg_of(mq, buffer));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_cancel);
+
+/**
+ * @brief    This function will receive a message from the messagequeue without copying it, the
+ *           receiver gets the buffer of the message in the pool.
+ *
+ * @note     The buffer belongs to the receiver until it is given back with rt_mq_recv_release(),
+ *           the slot of the message is not free for the senders before that. The messages are
+ *           received in the same order as rt_mq_recv() and rt_mq_recv_prio() get them.
+ *
+ * @see      rt_mq_recv_release()
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is a pointer to get the address of the message.
+ *
+ * @param    prio is a pointer to get the priority of the message, it can be RT_NULL.
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @param    suspend_flag status flag of the thread to be suspended.
+ *
+ * @return   Return the length of the message. When the return value is larger than zero, the operation is successful.
+ *           If the return value is any other values, no message is received.
+ */
+rt_ssize_t rt_mq_recv_loan(rt_mq_t mq, void **buffer, rt_int32_t *prio, rt_int32_t timeout, int suspend_flag)
+{
+    struct rt_mq_message *msg;
+    rt_err_t ret;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
+
+    ret = _mq_msg_get(mq, &msg, timeout, suspend_flag);
+    if (ret != RT_EOK)
+        return ret;
+
+    *buffer = GET_MESSAGEBYTE_ADDR(msg);
+#ifdef RT_USING_MESSAGEQUEUE_PRIORITY
+    if (prio != RT_NULL)
+        *prio = msg->prio;
+#else
+    if (prio != RT_NULL)
+        *prio = 0;
+#endif
+
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
+
+    return msg->length;
+}
+RTM_EXPORT(rt_mq_recv_loan);
+
+/**
+ * @brief    This function will give a received buffer back to the messagequeue. If there is a
+ *           thread suspended to send to the messagequeue, the thread will be resumed.
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is the buffer from rt_mq_recv_loan().
+ *
+ * @return   Return the operation status. It is always RT_EOK.
+ */
+rt_err_t rt_mq_recv_release(rt_mq_t mq, void *buffer)
+{
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    _mq_msg_free(mq, _mq_msg_of(mq, buffer));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_recv_release);
+#endif /* RT_USING_MESSAGEQUEUE_LOAN */
 /**
  * @brief    This function will set some extra attributions of a messagequeue object.
  *
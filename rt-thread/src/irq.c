@@ -12,6 +12,7 @@
  * 2021-08-15     Supperthomas fix the comment
  * 2022-01-07     Gabriel      Moving __on_rt_xxxxx_hook to irq.c
  * 2022-07-04     Yunjie       fix RT_DEBUG_LOG
+ * 2026-10-18     RT-Thread    add cpu usage accounting
  */
 
 #include <rthw.h>
@@ -88,6 +89,12 @@ rt_weak void rt_interrupt_enter(void)
 
     level = rt_hw_interrupt_disable();
     rt_interrupt_nest ++;
+#ifdef RT_USING_CPU_USAGE
+    if (rt_interrupt_nest == 1)
+    {
+        rt_cpu_usage_irq_enter();
+    }
+#endif /* RT_USING_CPU_USAGE */
     RT_OBJECT_HOOK_CALL(rt_interrupt_enter_hook,());
     rt_hw_interrupt_enable(level);
 
@@ -113,6 +120,12 @@ rt_weak void rt_interrupt_leave(void)
 
     level = rt_hw_interrupt_disable();
     RT_OBJECT_HOOK_CALL(rt_interrupt_leave_hook,());
+#ifdef RT_USING_CPU_USAGE
+    if (rt_interrupt_nest == 1)
+    {
+        rt_cpu_usage_irq_leave();
+    }
+#endif /* RT_USING_CPU_USAGE */
     rt_interrupt_nest --;
     rt_hw_interrupt_enable(level);
 }
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Message queue throughput benchmark.
+ *
+ * A producer thread fills messages of the given size and a consumer thread at the same priority
+ * checks them, through a queue of 8 messages. The copying rt_mq_send and rt_mq_recv fill a
+ * buffer of the producer and read one of the consumer, the loans fill and read the pool of the
+ * queue. The time per message and the throughput are reported. Without arguments it runs over
+ * messages of 16, 64, 256 and 1024 bytes.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(RT_MQ_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_MSGS              8
+#define BENCH_SIZE_MAX          1024
+
+static rt_mq_t bench_mq;
+static struct rt_semaphore bench_done;
+static rt_uint32_t bench_rounds, bench_size, bench_errors;
+static rt_bool_t bench_loan;
+static rt_uint8_t bench_tx[BENCH_SIZE_MAX], bench_rx[BENCH_SIZE_MAX];
+
+static void bench_producer(void *parameter)
+{
+    rt_uint32_t i;
+#ifdef RT_USING_MESSAGEQUEUE_LOAN
+    void *buf;
+#endif
+
+    for (i = 0; i < bench_rounds; i++)
+    {
+#ifdef RT_USING_MESSAGEQUEUE_LOAN
+        if (bench_loan)
+        {
+            rt_mq_loan(bench_mq, &buf, RT_WAITING_FOREVER, RT_UNINTERRUPTIBLE);
+            rt_memset(buf, (rt_uint8_t)i, bench_size);
+            rt_mq_commit(bench_mq, buf, bench_size, 0);
+            continue;
+        }
+#endif
+        rt_memset(bench_tx, (rt_uint8_t)i, bench_size);
+        rt_mq_send_wait(bench_mq, bench_tx, bench_size, RT_WAITING_FOREVER);
+    }
+}
+
+static void bench_consumer(void *parameter)
+{
+    const rt_uint8_t *msg;
+    rt_ssize_t len;
+    rt_uint32_t i;
+
+    for (i = 0; i < bench_rounds; i++)
+    {
+#ifdef RT_USING_MESSAGEQUEUE_LOAN
+        if (bench_loan)
+        {
+            len = rt_mq_recv_loan(bench_mq, (void **)&msg, RT_NULL, RT_WAITING_FOREVER, RT_UNINTERRUPTIBLE);
+            if (len != bench_size || msg[0] != (rt_uint8_t)i || msg[len - 1] != (rt_uint8_t)i)
+                bench_errors++;
+            if (len > 0)
+                rt_mq_recv_release(bench_mq, (void *)msg);
+            continue;
+        }
+#endif
+        msg = bench_rx;
+        len = rt_mq_recv(bench_mq, bench_rx, sizeof(bench_rx), RT_WAITING_FOREVER);
+        if (len != bench_size || msg[0] != (rt_uint8_t)i || msg[len - 1] != (rt_uint8_t)i)
+            bench_errors++;
+    }
+    rt_sem_release(&bench_done);
+}
+
+static rt_err_t bench_run(rt_uint32_t size, rt_uint32_t rounds, rt_bool_t loan)
+{
+    rt_thread_t producer, consumer;
+    rt_uint8_t prio = rt_thread_self()->current_priority;
+    rt_uint32_t t, ns;
+
+    bench_rounds = rounds;
+    bench_size = size;
+    bench_loan = loan;
+    bench_errors = 0;
+
+    producer = rt_thread_create("mqprod", bench_producer, RT_NULL, 1024, prio, 10);
+    consumer = rt_thread_create("mqcons", bench_consumer, RT_NULL, 1024, prio, 10);
+    if (producer == RT_NULL || consumer == RT_NULL)
+    {
+        if (producer) rt_thread_delete(producer);
+        if (consumer) rt_thread_delete(consumer);
+        rt_kprintf("no memory for the threads\n");
+        return -RT_ENOMEM;
+    }
+
+    t = BENCH_CLOCK();
+    rt_thread_startup(consumer);
+    rt_thread_startup(producer);
+    rt_sem_take(&bench_done, RT_WAITING_FOREVER);
+    t = BENCH_CLOCK() - t;
+
+    ns = (rt_uint32_t)(BENCH_CLOCK_NS(t) / rounds);
+    rt_kprintf("%5d %-5s %8d ns %8d KB/s%s\n", size, loan ? "loan" : "copy", ns,
+               ns ? (rt_uint32_t)((rt_uint64_t)size * 1000000000 / 1024 / ns) : 0,
+               bench_errors ? "  bad messages" : "");
+
+    return RT_EOK;
+}
+
+static void mq_bench(int argc, char **argv)
+{
+    static const rt_uint16_t sizes[] = {16, 64, 256, 1024};
+    rt_uint32_t rounds = 10000, i;
+
+    if (argc > 2) rounds = strtoul(argv[2], RT_NULL, 0);
+    if (rounds == 0 || (argc > 1 && (strtoul(argv[1], RT_NULL, 0) == 0 || strtoul(argv[1], RT_NULL, 0) > BENCH_SIZE_MAX)))
+    {
+        rt_kprintf("Usage: mq_bench [size] [rounds]\n");
+        return;
+    }
+
+    bench_mq = rt_mq_create("mqbench", BENCH_SIZE_MAX, BENCH_MSGS, RT_IPC_FLAG_FIFO);
+    if (bench_mq == RT_NULL)
+    {
+        rt_kprintf("no memory for the queue\n");
+        return;
+    }
+    rt_sem_init(&bench_done, "mqdone", 0, RT_IPC_FLAG_FIFO);
+
+    rt_kprintf(" size mode  per message   throughput\n");
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        if (argc > 1 && i > 0)
+            break;
+        bench_run(argc > 1 ? strtoul(argv[1], RT_NULL, 0) : sizes[i], rounds, RT_FALSE);
+#ifdef RT_USING_MESSAGEQUEUE_LOAN
+        bench_run(argc > 1 ? strtoul(argv[1], RT_NULL, 0) : sizes[i], rounds, RT_TRUE);
+#endif
+    }
+
+    rt_sem_detach(&bench_done);
+    rt_mq_delete(bench_mq);
+}
+MSH_CMD_EXPORT(mq_bench, message queue throughput);
+
+#ifdef RT_USING_UTEST
+#include <utest.h>
+
+static void test_mq_order(void)
+{
+    /* every message arrives once, in order and with its size */
+    uassert_int_equal(bench_run(64, 1000, RT_FALSE), RT_EOK);
+    uassert_int_equal(bench_errors, 0);
+#ifdef RT_USING_MESSAGEQUEUE_LOAN
+    uassert_int_equal(bench_run(BENCH_SIZE_MAX, 1000, RT_TRUE), RT_EOK);
+    uassert_int_equal(bench_errors, 0);
+#endif
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    bench_mq = rt_mq_create("mqbench", BENCH_SIZE_MAX, BENCH_MSGS, RT_IPC_FLAG_FIFO);
+    if (bench_mq == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+    rt_sem_init(&bench_done, "mqdone", 0, RT_IPC_FLAG_FIFO);
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_sem_detach(&bench_done);
+    rt_mq_delete(bench_mq);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_mq_order);
+}
+UTEST_TC_EXPORT(testcase, "src.mq_bench", utest_tc_init, utest_tc_cleanup, 10);
+#endif /* RT_USING_UTEST */
+
+#endif /* defined(RT_MQ_USING_BENCH) && defined(RT_USING_FINSH) */
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     RT-Thread    the first version
+ */
+
+/*
+ * Mutex contention benchmark.
+ *
+ * A number of threads at the priority of the shell take a mutex, hold it for a busy wait of
+ * the hold time, increment a counter without atomics and release it, for a number of rounds
+ * each. The time per take and release pair over all the threads is reported and the counter
+ * is checked. Without arguments it runs over 1, 2, 4 and 8 threads and hold times of 0, 1
+ * and 10 us.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(RT_MUTEX_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <msh_bench.h>
+
+#define BENCH_THREADS_MAX       8
+
+static struct rt_mutex bench_mutex;
+static struct rt_semaphore bench_start, bench_done;
+static rt_uint32_t bench_rounds, bench_hold, bench_counter;
+
+static void bench_entry(void *parameter)
+{
+    rt_uint32_t i;
+
+    rt_sem_take(&bench_start, RT_WAITING_FOREVER);
+    for (i = 0; i < bench_rounds; i++)
+    {
+        rt_mutex_take(&bench_mutex, RT_WAITING_FOREVER);
+        if (bench_hold)
+            rt_hw_us_delay(bench_hold);
+        bench_counter++;
+        rt_mutex_release(&bench_mutex);
+    }
+    rt_sem_release(&bench_done);
+}
+
+static int bench_run(rt_uint32_t threads, rt_uint32_t hold, rt_uint32_t rounds)
+{
+    rt_thread_t tid[BENCH_THREADS_MAX];
+    rt_uint32_t i, t, ops;
+
+    bench_rounds = rounds;
+    bench_hold = hold;
+    bench_counter = 0;
+    rt_mutex_init(&bench_mutex, "mbench", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&bench_start, "mstart", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&bench_done, "mdone", 0, RT_IPC_FLAG_FIFO);
+
+    for (i = 0; i < threads; i++)
+    {
+        tid[i] = rt_thread_create("mbench", bench_entry, RT_NULL, 1024, rt_thread_self()->current_priority, 10);
+        if (tid[i] == RT_NULL)
+            break;
+        rt_thread_startup(tid[i]);
+    }
+    threads = i;
+
+    t = BENCH_CLOCK();
+    for (i = 0; i < threads; i++)
+        rt_sem_release(&bench_start);
+    for (i = 0; i < threads; i++)
+        rt_sem_take(&bench_done, RT_WAITING_FOREVER);
+    t = BENCH_CLOCK() - t;
+
+    ops = threads * rounds;
+    rt_kprintf("%7d %7d %10d %10d ns%s\n", threads, hold, ops,
+               ops ? (rt_uint32_t)(BENCH_CLOCK_NS(t) / ops) : 0,
+               bench_counter == ops ? "" : "  counter mismatch");
+
+    rt_sem_detach(&bench_done);
+    rt_sem_detach(&bench_start);
+    rt_mutex_detach(&bench_mutex);
+
+    return threads;
+}
+
+static void mutex_bench(int argc, char **argv)
+{
+    static const rt_uint8_t threads[] = {1, 2, 4, 8};
+    static const rt_uint8_t holds[] = {0, 1, 10};
+    rt_uint32_t rounds = 1000, i, j;
+
+    if (argc > 3) rounds = strtoul(argv[3], RT_NULL, 0);
+    if (rounds == 0 || (argc > 1 && (strtoul(argv[1], RT_NULL, 0) == 0 || strtoul(argv[1], RT_NULL, 0) > BENCH_THREADS_MAX)))
+    {
+        rt_kprintf("Usage: mutex_bench [threads] [hold us] [rounds]\n");
+        return;
+    }
+
+#ifdef RT_USING_MUTEX_ADAPTIVE
+    rt_kprintf("adaptive mutex, %d spin rounds, %d CPUs\n", RT_MUTEX_SPIN_MAX, RT_CPUS_NR);
+#elif defined(RT_USING_SMP)
+    rt_kprintf("blocking mutex, %d CPUs\n", RT_CPUS_NR);
+#else
+    rt_kprintf("blocking mutex\n");
+#endif
+    rt_kprintf("threads hold us      takes  take+release\n");
+
+    if (argc > 1)
+    {
+        bench_run(strtoul(argv[1], RT_NULL, 0), argc > 2 ? strtoul(argv[2], RT_NULL, 0) : 0, rounds);
+        return;
+    }
+
+    for (i = 0; i < sizeof(holds) / sizeof(holds[0]); i++)
+    {
+        for (j = 0; j < sizeof(threads) / sizeof(threads[0]); j++)
+        {
+            if (bench_run(threads[j], holds[i], rounds) != threads[j])
+            {
+                rt_kprintf("no memory for the threads\n");
+                return;
+            }
+        }
+    }
+}
+MSH_CMD_EXPORT(mutex_bench, mutex contention);
+
+#ifdef RT_USING_UTEST
+#include <utest.h>
+
+static void test_mutex_exclusion(void)
+{
+    rt_uint32_t threads;
+
+    /* no increment of the counter is lost while the threads contend */
+    threads = bench_run(BENCH_THREADS_MAX / 2, 1, 200);
+    uassert_int_equal(threads, BENCH_THREADS_MAX / 2);
+    uassert_int_equal(bench_counter, threads * 200);
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_mutex_exclusion);
+}
+UTEST_TC_EXPORT(testcase, "src.mutex_bench", RT_NULL, RT_NULL, 10);
+#endif /* RT_USING_UTEST */
+
+#endif /* defined(RT_MUTEX_USING_BENCH) && defined(RT_USING_FINSH) */
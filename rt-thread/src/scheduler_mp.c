@@ -29,6 +29,7 @@
  *                             new task directly
  * 2022-01-07     Gabriel      Moving __on_rt_xxxxx_hook to scheduler.c
  * 2023-03-27     rose_man     Split into scheduler upc and scheduler_mp.c
+ * 2026-10-18     RT-Thread    add cpu usage accounting
  */
 
 #include <rtthread.h>
@@ -235,6 +236,10 @@ void rt_system_scheduler_start(void)
     rt_schedule_remove_thread(to_thread);
     to_thread->stat = RT_THREAD_RUNNING;
 
+#ifdef RT_USING_CPU_USAGE
+    rt_cpu_usage_switch(RT_NULL, to_thread);
+#endif /* RT_USING_CPU_USAGE */
+
     /* switch to new thread */
     rt_hw_context_switch_to((rt_ubase_t)&to_thread->sp, to_thread);
 
@@ -343,6 +348,9 @@ void rt_schedule(void)
                 /* if the destination thread is not the same as current thread */
                 pcpu->current_priority = (rt_uint8_t)highest_ready_priority;
 
+#ifdef RT_USING_CPU_USAGE
+                rt_cpu_usage_switch(current_thread, to_thread);
+#endif /* RT_USING_CPU_USAGE */
                 RT_OBJECT_HOOK_CALL(rt_scheduler_hook, (current_thread, to_thread));
 
                 rt_schedule_remove_thread(to_thread);
@@ -477,6 +485,9 @@ void rt_scheduler_do_irq_switch(void *context)
 
                 pcpu->current_priority = (rt_uint8_t)highest_ready_priority;
 
+#ifdef RT_USING_CPU_USAGE
+                rt_cpu_usage_switch(current_thread, to_thread);
+#endif /* RT_USING_CPU_USAGE */
                 RT_OBJECT_HOOK_CALL(rt_scheduler_hook, (current_thread, to_thread));
 
                 rt_schedule_remove_thread(to_thread);
@@ -528,6 +539,10 @@ void rt_schedule_insert_thread(struct rt_thread *thread)
         goto __exit;
     }
 
+#ifdef RT_USING_CPU_USAGE
+    rt_cpu_usage_ready(thread);
+#endif /* RT_USING_CPU_USAGE */
+
     /* READY thread, insert to ready queue */
     thread->stat = RT_THREAD_READY | (thread->stat & ~RT_THREAD_STAT_MASK);
 
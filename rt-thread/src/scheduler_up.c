@@ -29,6 +29,7 @@
  *                             new task directly
  * 2022-01-07     Gabriel      Moving __on_rt_xxxxx_hook to scheduler.c
  * 2023-03-27     rose_man     Split into scheduler upc and scheduler_mp.c
+ * 2026-10-18     RT-Thread    add cpu usage accounting
  */
 
 #include <rtthread.h>
@@ -207,6 +208,10 @@ void rt_system_scheduler_start(void)
     rt_schedule_remove_thread(to_thread);
     to_thread->stat = RT_THREAD_RUNNING;
 
+#ifdef RT_USING_CPU_USAGE
+    rt_cpu_usage_switch(RT_NULL, to_thread);
+#endif /* RT_USING_CPU_USAGE */
+
     /* switch to new thread */
 
     rt_hw_context_switch_to((rt_ubase_t)&to_thread->sp);
@@ -270,6 +275,9 @@ void rt_schedule(void)
                 from_thread         = rt_current_thread;
                 rt_current_thread   = to_thread;
 
+#ifdef RT_USING_CPU_USAGE
+                rt_cpu_usage_switch(from_thread, to_thread);
+#endif /* RT_USING_CPU_USAGE */
                 RT_OBJECT_HOOK_CALL(rt_scheduler_hook, (from_thread, to_thread));
 
                 if (need_insert_from_thread)
@@ -372,6 +380,10 @@ void rt_schedule_insert_thread(struct rt_thread *thread)
         goto __exit;
     }
 
+#ifdef RT_USING_CPU_USAGE
+    rt_cpu_usage_ready(thread);
+#endif /* RT_USING_CPU_USAGE */
+
     /* READY thread, insert to ready queue */
     thread->stat = RT_THREAD_READY | (thread->stat & ~RT_THREAD_STAT_MASK);
     /* there is no time slices left(YIELD), inserting thread before ready list*/
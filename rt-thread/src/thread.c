@@ -32,6 +32,8 @@
  * 2022-01-07     Gabriel      Moving __on_rt_xxxxx_hook to thread.c
  * 2022-01-24     THEWON       let rt_thread_sleep return thread->error when using signal
  * 2022-10-15     Bernard      add nested mutex feature
+ * 2026-10-18     RT-Thread    add cpu usage accounting
+ * 2026-10-18     RT-Thread    add the mutex priority of a thread
  */
 
 #include <rthw.h>
@@ -208,6 +210,7 @@ static rt_err_t _thread_init(struct rt_thread *thread,
 #ifdef RT_USING_MUTEX
     rt_list_init(&thread->taken_object_list);
     thread->pending_object = RT_NULL;
+    thread->mutex_priority = 0xff;
 #endif
 
 #ifdef RT_USING_EVENT
@@ -277,6 +280,10 @@ static rt_err_t _thread_init(struct rt_thread *thread,
 
 #ifdef RT_USING_CPU_USAGE
     thread->duration_tick = 0;
+    thread->wakeup_tick = 0;
+    thread->max_latency = 0;
+    thread->switch_count = 0;
+    thread->preempt_count = 0;
 #endif /* RT_USING_CPU_USAGE */
 
 #ifdef RT_USING_PTHREADS